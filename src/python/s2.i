@@ -61,3 +61,4 @@
 
 %include "coder.i"
 %include "s2_common.i"
+%include "s2_batch.i"
@@ -0,0 +1,138 @@
+//
+// Batch conversions operating on contiguous buffers via the Python buffer
+// protocol.  NumPy arrays, array.array and memoryview objects all work
+// without copying or per-element boxing, so billions of points can cross the
+// language boundary at C++ speed.  For example:
+//
+//   latlngs = np.asarray(points, dtype=np.float64)    # shape (N, 2)
+//   cell_ids = np.empty(len(latlngs), dtype=np.uint64)
+//   s2.S2CellIdsFromLatLngDegrees(latlngs, cell_ids, 30)
+//
+//   tokens = s2.S2CellIdsToTokens(cell_ids)
+//
+//   covering = np.array(cell_union.cell_ids(), dtype=np.uint64)
+//   contains = np.empty(len(cell_ids), dtype=np.uint8)
+//   s2.S2CellUnionContainsCellIds(covering, cell_ids, contains)
+//
+// There is no NumPy dependency; any object implementing the buffer protocol
+// can be used.  All buffers must be C-contiguous.
+//
+
+%{
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "s2/base/types.h"
+#include "s2/s2cell_id.h"
+#include "s2/s2latlng.h"
+%}
+
+%include "pybuffer.i"
+
+%pybuffer_binary(const double* latlng_degrees, size_t latlng_bytes);
+%pybuffer_binary(const uint64* cell_ids, size_t cell_id_bytes);
+%pybuffer_binary(const uint64* covering, size_t covering_bytes);
+%pybuffer_mutable_binary(uint64* out_cell_ids, size_t out_cell_id_bytes);
+%pybuffer_mutable_binary(uint8* contains, size_t contains_bytes);
+
+// The functions below report size and argument problems by raising a Python
+// exception, so propagate it out of the wrapper.
+%define %batch_exception(NAME)
+%exception NAME {
+  $action
+  if (PyErr_Occurred()) SWIG_fail;
+}
+%enddef
+
+%batch_exception(S2CellIdsFromLatLngDegrees)
+%batch_exception(S2CellIdsToTokens)
+%batch_exception(S2CellUnionContainsCellIds)
+
+%inline %{
+
+// Converts an (N, 2) buffer of (lat, lng) pairs in degrees to the id of the
+// containing cell at the given level, writing one uint64 per input point.
+void S2CellIdsFromLatLngDegrees(const double* latlng_degrees,
+                                size_t latlng_bytes, uint64* out_cell_ids,
+                                size_t out_cell_id_bytes,
+                                int level = S2CellId::kMaxLevel) {
+  if (latlng_bytes % (2 * sizeof(double)) != 0) {
+    PyErr_SetString(PyExc_ValueError,
+                    "latlng buffer size must be a multiple of 16 bytes "
+                    "(N x 2 float64 values)");
+    return;
+  }
+  const size_t n = latlng_bytes / (2 * sizeof(double));
+  if (out_cell_id_bytes != n * sizeof(uint64)) {
+    PyErr_SetString(PyExc_ValueError,
+                    "output buffer must hold exactly one uint64 per point");
+    return;
+  }
+  if (level < 0 || level > S2CellId::kMaxLevel) {
+    PyErr_SetString(PyExc_ValueError, "level must be in the range [0, 30]");
+    return;
+  }
+  for (size_t i = 0; i < n; ++i) {
+    S2CellId id(S2LatLng::FromDegrees(latlng_degrees[2 * i],
+                                      latlng_degrees[2 * i + 1]));
+    out_cell_ids[i] = id.parent(level).id();
+  }
+}
+
+// Converts a buffer of uint64 cell ids to a list of tokens.
+std::vector<std::string> S2CellIdsToTokens(const uint64* cell_ids,
+                                           size_t cell_id_bytes) {
+  std::vector<std::string> tokens;
+  if (cell_id_bytes % sizeof(uint64) != 0) {
+    PyErr_SetString(PyExc_ValueError,
+                    "cell id buffer size must be a multiple of 8 bytes");
+    return tokens;
+  }
+  const size_t n = cell_id_bytes / sizeof(uint64);
+  tokens.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    tokens.push_back(S2CellId(cell_ids[i]).ToToken());
+  }
+  return tokens;
+}
+
+// For each cell id in "cell_ids", writes 1 to the corresponding byte of
+// "contains" if the id is contained by the given covering and 0 otherwise.
+// The covering must be a sorted buffer of non-overlapping uint64 cell ids,
+// e.g. the cell_ids() of an S2CellUnion.
+void S2CellUnionContainsCellIds(const uint64* covering, size_t covering_bytes,
+                                const uint64* cell_ids, size_t cell_id_bytes,
+                                uint8* contains, size_t contains_bytes) {
+  if (covering_bytes % sizeof(uint64) != 0 ||
+      cell_id_bytes % sizeof(uint64) != 0) {
+    PyErr_SetString(PyExc_ValueError,
+                    "cell id buffer sizes must be multiples of 8 bytes");
+    return;
+  }
+  const size_t num_covering = covering_bytes / sizeof(uint64);
+  const size_t n = cell_id_bytes / sizeof(uint64);
+  if (contains_bytes != n) {
+    PyErr_SetString(PyExc_ValueError,
+                    "result buffer must hold exactly one byte per cell id");
+    return;
+  }
+  // Note that uint64 order and S2CellId order agree, so the sortedness check
+  // and the binary search below can work on the raw ids.
+  for (size_t i = 1; i < num_covering; ++i) {
+    if (covering[i - 1] >= covering[i]) {
+      PyErr_SetString(PyExc_ValueError, "covering must be sorted and unique");
+      return;
+    }
+  }
+  const uint64* end = covering + num_covering;
+  for (size_t i = 0; i < n; ++i) {
+    const S2CellId id(cell_ids[i]);
+    // Same logic as S2CellUnion::Contains(S2CellId).
+    const uint64* it = std::lower_bound(covering, end, id.id());
+    contains[i] = (it != end && S2CellId(*it).range_min() <= id) ||
+                  (it != covering && S2CellId(*(it - 1)).range_max() >= id);
+  }
+}
+
+%}
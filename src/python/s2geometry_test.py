@@ -1227,5 +1227,69 @@ class S2BuilderTest(unittest.TestCase):
     with self.assertRaises(ValueError):
       b.Build()
 
+class PyWrapS2BatchTestCase(unittest.TestCase):
+  """Tests for the buffer-based batch conversion functions.
+
+  array.array is used rather than NumPy to avoid a test dependency; any
+  object implementing the buffer protocol (including NumPy arrays) works.
+  """
+
+  def testBatchCellIdsFromLatLngDegrees(self):
+    import array
+    latlngs = array.array('d', [51.5001525, -0.1262355,
+                                -33.8688, 151.2093,
+                                0.0, 0.0])
+    out = array.array('Q', [0] * 3)
+    s2.S2CellIdsFromLatLngDegrees(latlngs, out)
+    for i in range(3):
+      expected = s2.S2CellId(
+          s2.S2LatLng.FromDegrees(latlngs[2 * i], latlngs[2 * i + 1]))
+      self.assertEqual(out[i], expected.id())
+
+  def testBatchCellIdsAtFixedLevel(self):
+    import array
+    latlngs = array.array('d', [51.5001525, -0.1262355])
+    out = array.array('Q', [0])
+    s2.S2CellIdsFromLatLngDegrees(latlngs, out, 12)
+    expected = s2.S2CellId(
+        s2.S2LatLng.FromDegrees(latlngs[0], latlngs[1])).parent(12)
+    self.assertEqual(out[0], expected.id())
+
+  def testBatchSizeMismatchRaises(self):
+    import array
+    latlngs = array.array('d', [1.0, 2.0])
+    out = array.array('Q', [0, 0])
+    with self.assertRaises(ValueError):
+      s2.S2CellIdsFromLatLngDegrees(latlngs, out)
+
+  def testBatchTokens(self):
+    import array
+    london = s2.S2CellId(s2.S2LatLng.FromDegrees(51.5001525, -0.1262355))
+    ids = array.array('Q', [london.id(), london.parent(12).id()])
+    tokens = s2.S2CellIdsToTokens(ids)
+    self.assertEqual(list(tokens),
+                     [london.ToToken(), london.parent(12).ToToken()])
+
+  def testBatchCoveringMembership(self):
+    import array
+    inside = s2.S2CellId(s2.S2LatLng.FromDegrees(51.5001525, -0.1262355))
+    outside = s2.S2CellId(s2.S2LatLng.FromDegrees(-33.8688, 151.2093))
+    cell = inside.parent(10)
+    covering = array.array('Q',
+                           sorted(cell.child(i).id() for i in range(4)))
+    queries = array.array('Q', [inside.id(), outside.id()])
+    contains = bytearray(len(queries))
+    s2.S2CellUnionContainsCellIds(covering, queries, contains)
+    self.assertEqual(list(contains), [1, 0])
+
+  def testBatchCoveringMustBeSorted(self):
+    import array
+    cell = s2.S2CellId(s2.S2LatLng.FromDegrees(10, 10)).parent(10)
+    covering = array.array('Q', [cell.child(1).id(), cell.child(0).id()])
+    queries = array.array('Q', [cell.child(0).id()])
+    with self.assertRaises(ValueError):
+      s2.S2CellUnionContainsCellIds(covering, queries, bytearray(1))
+
+
 if __name__ == "__main__":
   unittest.main()
@@ -21,6 +21,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <limits>
 #include <vector>
 
@@ -130,17 +131,37 @@ bool EncodedS2PointVector::Init(Decoder* decoder) {
     case CELL_IDS:
       return InitCellIdsFormat(decoder);
 
+    case UNCOMPRESSED_ALIGNED:
+      return InitUncompressedAlignedFormat(decoder);
+
     default:
       return false;
   }
 }
 
-vector<S2Point> EncodedS2PointVector::Decode() const {
-  vector<S2Point> points;
-  points.reserve(size_);
-  for (size_t i = 0; i < size_; ++i) {
-    points.push_back((*this)[i]);
+void EncodedS2PointVector::DecodeRange(int begin, int count,
+                                       S2Point* out) const {
+  ABSL_DCHECK_GE(begin, 0);
+  ABSL_DCHECK_GE(count, 0);
+  ABSL_DCHECK_LE(static_cast<size_t>(begin) + count, size_);
+  switch (format_) {
+    case Format::UNCOMPRESSED:
+    case Format::UNCOMPRESSED_ALIGNED:
+      std::memcpy(out, uncompressed_.points + begin, count * sizeof(S2Point));
+      break;
+
+    case Format::CELL_IDS:
+      DecodeCellIdsFormatRange(begin, count, out);
+      break;
+
+    default:
+      ABSL_DLOG(FATAL) << "Unrecognized format";
   }
+}
+
+vector<S2Point> EncodedS2PointVector::Decode() const {
+  vector<S2Point> points(size_);
+  DecodeRange(0, size_, points.data());
   return points;
 }
 
@@ -151,6 +172,11 @@ void EncodedS2PointVector::Encode(Encoder* encoder) const {
       EncodeS2PointVectorFast(MakeSpan(uncompressed_.points, size_), encoder);
       break;
 
+    case UNCOMPRESSED_ALIGNED:
+      EncodeS2PointVectorAligned(MakeSpan(uncompressed_.points, size_),
+                                 encoder);
+      break;
+
     case CELL_IDS: {
       // This is a full decode/encode dance, and not at all efficient.
       EncodeS2PointVectorCompact(Decode(), encoder);
@@ -186,6 +212,52 @@ void EncodeS2PointVectorFast(Span<const S2Point> points, Encoder* encoder) {
   encoder->putn(points.data(), points.size() * sizeof(S2Point));
 }
 
+// Encodes a vector of points in the UNCOMPRESSED_ALIGNED format.  This is
+// identical to the UNCOMPRESSED format except that the header is followed by
+// a one-byte padding count and 0-7 zero padding bytes, chosen so that the
+// array of S2Points starts at an 8-byte-aligned offset from the beginning of
+// the Encoder's buffer.
+void EncodeS2PointVectorAligned(Span<const S2Point> points, Encoder* encoder) {
+#ifndef IS_LITTLE_ENDIAN
+  ABSL_LOG(FATAL) << "Not implemented on big-endian architectures";
+#endif
+
+  encoder->Ensure(Varint::kMax64 + 8 + points.size() * sizeof(S2Point));
+  uint64 size_format = (points.size() << kEncodingFormatBits |
+                          EncodedS2PointVector::UNCOMPRESSED_ALIGNED);
+  encoder->put_varint64(size_format);
+
+  // Compute the padding needed after the one-byte padding count so that the
+  // point array starts at a multiple of 8 bytes.  (Encoder buffers are
+  // allocated with at least 8-byte alignment, so this also aligns the points
+  // in memory at encoding time.)
+  int padding = -(encoder->length() + 1) & 7;
+  encoder->put8(padding);
+  for (int i = 0; i < padding; ++i) encoder->put8(0);
+  encoder->putn(points.data(), points.size() * sizeof(S2Point));
+}
+
+bool EncodedS2PointVector::InitUncompressedAlignedFormat(Decoder* decoder) {
+  uint64 size;
+  if (!decoder->get_varint64(&size)) return false;
+  size >>= kEncodingFormatBits;
+  if (size > std::numeric_limits<uint32>::max()) return false;
+  size_ = size;
+
+  // Skip the padding that was inserted to align the point array.
+  if (decoder->avail() < 1) return false;
+  uint8 padding = decoder->get8();
+  if (padding > 7 || decoder->avail() < padding) return false;
+  decoder->skip(padding);
+
+  size_t bytes = size_t{size_} * sizeof(S2Point);
+  if (decoder->avail() < bytes) return false;
+
+  uncompressed_.points = reinterpret_cast<const S2Point*>(decoder->skip(0));
+  decoder->skip(bytes);
+  return true;
+}
+
 bool EncodedS2PointVector::InitUncompressedFormat(Decoder* decoder) {
 #if !defined(IS_LITTLE_ENDIAN) || defined(__arm__) || \
   defined(ABSL_INTERNAL_NEED_ALIGNED_LOADS)
@@ -873,4 +945,59 @@ S2Point EncodedS2PointVector::DecodeCellIdsFormat(int i) const {
                          S2::STtoUV(S2::SiTitoST(ti))).Normalize();
 }
 
+void EncodedS2PointVector::DecodeCellIdsFormatRange(int begin, int count,
+                                                    S2Point* out) const {
+  // This is equivalent to calling DecodeCellIdsFormat() for each index in
+  // [begin, begin + count), except that the block lookup, header, and offset
+  // are decoded only once per block of kBlockSize values.
+  int shift = S2CellId::kMaxLevel - cell_ids_.level;
+  int i = begin;
+  const int end = begin + count;
+  while (i < end) {
+    // Decode the header and offset of the block containing index "i" (see
+    // DecodeCellIdsFormat for documentation of the encoding).
+    const char* ptr = cell_ids_.blocks.GetStart(i >> kBlockShift);
+    uint8 header = *ptr++;
+    int overlap_nibbles = (header >> 3) & 1;
+    int offset_bytes = (header & 7) + overlap_nibbles;
+    int delta_nibbles = (header >> 4) + 1;
+    uint64 offset = 0;
+    if (offset_bytes > 0) {
+      int offset_shift = (delta_nibbles - overlap_nibbles) << 2;
+      offset = GetUintWithLength<uint64>(ptr, offset_bytes) << offset_shift;
+      ptr += offset_bytes;
+    }
+    int block_start = i & ~(kBlockSize - 1);
+    int block_size = min<int>(kBlockSize, size_ - block_start);
+    int delta_bytes = (delta_nibbles + 1) >> 1;
+    const char* exceptions = ptr + ((block_size * delta_nibbles + 1) >> 1);
+
+    // Decode all requested values within this block.
+    for (int block_end = min<int>(end, block_start + block_size);
+         i < block_end; ++i, ++out) {
+      int delta_nibble_offset = (i & (kBlockSize - 1)) * delta_nibbles;
+      uint64 delta = GetUintWithLength<uint64>(
+          ptr + (delta_nibble_offset >> 1), delta_bytes);
+      delta >>= (delta_nibble_offset & 1) << 2;
+      delta &= BitMask(delta_nibbles << 2);
+      if (cell_ids_.have_exceptions) {
+        if (delta < kBlockSize) {
+          *out = *reinterpret_cast<const S2Point*>(
+              exceptions + delta * sizeof(S2Point));
+          continue;
+        }
+        delta -= kBlockSize;
+      }
+      uint64 value = cell_ids_.base + offset + delta;
+      uint32 sj, tj;
+      DeinterleaveUint32BitPairs(value, &sj, &tj);
+      int si = (((sj << 1) | 1) << shift) & 0x7fffffff;
+      int ti = (((tj << 1) | 1) << shift) & 0x7fffffff;
+      int face = ((sj << shift) >> 30) | (((tj << (shift + 1)) >> 29) & 4);
+      *out = S2::FaceUVtoXYZ(face, S2::STtoUV(S2::SiTitoST(si)),
+                             S2::STtoUV(S2::SiTitoST(ti))).Normalize();
+    }
+  }
+}
+
 }  // namespace s2coding
@@ -42,6 +42,18 @@ namespace s2coding {
 void EncodeS2PointVector(absl::Span<const S2Point> points, CodingHint hint,
                          Encoder* encoder);
 
+// Like EncodeS2PointVector with CodingHint::FAST, except that padding is
+// inserted after the header so that the array of S2Points starts at an
+// 8-byte-aligned offset from the beginning of the Encoder's buffer.  This
+// allows the points to be read with aligned 64-bit loads (a prerequisite for
+// vectorized decoding) provided that the encoded data is later placed in
+// memory at an 8-byte-aligned address.  The profile is declared in the format
+// byte and detected transparently by Init(), but note that readers predating
+// this format will fail to decode it, so it should only be used when all
+// consumers are known to support it.
+void EncodeS2PointVectorAligned(absl::Span<const S2Point> points,
+                                Encoder* encoder);
+
 // This class represents an encoded vector of S2Points.  Values are decoded
 // only when they are accessed.  This allows for very fast initialization and
 // no additional memory use beyond the encoded data.  The encoded data is not
@@ -68,6 +80,14 @@ class EncodedS2PointVector {
   // Returns the element at the given index.
   S2Point operator[](int i) const;
 
+  // Decodes the "count" elements starting at index "begin" and stores them at
+  // "out".  This is faster than decoding elements one at a time because the
+  // per-block decoding state (block lookup, header, and offset) is computed
+  // only once per block rather than once per point.
+  //
+  // REQUIRES: 0 <= begin && begin + count <= size()
+  void DecodeRange(int begin, int count, S2Point* out) const;
+
   // Decodes and returns the entire original vector.
   std::vector<S2Point> Decode() const;
 
@@ -83,10 +103,13 @@ class EncodedS2PointVector {
                                   Encoder*);
   friend void EncodeS2PointVectorFast(absl::Span<const S2Point>, Encoder*);
   friend void EncodeS2PointVectorCompact(absl::Span<const S2Point>, Encoder*);
+  friend void EncodeS2PointVectorAligned(absl::Span<const S2Point>, Encoder*);
 
   bool InitUncompressedFormat(Decoder* decoder);
+  bool InitUncompressedAlignedFormat(Decoder* decoder);
   bool InitCellIdsFormat(Decoder* decoder);
   S2Point DecodeCellIdsFormat(int i) const;
+  void DecodeCellIdsFormatRange(int begin, int count, S2Point* out) const;
 
   // We use a tagged union to represent multiple formats, as opposed to an
   // abstract base class or templating.  This represents the best compromise
@@ -100,6 +123,9 @@ class EncodedS2PointVector {
   enum Format : uint8 {
     UNCOMPRESSED = 0,
     CELL_IDS = 1,
+    // Like UNCOMPRESSED, but the point array is padded to start at an
+    // 8-byte-aligned offset from the beginning of the encoding buffer.
+    UNCOMPRESSED_ALIGNED = 2,
   };
   Format format_;
   uint32 size_;
@@ -131,6 +157,7 @@ inline size_t EncodedS2PointVector::size() const {
 inline S2Point EncodedS2PointVector::operator[](int i) const {
   switch (format_) {
     case Format::UNCOMPRESSED:
+    case Format::UNCOMPRESSED_ALIGNED:
       return uncompressed_.points[i];
 
     case Format::CELL_IDS:
@@ -292,6 +292,37 @@ TEST(EncodedS2PointVectorTest, AllExceptionsBlock) {
   TestEncodedS2PointVector(points, CodingHint::FAST, 434);
 }
 
+TEST(EncodedS2PointVectorTest, DecodeRangeMatchesElementAccess) {
+  // Build a vector that spans several blocks and includes exceptions, then
+  // verify that DecodeRange() matches operator[] for a variety of subranges
+  // (including ranges that start and end in the middle of a block).
+  vector<S2Point> points;
+  for (int i = 0; i < 5 * kBlockSize; ++i) {
+    if (i % 7 == 3) {
+      points.push_back(S2Testing::RandomPoint());  // Encoded as an exception.
+    } else {
+      points.push_back(S2Testing::GetRandomCellId(S2CellId::kMaxLevel)
+                       .ToPoint());
+    }
+  }
+  for (CodingHint hint : {CodingHint::FAST, CodingHint::COMPACT}) {
+    Encoder encoder;
+    EncodeS2PointVector(points, hint, &encoder);
+    Decoder decoder(encoder.base(), encoder.length());
+    EncodedS2PointVector actual;
+    ASSERT_TRUE(actual.Init(&decoder));
+    for (int iter = 0; iter < 100; ++iter) {
+      int begin = S2Testing::rnd.Uniform(points.size() + 1);
+      int count = S2Testing::rnd.Uniform(points.size() + 1 - begin);
+      vector<S2Point> range(count);
+      actual.DecodeRange(begin, count, range.data());
+      for (int i = 0; i < count; ++i) {
+        EXPECT_EQ(actual[begin + i], range[i]);
+      }
+    }
+  }
+}
+
 TEST(EncodedS2PointVectorTest, FirstAtAllLevels) {
   // Test encoding the first S2CellId at each level (which also happens to have
   // the maximum face, si, and ti values).  All such S2CellIds can be encoded in
@@ -442,4 +473,32 @@ TEST(EncodedS2PointVectorTest, RoundtripEncodingCompact) {
   TestRoundtripEncoding(s2coding::CodingHint::COMPACT);
 }
 
+TEST(EncodedS2PointVectorTest, AlignedEncoding) {
+  // Test that the aligned profile decodes correctly and that the point array
+  // starts at an 8-byte-aligned offset from the start of the buffer.
+  for (int size : {0, 1, 2, 100}) {
+    vector<S2Point> points;
+    for (int i = 0; i < size; ++i) {
+      points.push_back(S2Testing::RandomPoint());
+    }
+    Encoder encoder;
+    EncodeS2PointVectorAligned(points, &encoder);
+    EXPECT_EQ(0, (encoder.length() - points.size() * sizeof(S2Point)) % 8);
+
+    // Copy the encoding into 8-byte-aligned storage so that the decoded
+    // points are aligned in memory as well.
+    auto aligned = make_unique<double[]>(encoder.length() / sizeof(double) + 1);
+    std::memcpy(aligned.get(), encoder.base(), encoder.length());
+    Decoder decoder(aligned.get(), encoder.length());
+    EncodedS2PointVector actual;
+    ASSERT_TRUE(actual.Init(&decoder));
+    EXPECT_EQ(points, actual.Decode());
+
+    // Reserialization preserves the aligned profile.
+    Encoder reencoder;
+    actual.Encode(&reencoder);
+    EXPECT_EQ(0, (reencoder.length() - points.size() * sizeof(S2Point)) % 8);
+  }
+}
+
 }  // namespace s2coding
@@ -0,0 +1,149 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/encoded_s2polygon.h"
+
+#include <memory>
+#include <utility>
+
+#include "absl/flags/flag.h"
+#include "absl/log/absl_check.h"
+
+#include "s2/base/commandlineflags.h"
+#include "s2/base/commandlineflags_declare.h"
+#include "s2/base/types.h"
+#include "s2/s2latlng.h"
+#include "s2/s2latlng_rect.h"
+#include "s2/s2loop.h"
+#include "s2/s2point.h"
+#include "s2/s2polygon.h"
+#include "s2/util/coding/coder.h"
+
+using std::make_unique;
+
+S2_DECLARE_int32(s2polygon_decode_max_num_loops);
+S2_DECLARE_int32(s2polygon_decode_max_num_vertices);
+
+namespace {
+
+// The encoding version emitted by S2Polygon::EncodeUncompressed() (see
+// kCurrentUncompressedEncodingVersionNumber in s2polygon.cc).
+const unsigned char kUncompressedEncodingVersion = 1;
+
+// The encoding version emitted by S2Loop::Encode() (see
+// kCurrentLosslessEncodingVersionNumber in s2loop.cc).
+const unsigned char kLosslessLoopEncodingVersion = 1;
+
+}  // namespace
+
+bool EncodedS2Polygon::Init(Decoder* decoder) {
+  base_ = nullptr;
+  length_ = 0;
+  loops_.clear();
+  decoded_loops_.clear();
+  eager_ = nullptr;
+  bound_ = S2LatLngRect::Empty();
+
+  if (decoder->avail() < sizeof(unsigned char)) return false;
+  const char* base = decoder->skip(0);
+  if (*reinterpret_cast<const unsigned char*>(base) !=
+      kUncompressedEncodingVersion) {
+    // The compressed format interleaves variable-length vertex blocks that
+    // cannot be skipped without parsing them, so decode it eagerly.
+    auto polygon = make_unique<S2Polygon>();
+    if (!polygon->Decode(decoder)) return false;
+    eager_ = std::move(polygon);
+    bound_ = eager_->GetRectBound();
+    return true;
+  }
+  decoder->get8();  // Version, checked above.
+  if (decoder->avail() < 2 * sizeof(uint8) + sizeof(uint32)) return false;
+  decoder->get8();  // Ignore irrelevant serialized owns_loops_ value.
+  decoder->get8();  // Ignore irrelevant serialized has_holes_ value.
+  const uint32 num_loops = decoder->get32();
+  if (num_loops > static_cast<uint32>(
+                      absl::GetFlag(FLAGS_s2polygon_decode_max_num_loops))) {
+    return false;
+  }
+  loops_.reserve(num_loops);
+  for (uint32 i = 0; i < num_loops; ++i) {
+    const size_t offset = decoder->skip(0) - base;
+    if (decoder->avail() < sizeof(uint8) + sizeof(uint32)) return false;
+    if (decoder->get8() != kLosslessLoopEncodingVersion) return false;
+    const uint32 num_vertices = decoder->get32();
+    if (num_vertices > static_cast<uint32>(absl::GetFlag(
+                           FLAGS_s2polygon_decode_max_num_vertices))) {
+      return false;
+    }
+    const size_t vertex_bytes = num_vertices * sizeof(S2Point);
+    if (decoder->avail() < vertex_bytes + sizeof(uint8) + sizeof(uint32)) {
+      return false;
+    }
+    decoder->skip(vertex_bytes + sizeof(uint8) + sizeof(uint32));
+    S2LatLngRect loop_bound;
+    if (!loop_bound.Decode(decoder)) return false;
+
+    // Ignore any empty loops that were previously encoded, the way
+    // S2Polygon::Decode() does.  Single-vertex loops are either empty or
+    // full and must be decoded to tell which, but they are tiny.
+    if (num_vertices == 0) continue;
+    std::unique_ptr<S2Loop> decoded;
+    if (num_vertices == 1) {
+      Decoder loop_decoder(base + offset, decoder->skip(0) - (base + offset));
+      decoded = make_unique<S2Loop>();
+      if (!decoded->Decode(&loop_decoder)) return false;
+      if (decoded->is_empty()) continue;
+    }
+    loops_.push_back(LoopEntry{offset, loop_bound});
+    decoded_loops_.push_back(std::move(decoded));
+  }
+  if (!bound_.Decode(decoder)) return false;
+  base_ = base;
+  length_ = decoder->skip(0) - base;
+  return true;
+}
+
+int EncodedS2Polygon::num_loops() const {
+  if (eager_ != nullptr) return eager_->num_loops();
+  return loops_.size();
+}
+
+const S2Loop& EncodedS2Polygon::loop(int i) {
+  if (eager_ != nullptr) return *eager_->loop(i);
+  ABSL_DCHECK_GE(i, 0);
+  ABSL_DCHECK_LT(i, num_loops());
+  if (decoded_loops_[i] == nullptr) {
+    Decoder decoder(base_ + loops_[i].offset, length_ - loops_[i].offset);
+    auto decoded = make_unique<S2Loop>();
+    // The loop framing was already validated by Init().
+    ABSL_CHECK(decoded->Decode(&decoder));
+    decoded_loops_[i] = std::move(decoded);
+  }
+  return *decoded_loops_[i];
+}
+
+bool EncodedS2Polygon::Contains(const S2Point& p) {
+  if (eager_ != nullptr) return eager_->Contains(p);
+  if (!bound_.Contains(p)) return false;
+  // A point is inside the polygon iff it is inside an odd number of loops
+  // (see S2Polygon::Contains).  Loops whose bound excludes the point cannot
+  // contain it and are skipped without being decoded.
+  bool inside = false;
+  for (size_t i = 0; i < loops_.size(); ++i) {
+    if (!loops_[i].bound.Contains(p)) continue;
+    inside ^= loop(i).Contains(p);
+  }
+  return inside;
+}
@@ -0,0 +1,103 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef S2_ENCODED_S2POLYGON_H_
+#define S2_ENCODED_S2POLYGON_H_
+
+#include <memory>
+#include <vector>
+
+#include "s2/_fp_contract_off.h"
+#include "s2/s2latlng_rect.h"
+#include "s2/s2loop.h"
+#include "s2/s2point.h"
+#include "s2/s2polygon.h"
+#include "s2/util/coding/coder.h"
+
+// EncodedS2Polygon is a lazily decoded view of a polygon stored in the
+// legacy S2Polygon::Encode() format.  S2Polygon::Decode() materializes
+// every loop eagerly, copying all of its vertices, even when the caller
+// only needs containment tests over a small area.  Init() instead just
+// scans the encoding to locate each loop and read its bound; a loop's
+// vertices are decoded the first time a query actually needs them, so
+// queries against huge stored polygons only pay for the loops whose
+// bounds are near the query points.
+//
+// REQUIRES: The Decoder data buffer must outlive this object (loops are
+// decoded from it on demand, without copying it).
+//
+// CAVEATS:
+//
+//  - Only the uncompressed format (see S2Polygon::EncodeUncompressed)
+//    supports lazy decoding, since its loop blocks have a known size and
+//    can be skipped.  The compressed format stores loop vertices as
+//    variable-length byte streams that cannot be skipped without parsing
+//    them, so Init() falls back to decoding such polygons eagerly.
+//
+//  - Unlike EncodedS2ShapeIndex, this class caches decoded loops without
+//    any synchronization, so queries require exclusive access.
+class EncodedS2Polygon {
+ public:
+  EncodedS2Polygon() = default;
+
+  // EncodedS2Polygon is neither copyable nor movable (loop() hands out
+  // references to the cached loops).
+  EncodedS2Polygon(const EncodedS2Polygon&) = delete;
+  EncodedS2Polygon& operator=(const EncodedS2Polygon&) = delete;
+
+  // Initializes from data encoded with S2Polygon::Encode() or
+  // S2Polygon::EncodeUncompressed().  Returns true on success.
+  bool Init(Decoder* decoder);
+
+  // Returns the number of non-empty loops of the polygon.  (Like
+  // S2Polygon::Decode(), any encoded empty loops are dropped.)
+  int num_loops() const;
+
+  // Returns loop "i", decoding and caching it if this is its first use.
+  //
+  // REQUIRES: 0 <= i < num_loops()
+  const S2Loop& loop(int i);
+
+  // Returns a conservative bound on the polygon (decoded by Init).
+  const S2LatLngRect& GetRectBound() const { return bound_; }
+
+  // Returns true if the polygon contains the given point, decoding only
+  // the loops whose bound contains it.  Returns the same result as
+  // S2Polygon::Contains(p) on the fully decoded polygon.
+  bool Contains(const S2Point& p);
+
+ private:
+  struct LoopEntry {
+    // Byte offset of the loop's encoding relative to base_.
+    size_t offset;
+    // The bound stored with the loop (covering the loop's interior).
+    S2LatLngRect bound;
+  };
+
+  const char* base_ = nullptr;  // Start of the encoded polygon.
+  size_t length_ = 0;           // Number of encoded polygon bytes.
+  std::vector<LoopEntry> loops_;
+
+  // Lazily decoded loops, parallel to loops_ (nullptr if not decoded yet).
+  std::vector<std::unique_ptr<S2Loop>> decoded_loops_;
+
+  // Holds the whole polygon when the encoding does not support lazy
+  // decoding (see class comments).
+  std::unique_ptr<S2Polygon> eager_;
+
+  S2LatLngRect bound_ = S2LatLngRect::Empty();
+};
+
+#endif  // S2_ENCODED_S2POLYGON_H_
@@ -0,0 +1,104 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/encoded_s2polygon.h"
+
+#include <memory>
+
+#include <gtest/gtest.h>
+#include "s2/s1angle.h"
+#include "s2/s2cap.h"
+#include "s2/s2latlng.h"
+#include "s2/s2point.h"
+#include "s2/s2polygon.h"
+#include "s2/s2testing.h"
+#include "s2/s2text_format.h"
+#include "s2/util/coding/coder.h"
+
+using std::unique_ptr;
+
+namespace {
+
+// Checks that the lazily decoded polygon matches "polygon" when initialized
+// from the given encoding of it.
+void ExpectMatchesPolygon(const S2Polygon& polygon, const Encoder& encoder) {
+  Decoder decoder(encoder.base(), encoder.length());
+  EncodedS2Polygon encoded;
+  ASSERT_TRUE(encoded.Init(&decoder));
+  EXPECT_EQ(polygon.num_loops(), encoded.num_loops());
+  EXPECT_EQ(polygon.GetRectBound(), encoded.GetRectBound());
+  S2Cap cap = polygon.GetCapBound();
+  for (int i = 0; i < 1000; ++i) {
+    S2Point p = S2Testing::SamplePoint(cap);
+    EXPECT_EQ(polygon.Contains(p), encoded.Contains(p));
+  }
+}
+
+TEST(EncodedS2Polygon, UncompressedPolygonWithHole) {
+  unique_ptr<S2Polygon> polygon(s2textformat::MakePolygonOrDie(
+      "0:0, 0:10, 10:10, 10:0; 2:2, 8:2, 8:8, 2:8"));
+  Encoder encoder;
+  polygon->EncodeUncompressed(&encoder);
+  ExpectMatchesPolygon(*polygon, encoder);
+}
+
+TEST(EncodedS2Polygon, CompressedFallsBackToEagerDecode) {
+  unique_ptr<S2Polygon> unsnapped(s2textformat::MakePolygonOrDie(
+      "0:0, 0:10, 10:10, 10:0; 2:2, 8:2, 8:8, 2:8"));
+  S2Polygon polygon;
+  polygon.InitToSnapped(*unsnapped);
+  Encoder encoder;
+  polygon.Encode(&encoder);
+  ExpectMatchesPolygon(polygon, encoder);
+}
+
+TEST(EncodedS2Polygon, EmptyPolygon) {
+  S2Polygon empty;
+  Encoder encoder;
+  empty.EncodeUncompressed(&encoder);
+  Decoder decoder(encoder.base(), encoder.length());
+  EncodedS2Polygon encoded;
+  ASSERT_TRUE(encoded.Init(&decoder));
+  EXPECT_EQ(0, encoded.num_loops());
+  EXPECT_FALSE(encoded.Contains(S2Testing::RandomPoint()));
+}
+
+TEST(EncodedS2Polygon, FullPolygon) {
+  unique_ptr<S2Polygon> full(s2textformat::MakePolygonOrDie("full"));
+  Encoder encoder;
+  full->EncodeUncompressed(&encoder);
+  Decoder decoder(encoder.base(), encoder.length());
+  EncodedS2Polygon encoded;
+  ASSERT_TRUE(encoded.Init(&decoder));
+  EXPECT_EQ(1, encoded.num_loops());
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_TRUE(encoded.Contains(S2Testing::RandomPoint()));
+  }
+}
+
+TEST(EncodedS2Polygon, InitFailsOnTruncatedData) {
+  unique_ptr<S2Polygon> polygon(
+      s2textformat::MakePolygonOrDie("0:0, 0:10, 10:10, 10:0"));
+  Encoder encoder;
+  polygon->EncodeUncompressed(&encoder);
+  for (size_t length : {size_t{0}, size_t{1}, size_t{7},
+                        encoder.length() - 1}) {
+    Decoder decoder(encoder.base(), length);
+    EncodedS2Polygon encoded;
+    EXPECT_FALSE(encoded.Init(&decoder)) << length;
+  }
+}
+
+}  // namespace
@@ -17,12 +17,22 @@
 
 #include "s2/encoded_s2shape_index.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <numeric>
+#include <thread>
 #include <vector>
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "absl/numeric/bits.h"
+
 #include "s2/base/casts.h"
 #include "s2/base/types.h"
 #include "s2/util/bits/bits.h"
@@ -32,6 +42,8 @@
 #include "s2/encoded_string_vector.h"
 #include "s2/mutable_s2shape_index.h"
 #include "s2/s2cell_id.h"
+#include "s2/s2cell_union.h"
+#include "s2/s2memory_tracker.h"
 #include "s2/s2point.h"
 #include "s2/s2shape.h"
 #include "s2/s2shape_index.h"
@@ -70,7 +82,11 @@ const S2ShapeIndexCell* EncodedS2ShapeIndex::GetCell(int i) const {
   //
   // Note that we do still use a lock for the write path to ensure that
   // cells_[i] and cell_decoded(i) are updated together atomically.
-  if (cell_decoded(i)) return cells_[i];
+  if (cell_decoded(i)) {
+    count_cell_hit();
+    set_cell_referenced(i);
+    return cells_[i];
+  }
 
   // Decode the cell before acquiring the spinlock in order to minimize the
   // time that the lock is held.
@@ -82,17 +98,40 @@ const S2ShapeIndexCell* EncodedS2ShapeIndex::GetCell(int i) const {
   // Recheck cell_decoded(i) once we hold the lock in case another thread
   // has decoded this cell in the meantime.
   SpinLockHolder l(&cells_lock_);
-  if (cell_decoded(i)) return cells_[i];
+  if (cell_decoded(i)) {
+    count_cell_hit();
+    set_cell_referenced(i);
+    return cells_[i];
+  }
+  cell_misses_.fetch_add(1, std::memory_order_relaxed);
+  const size_t cell_bytes = GetDecodedCellBytes(*cell);
+  decoded_cell_bytes_.fetch_add(cell_bytes, std::memory_order_relaxed);
+  mem_tracker_.Tally(cell_bytes);
 
   // Update the cell, setting cells_[i] before cell_decoded(i).
   cells_[i] = cell.get();
   set_cell_decoded(i);
+  set_cell_referenced(i);
   if (cell_cache_.size() < static_cast<size_t>(max_cell_cache_size())) {
     cell_cache_.push_back(i);
   }
   return cell.release();  // Ownership has been transferred to cells_.
 }
 
+// Returns the approximate number of heap bytes used by a decoded index cell,
+// including the edge ids allocated by its clipped shapes.
+size_t EncodedS2ShapeIndex::GetDecodedCellBytes(const S2ShapeIndexCell& cell) {
+  size_t bytes = sizeof(S2ShapeIndexCell) +
+      S2MemoryTracker::Client::GetCompactArrayAllocBytes(cell.shapes_);
+  for (int s = 0; s < cell.num_clipped(); ++s) {
+    const S2ClippedShape& clipped = cell.clipped(s);
+    // Edge ids are heap-allocated unless they form a single contiguous run
+    // or there are at most S2ClippedShape::kMaxInlineEdges of them.
+    if (!clipped.is_inline()) bytes += clipped.num_edges() * sizeof(int32);
+  }
+  return bytes;
+}
+
 EncodedS2ShapeIndex::EncodedS2ShapeIndex() = default;
 
 EncodedS2ShapeIndex::~EncodedS2ShapeIndex() {
@@ -140,10 +179,24 @@ bool EncodedS2ShapeIndex::Init(Decoder* decoder,
   //                                NO NO NO
   cells_.reset(new S2ShapeIndexCell*[cell_ids_.size()]);
   cells_decoded_ = vector<std::atomic<uint64>>((cell_ids_.size() + 63) >> 6);
+  cells_referenced_ = vector<std::atomic<uint64>>(cells_decoded_.size());
+  clock_hand_ = 0;
+  for (CellHitShard& shard : cell_hits_) {
+    shard.count.store(0, std::memory_order_relaxed);
+  }
+  cell_misses_.store(0, std::memory_order_relaxed);
 
   return encoded_cells_.Init(decoder);
 }
 
+void EncodedS2ShapeIndex::set_memory_tracker(S2MemoryTracker* tracker) {
+  mem_tracker_.Tally(-mem_tracker_.client_usage_bytes());
+  mem_tracker_.Init(tracker, "EncodedS2ShapeIndex");
+  if (mem_tracker_.is_active()) {
+    mem_tracker_.Tally(decoded_cell_bytes_.load(std::memory_order_relaxed));
+  }
+}
+
 void EncodedS2ShapeIndex::Encode(Encoder* encoder) const {
   // Re-encode the max edges and version number.
   encoder->Ensure(Varint::kMax64);
@@ -155,6 +208,86 @@ void EncodedS2ShapeIndex::Encode(Encoder* encoder) const {
   encoded_cells_.Encode(encoder);
 }
 
+// Advises the operating system to start paging in the given byte range.
+// Errors are deliberately ignored: madvise() is purely an optimization hint,
+// and it is harmless to call it on memory that is not file-backed.
+static void PrefetchRange(const char* begin, const char* end) {
+#if defined(__unix__) || defined(__APPLE__)
+  const uintptr_t kPageMask = static_cast<uintptr_t>(getpagesize()) - 1;
+  uintptr_t start = reinterpret_cast<uintptr_t>(begin) & ~kPageMask;
+  size_t length = reinterpret_cast<uintptr_t>(end) - start;
+  madvise(reinterpret_cast<void*>(start), length, MADV_WILLNEED);
+#else
+  static_cast<void>(begin);
+  static_cast<void>(end);
+#endif
+}
+
+void EncodedS2ShapeIndex::Prefetch(const S2CellUnion& cells) const {
+  for (S2CellId id : cells) {
+    size_t begin = cell_ids_.lower_bound(id.range_min());
+    size_t end = cell_ids_.lower_bound(id.range_max().next());
+    if (begin >= end) continue;
+    // The encoded cells are stored consecutively in a single buffer, so all
+    // index cells in the range can be advised with one call.
+    absl::string_view last = encoded_cells_[end - 1];
+    PrefetchRange(encoded_cells_.GetStart(begin), last.data() + last.size());
+  }
+}
+
+// Decodes the cells at the given index positions using up to "num_threads"
+// threads.  GetCell() skips positions that are already decoded and is safe to
+// call concurrently, so no further coordination is needed.
+void EncodedS2ShapeIndex::WarmUpPositions(const vector<int>& positions,
+                                          int num_threads) const {
+  // Decoding a cell is cheap; threading does not pay off unless each thread
+  // decodes a reasonable number of cells.
+  static constexpr int kMinCellsPerThread = 64;
+  num_threads = std::min(
+      num_threads, static_cast<int>(positions.size()) / kMinCellsPerThread);
+  if (num_threads <= 1) {
+    for (int pos : positions) GetCell(pos);
+    return;
+  }
+  vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([this, &positions, t, num_threads]() {
+      for (size_t i = t; i < positions.size(); i += num_threads) {
+        GetCell(positions[i]);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+}
+
+void EncodedS2ShapeIndex::WarmUp(int num_threads) const {
+  vector<int> positions(cell_ids_.size());
+  std::iota(positions.begin(), positions.end(), 0);
+  WarmUpPositions(positions, num_threads);
+}
+
+void EncodedS2ShapeIndex::WarmUp(const S2CellUnion& cells,
+                                 int num_threads) const {
+  vector<int> positions;
+  for (S2CellId id : cells) {
+    size_t begin = cell_ids_.lower_bound(id.range_min());
+    size_t end = cell_ids_.lower_bound(id.range_max().next());
+    for (size_t i = begin; i < end; ++i) {
+      positions.push_back(i);
+    }
+  }
+  WarmUpPositions(positions, num_threads);
+}
+
+int EncodedS2ShapeIndex::num_cells_decoded() const {
+  int count = 0;
+  for (const auto& group : cells_decoded_) {
+    count += absl::popcount(group.load(std::memory_order_relaxed));
+  }
+  return count;
+}
+
 void EncodedS2ShapeIndex::Minimize() {
   if (cells_ == nullptr) return;  // Not initialized yet.
 
@@ -172,6 +305,7 @@ void EncodedS2ShapeIndex::Minimize() {
     // but for a huge polygon with 1 million cells that's still 16000 cycles.)
     for (int pos : cell_cache_) {
       cells_decoded_[pos >> 6].store(0, std::memory_order_relaxed);
+      cells_referenced_[pos >> 6].store(0, std::memory_order_relaxed);
       delete cells_[pos];
     }
   } else {
@@ -185,9 +319,63 @@ void EncodedS2ShapeIndex::Minimize() {
         bits &= bits - 1;
       } while (bits != 0);
       cells_decoded_[i].store(0, std::memory_order_relaxed);
+      cells_referenced_[i].store(0, std::memory_order_relaxed);
     }
   }
   cell_cache_.clear();
+  mem_tracker_.Tally(
+      -static_cast<int64>(decoded_cell_bytes_.load(std::memory_order_relaxed)));
+  decoded_cell_bytes_.store(0, std::memory_order_relaxed);
+}
+
+void EncodedS2ShapeIndex::TrimDecodedCells(size_t max_bytes) {
+  if (cells_ == nullptr) return;  // Not initialized yet.
+  size_t bytes = decoded_cell_bytes_.load(std::memory_order_relaxed);
+  const size_t initial_bytes = bytes;
+
+  // CLOCK ("second chance") eviction.  The first pass evicts decoded cells
+  // whose reference bit is clear and clears the bits of the cells it spares;
+  // the second pass handles the case where every surviving cell had been
+  // referenced but the budget is still exceeded.  The sweep resumes where
+  // the previous one stopped (clock_hand_) so that eviction pressure is
+  // spread evenly over the index.
+  const size_t num_groups = cells_decoded_.size();
+  for (int pass = 0; pass < 2 && bytes > max_bytes; ++pass) {
+    for (size_t n = 0; n < num_groups && bytes > max_bytes; ++n) {
+      const size_t j = clock_hand_;
+      clock_hand_ = (clock_hand_ + 1 < num_groups) ? clock_hand_ + 1 : 0;
+      uint64 decoded = cells_decoded_[j].load(std::memory_order_relaxed);
+      if (decoded == 0) continue;
+      uint64 evict = decoded;
+      if (pass == 0) {
+        evict &= ~cells_referenced_[j].load(std::memory_order_relaxed);
+        // The cells spared in this group have consumed their second chance.
+        cells_referenced_[j].store(0, std::memory_order_relaxed);
+      }
+      while (evict != 0 && bytes > max_bytes) {
+        int offset = Bits::FindLSBSetNonZero64(evict);
+        S2ShapeIndexCell* cell = cells_[(j << 6) + offset];
+        bytes -= GetDecodedCellBytes(*cell);
+        delete cell;
+        decoded &= ~(1ULL << offset);
+        evict &= evict - 1;
+      }
+      cells_decoded_[j].store(decoded, std::memory_order_relaxed);
+    }
+  }
+  if (bytes == initial_bytes) return;
+  decoded_cell_bytes_.store(bytes, std::memory_order_relaxed);
+  mem_tracker_.Tally(static_cast<int64>(bytes) -
+                     static_cast<int64>(initial_bytes));
+
+  // Some entries of cell_cache_ may now refer to evicted cells; drop them so
+  // that Minimize() and the destructor do not delete cells twice.  (Cells
+  // that are decoded again after eviction are re-added by GetCell() if there
+  // is still room in the cache.)
+  cell_cache_.erase(
+      std::remove_if(cell_cache_.begin(), cell_cache_.end(),
+                     [this](int pos) { return !cell_decoded(pos); }),
+      cell_cache_.end());
 }
 
 size_t EncodedS2ShapeIndex::SpaceUsed() const {
@@ -197,6 +385,7 @@ size_t EncodedS2ShapeIndex::SpaceUsed() const {
   size += shapes_.capacity() * sizeof(std::atomic<S2Shape*>);
   size += cell_ids_.size() * sizeof(std::atomic<S2ShapeIndexCell*>);  // cells_
   size += cells_decoded_.capacity() * sizeof(std::atomic<uint64>);
+  size += cells_referenced_.capacity() * sizeof(std::atomic<uint64>);
   size += cell_cache_.capacity() * sizeof(int);
   return size;
 }
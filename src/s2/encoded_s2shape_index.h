@@ -20,8 +20,11 @@
 
 #include <cstddef>
 
+#include <array>
 #include <atomic>
+#include <functional>
 #include <memory>
+#include <thread>
 #include <vector>
 
 #include "s2/base/types.h"
@@ -32,10 +35,13 @@
 #include "s2/encoded_string_vector.h"
 #include "s2/mutable_s2shape_index.h"
 #include "s2/s2cell_id.h"
+#include "s2/s2memory_tracker.h"
 #include "s2/s2point.h"
 #include "s2/s2shape.h"
 #include "s2/s2shape_index.h"
 
+class S2CellUnion;
+
 // EncodedS2ShapeIndex is an S2ShapeIndex implementation that works directly
 // with encoded data.  Rather than decoding everything in advance, geometry is
 // decoded incrementally (down to individual edges) as needed.  It can be
@@ -120,11 +126,12 @@
 //                               expanded by a given radius.
 //
 // EncodedS2ShapeIndex is thread-compatible, meaning that const methods are
-// thread safe, and non-const methods are not thread safe.  The only non-const
-// method is Minimize(), so if you plan to call Minimize() while other threads
-// are actively using the index that you must use an external reader-writer
-// lock such as absl::Mutex to guard access to it.  (There is no global state
-// and therefore each index can be guarded independently.)
+// thread safe, and non-const methods are not thread safe.  The only
+// non-const methods are Minimize(), TrimDecodedCells(), and
+// set_memory_tracker(), so if you plan to call any of them while other
+// threads are actively using the index then you must use an external
+// reader-writer lock such as absl::Mutex to guard access to it.  (There is
+// no global state and therefore each index can be guarded independently.)
 class EncodedS2ShapeIndex final : public S2ShapeIndex {
  public:
   using Options = MutableS2ShapeIndex::Options;
@@ -150,6 +157,94 @@ class EncodedS2ShapeIndex final : public S2ShapeIndex {
   // Copies the encoded byte stream into a new encoder.
   void Encode(Encoder* encoder) const override;
 
+  // Advises the operating system to start paging in the encoded bytes of
+  // every index cell that intersects "cells" (using madvise(MADV_WILLNEED)
+  // where available; this method is a no-op on other platforms).
+  //
+  // This is useful when the encoded data is backed by a memory-mapped file
+  // that is much larger than RAM.  Since EncodedS2ShapeIndex never copies
+  // the encoded data, it can be initialized directly over such a mapping:
+  //
+  //   void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  //   Decoder decoder(data, size);
+  //   EncodedS2ShapeIndex index;
+  //   index.Init(&decoder, s2shapeutil::LazyDecodeShapeFactory(&decoder));
+  //
+  // Issuing a Prefetch() for the covering of an upcoming query then overlaps
+  // the read-ahead I/O with other work, rather than taking a major page
+  // fault for each cold index cell visited by the query.  The encoded data
+  // is not decoded or cached by this method.
+  void Prefetch(const S2CellUnion& cells) const;
+
+  // Decodes index cells ahead of their first use, so that queries do not pay
+  // decode latency in the serving path (e.g., during a query storm right
+  // after deployment).  The first overload decodes every cell in the index;
+  // the second decodes only the cells that intersect "cells" (e.g., a
+  // covering of the expected query region).  Cells that have already been
+  // decoded are skipped.  Up to "num_threads" threads are used.
+  //
+  // Decoding uses the same machinery as the lazy decoding done on the query
+  // path, so WarmUp() is safe to call from a background thread while other
+  // threads are querying the index; a query planner can likewise start
+  // decoding the cells for the next request while the current one computes.
+  void WarmUp(int num_threads) const;
+  void WarmUp(const S2CellUnion& cells, int num_threads) const;
+
+  // Returns the number of index cells that have been decoded so far.  Since
+  // cells are decoded lazily, this indicates how much of the index a given
+  // workload actually touches (e.g., for monitoring the effectiveness of
+  // LazyDecodeShapeFactory or WarmUp on a serving dashboard).  The cost is
+  // proportional to the total number of cells in the index, not the number
+  // decoded.
+  int num_cells_decoded() const;
+
+  // Reduces the memory used by decoded index cells to at most "max_bytes",
+  // preferring to evict the cells that have been referenced least recently.
+  // Eviction uses a CLOCK ("second chance") policy: each decoded cell has a
+  // reference bit that is set whenever the cell is accessed, and the sweep
+  // evicts decoded cells whose bit is clear while clearing the bits of the
+  // cells it spares.  Evicted cells are simply decoded again if they are
+  // accessed later, so this method never affects query results.
+  //
+  // This makes it possible to maintain a bounded decode budget over a set of
+  // long-lived indexes: call TrimDecodedCells() periodically (e.g. between
+  // query batches) and the hot working set stays decoded while cold cells
+  // return to their compressed form.  Like Minimize(), this method is not
+  // const and must be synchronized externally with any concurrent use of the
+  // index; unlike Minimize(), it does not discard the entire working set.
+  void TrimDecodedCells(size_t max_bytes);
+
+  // Returns the approximate number of heap bytes used by decoded index
+  // cells.  This is the quantity that TrimDecodedCells() bounds; it does not
+  // include the encoded data (owned by the client) or the decoded S2Shapes.
+  size_t decoded_cell_bytes() const;
+
+  // Returns the number of cell accesses that found the cell already decoded
+  // (hits), and the number that had to decode it first (misses).  Useful for
+  // monitoring how well the decode budget given to TrimDecodedCells() covers
+  // the working set (e.g., on a serving dashboard).
+  int64 num_cell_hits() const;
+  int64 num_cell_misses() const;
+
+  // Specifies that the memory used by decoded index cells should be tracked
+  // by the given S2MemoryTracker.  Note that this does not include the
+  // encoded data (which is owned by the client and never copied), nor the
+  // decoded S2Shapes.  May be called multiple times to switch trackers or to
+  // stop tracking altogether (by passing nullptr), in which case the usage
+  // due to this index is subtracted.
+  //
+  // Since cells are decoded lazily by const query methods, the tracker is
+  // updated while an internal lock is held.  This serializes updates made
+  // through this index, but a tracker shared with code running concurrently
+  // on other threads must be guarded externally.  If the tracker's limit is
+  // exceeded the error is recorded in memory_tracker()->error(); queries are
+  // not cancelled, but the caller can respond by calling TrimDecodedCells().
+  //
+  // REQUIRES: The lifetime of "tracker" must exceed the lifetime of the
+  //           index unless set_memory_tracker(nullptr) is called first.
+  void set_memory_tracker(S2MemoryTracker* tracker);
+  S2MemoryTracker* memory_tracker() const { return mem_tracker_.tracker(); }
+
   const Options& options() const { return options_; }
 
   // The number of distinct shape ids in the index.  This equals the number of
@@ -242,9 +337,14 @@ class EncodedS2ShapeIndex final : public S2ShapeIndex {
 
   S2Shape* GetShape(int id) const;
   const S2ShapeIndexCell* GetCell(int i) const;
+  void WarmUpPositions(const std::vector<int>& positions,
+                       int num_threads) const;
   bool cell_decoded(int i) const;
   void set_cell_decoded(int i) const;
+  void set_cell_referenced(int i) const;
+  void count_cell_hit() const;
   int max_cell_cache_size() const;
+  static size_t GetDecodedCellBytes(const S2ShapeIndexCell& cell);
 
   std::unique_ptr<ShapeFactory> shape_factory_;
 
@@ -274,6 +374,38 @@ class EncodedS2ShapeIndex final : public S2ShapeIndex {
   // All other elements of cells_ contain uninitialized (random) memory.
   mutable std::vector<std::atomic<uint64>> cells_decoded_;
 
+  // A parallel bit vector with one "reference bit" per cell, set whenever a
+  // decoded cell is accessed and cleared by the CLOCK sweep in
+  // TrimDecodedCells().  A set bit implies that the cell is decoded.
+  mutable std::vector<std::atomic<uint64>> cells_referenced_;
+
+  // The approximate number of heap bytes used by decoded index cells
+  // (see decoded_cell_bytes()).
+  mutable std::atomic<size_t> decoded_cell_bytes_{0};
+
+  // Counters for accesses to decoded index cells (see num_cell_hits()).
+  // Hits are counted on the lock-free read path of GetCell(), where a single
+  // shared counter would put one contended cache line in front of every
+  // query thread.  The hit count is therefore sharded: each thread
+  // increments a shard chosen by its thread id, and num_cell_hits() sums
+  // the shards.  Each shard is given its own cache line to prevent false
+  // sharing.  Misses are only counted while cells_lock_ is held, so a
+  // single counter suffices for them.
+  static constexpr int kNumCellHitShards = 8;  // Must be a power of 2.
+  struct alignas(64) CellHitShard {
+    std::atomic<int64> count{0};
+  };
+  mutable std::array<CellHitShard, kNumCellHitShards> cell_hits_;
+  mutable std::atomic<int64> cell_misses_{0};
+
+  // The position in cells_decoded_ where the next TrimDecodedCells() sweep
+  // resumes, so that eviction pressure is spread evenly over the index.
+  size_t clock_hand_ = 0;
+
+  // Tracks the memory used by decoded index cells if a tracker has been
+  // provided (see set_memory_tracker).  Updated while cells_lock_ is held.
+  mutable S2MemoryTracker::Client mem_tracker_;
+
   // In order to minimize destructor time when very few cells of a large
   // S2ShapeIndex are needed, we keep track of the indices of the first few
   // cells to be decoded.  This lets us avoid scanning the cells_decoded_
@@ -340,7 +472,41 @@ inline bool EncodedS2ShapeIndex::Iterator::Prev() {
 }
 
 inline void EncodedS2ShapeIndex::Iterator::Seek(S2CellId target) {
-  cell_pos_ = index_->cell_ids_.lower_bound(target);
+  // Query patterns such as S2CellIteratorJoin perform long runs of seeks
+  // that each move forward by only a few cells.  Rather than binary
+  // searching the entire cell id vector every time, gallop forward from the
+  // current position with exponentially increasing steps until the target
+  // is bracketed, then binary search within the final step.  This costs
+  // O(log d) where d is the distance moved, falling back to a full binary
+  // search for unpositioned iterators and backward seeks.
+  if (cell_pos_ == num_cells_) {
+    cell_pos_ = index_->cell_ids_.lower_bound(target);
+    return;
+  }
+  if (target <= index_->cell_ids_[cell_pos_]) {
+    // The current position already satisfies the seek unless the target is
+    // at or before the previous cell.
+    if (cell_pos_ == 0 || index_->cell_ids_[cell_pos_ - 1] < target) return;
+    cell_pos_ = index_->cell_ids_.lower_bound(target);
+    return;
+  }
+  int lo = cell_pos_, step = 1;
+  while (step < num_cells_ - lo && index_->cell_ids_[lo + step] < target) {
+    lo += step;
+    step <<= 1;
+  }
+  // Invariant: cell_ids_[lo] < target, and either hi == num_cells_ or
+  // cell_ids_[hi] >= target.
+  int hi = (step < num_cells_ - lo) ? lo + step : num_cells_;
+  while (lo + 1 < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (index_->cell_ids_[mid] < target) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  cell_pos_ = hi;
 }
 
 inline std::unique_ptr<EncodedS2ShapeIndex::IteratorBase>
@@ -372,6 +538,43 @@ inline void EncodedS2ShapeIndex::set_cell_decoded(int i) const {
   group->store(bits | 1ULL << (i & 63), std::memory_order_release);
 }
 
+// Sets the reference bit of the given cell, giving it a "second chance"
+// before the next TrimDecodedCells() sweep evicts it.  The bit is tested
+// before being written so that the common case (bit already set) does not
+// dirty the cache line.
+inline void EncodedS2ShapeIndex::set_cell_referenced(int i) const {
+  std::atomic<uint64>* group = &cells_referenced_[i >> 6];
+  const uint64 bit = 1ULL << (i & 63);
+  if ((group->load(std::memory_order_relaxed) & bit) == 0) {
+    group->fetch_or(bit, std::memory_order_relaxed);
+  }
+}
+
+inline size_t EncodedS2ShapeIndex::decoded_cell_bytes() const {
+  return decoded_cell_bytes_.load(std::memory_order_relaxed);
+}
+
+// Counts an access to an already-decoded cell (see cell_hits_).
+inline void EncodedS2ShapeIndex::count_cell_hit() const {
+  // The shard index only needs to be computed once per thread.
+  static thread_local const size_t shard =
+      std::hash<std::thread::id>()(std::this_thread::get_id()) &
+      (kNumCellHitShards - 1);
+  cell_hits_[shard].count.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline int64 EncodedS2ShapeIndex::num_cell_hits() const {
+  int64 hits = 0;
+  for (const CellHitShard& shard : cell_hits_) {
+    hits += shard.count.load(std::memory_order_relaxed);
+  }
+  return hits;
+}
+
+inline int64 EncodedS2ShapeIndex::num_cell_misses() const {
+  return cell_misses_.load(std::memory_order_relaxed);
+}
+
 inline int EncodedS2ShapeIndex::max_cell_cache_size() const {
   // The cell cache is sized so that scanning decoded_cells_ in the destructor
   // costs about 30 cycles per decoded cell in the worst case.  (This overhead
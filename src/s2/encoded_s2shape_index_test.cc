@@ -40,6 +40,7 @@
 #include "s2/s2builderutil_snap_functions.h"
 #include "s2/s2cap.h"
 #include "s2/s2cell_id.h"
+#include "s2/s2cell_union.h"
 #include "s2/s2closest_edge_query.h"
 #include "s2/s2coder.h"
 #include "s2/s2contains_point_query.h"
@@ -50,6 +51,7 @@
 #include "s2/s2lax_polygon_shape.h"
 #include "s2/s2lax_polyline_shape.h"
 #include "s2/s2loop.h"
+#include "s2/s2memory_tracker.h"
 #include "s2/s2point.h"
 #include "s2/s2point_vector_shape.h"
 #include "s2/s2pointutil.h"
@@ -352,6 +354,202 @@ TEST(EncodedS2ShapeIndex, LazyDecode) {
   test.Run(kNumReaders, kIters);
 }
 
+TEST(EncodedS2ShapeIndex, Prefetch) {
+  // Prefetch() is only an optimization hint, so all we can check here is
+  // that it accepts arbitrary coverings without crashing and does not
+  // disturb the index contents.
+  MutableS2ShapeIndex expected;
+  S2Polygon polygon(S2Loop::MakeRegularLoop(S2Point(3, 2, 1).Normalize(),
+                                            S1Angle::Degrees(1), 4096));
+  expected.Add(make_unique<S2LaxPolygonShape>(polygon));
+  Encoder encoder;
+  s2shapeutil::CompactEncodeTaggedShapes(expected, &encoder);
+  expected.Encode(&encoder);
+  Decoder decoder(encoder.base(), encoder.length());
+  EncodedS2ShapeIndex actual;
+  ASSERT_TRUE(actual.Init(&decoder,
+                          s2shapeutil::LazyDecodeShapeFactory(&decoder)));
+
+  S2CellUnion all({S2CellId::FromFace(0), S2CellId::FromFace(1),
+                   S2CellId::FromFace(2), S2CellId::FromFace(3),
+                   S2CellId::FromFace(4), S2CellId::FromFace(5)});
+  actual.Prefetch(all);
+  actual.Prefetch(S2CellUnion{});  // Empty coverings are fine too.
+  s2testing::ExpectEqual(expected, actual);
+}
+
+TEST(EncodedS2ShapeIndex, WarmUp) {
+  // Checks that WarmUp() decodes cells without disturbing the index
+  // contents, for both the whole-index and covering-restricted overloads,
+  // serial and threaded.
+  MutableS2ShapeIndex expected;
+  S2Polygon polygon(S2Loop::MakeRegularLoop(S2Point(1, 2, 3).Normalize(),
+                                            S1Angle::Degrees(1), 4096));
+  expected.Add(make_unique<S2LaxPolygonShape>(polygon));
+  Encoder encoder;
+  s2shapeutil::CompactEncodeTaggedShapes(expected, &encoder);
+  expected.Encode(&encoder);
+  Decoder decoder(encoder.base(), encoder.length());
+  EncodedS2ShapeIndex actual;
+  ASSERT_TRUE(actual.Init(&decoder,
+                          s2shapeutil::LazyDecodeShapeFactory(&decoder)));
+
+  EXPECT_EQ(0, actual.num_cells_decoded());
+  actual.WarmUp(S2CellUnion({S2CellId::FromFace(0)}), 4);
+  actual.WarmUp(S2CellUnion{}, 4);  // Empty coverings are fine too.
+  actual.WarmUp(1);
+  actual.WarmUp(4);  // Decoding again is a no-op.
+
+  // All cells have now been decoded.
+  int num_cells = 0;
+  for (MutableS2ShapeIndex::Iterator it(&expected, S2ShapeIndex::BEGIN);
+       !it.done(); it.Next()) {
+    ++num_cells;
+  }
+  EXPECT_EQ(num_cells, actual.num_cells_decoded());
+  s2testing::ExpectEqual(expected, actual);
+}
+
+TEST(EncodedS2ShapeIndex, TrimDecodedCells) {
+  MutableS2ShapeIndex expected;
+  S2Polygon polygon(S2Loop::MakeRegularLoop(S2Point(1, 2, 3).Normalize(),
+                                            S1Angle::Degrees(1), 4096));
+  expected.Add(make_unique<S2LaxPolygonShape>(polygon));
+  Encoder encoder;
+  s2shapeutil::CompactEncodeTaggedShapes(expected, &encoder);
+  expected.Encode(&encoder);
+  Decoder decoder(encoder.base(), encoder.length());
+  EncodedS2ShapeIndex actual;
+  ASSERT_TRUE(actual.Init(&decoder,
+                          s2shapeutil::LazyDecodeShapeFactory(&decoder)));
+  S2MemoryTracker tracker;
+  actual.set_memory_tracker(&tracker);
+
+  EXPECT_EQ(0, actual.num_cell_hits());
+  EXPECT_EQ(0, actual.num_cell_misses());
+  EXPECT_EQ(0, actual.decoded_cell_bytes());
+
+  // Decoding every cell is a miss per cell; decoding again is a hit per cell.
+  actual.WarmUp(1);
+  const int num_cells = actual.num_cells_decoded();
+  ASSERT_GT(num_cells, 0);
+  EXPECT_EQ(num_cells, actual.num_cell_misses());
+  EXPECT_EQ(0, actual.num_cell_hits());
+  const size_t all_bytes = actual.decoded_cell_bytes();
+  EXPECT_GT(all_bytes, 0);
+  EXPECT_EQ(static_cast<int64>(all_bytes), tracker.usage_bytes());
+  actual.WarmUp(1);
+  EXPECT_EQ(num_cells, actual.num_cell_hits());
+  EXPECT_EQ(num_cells, actual.num_cell_misses());
+  EXPECT_EQ(all_bytes, actual.decoded_cell_bytes());
+
+  // A budget at the current usage evicts nothing.
+  actual.TrimDecodedCells(all_bytes);
+  EXPECT_EQ(num_cells, actual.num_cells_decoded());
+
+  // A smaller budget is respected, and the surviving cells stay decoded.
+  actual.TrimDecodedCells(all_bytes / 2);
+  EXPECT_LE(actual.decoded_cell_bytes(), all_bytes / 2);
+  EXPECT_LT(actual.num_cells_decoded(), num_cells);
+  EXPECT_GT(actual.num_cells_decoded(), 0);
+  EXPECT_EQ(static_cast<int64>(actual.decoded_cell_bytes()),
+            tracker.usage_bytes());
+
+  // Evicted cells are decoded again transparently.
+  s2testing::ExpectEqual(expected, actual);
+  EXPECT_EQ(num_cells, actual.num_cells_decoded());
+
+  // A budget of zero evicts everything, like Minimize().
+  actual.TrimDecodedCells(0);
+  EXPECT_EQ(0, actual.num_cells_decoded());
+  EXPECT_EQ(0, actual.decoded_cell_bytes());
+  EXPECT_EQ(0, tracker.usage_bytes());
+  s2testing::ExpectEqual(expected, actual);
+
+  actual.set_memory_tracker(nullptr);
+  EXPECT_EQ(0, tracker.usage_bytes());
+}
+
+TEST(EncodedS2ShapeIndex, TrimDecodedCellsKeepsReferencedCells) {
+  MutableS2ShapeIndex expected;
+  S2Polygon polygon(S2Loop::MakeRegularLoop(S2Point(1, 2, 3).Normalize(),
+                                            S1Angle::Degrees(1), 4096));
+  expected.Add(make_unique<S2LaxPolygonShape>(polygon));
+  Encoder encoder;
+  s2shapeutil::CompactEncodeTaggedShapes(expected, &encoder);
+  expected.Encode(&encoder);
+  Decoder decoder(encoder.base(), encoder.length());
+  EncodedS2ShapeIndex actual;
+  ASSERT_TRUE(actual.Init(&decoder,
+                          s2shapeutil::LazyDecodeShapeFactory(&decoder)));
+
+  // Measure the decode footprint of the cells used by one point query.
+  auto query = MakeS2ContainsPointQuery(&actual);
+  const S2Point point = S2Point(1, 2, 3).Normalize();
+  EXPECT_TRUE(query.Contains(point));
+  const size_t hot_bytes = actual.decoded_cell_bytes();
+  EXPECT_GT(hot_bytes, 0);
+
+  // Decode everything, then sweep without meaningfully reducing the budget;
+  // this consumes every cell's second chance.
+  actual.WarmUp(1);
+  actual.TrimDecodedCells(actual.decoded_cell_bytes() - 1);
+
+  // Re-reference the hot cells, then trim to a budget that covers only them.
+  // The sweep should evict the cold cells and spare the hot ones, so that
+  // repeating the query does not need to decode anything.
+  EXPECT_TRUE(query.Contains(point));
+  const int64 misses = actual.num_cell_misses();
+  actual.TrimDecodedCells(hot_bytes);
+  EXPECT_LE(actual.decoded_cell_bytes(), hot_bytes);
+  EXPECT_TRUE(query.Contains(point));
+  EXPECT_EQ(misses, actual.num_cell_misses());
+}
+
+TEST(EncodedS2ShapeIndex, IteratorSeekPatterns) {
+  // Seek() gallops forward from the current iterator position before falling
+  // back to a full binary search.  Verify that seeks from arbitrary iterator
+  // states (near-monotonic runs, backward jumps, random jumps) agree with a
+  // seek on a freshly positioned iterator.
+  MutableS2ShapeIndex expected;
+  S2Polygon polygon(S2Loop::MakeRegularLoop(S2Point(1, 2, 3).Normalize(),
+                                            S1Angle::Degrees(5), 1024));
+  expected.Add(make_unique<S2LaxPolygonShape>(polygon));
+  Encoder encoder;
+  s2shapeutil::CompactEncodeTaggedShapes(expected, &encoder);
+  expected.Encode(&encoder);
+  Decoder decoder(encoder.base(), encoder.length());
+  EncodedS2ShapeIndex actual;
+  ASSERT_TRUE(actual.Init(&decoder,
+                          s2shapeutil::LazyDecodeShapeFactory(&decoder)));
+
+  vector<S2CellId> ids;
+  for (EncodedS2ShapeIndex::Iterator it(&actual, S2ShapeIndex::BEGIN);
+       !it.done(); it.Next()) {
+    ids.push_back(it.id());
+  }
+  ASSERT_GT(ids.size(), 100);
+  S2Testing::Random* rnd = &S2Testing::rnd;
+  EncodedS2ShapeIndex::Iterator it(&actual);
+  for (int iter = 0; iter < 1000; ++iter) {
+    // Mostly advance by a few cells, with occasional random jumps.
+    S2CellId target;
+    if (rnd->OneIn(10)) {
+      target = ids[rnd->Uniform(ids.size())];
+    } else if (!it.done()) {
+      target = it.id().advance(rnd->Uniform(16));
+    } else {
+      target = ids[0];
+    }
+    if (rnd->OneIn(3)) target = target.range_min();
+    it.Seek(target);
+    EncodedS2ShapeIndex::Iterator fresh(&actual);
+    fresh.Seek(target);
+    EXPECT_EQ(fresh.done(), it.done());
+    if (!it.done()) EXPECT_EQ(fresh.id(), it.id());
+  }
+}
+
 TEST(EncodedS2ShapeIndex, JavaByteCompatibility) {
   MutableS2ShapeIndex expected;
   expected.Add(make_unique<S2Polyline::OwningShape>(
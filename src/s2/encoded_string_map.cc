@@ -0,0 +1,54 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/encoded_string_map.h"
+
+#include <cstddef>
+
+#include "absl/strings/string_view.h"
+#include "s2/util/coding/coder.h"
+
+using absl::string_view;
+
+namespace s2coding {
+
+void StringMapEncoder::Encode(Encoder* encoder) {
+  keys_.Encode(encoder);
+  values_.Encode(encoder);
+}
+
+bool EncodedStringMap::Init(Decoder* decoder) {
+  if (!keys_.Init(decoder)) return false;
+  if (!values_.Init(decoder)) return false;
+  return keys_.size() == values_.size();
+}
+
+ptrdiff_t EncodedStringMap::Find(string_view key) const {
+  // Binary search for the first key that is not less than "key".  Note that
+  // each key comparison decodes only the two offsets of that key.
+  size_t lo = 0, hi = keys_.size();
+  while (lo < hi) {
+    size_t mid = (lo + hi) >> 1;
+    if (keys_[mid] < key) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  if (lo == keys_.size() || keys_[lo] != key) return -1;
+  return lo;
+}
+
+}  // namespace s2coding
@@ -0,0 +1,150 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef S2_ENCODED_STRING_MAP_H_
+#define S2_ENCODED_STRING_MAP_H_
+
+#include <cstddef>
+
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "s2/util/coding/coder.h"
+#include "s2/encoded_string_vector.h"
+
+namespace s2coding {
+
+// This class allows an EncodedStringMap to be created by adding keyed
+// entries incrementally.  It is intended as a simple container format for
+// storing many independently encoded blobs (such as EncodedS2ShapeIndexes
+// for map tiles) in a single buffer, so that clients can load one buffer
+// and then initialize individual entries lazily.  For example:
+//
+// void EncodeTiles(const vector<pair<string, S2ShapeIndex*>>& tiles,
+//                  Encoder* encoder) {
+//   StringMapEncoder encoded_tiles;
+//   for (const auto& tile : tiles) {
+//     Encoder* sub_encoder = encoded_tiles.AddViaEncoder(tile.first);
+//     s2shapeutil::CompactEncodeTaggedShapes(*tile.second, sub_encoder);
+//     tile.second->Encode(sub_encoder);
+//   }
+//   encoded_tiles.Encode(encoder);
+// }
+class StringMapEncoder {
+ public:
+  StringMapEncoder() = default;
+
+  // Adds a key/value pair to the encoded map.
+  //
+  // REQUIRES: Keys are added in strictly increasing order.  (This allows
+  //           EncodedStringMap to look up keys by binary search.)
+  void Add(const std::string& key, const std::string& value);
+
+  // Adds a key whose value is the output of the given Encoder.  The value
+  // consists of all output added to the encoder before the next call to any
+  // method of this class (after which the encoder is no longer valid).
+  //
+  // REQUIRES: Keys are added in strictly increasing order.
+  Encoder* AddViaEncoder(const std::string& key);
+
+  // Appends the EncodedStringMap representation to the given Encoder.
+  //
+  // REQUIRES: "encoder" uses the default constructor, so that its buffer
+  //           can be enlarged as necessary by calling Ensure(int).
+  void Encode(Encoder* encoder);
+
+ private:
+  StringVectorEncoder keys_;
+  StringVectorEncoder values_;
+};
+
+// This class represents an encoded map from strings to strings.  Values are
+// decoded only when they are accessed.  This allows for very fast
+// initialization and no additional memory use beyond the encoded data.  The
+// encoded data is not owned by this class; typically it points into a large
+// contiguous buffer that contains other encoded data as well.
+//
+// The keys form a table of contents that is decoded on demand as well, so
+// initializing a map with many entries and accessing only a few of them
+// (e.g. a tile server answering queries for individual tiles) does not touch
+// the remaining entries at all.
+class EncodedStringMap {
+ public:
+  // Constructs an uninitialized object; requires Init() to be called.
+  EncodedStringMap() = default;
+
+  // Initializes the EncodedStringMap.  Returns false on errors, leaving the
+  // map in an unspecified state.
+  //
+  // REQUIRES: The Decoder data buffer must outlive this object.
+  bool Init(Decoder* decoder);
+
+  // Returns the number of entries in the map.
+  size_t size() const;
+
+  // Returns the key of the i-th entry.  Keys are in increasing order.
+  absl::string_view key(size_t i) const;
+
+  // Returns the value of the i-th entry.
+  absl::string_view value(size_t i) const;
+
+  // Returns a Decoder initialized with the value of the i-th entry.  This is
+  // the intended way to lazily initialize an encoded data structure stored
+  // in the map (e.g. EncodedS2ShapeIndex::Init).
+  Decoder GetDecoder(size_t i) const;
+
+  // Returns the index of the entry with the given key, or -1 if no such
+  // entry exists.
+  ptrdiff_t Find(absl::string_view key) const;
+
+ private:
+  EncodedStringVector keys_;
+  EncodedStringVector values_;
+};
+
+
+//////////////////   Implementation details follow   ////////////////////
+
+
+inline void StringMapEncoder::Add(const std::string& key,
+                                  const std::string& value) {
+  keys_.Add(key);
+  values_.Add(value);
+}
+
+inline Encoder* StringMapEncoder::AddViaEncoder(const std::string& key) {
+  keys_.Add(key);
+  return values_.AddViaEncoder();
+}
+
+inline size_t EncodedStringMap::size() const {
+  return keys_.size();
+}
+
+inline absl::string_view EncodedStringMap::key(size_t i) const {
+  return keys_[i];
+}
+
+inline absl::string_view EncodedStringMap::value(size_t i) const {
+  return values_[i];
+}
+
+inline Decoder EncodedStringMap::GetDecoder(size_t i) const {
+  return values_.GetDecoder(i);
+}
+
+}  // namespace s2coding
+
+#endif  // S2_ENCODED_STRING_MAP_H_
@@ -0,0 +1,119 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/encoded_string_map.h"
+
+#include <cstddef>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "absl/strings/str_cat.h"
+#include "s2/util/coding/coder.h"
+
+using std::pair;
+using std::string;
+using std::vector;
+
+namespace s2coding {
+
+void TestEncodedStringMap(const vector<pair<string, string>>& input) {
+  Encoder encoder;
+  StringMapEncoder map_encoder;
+  for (const auto& entry : input) {
+    map_encoder.Add(entry.first, entry.second);
+  }
+  map_encoder.Encode(&encoder);
+
+  Decoder decoder(encoder.base(), encoder.length());
+  EncodedStringMap actual;
+  ASSERT_TRUE(actual.Init(&decoder));
+  ASSERT_EQ(actual.size(), input.size());
+  for (size_t i = 0; i < input.size(); ++i) {
+    EXPECT_EQ(actual.key(i), input[i].first);
+    EXPECT_EQ(actual.value(i), input[i].second);
+    EXPECT_EQ(actual.Find(input[i].first), static_cast<ptrdiff_t>(i));
+  }
+}
+
+TEST(EncodedStringMapTest, Empty) {
+  TestEncodedStringMap({});
+  Encoder encoder;
+  StringMapEncoder().Encode(&encoder);
+  Decoder decoder(encoder.base(), encoder.length());
+  EncodedStringMap actual;
+  ASSERT_TRUE(actual.Init(&decoder));
+  EXPECT_EQ(actual.Find("anything"), -1);
+}
+
+TEST(EncodedStringMapTest, OneEntry) {
+  TestEncodedStringMap({{"tile/0", "payload"}});
+}
+
+TEST(EncodedStringMapTest, EmptyKeysAndValues) {
+  TestEncodedStringMap({{"", ""}, {"a", ""}, {"b", "value"}});
+}
+
+TEST(EncodedStringMapTest, ManyEntries) {
+  vector<pair<string, string>> input;
+  for (int i = 0; i < 1000; ++i) {
+    input.push_back({absl::StrCat("tile/", 1000 + i),
+                     string(i % 50, 'x')});
+  }
+  TestEncodedStringMap(input);
+}
+
+TEST(EncodedStringMapTest, FindMissingKeys) {
+  Encoder encoder;
+  StringMapEncoder map_encoder;
+  map_encoder.Add("b", "1");
+  map_encoder.Add("d", "2");
+  map_encoder.Add("f", "3");
+  map_encoder.Encode(&encoder);
+  Decoder decoder(encoder.base(), encoder.length());
+  EncodedStringMap actual;
+  ASSERT_TRUE(actual.Init(&decoder));
+  EXPECT_EQ(actual.Find("a"), -1);
+  EXPECT_EQ(actual.Find("c"), -1);
+  EXPECT_EQ(actual.Find("e"), -1);
+  EXPECT_EQ(actual.Find("g"), -1);
+  EXPECT_EQ(actual.Find("b"), 0);
+  EXPECT_EQ(actual.Find("d"), 1);
+  EXPECT_EQ(actual.Find("f"), 2);
+}
+
+TEST(EncodedStringMapTest, ValuesAddedViaEncoder) {
+  Encoder encoder;
+  StringMapEncoder map_encoder;
+  Encoder* sub_encoder = map_encoder.AddViaEncoder("a");
+  sub_encoder->Ensure(8);
+  sub_encoder->put64(12345);
+  sub_encoder = map_encoder.AddViaEncoder("b");
+  sub_encoder->Ensure(8);
+  sub_encoder->put64(67890);
+  map_encoder.Encode(&encoder);
+
+  Decoder decoder(encoder.base(), encoder.length());
+  EncodedStringMap actual;
+  ASSERT_TRUE(actual.Init(&decoder));
+  Decoder value_decoder = actual.GetDecoder(actual.Find("b"));
+  EXPECT_EQ(value_decoder.get64(), 67890);
+  value_decoder = actual.GetDecoder(actual.Find("a"));
+  EXPECT_EQ(value_decoder.get64(), 12345);
+}
+
+}  // namespace s2coding
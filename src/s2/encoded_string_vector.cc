@@ -58,6 +58,7 @@ void StringVectorEncoder::Encode(Span<const string> v, Encoder* encoder) {
 bool EncodedStringVector::Init(Decoder* decoder) {
   if (!offsets_.Init(decoder)) return false;
   data_ = decoder->skip(0);
+  warm_offsets_ = nullptr;
   uint64 length = 0;
   for (int i = 0, n = offsets_.size(); i < n; ++i) {
     // Strings are packed sequentially, offsets_[i] representing end of item i.
@@ -71,6 +72,12 @@ bool EncodedStringVector::Init(Decoder* decoder) {
   return true;
 }
 
+void EncodedStringVector::WarmOffsets(std::vector<uint64>* storage) {
+  storage->resize(offsets_.size());
+  offsets_.DecodeAll(MakeSpan(*storage));
+  warm_offsets_ = storage->data();
+}
+
 vector<string_view> EncodedStringVector::Decode() const {
   size_t n = size();
   vector<string_view> result(n);
@@ -114,6 +114,20 @@ class EncodedStringVector {
   // faster than operator[] but returns an unbounded string.
   const char* GetStart(size_t i) const;
 
+  // Expands the offset table into "storage" so that each subsequent access
+  // performs a single indexed load rather than decoding the fixed-width
+  // encoded offsets.  This is worthwhile when offset decoding is on a
+  // critical path, e.g. for the shape table of an EncodedS2ShapeIndex where
+  // shapes are fetched on demand.  It costs size() * sizeof(uint64) bytes of
+  // memory, which is why it is not done by default.
+  //
+  // The expanded offsets are referenced rather than owned, in keeping with
+  // the rest of this class; Init() and Clear() revert to the encoded form.
+  //
+  // REQUIRES: "storage" is not resized or destroyed while it is in use by
+  //           this object.
+  void WarmOffsets(std::vector<uint64>* storage);
+
   // Returns the entire vector of original strings.  Requires that the
   // data buffer passed to the constructor persists until the result vector is
   // no longer needed.
@@ -123,8 +137,17 @@ class EncodedStringVector {
   void Encode(Encoder* encoder) const;
 
  private:
+  // Returns the offset of the end of the string at the given index.
+  uint64 offset(size_t i) const;
+
   EncodedUintVector<uint64> offsets_;
   const char* data_;
+
+  // Expanded form of "offsets_" (see WarmOffsets), or nullptr.  This is a
+  // non-owning pointer so that the class remains trivially destructible,
+  // which other classes rely on (e.g. EncodedS2PointVector stores it in a
+  // tagged union).
+  const uint64* warm_offsets_;
 };
 
 
@@ -145,15 +168,20 @@ inline Encoder* StringVectorEncoder::AddViaEncoder() {
 inline void EncodedStringVector::Clear() {
   offsets_.Clear();
   data_ = nullptr;
+  warm_offsets_ = nullptr;
 }
 
 inline size_t EncodedStringVector::size() const {
   return offsets_.size();
 }
 
+inline uint64 EncodedStringVector::offset(size_t i) const {
+  return (warm_offsets_ != nullptr) ? warm_offsets_[i] : offsets_[i];
+}
+
 inline absl::string_view EncodedStringVector::operator[](size_t i) const {
-  uint64 start = (i == 0) ? 0 : offsets_[i - 1];
-  uint64 limit = offsets_[i];
+  uint64 start = (i == 0) ? 0 : offset(i - 1);
+  uint64 limit = offset(i);
   return absl::string_view(data_ + start, limit - start);
 }
 
@@ -163,13 +191,13 @@ inline Decoder EncodedStringVector::GetDecoder(size_t i) const {
     return Decoder();
   }
 
-  uint64 start = (i == 0) ? 0 : offsets_[i - 1];
-  uint64 limit = offsets_[i];
+  uint64 start = (i == 0) ? 0 : offset(i - 1);
+  uint64 limit = offset(i);
   return Decoder(data_ + start, limit - start);
 }
 
 inline const char* EncodedStringVector::GetStart(size_t i) const {
-  uint64 start = (i == 0) ? 0 : offsets_[i - 1];
+  uint64 start = (i == 0) ? 0 : offset(i - 1);
   return data_ + start;
 }
 
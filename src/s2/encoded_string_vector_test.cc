@@ -75,6 +75,25 @@ TEST(EncodedStringVectorTest, TwoStrings) {
   TestEncodedStringVector({"fuji", "mutsu"}, 12);
 }
 
+TEST(EncodedStringVectorTest, WarmOffsets) {
+  const vector<string> input = {"fuji", "", "mutsu", "gala"};
+  Encoder encoder;
+  StringVectorEncoder::Encode(input, &encoder);
+  Decoder decoder(encoder.base(), encoder.length());
+  EncodedStringVector actual;
+  ASSERT_TRUE(actual.Init(&decoder));
+
+  vector<uint64> storage;
+  actual.WarmOffsets(&storage);
+  ASSERT_EQ(input.size(), storage.size());
+  for (size_t i = 0; i < input.size(); ++i) {
+    EXPECT_EQ(string_view(input[i]), actual[i]);
+    EXPECT_EQ(actual[i].data(), actual.GetStart(i));
+    Decoder element = actual.GetDecoder(i);
+    EXPECT_EQ(input[i].size(), element.avail());
+  }
+}
+
 TEST(EncodedStringVectorTest, TwoBigStrings) {
   TestEncodedStringVector({string(10000, 'x'), string(100000, 'y')},
                           110007);
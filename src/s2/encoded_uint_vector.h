@@ -32,6 +32,7 @@
 #include "s2/util/bits/bits.h"
 #include "s2/util/coding/coder.h"
 #include "s2/util/coding/varint.h"
+#include "s2/util/endian/endian.h"
 
 namespace s2coding {
 
@@ -91,6 +92,14 @@ class EncodedUintVector {
   // REQUIRES: The vector elements are sorted in non-decreasing order.
   size_t lower_bound(T target) const;
 
+  // Decodes the entire vector into "out".  This is much faster than decoding
+  // elements one at a time because the value width is dispatched once rather
+  // than per element, which allows the fixed-width inner loop to be unrolled
+  // and vectorized by the compiler.
+  //
+  // REQUIRES: out.size() == size()
+  void DecodeAll(absl::Span<T> out) const;
+
   // Decodes and returns the entire original vector.
   std::vector<T> Decode() const;
 
@@ -98,6 +107,7 @@ class EncodedUintVector {
 
  private:
   template <int length> size_t lower_bound(T target) const;
+  template <int length> void DecodeAll(T* out) const;
 
   const char* data_;
   uint32 size_;
@@ -222,6 +232,12 @@ void EncodeUintVector(absl::Span<const T> v, Encoder* encoder) {
   encoder->Ensure(Varint::kMax64 + v.size() * len);
   uint64 size_len = (uint64{v.size()} * sizeof(T)) | (len - 1);
   encoder->put_varint64(size_len);
+  if (len == sizeof(T) && LittleEndian::IsLittleEndian()) {
+    // Full-width elements are encoded exactly as they appear in memory, so
+    // the entire array can be appended with a single bulk copy.
+    encoder->putn(v.data(), v.size() * sizeof(T));
+    return;
+  }
   for (auto x : v) {
     EncodeUintWithLength(x, len, encoder);
   }
@@ -283,25 +299,63 @@ size_t EncodedUintVector<T>::lower_bound(T target) const {
 
 template <class T> template <int length>
 inline size_t EncodedUintVector<T>::lower_bound(T target) const {
-  size_t lo = 0, hi = size_;
-  while (lo < hi) {
-    size_t mid = (lo + hi) >> 1;
-    T value = GetUintWithLength<T>(data_ + mid * length, length);
-    if (value < target) {
-      lo = mid + 1;
-    } else {
-      hi = mid;
-    }
+  // Branch-free binary search.  Each iteration halves the remaining range by
+  // conditionally advancing "base", using arithmetic rather than a branch so
+  // that mispredicted comparisons (which are the common case when searching
+  // for effectively random keys) do not flush the pipeline.  The two possible
+  // probe locations of the following iteration are prefetched so that the
+  // memory latency of the next probe overlaps the current one; this recovers
+  // most of the benefit of a cache-optimized (e.g. Eytzinger) layout without
+  // changing the encoding.  See Khuong & Morin, "Array Layouts for
+  // Comparison-Based Searching".
+  if (size_ == 0) return 0;
+  const char* base = data_;
+  size_t n = size_;
+  while (n > 1) {
+    size_t half = n >> 1;
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(base + (half >> 1) * length);
+    __builtin_prefetch(base + (half + (half >> 1)) * length);
+#endif
+    base += (GetUintWithLength<T>(base + (half - 1) * length, length) <
+             target) * (half * length);
+    n -= half;
+  }
+  return (base - data_) / length +
+         (GetUintWithLength<T>(base, length) < target);
+}
+
+template <class T>
+void EncodedUintVector<T>::DecodeAll(absl::Span<T> out) const {
+  ABSL_DCHECK_EQ(out.size(), size_);
+  if (size_ == 0) return;
+  switch (len_) {
+    case 1: return DecodeAll<1>(out.data());
+    case 2: return DecodeAll<2>(out.data());
+    case 3: return DecodeAll<3>(out.data());
+    case 4: return DecodeAll<4>(out.data());
+    case 5: return DecodeAll<5>(out.data());
+    case 6: return DecodeAll<6>(out.data());
+    case 7: return DecodeAll<7>(out.data());
+    default: return DecodeAll<8>(out.data());
+  }
+}
+
+template <class T> template <int length>
+inline void EncodedUintVector<T>::DecodeAll(T* out) const {
+  // Since "length" is a compile-time constant here, GetUintWithLength reduces
+  // to a fixed sequence of unaligned loads and the loop becomes a simple
+  // widening copy.
+  const char* ptr = data_;
+  for (size_t i = 0; i < size_; ++i, ptr += length) {
+    out[i] = GetUintWithLength<T>(ptr, length);
   }
-  return lo;
 }
 
 template <class T>
 std::vector<T> EncodedUintVector<T>::Decode() const {
   std::vector<T> result(size_);
-  for (int i = 0; i < size_; ++i) {
-    result[i] = (*this)[i];
-  }
+  DecodeAll(absl::MakeSpan(result));
   return result;
 }
 
@@ -26,6 +26,7 @@
 #include "s2/base/types.h"
 #include <gtest/gtest.h>
 #include "absl/log/absl_check.h"
+#include "absl/types/span.h"
 #include "s2/util/coding/coder.h"
 
 using std::vector;
@@ -79,6 +80,14 @@ TEST(EncodedUintVectorTest, EightBytes) {
   TestEncodedUintVector(vector<uint64>{~0ULL, 0, 0x0102030405060708}, 25);
 }
 
+TEST(EncodedUintVectorTest, FullWidthBulkCopy) {
+  // Exercises the bulk-copy encoding path used when every element requires
+  // the full width of T.
+  vector<uint64> values;
+  for (int i = 0; i < 100; ++i) values.push_back((uint64{1} << 62) + i);
+  TestEncodedUintVector(values, 2 + 100 * 8);
+}
+
 template <class T>
 vector<T> MakeSortedTestVector(int bytes_per_value, int num_values) {
   ABSL_DCHECK_LE(bytes_per_value, sizeof(T));
@@ -131,6 +140,22 @@ TEST(EncodedUintVector, LowerBound) {
   }
 }
 
+TEST(EncodedUintVectorTest, DecodeAllAtAllValueWidths) {
+  // Verifies the bulk DecodeAll() path against operator[] for every encoded
+  // value width from 1 to 8 bytes.
+  for (int bytes_per_value = 1; bytes_per_value <= 8; ++bytes_per_value) {
+    auto v = MakeSortedTestVector<uint64>(bytes_per_value, 100);
+    Encoder encoder;
+    auto actual = MakeEncodedVector(v, &encoder);
+    vector<uint64> decoded(actual.size());
+    actual.DecodeAll(absl::MakeSpan(decoded));
+    for (size_t i = 0; i < actual.size(); ++i) {
+      EXPECT_EQ(actual[i], decoded[i]);
+    }
+    EXPECT_EQ(decoded, v);
+  }
+}
+
 TEST(EncodedUintVectorTest, RoundtripEncoding) {
   vector<uint64> values{10, 20, 30, 40};
 
@@ -0,0 +1,158 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/frozen_s2shape_index.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+
+#include "s2/encoded_s2cell_id_vector.h"
+#include "s2/encoded_string_vector.h"
+#include "s2/mutable_s2shape_index.h"
+#include "s2/s2cell_id.h"
+#include "s2/s2shape_index.h"
+#include "s2/util/coding/coder.h"
+#include "s2/util/coding/varint.h"
+
+using std::vector;
+
+FrozenS2ShapeIndex::FrozenS2ShapeIndex() = default;
+
+FrozenS2ShapeIndex::FrozenS2ShapeIndex(MutableS2ShapeIndex&& index) {
+  Init(std::move(index));
+}
+
+FrozenS2ShapeIndex::~FrozenS2ShapeIndex() {
+  // The cells' S2ClippedShape arrays are non-owning views into the shared
+  // clipped_shapes_ block, and the edge arrays of those shapes point into
+  // the shared edge_ids_ buffer (see Init), but ~S2ShapeIndexCell() assumes
+  // ownership of both and would deallocate them.  Reset each cell to an
+  // empty state first; the shared blocks are freed by the member vectors.
+  for (S2ShapeIndexCell& cell : cells_) {
+    cell.shapes_.Init();
+  }
+}
+
+void FrozenS2ShapeIndex::Init(MutableS2ShapeIndex&& index) {
+  ABSL_DCHECK(shapes_.empty() && cells_.empty());
+  index.ForceBuild();
+  options_ = index.options();
+
+  // First pass: count the index cells, clipped shapes, and the edge ids that
+  // are too numerous to be stored inline, so that all buffers can be sized
+  // exactly.  (The clipped shape and edge id buffers must never reallocate
+  // since the cells and S2ClippedShapes point into them.)
+  int num_cells = 0;
+  size_t num_clipped = 0;
+  size_t num_edge_ids = 0;
+  for (MutableS2ShapeIndex::Iterator it(&index, S2ShapeIndex::BEGIN);
+       !it.done(); it.Next(), ++num_cells) {
+    const S2ShapeIndexCell& cell = it.cell();
+    num_clipped += cell.num_clipped();
+    for (int s = 0; s < cell.num_clipped(); ++s) {
+      const S2ClippedShape& clipped = cell.clipped(s);
+      if (!clipped.is_single_run() &&
+          clipped.num_edges() > S2ClippedShape::kMaxInlineEdges) {
+        num_edge_ids += clipped.num_edges();
+      }
+    }
+  }
+  cell_ids_.reserve(num_cells);
+  cells_ = vector<S2ShapeIndexCell>(num_cells);
+  clipped_shapes_ = vector<S2ClippedShape>(num_clipped);
+  edge_ids_.reserve(num_edge_ids);
+
+  // Second pass: copy the cell contents into the flat buffers.
+  int cell_index = 0;
+  size_t num_clipped_used = 0;
+  for (MutableS2ShapeIndex::Iterator it(&index, S2ShapeIndex::BEGIN);
+       !it.done(); it.Next(), ++cell_index) {
+    const S2ShapeIndexCell& cell = it.cell();
+    cell_ids_.push_back(it.id());
+    // Carve the cell's clipped shapes out of the shared header block rather
+    // than allocating them with add_shapes().
+    S2ClippedShape* base = clipped_shapes_.data() + num_clipped_used;
+    cells_[cell_index].shapes_.InitAsView(base, cell.num_clipped());
+    num_clipped_used += cell.num_clipped();
+    for (int s = 0; s < cell.num_clipped(); ++s) {
+      const S2ClippedShape& src = cell.clipped(s);
+      S2ClippedShape* dst = base + s;
+      dst->shape_id_ = src.shape_id();
+      dst->single_run_ = src.is_single_run();
+      dst->num_edges_ = src.num_edges();
+      dst->contains_center_ = src.contains_center();
+      if (src.is_single_run()) {
+        dst->inline_edges_[0] = src.edge(0);
+      } else if (dst->is_inline()) {
+        for (int e = 0; e < src.num_edges(); ++e) {
+          dst->inline_edges_[e] = src.edge(e);
+        }
+      } else {
+        dst->edges_ = edge_ids_.data() + edge_ids_.size();
+        for (int e = 0; e < src.num_edges(); ++e) {
+          edge_ids_.push_back(src.edge(e));
+        }
+      }
+    }
+  }
+  ABSL_DCHECK_EQ(num_clipped, num_clipped_used);
+  ABSL_DCHECK_EQ(num_edge_ids, edge_ids_.size());
+
+  // Finally take ownership of the shapes and reset the source index.  (This
+  // does not use MutableS2ShapeIndex::Release() since that would make a copy
+  // of every edge in order to support incremental updates.)
+  shapes_ = std::move(index.shapes_);
+  index.Clear();
+}
+
+void FrozenS2ShapeIndex::Iterator::Seek(S2CellId target) {
+  cell_pos_ = static_cast<int32>(
+      std::lower_bound(index_->cell_ids_.begin(), index_->cell_ids_.end(),
+                       target) -
+      index_->cell_ids_.begin());
+}
+
+void FrozenS2ShapeIndex::Encode(Encoder* encoder) const {
+  // This matches the encoding written by MutableS2ShapeIndex::Encode (with
+  // the same version number), so the output can be decoded by either
+  // MutableS2ShapeIndex or EncodedS2ShapeIndex.
+  encoder->Ensure(Varint::kMax64);
+  uint64 max_edges = options_.max_edges_per_cell();
+  encoder->put_varint64(
+      max_edges << 2 | MutableS2ShapeIndex::kCurrentEncodingVersionNumber);
+
+  s2coding::StringVectorEncoder encoded_cells;
+  for (int i = 0; i < num_cells(); ++i) {
+    cells_[i].Encode(num_shape_ids(), encoded_cells.AddViaEncoder());
+  }
+  s2coding::EncodeS2CellIdVector(cell_ids_, encoder);
+  encoded_cells.Encode(encoder);
+}
+
+size_t FrozenS2ShapeIndex::SpaceUsed() const {
+  size_t size = sizeof(*this);
+  size += shapes_.capacity() * sizeof(std::unique_ptr<S2Shape>);
+  size += cell_ids_.capacity() * sizeof(S2CellId);
+  size += cells_.capacity() * sizeof(S2ShapeIndexCell);
+  // The cells' S2ClippedShape arrays all live in clipped_shapes_.
+  size += clipped_shapes_.capacity() * sizeof(S2ClippedShape);
+  size += edge_ids_.capacity() * sizeof(int32);
+  return size;
+}
@@ -0,0 +1,204 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef S2_FROZEN_S2SHAPE_INDEX_H_
+#define S2_FROZEN_S2SHAPE_INDEX_H_
+
+#include <memory>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+
+#include "s2/base/types.h"
+#include "s2/_fp_contract_off.h"
+#include "s2/mutable_s2shape_index.h"
+#include "s2/s2cell_id.h"
+#include "s2/s2shape.h"
+#include "s2/s2shape_index.h"
+#include "s2/util/coding/coder.h"
+
+// FrozenS2ShapeIndex is a read-only S2ShapeIndex implementation optimized
+// for serving workloads.  It is built by moving the contents out of a fully
+// constructed MutableS2ShapeIndex.  Rather than keeping the cell contents in
+// a btree with per-cell heap allocations, FrozenS2ShapeIndex lays the cell
+// ids, index cells, clipped shape headers, and edge id arrays out in a small
+// number of contiguous buffers, which greatly improves cache behavior for
+// queries that walk many cells (such as S2ClosestEdgeQuery and
+// S2BooleanOperation).
+//
+// FrozenS2ShapeIndex implements the standard S2ShapeIndex interface and
+// iterator contract, so it can be used anywhere a `const S2ShapeIndex&` is
+// accepted.  It cannot be modified after construction; to change the
+// geometry, build a new MutableS2ShapeIndex and freeze it again.
+//
+// Example usage:
+//
+//   MutableS2ShapeIndex mutable_index;
+//   ... add shapes to mutable_index ...
+//   FrozenS2ShapeIndex index(std::move(mutable_index));
+//   S2ClosestEdgeQuery query(&index);
+//   ...
+//
+// FrozenS2ShapeIndex is thread-compatible; since every method except
+// Minimize() is const, it may be shared freely among query threads.
+class FrozenS2ShapeIndex final : public S2ShapeIndex {
+ public:
+  using Options = MutableS2ShapeIndex::Options;
+
+  // Creates an empty index that may be initialized by calling Init().
+  FrozenS2ShapeIndex();
+
+  // Convenience constructor equivalent to calling Init(std::move(index)).
+  explicit FrozenS2ShapeIndex(MutableS2ShapeIndex&& index);
+
+  ~FrozenS2ShapeIndex() override;
+
+  // Initializes this index by taking ownership of the shapes and cell
+  // contents of the given index.  Any pending updates are applied first.
+  // The given index is left empty, as if Clear() had been called.
+  //
+  // REQUIRES: This index is empty (i.e., newly created or Clear() was
+  //           called on a MutableS2ShapeIndex before freezing it).
+  void Init(MutableS2ShapeIndex&& index);
+
+  const Options& options() const { return options_; }
+
+  // The number of index cells.
+  int num_cells() const { return static_cast<int>(cell_ids_.size()); }
+
+  // S2ShapeIndex interface:
+  int num_shape_ids() const override {
+    return static_cast<int>(shapes_.size());
+  }
+  const S2Shape* shape(int id) const override { return shapes_[id].get(); }
+
+  // Stores an encoded representation of the index into the given encoder.
+  // The encoding is identical to that of MutableS2ShapeIndex, so the result
+  // can be decoded as either a MutableS2ShapeIndex or an EncodedS2ShapeIndex.
+  void Encode(Encoder* encoder) const override;
+
+  size_t SpaceUsed() const override;
+
+  // FrozenS2ShapeIndex has no data structures that can be rebuilt on demand,
+  // so this method does nothing.
+  void Minimize() override {}
+
+  class Iterator final : public IteratorBase {
+   public:
+    // Default constructor; must be followed by a call to Init().
+    Iterator() = default;
+
+    // Constructs an iterator positioned as specified.
+    explicit Iterator(const FrozenS2ShapeIndex* index,
+                      InitialPosition pos = UNPOSITIONED) {
+      Init(index, pos);
+    }
+
+    // Initializes an iterator for the given FrozenS2ShapeIndex.
+    void Init(const FrozenS2ShapeIndex* index,
+              InitialPosition pos = UNPOSITIONED) {
+      index_ = index;
+      num_cells_ = index->num_cells();
+      cell_pos_ = (pos == BEGIN) ? 0 : num_cells_;
+    }
+
+    S2CellId id() const override {
+      if (done()) return S2CellId::Sentinel();
+      return index_->cell_ids_[cell_pos_];
+    }
+
+    bool done() const override { return cell_pos_ == num_cells_; }
+
+    const S2ShapeIndexCell& cell() const override {
+      ABSL_DCHECK(!done());
+      return index_->cells_[cell_pos_];
+    }
+
+    // S2CellIterator API:
+    void Begin() override { cell_pos_ = 0; }
+    void Finish() override { cell_pos_ = num_cells_; }
+    void Next() override {
+      ABSL_DCHECK(!done());
+      ++cell_pos_;
+    }
+    bool Prev() override {
+      if (cell_pos_ == 0) return false;
+      --cell_pos_;
+      return true;
+    }
+    void Seek(S2CellId target) override;
+
+    bool Locate(const S2Point& target) override {
+      return LocateImpl(*this, target);
+    }
+
+    S2CellRelation Locate(S2CellId target) override {
+      return LocateImpl(*this, target);
+    }
+
+    std::unique_ptr<IteratorBase> Clone() const override {
+      return std::make_unique<Iterator>(*this);
+    }
+
+   private:
+    const FrozenS2ShapeIndex* index_ = nullptr;
+    int32 cell_pos_ = 0;  // Current position in the vector of index cells.
+    int32 num_cells_ = 0;
+  };
+
+ protected:
+  std::unique_ptr<IteratorBase> NewIterator(InitialPosition pos) const
+      override {
+    return std::make_unique<Iterator>(this, pos);
+  }
+
+ private:
+  friend class Iterator;
+
+  // The options that were used to build the original index.
+  Options options_;
+
+  // The shapes in the index, accessed by their shape id.  Removed shapes are
+  // represented by nullptr pointers (shape ids are never reused).
+  std::vector<std::unique_ptr<S2Shape>> shapes_;
+
+  // The cell ids of all index cells, in increasing order.  The contents of
+  // cell_ids_[i] are stored in cells_[i].  Keeping the two arrays separate
+  // makes Seek() touch only the (smaller, densely packed) id array.
+  std::vector<S2CellId> cell_ids_;
+
+  // The index cells, in the same order as cell_ids_.  Each cell's
+  // S2ClippedShape array is a non-owning view into clipped_shapes_ below,
+  // and the edge id arrays of those S2ClippedShapes point into edge_ids_
+  // rather than being allocated individually (see Init).
+  std::vector<S2ShapeIndexCell> cells_;
+
+  // Shared storage for the S2ClippedShape headers (shape ids, edge counts,
+  // and inline or pointed-to edge arrays) of all index cells.  Packing the
+  // headers into one block rather than one small heap allocation per cell
+  // means that scanning the shapes and edges of consecutive cells touches
+  // sequential cache lines.
+  std::vector<S2ClippedShape> clipped_shapes_;
+
+  // Shared storage for the edge ids of all S2ClippedShapes that have too
+  // many edges to be stored inline.  This buffer is sized exactly during
+  // Init() and never reallocated, so pointers into it remain stable.
+  std::vector<int32> edge_ids_;
+
+  FrozenS2ShapeIndex(const FrozenS2ShapeIndex&) = delete;
+  void operator=(const FrozenS2ShapeIndex&) = delete;
+};
+
+#endif  // S2_FROZEN_S2SHAPE_INDEX_H_
@@ -0,0 +1,135 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/frozen_s2shape_index.h"
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "s2/util/coding/coder.h"
+#include "s2/mutable_s2shape_index.h"
+#include "s2/s1angle.h"
+#include "s2/s2cell_id.h"
+#include "s2/s2closest_edge_query.h"
+#include "s2/s2contains_point_query.h"
+#include "s2/s2fractal.h"
+#include "s2/s2latlng.h"
+#include "s2/s2loop.h"
+#include "s2/s2point.h"
+#include "s2/s2pointutil.h"
+#include "s2/s2shape.h"
+#include "s2/s2shapeutil_testing.h"
+#include "s2/s2testing.h"
+#include "s2/s2text_format.h"
+
+using s2textformat::MakeIndexOrDie;
+using std::make_unique;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+namespace {
+
+// Builds two identical MutableS2ShapeIndexes from the given s2text_format
+// string, freezes one of them, and checks that the frozen index is
+// equivalent to the mutable one.
+void TestFreeze(const string& index_str) {
+  auto expected = MakeIndexOrDie(index_str);
+  FrozenS2ShapeIndex actual(std::move(*MakeIndexOrDie(index_str)));
+  s2testing::ExpectEqual(*expected, actual);
+}
+
+TEST(FrozenS2ShapeIndex, Empty) {
+  FrozenS2ShapeIndex index;
+  EXPECT_EQ(0, index.num_shape_ids());
+  EXPECT_EQ(0, index.num_cells());
+  FrozenS2ShapeIndex::Iterator it(&index, S2ShapeIndex::BEGIN);
+  EXPECT_TRUE(it.done());
+}
+
+TEST(FrozenS2ShapeIndex, MixedGeometry) {
+  TestFreeze("0:0 | 1:1 # 2:2, 3:3, 4:4 # 5:5, 6:6, 7:7; 8:8, 9:9, 10:10");
+}
+
+TEST(FrozenS2ShapeIndex, ManyCells) {
+  // A fractal with enough edges that the index is subdivided into many cells
+  // and most S2ClippedShapes store their edge ids out of line.
+  S2Fractal fractal;
+  fractal.SetLevelForApproxMaxEdges(1000);
+  auto loop = fractal.MakeLoop(
+      S2::GetFrame(S2LatLng::FromDegrees(10, 10).ToPoint()),
+      S1Angle::Degrees(5));
+  MutableS2ShapeIndex mutable_index;
+  mutable_index.Add(make_unique<S2Loop::OwningShape>(std::move(loop)));
+  Encoder encoder;
+  mutable_index.Encode(&encoder);
+
+  FrozenS2ShapeIndex index(std::move(mutable_index));
+  EXPECT_GT(index.num_cells(), 10);
+
+  // The frozen index encodes identically to the original.
+  Encoder frozen_encoder;
+  index.Encode(&frozen_encoder);
+  ASSERT_EQ(encoder.length(), frozen_encoder.length());
+  EXPECT_EQ(0, memcmp(encoder.base(), frozen_encoder.base(),
+                      encoder.length()));
+}
+
+TEST(FrozenS2ShapeIndex, ClippedShapeHeadersArePacked) {
+  // The S2ClippedShape arrays of consecutive cells should be adjacent in
+  // memory, since they are carved out of one shared block.
+  S2Fractal fractal;
+  fractal.SetLevelForApproxMaxEdges(1000);
+  auto loop = fractal.MakeLoop(
+      S2::GetFrame(S2LatLng::FromDegrees(10, 10).ToPoint()),
+      S1Angle::Degrees(5));
+  MutableS2ShapeIndex mutable_index;
+  mutable_index.Add(make_unique<S2Loop::OwningShape>(std::move(loop)));
+  FrozenS2ShapeIndex index(std::move(mutable_index));
+  ASSERT_GT(index.num_cells(), 10);
+
+  const S2ClippedShape* next = nullptr;
+  for (FrozenS2ShapeIndex::Iterator it(&index, S2ShapeIndex::BEGIN);
+       !it.done(); it.Next()) {
+    const S2ShapeIndexCell& cell = it.cell();
+    ASSERT_GT(cell.num_clipped(), 0);
+    if (next != nullptr) EXPECT_EQ(next, &cell.clipped(0));
+    next = &cell.clipped(0) + cell.num_clipped();
+  }
+}
+
+TEST(FrozenS2ShapeIndex, QueriesWorkUnchanged) {
+  auto expected = MakeIndexOrDie(
+      "# # 0:0, 0:10, 10:10, 10:0; 2:2, 2:8, 8:8, 8:2");
+  FrozenS2ShapeIndex index(
+      std::move(*MakeIndexOrDie("# # 0:0, 0:10, 10:10, 10:0; 2:2, 2:8, 8:8, "
+                                "8:2")));
+  S2ClosestEdgeQuery expected_query(expected.get());
+  S2ClosestEdgeQuery query(&index);
+  auto contains_query = MakeS2ContainsPointQuery(&index);
+  for (int i = 0; i < 100; ++i) {
+    S2Point point = S2Testing::RandomPoint();
+    S2ClosestEdgeQuery::PointTarget target(point);
+    EXPECT_EQ(expected_query.GetDistance(&target), query.GetDistance(&target));
+    EXPECT_EQ(MakeS2ContainsPointQuery(expected.get()).Contains(point),
+              contains_query.Contains(point));
+  }
+}
+
+}  // namespace
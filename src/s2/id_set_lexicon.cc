@@ -54,6 +54,20 @@ void IdSetLexicon::Clear() {
   id_sets_.Clear();
 }
 
+int32 IdSetLexicon::AddPair(int32 id0, int32 id1) {
+  ABSL_DCHECK_GE(id0, 0);
+  ABSL_DCHECK_GE(id1, 0);
+  if (id0 == id1) {
+    // Singleton sets are represented by their element.
+    return id0;
+  }
+  if (id0 > id1) std::swap(id0, id1);
+  const int32 ids[2] = {id0, id1};
+  // Non-singleton sets are represented by the bitwise complement of the id
+  // returned by SequenceLexicon.
+  return ~id_sets_.Add(ids, ids + 2);
+}
+
 int32 IdSetLexicon::AddInternal(vector<int32>* ids) {
   if (ids->empty()) {
     // Empty sets have a special id chosen not to conflict with other ids.
@@ -61,6 +75,9 @@ int32 IdSetLexicon::AddInternal(vector<int32>* ids) {
   } else if (ids->size() == 1) {
     // Singleton sets are represented by their element.
     return (*ids)[0];
+  } else if (ids->size() == 2) {
+    // Pairs are common enough to be worth bypassing the sort/dedup below.
+    return AddPair((*ids)[0], (*ids)[1]);
   } else {
     // Canonicalize the set by sorting and removing duplicates.
     std::sort(ids->begin(), ids->end());
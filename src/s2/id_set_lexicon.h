@@ -107,6 +107,13 @@ class IdSetLexicon {
   // const.  Equivalent to calling Add(&id, &id + 1).
   int32 AddSingleton(int32 id) const;
 
+  // Convenience method that returns the unique id for the set {id0, id1}.
+  // Equivalent to calling Add() with both values, but avoids the temporary
+  // storage and sorting used by the general case.  (Sets of size two are
+  // very common, e.g. when tracking the provenance of boolean operation
+  // results.)  If the two values are equal the result is a singleton set.
+  int32 AddPair(int32 id0, int32 id1);
+
   // Convenience method that returns the unique id for the empty set.  Note
   // that because the empty set takes up no space and has a fixed id, this
   // method is static.  Equivalent to calling Add() with an empty container.
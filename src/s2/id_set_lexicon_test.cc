@@ -55,6 +55,18 @@ TEST(IdSetLexicon, SingletonSets) {
   ExpectIdSet({m}, lexicon.id_set(m));
 }
 
+TEST(IdSetLexicon, PairSets) {
+  IdSetLexicon lexicon;
+  EXPECT_EQ(~0, lexicon.AddPair(5, 2));
+  EXPECT_EQ(~0, lexicon.AddPair(2, 5));
+  EXPECT_EQ(~0, lexicon.Add(Seq{5, 2}));
+  EXPECT_EQ(3, lexicon.AddPair(3, 3));
+  EXPECT_EQ(~1, lexicon.Add(Seq{0, 1}));
+
+  ExpectIdSet({2, 5}, lexicon.id_set(~0));
+  ExpectIdSet({0, 1}, lexicon.id_set(~1));
+}
+
 TEST(IdSetLexicon, SetsAreSorted) {
   IdSetLexicon lexicon;
   EXPECT_EQ(~0, lexicon.Add(Seq{2, 5}));
@@ -18,11 +18,14 @@
 #include "s2/mutable_s2shape_index.h"
 
 #include <cstddef>
+#include <cstdint>
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <cmath>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -35,6 +38,7 @@
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "absl/utility/utility.h"
 #include "s2/util/coding/coder.h"
 #include "s2/util/coding/varint.h"
@@ -48,14 +52,17 @@
 #include "s2/s2coords.h"
 #include "s2/s2edge_clipping.h"
 #include "s2/s2edge_crosser.h"
+#include "s2/s2executor.h"
 #include "s2/s2memory_tracker.h"
 #include "s2/s2metrics.h"
 #include "s2/s2padded_cell.h"
+#include "s2/s2phase_timer.h"
 #include "s2/s2point.h"
 #include "s2/s2shape.h"
 #include "s2/s2shape_index.h"
 #include "s2/s2shapeutil_contains_brute_force.h"
 #include "s2/s2shapeutil_shape_edge_id.h"
+#include "s2/s2wrapped_shape.h"
 #include "s2/util/gtl/compact_array.h"
 #include "s2/util/math/mathutil.h"
 
@@ -64,6 +71,7 @@ using std::make_pair;
 using std::make_unique;
 using std::max;
 using std::min;
+using std::string;
 using std::unique_ptr;
 using std::vector;
 
@@ -194,6 +202,216 @@ void MutableS2ShapeIndex::Options::set_max_edges_per_cell(
   max_edges_per_cell_ = max_edges_per_cell;
 }
 
+void MutableS2ShapeIndex::Options::set_num_index_threads(
+    int num_index_threads) {
+  ABSL_DCHECK_GE(num_index_threads, 1);
+  num_index_threads_ = num_index_threads;
+}
+
+void MutableS2ShapeIndex::Options::set_use_arena(bool use_arena) {
+  use_arena_ = use_arena;
+}
+
+void MutableS2ShapeIndex::Options::set_segment_allocator(
+    SegmentAllocator segment_allocator) {
+  ABSL_DCHECK_EQ(segment_allocator.alloc != nullptr,
+                 segment_allocator.free != nullptr)
+      << "Either both allocator functions must be set or neither";
+  segment_allocator_ = std::move(segment_allocator);
+}
+
+void MutableS2ShapeIndex::Options::set_max_update_milliseconds(
+    int max_update_milliseconds) {
+  ABSL_DCHECK_GE(max_update_milliseconds, 0);
+  max_update_milliseconds_ = max_update_milliseconds;
+}
+
+// An append-only block allocator used when Options::use_arena() is true
+// (see that method for details).  All S2ShapeIndexCells and out-of-line
+// S2ClippedShape edge id arrays are carved from a small number of large
+// blocks, eliminating per-cell heap allocations during index construction.
+// Individual allocations are never recycled; all blocks are released at
+// once when the arena is destroyed.  Alloc() is thread-safe because cells
+// may be created concurrently during a multi-threaded initial build (see
+// UpdateFaceEdgesParallel).
+class MutableS2ShapeIndex::CellArena {
+ public:
+  // Blocks are obtained through "segment_allocator" if its functions are
+  // set, and from the heap otherwise.  The functions are copied, since the
+  // arena can outlive the index options (see SnapshotState).
+  explicit CellArena(const Options::SegmentAllocator& segment_allocator)
+      : segment_allocator_(segment_allocator) {}
+
+  ~CellArena() {
+    for (const Block& block : blocks_) {
+      if (segment_allocator_.free != nullptr) {
+        segment_allocator_.free(block.data, block.size);
+      } else {
+        delete[] block.data;
+      }
+    }
+  }
+
+  // Returns "bytes" bytes of uninitialized memory (8-byte aligned).
+  void* Alloc(size_t bytes) {
+    bytes = (bytes + 7) & ~size_t{7};
+    SpinLockHolder lock(&lock_);
+    if (bytes > avail_) AddBlock(bytes);
+    void* result = next_;
+    next_ += bytes;
+    avail_ -= bytes;
+    return result;
+  }
+
+  // Returns true if "p" points into memory owned by this arena.  (Not all
+  // edge arrays are arena-allocated, e.g. cells created by Init(Decoder*)
+  // allocate their edge arrays on the heap; see DeleteIndexCell.)
+  bool Contains(const void* p) const {
+    SpinLockHolder lock(&lock_);
+    for (const Block& block : blocks_) {
+      if (p >= block.data && p < block.data + block.size) return true;
+    }
+    return false;
+  }
+
+  size_t SpaceUsed() const {
+    SpinLockHolder lock(&lock_);
+    size_t size = sizeof(*this) + blocks_.capacity() * sizeof(Block);
+    for (const Block& block : blocks_) size += block.size;
+    return size;
+  }
+
+ private:
+  struct Block {
+    char* data;
+    size_t size;
+  };
+
+  // Block sizes grow geometrically (up to a limit) so that small indexes
+  // waste little memory while large indexes need only a few blocks.
+  // REQUIRES: lock_ is held.
+  void AddBlock(size_t min_bytes) {
+    size_t size = max(min_bytes, min(kMaxBlockSize, next_block_size_));
+    next_block_size_ = 2 * size;
+    char* data = segment_allocator_.alloc != nullptr
+                     ? static_cast<char*>(segment_allocator_.alloc(size))
+                     : new char[size];
+    ABSL_DCHECK_EQ(reinterpret_cast<uintptr_t>(data) & 7, 0u)
+        << "Segment allocator must return 8-byte aligned memory";
+    blocks_.push_back(Block{data, size});
+    next_ = data;
+    avail_ = size;
+  }
+
+  static constexpr size_t kMaxBlockSize = size_t{1} << 20;  // 1 MB
+
+  const Options::SegmentAllocator segment_allocator_;
+  mutable SpinLock lock_;
+  vector<Block> blocks_;
+  char* next_ = nullptr;
+  size_t avail_ = 0;
+  size_t next_block_size_ = size_t{1} << 14;  // 16 KB
+};
+
+// State shared between a MutableS2ShapeIndex and its outstanding Snapshots
+// (see GetSnapshot).  Index cells that are removed from the index while
+// snapshots exist are "retired" into this structure rather than deleted, so
+// that snapshot readers never observe freed memory.  This is an epoch-style
+// reclamation scheme: the retired cells are destroyed only when the last
+// reference to this state (held by the index and by each snapshot) is
+// dropped.
+struct MutableS2ShapeIndex::SnapshotState {
+  ~SnapshotState() {
+    for (const RetiredCell& retired : retired_cells) {
+      DestroyIndexCell(const_cast<S2ShapeIndexCell*>(retired.cell),
+                       retired.arena);
+    }
+  }
+
+  // A retired cell together with the arena it was allocated from (nullptr
+  // for heap-allocated cells).  Any such arena is transferred to "arenas"
+  // below before the index stops referencing it (see Minimize), so the
+  // pointer remains valid for the lifetime of this state.
+  struct RetiredCell {
+    const S2ShapeIndexCell* cell;
+    const CellArena* arena;
+  };
+  std::vector<RetiredCell> retired_cells;
+
+  // Arenas that still back retired cells but are no longer used by the
+  // index.  These are freed by the implicit member destructor, i.e. after
+  // the retired cells have been destroyed above.
+  std::vector<std::unique_ptr<CellArena>> arenas;
+};
+
+// Returns a new S2ShapeIndexCell, allocated from the arena when one is in
+// use.  All index cells must be created through this method so that
+// DeleteIndexCell() can dispose of them correctly.
+S2ShapeIndexCell* MutableS2ShapeIndex::NewIndexCell() {
+  if (!options_.use_arena()) return new S2ShapeIndexCell;
+  if (arena_ == nullptr) {
+    arena_ = make_unique<CellArena>(options_.segment_allocator());
+  }
+  return new (arena_->Alloc(sizeof(S2ShapeIndexCell))) S2ShapeIndexCell;
+}
+
+// Destroys an index cell created by NewIndexCell().
+void MutableS2ShapeIndex::DeleteIndexCell(S2ShapeIndexCell* cell) {
+  DestroyIndexCell(cell, arena_.get());
+}
+
+// Like DeleteIndexCell(), except that when outstanding snapshots may still
+// reference "cell" it is retired into the shared snapshot state instead, and
+// destroyed only once the last such snapshot goes away.
+void MutableS2ShapeIndex::ReleaseIndexCell(S2ShapeIndexCell* cell) {
+  if (snapshot_state_ != nullptr && snapshot_state_.use_count() > 1) {
+    snapshot_state_->retired_cells.push_back(
+        SnapshotState::RetiredCell{cell, arena_.get()});
+  } else {
+    DeleteIndexCell(cell);
+  }
+}
+
+// Destroys an index cell allocated from the given arena (or from the heap if
+// "arena" is nullptr).  When the arena is in use, the cell object and (most)
+// edge arrays live in arena blocks whose memory is released wholesale when
+// the arena is destroyed; only the cell's internal compact_array storage
+// needs to be freed here.
+/*static*/ void MutableS2ShapeIndex::DestroyIndexCell(S2ShapeIndexCell* cell,
+                                                      const CellArena* arena) {
+  if (arena == nullptr) {
+    delete cell;
+    return;
+  }
+  for (int s = 0; s < cell->num_clipped(); ++s) {
+    S2ClippedShape* clipped = &cell->shapes_[s];
+    // Edge arrays carved from the arena must not be delete[]ed by
+    // S2ClippedShape::Destruct(); marking the shape empty makes it inline.
+    if (!clipped->is_inline() && arena->Contains(clipped->edges_)) {
+      clipped->num_edges_ = 0;
+    }
+  }
+  cell->~S2ShapeIndexCell();
+}
+
+// Like S2ClippedShape::Init(), but allocates the edge id array from the
+// arena when one is in use.
+void MutableS2ShapeIndex::InitClippedEdges(S2ClippedShape* clipped,
+                                           int32 shape_id, int32 num_edges) {
+  if (arena_ == nullptr) {
+    clipped->Init(shape_id, num_edges);
+    return;
+  }
+  clipped->shape_id_ = shape_id;
+  clipped->single_run_ = false;
+  clipped->num_edges_ = num_edges;
+  clipped->contains_center_ = false;
+  if (!clipped->is_inline()) {
+    clipped->edges_ =
+        static_cast<int32*>(arena_->Alloc(num_edges * sizeof(int32)));
+  }
+}
+
 // FaceEdge and ClippedEdge store temporary edge data while the index is being
 // updated.  FaceEdge represents an edge that has been projected onto a given
 // face, while ClippedEdge represents the portion of that edge that has been
@@ -442,12 +660,15 @@ MutableS2ShapeIndex::MutableS2ShapeIndex(const Options& options) {
 MutableS2ShapeIndex::MutableS2ShapeIndex(MutableS2ShapeIndex&& b)
     : S2ShapeIndex(std::move(b)),
       shapes_(std::move(b.shapes_)),
+      num_edges_(std::exchange(b.num_edges_, 0)),
       cell_map_(std::move(b.cell_map_)),
       options_(std::move(b.options_)),
       pending_additions_begin_(std::exchange(b.pending_additions_begin_, 0)),
       pending_removals_(std::move(b.pending_removals_)),
       index_status_(b.index_status_.exchange(FRESH, std::memory_order_relaxed)),
-      mem_tracker_(std::move(b.mem_tracker_)) {}
+      mem_tracker_(std::move(b.mem_tracker_)),
+      arena_(std::move(b.arena_)),
+      snapshot_state_(std::move(b.snapshot_state_)) {}
 
 MutableS2ShapeIndex& MutableS2ShapeIndex::operator=(MutableS2ShapeIndex&& b) {
   // We need to delegate to our parent move-assignment operator since we can't
@@ -455,6 +676,7 @@ MutableS2ShapeIndex& MutableS2ShapeIndex::operator=(MutableS2ShapeIndex&& b) {
   // half-moved state after calling but is ultimately safe.
   S2ShapeIndex::operator=(static_cast<S2ShapeIndex&&>(b));
   shapes_ = std::move(b.shapes_);
+  num_edges_ = std::exchange(b.num_edges_, 0);
   cell_map_.swap(b.cell_map_);
   options_ = std::move(b.options_);
   pending_additions_begin_ = std::exchange(b.pending_additions_begin_, 0);
@@ -463,6 +685,8 @@ MutableS2ShapeIndex& MutableS2ShapeIndex::operator=(MutableS2ShapeIndex&& b) {
       b.index_status_.exchange(FRESH, std::memory_order_relaxed),
       std::memory_order_relaxed);
   mem_tracker_ = std::move(b.mem_tracker_);
+  arena_ = std::move(b.arena_);
+  snapshot_state_ = std::move(b.snapshot_state_);
   return *this;
 }
 
@@ -478,7 +702,7 @@ MutableS2ShapeIndex::~MutableS2ShapeIndex() {
 
 void MutableS2ShapeIndex::set_memory_tracker(S2MemoryTracker* tracker) {
   mem_tracker_.Tally(-mem_tracker_.client_usage_bytes());
-  mem_tracker_.Init(tracker);
+  mem_tracker_.Init(tracker, "MutableS2ShapeIndex");
   if (mem_tracker_.is_active()) mem_tracker_.Tally(SpaceUsed());
 }
 
@@ -495,28 +719,187 @@ void MutableS2ShapeIndex::MarkIndexStale() {
 
 void MutableS2ShapeIndex::Minimize() {
   mem_tracker_.Tally(-mem_tracker_.client_usage_bytes());
+  if (snapshot_state_ != nullptr && snapshot_state_.use_count() == 1) {
+    // All snapshots are gone; free any cells retired on their behalf.
+    snapshot_state_.reset();
+  }
   Iterator it;
   for (it.InitStale(this, S2ShapeIndex::BEGIN); !it.done(); it.Next()) {
-    delete &it.cell();
+    ReleaseIndexCell(const_cast<S2ShapeIndexCell*>(&it.cell()));
   }
   cell_map_.clear();
+  if (snapshot_state_ != nullptr && arena_ != nullptr) {
+    // Outstanding snapshots may still reference arena-allocated cells, so
+    // transfer ownership of the arena to the shared state.
+    snapshot_state_->arenas.push_back(std::move(arena_));
+  }
+  arena_.reset();
   pending_removals_.reset();
   pending_additions_begin_ = 0;
   MarkIndexStale();
   if (mem_tracker_.is_active()) mem_tracker_.Tally(SpaceUsed());
 }
 
+unique_ptr<MutableS2ShapeIndex::Snapshot> MutableS2ShapeIndex::GetSnapshot() {
+  // Apply any pending updates first, so that the snapshot reflects them and
+  // so that the cells copied below are no longer subject to change.
+  ForceBuild();
+  if (snapshot_state_ != nullptr && snapshot_state_.use_count() == 1) {
+    // All previous snapshots are gone; free the cells retired on their
+    // behalf rather than sharing them with the new snapshot.
+    snapshot_state_.reset();
+  }
+  if (snapshot_state_ == nullptr) {
+    snapshot_state_ = std::make_shared<SnapshotState>();
+  }
+  auto snapshot = unique_ptr<Snapshot>(new Snapshot);
+  snapshot->options_ = options_;
+  snapshot->state_ = snapshot_state_;
+  snapshot->shapes_.reserve(shapes_.size());
+  for (const auto& shape : shapes_) {
+    snapshot->shapes_.push_back(shape.get());
+  }
+  snapshot->cell_ids_.reserve(cell_map_.size());
+  snapshot->cells_.reserve(cell_map_.size());
+  for (const auto& entry : cell_map_) {
+    snapshot->cell_ids_.push_back(entry.first);
+    snapshot->cells_.push_back(entry.second);
+  }
+  return snapshot;
+}
+
+unique_ptr<MutableS2ShapeIndex::Compaction>
+MutableS2ShapeIndex::PrepareCompaction() {
+  // Apply any pending updates first so that the compacted index reflects
+  // them and the contents examined below are stable.
+  ForceBuild();
+  auto compaction = unique_ptr<Compaction>(new Compaction);
+  compaction->index_.Init(options_);
+  compaction->expected_shapes_.reserve(shapes_.size());
+  for (size_t id = 0; id < shapes_.size(); ++id) {
+    compaction->expected_shapes_.push_back(shapes_[id].get());
+    if (shapes_[id] == nullptr) continue;
+    compaction->old_shape_ids_.push_back(static_cast<int>(id));
+    compaction->index_.Add(make_unique<S2WrappedShape>(shapes_[id].get()));
+  }
+  // The expensive part: build the dense cell structures.  Only immutable
+  // shape geometry is read here, so this may run on a background thread
+  // while other threads query this index or snapshots of it.
+  compaction->index_.ForceBuild();
+  return compaction;
+}
+
+vector<int> MutableS2ShapeIndex::ApplyCompaction(
+    unique_ptr<Compaction> compaction) {
+  ABSL_DCHECK(update_state_ == nullptr);
+  ABSL_DCHECK_EQ(shapes_.size(), compaction->expected_shapes_.size());
+  MutableS2ShapeIndex& dense = compaction->index_;
+
+  mem_tracker_.Tally(-mem_tracker_.client_usage_bytes());
+
+  // Retire the current cells and arena exactly as Minimize() does, so that
+  // outstanding snapshots remain valid.
+  if (snapshot_state_ != nullptr && snapshot_state_.use_count() == 1) {
+    snapshot_state_.reset();
+  }
+  Iterator it;
+  for (it.InitStale(this, S2ShapeIndex::BEGIN); !it.done(); it.Next()) {
+    ReleaseIndexCell(const_cast<S2ShapeIndexCell*>(&it.cell()));
+  }
+  cell_map_.clear();
+  if (snapshot_state_ != nullptr && arena_ != nullptr) {
+    snapshot_state_->arenas.push_back(std::move(arena_));
+  }
+  arena_.reset();
+
+  // Replace the non-owning wrappers with the real shapes, renumbering them
+  // densely.  The shape objects themselves do not move in memory, so raw
+  // pointers held by snapshots remain valid.
+  const int num_shapes = static_cast<int>(compaction->old_shape_ids_.size());
+  for (int new_id = 0; new_id < num_shapes; ++new_id) {
+    const int old_id = compaction->old_shape_ids_[new_id];
+    ABSL_DCHECK_EQ(shapes_[old_id].get(),
+                   compaction->expected_shapes_[old_id]);
+    dense.shapes_[new_id] = std::move(shapes_[old_id]);
+  }
+
+  // Install the dense structures.
+  shapes_ = std::move(dense.shapes_);
+  num_edges_ = dense.num_edges_;
+  cell_map_.swap(dense.cell_map_);
+  arena_ = std::move(dense.arena_);
+  pending_additions_begin_ = static_cast<int>(shapes_.size());
+  pending_removals_.reset();
+  index_status_.store(FRESH, std::memory_order_relaxed);
+
+  if (mem_tracker_.is_active()) mem_tracker_.Tally(SpaceUsed());
+  return std::move(compaction->old_shape_ids_);
+}
+
+MutableS2ShapeIndex::Snapshot::~Snapshot() = default;
+
+void MutableS2ShapeIndex::Snapshot::Encode(Encoder* encoder) const {
+  // This matches the encoding written by MutableS2ShapeIndex::Encode (with
+  // the same version number), so the output can be decoded by either
+  // MutableS2ShapeIndex or EncodedS2ShapeIndex.
+  encoder->Ensure(Varint::kMax64);
+  uint64 max_edges = options_.max_edges_per_cell();
+  encoder->put_varint64(max_edges << 2 | kCurrentEncodingVersionNumber);
+
+  s2coding::StringVectorEncoder encoded_cells;
+  for (int i = 0; i < num_cells(); ++i) {
+    cells_[i]->Encode(num_shape_ids(), encoded_cells.AddViaEncoder());
+  }
+  s2coding::EncodeS2CellIdVector(cell_ids_, encoder);
+  encoded_cells.Encode(encoder);
+}
+
+size_t MutableS2ShapeIndex::Snapshot::SpaceUsed() const {
+  // The cell contents are shared with the index (and possibly with other
+  // snapshots) and are therefore not counted here.
+  size_t size = sizeof(*this);
+  size += shapes_.capacity() * sizeof(const S2Shape*);
+  size += cell_ids_.capacity() * sizeof(S2CellId);
+  size += cells_.capacity() * sizeof(const S2ShapeIndexCell*);
+  return size;
+}
+
+void MutableS2ShapeIndex::Snapshot::Iterator::Seek(S2CellId target) {
+  cell_pos_ = std::lower_bound(snapshot_->cell_ids_.begin(),
+                               snapshot_->cell_ids_.end(), target) -
+              snapshot_->cell_ids_.begin();
+}
+
 int MutableS2ShapeIndex::Add(unique_ptr<S2Shape> shape) {
   // Additions are processed lazily by ApplyUpdates().  Note that in order to
   // avoid unexpected client behavior, this method continues to add shapes
   // even once the specified S2MemoryTracker limit has been exceeded.
   const int id = shapes_.size();
   mem_tracker_.AddSpace(&shapes_, 1);
+  if (shape != nullptr) num_edges_ += shape->num_edges();
   shapes_.push_back(std::move(shape));
   MarkIndexStale();
   return id;
 }
 
+int MutableS2ShapeIndex::Add(absl::Span<unique_ptr<S2Shape>> shapes) {
+  const int id = shapes_.size();
+  if (shapes.empty()) return id;
+  mem_tracker_.AddSpaceExact(&shapes_, shapes.size());
+  for (unique_ptr<S2Shape>& shape : shapes) {
+    if (shape != nullptr) num_edges_ += shape->num_edges();
+    shapes_.push_back(std::move(shape));
+  }
+  MarkIndexStale();
+  return id;
+}
+
+void MutableS2ShapeIndex::Reserve(int num_shapes) {
+  // As with Add(), reservation proceeds even once an S2MemoryTracker limit
+  // has been exceeded.
+  mem_tracker_.AddSpaceExact(&shapes_, num_shapes);
+}
+
 unique_ptr<S2Shape> MutableS2ShapeIndex::Release(int shape_id) {
   // This class updates itself lazily, because it is much more efficient to
   // process additions and removals in batches.  However this means that when
@@ -525,6 +908,7 @@ unique_ptr<S2Shape> MutableS2ShapeIndex::Release(int shape_id) {
 
   ABSL_DCHECK(shapes_[shape_id] != nullptr);
   auto shape = std::move(shapes_[shape_id]);
+  num_edges_ -= shape->num_edges();
   if (shape_id >= pending_additions_begin_) {
     // We are removing a shape that has not yet been added to the index,
     // so there is nothing else to do.
@@ -560,6 +944,7 @@ vector<unique_ptr<S2Shape>> MutableS2ShapeIndex::ReleaseAll() {
   ABSL_DCHECK(update_state_ == nullptr);
   vector<unique_ptr<S2Shape>> result;
   result.swap(shapes_);
+  num_edges_ = 0;
   Minimize();
   return result;
 }
@@ -599,12 +984,16 @@ void MutableS2ShapeIndex::ApplyUpdatesThreadSafe() {
     update_state_->wait_mutex.Lock();
     // Release the spinlock before doing any real work.
     lock_.Unlock();
-    ApplyUpdatesInternal();
+    // With Options::max_update_milliseconds() set, only part of the pending
+    // work may be applied; the index then remains STALE (but consistent) and
+    // application resumes on the next triggering query.
+    bool fully_applied = ApplyUpdatesInternal();
     lock_.Lock();
     // index_status_ can be updated to FRESH only while locked *and* using
     // an atomic store operation, so that MaybeApplyUpdates() can check
     // whether the index is FRESH without acquiring the spinlock.
-    index_status_.store(FRESH, std::memory_order_release);
+    index_status_.store(fully_applied ? FRESH : STALE,
+                        std::memory_order_release);
     UnlockAndSignal();  // Notify any waiting threads.
   }
 }
@@ -614,7 +1003,9 @@ void MutableS2ShapeIndex::ApplyUpdatesThreadSafe() {
 // REQUIRES: lock_ is held.
 // REQUIRES: wait_mutex is held.
 inline void MutableS2ShapeIndex::UnlockAndSignal() {
-  ABSL_DCHECK_EQ(FRESH, index_status_);
+  // The status is normally FRESH here, but may be STALE if an update budget
+  // was exceeded (see Options::max_update_milliseconds).
+  ABSL_DCHECK_NE(UPDATING, index_status_);
   int num_waiting = update_state_->num_waiting;
   lock_.Unlock();
   // Allow another waiting thread to proceed.  Note that no new threads can
@@ -630,21 +1021,48 @@ inline void MutableS2ShapeIndex::UnlockAndSignal() {
   }
 }
 
-// This method updates the index by applying all pending additions and
-// removals.  It does *not* update index_status_ (see ApplyUpdatesThreadSafe).
-void MutableS2ShapeIndex::ApplyUpdatesInternal() {
+// This method updates the index by applying pending additions and removals,
+// and returns true if all pending updates were applied.  When
+// Options::max_update_milliseconds() is set, it may stop at a batch boundary
+// once the budget is exceeded and return false; the index is then consistent
+// (all removals plus a prefix of the additions) and a later call resumes
+// from pending_additions_begin_.  It does *not* update index_status_ (see
+// ApplyUpdatesThreadSafe).
+bool MutableS2ShapeIndex::ApplyUpdatesInternal() {
+  S2PhaseTimer phase_timer(S2Phase::kIndexApplyUpdates);
+  // A steady clock is used so that the budget is unaffected by system clock
+  // adjustments.
+  const bool has_deadline = options_.max_update_milliseconds() > 0;
+  const auto deadline =
+      std::chrono::steady_clock::now() +
+      std::chrono::milliseconds(options_.max_update_milliseconds());
+
   // Check whether we have so many edges to process that we should process
   // them in multiple batches to save memory.  Building the index can use up
   // to 20x as much memory (per edge) as the final index size.
   vector<BatchDescriptor> batches = GetUpdateBatches();
-  for (const BatchDescriptor& batch : batches) {
+
+  // Whether the six face subtrees may be built in parallel (see
+  // Options::set_num_index_threads).  This is only done for the initial
+  // build of an empty index: with no existing index cells and no shapes
+  // being removed, the recursion never locates or absorbs existing cells,
+  // so the face subtrees are independent except for their (disjoint)
+  // insertions into cell_map_.
+  const bool parallel_build =
+      options_.num_index_threads() > 1 && batches.size() == 1 &&
+      cell_map_.empty() && !pending_removals_ && !mem_tracker_.is_active();
+  for (size_t batch_index = 0; batch_index < batches.size(); ++batch_index) {
+    const BatchDescriptor& batch = batches[batch_index];
     if (mem_tracker_.is_active()) {
       ABSL_DCHECK_EQ(mem_tracker_.client_usage_bytes(),
                      SpaceUsed());  // Invariant.
     }
     vector<FaceEdge> all_edges[6];
     ReserveSpace(batch, all_edges);
-    if (!mem_tracker_.ok()) return Minimize();
+    if (!mem_tracker_.ok()) {
+      Minimize();
+      return true;
+    }
 
     InteriorTracker tracker;
     if (pending_removals_) {
@@ -665,10 +1083,20 @@ void MutableS2ShapeIndex::ApplyUpdatesInternal() {
       AddShape(shape, begin.shape_id, begin.edge_id, edges_end, all_edges,
                &tracker);
     }
-    for (int face = 0; face < 6; ++face) {
-      UpdateFaceEdges(face, all_edges[face], &tracker);
-      // Save memory by clearing vectors after we are done with them.
-      vector<FaceEdge>().swap(all_edges[face]);
+    if (parallel_build) {
+      // Partial shapes only occur when updates are split across batches.
+      ABSL_DCHECK_LT(tracker.partial_shape_id(), 0);
+      UpdateFaceEdgesParallel(batch, all_edges);
+      for (int face = 0; face < 6; ++face) {
+        vector<FaceEdge>().swap(all_edges[face]);
+      }
+    } else {
+      for (int face = 0; face < 6; ++face) {
+        UpdateFaceEdges(face, all_edges[face], &tracker,
+                        false /*disjoint_from_index*/);
+        // Save memory by clearing vectors after we are done with them.
+        vector<FaceEdge>().swap(all_edges[face]);
+      }
     }
     pending_additions_begin_ = batch.end.shape_id;
     if (batch.begin.edge_id > 0 && batch.end.edge_id == 0) {
@@ -679,10 +1107,23 @@ void MutableS2ShapeIndex::ApplyUpdatesInternal() {
     }
     if (mem_tracker_.is_active()) {
       mem_tracker_.Tally(-mem_tracker_.client_usage_bytes());
-      if (!mem_tracker_.Tally(SpaceUsed())) return Minimize();
+      if (!mem_tracker_.Tally(SpaceUsed())) {
+        Minimize();
+        return true;
+      }
+    }
+    // Stop early if the update budget is exhausted, but only at a shape
+    // boundary: a batch that ends mid-shape (end.edge_id != 0) leaves that
+    // shape partially indexed, and application resumes at whole-shape
+    // granularity (pending_additions_begin_).
+    if (has_deadline && batch_index + 1 < batches.size() &&
+        batch.end.edge_id == 0 &&
+        std::chrono::steady_clock::now() >= deadline) {
+      return false;
     }
   }
   // It is the caller's responsibility to update index_status_.
+  return true;
 }
 
 // Count the number of edges being updated, and break them into several
@@ -1090,7 +1531,7 @@ void MutableS2ShapeIndex::FinishPartialShape(int shape_id) {
                                         : S2CellId::End(S2CellId::kMaxLevel);
       if (begin != fill_end) {
         for (S2CellId cellid : S2CellUnion::FromBeginEnd(begin, fill_end)) {
-          S2ShapeIndexCell* cell = new S2ShapeIndexCell;
+          S2ShapeIndexCell* cell = NewIndexCell();
           S2ClippedShape* clipped = cell->add_shapes(1);
           clipped->Init(shape_id, 0);
           clipped->set_contains_center(true);
@@ -1230,9 +1671,54 @@ class MutableS2ShapeIndex::EdgeAllocator {
 // Given a face and a vector of edges that intersect that face, add or remove
 // all the edges from the index.  (An edge is added if shapes_[id] is not
 // nullptr, and removed otherwise.)
+// Builds the six face subtrees in parallel using up to
+// options_.num_index_threads() threads, each thread processing entire faces.
+// Each face gets its own InteriorTracker whose focus starts at the point
+// where the space-filling curve enters that face, seeded by testing every
+// shape with an interior against that point.  This reproduces exactly the
+// tracker state that the single-threaded code has when it reaches the face,
+// since the same set of shapes contains the exit point of one face and the
+// entry point of the next (there are no intervening cells).
+//
+// REQUIRES: cell_map_ is empty and there are no pending removals (so that
+//           the face subtrees are independent; see ApplyUpdatesInternal).
+void MutableS2ShapeIndex::UpdateFaceEdgesParallel(
+    const BatchDescriptor& batch, const vector<FaceEdge> all_edges[6]) {
+  // Create the arena (if enabled) before spawning any threads, since lazy
+  // creation in NewIndexCell() is not thread-safe.
+  if (options_.use_arena() && arena_ == nullptr) {
+    arena_ = make_unique<CellArena>(options_.segment_allocator());
+  }
+  update_threads_active_ = true;
+  std::atomic<int> next_face{0};
+  const auto build_faces = [&]() {
+    for (int face = next_face++; face < 6; face = next_face++) {
+      InteriorTracker tracker;
+      S2PaddedCell face_pcell(S2CellId::FromFace(face), kCellPadding);
+      tracker.MoveTo(face_pcell.GetEntryVertex());
+      tracker.set_next_cellid(face_pcell.id());
+      for (int shape_id = pending_additions_begin_;
+           shape_id < batch.end.shape_id; ++shape_id) {
+        const S2Shape* shape = this->shape(shape_id);
+        if (shape == nullptr || shape->dimension() != 2) continue;
+        tracker.AddShape(shape_id, s2shapeutil::ContainsBruteForce(
+                                       *shape, tracker.focus()));
+      }
+      UpdateFaceEdges(face, all_edges[face], &tracker,
+                      true /*disjoint_from_index*/);
+    }
+  };
+  int num_threads = min(options_.num_index_threads(), 6);
+  S2Executor* executor = options_.executor();
+  if (executor == nullptr) executor = S2Executor::Default();
+  executor->Run(num_threads, [&build_faces](int) { build_faces(); });
+  update_threads_active_ = false;
+}
+
 void MutableS2ShapeIndex::UpdateFaceEdges(int face,
                                           const vector<FaceEdge>& face_edges,
-                                          InteriorTracker* tracker) {
+                                          InteriorTracker* tracker,
+                                          bool disjoint_from_index) {
   int num_edges = face_edges.size();
   if (num_edges == 0 && tracker->shape_ids().empty()) return;
 
@@ -1261,15 +1747,20 @@ void MutableS2ShapeIndex::UpdateFaceEdges(int face,
   S2PaddedCell pcell(face_id, kCellPadding);
 
   // "disjoint_from_index" means that the current cell being processed (and
-  // all its descendants) are not already present in the index.  It is set to
-  // true during the recursion whenever we detect that the current cell is
-  // disjoint from the index.  We could save a tiny bit of work by setting
-  // this flag to true here on the very first update, however currently there
-  // is no easy way to check that.  (It's not sufficient to test whether
-  // cell_map_.empty() or pending_additions_begin_ == 0.)
-  bool disjoint_from_index = false;
+  // all its descendants) are not already present in the index.  It is passed
+  // as true by UpdateFaceEdgesParallel() (which requires an empty index) and
+  // is otherwise set to true during the recursion whenever we detect that
+  // the current cell is disjoint from the index.  In the latter case we
+  // could save a tiny bit of work by setting this flag to true here on the
+  // very first update, however currently there is no easy way to check that.
+  // (It's not sufficient to test whether cell_map_.empty() or
+  // pending_additions_begin_ == 0.)
   if (num_edges > 0) {
-    S2CellId shrunk_id = ShrinkToFit(pcell, bound);
+    // When the index is known to be empty we must not consult it, both
+    // because there is nothing to find and because other faces may be
+    // inserting cells concurrently (see UpdateFaceEdgesParallel).
+    S2CellId shrunk_id = disjoint_from_index ? pcell.ShrinkToFit(bound)
+                                             : ShrinkToFit(pcell, bound);
     if (shrunk_id != pcell.id()) {
       // All the edges are contained by some descendant of the face cell.  We
       // can save a lot of work by starting directly with that cell, but if we
@@ -1675,7 +2166,7 @@ void MutableS2ShapeIndex::AbsorbIndexCell(const S2PaddedCell& pcell,
   // Update the edge list and delete this cell from the index.
   edges->swap(new_edges);
   cell_map_.erase(pcell.id());
-  delete &cell;
+  ReleaseIndexCell(const_cast<S2ShapeIndexCell*>(&cell));
 }
 
 // Attempt to build an index cell containing the given edges, and return true
@@ -1841,7 +2332,7 @@ bool MutableS2ShapeIndex::MakeIndexCell(const S2PaddedCell& pcell,
   // with the shapes that happen to contain the cell center.
   const ShapeIdSet& cshape_ids = tracker->shape_ids();
   int num_shapes = CountShapes(edges, cshape_ids);
-  S2ShapeIndexCell* cell = new S2ShapeIndexCell;
+  S2ShapeIndexCell* cell = NewIndexCell();
   S2ClippedShape* base = cell->add_shapes(num_shapes);
 
   // To fill the index cell we merge the two sources of shapes: "edge shapes"
@@ -1872,9 +2363,23 @@ bool MutableS2ShapeIndex::MakeIndexCell(const S2PaddedCell& pcell,
              edges[enext]->face_edge->shape_id == eshape_id) {
         ++enext;
       }
-      clipped->Init(eshape_id, enext - ebegin);
-      for (size_t e = ebegin; e < enext; ++e) {
-        clipped->set_edge(e - ebegin, edges[e]->face_edge->edge_id);
+      // Consecutive edges of a polyline chain usually intersect the same
+      // cell, so the edge ids frequently form a single contiguous run; such
+      // runs can be stored inline without allocating an edge array.
+      int num_edges = enext - ebegin;
+      int first_edge = edges[ebegin]->face_edge->edge_id;
+      bool single_run = num_edges > S2ClippedShape::kMaxInlineEdges;
+      for (size_t e = ebegin + 1; single_run && e < enext; ++e) {
+        single_run = edges[e]->face_edge->edge_id ==
+                     first_edge + static_cast<int>(e - ebegin);
+      }
+      if (single_run) {
+        clipped->InitRun(eshape_id, first_edge, num_edges);
+      } else {
+        InitClippedEdges(clipped, eshape_id, num_edges);
+        for (size_t e = ebegin; e < enext; ++e) {
+          clipped->set_edge(e - ebegin, edges[e]->face_edge->edge_id);
+        }
       }
       if (cshape_id == eshape_id) {
         clipped->set_contains_center(true);
@@ -1887,7 +2392,17 @@ bool MutableS2ShapeIndex::MakeIndexCell(const S2PaddedCell& pcell,
   // is much faster to give an insertion hint in this case.  Otherwise the
   // hint doesn't do much harm.  With more effort we could provide a hint even
   // during incremental updates, but this is probably not worth the effort.
-  cell_map_.insert(cell_map_.end(), make_pair(pcell.id(), cell));
+  if (update_threads_active_) {
+    // Several face subtrees are being built concurrently (see
+    // UpdateFaceEdgesParallel).  Each face still inserts cells in increasing
+    // order within its own disjoint S2CellId range, but the end() hint no
+    // longer applies and insertions must be serialized.
+    cells_lock_.Lock();
+    cell_map_.insert(make_pair(pcell.id(), cell));
+    cells_lock_.Unlock();
+  } else {
+    cell_map_.insert(cell_map_.end(), make_pair(pcell.id(), cell));
+  }
 
   // Shift the InteriorTracker focus point to the exit vertex of this cell.
   if (tracker->is_active() && !edges.empty()) {
@@ -1940,14 +2455,20 @@ size_t MutableS2ShapeIndex::SpaceUsed() const {
   size += shapes_.capacity() * sizeof(unique_ptr<S2Shape>);
   // cell_map_ itself is already included in sizeof(*this).
   size += cell_map_.bytes_used() - sizeof(cell_map_);
-  size += cell_map_.size() * sizeof(S2ShapeIndexCell);
+  if (arena_ != nullptr) {
+    // Index cells and most clipped edge arrays live in the arena.
+    size += arena_->SpaceUsed();
+  } else {
+    size += cell_map_.size() * sizeof(S2ShapeIndexCell);
+  }
   Iterator it;
   for (it.InitStale(this, S2ShapeIndex::BEGIN); !it.done(); it.Next()) {
     const S2ShapeIndexCell& cell = it.cell();
     size += cell.shapes_.capacity() * sizeof(S2ClippedShape);
     for (int s = 0; s < cell.num_clipped(); ++s) {
       const S2ClippedShape& clipped = cell.clipped(s);
-      if (!clipped.is_inline()) {
+      if (!clipped.is_inline() &&
+          (arena_ == nullptr || !arena_->Contains(clipped.edges_))) {
         size += clipped.num_edges() * sizeof(int32);
       }
     }
@@ -1963,6 +2484,7 @@ size_t MutableS2ShapeIndex::SpaceUsed() const {
 }
 
 void MutableS2ShapeIndex::Encode(Encoder* encoder) const {
+  S2PhaseTimer phase_timer(S2Phase::kIndexEncode);
   // The version number is encoded in 2 bits, under the assumption that by the
   // time we need 5 versions the first version can be permanently retired.
   // This only saves 1 byte, but that's significant for very small indexes.
@@ -1975,17 +2497,65 @@ void MutableS2ShapeIndex::Encode(Encoder* encoder) const {
   ForceBuild();
   vector<S2CellId> cell_ids;
   cell_ids.reserve(cell_map_.size());
-  s2coding::StringVectorEncoder encoded_cells;
+  int num_threads = options_.num_index_threads();
+  if (num_threads > 1 && cell_map_.size() > 1) {
+    EncodeCellsParallel(num_threads, &cell_ids, encoder);
+  } else {
+    s2coding::StringVectorEncoder encoded_cells;
+    for (Iterator it(this, S2ShapeIndex::BEGIN); !it.done(); it.Next()) {
+      cell_ids.push_back(it.id());
+      it.cell().Encode(num_shape_ids(), encoded_cells.AddViaEncoder());
+    }
+    s2coding::EncodeS2CellIdVector(cell_ids, encoder);
+    encoded_cells.Encode(encoder);
+  }
+}
+
+// Encodes the index cells using up to "num_threads" threads and appends the
+// result to "encoder" (along with the cell ids, which are returned in
+// "cell_ids").  Each cell is encoded independently into its own string;
+// chunks of consecutive cells are claimed dynamically so that threads stay
+// busy even when cell sizes are skewed.  The per-cell strings are then
+// assembled sequentially, which is a cheap memcpy.  The output is
+// byte-for-byte identical to the single-threaded encoding, since the encoded
+// string vector format already stores an offset directory for the cells.
+void MutableS2ShapeIndex::EncodeCellsParallel(int num_threads,
+                                              vector<S2CellId>* cell_ids,
+                                              Encoder* encoder) const {
+  vector<const S2ShapeIndexCell*> cells;
+  cells.reserve(cell_map_.size());
   for (Iterator it(this, S2ShapeIndex::BEGIN); !it.done(); it.Next()) {
-    cell_ids.push_back(it.id());
-    it.cell().Encode(num_shape_ids(), encoded_cells.AddViaEncoder());
+    cell_ids->push_back(it.id());
+    cells.push_back(&it.cell());
   }
-  s2coding::EncodeS2CellIdVector(cell_ids, encoder);
-  encoded_cells.Encode(encoder);
+  vector<string> encoded(cells.size());
+  // Chunks are large enough to amortize the atomic increment but small
+  // enough to balance load across threads.
+  constexpr size_t kCellsPerChunk = 64;
+  std::atomic<size_t> next_begin{0};
+  const auto encode_cells = [&]() {
+    Encoder cell_encoder;
+    for (;;) {
+      size_t begin = next_begin.fetch_add(kCellsPerChunk);
+      if (begin >= cells.size()) break;
+      size_t end = min(begin + kCellsPerChunk, cells.size());
+      for (size_t i = begin; i < end; ++i) {
+        cell_encoder.clear();
+        cells[i]->Encode(num_shape_ids(), &cell_encoder);
+        encoded[i].assign(cell_encoder.base(), cell_encoder.length());
+      }
+    }
+  };
+  S2Executor* executor = options_.executor();
+  if (executor == nullptr) executor = S2Executor::Default();
+  executor->Run(num_threads, [&encode_cells](int) { encode_cells(); });
+  s2coding::EncodeS2CellIdVector(*cell_ids, encoder);
+  s2coding::StringVectorEncoder::Encode(encoded, encoder);
 }
 
 bool MutableS2ShapeIndex::Init(Decoder* decoder,
                                const ShapeFactory& shape_factory) {
+  S2PhaseTimer phase_timer(S2Phase::kIndexDecode);
   Clear();
   uint64 max_edges_version;
   if (!decoder->get_varint64(&max_edges_version)) return false;
@@ -1996,6 +2566,7 @@ bool MutableS2ShapeIndex::Init(Decoder* decoder,
   shapes_.reserve(num_shapes);
   for (size_t shape_id = 0; shape_id < num_shapes; ++shape_id) {
     auto shape = shape_factory[shape_id];
+    if (shape != nullptr) num_edges_ += shape->num_edges();
     shapes_.push_back(std::move(shape));
   }
 
@@ -2006,10 +2577,10 @@ bool MutableS2ShapeIndex::Init(Decoder* decoder,
 
   for (size_t i = 0; i < cell_ids.size(); ++i) {
     S2CellId id = cell_ids[i];
-    S2ShapeIndexCell* cell = new S2ShapeIndexCell;
+    S2ShapeIndexCell* cell = NewIndexCell();
     Decoder decoder = encoded_cells.GetDecoder(i);
     if (!cell->Decode(num_shapes, &decoder)) {
-      delete cell;
+      DeleteIndexCell(cell);
       return false;
     }
     cell_map_.insert(cell_map_.end(), make_pair(id, cell));
@@ -21,6 +21,7 @@
 #include <array>
 #include <atomic>
 #include <cstddef>
+#include <functional>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -30,6 +31,7 @@
 #include "absl/log/absl_check.h"
 #include "absl/container/btree_map.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 
 #include "s2/base/commandlineflags.h"
 #include "s2/base/commandlineflags_declare.h"
@@ -39,6 +41,7 @@
 #include "s2/r1interval.h"
 #include "s2/r2rect.h"
 #include "s2/s2cell_id.h"
+#include "s2/s2executor.h"
 #include "s2/s2memory_tracker.h"
 #include "s2/s2point.h"
 #include "s2/s2pointutil.h"
@@ -120,7 +123,16 @@ class BTreeMap : public absl::btree_map<Key, Value> {
 // ensure that no cell contains more than a small number of edges.
 //
 // For efficiency, updates are batched together and applied lazily on the
-// first subsequent query.  Locking is used to ensure that MutableS2ShapeIndex
+// first subsequent query.  Updates are also applied incrementally at cell
+// granularity: the recursion that re-clips edges only descends into index
+// cells whose region is intersected by an added or removed edge (or by the
+// interior of an added or removed shape), absorbing and rebuilding exactly
+// those cells and leaving disjoint subtrees untouched.  As a result the cost
+// of releasing and re-adding one shape is proportional to the number of
+// cells that shape intersects, not to the size of the index, which makes
+// interactive editing of a large index practical.
+//
+// Locking is used to ensure that MutableS2ShapeIndex
 // has the same thread-safety properties as "vector": const methods are
 // thread-safe, while non-const methods are not thread-safe.  This means that
 // if one thread updates the index, you must ensure that no other thread is
@@ -168,8 +180,104 @@ class MutableS2ShapeIndex final : public S2ShapeIndex {
     int max_edges_per_cell() const { return max_edges_per_cell_; }
     void set_max_edges_per_cell(int max_edges_per_cell);
 
+    // The maximum number of threads used to apply the initial batch of
+    // updates (e.g., the first query after a long sequence of Add() calls).
+    // When more than one thread is specified, the six cube faces and their
+    // subtrees are distributed across a pool of that many threads, which can
+    // substantially reduce the time needed to build very large indexes.
+    //
+    // Multiple threads are only used when the index is otherwise empty,
+    // there are no pending shape removals, all updates fit in a single batch
+    // (see --s2shape_index_tmp_memory_budget), and memory tracking is not
+    // enabled (see set_memory_tracker); otherwise the single-threaded code
+    // path is used.  In particular, incremental updates are always applied
+    // single-threaded.  The resulting index is identical in either case.
+    //
+    // Defaults to 1 (single-threaded).
+    int num_index_threads() const { return num_index_threads_; }
+    void set_num_index_threads(int num_index_threads);
+
+    // If true, the index cells and their out-of-line edge id arrays are
+    // carved from a few large blocks owned by the index rather than being
+    // allocated individually on the heap.  This eliminates millions of
+    // small allocations when building large indexes, and tearing the index
+    // down releases just the underlying blocks.
+    //
+    // The trade-off is that the memory of individual cells is not recycled
+    // until the index is cleared or destroyed, so workloads that perform
+    // many incremental updates will temporarily retain the memory of
+    // replaced cells.  Arena memory is reported through SpaceUsed() and
+    // therefore tracked by any S2MemoryTracker (see set_memory_tracker).
+    //
+    // Defaults to false.
+    bool use_arena() const { return use_arena_; }
+    void set_use_arena(bool use_arena);
+
+    // An optional pair of functions used to allocate and free the large
+    // memory blocks created when use_arena() is true.  This lets clients
+    // control the placement of the bulk of the index memory, e.g. backing
+    // it with huge pages (MAP_HUGETLB) to reduce TLB misses or binding it
+    // to a particular NUMA node, which can matter for very large indexes.
+    //
+    // The alloc function must return memory aligned to at least 8 bytes and
+    // may be called concurrently during a multi-threaded build.  The free
+    // function is called once per block with the original pointer and size.
+    // Either both functions must be set or neither.  The hooks have no
+    // effect unless use_arena() is true, since without the arena all
+    // allocations are small and per-cell.
+    //
+    // Defaults to empty functions, meaning blocks come from the heap.
+    struct SegmentAllocator {
+      std::function<void* (size_t bytes)> alloc;
+      std::function<void (void* ptr, size_t bytes)> free;
+    };
+    const SegmentAllocator& segment_allocator() const {
+      return segment_allocator_;
+    }
+    void set_segment_allocator(SegmentAllocator segment_allocator);
+
+    // The executor used to run the threads requested by
+    // set_num_index_threads().  This allows clients with their own scheduler
+    // to control how the index build is parallelized (see S2Executor).  The
+    // executor is not owned and must outlive the index.
+    //
+    // Defaults to nullptr, which means S2Executor::Default() is used.
+    S2Executor* executor() const { return executor_; }
+    void set_executor(S2Executor* executor) { executor_ = executor; }
+
+    // The maximum wall-clock time (in milliseconds) that a single triggering
+    // query spends applying pending updates, or 0 for no limit.  Normally
+    // the first query after a sequence of mutations applies all pending
+    // updates, which can stall that query for several seconds on very large
+    // indexes.  With a budget set, update work is applied one batch at a
+    // time (see --s2shape_index_tmp_memory_budget) until the budget is
+    // exceeded, and then resumes on subsequent queries, converting one large
+    // stall into bounded increments.  At least one batch is always applied
+    // per triggering query, so application is guaranteed to make progress.
+    //
+    // Between increments the index remains queryable and consistent: it
+    // contains all pending removals and a prefix of the pending additions,
+    // with each added shape either fully indexed or not indexed at all.
+    //
+    // CAVEAT: This mode weakens the usual guarantee that const methods are
+    // thread-safe.  A query may return while the index is still stale, and a
+    // concurrent query could then start applying the next increment while
+    // the first query is reading the index.  Queries are thread-safe again
+    // once is_fresh() returns true; multi-threaded readers should either
+    // call ForceBuild() after mutating (which repeats increments until the
+    // index is fresh) or synchronize queries externally until then.
+    //
+    // Defaults to 0 (each triggering query applies all pending updates).
+    int max_update_milliseconds() const { return max_update_milliseconds_; }
+    void set_max_update_milliseconds(int max_update_milliseconds);
+
    private:
     int max_edges_per_cell_;
+    int num_index_threads_ = 1;
+    bool use_arena_ = false;
+    SegmentAllocator segment_allocator_;
+    S2Executor* executor_ = nullptr;
+    int max_update_milliseconds_ = 0;
   };
 
   // Creates a MutableS2ShapeIndex that uses the default option settings.
@@ -251,6 +359,12 @@ class MutableS2ShapeIndex final : public S2ShapeIndex {
   // has been removed from the index.
   const S2Shape* shape(int id) const override { return shapes_[id].get(); }
 
+  // Returns the total number of edges and points in all indexed shapes.
+  // This count is maintained incrementally as shapes are added and removed,
+  // so it takes constant time (unlike the base class implementation, which
+  // is linear in the number of shapes).
+  int num_edges() const override { return num_edges_; }
+
   // Minimizes memory usage by requesting that any data structures that can be
   // rebuilt should be discarded.  This method invalidates all iterators.
   //
@@ -277,6 +391,11 @@ class MutableS2ShapeIndex final : public S2ShapeIndex {
   // The encoded form also has the advantage of being a contiguous block of
   // memory.
   //
+  // If Options::num_index_threads() is greater than 1 then the index cells
+  // are encoded in parallel using that many threads (via the executor
+  // configured in the options, if any).  The output is byte-for-byte
+  // identical to the single-threaded encoding.
+  //
   // REQUIRES: "encoder" uses the default constructor, so that its buffer
   //           can be enlarged as necessary by calling Ensure(int).
   void Encode(Encoder* encoder) const override;
@@ -372,6 +491,24 @@ class MutableS2ShapeIndex final : public S2ShapeIndex {
   // continue to be added even once the specified limit has been reached.
   int Add(std::unique_ptr<S2Shape> shape);
 
+  // Like Add() above, but takes ownership of every shape in "shapes" (in
+  // order) and reserves all of the required space up front.  Returns the id
+  // assigned to the first shape; the remaining shapes receive consecutive
+  // ids.  This is the preferred way to bulk-load an index when the shapes
+  // are already in hand, since it performs one reservation and one memory
+  // tracking update rather than one per shape.  Note that the pending
+  // additions are applied as a single combined update in any case (split
+  // into batches internally only to limit temporary memory, based on exact
+  // edge counts of the pending shapes); call ForceBuild() to apply them
+  // eagerly.
+  int Add(absl::Span<std::unique_ptr<S2Shape>> shapes);
+
+  // Advises the index that at least "num_shapes" further shapes will be
+  // added, reserving space for them up front.  This is useful for loaders
+  // that receive shapes one at a time but know the total in advance.  Like
+  // Add(), this method is not affected by S2MemoryTracker.
+  void Reserve(int num_shapes);
+
   // Removes the given shape from the index and return ownership to the caller.
   // Invalidates all iterators and their associated data.
   std::unique_ptr<S2Shape> Release(int shape_id);
@@ -424,22 +561,94 @@ class MutableS2ShapeIndex final : public S2ShapeIndex {
   // MaybeApplyUpdates).
   bool is_fresh() const;
 
+  // An immutable view of the index contents at the time it was created; see
+  // GetSnapshot() below.
+  class Snapshot;
+
+  // Returns an immutable snapshot of the current index contents.  The
+  // snapshot implements the full S2ShapeIndex interface, so it can be used
+  // with any S2 query class, and it remains valid while shapes are
+  // subsequently added to or released from this index: index cells that a
+  // snapshot may still reference are retired rather than deleted, and are
+  // freed only once the last snapshot using them has been destroyed.  This
+  // lets serving threads keep querying a snapshot while another thread
+  // applies updates, without copying the index and without readers ever
+  // blocking behind an update.
+  //
+  // Any pending updates are applied before the snapshot is taken.  Creating
+  // a snapshot is cheap relative to copying the index: only the shape and
+  // cell pointers are copied, not the cell contents or edges.
+  //
+  // CAVEATS:
+  //  - The shapes themselves are not copied.  The index must outlive its
+  //    snapshots, and if a shape is removed with Release() (or Clear()), the
+  //    caller must keep that shape alive for as long as any snapshot taken
+  //    before the removal is in use.
+  //  - Like Add() and Release(), this method must not be called concurrently
+  //    with any other method of this index.
+  std::unique_ptr<Snapshot> GetSnapshot();
+
+  // Holds the dense replacement structures built by PrepareCompaction()
+  // until they are installed by ApplyCompaction(); see below.
+  class Compaction;
+
+  // Long-lived indexes that undergo many Add()/Release() cycles become
+  // fragmented: released shape ids leave null entries in the shape vector,
+  // and cell structures retain stale capacity.  Compaction rewrites the
+  // index into dense storage: the surviving shapes are renumbered with
+  // consecutive ids starting at zero, and all cell structures are rebuilt
+  // at exactly the required size.
+  //
+  // Compaction is split into two phases so that the expensive part can run
+  // in the background while the index continues to serve reads:
+  //
+  //  1. PrepareCompaction() builds the dense replacement structures.  Only
+  //     immutable shape geometry is read, so this may run on a background
+  //     thread while other threads query the index (or snapshots of it).
+  //     Like ForceBuild() it may not be called concurrently with Add(),
+  //     Release(), Clear(), or other writer methods.
+  //
+  //  2. ApplyCompaction() installs the prepared structures and returns a
+  //     vector mapping each new shape id to the id that shape had before
+  //     compaction.  No geometry is reprocessed, so the writer is blocked
+  //     only for the pointer swaps.  Cells of the old index that are still
+  //     referenced by outstanding snapshots are retired rather than
+  //     deleted, exactly as for Release(), so snapshots taken before the
+  //     compaction remain valid (they continue to observe the old shape
+  //     ids).  The shape objects themselves are never copied or moved in
+  //     memory.
+  //
+  // REQUIRES: The index is not mutated between the two calls.
+  //
+  // Example usage:
+  //
+  //   auto snapshot = index.GetSnapshot();    // Readers use the snapshot.
+  //   auto compaction = std::async(std::launch::async, [&] {
+  //     return index.PrepareCompaction();
+  //   }).get();                               // (Or any background thread.)
+  //   std::vector<int> old_ids = index.ApplyCompaction(std::move(compaction));
+  std::unique_ptr<Compaction> PrepareCompaction();
+  std::vector<int> ApplyCompaction(std::unique_ptr<Compaction> compaction);
+
  protected:
   std::unique_ptr<IteratorBase> NewIterator(InitialPosition pos) const override;
 
  private:
   friend class EncodedS2ShapeIndex;
+  friend class FrozenS2ShapeIndex;
   friend class Iterator;
   friend class MutableS2ShapeIndexTest;
   friend class S2Stats;
 
   class BatchGenerator;
+  class CellArena;
   class EdgeAllocator;
   class InteriorTracker;
   struct BatchDescriptor;
   struct ClippedEdge;
   struct FaceEdge;
   struct RemovedShape;
+  struct SnapshotState;
 
   using ShapeEdgeId = s2shapeutil::ShapeEdgeId;
   using ShapeIdSet = std::vector<int>;
@@ -449,11 +658,17 @@ class MutableS2ShapeIndex final : public S2ShapeIndex {
   static constexpr unsigned char kCurrentEncodingVersionNumber = 0;
 
   // Internal methods are documented with their definitions.
+  S2ShapeIndexCell* NewIndexCell();
+  void DeleteIndexCell(S2ShapeIndexCell* cell);
+  void ReleaseIndexCell(S2ShapeIndexCell* cell);
+  static void DestroyIndexCell(S2ShapeIndexCell* cell, const CellArena* arena);
+  void InitClippedEdges(S2ClippedShape* clipped, int32 shape_id,
+                        int32 num_edges);
   bool is_shape_being_removed(int shape_id) const;
   void MarkIndexStale();
   void MaybeApplyUpdates() const;
   void ApplyUpdatesThreadSafe();
-  void ApplyUpdatesInternal();
+  bool ApplyUpdatesInternal();
   std::vector<BatchDescriptor> GetUpdateBatches() const;
   void ReserveSpace(const BatchDescriptor& batch,
                     std::vector<FaceEdge> all_edges[6]);
@@ -466,7 +681,11 @@ class MutableS2ShapeIndex final : public S2ShapeIndex {
   void FinishPartialShape(int shape_id);
   void AddFaceEdge(FaceEdge* edge, std::vector<FaceEdge> all_edges[6]) const;
   void UpdateFaceEdges(int face, const std::vector<FaceEdge>& face_edges,
-                       InteriorTracker* tracker);
+                       InteriorTracker* tracker, bool disjoint_from_index);
+  void UpdateFaceEdgesParallel(const BatchDescriptor& batch,
+                               const std::vector<FaceEdge> all_edges[6]);
+  void EncodeCellsParallel(int num_threads, std::vector<S2CellId>* cell_ids,
+                           Encoder* encoder) const;
   S2CellId ShrinkToFit(const S2PaddedCell& pcell, const R2Rect& bound) const;
   void SkipCellRange(S2CellId begin, S2CellId end, InteriorTracker* tracker,
                      EdgeAllocator* alloc, bool disjoint_from_index);
@@ -505,6 +724,10 @@ class MutableS2ShapeIndex final : public S2ShapeIndex {
   // replaced by nullptr pointers.
   std::vector<std::unique_ptr<S2Shape>> shapes_;
 
+  // The total number of edges and points in all shapes in shapes_, updated
+  // by Add(), Release(), and ReleaseAll().
+  int num_edges_ = 0;
+
   // A map from S2CellId to the set of clipped shapes that intersect that
   // cell.  The cell ids cover a set of non-overlapping regions on the
   // sphere.  Note that this field is updated lazily (see below).  Const
@@ -512,6 +735,23 @@ class MutableS2ShapeIndex final : public S2ShapeIndex {
   // (The easiest way to achieve this is simply to use an Iterator.)
   CellMap cell_map_;
 
+  // Set to true while UpdateFaceEdgesParallel() is building several face
+  // subtrees concurrently, in which case insertions into cell_map_ must be
+  // serialized using cells_lock_ (see MakeIndexCell).
+  bool update_threads_active_ = false;
+  SpinLock cells_lock_;
+
+  // The arena from which index cells and edge id arrays are allocated when
+  // options().use_arena() is true, and nullptr otherwise.  It is created
+  // lazily by NewIndexCell() and released by Minimize().
+  std::unique_ptr<CellArena> arena_;
+
+  // State shared with any outstanding Snapshots of this index (see
+  // GetSnapshot).  Index cells that are removed while snapshots exist are
+  // retired into this structure rather than deleted; it is nullptr when no
+  // snapshot has been created since the retired cells were last freed.
+  std::shared_ptr<SnapshotState> snapshot_state_;
+
   // The options supplied for this index.
   Options options_;
 
@@ -685,6 +925,151 @@ class MutableS2ShapeIndex::BatchGenerator {
   std::vector<BatchDescriptor> batches_;  // The completed batches so far.
 };
 
+// The dense replacement structures built by PrepareCompaction().  This class
+// is opaque to callers; it exists only to be passed to ApplyCompaction().
+class MutableS2ShapeIndex::Compaction {
+ private:
+  friend class MutableS2ShapeIndex;
+  Compaction() = default;
+
+  // A replacement index containing non-owning wrappers of the surviving
+  // shapes, with consecutive shape ids.  The wrappers are replaced by the
+  // real shapes when the compaction is applied.
+  MutableS2ShapeIndex index_;
+
+  // Maps each new shape id to the id the shape had before compaction.
+  std::vector<int> old_shape_ids_;
+
+  // The shape pointers at the time PrepareCompaction() was called, used to
+  // verify that the index was not mutated before ApplyCompaction().
+  std::vector<const S2Shape*> expected_shapes_;
+};
+
+// A Snapshot is an immutable view of a MutableS2ShapeIndex, created by
+// calling GetSnapshot().  Its cell contents are shared with the index (and
+// with other snapshots) rather than copied; see GetSnapshot() for the
+// ownership rules.  Snapshots are thread-compatible: since every method is
+// const, a snapshot may be shared freely among query threads.
+class MutableS2ShapeIndex::Snapshot final : public S2ShapeIndex {
+ public:
+  ~Snapshot() override;
+
+  // The options of the index the snapshot was taken from.
+  const Options& options() const { return options_; }
+
+  // The number of index cells in this snapshot.
+  int num_cells() const { return static_cast<int>(cell_ids_.size()); }
+
+  // S2ShapeIndex interface:
+  int num_shape_ids() const override {
+    return static_cast<int>(shapes_.size());
+  }
+  const S2Shape* shape(int id) const override { return shapes_[id]; }
+
+  // Stores an encoded representation of the snapshot into the given encoder.
+  // The encoding is identical to that of MutableS2ShapeIndex.
+  void Encode(Encoder* encoder) const override;
+
+  size_t SpaceUsed() const override;
+
+  // Snapshots have no data structures that can be rebuilt on demand, so this
+  // method does nothing.
+  void Minimize() override {}
+
+  class Iterator final : public IteratorBase {
+   public:
+    // Default constructor; must be followed by a call to Init().
+    Iterator() = default;
+
+    // Constructs an iterator positioned as specified.
+    explicit Iterator(const Snapshot* snapshot,
+                      InitialPosition pos = UNPOSITIONED) {
+      Init(snapshot, pos);
+    }
+
+    // Initializes an iterator for the given Snapshot.
+    void Init(const Snapshot* snapshot, InitialPosition pos = UNPOSITIONED) {
+      snapshot_ = snapshot;
+      num_cells_ = snapshot->num_cells();
+      cell_pos_ = (pos == BEGIN) ? 0 : num_cells_;
+    }
+
+    S2CellId id() const override {
+      if (done()) return S2CellId::Sentinel();
+      return snapshot_->cell_ids_[cell_pos_];
+    }
+
+    bool done() const override { return cell_pos_ == num_cells_; }
+
+    const S2ShapeIndexCell& cell() const override {
+      ABSL_DCHECK(!done());
+      return *snapshot_->cells_[cell_pos_];
+    }
+
+    // S2CellIterator API:
+    void Begin() override { cell_pos_ = 0; }
+    void Finish() override { cell_pos_ = num_cells_; }
+    void Next() override {
+      ABSL_DCHECK(!done());
+      ++cell_pos_;
+    }
+    bool Prev() override {
+      if (cell_pos_ == 0) return false;
+      --cell_pos_;
+      return true;
+    }
+    void Seek(S2CellId target) override;
+
+    bool Locate(const S2Point& target) override {
+      return LocateImpl(*this, target);
+    }
+
+    S2CellRelation Locate(S2CellId target) override {
+      return LocateImpl(*this, target);
+    }
+
+    std::unique_ptr<IteratorBase> Clone() const override {
+      return std::make_unique<Iterator>(*this);
+    }
+
+   private:
+    const Snapshot* snapshot_ = nullptr;
+    int32 cell_pos_ = 0;  // Current position in the vector of index cells.
+    int32 num_cells_ = 0;
+  };
+
+ protected:
+  std::unique_ptr<IteratorBase> NewIterator(InitialPosition pos) const
+      override {
+    return std::make_unique<Iterator>(this, pos);
+  }
+
+ private:
+  friend class MutableS2ShapeIndex;
+
+  Snapshot() = default;
+
+  // The options of the index the snapshot was taken from.
+  Options options_;
+
+  // The shapes in the index at the time the snapshot was taken, accessed by
+  // their shape id.  The shapes are owned by the index (or, once removed, by
+  // whoever called Release); see GetSnapshot() for the lifetime rules.
+  std::vector<const S2Shape*> shapes_;
+
+  // The ids and contents of all index cells at the time the snapshot was
+  // taken, in increasing id order.  The cells are kept alive by state_ even
+  // after they are removed from the index.
+  std::vector<S2CellId> cell_ids_;
+  std::vector<const S2ShapeIndexCell*> cells_;
+
+  // Keeps retired index cells alive for as long as this snapshot exists.
+  std::shared_ptr<SnapshotState> state_;
+
+  Snapshot(const Snapshot&) = delete;
+  void operator=(const Snapshot&) = delete;
+};
+
 inline MutableS2ShapeIndex::Iterator::Iterator() : index_(nullptr) {
 }
 
@@ -734,6 +1119,28 @@ inline bool MutableS2ShapeIndex::Iterator::Prev() {
 }
 
 inline void MutableS2ShapeIndex::Iterator::Seek(S2CellId target) {
+  // Query patterns such as S2CellIteratorJoin perform long runs of seeks
+  // that each move forward by only a few cells.  Rather than searching the
+  // entire b-tree every time, scan forward from the current position for a
+  // bounded number of steps before falling back to a full search.
+  if (iter_ == end_) {
+    iter_ = index_->cell_map_.lower_bound(target);
+    return;
+  }
+  if (target <= iter_->first) {
+    // The current position already satisfies the seek unless the target is
+    // at or before the previous cell.
+    if (iter_ == index_->cell_map_.begin()) return;
+    auto prev = iter_;
+    if ((--prev)->first < target) return;
+    iter_ = index_->cell_map_.lower_bound(target);
+    return;
+  }
+  constexpr int kMaxLinearSteps = 16;
+  for (int i = 0; i < kMaxLinearSteps; ++i) {
+    ++iter_;
+    if (iter_ == end_ || target <= iter_->first) return;
+  }
   iter_ = index_->cell_map_.lower_bound(target);
 }
 
@@ -743,7 +1150,11 @@ MutableS2ShapeIndex::NewIterator(InitialPosition pos) const {
 }
 
 inline void MutableS2ShapeIndex::ForceBuild() const {
-  MaybeApplyUpdates();
+  // With Options::max_update_milliseconds() set, each triggering call may
+  // apply only part of the pending work, so repeat until the index is fresh.
+  do {
+    MaybeApplyUpdates();
+  } while (index_status_.load(std::memory_order_acquire) != FRESH);
 }
 
 inline bool MutableS2ShapeIndex::is_fresh() const {
@@ -19,6 +19,7 @@
 
 #include <cmath>
 #include <cstddef>
+#include <cstring>
 
 #include <algorithm>
 #include <memory>
@@ -30,11 +31,14 @@
 
 #include <gtest/gtest.h>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/flags/flag.h"
 #include "absl/flags/reflection.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "absl/types/span.h"
 
 #include "s2/base/commandlineflags.h"
 #include "s2/base/commandlineflags_declare.h"
@@ -52,6 +56,9 @@
 #include "s2/s2edge_vector_shape.h"
 #include "s2/s2error.h"
 #include "s2/s2fractal.h"
+#include "s2/s2latlng.h"
+#include "s2/s2latlng_rect.h"
+#include "s2/s2latlng_rect_bounder.h"
 #include "s2/s2lax_polygon_shape.h"
 #include "s2/s2lax_polyline_shape.h"
 #include "s2/s2loop.h"
@@ -450,6 +457,41 @@ TEST_F(MutableS2ShapeIndexTest, NoEdges) {
   TestEncodeDecode();
 }
 
+TEST_F(MutableS2ShapeIndexTest, IteratorSeekPatterns) {
+  // Seek() scans forward from the current iterator position before falling
+  // back to a full search.  Verify that seeks from arbitrary iterator states
+  // (near-monotonic runs, backward jumps, random jumps) agree with a seek on
+  // a freshly positioned iterator.
+  index_.Add(make_unique<S2Loop::OwningShape>(S2Loop::MakeRegularLoop(
+      S2Point(1, 2, 3).Normalize(), S1Angle::Degrees(5), 500)));
+  vector<S2CellId> ids;
+  for (MutableS2ShapeIndex::Iterator it(&index_, S2ShapeIndex::BEGIN);
+       !it.done(); it.Next()) {
+    ids.push_back(it.id());
+  }
+  ASSERT_GT(ids.size(), 100);
+  S2Testing::Random* rnd = &S2Testing::rnd;
+  MutableS2ShapeIndex::Iterator it(&index_);
+  for (int iter = 0; iter < 1000; ++iter) {
+    // Mostly advance by a few cells, with occasional random jumps.
+    S2CellId target;
+    if (rnd->OneIn(10)) {
+      target = ids[rnd->Uniform(ids.size())];
+    } else if (!it.done()) {
+      S2CellId pos = it.id();
+      target = pos.advance(rnd->Uniform(16));
+    } else {
+      target = ids[0];
+    }
+    if (rnd->OneIn(3)) target = target.range_min();
+    it.Seek(target);
+    MutableS2ShapeIndex::Iterator expected(&index_);
+    expected.Seek(target);
+    EXPECT_EQ(expected.done(), it.done());
+    if (!it.done()) EXPECT_EQ(expected.id(), it.id());
+  }
+}
+
 TEST_F(MutableS2ShapeIndexTest, OneEdge) {
   EXPECT_EQ(0, index_.Add(make_unique<S2EdgeVectorShape>(S2Point(1, 0, 0),
                                                          S2Point(0, 1, 0))));
@@ -488,6 +530,229 @@ TEST_F(MutableS2ShapeIndexTest, LoopsSpanningThreeFaces) {
   TestEncodeDecode();
 }
 
+TEST_F(MutableS2ShapeIndexTest, ParallelBuildMatchesSerialBuild) {
+  // Verifies that a multi-threaded initial build (see
+  // Options::set_num_index_threads) produces exactly the same index as the
+  // single-threaded code path.
+  MutableS2ShapeIndex::Options options;
+  options.set_num_index_threads(4);
+  index_.Init(options);
+  S2Polygon polygon;
+  const int kNumEdges = 100;  // Validation is quadratic
+  // Use loops centered around the cube vertex at the start of the Hilbert
+  // curve, so that several face subtrees have both edges and interior state.
+  S2Testing::ConcentricLoopsPolygon(S2Point(1, -1, -1).Normalize(), 3,
+                                    kNumEdges, &polygon);
+  vector<unique_ptr<S2Loop>> loops = polygon.Release();
+  MutableS2ShapeIndex serial_index;
+  for (const auto& loop : loops) {
+    index_.Add(make_unique<S2Loop::Shape>(&*loop));
+    serial_index.Add(make_unique<S2Loop::Shape>(&*loop));
+  }
+  QuadraticValidate();  // Forces the parallel build and validates the result.
+  s2testing::ExpectEqual(index_, serial_index);
+}
+
+TEST_F(MutableS2ShapeIndexTest, ParallelEncodeMatchesSerialEncode) {
+  // Verifies that a multi-threaded Encode() produces byte-for-byte identical
+  // output to the single-threaded code path.
+  MutableS2ShapeIndex::Options options;
+  options.set_num_index_threads(4);
+  index_.Init(options);
+  S2Polygon polygon;
+  S2Testing::ConcentricLoopsPolygon(S2Point(1, -1, -1).Normalize(), 5,
+                                    200, &polygon);
+  vector<unique_ptr<S2Loop>> loops = polygon.Release();
+  MutableS2ShapeIndex serial_index;
+  for (const auto& loop : loops) {
+    index_.Add(make_unique<S2Loop::Shape>(&*loop));
+    serial_index.Add(make_unique<S2Loop::Shape>(&*loop));
+  }
+  Encoder parallel_encoder, serial_encoder;
+  index_.Encode(&parallel_encoder);
+  serial_index.Encode(&serial_encoder);
+  ASSERT_EQ(serial_encoder.length(), parallel_encoder.length());
+  EXPECT_EQ(0, memcmp(serial_encoder.base(), parallel_encoder.base(),
+                      serial_encoder.length()));
+
+  // The parallel encoding must also remain decodable.
+  Decoder decoder(parallel_encoder.base(), parallel_encoder.length());
+  MutableS2ShapeIndex decoded_index;
+  ASSERT_TRUE(decoded_index.Init(
+      &decoder, s2shapeutil::WrappedShapeFactory(&index_)));
+  s2testing::ExpectEqual(index_, decoded_index);
+}
+
+TEST_F(MutableS2ShapeIndexTest, SnapshotRemainsValidAcrossUpdates) {
+  // Build an index, take a snapshot, then mutate the index and verify that
+  // the snapshot still reflects the original contents.
+  S2Polygon polygon;
+  S2Testing::ConcentricLoopsPolygon(S2Point(1, 0, 0), 2, 100, &polygon);
+  vector<unique_ptr<S2Loop>> loops = polygon.Release();
+  MutableS2ShapeIndex expected;
+  for (const auto& loop : loops) {
+    index_.Add(make_unique<S2Loop::Shape>(&*loop));
+    expected.Add(make_unique<S2Loop::Shape>(&*loop));
+  }
+  auto snapshot = index_.GetSnapshot();
+  s2testing::ExpectEqual(*snapshot, expected);
+
+  // Removing a shape and adding a new one triggers an incremental update
+  // that absorbs (and would otherwise delete) some existing index cells.
+  auto released = index_.Release(0);  // Must outlive the snapshot.
+  index_.Add(make_unique<S2EdgeVectorShape>(S2Point(0, 0, 1),
+                                            S2Point(0, 1, 0)));
+  index_.ForceBuild();
+  s2testing::ExpectEqual(*snapshot, expected);
+
+  // A new snapshot sees the updated contents, while the old one does not.
+  auto snapshot2 = index_.GetSnapshot();
+  s2testing::ExpectEqual(*snapshot2, index_);
+  s2testing::ExpectEqual(*snapshot, expected);
+
+  // Minimize() discards all the index cells, but outstanding snapshots can
+  // still be queried safely.
+  index_.Minimize();
+  s2testing::ExpectEqual(*snapshot, expected);
+}
+
+TEST_F(MutableS2ShapeIndexTest, CompactionProducesDenseEquivalentIndex) {
+  // Add 10 polylines and release every other one, leaving the shape id
+  // space sparse.
+  vector<vector<S2Point>> lines;
+  for (int i = 0; i < 10; ++i) {
+    vector<S2Point> vertices;
+    for (int j = 0; j <= 5; ++j) {
+      vertices.push_back(
+          S2LatLng::FromDegrees(10 * i + 0.1 * j, 20 + 0.1 * j).ToPoint());
+    }
+    lines.push_back(vertices);
+  }
+  for (const auto& line : lines) {
+    index_.Add(make_unique<S2LaxPolylineShape>(line));
+  }
+  vector<unique_ptr<S2Shape>> released;  // Must outlive the snapshot.
+  for (int id = 0; id < 10; id += 2) {
+    released.push_back(index_.Release(id));
+  }
+
+  // Take a snapshot of the fragmented index, then compact.
+  auto snapshot = index_.GetSnapshot();
+  vector<const S2Shape*> survivors;
+  for (int id = 1; id < 10; id += 2) survivors.push_back(index_.shape(id));
+  vector<int> old_ids = index_.ApplyCompaction(index_.PrepareCompaction());
+
+  // The surviving shapes are renumbered densely, without being moved.
+  EXPECT_EQ(old_ids, (vector<int>{1, 3, 5, 7, 9}));
+  ASSERT_EQ(index_.num_shape_ids(), 5);
+  for (int new_id = 0; new_id < 5; ++new_id) {
+    EXPECT_EQ(index_.shape(new_id), survivors[new_id]);
+  }
+  QuadraticValidate();
+
+  // The compacted contents match an index built densely from scratch.
+  MutableS2ShapeIndex expected;
+  for (int old_id : old_ids) {
+    expected.Add(make_unique<S2LaxPolylineShape>(lines[old_id]));
+  }
+  s2testing::ExpectEqual(index_, expected);
+
+  // The snapshot still reflects the pre-compaction state, including the
+  // original shape ids.
+  MutableS2ShapeIndex expected_old;
+  for (const auto& line : lines) {
+    expected_old.Add(make_unique<S2LaxPolylineShape>(line));
+  }
+  vector<unique_ptr<S2Shape>> released_old;
+  for (int id = 0; id < 10; id += 2) {
+    released_old.push_back(expected_old.Release(id));
+  }
+  EXPECT_EQ(snapshot->num_shape_ids(), 10);
+  s2testing::ExpectEqual(*snapshot, expected_old);
+
+  // The compacted index accepts further updates normally.
+  EXPECT_EQ(index_.Add(make_unique<S2LaxPolylineShape>(lines[0])), 5);
+  QuadraticValidate();
+}
+
+TEST_F(MutableS2ShapeIndexTest, ArenaBuildMatchesHeapBuild) {
+  // Verifies that building with arena allocation (see Options::set_use_arena)
+  // produces the same index contents as the default heap allocation, and that
+  // incremental updates work when the index cells live in the arena.
+  MutableS2ShapeIndex::Options options;
+  options.set_use_arena(true);
+  index_.Init(options);
+  S2Polygon polygon;
+  const int kNumEdges = 100;  // Validation is quadratic
+  S2Testing::ConcentricLoopsPolygon(S2Point(1, -1, -1).Normalize(), 3,
+                                    kNumEdges, &polygon);
+  vector<unique_ptr<S2Loop>> loops = polygon.Release();
+  MutableS2ShapeIndex heap_index;
+  for (const auto& loop : loops) {
+    index_.Add(make_unique<S2Loop::Shape>(&*loop));
+    heap_index.Add(make_unique<S2Loop::Shape>(&*loop));
+  }
+  QuadraticValidate();
+  s2testing::ExpectEqual(index_, heap_index);
+
+  // Now remove a shape and add another one, which exercises AbsorbIndexCell
+  // and the arena-aware cell deletion path.
+  index_.Release(0);
+  heap_index.Release(0);
+  index_.Add(make_unique<S2EdgeVectorShape>(S2Point(1, 0, 0),
+                                            S2Point(0, 1, 0)));
+  heap_index.Add(make_unique<S2EdgeVectorShape>(S2Point(1, 0, 0),
+                                                S2Point(0, 1, 0)));
+  QuadraticValidate();
+  s2testing::ExpectEqual(index_, heap_index);
+}
+
+TEST_F(MutableS2ShapeIndexTest, SegmentAllocatorBuild) {
+  // Verifies that the arena requests its blocks through the segment
+  // allocator hooks (see Options::set_segment_allocator), that every block
+  // is freed with its original pointer and size, and that the index contents
+  // are unaffected by the custom allocator.
+  struct Segment {
+    void* ptr;
+    size_t bytes;
+  };
+  vector<Segment> allocated, freed;
+  MutableS2ShapeIndex::Options options;
+  options.set_use_arena(true);
+  options.set_segment_allocator(
+      {[&allocated](size_t bytes) {
+         void* ptr = ::operator new(bytes);
+         allocated.push_back(Segment{ptr, bytes});
+         return ptr;
+       },
+       [&freed](void* ptr, size_t bytes) {
+         freed.push_back(Segment{ptr, bytes});
+         ::operator delete(ptr);
+       }});
+  S2Polygon polygon;
+  S2Testing::ConcentricLoopsPolygon(S2Point(1, -1, -1).Normalize(), 3,
+                                    100, &polygon);
+  vector<unique_ptr<S2Loop>> loops = polygon.Release();
+  MutableS2ShapeIndex heap_index;
+  {
+    MutableS2ShapeIndex index(options);
+    for (const auto& loop : loops) {
+      index.Add(make_unique<S2Loop::Shape>(&*loop));
+      heap_index.Add(make_unique<S2Loop::Shape>(&*loop));
+    }
+    index.ForceBuild();
+    s2testing::ExpectEqual(index, heap_index);
+    EXPECT_GT(allocated.size(), 0);
+    EXPECT_TRUE(freed.empty());
+  }
+  // Destroying the index frees every block exactly once.
+  ASSERT_EQ(allocated.size(), freed.size());
+  for (size_t i = 0; i < allocated.size(); ++i) {
+    EXPECT_EQ(allocated[i].ptr, freed[i].ptr);
+    EXPECT_EQ(allocated[i].bytes, freed[i].bytes);
+  }
+}
+
 TEST_F(MutableS2ShapeIndexTest, ManyIdenticalEdges) {
   const int kNumEdges = 100;  // Validation is quadratic
   S2Point a = S2Point(0.99, 0.99, 1).Normalize();
@@ -548,6 +813,32 @@ TEST_F(MutableS2ShapeIndexTest, ManyTinyEdges) {
   EXPECT_TRUE(it.done());
 }
 
+TEST_F(MutableS2ShapeIndexTest, PolylineEdgeRuns) {
+  // Consecutive edges of a polyline chain usually intersect the same cell,
+  // in which case the clipped shape stores them as a single contiguous run
+  // rather than an explicit edge array.  Verify that the accessors and the
+  // encoding behave identically for an index dominated by such runs.
+  vector<S2Point> vertices;
+  for (int i = 0; i <= 400; ++i) {
+    vertices.push_back(S2LatLng::FromDegrees(0.02 * i, 0.03 * i).ToPoint());
+  }
+  index_.Add(make_unique<S2LaxPolylineShape>(vertices));
+  QuadraticValidate();
+  TestEncodeDecode();
+  for (MutableS2ShapeIndex::Iterator it(&index_, S2ShapeIndex::BEGIN);
+       !it.done(); it.Next()) {
+    const S2ClippedShape& clipped = it.cell().clipped(0);
+    ASSERT_GT(clipped.num_edges(), 0);
+    for (int i = 0; i < clipped.num_edges(); ++i) {
+      if (i > 0) EXPECT_LT(clipped.edge(i - 1), clipped.edge(i));
+      EXPECT_TRUE(clipped.ContainsEdge(clipped.edge(i)));
+    }
+    EXPECT_FALSE(clipped.ContainsEdge(clipped.edge(0) - 1));
+    int last_edge = clipped.edge(clipped.num_edges() - 1);
+    EXPECT_FALSE(clipped.ContainsEdge(last_edge + 1));
+  }
+}
+
 TEST_F(MutableS2ShapeIndexTest, SimpleUpdates) {
   // Add 5 loops one at a time, then release them one at a time,
   // validating the index at each step.
@@ -565,6 +856,77 @@ TEST_F(MutableS2ShapeIndexTest, SimpleUpdates) {
   }
 }
 
+// Returns a rectangle bound containing every edge of "shape".
+static S2LatLngRect MakeShapeBound(const S2Shape& shape) {
+  S2LatLngRectBounder bounder;
+  for (int e = 0; e < shape.num_edges(); ++e) {
+    bounder.AddPoint(shape.edge(e).v0);
+    bounder.AddPoint(shape.edge(e).v1);
+  }
+  return bounder.GetBound();
+}
+
+TEST_F(MutableS2ShapeIndexTest, EditLeavesDisjointCellsUntouched) {
+  // Incremental updates are applied at cell granularity: editing one shape
+  // must not modify the contents of any index cell that is disjoint from it.
+  for (int i = 0; i < 100; ++i) {
+    vector<S2Point> vertices;
+    double lat = -60 + 12 * (i % 10), lng = -150 + 30 * (i / 10);
+    for (int j = 0; j <= 10; ++j) {
+      vertices.push_back(
+          S2LatLng::FromDegrees(lat + 0.01 * j, lng + 0.01 * j).ToPoint());
+    }
+    index_.Add(make_unique<S2LaxPolylineShape>(vertices));
+  }
+  // Snapshots the contents of every index cell as a string.
+  auto Snapshot = [this]() {
+    absl::flat_hash_map<S2CellId, string> contents;
+    for (MutableS2ShapeIndex::Iterator it(&index_, S2ShapeIndex::BEGIN);
+         !it.done(); it.Next()) {
+      string& cell = contents[it.id()];
+      for (int s = 0; s < it.cell().num_clipped(); ++s) {
+        const S2ClippedShape& clipped = it.cell().clipped(s);
+        absl::StrAppend(&cell, clipped.shape_id(), ":",
+                        clipped.contains_center() ? "c" : "");
+        for (int e = 0; e < clipped.num_edges(); ++e) {
+          absl::StrAppend(&cell, clipped.edge(e), ",");
+        }
+        absl::StrAppend(&cell, ";");
+      }
+    }
+    return contents;
+  };
+  auto before = Snapshot();
+  S2LatLngRect shape_bound = MakeShapeBound(*index_.shape(0));
+  index_.Add(index_.Release(0));
+  auto after = Snapshot();
+  for (const auto& entry : after) {
+    if (S2Cell(entry.first).GetRectBound().Intersects(shape_bound)) continue;
+    auto it = before.find(entry.first);
+    ASSERT_TRUE(it != before.end()) << entry.first;
+    EXPECT_EQ(it->second, entry.second) << entry.first;
+  }
+}
+
+TEST_F(MutableS2ShapeIndexTest, BulkAdd) {
+  // Adding a span of shapes must be equivalent to adding them one at a time.
+  S2Polygon polygon;
+  S2Testing::ConcentricLoopsPolygon(S2Point(1, 0, 0), 5, 20, &polygon);
+  vector<unique_ptr<S2Shape>> shapes;
+  for (int i = 0; i < polygon.num_loops(); ++i) {
+    shapes.push_back(make_unique<S2Loop::Shape>(polygon.loop(i)));
+  }
+  index_.Reserve(shapes.size());
+  EXPECT_EQ(index_.Add(absl::MakeSpan(shapes)), 0);
+  EXPECT_EQ(index_.num_shape_ids(), polygon.num_loops());
+  EXPECT_EQ(index_.num_edges(), polygon.num_vertices());
+  QuadraticValidate();
+
+  // Adding an empty span is a no-op that returns the next shape id.
+  EXPECT_EQ(index_.Add(absl::Span<unique_ptr<S2Shape>>()),
+            index_.num_shape_ids());
+}
+
 TEST_F(MutableS2ShapeIndexTest, RandomUpdates) {
   // Set the temporary memory budget such that at least one shape needs to be
   // split into multiple update batches (namely, the "5 concentric rings"
@@ -639,6 +1001,57 @@ TEST_F(MutableS2ShapeIndexTest, RandomUpdates) {
   }
 }
 
+TEST_F(MutableS2ShapeIndexTest, BoundedLatencyUpdates) {
+  // With Options::max_update_milliseconds() set, a triggering query may apply
+  // only part of the pending work and leave the rest for later triggers.  Use
+  // a small temporary memory budget so that the work is split into many
+  // batches, giving the deadline code a chance to stop between them.  Whether
+  // any individual trigger actually runs out of budget depends on machine
+  // speed, so this test only verifies the invariants that hold either way:
+  // every increment leaves a queryable index, progress is always made, and
+  // the final index is identical to one built without a deadline.
+  absl::FlagSaver fs;
+  absl::SetFlag(&FLAGS_s2shape_index_tmp_memory_budget, 10000);
+
+  MutableS2ShapeIndex::Options options;
+  options.set_max_update_milliseconds(1);
+  index_.Init(options);
+  S2Polygon polygon;
+  S2Testing::ConcentricLoopsPolygon(S2Point(1, -1, -1).Normalize(), 20, 50,
+                                    &polygon);
+  vector<unique_ptr<S2Loop>> loops = polygon.Release();
+  MutableS2ShapeIndex no_deadline_index;
+  for (const auto& loop : loops) {
+    index_.Add(make_unique<S2Loop::Shape>(&*loop));
+    no_deadline_index.Add(make_unique<S2Loop::Shape>(&*loop));
+  }
+  // Each trigger applies at least one batch, so this loop must terminate.
+  int num_triggers = 0;
+  while (!index_.is_fresh()) {
+    ASSERT_LT(num_triggers++, 1000);
+    int num_cells = 0;
+    for (MutableS2ShapeIndex::Iterator it(&index_, S2ShapeIndex::BEGIN);
+         !it.done(); it.Next()) {
+      ++num_cells;
+    }
+    // The partially updated index is consistent and queryable; with only
+    // additions pending it can never shrink below the already-applied state.
+    EXPECT_GE(num_cells, 0);
+    EXPECT_EQ(index_.num_shape_ids(), static_cast<int>(loops.size()));
+  }
+  s2testing::ExpectEqual(index_, no_deadline_index);
+  QuadraticValidate();
+
+  // ForceBuild() must loop until all increments have been applied.
+  MutableS2ShapeIndex force_index(options);
+  for (const auto& loop : loops) {
+    force_index.Add(make_unique<S2Loop::Shape>(&*loop));
+  }
+  force_index.ForceBuild();
+  EXPECT_TRUE(force_index.is_fresh());
+  s2testing::ExpectEqual(force_index, no_deadline_index);
+}
+
 // A test that repeatedly updates "index_" in one thread and attempts to
 // concurrently read the index_ from several other threads.  When all threads
 // have finished reading, the first thread makes another update.
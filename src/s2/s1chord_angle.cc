@@ -20,10 +20,14 @@
 #include <algorithm>
 #include <cfloat>
 #include <cmath>
+#include <cstddef>
 #include <ostream>
 
 #include "absl/log/absl_check.h"
+#include "absl/types/span.h"
 #include "s2/s1angle.h"
+#include "s2/s2point.h"
+#include "s2/s2pointutil.h"
 
 using std::max;
 using std::min;
@@ -50,6 +54,66 @@ S1ChordAngle::S1ChordAngle(S1Angle angle) {
   ABSL_DCHECK(is_valid());
 }
 
+void S1ChordAngle::Batch(absl::Span<const S2Point> a,
+                         absl::Span<const S2Point> b,
+                         absl::Span<S1ChordAngle> result) {
+  ABSL_DCHECK_EQ(a.size(), b.size());
+  ABSL_DCHECK_EQ(a.size(), result.size());
+  // This loop is kept free of branches and function calls so that the
+  // compiler can vectorize the squared-distance computation; the DCHECKs of
+  // the two-point constructor are amortized over the whole batch instead.
+  for (size_t i = 0; i < a.size(); ++i) {
+    double dx = a[i].x() - b[i].x();
+    double dy = a[i].y() - b[i].y();
+    double dz = a[i].z() - b[i].z();
+    result[i].length2_ = min(kMaxLength2, dx * dx + dy * dy + dz * dz);
+  }
+  for (size_t i = 0; i < a.size(); ++i) {
+    ABSL_DCHECK(S2::IsUnitLength(a[i]));
+    ABSL_DCHECK(S2::IsUnitLength(b[i]));
+  }
+}
+
+S1ChordAngle S1ChordAngle::MinBatch(absl::Span<const S1ChordAngle> angles) {
+  // Reducing over the raw squared chord lengths keeps the loop branch-free
+  // (min() compiles to a single instruction on doubles) and also handles the
+  // special values correctly, since all comparisons are defined in terms of
+  // length2_.
+  double min_length2 = Infinity().length2_;
+  for (size_t i = 0; i < angles.size(); ++i) {
+    min_length2 = min(min_length2, angles[i].length2_);
+  }
+  S1ChordAngle result;
+  result.length2_ = min_length2;
+  return result;
+}
+
+int S1ChordAngle::CollectBelow(absl::Span<const S1ChordAngle> angles,
+                               S1ChordAngle limit, absl::Span<int> indices) {
+  ABSL_DCHECK_GE(indices.size(), angles.size());
+  // Branch-free compaction: every candidate index is written unconditionally,
+  // and the output cursor only advances for indices that pass the test.
+  int n = 0;
+  for (size_t i = 0; i < angles.size(); ++i) {
+    indices[n] = static_cast<int>(i);
+    n += (angles[i].length2_ < limit.length2_);
+  }
+  return n;
+}
+
+void S1ChordAngle::Sin2Batch(absl::Span<const S1ChordAngle> angles,
+                             absl::Span<double> result) {
+  ABSL_DCHECK_EQ(angles.size(), result.size());
+  // See sin2() below for the derivation.  As in Batch(), the DCHECKs are
+  // hoisted out of the main loop so that it can vectorize.
+  for (size_t i = 0; i < angles.size(); ++i) {
+    result[i] = angles[i].length2_ * (1 - 0.25 * angles[i].length2_);
+  }
+  for (size_t i = 0; i < angles.size(); ++i) {
+    ABSL_DCHECK(!angles[i].is_special());
+  }
+}
+
 S1Angle S1ChordAngle::ToAngle() const {
   if (is_negative()) return S1Angle::Radians(-1);
   if (is_infinity()) return S1Angle::Infinity();
@@ -26,6 +26,7 @@
 
 #include "s2/base/types.h"
 #include "absl/log/absl_check.h"
+#include "absl/types/span.h"
 #include "s2/_fp_contract_off.h"
 #include "s2/s1angle.h"
 #include "s2/s2point.h"
@@ -130,6 +131,43 @@ class S1ChordAngle {
   // given points.  The points must be unit length.
   constexpr S1ChordAngle(const S2Point& x, const S2Point& y);
 
+  // Computes S1ChordAngle(a[i], b[i]) for every pair of corresponding points
+  // and stores the results in "result".  Equivalent to calling the two-point
+  // constructor in a loop, but written as a batch kernel (see
+  // util/math/vector_batch.h) so that the distance computation vectorizes.
+  //
+  // REQUIRES: a.size() == b.size() == result.size()
+  static void Batch(absl::Span<const S2Point> a, absl::Span<const S2Point> b,
+                    absl::Span<S1ChordAngle> result);
+
+  // Batch kernels over spans of chord angles.  Since S1ChordAngle consists of
+  // a single double, a contiguous span of S1ChordAngles is already a packed
+  // array of squared chord lengths; no separate structure-of-arrays type is
+  // needed.  Like Batch() above, these methods are written branch-free so
+  // that the compiler can vectorize them.
+
+  // Returns the minimum of the given chord angles, or Infinity() if the span
+  // is empty.  Special values (Negative, Infinity) are allowed and compare in
+  // the usual way.
+  static S1ChordAngle MinBatch(absl::Span<const S1ChordAngle> angles);
+
+  // Writes the indices of all elements with angles[i] < limit to the front of
+  // "indices" (in increasing order) and returns how many there were.  This is
+  // intended for culling distance candidates in bulk before any per-candidate
+  // scalar work runs.
+  //
+  // REQUIRES: indices.size() >= angles.size()
+  static int CollectBelow(absl::Span<const S1ChordAngle> angles,
+                          S1ChordAngle limit, absl::Span<int> indices);
+
+  // Computes sin2(angles[i]) for every element and stores the results in
+  // "result".  Equivalent to calling sin2() in a loop.
+  //
+  // REQUIRES: a.size() == result.size()
+  // REQUIRES: !angles[i].is_special() for all i
+  static void Sin2Batch(absl::Span<const S1ChordAngle> angles,
+                        absl::Span<double> result);
+
   // Return the zero chord angle.
   static S1ChordAngle Zero();
 
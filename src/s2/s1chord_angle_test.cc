@@ -17,11 +17,15 @@
 
 #include <cmath>
 
+#include <algorithm>
 #include <cfloat>
+#include <cstddef>
 #include <limits>
 #include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
+#include "absl/types/span.h"
 #include "s2/s1angle.h"
 #include "s2/s2edge_distances.h"
 #include "s2/s2point.h"
@@ -48,6 +52,66 @@ TEST(S1ChordAngle, TwoPointConstructor) {
   }
 }
 
+TEST(S1ChordAngle, BatchMatchesTwoPointConstructor) {
+  std::vector<S2Point> a, b;
+  for (int i = 0; i < 100; ++i) {
+    a.push_back(S2Testing::RandomPoint());
+    b.push_back(S2Testing::RandomPoint());
+  }
+  // Include an antipodal pair so that the clamp to 4.0 is exercised.
+  a.push_back(a[0]);
+  b.push_back(-a[0]);
+  std::vector<S1ChordAngle> batch(a.size());
+  S1ChordAngle::Batch(a, b, absl::MakeSpan(batch));
+  for (size_t i = 0; i < a.size(); ++i) {
+    EXPECT_EQ(S1ChordAngle(a[i], b[i]), batch[i]);
+  }
+}
+
+TEST(S1ChordAngle, MinBatch) {
+  EXPECT_EQ(S1ChordAngle::Infinity(), S1ChordAngle::MinBatch({}));
+  std::vector<S1ChordAngle> angles;
+  S1ChordAngle expected = S1ChordAngle::Infinity();
+  for (int i = 0; i < 100; ++i) {
+    angles.push_back(S1ChordAngle::FromLength2(4 * S2Testing::rnd.RandDouble()));
+    expected = std::min(expected, angles.back());
+  }
+  EXPECT_EQ(expected, S1ChordAngle::MinBatch(angles));
+  // Special values participate in the reduction like any other value.
+  angles.push_back(S1ChordAngle::Negative());
+  EXPECT_EQ(S1ChordAngle::Negative(), S1ChordAngle::MinBatch(angles));
+}
+
+TEST(S1ChordAngle, CollectBelow) {
+  std::vector<S1ChordAngle> angles;
+  for (int i = 0; i < 100; ++i) {
+    angles.push_back(S1ChordAngle::FromLength2(4 * S2Testing::rnd.RandDouble()));
+  }
+  S1ChordAngle limit = S1ChordAngle::Right();
+  std::vector<int> indices(angles.size());
+  int n = S1ChordAngle::CollectBelow(angles, limit, absl::MakeSpan(indices));
+  std::vector<int> expected;
+  for (size_t i = 0; i < angles.size(); ++i) {
+    if (angles[i] < limit) expected.push_back(i);
+  }
+  ASSERT_EQ(static_cast<int>(expected.size()), n);
+  for (int i = 0; i < n; ++i) {
+    EXPECT_EQ(expected[i], indices[i]);
+  }
+}
+
+TEST(S1ChordAngle, Sin2BatchMatchesScalar) {
+  std::vector<S1ChordAngle> angles;
+  for (int i = 0; i < 100; ++i) {
+    angles.push_back(S1ChordAngle::FromLength2(4 * S2Testing::rnd.RandDouble()));
+  }
+  std::vector<double> batch(angles.size());
+  S1ChordAngle::Sin2Batch(angles, absl::MakeSpan(batch));
+  for (size_t i = 0; i < angles.size(); ++i) {
+    EXPECT_EQ(sin2(angles[i]), batch[i]);
+  }
+}
+
 TEST(S1ChordAngle, FromLength2) {
   EXPECT_EQ(0, S1ChordAngle::FromLength2(0).degrees());
   EXPECT_DOUBLE_EQ(60, S1ChordAngle::FromLength2(1).degrees());
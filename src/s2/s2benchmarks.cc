@@ -0,0 +1,211 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Benchmarks for the hot paths of the library, built as the "s2benchmarks"
+// target when -DBUILD_BENCHMARKS=ON is given to CMake.  The datasets are
+// synthetic but representative: fractal coastlines for indexing and queries,
+// overlapping regular polygons for boolean operations, and random caps and
+// point clouds for coverings and coding.
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "s2/encoded_s2point_vector.h"
+#include "s2/mutable_s2shape_index.h"
+#include "s2/s1angle.h"
+#include "s2/s1chord_angle.h"
+#include "s2/s2boolean_operation.h"
+#include "s2/s2builderutil_s2polygon_layer.h"
+#include "s2/s2cap.h"
+#include "s2/s2cell_union.h"
+#include "s2/s2closest_edge_query.h"
+#include "s2/s2edge_crosser.h"
+#include "s2/s2error.h"
+#include "s2/s2fractal.h"
+#include "s2/s2loop.h"
+#include "s2/s2point.h"
+#include "s2/s2polygon.h"
+#include "s2/s2predicates.h"
+#include "s2/s2region_coverer.h"
+#include "s2/s2testing.h"
+#include "s2/util/coding/coder.h"
+
+namespace {
+
+// Returns a fractal loop with approximately the given number of edges.
+std::unique_ptr<S2Loop> MakeFractalLoop(int num_edges) {
+  S2Fractal fractal;
+  fractal.SetLevelForApproxMaxEdges(num_edges);
+  return fractal.MakeLoop(S2Testing::GetRandomFrame(), S1Angle::Degrees(1));
+}
+
+void BM_MutableS2ShapeIndexBuild(benchmark::State& state) {
+  std::unique_ptr<S2Loop> loop = MakeFractalLoop(state.range(0));
+  for (auto _ : state) {
+    MutableS2ShapeIndex index;
+    index.Add(std::make_unique<S2Loop::Shape>(loop.get()));
+    index.ForceBuild();
+  }
+  state.SetItemsProcessed(state.iterations() * loop->num_vertices());
+}
+BENCHMARK(BM_MutableS2ShapeIndexBuild)->Range(1 << 10, 1 << 17);
+
+void BM_LoopGetArea(benchmark::State& state) {
+  std::unique_ptr<S2Loop> loop = MakeFractalLoop(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(loop->GetArea());
+  }
+  state.SetItemsProcessed(state.iterations() * loop->num_vertices());
+}
+BENCHMARK(BM_LoopGetArea)->Range(1 << 10, 1 << 17);
+
+void BM_LoopInitOriginAndBound(benchmark::State& state) {
+  std::unique_ptr<S2Loop> loop = MakeFractalLoop(state.range(0));
+  std::vector<S2Point> vertices(loop->vertices_span().begin(),
+                                loop->vertices_span().end());
+  for (auto _ : state) {
+    // Construction is dominated by the bounding scan (the spatial index is
+    // built lazily and is never triggered here).
+    S2Loop copy(vertices);
+    benchmark::DoNotOptimize(copy.GetRectBound());
+  }
+  state.SetItemsProcessed(state.iterations() * loop->num_vertices());
+}
+BENCHMARK(BM_LoopInitOriginAndBound)->Range(1 << 10, 1 << 17);
+
+void BM_EdgeCrosserLoopScan(benchmark::State& state) {
+  std::unique_ptr<S2Loop> loop = MakeFractalLoop(state.range(0));
+  // A chord spanning the fractal, so that the scan sees real crossings.
+  S2Cap cap(loop->vertex(0), S1Angle::Degrees(2));
+  S2Point a = S2Testing::SamplePoint(cap);
+  S2Point b = S2Testing::SamplePoint(cap);
+  for (auto _ : state) {
+    S2EdgeCrosser crosser(&a, &b, &loop->vertex(0));
+    int num_crossings = 0;
+    for (int i = 1; i <= loop->num_vertices(); ++i) {
+      if (crosser.CrossingSign(&loop->vertex(i)) > 0) ++num_crossings;
+    }
+    benchmark::DoNotOptimize(num_crossings);
+  }
+  state.SetItemsProcessed(state.iterations() * loop->num_vertices());
+}
+BENCHMARK(BM_EdgeCrosserLoopScan)->Range(1 << 10, 1 << 17);
+
+void BM_ClosestEdgeQueryFindClosestEdges(benchmark::State& state) {
+  std::unique_ptr<S2Loop> loop = MakeFractalLoop(state.range(0));
+  MutableS2ShapeIndex index;
+  index.Add(std::make_unique<S2Loop::Shape>(loop.get()));
+  index.ForceBuild();
+
+  // Sample the targets from a cap slightly larger than the fractal so that
+  // both near and far queries are represented.
+  S2Cap cap(loop->vertex(0), S1Angle::Degrees(2));
+  std::vector<S2Point> targets;
+  for (int i = 0; i < 64; ++i) targets.push_back(S2Testing::SamplePoint(cap));
+
+  S2ClosestEdgeQuery query(&index);
+  query.mutable_options()->set_max_results(8);
+  std::vector<S2ClosestEdgeQuery::Result> results;
+  int i = 0;
+  for (auto _ : state) {
+    S2ClosestEdgeQuery::PointTarget target(targets[i++ % targets.size()]);
+    query.FindClosestEdges(&target, &results);
+    benchmark::DoNotOptimize(results);
+  }
+}
+BENCHMARK(BM_ClosestEdgeQueryFindClosestEdges)->Range(1 << 10, 1 << 17);
+
+void BM_BooleanOperationIntersection(benchmark::State& state) {
+  // Two regular polygons whose boundaries cross, so that the intersection
+  // exercises both the crossing enumeration and the output assembly.
+  const int num_vertices = state.range(0);
+  const S1Angle radius = S1Angle::Degrees(1);
+  S2Point center_a = S2Testing::RandomPoint();
+  S2Point center_b =
+      S2Testing::SamplePoint(S2Cap(center_a, 0.5 * radius));
+  S2Polygon a(S2Loop::MakeRegularLoop(center_a, radius, num_vertices));
+  S2Polygon b(S2Loop::MakeRegularLoop(center_b, radius, num_vertices));
+
+  for (auto _ : state) {
+    S2Polygon result;
+    S2BooleanOperation op(
+        S2BooleanOperation::OpType::INTERSECTION,
+        std::make_unique<s2builderutil::S2PolygonLayer>(&result));
+    S2Error error;
+    op.Build(a.index(), b.index(), &error);
+    benchmark::DoNotOptimize(result);
+  }
+}
+BENCHMARK(BM_BooleanOperationIntersection)->Range(1 << 6, 1 << 14);
+
+void BM_RegionCovererGetCovering(benchmark::State& state) {
+  S2RegionCoverer::Options options;
+  options.set_max_cells(state.range(0));
+  S2RegionCoverer coverer(options);
+
+  std::vector<S2Cap> caps;
+  for (int i = 0; i < 64; ++i) {
+    caps.push_back(S2Cap(S2Testing::RandomPoint(), S1Angle::Degrees(1)));
+  }
+  int i = 0;
+  for (auto _ : state) {
+    S2CellUnion covering = coverer.GetCovering(caps[i++ % caps.size()]);
+    benchmark::DoNotOptimize(covering);
+  }
+}
+BENCHMARK(BM_RegionCovererGetCovering)->Arg(8)->Arg(64)->Arg(256);
+
+void BM_EncodedS2PointVectorDecode(benchmark::State& state) {
+  const int num_points = state.range(0);
+  std::vector<S2Point> points;
+  for (int i = 0; i < num_points; ++i) {
+    points.push_back(S2Testing::RandomPoint());
+  }
+  Encoder encoder;
+  s2coding::EncodeS2PointVector(points, s2coding::CodingHint::COMPACT,
+                                &encoder);
+  for (auto _ : state) {
+    Decoder decoder(encoder.base(), encoder.length());
+    s2coding::EncodedS2PointVector encoded;
+    encoded.Init(&decoder);
+    S2Point sum(0, 0, 0);
+    for (int i = 0; i < num_points; ++i) sum += encoded[i];
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * num_points);
+}
+BENCHMARK(BM_EncodedS2PointVectorDecode)->Range(1 << 10, 1 << 16);
+
+void BM_PredicatesSign(benchmark::State& state) {
+  // Random triples almost always take the triage fast path, which is the
+  // distribution seen in practice.
+  std::vector<std::array<S2Point, 3>> triples;
+  for (int i = 0; i < 1024; ++i) {
+    triples.push_back({S2Testing::RandomPoint(), S2Testing::RandomPoint(),
+                       S2Testing::RandomPoint()});
+  }
+  for (auto _ : state) {
+    int total = 0;
+    for (const auto& t : triples) total += s2pred::Sign(t[0], t[1], t[2]);
+    benchmark::DoNotOptimize(total);
+  }
+  state.SetItemsProcessed(state.iterations() * triples.size());
+}
+BENCHMARK(BM_PredicatesSign);
+
+}  // namespace
@@ -91,16 +91,19 @@
 #include "s2/s2builder_layer.h"
 #include "s2/s2builderutil_snap_functions.h"
 #include "s2/s2cell_id.h"
+#include "s2/s2cell_union.h"
 #include "s2/s2contains_point_query.h"
 #include "s2/s2crossing_edge_query.h"
 #include "s2/s2edge_crossings.h"
 #include "s2/s2error.h"
 #include "s2/s2measures.h"
 #include "s2/s2memory_tracker.h"
+#include "s2/s2phase_timer.h"
 #include "s2/s2point.h"
 #include "s2/s2predicates.h"
 #include "s2/s2shape.h"
 #include "s2/s2shape_index.h"
+#include "s2/s2shape_index_region.h"
 #include "s2/s2shape_index_measures.h"
 #include "s2/s2shapeutil_shape_edge.h"
 #include "s2/s2shapeutil_shape_edge_id.h"
@@ -866,7 +869,7 @@ class S2BooleanOperation::Impl {
  public:
   explicit Impl(S2BooleanOperation* op)
       : op_(op), index_crossings_first_region_id_(-1),
-        tracker_(op->options_.memory_tracker()) {
+        tracker_(op->options_.memory_tracker(), "S2BooleanOperation") {
   }
 
   bool Build(S2Error* error);
@@ -960,6 +963,9 @@ class S2BooleanOperation::Impl {
   bool GetChainStarts(int a_region_id, bool invert_a, bool invert_b,
                       bool invert_result, CrossingProcessor* cp,
                       vector<ShapeEdgeId>* chain_starts);
+  bool GetPreparedChainStarts(const PreparedOperand& prepared, bool invert_a,
+                              bool invert_result, const S2ShapeIndex& b_index,
+                              vector<ShapeEdgeId>* chain_starts);
   bool ProcessIncidentEdges(const ShapeEdge& a,
                             S2ContainsPointQuery<S2ShapeIndex>* query,
                             CrossingProcessor* cp);
@@ -967,9 +973,11 @@ class S2BooleanOperation::Impl {
   bool AddIndexCrossing(const ShapeEdge& a, const ShapeEdge& b,
                         bool is_interior, IndexCrossings* crossings);
   bool InitIndexCrossings(int region_id);
+  bool InitIndexCrossingsParallel(int num_threads);
   bool AddBoundaryPair(bool invert_a, bool invert_b, bool invert_result,
                        CrossingProcessor* cp);
   bool AreRegionsIdentical() const;
+  bool HaveDisjointBounds() const;
   bool BuildOpType(OpType op_type);
   bool IsFullPolygonResult(const S2Builder::Graph& g, S2Error* error) const;
   bool IsFullPolygonUnion(const S2ShapeIndex& a,
@@ -2128,6 +2136,18 @@ bool S2BooleanOperation::Impl::GetChainStarts(
   // may discover that the result region is non-empty and terminate the entire
   // operation early.
   bool b_has_interior = HasInterior(b_index);
+
+  // If region A was passed to Build() as a PreparedOperand then we can use
+  // its precomputed chain start locations to avoid iterating over all of its
+  // chains.  This is only possible when region B is not inverted (otherwise
+  // chains that start outside B's index cells are contained) and boolean
+  // output was not requested (which requires visiting every chain).
+  const PreparedOperand* prepared = op_->prepared_[a_region_id];
+  if (prepared != nullptr && b_has_interior && !invert_b &&
+      !is_boolean_output()) {
+    return GetPreparedChainStarts(*prepared, invert_a, invert_result, b_index,
+                                  chain_starts);
+  }
   if (b_has_interior || invert_b || is_boolean_output()) {
     auto query = MakeS2ContainsPointQuery(&b_index);
     int num_shape_ids = a_index.num_shape_ids();
@@ -2163,6 +2183,50 @@ bool S2BooleanOperation::Impl::GetChainStarts(
   return true;
 }
 
+// Like the main loop of GetChainStarts(), but uses the precomputed chain
+// start locations of a PreparedOperand to examine only the chains whose
+// start vertex lies within an index cell of region B.  Chain starts outside
+// all of B's index cells cannot be contained by B's polygons (see
+// S2ContainsPointQuery), so skipping them does not affect the result.
+bool S2BooleanOperation::Impl::GetPreparedChainStarts(
+    const PreparedOperand& prepared, bool invert_a, bool invert_result,
+    const S2ShapeIndex& b_index, vector<ShapeEdgeId>* chain_starts) {
+  const S2ShapeIndex& a_index = prepared.index();
+  auto query = MakeS2ContainsPointQuery(&b_index);
+  const auto& starts = prepared.chain_starts_;
+  auto next = starts.begin();
+  for (S2ShapeIndex::Iterator it(&b_index, S2ShapeIndex::BEGIN);
+       !it.done() && next != starts.end(); it.Next()) {
+    // Skip any chain starts that precede this index cell.
+    S2CellId range_min = it.id().range_min();
+    if (next->first < range_min) {
+      next = lower_bound(next, starts.end(), range_min,
+                         [](const pair<S2CellId, ShapeEdgeId>& start,
+                            S2CellId id) { return start.first < id; });
+    }
+    // Test the chain starts contained by this index cell.
+    for (S2CellId range_max = it.id().range_max();
+         next != starts.end() && next->first <= range_max; ++next) {
+      ShapeEdgeId id = next->second;
+      const S2Shape* a_shape = a_index.shape(id.shape_id);
+
+      // As in GetChainStarts(), points and polylines in region A can be
+      // ignored if region A is being subtracted from region B.
+      if (invert_a != invert_result && a_shape->dimension() < 2) continue;
+
+      if (query.Contains(a_shape->edge(id.edge_id).v0)) {
+        if (!tracker_.AddSpace(chain_starts, 1)) return false;
+        chain_starts->push_back(id);
+      }
+    }
+  }
+  // AddBoundary() requires the chain starts to be sorted by ShapeEdgeId.
+  std::sort(chain_starts->begin(), chain_starts->end());
+  if (!tracker_.AddSpace(chain_starts, 1)) return false;
+  chain_starts->push_back(kSentinel);
+  return true;
+}
+
 bool S2BooleanOperation::Impl::ProcessIncidentEdges(
     const ShapeEdge& a, S2ContainsPointQuery<S2ShapeIndex>* query,
     CrossingProcessor* cp) {
@@ -2231,20 +2295,26 @@ bool S2BooleanOperation::Impl::InitIndexCrossings(int region_id) {
   if (region_id == index_crossings_first_region_id_) return true;
   if (index_crossings_first_region_id_ < 0) {
     ABSL_DCHECK_EQ(region_id, 0);  // For efficiency, not correctness.
-    // TODO(ericv): This would be more efficient if VisitCrossingEdgePairs()
-    // returned the sign (+1 or -1) of the interior crossing, i.e.
-    // "int interior_crossing_sign" rather than "bool is_interior".
-    if (!s2shapeutil::VisitCrossingEdgePairs(
-            *op_->regions_[0], *op_->regions_[1],
-            s2shapeutil::CrossingType::ALL,
-            [this](const ShapeEdge& a, const ShapeEdge& b, bool is_interior) {
-              // For all supported operations (union, intersection, and
-              // difference), if the input edges have an interior crossing
-              // then the output is guaranteed to have at least one edge.
-              if (is_interior && is_boolean_output()) return false;
-              return AddIndexCrossing(a, b, is_interior, &index_crossings_);
-            })) {
-      return false;
+    const int num_threads = op_->options_.num_threads();
+    if (num_threads > 1) {
+      if (!InitIndexCrossingsParallel(num_threads)) return false;
+    } else {
+      // TODO(ericv): This would be more efficient if VisitCrossingEdgePairs()
+      // returned the sign (+1 or -1) of the interior crossing, i.e.
+      // "int interior_crossing_sign" rather than "bool is_interior".
+      if (!s2shapeutil::VisitCrossingEdgePairs(
+              *op_->regions_[0], *op_->regions_[1],
+              s2shapeutil::CrossingType::ALL,
+              [this](const ShapeEdge& a, const ShapeEdge& b,
+                     bool is_interior) {
+                // For all supported operations (union, intersection, and
+                // difference), if the input edges have an interior crossing
+                // then the output is guaranteed to have at least one edge.
+                if (is_interior && is_boolean_output()) return false;
+                return AddIndexCrossing(a, b, is_interior, &index_crossings_);
+              })) {
+        return false;
+      }
     }
     if (index_crossings_.size() > 1) {
       std::sort(index_crossings_.begin(), index_crossings_.end());
@@ -2252,6 +2322,20 @@ bool S2BooleanOperation::Impl::InitIndexCrossings(int region_id) {
           std::unique(index_crossings_.begin(), index_crossings_.end()),
           index_crossings_.end());
     }
+    if (num_threads > 1) {
+      // In the parallel case the intersection points of interior crossings
+      // could not be passed to the S2Builder as the crossings were found
+      // (see InitIndexCrossingsParallel), so add them now that the crossings
+      // have been deduplicated.
+      for (const IndexCrossing& crossing : index_crossings_) {
+        if (!crossing.is_interior_crossing) continue;
+        auto a = op_->regions_[0]->shape(crossing.a.shape_id)
+                     ->edge(crossing.a.edge_id);
+        auto b = op_->regions_[1]->shape(crossing.b.shape_id)
+                     ->edge(crossing.b.edge_id);
+        builder_->AddIntersection(S2::GetIntersection(a.v0, a.v1, b.v0, b.v1));
+      }
+    }
     // Add a sentinel value to simplify the loop logic.
     tracker_.AddSpace(&index_crossings_, 1);
     index_crossings_.push_back(IndexCrossing(kSentinel, kSentinel));
@@ -2270,6 +2354,57 @@ bool S2BooleanOperation::Impl::InitIndexCrossings(int region_id) {
   return tracker_.ok();
 }
 
+// Enumerates the edge crossings between the two regions on "num_threads"
+// threads, with each thread appending the crossings it finds to its own
+// buffer.  The buffers are merged into index_crossings_ afterwards; the
+// caller is responsible for sorting and deduplicating the merged result
+// (crossings near a partition boundary may be found by more than one thread).
+//
+// The per-thread visitors must not touch tracker_ or builder_, which are not
+// thread-safe; memory is accounted for when the buffers are merged, and the
+// intersection points of interior crossings are added to the S2Builder by
+// InitIndexCrossings() after deduplication.
+bool S2BooleanOperation::Impl::InitIndexCrossingsParallel(int num_threads) {
+  vector<IndexCrossings> buffers(num_threads);
+  vector<s2shapeutil::EdgePairVisitor> visitors;
+  visitors.reserve(num_threads);
+  for (int t = 0; t < num_threads; ++t) {
+    IndexCrossings* buffer = &buffers[t];
+    visitors.push_back([this, buffer](const ShapeEdge& a, const ShapeEdge& b,
+                                      bool is_interior) {
+      // For all supported operations (union, intersection, and difference),
+      // if the input edges have an interior crossing then the output is
+      // guaranteed to have at least one edge.
+      if (is_interior && is_boolean_output()) return false;
+      buffer->push_back(IndexCrossing(a.id(), b.id()));
+      IndexCrossing* crossing = &buffer->back();
+      if (is_interior) {
+        crossing->is_interior_crossing = true;
+        if (s2pred::Sign(a.v0(), a.v1(), b.v0()) > 0) {
+          crossing->left_to_right = true;
+        }
+      } else if (S2::VertexCrossing(a.v0(), a.v1(), b.v0(), b.v1())) {
+        // TODO(ericv): This field isn't used unless one shape is a polygon
+        // and the other is a polyline or polygon, but we don't have the
+        // shape dimension information readily available here.
+        crossing->is_vertex_crossing = true;
+      }
+      return true;  // Continue visiting.
+    });
+  }
+  bool result = s2shapeutil::VisitCrossingEdgePairs(
+      *op_->regions_[0], *op_->regions_[1], s2shapeutil::CrossingType::ALL,
+      visitors, op_->options_.executor());
+  size_t num_crossings = 0;
+  for (const IndexCrossings& buffer : buffers) num_crossings += buffer.size();
+  if (!tracker_.AddSpace(&index_crossings_, num_crossings)) return false;
+  for (const IndexCrossings& buffer : buffers) {
+    index_crossings_.insert(index_crossings_.end(),
+                            buffer.begin(), buffer.end());
+  }
+  return result;
+}
+
 // Supports "early exit" in the case of boolean results by returning false
 // as soon as the result is known to be non-empty.
 bool S2BooleanOperation::Impl::AddBoundaryPair(
@@ -2280,6 +2415,14 @@ bool S2BooleanOperation::Impl::AddBoundaryPair(
   auto type = op_->op_type_;
   if (type == OpType::DIFFERENCE || type == OpType::SYMMETRIC_DIFFERENCE) {
     if (AreRegionsIdentical()) return true;
+  } else if (type == OpType::INTERSECTION) {
+    // Optimization: if the cell-union bounds of the two regions are disjoint
+    // then the intersection is empty, and the chain-start computation and
+    // boundary walks below can be skipped entirely.  This check is valid
+    // only when neither operand is inverted, which is why it is restricted
+    // to INTERSECTION (UNION inverts both operands, and DIFFERENCE inverts
+    // one; disjoint bounds do not make those results trivial to emit).
+    if (HaveDisjointBounds()) return true;
   } else if (is_boolean_output()) {
     // TODO(ericv): When boolean output is requested there are other quick
     // checks that could be done here, such as checking whether a full cell from
@@ -2303,6 +2446,7 @@ bool S2BooleanOperation::Impl::AddBoundaryPair(
 // Supports "early exit" in the case of boolean results by returning false
 // as soon as the result is known to be non-empty.
 bool S2BooleanOperation::Impl::BuildOpType(OpType op_type) {
+  S2PhaseTimer phase_timer(S2Phase::kBooleanOpGraphBuild);
   // CrossingProcessor does the real work of emitting the output edges.
   CrossingProcessor cp(op_->options_.polygon_model(),
                        op_->options_.polyline_model(),
@@ -2584,6 +2728,17 @@ bool S2BooleanOperation::Impl::AreRegionsIdentical() const {
   return true;
 }
 
+bool S2BooleanOperation::Impl::HaveDisjointBounds() const {
+  // The bounds are coarse coverings of the index cells (at most 4 cells
+  // each, see S2ShapeIndexRegion), so this is conservative: a false return
+  // does not imply that the regions intersect.
+  vector<S2CellId> a_bound, b_bound;
+  MakeS2ShapeIndexRegion(op_->regions_[0]).GetCellUnionBound(&a_bound);
+  MakeS2ShapeIndexRegion(op_->regions_[1]).GetCellUnionBound(&b_bound);
+  return !S2CellUnion(std::move(a_bound)).Intersects(
+      S2CellUnion(std::move(b_bound)));
+}
+
 void S2BooleanOperation::Impl::DoBuild(S2Error* error) {
   if (!tracker_.ok()) return;
   builder_options_ = S2Builder::Options(op_->options_.snap_function());
@@ -2647,7 +2802,9 @@ S2BooleanOperation::Options::Options(const Options& options)
       precision_(options.precision_),
       conservative_output_(options.conservative_output_),
       source_id_lexicon_(options.source_id_lexicon_),
-      memory_tracker_(options.memory_tracker_) {
+      memory_tracker_(options.memory_tracker_),
+      num_threads_(options.num_threads_),
+      executor_(options.executor_) {
 }
 
 S2BooleanOperation::Options& S2BooleanOperation::Options::operator=(
@@ -2662,6 +2819,8 @@ S2BooleanOperation::Options& S2BooleanOperation::Options::operator=(
   conservative_output_ = options.conservative_output_;
   source_id_lexicon_ = options.source_id_lexicon_;
   memory_tracker_ = options.memory_tracker_;
+  num_threads_ = options.num_threads_;
+  executor_ = options.executor_;
   return *this;
 }
 
@@ -2729,6 +2888,23 @@ void S2BooleanOperation::Options::set_memory_tracker(S2MemoryTracker* tracker) {
   memory_tracker_ = tracker;
 }
 
+int S2BooleanOperation::Options::num_threads() const {
+  return num_threads_;
+}
+
+void S2BooleanOperation::Options::set_num_threads(int num_threads) {
+  ABSL_DCHECK_GE(num_threads, 1);
+  num_threads_ = num_threads;
+}
+
+S2Executor* S2BooleanOperation::Options::executor() const {
+  return executor_;
+}
+
+void S2BooleanOperation::Options::set_executor(S2Executor* executor) {
+  executor_ = executor;
+}
+
 string_view S2BooleanOperation::OpTypeToString(OpType op_type) {
   switch (op_type) {
     case OpType::UNION:                return "UNION";
@@ -2785,9 +2961,48 @@ bool S2BooleanOperation::Build(const S2ShapeIndex& a,
                                S2Error* error) {
   regions_[0] = &a;
   regions_[1] = &b;
+  prepared_[0] = prepared_[1] = nullptr;
+  return Impl(this).Build(error);
+}
+
+bool S2BooleanOperation::Build(const S2ShapeIndex& a,
+                               const PreparedOperand& b,
+                               S2Error* error) {
+  regions_[0] = &a;
+  regions_[1] = &b.index();
+  prepared_[0] = nullptr;
+  prepared_[1] = &b;
+  return Impl(this).Build(error);
+}
+
+bool S2BooleanOperation::Build(const PreparedOperand& a,
+                               const S2ShapeIndex& b,
+                               S2Error* error) {
+  regions_[0] = &a.index();
+  regions_[1] = &b;
+  prepared_[0] = &a;
+  prepared_[1] = nullptr;
   return Impl(this).Build(error);
 }
 
+S2BooleanOperation::PreparedOperand::PreparedOperand(const S2ShapeIndex* index)
+    : index_(index) {
+  int num_shape_ids = index->num_shape_ids();
+  for (int shape_id = 0; shape_id < num_shape_ids; ++shape_id) {
+    const S2Shape* shape = index->shape(shape_id);
+    if (shape == nullptr) continue;
+    int num_chains = shape->num_chains();
+    for (int chain_id = 0; chain_id < num_chains; ++chain_id) {
+      S2Shape::Chain chain = shape->chain(chain_id);
+      if (chain.length == 0) continue;
+      const S2Point& v0 = shape->chain_edge(chain_id, 0).v0;
+      chain_starts_.push_back(make_pair(
+          S2CellId(v0), s2shapeutil::ShapeEdgeId(shape_id, chain.start)));
+    }
+  }
+  std::sort(chain_starts_.begin(), chain_starts_.end());
+}
+
 bool S2BooleanOperation::IsEmpty(
     OpType op_type, const S2ShapeIndex& a, const S2ShapeIndex& b,
     const Options& options) {
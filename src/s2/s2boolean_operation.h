@@ -27,9 +27,12 @@
 #include "s2/s2builder.h"
 #include "s2/s2builder_graph.h"
 #include "s2/s2builder_layer.h"
+#include "s2/s2cell_id.h"
 #include "s2/s2error.h"
+#include "s2/s2executor.h"
 #include "s2/s2memory_tracker.h"
 #include "s2/s2shape_index.h"
+#include "s2/s2shapeutil_shape_edge_id.h"
 #include "s2/value_lexicon.h"
 
 // This class implements boolean operations (intersection, union, difference,
@@ -207,6 +210,9 @@
 //       std::make_unique<S2PolygonLayer>(&polygon));
 
 class S2BooleanOperation {
+ private:
+  class Impl;  // The actual implementation.
+
  public:
   // The supported operation types.
   enum class OpType : uint8 {
@@ -437,6 +443,26 @@ class S2BooleanOperation {
     S2MemoryTracker* memory_tracker() const;
     void set_memory_tracker(S2MemoryTracker* tracker);
 
+    // Specifies the number of threads used to enumerate the edge crossings
+    // between the two input regions, which is the dominant cost of Build()
+    // for large inputs.  Values greater than 1 cause the S2CellId space to be
+    // partitioned into ranges that are processed on separate threads, with
+    // the per-thread results merged afterwards.  All other phases of the
+    // operation are single-threaded regardless of this setting.
+    //
+    // DEFAULT: 1 (crossings are enumerated serially)
+    int num_threads() const;
+    void set_num_threads(int num_threads);
+
+    // The executor used to run the threads requested by set_num_threads().
+    // This allows clients with their own scheduler to control how the edge
+    // crossings are enumerated in parallel (see S2Executor).  The executor
+    // is not owned and must outlive the operation.
+    //
+    // DEFAULT: nullptr (meaning S2Executor::Default() is used)
+    S2Executor* executor() const;
+    void set_executor(S2Executor* executor);
+
     // Options may be assigned and copied.
     Options(const Options& options);
     Options& operator=(const Options& options);
@@ -451,6 +477,8 @@ class S2BooleanOperation {
     bool conservative_output_ = false;
     ValueLexicon<SourceId>* source_id_lexicon_ = nullptr;
     S2MemoryTracker* memory_tracker_ = nullptr;
+    int num_threads_ = 1;
+    S2Executor* executor_ = nullptr;
   };
 
 #ifndef SWIG
@@ -494,6 +522,48 @@ class S2BooleanOperation {
   bool Build(const S2ShapeIndex& a, const S2ShapeIndex& b,
              S2Error* error);
 
+  // A PreparedOperand wraps one input region and caches work that would
+  // otherwise be repeated by every Build() call against that region.
+  // Specifically it records the location of the start vertex of every edge
+  // chain, which allows Build() to consider only the chains that start
+  // within the index cells of the other operand rather than iterating over
+  // all of them.  This makes the per-operation cost roughly proportional to
+  // the size of the smaller operand, which is a significant savings when
+  // many small regions are clipped against the same large region:
+  //
+  //   S2BooleanOperation::PreparedOperand coastline(&coastline_index);
+  //   for (const auto& parcel : parcels) {
+  //     S2BooleanOperation op(S2BooleanOperation::OpType::INTERSECTION,
+  //                           MakeParcelLayer(parcel), options);
+  //     if (!op.Build(parcel->index(), coastline, &error)) { ... }
+  //   }
+  //
+  // The wrapped index must persist and must not be modified for the
+  // lifetime of the PreparedOperand.
+  class PreparedOperand {
+   public:
+    explicit PreparedOperand(const S2ShapeIndex* index);
+
+    const S2ShapeIndex& index() const { return *index_; }
+
+   private:
+    friend class Impl;
+
+    const S2ShapeIndex* index_;
+
+    // The first edge of every non-empty chain of the index, sorted by the
+    // leaf S2CellId of the chain's start vertex.  This allows the chains
+    // that start within a given range of leaf cells to be found by binary
+    // search.
+    std::vector<std::pair<S2CellId, s2shapeutil::ShapeEdgeId>> chain_starts_;
+  };
+
+  // Variants of Build() where one of the input regions has been preprocessed
+  // using PreparedOperand (see above).  The result is identical to calling
+  // Build() with the underlying indexes.
+  bool Build(const S2ShapeIndex& a, const PreparedOperand& b, S2Error* error);
+  bool Build(const PreparedOperand& a, const S2ShapeIndex& b, S2Error* error);
+
   // Convenience method that returns true if the result of the given operation
   // is empty.
   static bool IsEmpty(OpType op_type,
@@ -522,8 +592,6 @@ class S2BooleanOperation {
   }
 
  private:
-  class Impl;  // The actual implementation.
-
   // Internal constructor to reduce code duplication.
   S2BooleanOperation(OpType op_type, const Options& options);
 
@@ -539,6 +607,10 @@ class S2BooleanOperation {
   // The input regions.
   const S2ShapeIndex* regions_[2];
 
+  // The corresponding PreparedOperand for each input region, or nullptr if
+  // the region was passed to Build() as a plain S2ShapeIndex.
+  const PreparedOperand* prepared_[2] = {nullptr, nullptr};
+
   // The output consists either of zero layers, one layer, or three layers.
   std::vector<std::unique_ptr<S2Builder::Layer>> layers_;
 
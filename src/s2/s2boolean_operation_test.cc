@@ -43,11 +43,13 @@
 #include "s2/s2builder_layer.h"
 #include "s2/s2builderutil_lax_polygon_layer.h"
 #include "s2/s2builderutil_s2point_vector_layer.h"
+#include "s2/s2builderutil_s2polygon_layer.h"
 #include "s2/s2builderutil_s2polyline_vector_layer.h"
 #include "s2/s2builderutil_snap_functions.h"
 #include "s2/s2builderutil_testing.h"
 #include "s2/s2edge_crossings.h"
 #include "s2/s2error.h"
+#include "s2/s2fractal.h"
 #include "s2/s2latlng.h"
 #include "s2/s2lax_polygon_shape.h"
 #include "s2/s2lax_polyline_shape.h"
@@ -76,6 +78,7 @@ using absl::string_view;
 using absl::StrSplit;
 using s2builderutil::IndexMatchingLayer;
 using s2builderutil::LaxPolygonLayer;
+using s2builderutil::S2PolygonLayer;
 using s2shapeutil::ContainsBruteForce;
 using std::make_unique;
 using std::pair;
@@ -221,6 +224,23 @@ TEST(S2BooleanOperation, DegeneratePolygons) {
   ExpectResult(OpType::UNION, options, a, b, a);
 }
 
+TEST(S2BooleanOperation, DisjointRegions) {
+  // Regions whose cell-union bounds are disjoint take a fast path for
+  // INTERSECTION that emits the empty result without walking either index.
+  // Verify that all op types still produce correct results for such inputs.
+  S2BooleanOperation::Options options;
+  auto a = "0:0 # 1:0, 1:1 # 2:2, 2:3, 3:3";
+  auto b = "60:60 # 61:60, 61:61 # 62:62, 62:63, 63:63";
+  ExpectResult(OpType::INTERSECTION, options, a, b, "# #");
+  ExpectResult(OpType::DIFFERENCE, options, a, b, a);
+  ExpectResult(OpType::UNION, options, a, b,
+               "0:0 | 60:60 # 1:0, 1:1 | 61:60, 61:61 "
+               "# 2:2, 2:3, 3:3 | 62:62, 62:63, 63:63");
+  EXPECT_FALSE(S2BooleanOperation::Intersects(*s2textformat::MakeIndexOrDie(a),
+                                              *s2textformat::MakeIndexOrDie(b),
+                                              options));
+}
+
 TEST(S2BooleanOperation, PointPoint) {
   S2BooleanOperation::Options options;
   auto a = "0:0 | 1:0 # #";
@@ -955,6 +975,73 @@ TEST(S2BooleanOperation, PolygonEdgePolygonEdgeCrossing) {
                "1:2, 1:3, 3:3, 3:1, 2:1, 2:2");
 }
 
+TEST(S2BooleanOperation, PolygonEdgePolygonEdgeCrossingMultiThreaded) {
+  // Same as PolygonEdgePolygonEdgeCrossing, but with the edge crossings
+  // enumerated on multiple threads.
+  S2BooleanOperation::Options options = RoundToE(2);
+  options.set_num_threads(4);
+  auto a = "# # 0:0, 0:2, 2:2, 2:0";
+  auto b = "# # 1:1, 1:3, 3:3, 3:1";
+  ExpectResult(OpType::UNION, options, a, b,
+               "# # 0:0, 0:2, 1:2, 1:3, 3:3, 3:1, 2:1, 2:0");
+  ExpectResult(OpType::INTERSECTION, options, a, b,
+               "# # 1:1, 1:2, 2:2, 2:1");
+  ExpectResult(OpType::DIFFERENCE, options, a, b,
+               "# # 0:0, 0:2, 1:2, 1:1, 2:1, 2:0");
+  ExpectResult(OpType::SYMMETRIC_DIFFERENCE, options, a, b,
+               "# # 0:0, 0:2, 1:2, 1:1, 2:1, 2:0; "
+               "1:2, 1:3, 3:3, 3:1, 2:1, 2:2");
+}
+
+TEST(S2BooleanOperation, PreparedOperandMatchesPlainBuild) {
+  // Verifies that Build() with a PreparedOperand yields the same result as
+  // Build() with the underlying index, with the prepared region on either
+  // side of the operation.
+  S2Fractal fractal;
+  fractal.SetLevelForApproxMaxEdges(1000);
+  S2Polygon big_polygon(fractal.MakeLoop(
+      S2::GetFrame(s2textformat::MakePointOrDie("10:10")),
+      S1Angle::Degrees(5)));
+  MutableS2ShapeIndex big_index;
+  big_index.Add(make_unique<S2Polygon::Shape>(&big_polygon));
+  S2BooleanOperation::PreparedOperand prepared(&big_index);
+
+  // Small operands that straddle the fractal boundary, lie deep in its
+  // interior, and lie far outside all of its index cells.
+  for (const string& parcel_str :
+       vector<string>{"# # 6:6, 6:14, 14:14, 14:6",
+                      "# # 9.9:9.9, 9.9:10.1, 10.1:10.1, 10.1:9.9",
+                      "# # 40:40, 40:41, 41:41, 41:40"}) {
+    auto parcel = s2textformat::MakeIndexOrDie(parcel_str);
+    for (OpType op_type :
+         {OpType::UNION, OpType::INTERSECTION, OpType::DIFFERENCE,
+          OpType::SYMMETRIC_DIFFERENCE}) {
+      SCOPED_TRACE(absl::StrCat(S2BooleanOperation::OpTypeToString(op_type),
+                                " of ", parcel_str));
+      S2Error error;
+      S2Polygon expected, actual;
+      {
+        S2BooleanOperation op(op_type, make_unique<S2PolygonLayer>(&expected));
+        ASSERT_TRUE(op.Build(*parcel, big_index, &error)) << error;
+      }
+      {
+        S2BooleanOperation op(op_type, make_unique<S2PolygonLayer>(&actual));
+        ASSERT_TRUE(op.Build(*parcel, prepared, &error)) << error;
+      }
+      EXPECT_TRUE(expected.Equals(actual));
+      {
+        S2BooleanOperation op(op_type, make_unique<S2PolygonLayer>(&expected));
+        ASSERT_TRUE(op.Build(big_index, *parcel, &error)) << error;
+      }
+      {
+        S2BooleanOperation op(op_type, make_unique<S2PolygonLayer>(&actual));
+        ASSERT_TRUE(op.Build(prepared, *parcel, &error)) << error;
+      }
+      EXPECT_TRUE(expected.Equals(actual));
+    }
+  }
+}
+
 TEST(S2BooleanOperation, PolygonEdgeOpenPolygonEdgeOverlap) {
   S2BooleanOperation::Options options;
   // One shape is a rectangle, the other consists of one triangle inside the
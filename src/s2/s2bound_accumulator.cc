@@ -0,0 +1,96 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2bound_accumulator.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "s2/r1interval.h"
+#include "s2/s1angle.h"
+#include "s2/s1interval.h"
+#include "s2/s2cap.h"
+#include "s2/s2latlng_rect.h"
+#include "s2/s2point.h"
+
+using std::max;
+using std::min;
+
+void S2BoundAccumulator::AddCap(const S2Cap& cap) {
+  if (cap.is_empty()) return;
+  // For any unit vector e, the dot product p * e over all points p of the cap
+  // is cos(a) where a ranges over [theta - r, theta + r] clamped to [0, Pi],
+  // theta being the angle between the cap center and e and r the cap radius.
+  // Applying this to the three coordinate axes yields the tightest axis-
+  // aligned box containing the cap.
+  // The acos/cos round trip is padded by DBL_EPSILON to absorb its rounding
+  // error, so the box is conservative.
+  const double r = cap.GetRadius().radians();
+  for (int i = 0; i < 3; ++i) {
+    const double theta = acos(max(-1.0, min(1.0, cap.center()[i])));
+    min_[i] = min(min_[i], cos(min(M_PI, theta + r)) - DBL_EPSILON);
+    max_[i] = max(max_[i], cos(max(0.0, theta - r)) + DBL_EPSILON);
+  }
+}
+
+S2LatLngRect S2BoundAccumulator::GetRectBound() const {
+  if (is_empty()) return S2LatLngRect::Empty();
+
+  // Latitude is asin(z), which is monotonic, so the z-range of the box gives
+  // the latitude range of its contents.  Added points are only approximately
+  // unit length however, and asin() amplifies the resulting error in z by
+  // 1/cos(latitude) = 1/sqrt(1 - z^2), so each endpoint is expanded by that
+  // factor (which is capped near the poles, where the latitude error cannot
+  // exceed about sqrt(DBL_EPSILON) in any case).
+  const auto lat_error = [](double z) {
+    return 2 * DBL_EPSILON * (1 + 1 / sqrt(max(1 - z * z, DBL_EPSILON)));
+  };
+  const double z_lo = max(-1.0, min(1.0, min_[2]));
+  const double z_hi = max(-1.0, min(1.0, max_[2]));
+  R1Interval lat(asin(z_lo) - lat_error(z_lo), asin(z_hi) + lat_error(z_hi));
+  lat = lat.Intersection(S2LatLngRect::FullLat());
+
+  // If the projection of the box onto the xy-plane contains the origin then
+  // the box contains points of every longitude (this includes the case where
+  // the box has collapsed to a pole).  Otherwise the projection lies in an
+  // open half-plane through the origin, so the longitudes it spans form an
+  // interval of length less than Pi whose endpoints are attained at corners
+  // of the projection.
+  S1Interval lng;
+  if (min_[0] <= 0 && max_[0] >= 0 && min_[1] <= 0 && max_[1] >= 0) {
+    lng = S1Interval::Full();
+  } else {
+    lng = S1Interval::FromPoint(atan2(min_[1], min_[0]));
+    lng.AddPoint(atan2(min_[1], max_[0]));
+    lng.AddPoint(atan2(max_[1], min_[0]));
+    lng.AddPoint(atan2(max_[1], max_[0]));
+  }
+
+  // The box stores raw coordinates while S2LatLngRect::Contains() compares
+  // rounded S2LatLng values, and asin() above need not round the same way as
+  // the atan2() used by S2LatLng.  As in S2LatLngRectBounder::GetBound(), we
+  // expand the result by a small multiple of DBL_EPSILON to account for all
+  // such rounding, and take the polar closure so that a bound touching a pole
+  // contains every representation of that pole.
+  const S2LatLng kExpansion = S2LatLng::FromRadians(2 * DBL_EPSILON,
+                                                    4 * DBL_EPSILON);
+  return S2LatLngRect(lat, lng).Expanded(kExpansion).PolarClosure();
+}
+
+S2Cap S2BoundAccumulator::GetCapBound() const {
+  if (is_empty()) return S2Cap::Empty();
+  return GetRectBound().GetCapBound();
+}
@@ -0,0 +1,89 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef S2_S2BOUND_ACCUMULATOR_H_
+#define S2_S2BOUND_ACCUMULATOR_H_
+
+#include <algorithm>
+
+#include "s2/_fp_contract_off.h"
+#include "s2/s2cap.h"
+#include "s2/s2latlng_rect.h"
+#include "s2/s2point.h"
+
+// S2BoundAccumulator is a streaming accumulator for conservative bounds over
+// a sequence of points and/or caps.  It is designed for aggregation pipelines
+// that maintain one bound per key in a hash table: the object has a small
+// fixed size (six doubles), updates are branch-free comparisons that the
+// compiler can vectorize, and nothing is allocated until a bound is actually
+// requested.
+//
+// Internally the accumulator maintains an axis-aligned box in (x, y, z)
+// coordinates that contains every point added so far.  GetRectBound() and
+// GetCapBound() convert the box to an S2LatLngRect or S2Cap on demand.  The
+// rectangle is tight in latitude (latitude depends only on z) and is the
+// tightest longitude interval spanned by the box, both padded by a few ulps
+// for rounding, so it is usually close to the rectangle that would be
+// obtained by adding each point to an S2LatLngRect directly.  The cap bound
+// is derived from the rectangle.
+//
+// Accumulators may be merged with AddBound(), which makes the type suitable
+// for combining partial aggregates computed on different threads or shards.
+//
+// This class is not thread-safe.
+class S2BoundAccumulator {
+ public:
+  // Creates an empty accumulator (one whose bounds contain no points).
+  S2BoundAccumulator() = default;
+
+  // Resets the accumulator to its empty state.
+  void Clear() { *this = S2BoundAccumulator(); }
+
+  // Returns true if no points or non-empty caps have been added.
+  bool is_empty() const { return max_[0] < min_[0]; }
+
+  // Expands the bound to include the given point, which must be unit length.
+  void AddPoint(const S2Point& p) {
+    for (int i = 0; i < 3; ++i) {
+      min_[i] = std::min(min_[i], p[i]);
+      max_[i] = std::max(max_[i], p[i]);
+    }
+  }
+
+  // Expands the bound to include every point of the given cap.
+  void AddCap(const S2Cap& cap);
+
+  // Expands the bound to include everything added to "other".
+  void AddBound(const S2BoundAccumulator& other) {
+    for (int i = 0; i < 3; ++i) {
+      min_[i] = std::min(min_[i], other.min_[i]);
+      max_[i] = std::max(max_[i], other.max_[i]);
+    }
+  }
+
+  // Returns a rectangle containing every point added so far.
+  S2LatLngRect GetRectBound() const;
+
+  // Returns a cap containing every point added so far.
+  S2Cap GetCapBound() const;
+
+ private:
+  // The box is empty iff min_[i] > max_[i].  Using 2 as the sentinel (rather
+  // than infinity) keeps the arithmetic in GetRectBound() finite.
+  double min_[3] = {2, 2, 2};
+  double max_[3] = {-2, -2, -2};
+};
+
+#endif  // S2_S2BOUND_ACCUMULATOR_H_
@@ -0,0 +1,113 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2bound_accumulator.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "absl/flags/flag.h"
+#include "s2/s1angle.h"
+#include "s2/s2cap.h"
+#include "s2/s2latlng.h"
+#include "s2/s2latlng_rect.h"
+#include "s2/s2point.h"
+#include "s2/s2testing.h"
+
+using std::vector;
+
+TEST(S2BoundAccumulator, Empty) {
+  S2BoundAccumulator bound;
+  EXPECT_TRUE(bound.is_empty());
+  EXPECT_TRUE(bound.GetRectBound().is_empty());
+  EXPECT_TRUE(bound.GetCapBound().is_empty());
+}
+
+TEST(S2BoundAccumulator, SinglePoint) {
+  S2BoundAccumulator bound;
+  S2Point p = S2LatLng::FromDegrees(10, 20).ToPoint();
+  bound.AddPoint(p);
+  EXPECT_FALSE(bound.is_empty());
+  EXPECT_TRUE(bound.GetRectBound().Contains(p));
+  EXPECT_TRUE(bound.GetCapBound().Contains(p));
+  bound.Clear();
+  EXPECT_TRUE(bound.is_empty());
+}
+
+TEST(S2BoundAccumulator, BoundsContainAddedPoints) {
+  S2Testing::rnd.Reset(absl::GetFlag(FLAGS_s2_random_seed));
+  for (int iter = 0; iter < 50; ++iter) {
+    S2BoundAccumulator bound;
+    vector<S2Point> points;
+    for (int i = 0; i < 20; ++i) {
+      points.push_back(S2Testing::RandomPoint());
+      bound.AddPoint(points.back());
+    }
+    S2LatLngRect rect = bound.GetRectBound();
+    S2Cap cap = bound.GetCapBound();
+    for (const S2Point& p : points) {
+      EXPECT_TRUE(rect.Contains(p));
+      EXPECT_TRUE(cap.Contains(p));
+    }
+  }
+}
+
+TEST(S2BoundAccumulator, PolePoint) {
+  // A box collapsed to a pole spans every longitude.
+  S2BoundAccumulator bound;
+  bound.AddPoint(S2Point(0, 0, 1));
+  EXPECT_TRUE(bound.GetRectBound().Contains(S2Point(0, 0, 1)));
+  EXPECT_TRUE(bound.GetRectBound().lng().is_full());
+}
+
+TEST(S2BoundAccumulator, AddCapContainsCapBoundary) {
+  S2Testing::rnd.Reset(absl::GetFlag(FLAGS_s2_random_seed));
+  for (int iter = 0; iter < 50; ++iter) {
+    S2Cap cap = S2Cap(S2Testing::RandomPoint(),
+                      S1Angle::Radians(M_PI * S2Testing::rnd.RandDouble()));
+    S2BoundAccumulator bound;
+    bound.AddCap(cap);
+    S2LatLngRect rect = bound.GetRectBound();
+    S2Cap cap_bound = bound.GetCapBound();
+    for (int i = 0; i < 20; ++i) {
+      S2Point p = S2Testing::SamplePoint(cap);
+      EXPECT_TRUE(rect.Contains(p));
+      EXPECT_TRUE(cap_bound.Contains(p));
+    }
+  }
+}
+
+TEST(S2BoundAccumulator, AddEmptyCapIsNoOp) {
+  S2BoundAccumulator bound;
+  bound.AddCap(S2Cap::Empty());
+  EXPECT_TRUE(bound.is_empty());
+}
+
+TEST(S2BoundAccumulator, MergeMatchesCombinedUpdates) {
+  S2Testing::rnd.Reset(absl::GetFlag(FLAGS_s2_random_seed));
+  for (int iter = 0; iter < 20; ++iter) {
+    S2BoundAccumulator combined, left, right;
+    for (int i = 0; i < 30; ++i) {
+      S2Point p = S2Testing::RandomPoint();
+      combined.AddPoint(p);
+      (i % 2 == 0 ? left : right).AddPoint(p);
+    }
+    left.AddBound(right);
+    // Min/max updates commute, so merging partial accumulators gives exactly
+    // the same box (and hence the same bounds) as a single accumulator.
+    EXPECT_EQ(combined.GetRectBound(), left.GetRectBound());
+    EXPECT_EQ(combined.GetCapBound(), left.GetCapBound());
+  }
+}
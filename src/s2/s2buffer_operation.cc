@@ -68,6 +68,7 @@
 #include "s2/s2edge_distances.h"
 #include "s2/s2error.h"
 #include "s2/s2lax_loop_shape.h"
+#include "s2/s2lax_polygon_shape.h"
 #include "s2/s2memory_tracker.h"
 #include "s2/s2point.h"
 #include "s2/s2point_span.h"
@@ -337,7 +338,7 @@ void S2BufferOperation::Init(unique_ptr<S2Builder::Layer> result_layer,
       buffer_sign_ == 0 && options_.buffer_radius() >= S1Angle::Zero());
   winding_options.set_memory_tracker(options.memory_tracker());
   op_.Init(std::move(result_layer), winding_options);
-  tracker_.Init(options.memory_tracker());
+  tracker_.Init(options.memory_tracker(), "S2BufferOperation");
 }
 
 const S2BufferOperation::Options& S2BufferOperation::options() const {
@@ -769,3 +770,118 @@ bool S2BufferOperation::Build(S2Error* error) {
   return op_.Build(ref_point_, ref_winding_,
                    S2WindingOperation::WindingRule::POSITIVE, error);
 }
+
+S2MultiRadiusBufferOperation::S2MultiRadiusBufferOperation() = default;
+
+S2MultiRadiusBufferOperation::~S2MultiRadiusBufferOperation() = default;
+
+S2MultiRadiusBufferOperation::S2MultiRadiusBufferOperation(
+    vector<unique_ptr<S2Builder::Layer>> result_layers,
+    absl::Span<const S1Angle> buffer_radii,
+    const S2BufferOperation::Options& options) {
+  Init(std::move(result_layers), buffer_radii, options);
+}
+
+void S2MultiRadiusBufferOperation::Init(
+    vector<unique_ptr<S2Builder::Layer>> result_layers,
+    absl::Span<const S1Angle> buffer_radii,
+    const S2BufferOperation::Options& options) {
+  ABSL_DCHECK_EQ(result_layers.size(), buffer_radii.size());
+  ops_.clear();
+  ops_.reserve(buffer_radii.size());
+  for (size_t i = 0; i < buffer_radii.size(); ++i) {
+    S2BufferOperation::Options radius_options = options;
+    radius_options.set_buffer_radius(buffer_radii[i]);
+    ops_.push_back(make_unique<S2BufferOperation>(std::move(result_layers[i]),
+                                                  radius_options));
+  }
+}
+
+void S2MultiRadiusBufferOperation::AddPoint(const S2Point& point) {
+  for (const auto& op : ops_) op->AddPoint(point);
+}
+
+void S2MultiRadiusBufferOperation::AddPolyline(S2PointSpan polyline) {
+  for (const auto& op : ops_) op->AddPolyline(polyline);
+}
+
+void S2MultiRadiusBufferOperation::AddLoop(S2PointLoopSpan loop) {
+  for (const auto& op : ops_) op->AddLoop(loop);
+}
+
+// Extracts the vertices of each point chain of "shape" once and adds the
+// result to every per-radius operation.
+void S2MultiRadiusBufferOperation::ForwardPoints(const S2Shape& shape) {
+  for (int c = 0; c < shape.num_chains(); ++c) {
+    if (shape.chain(c).length == 0) continue;
+    const S2Point point = shape.edge(c).v0;
+    for (const auto& op : ops_) op->AddPoint(point);
+  }
+}
+
+// Extracts the vertices of each polyline chain of "shape" once and adds the
+// result to every per-radius operation.
+void S2MultiRadiusBufferOperation::ForwardPolylineChains(const S2Shape& shape) {
+  for (int c = 0; c < shape.num_chains(); ++c) {
+    if (shape.chain(c).length == 0) continue;
+    S2::GetChainVertices(shape, c, &tmp_vertices_);
+    for (const auto& op : ops_) op->AddPolyline(S2PointSpan(tmp_vertices_));
+  }
+}
+
+void S2MultiRadiusBufferOperation::AddShape(const S2Shape& shape) {
+  const int dimension = shape.dimension();
+  if (dimension == 0) {
+    ForwardPoints(shape);
+  } else if (dimension == 1) {
+    ForwardPolylineChains(shape);
+  } else {
+    // Materialize the loops once so that each per-radius operation works from
+    // an in-memory copy rather than re-decoding the original shape.  Empty
+    // loops (representing full loops) are preserved.
+    vector<S2LaxPolygonShape::Loop> loops(shape.num_chains());
+    for (int c = 0; c < shape.num_chains(); ++c) {
+      if (shape.chain(c).length == 0) continue;
+      S2::GetChainVertices(shape, c, &loops[c]);
+    }
+    const S2LaxPolygonShape polygon(loops);
+    for (const auto& op : ops_) op->AddShape(polygon);
+  }
+}
+
+void S2MultiRadiusBufferOperation::AddShapeIndex(const S2ShapeIndex& index) {
+  // Polygonal shapes are gathered into a single materialized polygon so that
+  // each per-radius operation sees them as one layer, exactly as
+  // S2BufferOperation::AddShapeIndex does.  (Polygon interiors within a layer
+  // are required to be disjoint, so containment of the reference point by the
+  // combined polygon matches containment by the index.)
+  vector<S2LaxPolygonShape::Loop> loops;
+  bool has_polygon = false;
+  for (const S2Shape* shape : index) {
+    if (shape == nullptr) continue;
+    const int dimension = shape->dimension();
+    if (dimension == 0) {
+      ForwardPoints(*shape);
+    } else if (dimension == 1) {
+      ForwardPolylineChains(*shape);
+    } else {
+      has_polygon = true;
+      for (int c = 0; c < shape->num_chains(); ++c) {
+        loops.emplace_back();
+        if (shape->chain(c).length == 0) continue;
+        S2::GetChainVertices(*shape, c, &loops.back());
+      }
+    }
+  }
+  if (has_polygon) {
+    const S2LaxPolygonShape polygon(loops);
+    for (const auto& op : ops_) op->AddShape(polygon);
+  }
+}
+
+bool S2MultiRadiusBufferOperation::Build(S2Error* error) {
+  for (const auto& op : ops_) {
+    if (!op->Build(error)) return false;
+  }
+  return true;
+}
@@ -23,6 +23,7 @@
 
 #include "s2/base/types.h"
 #include "absl/log/absl_log.h"
+#include "absl/types/span.h"
 #include "s2/s1angle.h"
 #include "s2/s1chord_angle.h"
 #include "s2/s2builder.h"
@@ -357,4 +358,65 @@ class S2BufferOperation {
   S2MemoryTracker::Client tracker_;
 };
 
+// S2MultiRadiusBufferOperation buffers the same input geometry at several
+// radii at once (e.g. styling the same road network at 8 different widths),
+// sending the output polygon for buffer_radii[i] to result_layers[i].
+//
+// Compared to running one S2BufferOperation per radius, the input geometry
+// is decoded and dispatched once: each shape's chain vertices are
+// materialized a single time and shared by all of the per-radius operations,
+// so encoded shapes and shape indexes are not re-traversed per radius.  The
+// offset geometry itself necessarily depends on the radius and is still
+// generated separately for each one.
+//
+// Each radius produces exactly the same output as a standalone
+// S2BufferOperation with that buffer_radius() and the same remaining
+// options.
+class S2MultiRadiusBufferOperation {
+ public:
+  // Default constructor; requires Init() to be called.
+  S2MultiRadiusBufferOperation();
+  ~S2MultiRadiusBufferOperation();
+
+  // Convenience constructor that calls Init().
+  S2MultiRadiusBufferOperation(
+      std::vector<std::unique_ptr<S2Builder::Layer>> result_layers,
+      absl::Span<const S1Angle> buffer_radii,
+      const S2BufferOperation::Options& options = S2BufferOperation::Options{});
+
+  // Starts a buffer operation for each of the given radii, sending the
+  // output for buffer_radii[i] to result_layers[i].  The buffer_radius() of
+  // "options" is ignored; all other options apply to every radius.
+  //
+  // REQUIRES: result_layers.size() == buffer_radii.size()
+  void Init(std::vector<std::unique_ptr<S2Builder::Layer>> result_layers,
+            absl::Span<const S1Angle> buffer_radii,
+            const S2BufferOperation::Options& options =
+                S2BufferOperation::Options{});
+
+  // Returns the number of radii being buffered.
+  int num_radii() const { return ops_.size(); }
+
+  // The input methods below mirror those of S2BufferOperation and add the
+  // given geometry to every per-radius operation.
+  void AddPoint(const S2Point& point);
+  void AddPolyline(S2PointSpan polyline);
+  void AddLoop(S2PointLoopSpan loop);
+  void AddShape(const S2Shape& shape);
+  void AddShapeIndex(const S2ShapeIndex& index);
+
+  // Builds all of the per-radius operations, returning true on success.
+  // Otherwise returns false and sets "error" to the first error encountered.
+  bool Build(S2Error* error);
+
+ private:
+  void ForwardPolylineChains(const S2Shape& shape);
+  void ForwardPoints(const S2Shape& shape);
+
+  std::vector<std::unique_ptr<S2BufferOperation>> ops_;
+
+  // Used internally as a temporary to avoid excessive memory allocation.
+  std::vector<S2Point> tmp_vertices_;
+};
+
 #endif  // S2_S2BUFFER_OPERATION_H_
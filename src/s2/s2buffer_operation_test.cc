@@ -705,4 +705,39 @@ TEST(S2BufferOperation, ZigZagPolyline) {
   }
 }
 
+TEST(S2MultiRadiusBufferOperation, MatchesIndividualOperations) {
+  // Buffers a mixture of points, polylines, and a polygon with a hole at
+  // several radii at once, and checks that each output is identical to
+  // running a standalone S2BufferOperation at that radius.
+  auto index = s2textformat::MakeIndexOrDie(
+      "2:2 | 4:4 # 0:0, 0:5, 3:5 "
+      "# 10:10, 10:15, 15:15, 15:10; 11:11, 11:12, 12:12");
+  const vector<S1Angle> radii = {S1Angle::Degrees(0.5), S1Angle::Degrees(1),
+                                 S1Angle::Degrees(2)};
+  const double kErrorFraction = 0.02;
+
+  vector<unique_ptr<S2LaxPolygonShape>> outputs;
+  vector<unique_ptr<S2Builder::Layer>> layers;
+  for (size_t i = 0; i < radii.size(); ++i) {
+    outputs.push_back(make_unique<S2LaxPolygonShape>());
+    layers.push_back(
+        make_unique<s2builderutil::LaxPolygonLayer>(outputs.back().get()));
+  }
+  S2BufferOperation::Options options;
+  options.set_error_fraction(kErrorFraction);
+  S2MultiRadiusBufferOperation op(std::move(layers), radii, options);
+  ASSERT_EQ(op.num_radii(), 3);
+  op.AddShapeIndex(*index);
+  S2Error error;
+  ASSERT_TRUE(op.Build(&error)) << error;
+
+  for (size_t i = 0; i < radii.size(); ++i) {
+    auto expected = DoBuffer(
+        [&index](S2BufferOperation* op) { op->AddShapeIndex(*index); },
+        radii[i], kErrorFraction);
+    EXPECT_EQ(s2textformat::ToString(*expected),
+              s2textformat::ToString(*outputs[i]));
+  }
+}
+
 }  // namespace
@@ -76,6 +76,7 @@
 #include <iostream>
 #include <memory>
 #include <ostream>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -106,6 +107,7 @@
 #include "s2/s2edge_distances.h"
 #include "s2/s2error.h"
 #include "s2/s2loop.h"
+#include "s2/s2phase_timer.h"
 #include "s2/s2point.h"
 #include "s2/s2point_index.h"
 #include "s2/s2point_span.h"
@@ -146,7 +148,10 @@ S2Builder::Options::Options(const Options& options)
       intersection_tolerance_(options.intersection_tolerance_),
       simplify_edge_chains_(options.simplify_edge_chains_),
       idempotent_(options.idempotent_),
-      memory_tracker_(options.memory_tracker_) {
+      assume_input_snapped_(options.assume_input_snapped_),
+      deduplicate_edges_(options.deduplicate_edges_),
+      memory_tracker_(options.memory_tracker_),
+      num_threads_(options.num_threads_) {
 }
 
 S2Builder::Options& S2Builder::Options::operator=(const Options& options) {
@@ -155,7 +160,10 @@ S2Builder::Options& S2Builder::Options::operator=(const Options& options) {
   intersection_tolerance_ = options.intersection_tolerance_;
   simplify_edge_chains_ = options.simplify_edge_chains_;
   idempotent_ = options.idempotent_;
+  assume_input_snapped_ = options.assume_input_snapped_;
+  deduplicate_edges_ = options.deduplicate_edges_;
   memory_tracker_ = options.memory_tracker_;
+  num_threads_ = options.num_threads_;
   return *this;
 }
 
@@ -327,7 +335,7 @@ void S2Builder::Init(const Options& options) {
   // input geometry needs to be modified, snapping_needed_ is set to true.
   snapping_needed_ = false;
 
-  tracker_.Init(options.memory_tracker());
+  tracker_.Init(options.memory_tracker(), "S2Builder");
 }
 
 void S2Builder::clear_labels() {
@@ -373,6 +381,9 @@ void S2Builder::StartLayer(unique_ptr<Layer> layer) {
   layer_begins_.push_back(input_edges_.size());
   layer_is_full_polygon_predicates_.push_back(IsFullPolygon(false));
   layers_.push_back(std::move(layer));
+  // Each layer corresponds to a contiguous range of input edges, so edges
+  // may only be deduplicated within a layer.
+  edge_id_map_.clear();
 }
 
 // Input vertices are stored in a vector, with some removal of duplicates.
@@ -380,6 +391,17 @@ void S2Builder::StartLayer(unique_ptr<Layer> layer) {
 // in a single vector; each layer corresponds to a contiguous range.
 
 S2Builder::InputVertexId S2Builder::AddVertex(const S2Point& v) {
+  if (options_.deduplicate_edges()) {
+    // Deduplicate vertices exactly so that duplicate edges can be detected
+    // by comparing vertex ids (see AddEdgeInternal).
+    auto it = vertex_id_map_.find(v);
+    if (it != vertex_id_map_.end()) return it->second;
+    if (!tracker_.AddSpace(&input_vertices_, 1)) return -1;
+    input_vertices_.push_back(v);
+    InputVertexId id = input_vertices_.size() - 1;
+    vertex_id_map_.insert({v, id});
+    return id;
+  }
   // Remove duplicate vertices that follow the pattern AB, BC, CD.  If we want
   // to do anything more sophisticated, either use a ValueLexicon, or sort the
   // vertices once they have all been added, remove duplicates, and update the
@@ -410,21 +432,48 @@ void S2Builder::AddEdge(const S2Point& v0, const S2Point& v1) {
   }
   InputVertexId j0 = AddVertex(v0);
   InputVertexId j1 = AddVertex(v1);
-  if (!tracker_.AddSpace(&input_edges_, 1)) return;
-  input_edges_.push_back(InputEdge(j0, j1));
+  AddEdgeInternal(j0, j1);
+}
 
-  // If there are any labels, then attach them to this input edge.
+// Adds an edge between two existing input vertices, attaching the current
+// labels to it.
+void S2Builder::AddEdgeInternal(InputVertexId j0, InputVertexId j1) {
+  // If the label set has changed, compute its id before the edge is added
+  // (and before checking for duplicates, since edges with different labels
+  // must not be merged).
   if (label_set_modified_) {
     if (label_set_ids_.empty()) {
       // Populate the missing entries with empty label sets.
-      label_set_ids_.assign(input_edges_.size() - 1, label_set_id_);
+      label_set_ids_.assign(input_edges_.size(), label_set_id_);
     }
     label_set_id_ = label_set_lexicon_.Add(label_set_);
-    label_set_ids_.push_back(label_set_id_);
     label_set_modified_ = false;
-  } else if (!label_set_ids_.empty()) {
+  }
+  if (options_.deduplicate_edges()) {
+    InputEdgeId id = input_edges_.size();
+    auto result = edge_id_map_.insert({{InputEdge(j0, j1), label_set_id_}, id});
+    if (!result.second) {
+      // An exact duplicate of an earlier edge in this layer; simply record
+      // that one more copy of that edge exists.
+      if (input_edge_multiplicities_.empty()) {
+        input_edge_multiplicities_.assign(input_edges_.size(), 1);
+      }
+      ++input_edge_multiplicities_[result.first->second];
+      return;
+    }
+  }
+  if (!tracker_.AddSpace(&input_edges_, 1)) return;
+  input_edges_.push_back(InputEdge(j0, j1));
+  // "label_set_ids_" may still be empty here if the labels were set before
+  // the first edge was added, in which case the backfill above assigned no
+  // entries; the current label set id must be pushed regardless.
+  if (!label_set_ids_.empty() ||
+      label_set_id_ != label_set_lexicon_.EmptySetId()) {
     label_set_ids_.push_back(label_set_id_);
   }
+  if (!input_edge_multiplicities_.empty()) {
+    input_edge_multiplicities_.push_back(1);
+  }
 }
 
 void S2Builder::AddPolyline(S2PointSpan polyline) {
@@ -433,6 +482,26 @@ void S2Builder::AddPolyline(S2PointSpan polyline) {
   }
 }
 
+void S2Builder::AddPolyline(vector<S2Point>&& polyline) {
+  // The buffer can only be adopted as-is when the builder has no input
+  // vertices yet (the edges below refer to the vertices by position).
+  if (!input_vertices_.empty() || polyline.size() <= 1) {
+    AddPolyline(S2PointSpan(polyline));
+    return;
+  }
+  ABSL_DCHECK(!layers_.empty()) << "Call StartLayer before adding any edges";
+  bool discard_degenerate = (layer_options_.back().degenerate_edges() ==
+                             GraphOptions::DegenerateEdges::DISCARD);
+  input_vertices_ = std::move(polyline);
+  if (!tracker_.Tally(input_vertices_)) return;
+  for (size_t i = 1; i < input_vertices_.size(); ++i) {
+    if (discard_degenerate && input_vertices_[i - 1] == input_vertices_[i]) {
+      continue;
+    }
+    AddEdgeInternal(i - 1, i);
+  }
+}
+
 void S2Builder::AddPolyline(const S2Polyline& polyline) {
   const int n = polyline.num_vertices();
   for (int i = 1; i < n; ++i) {
@@ -446,6 +515,27 @@ void S2Builder::AddLoop(S2PointLoopSpan loop) {
   }
 }
 
+void S2Builder::AddLoop(vector<S2Point>&& loop) {
+  // See AddPolyline(vector<S2Point>&&) above.
+  if (!input_vertices_.empty() || loop.empty()) {
+    AddLoop(S2PointLoopSpan(loop));
+    return;
+  }
+  ABSL_DCHECK(!layers_.empty()) << "Call StartLayer before adding any edges";
+  bool discard_degenerate = (layer_options_.back().degenerate_edges() ==
+                             GraphOptions::DegenerateEdges::DISCARD);
+  input_vertices_ = std::move(loop);
+  if (!tracker_.Tally(input_vertices_)) return;
+  const size_t n = input_vertices_.size();
+  for (size_t i = 0; i < n; ++i) {
+    const size_t j = (i + 1 == n) ? 0 : i + 1;
+    if (discard_degenerate && input_vertices_[i] == input_vertices_[j]) {
+      continue;
+    }
+    AddEdgeInternal(i, j);
+  }
+}
+
 void S2Builder::AddLoop(const S2Loop& loop) {
   // Ignore loops that do not have a boundary.
   if (loop.is_empty_or_full()) return;
@@ -558,12 +648,16 @@ void S2Builder::Reset() {
   label_set_lexicon_.Clear();
   label_set_.clear();
   label_set_modified_ = false;
+  vertex_id_map_.clear();
+  edge_id_map_.clear();
+  input_edge_multiplicities_.clear();
   sites_.clear();
   edge_sites_.clear();
   snapping_needed_ = false;
 }
 
 void S2Builder::ChooseSites() {
+  S2PhaseTimer phase_timer(S2Phase::kBuilderSnap);
   if (!tracker_.ok() || input_vertices_.empty()) return;
 
   // Note that although we always create an S2ShapeIndex, often it is not
@@ -577,6 +671,19 @@ void S2Builder::ChooseSites() {
     AddEdgeCrossings(input_edge_index);
   }
 
+  // Fast idempotent path (opt-in): if every input vertex is already at a
+  // snap location then the input is passed through unmodified, without
+  // building the S2PointIndex of candidate sites.  The separation criteria
+  // are assumed rather than verified; see Options::assume_input_snapped().
+  // Note that snapping_needed_ is already true here if the idempotent()
+  // option is off, if any vertices were forced, or if any crossing edges
+  // were just split, so the full path is used in all of those cases.
+  if (snapping_requested_ && !snapping_needed_ &&
+      options_.assume_input_snapped() && InputVerticesAreSnapped()) {
+    ChooseAllVerticesAsSites();
+    return;
+  }
+
   if (snapping_requested_) {
     S2PointIndex<SiteId> site_index;
     auto _ = absl::MakeCleanup([&]() { tracker_.DoneSiteIndex(site_index); });
@@ -592,6 +699,17 @@ void S2Builder::ChooseSites() {
   }
 }
 
+// Returns true if every input vertex is already at a snap location, i.e. the
+// snap function maps it to itself.  This is a single pass over the vertices
+// and does not require any spatial index.
+bool S2Builder::InputVerticesAreSnapped() const {
+  const SnapFunction& snap_function = options_.snap_function();
+  for (const S2Point& vertex : input_vertices_) {
+    if (snap_function.SnapPoint(vertex) != vertex) return false;
+  }
+  return true;
+}
+
 void S2Builder::ChooseAllVerticesAsSites() {
   // Sort the input vertices, discard duplicates, and use the result as the
   // list of sites.  (We sort in the same order used by ChooseInitialSites()
@@ -679,12 +797,39 @@ vector<S2Builder::InputVertexKey> S2Builder::SortInputVertices() {
        ++i) {
     keys.push_back(InputVertexKey(S2CellId(input_vertices_[i]), i));
   }
-  std::sort(keys.begin(), keys.end(),
-            [this](const InputVertexKey& a, const InputVertexKey& b) {
+  // Note that vertices with identical S2CellIds and coordinates are
+  // equivalent under this ordering, and all later phases treat such vertices
+  // identically, so the output does not depend on how ties are broken.  This
+  // allows the sort to be split into chunks (sorted on separate threads) that
+  // are then merged, without affecting the result.
+  const auto cmp = [this](const InputVertexKey& a, const InputVertexKey& b) {
       if (a.first < b.first) return true;
       if (b.first < a.first) return false;
       return input_vertices_[a.second] < input_vertices_[b.second];
-    });
+    };
+  constexpr size_t kMinVerticesPerThread = 1 << 14;
+  const size_t num_chunks = std::max<size_t>(
+      1, std::min<size_t>(options_.num_threads(),
+                          keys.size() / kMinVerticesPerThread));
+  if (num_chunks == 1) {
+    std::sort(keys.begin(), keys.end(), cmp);
+  } else {
+    const size_t n = keys.size();
+    vector<std::thread> threads;
+    threads.reserve(num_chunks);
+    for (size_t c = 0; c < num_chunks; ++c) {
+      threads.emplace_back([&keys, &cmp, n, num_chunks, c]() {
+        std::sort(keys.begin() + c * n / num_chunks,
+                  keys.begin() + (c + 1) * n / num_chunks, cmp);
+      });
+    }
+    for (auto& thread : threads) thread.join();
+    for (size_t c = 1; c < num_chunks; ++c) {
+      std::inplace_merge(keys.begin(),
+                         keys.begin() + c * n / num_chunks,
+                         keys.begin() + (c + 1) * n / num_chunks, cmp);
+    }
+  }
   return keys;
 }
 
@@ -812,6 +957,55 @@ S2Point S2Builder::SnapSite(const S2Point& point) const {
 // checks whether the input vertices and edges may already satisfy the output
 // criteria.  If any problems are found then snapping_needed_ is set to true.
 void S2Builder::CollectSiteEdges(const S2PointIndex<SiteId>& site_index) {
+  if (!tracker_.AddSpaceExact(&edge_sites_, input_edges_.size())) return;
+  edge_sites_.resize(input_edges_.size());  // Construct all elements.
+
+  // The edges are independent of each other, so when multiple threads are
+  // requested the work is split into contiguous chunks of edges that are
+  // processed concurrently.  (The site index is never modified here, so it
+  // can safely be queried from multiple threads.)  Each chunk only writes to
+  // its own elements of edge_sites_, so the result is the same as in the
+  // single-threaded case.
+  const size_t num_edges = input_edges_.size();
+  constexpr size_t kMinEdgesPerThread = 1 << 10;
+  const size_t num_chunks = std::max<size_t>(
+      1, std::min<size_t>(options_.num_threads(),
+                          num_edges / kMinEdgesPerThread));
+  if (num_chunks == 1) {
+    if (CollectSiteEdgeRange(site_index, 0, num_edges)) {
+      snapping_needed_ = true;
+    }
+  } else {
+    vector<char> chunk_snapping_needed(num_chunks, false);
+    vector<std::thread> threads;
+    threads.reserve(num_chunks);
+    for (size_t c = 0; c < num_chunks; ++c) {
+      threads.emplace_back(
+          [this, &site_index, &chunk_snapping_needed, num_edges, num_chunks,
+           c]() {
+            chunk_snapping_needed[c] = CollectSiteEdgeRange(
+                site_index, c * num_edges / num_chunks,
+                (c + 1) * num_edges / num_chunks);
+          });
+    }
+    for (auto& thread : threads) thread.join();
+    for (char chunk_result : chunk_snapping_needed) {
+      if (chunk_result) snapping_needed_ = true;
+    }
+  }
+  // The memory tracker is not thread-safe, so the tally is done afterwards.
+  for (const auto& sites : edge_sites_) {
+    if (!tracker_.TallyEdgeSites(sites)) return;
+  }
+}
+
+// Collects the candidate sites near the input edges [begin, end), populating
+// the corresponding elements of edge_sites_.  Returns true if any site was
+// found close enough to an edge that snapping is needed.  This method does
+// not modify any other member fields and may be called concurrently for
+// disjoint edge ranges.
+bool S2Builder::CollectSiteEdgeRange(const S2PointIndex<SiteId>& site_index,
+                                     InputEdgeId begin, InputEdgeId end) {
   // Find all points whose distance is <= edge_site_query_radius_ca_.
   //
   // Memory used by S2ClosestPointQuery is not tracked, but it is temporary,
@@ -820,9 +1014,11 @@ void S2Builder::CollectSiteEdges(const S2PointIndex<SiteId>& site_index) {
   options.set_conservative_max_distance(edge_site_query_radius_ca_);
   S2ClosestPointQuery<SiteId> site_query(&site_index, options);
   vector<S2ClosestPointQuery<SiteId>::Result> results;
-  if (!tracker_.AddSpaceExact(&edge_sites_, input_edges_.size())) return;
-  edge_sites_.resize(input_edges_.size());  // Construct all elements.
-  for (InputEdgeId e = 0; static_cast<size_t>(e) < input_edges_.size(); ++e) {
+  // Initializing this from snapping_needed_ (which is not modified until all
+  // chunks have finished) skips the separation tests below when snapping is
+  // already known to be necessary.
+  bool snapping_needed = snapping_needed_;
+  for (InputEdgeId e = begin; e < end; ++e) {
     const InputEdge& edge = input_edges_[e];
     const S2Point& v0 = input_vertices_[edge.first];
     const S2Point& v1 = input_vertices_[edge.second];
@@ -836,17 +1032,17 @@ void S2Builder::CollectSiteEdges(const S2PointIndex<SiteId>& site_index) {
     sites->reserve(results.size());
     for (const auto& result : results) {
       sites->push_back(result.data());
-      if (!snapping_needed_ &&
+      if (!snapping_needed &&
           result.distance() < min_edge_site_separation_ca_limit_ &&
           result.point() != v0 && result.point() != v1 &&
           s2pred::CompareEdgeDistance(result.point(), v0, v1,
                                       min_edge_site_separation_ca_) < 0) {
-        snapping_needed_ = true;
+        snapping_needed = true;
       }
     }
     SortSitesByDistance(v0, sites);
-    if (!tracker_.TallyEdgeSites(*sites)) return;
   }
+  return snapping_needed;
 }
 
 // Sorts the sites in increasing order of distance to X.
@@ -1397,28 +1593,64 @@ void S2Builder::AddSnappedEdges(
     vector<compact_array<InputVertexId>>* site_vertices) {
   bool discard_degenerate_edges = (options.degenerate_edges() ==
                                    GraphOptions::DegenerateEdges::DISCARD);
+  // When multiple threads are requested, the snapped site chains (which are
+  // computed independently for each edge) are precomputed in parallel over
+  // contiguous chunks of edges.  Assembling the output edges from the chains
+  // remains sequential, so the result is identical for any thread count.
+  vector<vector<SiteId>> chains;
+  constexpr int kMinEdgesPerThread = 1 << 12;
+  const int num_chunks = std::max(
+      1, std::min(options_.num_threads(), (end - begin) / kMinEdgesPerThread));
+  if (num_chunks > 1 && snapping_needed_) {
+    const int n = end - begin;
+    chains.resize(n);
+    vector<std::thread> threads;
+    threads.reserve(num_chunks);
+    for (int c = 0; c < num_chunks; ++c) {
+      threads.emplace_back([this, &chains, begin, n, num_chunks, c]() {
+        for (int i = c * n / num_chunks; i < (c + 1) * n / num_chunks; ++i) {
+          SnapEdge(begin + i, &chains[i]);
+        }
+      });
+    }
+    for (auto& thread : threads) thread.join();
+  }
   vector<SiteId> chain;
   for (InputEdgeId e = begin; e < end; ++e) {
     InputEdgeIdSetId id = input_edge_id_set_lexicon->AddSingleton(e);
-    SnapEdge(e, &chain);
+    if (chains.empty()) {
+      SnapEdge(e, &chain);
+    } else {
+      chain.swap(chains[e - begin]);
+    }
     if (chain.empty()) {
       continue;
     }
 
+    // Edges that were deduplicated at ingest time (see
+    // Options::deduplicate_edges) are expanded to their original
+    // multiplicity here so that the output layers are unaffected.
+    const int multiplicity = input_edge_multiplicities_.empty()
+                                 ? 1 : input_edge_multiplicities_[e];
     int num_snapped_edges = max<int>(1, chain.size() - 1);
     if (options.edge_type() == EdgeType::UNDIRECTED) num_snapped_edges *= 2;
+    num_snapped_edges *= multiplicity;
     if (!tracker_.AddSpace(edges, num_snapped_edges)) return;
     if (!tracker_.AddSpace(input_edge_ids, num_snapped_edges)) return;
     MaybeAddInputVertex(input_edges_[e].first, chain[0], site_vertices);
     if (chain.size() == 1) {
       if (discard_degenerate_edges) continue;
-      AddSnappedEdge(chain[0], chain[0], id, options.edge_type(),
-                     edges, input_edge_ids);
+      for (int copy = 0; copy < multiplicity; ++copy) {
+        AddSnappedEdge(chain[0], chain[0], id, options.edge_type(),
+                       edges, input_edge_ids);
+      }
     } else {
       MaybeAddInputVertex(input_edges_[e].second, chain.back(), site_vertices);
-      for (size_t i = 1; i < chain.size(); ++i) {
-        AddSnappedEdge(chain[i-1], chain[i], id, options.edge_type(),
-                       edges, input_edge_ids);
+      for (int copy = 0; copy < multiplicity; ++copy) {
+        for (size_t i = 1; i < chain.size(); ++i) {
+          AddSnappedEdge(chain[i-1], chain[i], id, options.edge_type(),
+                         edges, input_edge_ids);
+        }
       }
     }
   }
@@ -29,6 +29,7 @@
 #include <vector>
 
 #include "absl/base/macros.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
@@ -44,6 +45,7 @@
 #include "s2/s2error.h"
 #include "s2/s2memory_tracker.h"
 #include "s2/s2point.h"
+#include "s2/s2point_fingerprint.h"
 #include "s2/s2point_index.h"
 #include "s2/s2point_span.h"
 #include "s2/s2shape.h"
@@ -442,6 +444,51 @@ class S2Builder {
     bool idempotent() const;
     void set_idempotent(bool idempotent);
 
+    // If true, then idempotency (see above) is verified using a much cheaper
+    // test: when every input vertex is already at a snap location (i.e.,
+    // SnapPoint() maps it to itself), the input is passed through to the
+    // output layers directly, without building the internal index of
+    // candidate sites that is normally used to verify the separation
+    // criteria.  This makes no-op builds substantially cheaper.
+    //
+    // The separation criteria are *assumed* rather than verified, so this
+    // option is only appropriate when the input is known to satisfy them
+    // already (e.g., because it is the output of a previous S2Builder
+    // invocation that used the same snap function).  Otherwise the output
+    // may violate the min_vertex_separation() and min_edge_vertex_separation()
+    // guarantees.  Note that if some input vertex is not at a snap location
+    // (or if crossing edges are found when split_crossing_edges() is true)
+    // then S2Builder falls back to the normal snapping path, so the output is
+    // still correct in that case.
+    //
+    // This option has no effect unless idempotent() is true.
+    //
+    // DEFAULT: false
+    bool assume_input_snapped() const;
+    void set_assume_input_snapped(bool assume_input_snapped);
+
+    // If true, then exact duplicate input edges (those with identical
+    // endpoints and identical labels) are merged as they are added, rather
+    // than all being kept in memory until graph processing sorts them out.
+    // Each merged edge remembers its multiplicity, so the output layers see
+    // the same number of edge copies as without this option.  The
+    // observable differences are that all copies of a duplicate edge share
+    // a single InputEdgeId (and therefore a single label set entry), and
+    // that the copies reach the layers consecutively rather than in their
+    // original positions, which can affect the output order of layer types
+    // sensitive to input edge ordering (e.g. S2PolylineVectorLayer when
+    // duplicate edges are kept).  Input vertices are also deduplicated
+    // exactly in this mode so that duplicate edges can be detected by
+    // comparing vertex ids.
+    //
+    // This reduces peak memory usage substantially when the input contains
+    // many duplicate edges, at the cost of a hash lookup per input vertex
+    // and edge.
+    //
+    // DEFAULT: false
+    bool deduplicate_edges() const;
+    void set_deduplicate_edges(bool deduplicate_edges);
+
     // Specifies that internal memory usage should be tracked using the given
     // S2MemoryTracker.  If a memory limit is specified and more more memory
     // than this is required then an error will be returned.  Example usage:
@@ -471,6 +518,18 @@ class S2Builder {
     S2MemoryTracker* memory_tracker() const;
     void set_memory_tracker(S2MemoryTracker* tracker);
 
+    // Specifies the number of threads used by the most expensive snapping
+    // phases (sorting the input vertices, collecting the candidate sites
+    // near each input edge, and snapping the edges of each output layer).
+    // These phases parallelize over contiguous chunks of the input, so the
+    // output is guaranteed to be identical regardless of this setting.  The
+    // remaining phases, such as selecting the Voronoi sites and simplifying
+    // edge chains, are inherently sequential and always run on one thread.
+    //
+    // DEFAULT: 1 (all phases are single-threaded)
+    int num_threads() const;
+    void set_num_threads(int num_threads);
+
     // Options may be assigned and copied.
     Options(const Options& options);
     Options& operator=(const Options& options);
@@ -481,7 +540,10 @@ class S2Builder {
     S1Angle intersection_tolerance_ = S1Angle::Zero();
     bool simplify_edge_chains_ = false;
     bool idempotent_ = true;
+    bool assume_input_snapped_ = false;
+    bool deduplicate_edges_ = false;
     S2MemoryTracker* memory_tracker_ = nullptr;
+    int num_threads_ = 1;
   };
 
   class Graph;
@@ -563,6 +625,12 @@ class S2Builder {
   void AddPolyline(S2PointSpan polyline);
   void AddPolyline(const S2Polyline& polyline);
 
+  // Like the above, but takes ownership of the given vertex buffer.  If no
+  // vertices have been added to the builder yet, the buffer is adopted as
+  // the builder's input vertex storage rather than copied, which roughly
+  // halves the peak memory usage when building from one large polyline.
+  void AddPolyline(std::vector<S2Point>&& polyline);
+
   // Adds the edges in the given loop to the current layer.  Note that a loop
   // consisting of one vertex adds a single degenerate edge.
   //
@@ -572,6 +640,11 @@ class S2Builder {
   void AddLoop(S2PointLoopSpan loop);
   void AddLoop(const S2Loop& loop);
 
+  // Like AddLoop(S2PointLoopSpan), but takes ownership of the given vertex
+  // buffer, adopting it as the builder's input vertex storage when possible
+  // (see AddPolyline(std::vector<S2Point>&&) above).
+  void AddLoop(std::vector<S2Point>&& loop);
+
   // Adds the loops in the given polygon to the current layer.  Loops
   // representing holes have their edge directions automatically reversed as
   // described for AddLoop().  Note that this method does not distinguish
@@ -822,7 +895,9 @@ class S2Builder {
   };
 
   InputVertexId AddVertex(const S2Point& v);
+  void AddEdgeInternal(InputVertexId j0, InputVertexId j1);
   void ChooseSites();
+  bool InputVerticesAreSnapped() const;
   void ChooseAllVerticesAsSites();
   std::vector<InputVertexKey> SortInputVertices();
   void AddEdgeCrossings(const MutableS2ShapeIndex& input_edge_index);
@@ -831,6 +906,8 @@ class S2Builder {
   void ChooseInitialSites(S2PointIndex<SiteId>* site_index);
   S2Point SnapSite(const S2Point& point) const;
   void CollectSiteEdges(const S2PointIndex<SiteId>& site_index);
+  bool CollectSiteEdgeRange(const S2PointIndex<SiteId>& site_index,
+                            InputEdgeId begin, InputEdgeId end);
   void SortSitesByDistance(const S2Point& x,
                            gtl::compact_array<SiteId>* sites) const;
   void InsertSiteByDistance(SiteId new_site_id, const S2Point& x,
@@ -960,6 +1037,22 @@ class S2Builder {
   // (by adding it to label_set_lexicon()).
   LabelSetId label_set_id_;
 
+  // When Options::deduplicate_edges() is true, these map each distinct input
+  // vertex to its id, and each distinct (edge, label set) combination of the
+  // current layer to its input edge id.  The edge map is cleared by
+  // StartLayer() since each layer covers a contiguous input edge range.  The
+  // vertex map hashes by platform-stable fingerprint so that the dedup result
+  // does not depend on the per-process hash seed.
+  absl::flat_hash_map<S2Point, InputVertexId, S2PointFingerprintHash>
+      vertex_id_map_;
+  absl::flat_hash_map<std::pair<InputEdge, LabelSetId>, InputEdgeId>
+      edge_id_map_;
+
+  // The number of copies of each input edge.  This vector is populated only
+  // if deduplicate_edges() is true and at least one duplicate edge has been
+  // merged.
+  std::vector<int32> input_edge_multiplicities_;
+
   ////////////// Data for Snapping and Simplifying //////////////
 
   // The number of sites specified using ForceVertex().  These sites are
@@ -1243,6 +1336,24 @@ inline void S2Builder::Options::set_idempotent(bool idempotent) {
   idempotent_ = idempotent;
 }
 
+inline bool S2Builder::Options::assume_input_snapped() const {
+  return assume_input_snapped_;
+}
+
+inline void S2Builder::Options::set_assume_input_snapped(
+    bool assume_input_snapped) {
+  assume_input_snapped_ = assume_input_snapped;
+}
+
+inline bool S2Builder::Options::deduplicate_edges() const {
+  return deduplicate_edges_;
+}
+
+inline void S2Builder::Options::set_deduplicate_edges(
+    bool deduplicate_edges) {
+  deduplicate_edges_ = deduplicate_edges;
+}
+
 inline S2MemoryTracker* S2Builder::Options::memory_tracker() const {
   return memory_tracker_;
 }
@@ -1252,6 +1363,15 @@ inline void S2Builder::Options::set_memory_tracker(
   memory_tracker_ = tracker;
 }
 
+inline int S2Builder::Options::num_threads() const {
+  return num_threads_;
+}
+
+inline void S2Builder::Options::set_num_threads(int num_threads) {
+  ABSL_DCHECK_GE(num_threads, 1);
+  num_threads_ = num_threads;
+}
+
 inline S2Builder::GraphOptions::EdgeType
 S2Builder::GraphOptions::edge_type() const {
   return edge_type_;
@@ -21,12 +21,14 @@
 #include <array>
 #include <limits>
 #include <numeric>
+#include <thread>
 #include <utility>
 #include <vector>
 
 #include "s2/base/types.h"
 #include "absl/container/btree_map.h"
 #include "absl/log/absl_check.h"
+#include "absl/types/span.h"
 #include "s2/id_set_lexicon.h"
 #include "s2/s2builder.h"
 #include "s2/s2error.h"
@@ -74,6 +76,49 @@ vector<Graph::EdgeId> Graph::GetInEdgeIds() const {
   return in_edge_ids;
 }
 
+vector<Graph::EdgeId> Graph::GetInEdgeIds(int num_threads) const {
+  // Sorting is not worth threading unless each thread gets a large block.
+  static constexpr int kMinEdgesPerThread = 1 << 16;
+  num_threads = std::min(num_threads, num_edges() / kMinEdgesPerThread);
+  if (num_threads <= 1) return GetInEdgeIds();
+
+  vector<EdgeId> in_edge_ids(num_edges());
+  std::iota(in_edge_ids.begin(), in_edge_ids.end(), 0);
+  auto less = [this](EdgeId ai, EdgeId bi) {
+    return StableLessThan(reverse(edge(ai)), reverse(edge(bi)), ai, bi);
+  };
+  // Sort "num_threads" blocks in parallel, then merge them.  The comparator
+  // breaks ties by edge id, so the final order is unique and identical to
+  // the single-threaded result.
+  const size_t n = in_edge_ids.size();
+  vector<size_t> bounds(num_threads + 1);
+  for (int t = 0; t <= num_threads; ++t) bounds[t] = t * n / num_threads;
+  vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      std::sort(in_edge_ids.begin() + bounds[t],
+                in_edge_ids.begin() + bounds[t + 1], less);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  for (int t = 2; t <= num_threads; ++t) {
+    std::inplace_merge(in_edge_ids.begin(),
+                       in_edge_ids.begin() + bounds[t - 1],
+                       in_edge_ids.begin() + bounds[t], less);
+  }
+  return in_edge_ids;
+}
+
+vector<Graph::EdgeId> Graph::GetSiblingMap(int num_threads) const {
+  vector<EdgeId> in_edge_ids = GetInEdgeIds(num_threads);
+  MakeSiblingMap(&in_edge_ids);
+  for (EdgeId e = 0; e < num_edges(); ++e) {
+    ABSL_DCHECK(e == in_edge_ids[in_edge_ids[e]]);
+  }
+  return in_edge_ids;
+}
+
 vector<Graph::EdgeId> Graph::GetSiblingMap() const {
   vector<EdgeId> in_edge_ids = GetInEdgeIds();
   MakeSiblingMap(&in_edge_ids);
@@ -864,8 +909,14 @@ class Graph::EdgeProcessor {
   vector<Edge>& edges_;
   vector<InputEdgeIdSetId>& input_ids_;
   IdSetLexicon* id_set_lexicon_;
-  vector<EdgeId> out_edges_;
-  vector<EdgeId> in_edges_;
+
+  // A single allocation holding both sorted edge id arrays; "out_edges_" and
+  // "in_edges_" are views of its first and second halves.  Multi-layer
+  // builds call ProcessEdges() once per layer, so combining the two arrays
+  // halves the number of temporary allocations made per layer.
+  vector<EdgeId> edge_id_storage_;
+  absl::Span<EdgeId> out_edges_;
+  absl::Span<EdgeId> in_edges_;
 
   vector<Edge> new_edges_;
   vector<InputEdgeIdSetId> new_input_ids_;
@@ -877,14 +928,14 @@ void Graph::ProcessEdges(GraphOptions* options, vector<Edge>* edges,
                          vector<InputEdgeIdSetId>* input_ids,
                          IdSetLexicon* id_set_lexicon, S2Error* error,
                          S2MemoryTracker::Client* tracker) {
-  // Graph::EdgeProcessor uses 8 bytes per input edge (out_edges_ and
-  // in_edges_) plus 12 bytes per output edge (new_edges_, new_input_ids_).
+  // Graph::EdgeProcessor uses 8 bytes per input edge (edge_id_storage_,
+  // which holds both the outgoing and incoming edge id orderings) plus 12
+  // bytes per output edge (new_edges_, new_input_ids_).
   // For simplicity we assume that num_input_edges == num_output_edges, since
   // Graph:EdgeProcessor does not increase the number of edges except possibly
   // in the case of SiblingPairs::CREATE (which we ignore).
   //
-  //  vector<EdgeId> out_edges_;                 // Graph::EdgeProcessor
-  //  vector<EdgeId> in_edges_;                  // Graph::EdgeProcessor
+  //  vector<EdgeId> edge_id_storage_;           // Graph::EdgeProcessor
   //  vector<Edge> new_edges_;                   // Graph::EdgeProcessor
   //  vector<InputEdgeIdSetId> new_input_ids_;   // Graph::EdgeProcessor
   //
@@ -918,18 +969,37 @@ Graph::EdgeProcessor::EdgeProcessor(const GraphOptions& options,
                                     IdSetLexicon* id_set_lexicon)
     : options_(options), edges_(*edges),
       input_ids_(*input_ids), id_set_lexicon_(id_set_lexicon),
-      out_edges_(edges_.size()), in_edges_(edges_.size()) {
+      edge_id_storage_(2 * edges_.size()) {
+  out_edges_ = absl::MakeSpan(edge_id_storage_).first(edges_.size());
+  in_edges_ = absl::MakeSpan(edge_id_storage_).subspan(edges_.size());
+
   // Sort the outgoing and incoming edges in lexigraphic order.  We use a
   // stable sort to ensure that each undirected edge becomes a sibling pair,
-  // even if there are multiple identical input edges.
+  // even if there are multiple identical input edges.  The two sort orders
+  // are computed independently, so for large graphs we sort them
+  // concurrently (see also GetInEdgeIds).
   std::iota(out_edges_.begin(), out_edges_.end(), 0);
-  std::sort(out_edges_.begin(), out_edges_.end(), [this](EdgeId a, EdgeId b) {
-      return StableLessThan(edges_[a], edges_[b], a, b);
-    });
   std::iota(in_edges_.begin(), in_edges_.end(), 0);
-  std::sort(in_edges_.begin(), in_edges_.end(), [this](EdgeId a, EdgeId b) {
-      return StableLessThan(reverse(edges_[a]), reverse(edges_[b]), a, b);
-    });
+  auto sort_out_edges = [this]() {
+    std::sort(out_edges_.begin(), out_edges_.end(),
+              [this](EdgeId a, EdgeId b) {
+        return StableLessThan(edges_[a], edges_[b], a, b);
+      });
+  };
+  auto sort_in_edges = [this]() {
+    std::sort(in_edges_.begin(), in_edges_.end(), [this](EdgeId a, EdgeId b) {
+        return StableLessThan(reverse(edges_[a]), reverse(edges_[b]), a, b);
+      });
+  };
+  static constexpr size_t kMinEdgesPerThread = 1 << 16;
+  if (edges_.size() >= kMinEdgesPerThread) {
+    std::thread sorter(sort_out_edges);
+    sort_in_edges();
+    sorter.join();
+  } else {
+    sort_out_edges();
+    sort_in_edges();
+  }
   new_edges_.reserve(edges_.size());
   new_input_ids_.reserve(edges_.size());
 }
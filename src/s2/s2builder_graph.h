@@ -146,6 +146,13 @@ class S2Builder::Graph {
   // contiguous subrange of this ordering.
   std::vector<EdgeId> GetInEdgeIds() const;
 
+  // Like GetInEdgeIds(), but sorts using up to "num_threads" threads.  The
+  // result is identical to the single-threaded version (the edge ordering
+  // breaks ties by edge id, so the sorted order is unique).  This is useful
+  // for very large graphs, where this sort can dominate the post-snapping
+  // phases of S2Builder layers.
+  std::vector<EdgeId> GetInEdgeIds(int num_threads) const;
+
   // Given a graph such that every directed edge has a sibling, returns a map
   // from EdgeId to the sibling EdgeId.  This method is identical to
   // GetInEdgeIds() except that (1) it requires edges to have siblings, and
@@ -159,6 +166,10 @@ class S2Builder::Graph {
   //      options.edge_type() == UNDIRECTED)
   std::vector<EdgeId> GetSiblingMap() const;
 
+  // Like GetSiblingMap(), but sorts the incoming edge ids using up to
+  // "num_threads" threads (see GetInEdgeIds above).
+  std::vector<EdgeId> GetSiblingMap(int num_threads) const;
+
   // Like GetSiblingMap(), but constructs the map starting from the vector of
   // incoming edge ids returned by GetInEdgeIds().  (This operation is a no-op
   // unless undirected degenerate edges are present, in which case such edges
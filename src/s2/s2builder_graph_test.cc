@@ -20,6 +20,7 @@
 
 #include "s2/s2builder_graph.h"
 
+#include <algorithm>
 #include <array>
 #include <memory>
 #include <ostream>
@@ -34,6 +35,7 @@
 #include "s2/s2error.h"
 #include "s2/s2lax_polyline_shape.h"
 #include "s2/s2point.h"
+#include "s2/s2testing.h"
 #include "s2/s2text_format.h"
 
 using s2builderutil::GraphClone;
@@ -86,6 +88,30 @@ TEST(Graph, LabelsRequestedButNotProvided) {
   EXPECT_TRUE(labels.empty());
 }
 
+TEST(Graph, GetInEdgeIdsMultiThreadedMatchesSerial) {
+  // Builds a graph large enough to exercise the parallel sort path and
+  // verifies that the result is identical to the single-threaded version.
+  GraphOptions options(EdgeType::DIRECTED, DegenerateEdges::KEEP,
+                       DuplicateEdges::KEEP, SiblingPairs::KEEP);
+  const int kNumVertices = 1000;
+  const int kNumEdges = 1 << 18;
+  vector<S2Point> vertices(kNumVertices, S2Point(1, 0, 0));
+  vector<Edge> edges;
+  edges.reserve(kNumEdges);
+  for (int i = 0; i < kNumEdges; ++i) {
+    edges.push_back({S2Testing::rnd.Uniform(kNumVertices),
+                     S2Testing::rnd.Uniform(kNumVertices)});
+  }
+  std::sort(edges.begin(), edges.end());
+  vector<InputEdgeIdSetId> input_edge_id_set_ids(kNumEdges, 0);
+  IdSetLexicon input_edge_id_set_lexicon, label_set_lexicon;
+  vector<LabelSetId> label_set_ids;
+  Graph g{
+    options, &vertices, &edges, &input_edge_id_set_ids,
+    &input_edge_id_set_lexicon, &label_set_ids, &label_set_lexicon, nullptr};
+  EXPECT_EQ(g.GetInEdgeIds(), g.GetInEdgeIds(4));
+}
+
 TEST(GetDirectedLoops, DegenerateEdges) {
   GraphClone gc;
   S2Builder builder{S2Builder::Options()};
@@ -66,6 +66,7 @@
 #include "s2/s2loop.h"
 #include "s2/s2memory_tracker.h"
 #include "s2/s2point.h"
+#include "s2/s2pointutil.h"
 #include "s2/s2polygon.h"
 #include "s2/s2polyline.h"
 #include "s2/s2predicates.h"
@@ -456,6 +457,35 @@ TEST(S2Builder, IdempotencyDoesNotSnapAdequatelySeparatedEdges) {
   EXPECT_EQ(expected, s2textformat::ToString(output2));
 }
 
+TEST(S2Builder, AssumeInputSnappedPassesSnappedInputThrough) {
+  // When assume_input_snapped() is true and every input vertex is already at
+  // a snap location, the input should be passed through unmodified (without
+  // verifying the separation criteria).
+  S2Builder::Options options(IntLatLngSnapFunction(0));
+  options.set_assume_input_snapped(true);
+  S2Builder builder(options);
+  S2Polyline output;
+  builder.StartLayer(make_unique<S2PolylineLayer>(&output));
+  builder.AddPolyline(*MakePolylineOrDie("0:0, 0:2, 1:3"));
+  S2Error error;
+  ASSERT_TRUE(builder.Build(&error)) << error;
+  EXPECT_EQ("0:0, 0:2, 1:3", s2textformat::ToString(output));
+}
+
+TEST(S2Builder, AssumeInputSnappedStillSnapsUnsnappedVertices) {
+  // When assume_input_snapped() is true but some input vertex is not at a
+  // snap location, S2Builder must fall back to the normal snapping path.
+  S2Builder::Options options(IntLatLngSnapFunction(0));
+  options.set_assume_input_snapped(true);
+  S2Builder builder(options);
+  S2Polyline output;
+  builder.StartLayer(make_unique<S2PolylineLayer>(&output));
+  builder.AddPolyline(*MakePolylineOrDie("0:0, 0.1:2.1, 1:3"));
+  S2Error error;
+  ASSERT_TRUE(builder.Build(&error)) << error;
+  EXPECT_EQ("0:0, 0:2, 1:3", s2textformat::ToString(output));
+}
+
 TEST(S2Builder, NearbyVerticesSnappedWithZeroSnapRadiusEdgeSplitting) {
   // Verify that even when the split_crossing_edges() option is used with a snap
   // radius of zero, edges are snapped to nearby vertices (those within a
@@ -709,6 +739,79 @@ TEST(S2Builder, SelfIntersectingPolygon) {
   ExpectPolygonsEqual(*expected, output);
 }
 
+TEST(S2Builder, AddPolylineMovedVertexBuffer) {
+  // The move-in overload adopts the caller's buffer when the builder is
+  // empty and falls back to copying otherwise; both cases must produce the
+  // same output as the span-based overload.
+  vector<S2Point> vertices = S2Testing::MakeRegularPoints(
+      S2LatLng::FromDegrees(10, 10).ToPoint(), S1Angle::Degrees(1), 20);
+  S2Builder builder{S2Builder::Options(IntLatLngSnapFunction(3))};
+  S2Polyline output1, output2, expected;
+  builder.StartLayer(make_unique<S2PolylineLayer>(&expected));
+  builder.AddPolyline(S2PointSpan(vertices));
+  S2Error error;
+  ASSERT_TRUE(builder.Build(&error)) << error;
+
+  builder.StartLayer(make_unique<S2PolylineLayer>(&output1));
+  builder.AddPolyline(vector<S2Point>(vertices));  // Adopted.
+  ASSERT_TRUE(builder.Build(&error)) << error;
+  ExpectPolylinesEqual(expected, output1);
+
+  // When the builder already has input vertices (here from a preceding
+  // layer), the buffer cannot be adopted and is copied instead.
+  S2Polyline dummy;
+  builder.StartLayer(make_unique<S2PolylineLayer>(&dummy));
+  builder.AddEdge(S2LatLng::FromDegrees(20, 20).ToPoint(),
+                  S2LatLng::FromDegrees(20, 21).ToPoint());
+  builder.StartLayer(make_unique<S2PolylineLayer>(&output2));
+  builder.AddPolyline(vector<S2Point>(vertices));  // Copied.
+  ASSERT_TRUE(builder.Build(&error)) << error;
+  ExpectPolylinesEqual(expected, output2);
+}
+
+TEST(S2Builder, AddLoopMovedVertexBuffer) {
+  vector<S2Point> vertices = S2Testing::MakeRegularPoints(
+      S2LatLng::FromDegrees(10, 10).ToPoint(), S1Angle::Degrees(1), 20);
+  S2Builder builder{S2Builder::Options(IntLatLngSnapFunction(3))};
+  S2Polygon output, expected;
+  builder.StartLayer(make_unique<S2PolygonLayer>(&expected));
+  builder.AddLoop(S2PointLoopSpan(vertices));
+  S2Error error;
+  ASSERT_TRUE(builder.Build(&error)) << error;
+
+  builder.StartLayer(make_unique<S2PolygonLayer>(&output));
+  builder.AddLoop(vector<S2Point>(vertices));  // Adopted.
+  ASSERT_TRUE(builder.Build(&error)) << error;
+  ExpectPolygonsEqual(expected, output);
+}
+
+TEST(S2Builder, MultiThreadedOutputMatchesSingleThreaded) {
+  // Verifies that the parallelized snapping phases produce output identical
+  // to the single-threaded implementation.  The input is made large enough
+  // to exceed the per-thread minimums of the parallelized phases.
+  S2Fractal fractal;
+  fractal.SetLevelForApproxMaxEdges(10000);
+  unique_ptr<S2Loop> input = fractal.MakeLoop(
+      S2::GetFrame(S2LatLng::FromDegrees(10, 10).ToPoint()),
+      S1Angle::Degrees(5));
+  S2Polygon expected;
+  for (int num_threads : {1, 4}) {
+    S2Builder::Options options{IntLatLngSnapFunction(5)};
+    options.set_num_threads(num_threads);
+    S2Builder builder(options);
+    S2Polygon output;
+    builder.StartLayer(make_unique<S2PolygonLayer>(&output));
+    builder.AddLoop(*input);
+    S2Error error;
+    ASSERT_TRUE(builder.Build(&error)) << error;
+    if (num_threads == 1) {
+      expected.Copy(output);
+    } else {
+      ExpectPolygonsEqual(expected, output);
+    }
+  }
+}
+
 TEST(S2Builder, TieBreakingIsConsistent) {
   // Check that when an edge passes between two equally distant vertices, that
   // the choice of which one to snap to does not depend on the edge direction.
@@ -846,6 +949,104 @@ void TestPolylineLayersBothEdgeTypes(
   TestPolylineLayers(input_strs, expected_strs, layer_options, builder_options);
 }
 
+TEST(S2Builder, DeduplicateEdgesPreservesMultiplicity) {
+  // With ingest-time deduplication enabled (see Options::deduplicate_edges),
+  // exact duplicate edges are merged as they arrive but their multiplicity
+  // is preserved, so the output must match the default path for both the
+  // KEEP and MERGE duplicate edge policies.  The outputs are compared as
+  // sorted sets because deduplication changes the relative order in which
+  // duplicate copies reach the layers (see the option documentation).
+  const vector<string_view> input = {
+      "0:0, 0:5, 5:5", "0:0, 0:5, 5:5", "0:0, 0:5, 5:5", "2:2, 3:3"};
+  for (auto duplicate_edges : {GraphOptions::DuplicateEdges::KEEP,
+                               GraphOptions::DuplicateEdges::MERGE}) {
+    S2PolylineVectorLayer::Options layer_options;
+    layer_options.set_duplicate_edges(duplicate_edges);
+    vector<vector<string>> outputs;
+    for (bool deduplicate : {false, true}) {
+      S2Builder::Options options{IntLatLngSnapFunction(0)};  // E0 coords
+      options.set_deduplicate_edges(deduplicate);
+      S2Builder builder(options);
+      vector<unique_ptr<S2Polyline>> output;
+      builder.StartLayer(
+          make_unique<S2PolylineVectorLayer>(&output, layer_options));
+      for (auto input_str : input) {
+        builder.AddPolyline(*MakePolylineOrDie(input_str));
+      }
+      S2Error error;
+      ASSERT_TRUE(builder.Build(&error)) << error;
+      vector<string> output_strs;
+      for (const auto& polyline : output) {
+        output_strs.push_back(s2textformat::ToString(*polyline));
+      }
+      std::sort(output_strs.begin(), output_strs.end());
+      outputs.push_back(std::move(output_strs));
+    }
+    EXPECT_EQ(outputs[0], outputs[1]);
+    int expected_size =
+        (duplicate_edges == GraphOptions::DuplicateEdges::MERGE) ? 2 : 7;
+    EXPECT_EQ(expected_size, outputs[0].size());
+  }
+}
+
+TEST(S2Builder, DeduplicateEdgesKeepsDistinctLabels) {
+  // Edges with identical endpoints but different labels must not be merged
+  // by ingest-time deduplication.
+  S2Builder::Options options{IntLatLngSnapFunction(0)};
+  options.set_deduplicate_edges(true);
+  S2Builder builder(options);
+  vector<unique_ptr<S2Polyline>> output;
+  S2PolylineVectorLayer::LabelSetIds label_set_ids;
+  IdSetLexicon label_set_lexicon;
+  S2PolylineVectorLayer::Options layer_options;
+  layer_options.set_duplicate_edges(GraphOptions::DuplicateEdges::MERGE);
+  builder.StartLayer(make_unique<S2PolylineVectorLayer>(
+      &output, &label_set_ids, &label_set_lexicon, layer_options));
+  builder.set_label(1);
+  builder.AddPolyline(*MakePolylineOrDie("0:0, 0:1"));
+  builder.set_label(2);
+  builder.AddPolyline(*MakePolylineOrDie("0:0, 0:1"));
+  S2Error error;
+  ASSERT_TRUE(builder.Build(&error)) << error;
+  // The two copies have different labels, so they are kept as distinct input
+  // edges and the merged output edge carries both labels.
+  ASSERT_EQ(1, output.size());
+  ASSERT_EQ(1, label_set_ids.size());
+  ASSERT_EQ(1, label_set_ids[0].size());
+  vector<int32> labels;
+  for (int32 label : label_set_lexicon.id_set(label_set_ids[0][0])) {
+    labels.push_back(label);
+  }
+  EXPECT_EQ(vector<int32>({1, 2}), labels);
+}
+
+TEST(S2Builder, LabelsSetBeforeFirstEdge) {
+  // A label set created before the first edge is added must be attached to
+  // that edge (and subsequent ones), even though no earlier entries exist
+  // to backfill.
+  S2Builder builder{S2Builder::Options()};
+  vector<unique_ptr<S2Polyline>> output;
+  S2PolylineVectorLayer::LabelSetIds label_set_ids;
+  IdSetLexicon label_set_lexicon;
+  builder.StartLayer(make_unique<S2PolylineVectorLayer>(
+      &output, &label_set_ids, &label_set_lexicon,
+      S2PolylineVectorLayer::Options()));
+  builder.set_label(5);
+  builder.AddPolyline(*MakePolylineOrDie("0:0, 0:1, 0:2"));
+  S2Error error;
+  ASSERT_TRUE(builder.Build(&error)) << error;
+  ASSERT_EQ(1, output.size());
+  ASSERT_EQ(1, label_set_ids.size());
+  ASSERT_EQ(2, label_set_ids[0].size());
+  for (int32 label_set_id : label_set_ids[0]) {
+    vector<int32> labels;
+    for (int32 label : label_set_lexicon.id_set(label_set_id)) {
+      labels.push_back(label);
+    }
+    EXPECT_EQ(vector<int32>({5}), labels);
+  }
+}
+
 TEST(S2Builder, SimplifyOneEdge) {
   // Simplify a perturbed edge chain into a single edge.
 
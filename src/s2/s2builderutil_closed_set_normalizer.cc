@@ -29,6 +29,7 @@
 #include "s2/s2builder_layer.h"
 #include "s2/s2builderutil_find_polygon_degeneracies.h"
 #include "s2/s2error.h"
+#include "s2/s2executor.h"
 
 using std::make_unique;
 using std::shared_ptr;
@@ -84,19 +85,34 @@ const vector<Graph>& ClosedSetNormalizer::Run(
   for (int dim = 0; dim < 3; ++dim) {
     ABSL_DCHECK(g[dim].options() == graph_options_in_[dim]);
   }
-  if (options_.suppress_lower_dimensions()) {
-    // Build the auxiliary data needed to suppress lower-dimensional edges.
-    in_edges2_ = g[2].GetInEdgeIds();
-    is_suppressed_.resize(g[0].vertices().size());
-    for (int dim = 1; dim <= 2; ++dim) {
-      for (int e = 0; e < g[dim].num_edges(); ++e) {
-        Edge edge = g[dim].edge(e);
-        if (edge.first != edge.second) {
-          is_suppressed_[edge.first] = true;
-          is_suppressed_[edge.second] = true;
-        }
+  // Reset the scratch state of any previous invocation, retaining the
+  // allocated capacity so that repeated calls avoid most allocation.
+  new_graphs_.clear();
+  for (int dim = 0; dim < 3; ++dim) {
+    new_edges_[dim].clear();
+    new_input_edge_ids_[dim].clear();
+  }
+  in_edges2_.clear();
+  is_suppressed_.clear();
+
+  // The polygon degeneracy analysis and the construction of the auxiliary
+  // edge-suppression tables are independent preprocessing passes, so when
+  // multiple threads were requested they are overlapped.
+  if (options_.num_threads() > 1 && options_.suppress_lower_dimensions()) {
+    S2Error degeneracy_error;
+    S2Executor* executor =
+        options_.executor() ? options_.executor() : S2Executor::Default();
+    executor->Run(2, [&](int i) {
+      if (i == 0) {
+        degeneracies_ = FindPolygonDegeneracies(g[2], &degeneracy_error);
+      } else {
+        BuildSuppressionData(g);
       }
-    }
+    });
+    if (!degeneracy_error.ok()) *error = degeneracy_error;
+  } else {
+    degeneracies_ = FindPolygonDegeneracies(g[2], error);
+    if (options_.suppress_lower_dimensions()) BuildSuppressionData(g);
   }
 
   // Compute the edges that belong in the output graphs.
@@ -160,16 +176,30 @@ inline Edge ClosedSetNormalizer::AdvanceIncoming(
               : Graph::reverse(g.edge(in_edges[*i])));
   }
 
+// Builds the auxiliary data needed to suppress lower-dimensional edges.
+void ClosedSetNormalizer::BuildSuppressionData(const vector<Graph>& g) {
+  in_edges2_ = g[2].GetInEdgeIds();
+  is_suppressed_.assign(g[0].vertices().size(), false);
+  for (int dim = 1; dim <= 2; ++dim) {
+    for (int e = 0; e < g[dim].num_edges(); ++e) {
+      Edge edge = g[dim].edge(e);
+      if (edge.first != edge.second) {
+        is_suppressed_[edge.first] = true;
+        is_suppressed_[edge.second] = true;
+      }
+    }
+  }
+}
+
 void ClosedSetNormalizer::NormalizeEdges(const vector<Graph>& g,
                                          S2Error* error) {
-  // Find the degenerate polygon edges and sibling pairs, and classify each
-  // edge as belonging to either a shell or a hole.
-  auto degeneracies = FindPolygonDegeneracies(g[2], error);
-  auto degeneracy = degeneracies.begin();
+  // The degenerate polygon edges and sibling pairs were found by Run(),
+  // with each edge classified as belonging to either a shell or a hole.
+  auto degeneracy = degeneracies_.begin();
 
   // Walk through the three edge vectors performing a merge join.  We also
   // maintain positions in two other auxiliary vectors: the vector of sorted
-  // polygon degeneracies (degeneracies), and the vector of incoming polygon
+  // polygon degeneracies (degeneracies_), and the vector of incoming polygon
   // edges (if we are suppressing lower-dimensional duplicate edges).
   EdgeId e0 = -1, e1 = -1, e2 = -1;  // Current position in g[dim].edges()
   int in_e2 = -1;  // Current position in in_edges2_
@@ -180,7 +210,7 @@ void ClosedSetNormalizer::NormalizeEdges(const vector<Graph>& g,
   for (;;) {
     if (edge2 <= edge1 && edge2 <= edge0) {
       if (edge2 == sentinel_) break;
-      if (degeneracy == degeneracies.end() || degeneracy->edge_id != e2) {
+      if (degeneracy == degeneracies_.end() || degeneracy->edge_id != e2) {
         // Normal polygon edge (not part of a degeneracy).
         AddEdge(2, g[2], e2);
         while (options_.suppress_lower_dimensions() && edge1 == edge2) {
@@ -26,6 +26,7 @@
 #include "s2/s2builder_graph.h"
 #include "s2/s2builderutil_find_polygon_degeneracies.h"
 #include "s2/s2error.h"
+#include "s2/s2executor.h"
 
 namespace s2builderutil {
 
@@ -94,8 +95,29 @@ class ClosedSetNormalizer {
     bool suppress_lower_dimensions() const;
     void set_suppress_lower_dimensions(bool suppress_lower_dimensions);
 
+    // Specifies the number of threads used by Run().  When more than one
+    // thread is requested, the polygon degeneracy analysis runs concurrently
+    // with the construction of the edge-suppression tables (the two
+    // preprocessing passes that dominate the cost of normalization).  The
+    // results are identical regardless of this setting.
+    //
+    // DEFAULT: 1 (all work is done on the calling thread).
+    int num_threads() const;
+    void set_num_threads(int num_threads);
+
+    // The executor used to run the threads requested by set_num_threads().
+    // This allows clients with their own scheduler to control how the work
+    // is parallelized (see S2Executor).  The executor is not owned and must
+    // outlive the normalization.
+    //
+    // Defaults to nullptr, which means S2Executor::Default() is used.
+    S2Executor* executor() const;
+    void set_executor(S2Executor* executor);
+
    private:
     bool suppress_lower_dimensions_;
+    int num_threads_ = 1;
+    S2Executor* executor_ = nullptr;
   };
 
   // Constructs a ClosedSetNormalizer whose output will be three
@@ -123,6 +145,11 @@ class ClosedSetNormalizer {
   // Note that the input graphs, their contents, and the ClosedSetNormalizer
   // itself must persist until the output of this class is no longer needed.
   // (To emphasize this requirement, a const reference is returned.)
+  //
+  // Run() may be called repeatedly with different inputs (provided that the
+  // previous output is no longer in use); the scratch vectors allocated by
+  // earlier invocations are reused, which avoids most allocation when
+  // normalizing many sets of graphs with one normalizer.
   const std::vector<S2Builder::Graph>& Run(
       const std::vector<S2Builder::Graph>& input, S2Error* error);
 
@@ -132,6 +159,7 @@ class ClosedSetNormalizer {
   S2Builder::Graph::Edge AdvanceIncoming(
       const S2Builder::Graph& g,
       const std::vector<S2Builder::Graph::EdgeId>& in_edges, int* i) const;
+  void BuildSuppressionData(const std::vector<S2Builder::Graph>& g);
   void NormalizeEdges(const std::vector<S2Builder::Graph>& g, S2Error* error);
   void AddEdge(int new_dim, const S2Builder::Graph& g,
                S2Builder::Graph::EdgeId e);
@@ -157,6 +185,9 @@ class ClosedSetNormalizer {
   // the reverse direction.
   std::vector<S2Builder::Graph::EdgeId> in_edges2_;
 
+  // The polygon degeneracies of the current input, sorted by edge id.
+  std::vector<PolygonDegeneracy> degeneracies_;
+
   // Output data.
   std::vector<S2Builder::Graph> new_graphs_;
   std::vector<S2Builder::Graph::Edge> new_edges_[3];
@@ -215,6 +246,22 @@ inline void ClosedSetNormalizer::Options::set_suppress_lower_dimensions(
   suppress_lower_dimensions_ = suppress_lower_dimensions;
 }
 
+inline int ClosedSetNormalizer::Options::num_threads() const {
+  return num_threads_;
+}
+
+inline void ClosedSetNormalizer::Options::set_num_threads(int num_threads) {
+  num_threads_ = num_threads;
+}
+
+inline S2Executor* ClosedSetNormalizer::Options::executor() const {
+  return executor_;
+}
+
+inline void ClosedSetNormalizer::Options::set_executor(S2Executor* executor) {
+  executor_ = executor;
+}
+
 inline const std::vector<S2Builder::GraphOptions>&
 ClosedSetNormalizer::graph_options() const {
   return graph_options_in_;
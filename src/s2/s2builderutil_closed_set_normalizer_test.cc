@@ -85,6 +85,7 @@ class NormalizeTest : public testing::Test {
 
  protected:
   bool suppress_lower_dimensions_;
+  int num_threads_ = 1;
   vector<GraphOptions> graph_options_out_;
 
  private:
@@ -98,6 +99,7 @@ class NormalizeTest : public testing::Test {
 void NormalizeTest::Run(string_view input_str, string_view expected_str) {
   ClosedSetNormalizer::Options options;
   options.set_suppress_lower_dimensions(suppress_lower_dimensions_);
+  options.set_num_threads(num_threads_);
   ClosedSetNormalizer normalizer(options, graph_options_out_);
 
   S2Builder builder{S2Builder::Options()};
@@ -108,10 +110,15 @@ void NormalizeTest::Run(string_view input_str, string_view expected_str) {
   // Populate the "input" and "expected" vectors.
   EXPECT_TRUE(builder.Build(&error)) << error;
 
-  const vector<Graph>& actual = normalizer.Run(input, &error);
-  for (int dim = 0; dim < 3; ++dim) {
-    EXPECT_TRUE(expected[dim].options() == actual[dim].options());
-    EXPECT_EQ(ToString(expected[dim]), ToString(actual[dim])) << "dim=" << dim;
+  // Run the normalizer twice to verify that its scratch state is reset
+  // between invocations (Run() may be called repeatedly; see its contract).
+  for (int pass = 0; pass < 2; ++pass) {
+    const vector<Graph>& actual = normalizer.Run(input, &error);
+    for (int dim = 0; dim < 3; ++dim) {
+      EXPECT_TRUE(expected[dim].options() == actual[dim].options());
+      EXPECT_EQ(ToString(expected[dim]), ToString(actual[dim]))
+          << "dim=" << dim << ", pass=" << pass;
+    }
   }
 }
 
@@ -226,6 +233,17 @@ TEST_F(NormalizeTest, DuplicateEdgeMerging) {
       "0:0 # 0:1, 0:2 #");
 }
 
+TEST_F(NormalizeTest, MultiThreadedMatchesSingleThreaded) {
+  // The results must be identical regardless of num_threads(); re-run a
+  // sample of the cases above with the preprocessing passes overlapped.
+  num_threads_ = 2;
+  Run("# # 0:0", "0:0 # #");
+  Run("# 0:0, 1:0 # 0:0; 1:0", "# 0:0, 1:0 #");
+  Run("# 1:0, 0:0 # 0:0, 0:1, 1:0", "# # 0:0, 0:1, 1:0");
+  Run("0:0 | 0:1 | 1:0 # # 0:0, 0:1, 1:0",
+      "# # 0:0, 0:1, 1:0");
+}
+
 // If this code changes, please update the header file comments to match.
 bool ComputeUnion(const S2ShapeIndex& a, const S2ShapeIndex& b,
                   MutableS2ShapeIndex* index, S2Error* error) {
@@ -42,10 +42,12 @@
 #include "s2/s2builder.h"
 #include "s2/s2builder_graph.h"
 #include "s2/s2builder_layer.h"
+#include "s2/s2coder.h"
 #include "s2/s2error.h"
 #include "s2/s2lax_polygon_shape.h"
 #include "s2/s2point.h"
 #include "s2/s2shape.h"
+#include "s2/util/coding/coder.h"
 
 namespace s2builderutil {
 
@@ -187,6 +189,50 @@ class IndexedLaxPolygonLayer : public S2Builder::Layer {
   LaxPolygonLayer layer_;
 };
 
+// Like LaxPolygonLayer, but appends the output polygon to an Encoder in the
+// S2LaxPolygonShape encoding format rather than handing a materialized shape
+// back to the client.  This is convenient for write paths whose output is
+// always the serialized form: the polygon built internally is encoded and
+// discarded as soon as Build() completes, so no shape outlives the build.
+// The result can be decoded with S2LaxPolygonShape::Init(Decoder*) or
+// wrapped with EncodedS2LaxPolygonShape.
+//
+// Note that the polygon is encoded even if it is empty, so that the output
+// buffer is always a valid encoding.
+class EncodedLaxPolygonLayer : public S2Builder::Layer {
+ public:
+  using Options = LaxPolygonLayer::Options;
+
+  // Specifies that the polygon should be appended to "encoder" using the
+  // given coding hint.
+  //
+  // REQUIRES: "encoder" uses the default constructor, so that its buffer
+  //           can be enlarged as necessary by calling Ensure(int).
+  explicit EncodedLaxPolygonLayer(
+      Encoder* encoder,
+      s2coding::CodingHint hint = s2coding::CodingHint::COMPACT,
+      const Options& options = Options())
+      : encoder_(encoder), hint_(hint), layer_(&polygon_, options) {}
+
+  GraphOptions graph_options() const override {
+    return layer_.graph_options();
+  }
+
+  void Build(const Graph& g, S2Error* error) override {
+    layer_.Build(g, error);
+    if (error->ok()) {
+      polygon_.Encode(encoder_, hint_);
+      polygon_ = S2LaxPolygonShape();  // Free the intermediate storage.
+    }
+  }
+
+ private:
+  Encoder* encoder_;
+  s2coding::CodingHint hint_;
+  S2LaxPolygonShape polygon_;
+  LaxPolygonLayer layer_;
+};
+
 
 //////////////////   Implementation details follow   ////////////////////
 
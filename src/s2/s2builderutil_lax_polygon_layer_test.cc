@@ -43,10 +43,12 @@
 #include "s2/s2point.h"
 #include "s2/s2shape.h"
 #include "s2/s2text_format.h"
+#include "s2/util/coding/coder.h"
 
 using absl::btree_set;
 using absl::flat_hash_map;
 using absl::string_view;
+using s2builderutil::EncodedLaxPolygonLayer;
 using s2builderutil::IndexedLaxPolygonLayer;
 using s2builderutil::LaxPolygonLayer;
 using s2textformat::MakeLaxPolygonOrDie;
@@ -377,4 +379,33 @@ TEST(IndexedLaxPolygonLayer, IgnoresEmptyShape) {
   EXPECT_EQ(0, index.num_shape_ids());
 }
 
+TEST(EncodedLaxPolygonLayer, EncodesPolygon) {
+  const string& polygon_str = "0:0, 0:10, 10:0; 2:2, 2:4, 4:2";
+  Encoder encoder;
+  S2Builder builder{S2Builder::Options()};
+  builder.StartLayer(make_unique<EncodedLaxPolygonLayer>(&encoder));
+  builder.AddShape(*MakeLaxPolygonOrDie(polygon_str));
+  S2Error error;
+  ASSERT_TRUE(builder.Build(&error));
+
+  Decoder decoder(encoder.base(), encoder.length());
+  S2LaxPolygonShape decoded;
+  ASSERT_TRUE(decoded.Init(&decoder));
+  EXPECT_EQ(polygon_str, s2textformat::ToString(decoded));
+}
+
+TEST(EncodedLaxPolygonLayer, EncodesEmptyPolygon) {
+  // An empty build still produces a valid encoding.
+  Encoder encoder;
+  S2Builder builder{S2Builder::Options()};
+  builder.StartLayer(make_unique<EncodedLaxPolygonLayer>(&encoder));
+  S2Error error;
+  ASSERT_TRUE(builder.Build(&error));
+
+  Decoder decoder(encoder.base(), encoder.length());
+  S2LaxPolygonShape decoded;
+  ASSERT_TRUE(decoded.Init(&decoder));
+  EXPECT_TRUE(decoded.is_empty());
+}
+
 }  // namespace
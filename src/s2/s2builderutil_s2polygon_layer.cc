@@ -89,6 +89,7 @@ GraphOptions S2PolygonLayer::graph_options() const {
 void S2PolygonLayer::AppendS2Loops(const Graph& g,
                                    const vector<Graph::EdgeLoop>& edge_loops,
                                    vector<unique_ptr<S2Loop>>* loops) const {
+  loops->reserve(loops->size() + edge_loops.size());
   vector<S2Point> vertices;
   for (const auto& edge_loop : edge_loops) {
     vertices.reserve(edge_loop.size());
@@ -106,6 +107,7 @@ void S2PolygonLayer::AppendEdgeLabels(
     const vector<Graph::EdgeLoop>& edge_loops) {
   if (!label_set_ids_) return;
 
+  label_set_ids_->reserve(label_set_ids_->size() + edge_loops.size());
   vector<Label> labels;  // Temporary storage for labels.
   Graph::LabelFetcher fetcher(g, options_.edge_type());
   for (const auto& edge_loop : edge_loops) {
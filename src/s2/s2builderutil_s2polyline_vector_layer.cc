@@ -79,9 +79,14 @@ void S2PolylineVectorLayer::Build(const Graph& g, S2Error* error) {
       options_.polyline_type());
   polylines_->reserve(edge_polylines.size());
   if (label_set_ids_) label_set_ids_->reserve(edge_polylines.size());
+  // Initializing the fetcher computes the sibling map for undirected edges,
+  // so this is done once rather than once per polyline.
+  Graph::LabelFetcher fetcher;
+  if (label_set_ids_) fetcher.Init(g, options_.edge_type());
   vector<S2Point> vertices;  // Temporary storage for vertices.
   vector<Label> labels;  // Temporary storage for labels.
   for (const auto& edge_polyline : edge_polylines) {
+    vertices.reserve(edge_polyline.size() + 1);
     vertices.push_back(g.vertex(g.edge(edge_polyline[0]).first));
     for (EdgeId e : edge_polyline) {
       vertices.push_back(g.vertex(g.edge(e).second));
@@ -94,7 +99,6 @@ void S2PolylineVectorLayer::Build(const Graph& g, S2Error* error) {
     }
     polylines_->emplace_back(polyline);
     if (label_set_ids_) {
-      Graph::LabelFetcher fetcher(g, options_.edge_type());
       vector<LabelSetId> polyline_labels;
       polyline_labels.reserve(edge_polyline.size());
       for (EdgeId e : edge_polyline) {
@@ -25,11 +25,11 @@
 #include <string>
 #include <vector>
 
-#include "absl/base/call_once.h"
 #include "absl/base/casts.h"
 #include "absl/log/absl_check.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 
 #include "s2/base/types.h"
 #include "s2/util/bits/bits.h"
@@ -38,6 +38,7 @@
 #include "s2/r2.h"
 #include "s2/r2rect.h"
 #include "s2/s1angle.h"
+#include "s2/s2cell_id_sort.h"
 #include "s2/s2coords.h"
 #include "s2/s2coords_internal.h"
 #include "s2/s2error.h"
@@ -70,6 +71,10 @@ using std::vector;
 // We also experimented with looking up 16 bits at a time (14 bits of position
 // plus 2 of orientation) but found that smaller lookup tables gave better
 // performance.  (2KB fits easily in the primary cache.)
+//
+// The tables are generated at compile time, which avoids any startup cost
+// and allows the compiler to constant-fold through FromFaceIJ and
+// ToFaceIJOrientation when the arguments are known.
 
 
 // Values for these constants are *declared* in the *.h file. Even though
@@ -84,43 +89,56 @@ const int S2CellId::kMaxLevel;
 const int S2CellId::kPosBits;
 const int S2CellId::kMaxSize;
 
-static const int kLookupBits = 4;
-static uint16 lookup_pos[1 << (2 * kLookupBits + 2)];
-static uint16 lookup_ij[1 << (2 * kLookupBits + 2)];
+constexpr int kLookupBits = 4;
+
+namespace {
+struct LookupTables {
+  uint16 pos[1 << (2 * kLookupBits + 2)] = {};
+  uint16 ij[1 << (2 * kLookupBits + 2)] = {};
+};
+}  // namespace
 
-static void InitLookupCell(int level, int i, int j, int orig_orientation,
-                           int pos, int orientation) {
+static constexpr void InitLookupCell(LookupTables& tables, int level, int i,
+                                     int j, int orig_orientation, int pos,
+                                     int orientation) {
   if (level == kLookupBits) {
     int ij = (i << kLookupBits) + j;
-    lookup_pos[(ij << 2) + orig_orientation] = (pos << 2) + orientation;
-    lookup_ij[(pos << 2) + orig_orientation] = (ij << 2) + orientation;
+    tables.pos[(ij << 2) + orig_orientation] = (pos << 2) + orientation;
+    tables.ij[(pos << 2) + orig_orientation] = (ij << 2) + orientation;
   } else {
     level++;
     i <<= 1;
     j <<= 1;
     pos <<= 2;
     const int* r = kPosToIJ[orientation];
-    InitLookupCell(level, i + (r[0] >> 1), j + (r[0] & 1), orig_orientation,
-                   pos, orientation ^ kPosToOrientation[0]);
-    InitLookupCell(level, i + (r[1] >> 1), j + (r[1] & 1), orig_orientation,
-                   pos + 1, orientation ^ kPosToOrientation[1]);
-    InitLookupCell(level, i + (r[2] >> 1), j + (r[2] & 1), orig_orientation,
-                   pos + 2, orientation ^ kPosToOrientation[2]);
-    InitLookupCell(level, i + (r[3] >> 1), j + (r[3] & 1), orig_orientation,
-                   pos + 3, orientation ^ kPosToOrientation[3]);
+    InitLookupCell(tables, level, i + (r[0] >> 1), j + (r[0] & 1),
+                   orig_orientation, pos, orientation ^ kPosToOrientation[0]);
+    InitLookupCell(tables, level, i + (r[1] >> 1), j + (r[1] & 1),
+                   orig_orientation, pos + 1,
+                   orientation ^ kPosToOrientation[1]);
+    InitLookupCell(tables, level, i + (r[2] >> 1), j + (r[2] & 1),
+                   orig_orientation, pos + 2,
+                   orientation ^ kPosToOrientation[2]);
+    InitLookupCell(tables, level, i + (r[3] >> 1), j + (r[3] & 1),
+                   orig_orientation, pos + 3,
+                   orientation ^ kPosToOrientation[3]);
   }
 }
 
-static absl::once_flag flag;
-inline static void MaybeInit() {
-  absl::call_once(flag, []{
-    InitLookupCell(0, 0, 0, 0, 0, 0);
-    InitLookupCell(0, 0, 0, kSwapMask, 0, kSwapMask);
-    InitLookupCell(0, 0, 0, kInvertMask, 0, kInvertMask);
-    InitLookupCell(0, 0, 0, kSwapMask|kInvertMask, 0, kSwapMask|kInvertMask);
-  });
+static constexpr LookupTables MakeLookupTables() {
+  LookupTables tables;
+  InitLookupCell(tables, 0, 0, 0, 0, 0, 0);
+  InitLookupCell(tables, 0, 0, 0, kSwapMask, 0, kSwapMask);
+  InitLookupCell(tables, 0, 0, 0, kInvertMask, 0, kInvertMask);
+  InitLookupCell(tables, 0, 0, 0, kSwapMask | kInvertMask, 0,
+                 kSwapMask | kInvertMask);
+  return tables;
 }
 
+static constexpr LookupTables kLookupTables = MakeLookupTables();
+static constexpr const uint16* lookup_pos = kLookupTables.pos;
+static constexpr const uint16* lookup_ij = kLookupTables.ij;
+
 S2CellId S2CellId::advance(int64 steps) const {
   if (steps == 0) return *this;
 
@@ -232,6 +250,10 @@ string S2CellId::ToToken() const {
   return HexFormatString(id_ >> (4 * num_zero_digits), 16 - num_zero_digits);
 }
 
+string S2CellId::ToFixedToken() const {
+  return HexFormatString(id_, 16);
+}
+
 S2CellId S2CellId::FromToken(const string_view token) {
   if (token.length() > 16) return S2CellId::None();
   uint64 id = 0;
@@ -253,6 +275,22 @@ S2CellId S2CellId::FromToken(const string_view token) {
   return S2CellId(id);
 }
 
+void S2CellId::ToTokens(absl::Span<const S2CellId> ids,
+                        vector<string>* tokens) {
+  tokens->reserve(tokens->size() + ids.size());
+  for (S2CellId id : ids) {
+    tokens->push_back(id.ToToken());
+  }
+}
+
+void S2CellId::FromTokens(absl::Span<const string_view> tokens,
+                          vector<S2CellId>* ids) {
+  ids->reserve(ids->size() + tokens.size());
+  for (string_view token : tokens) {
+    ids->push_back(FromToken(token));
+  }
+}
+
 void S2CellId::Encode(Encoder* const encoder) const {
   encoder->Ensure(sizeof(uint64));  // A single uint64.
   encoder->put64(id_);
@@ -264,17 +302,18 @@ bool S2CellId::Decode(Decoder* const decoder) {
   return true;
 }
 
-S2CellId S2CellId::FromFaceIJ(int face, int i, int j) {
-  // Initialization if not done yet
-  MaybeInit();
-
+// Converts (face, i, j) to a leaf cell id.  Identical to FromFaceIJ() except
+// that it assumes the lookup tables have already been initialized, which
+// allows the initialization check to be hoisted out of batch conversion
+// loops (see FromPoints below).
+inline static uint64 FaceIJtoCellId(int face, int i, int j) {
   // Optimization notes:
   //  - Non-overlapping bit fields can be combined with either "+" or "|".
   //    Generally "+" seems to produce better code, but not always.
 
   // Note that this value gets shifted one bit to the left at the end
   // of the function.
-  uint64 n = absl::implicit_cast<uint64>(face) << (kPosBits - 1);
+  uint64 n = absl::implicit_cast<uint64>(face) << (S2CellId::kPosBits - 1);
 
   // Alternating faces have opposite Hilbert curve orientations; this
   // is necessary in order for all faces to have a right-handed
@@ -305,7 +344,11 @@ S2CellId S2CellId::FromFaceIJ(int face, int i, int j) {
   GET_BITS(0);
 #undef GET_BITS
 
-  return S2CellId(n * 2 + 1);
+  return n * 2 + 1;
+}
+
+S2CellId S2CellId::FromFaceIJ(int face, int i, int j) {
+  return S2CellId(FaceIJtoCellId(face, i, j));
 }
 
 S2CellId::S2CellId(const S2Point& p) {
@@ -316,14 +359,23 @@ S2CellId::S2CellId(const S2Point& p) {
   id_ = FromFaceIJ(face, i, j).id();
 }
 
+void S2CellId::FromPoints(absl::Span<const S2Point> points,
+                          absl::Span<S2CellId> output) {
+  ABSL_DCHECK_GE(output.size(), points.size());
+  for (size_t k = 0; k < points.size(); ++k) {
+    double u, v;
+    int face = S2::XYZtoFaceUV(points[k], &u, &v);
+    int i = S2::STtoIJ(S2::UVtoST(u));
+    int j = S2::STtoIJ(S2::UVtoST(v));
+    output[k] = S2CellId(FaceIJtoCellId(face, i, j));
+  }
+}
+
 S2CellId::S2CellId(const S2LatLng& ll)
   : S2CellId(ll.ToPoint()) {
 }
 
 int S2CellId::ToFaceIJOrientation(int* pi, int* pj, int* orientation) const {
-  // Initialization if not done yet
-  MaybeInit();
-
   int i = 0, j = 0;
   int face = this->face();
   int bits = (face & kSwapMask);
@@ -605,6 +657,18 @@ void S2CellId::AppendAllNeighbors(int nbr_level,
   }
 }
 
+void S2CellId::AppendAllNeighbors(absl::Span<const S2CellId> ids,
+                                  int nbr_level, vector<S2CellId>* output) {
+  const size_t start = output->size();
+  // Every cell has at least 8 neighbors at its own level (more when
+  // nbr_level is larger), so this is a lower bound on the appended size.
+  output->reserve(start + 8 * ids.size());
+  for (S2CellId id : ids) id.AppendAllNeighbors(nbr_level, output);
+  S2::SortCellIds(absl::MakeSpan(*output).subspan(start));
+  output->erase(std::unique(output->begin() + start, output->end()),
+                output->end());
+}
+
 string S2CellId::ToString() const {
   if (!is_valid()) {
     return StrCat("Invalid: ", absl::Hex(id(), absl::kZeroPad16));
@@ -33,6 +33,7 @@
 #include "absl/log/absl_check.h"
 #include "absl/numeric/bits.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 
 #include "s2/_fp_contract_off.h"
 #include "s2/base/types.h"
@@ -119,6 +120,18 @@ class S2CellId {
   // containment this way).
   explicit S2CellId(const S2Point& p);
 
+  // Batch version of the constructor above: converts each element of
+  // "points" to the leaf cell containing it and stores the result in the
+  // corresponding element of "output".  This is faster than converting points
+  // one at a time because the per-call overhead (including the check that the
+  // Hilbert curve lookup tables have been initialized) is hoisted out of the
+  // conversion loop, which also gives the compiler more freedom to pipeline
+  // the arithmetic across points.
+  //
+  // REQUIRES: output.size() >= points.size()
+  static void FromPoints(absl::Span<const S2Point> points,
+                         absl::Span<S2CellId> output);
+
   // Construct a leaf cell containing the given normalized S2LatLng.
   explicit S2CellId(const S2LatLng& ll);
 
@@ -386,6 +399,24 @@ class S2CellId {
   std::string ToToken() const;
   static S2CellId FromToken(absl::string_view token);
 
+  // Like ToToken(), but always produces a fixed-width token of 16 hex
+  // digits (trailing zeros are not stripped).  Fixed-width tokens are
+  // slightly faster to produce and to parse since their length does not
+  // need to be computed, and they can be stored in fixed-size records.
+  // The result can be decoded with FromToken(), and ordering is preserved
+  // just like ToToken().
+  std::string ToFixedToken() const;
+
+  // Batch versions of ToToken() and FromToken() that convert many cell ids
+  // at once, appending the results to "tokens" / "ids".  These are faster
+  // than converting ids one at a time since the output storage is reserved
+  // up front.  Malformed tokens decode to S2CellId::None(), exactly like
+  // FromToken().
+  static void ToTokens(absl::Span<const S2CellId> ids,
+                       std::vector<std::string>* tokens);
+  static void FromTokens(absl::Span<const absl::string_view> tokens,
+                         std::vector<S2CellId>* ids);
+
   // Legacy coder for S2CellId that delegates to the token representation.
   // Storage is variable depending on the level of the cell.
   class Coder : public s2coding::S2Coder<S2CellId> {
@@ -441,6 +472,20 @@ class S2CellId {
   // REQUIRES: nbr_level >= this->level().
   void AppendAllNeighbors(int nbr_level, std::vector<S2CellId>* output) const;
 
+  // Appends the neighbors of every cell in "ids" at the given level to
+  // "output", sorted and with duplicates removed.  Adjacent cells in "ids"
+  // share neighbors (and may be neighbors of each other, in which case they
+  // appear in the output), so when expanding a large frontier of cells this
+  // is much more useful than calling AppendAllNeighbors() on each cell in
+  // turn; it also sorts the combined result with a radix sort (see
+  // S2::SortCellIds), which is several times faster than std::sort for
+  // large batches.  Cells that were already in "output" are not sorted or
+  // deduplicated.
+  //
+  // REQUIRES: nbr_level >= id.level() for every cell in "ids".
+  static void AppendAllNeighbors(absl::Span<const S2CellId> ids, int nbr_level,
+                                 std::vector<S2CellId>* output);
+
   /////////////////////////////////////////////////////////////////////
   // Low-level methods.
 
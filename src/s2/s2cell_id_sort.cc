@@ -0,0 +1,107 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2cell_id_sort.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "absl/types/span.h"
+
+#include "s2/base/types.h"
+#include "s2/s2cell_id.h"
+
+using std::vector;
+
+namespace S2 {
+
+namespace {
+
+// Number of key bits consumed per counting-sort pass.
+constexpr int kRadixBits = 8;
+constexpr int kNumBuckets = 1 << kRadixBits;
+
+// Below this size a comparison sort is faster than the 8 counting passes.
+constexpr size_t kMinRadixSortSize = 1 << 12;
+
+// Sorts one contiguous block using an LSD radix sort.  "scratch" is resized
+// as necessary and may be reused across calls.
+void RadixSortBlock(absl::Span<S2CellId> ids, vector<S2CellId>* scratch) {
+  const size_t n = ids.size();
+  if (n < kMinRadixSortSize) {
+    std::sort(ids.begin(), ids.end());
+    return;
+  }
+  scratch->resize(n);
+  S2CellId* src = ids.data();
+  S2CellId* dst = scratch->data();
+  for (int shift = 0; shift < 64; shift += kRadixBits) {
+    size_t counts[kNumBuckets] = {0};
+    for (size_t i = 0; i < n; ++i) {
+      ++counts[(src[i].id() >> shift) & (kNumBuckets - 1)];
+    }
+    // Skip passes where every key has the same byte (common for cell ids,
+    // e.g. the low bytes of coarse cells or the high bytes of cells on a
+    // single face).
+    if (std::any_of(counts, counts + kNumBuckets,
+                    [n](size_t count) { return count == n; })) {
+      continue;
+    }
+    size_t pos = 0;
+    for (size_t& count : counts) {
+      size_t begin = pos;
+      pos += count;
+      count = begin;
+    }
+    for (size_t i = 0; i < n; ++i) {
+      dst[counts[(src[i].id() >> shift) & (kNumBuckets - 1)]++] = src[i];
+    }
+    std::swap(src, dst);
+  }
+  if (src != ids.data()) std::copy(src, src + n, ids.data());
+}
+
+}  // namespace
+
+void SortCellIds(absl::Span<S2CellId> ids, int num_threads) {
+  const size_t n = ids.size();
+  constexpr size_t kMinIdsPerThread = 1 << 16;
+  const size_t num_blocks = std::max<size_t>(
+      1, std::min<size_t>(num_threads, n / kMinIdsPerThread));
+  if (num_blocks == 1) {
+    vector<S2CellId> scratch;
+    RadixSortBlock(ids, &scratch);
+    return;
+  }
+  vector<std::thread> threads;
+  threads.reserve(num_blocks);
+  for (size_t b = 0; b < num_blocks; ++b) {
+    threads.emplace_back([ids, n, num_blocks, b]() {
+      vector<S2CellId> scratch;
+      RadixSortBlock(ids.subspan(b * n / num_blocks,
+                                 (b + 1) * n / num_blocks - b * n / num_blocks),
+                     &scratch);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  for (size_t b = 1; b < num_blocks; ++b) {
+    std::inplace_merge(ids.begin(), ids.begin() + b * n / num_blocks,
+                       ids.begin() + (b + 1) * n / num_blocks);
+  }
+}
+
+}  // namespace S2
@@ -0,0 +1,39 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef S2_S2CELL_ID_SORT_H_
+#define S2_S2CELL_ID_SORT_H_
+
+#include "absl/types/span.h"
+
+#include "s2/_fp_contract_off.h"
+#include "s2/s2cell_id.h"
+
+namespace S2 {
+
+// Sorts the given cell ids into increasing order.  The result is identical
+// to std::sort, but large inputs are sorted with an LSD radix sort, which is
+// several times faster because cell ids are uniformly distributed 64-bit
+// keys.  Small inputs fall back to std::sort (radix sort only pays off once
+// its per-pass bookkeeping is amortized).
+//
+// If "num_threads" is greater than 1 then the input is split into blocks
+// that are sorted on separate threads and then merged; the result does not
+// depend on the number of threads.
+void SortCellIds(absl::Span<S2CellId> ids, int num_threads = 1);
+
+}  // namespace S2
+
+#endif  // S2_S2CELL_ID_SORT_H_
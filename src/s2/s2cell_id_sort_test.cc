@@ -0,0 +1,82 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2cell_id_sort.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "absl/types/span.h"
+#include "s2/s2cell_id.h"
+#include "s2/s2testing.h"
+
+using std::vector;
+
+namespace {
+
+// Returns random cell ids of mixed levels, including duplicates.
+vector<S2CellId> MakeRandomCellIds(int n) {
+  vector<S2CellId> ids;
+  ids.reserve(n);
+  for (int i = 0; i < n; ++i) {
+    ids.push_back(S2Testing::GetRandomCellId());
+    if (S2Testing::rnd.OneIn(10)) ids.push_back(ids.back());  // Duplicates.
+  }
+  return ids;
+}
+
+void ExpectMatchesStdSort(int n, int num_threads) {
+  vector<S2CellId> expected = MakeRandomCellIds(n);
+  vector<S2CellId> actual = expected;
+  std::sort(expected.begin(), expected.end());
+  S2::SortCellIds(absl::MakeSpan(actual), num_threads);
+  EXPECT_EQ(expected, actual);
+}
+
+TEST(SortCellIds, EmptyAndSingleton) {
+  ExpectMatchesStdSort(0, 1);
+  ExpectMatchesStdSort(1, 1);
+}
+
+TEST(SortCellIds, SmallInputsUseComparisonSort) {
+  // Below the radix sort threshold.
+  ExpectMatchesStdSort(1000, 1);
+}
+
+TEST(SortCellIds, LargeInputs) {
+  // Above the radix sort threshold.
+  ExpectMatchesStdSort(100000, 1);
+}
+
+TEST(SortCellIds, MultiThreadedMatchesSerial) {
+  ExpectMatchesStdSort(1 << 18, 4);
+}
+
+TEST(SortCellIds, SingleFace) {
+  // All cell ids on one face, so the high byte passes are constant.
+  vector<S2CellId> expected;
+  for (int i = 0; i < 100000; ++i) {
+    S2CellId id = S2Testing::GetRandomCellId(S2CellId::kMaxLevel);
+    expected.push_back(S2CellId::FromFacePosLevel(3, id.pos(),
+                                                  S2CellId::kMaxLevel));
+  }
+  vector<S2CellId> actual = expected;
+  std::sort(expected.begin(), expected.end());
+  S2::SortCellIds(absl::MakeSpan(actual));
+  EXPECT_EQ(expected, actual);
+}
+
+}  // namespace
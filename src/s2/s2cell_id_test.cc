@@ -34,6 +34,7 @@
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 
 #include "s2/r1interval.h"
 #include "s2/r2.h"
@@ -299,6 +300,26 @@ TEST(S2CellId, Inverses) {
   }
 }
 
+TEST(S2CellId, FromPoints) {
+  // Check that batch conversion gives exactly the same result as converting
+  // each point individually, including points on face/cell boundaries.
+  vector<S2Point> points;
+  for (int i = 0; i < 1000; ++i) {
+    points.push_back(S2Testing::RandomPoint());
+  }
+  for (int face = 0; face < 6; ++face) {
+    points.push_back(S2CellId::FromFace(face).ToPoint());
+  }
+  vector<S2CellId> ids(points.size());
+  S2CellId::FromPoints(points, absl::MakeSpan(ids));
+  for (size_t i = 0; i < points.size(); ++i) {
+    EXPECT_EQ(S2CellId(points[i]), ids[i]);
+  }
+
+  // An empty batch is allowed.
+  S2CellId::FromPoints({}, {});
+}
+
 TEST(S2CellId, Tokens) {
   // Test random cell ids at all levels.
   for (int i = 0; i < 10000; ++i) {
@@ -328,6 +349,50 @@ TEST(S2CellId, Tokens) {
   EXPECT_EQ(S2CellId::None(), S2CellId::FromToken(" 876bee99"));
 }
 
+TEST(S2CellId, FixedTokens) {
+  // Fixed-width tokens are always 16 digits and decode with FromToken().
+  for (int i = 0; i < 10000; ++i) {
+    S2CellId id = S2Testing::GetRandomCellId();
+    string token = id.ToFixedToken();
+    EXPECT_EQ(token.size(), 16);
+    EXPECT_EQ(id, S2CellId::FromToken(token));
+  }
+  EXPECT_EQ("0000000000000000", S2CellId::None().ToFixedToken());
+  EXPECT_EQ(S2CellId::None(),
+            S2CellId::FromToken(S2CellId::None().ToFixedToken()));
+}
+
+TEST(S2CellId, TokenBatches) {
+  vector<S2CellId> ids;
+  for (int i = 0; i < 1000; ++i) {
+    ids.push_back(S2Testing::GetRandomCellId());
+  }
+  vector<string> tokens;
+  S2CellId::ToTokens(ids, &tokens);
+  ASSERT_EQ(ids.size(), tokens.size());
+  for (size_t i = 0; i < ids.size(); ++i) {
+    EXPECT_EQ(ids[i].ToToken(), tokens[i]);
+  }
+  vector<absl::string_view> token_views(tokens.begin(), tokens.end());
+  // Malformed tokens decode to S2CellId::None(), just like FromToken().
+  token_views.push_back("876b e99");
+  vector<S2CellId> decoded;
+  S2CellId::FromTokens(token_views, &decoded);
+  ASSERT_EQ(token_views.size(), decoded.size());
+  for (size_t i = 0; i < ids.size(); ++i) {
+    EXPECT_EQ(ids[i], decoded[i]);
+  }
+  EXPECT_EQ(S2CellId::None(), decoded.back());
+
+  // Both methods append to any existing contents.
+  S2CellId::ToTokens(ids, &tokens);
+  EXPECT_EQ(2 * ids.size(), tokens.size());
+
+  // An empty batch is allowed.
+  S2CellId::ToTokens({}, &tokens);
+  S2CellId::FromTokens({}, &decoded);
+}
+
 TEST(S2CellId, EncodeDecode) {
   S2CellId id(0x7837423);
   Encoder encoder;
@@ -659,6 +724,31 @@ TEST(S2CellId, AllNeighborsForZurich) {
                           S2CellId::FromDebugString("2/033031110322")));
 }
 
+TEST(S2CellId, AppendAllNeighborsBatch) {
+  // The batch version must produce the sorted, deduplicated union of the
+  // per-cell results, including input cells that neighbor each other.
+  vector<S2CellId> ids;
+  for (int i = 0; i < 100; ++i) {
+    S2CellId id = S2Testing::GetRandomCellId(10);
+    ids.push_back(id);
+    // Include the neighbors themselves so that many inputs are adjacent.
+    id.AppendAllNeighbors(10, &ids);
+  }
+  const int nbr_level = 12;
+  vector<S2CellId> expected;
+  for (S2CellId id : ids) id.AppendAllNeighbors(nbr_level, &expected);
+  std::sort(expected.begin(), expected.end());
+  expected.erase(std::unique(expected.begin(), expected.end()),
+                 expected.end());
+
+  // Existing contents of "output" are left untouched.
+  vector<S2CellId> actual = {S2CellId::Sentinel()};
+  S2CellId::AppendAllNeighbors(ids, nbr_level, &actual);
+  ASSERT_GE(actual.size(), 1);
+  EXPECT_EQ(S2CellId::Sentinel(), actual[0]);
+  EXPECT_EQ(expected, vector<S2CellId>(actual.begin() + 1, actual.end()));
+}
+
 // Returns a random point on the boundary of the given rectangle.
 static R2Point SampleBoundary(const R2Rect& rect) {
   R2Point uv;
@@ -18,12 +18,16 @@
 #include "s2/s2cell_index.h"
 
 #include <algorithm>
+#include <thread>
 #include <vector>
 
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/absl_check.h"
+#include "s2/encoded_s2cell_id_vector.h"
+#include "s2/encoded_uint_vector.h"
 #include "s2/s2cell_id.h"
 #include "s2/s2cell_union.h"
+#include "s2/util/coding/coder.h"
 
 using absl::flat_hash_set;
 using std::vector;
@@ -72,7 +76,7 @@ void S2CellIndex::Add(const S2CellUnion& cell_ids, Label label) {
   }
 }
 
-void S2CellIndex::Build() {
+void S2CellIndex::Build(int num_threads) {
   // To build the cell tree and leaf cell ranges, we maintain a stack of
   // (cell_id, label) pairs that contain the current leaf cell.  This class
   // represents an instruction to push or pop a (cell_id, label) pair.
@@ -116,7 +120,32 @@ void S2CellIndex::Build() {
       Delta(S2CellId::Begin(S2CellId::kMaxLevel), S2CellId::None(), -1));
   deltas.push_back(
       Delta(S2CellId::End(S2CellId::kMaxLevel), S2CellId::None(), -1));
-  std::sort(deltas.begin(), deltas.end());
+
+  // Sorting the deltas dominates the build time for large indexes, so when
+  // requested the sort is split into chunks (sorted on separate threads) that
+  // are then merged.  Using more threads than this would only add overhead.
+  constexpr size_t kMinDeltasPerThread = 1 << 14;
+  const size_t num_chunks = std::max<size_t>(
+      1, std::min<size_t>(num_threads, deltas.size() / kMinDeltasPerThread));
+  if (num_chunks == 1) {
+    std::sort(deltas.begin(), deltas.end());
+  } else {
+    const size_t n = deltas.size();
+    std::vector<std::thread> threads;
+    threads.reserve(num_chunks);
+    for (size_t c = 0; c < num_chunks; ++c) {
+      threads.emplace_back([&deltas, n, num_chunks, c]() {
+        std::sort(deltas.begin() + c * n / num_chunks,
+                  deltas.begin() + (c + 1) * n / num_chunks);
+      });
+    }
+    for (auto& thread : threads) thread.join();
+    for (size_t c = 1; c < num_chunks; ++c) {
+      std::inplace_merge(deltas.begin(),
+                         deltas.begin() + c * n / num_chunks,
+                         deltas.begin() + (c + 1) * n / num_chunks);
+    }
+  }
 
   // Now walk through the deltas to build the leaf cell ranges and cell tree
   // (which is essentially a permanent form of the "stack" described above).
@@ -138,6 +167,82 @@ void S2CellIndex::Build() {
   }
 }
 
+void S2CellIndex::Encode(Encoder* encoder) const {
+  ABSL_DCHECK(!range_nodes_.empty()) << "Call Build() first.";
+
+  encoder->Ensure(1);
+  encoder->put8(kCurrentEncodingVersionNumber);
+
+  // The cell tree and range nodes are stored column-wise so that the cell
+  // ids and small integers can each use the most compact encoding available.
+  // Note that "parent" and "contents" fields are >= -1, so they are shifted
+  // by one to make them non-negative.
+  vector<S2CellId> cell_ids;
+  vector<uint32> labels, parents;
+  cell_ids.reserve(cell_tree_.size());
+  labels.reserve(cell_tree_.size());
+  parents.reserve(cell_tree_.size());
+  for (const CellNode& node : cell_tree_) {
+    cell_ids.push_back(node.cell_id);
+    labels.push_back(node.label);
+    parents.push_back(node.parent + 1);
+  }
+  s2coding::EncodeS2CellIdVector(cell_ids, encoder);
+  s2coding::EncodeUintVector<uint32>(labels, encoder);
+  s2coding::EncodeUintVector<uint32>(parents, encoder);
+
+  vector<S2CellId> start_ids;
+  vector<uint32> contents;
+  start_ids.reserve(range_nodes_.size());
+  contents.reserve(range_nodes_.size());
+  for (const RangeNode& node : range_nodes_) {
+    start_ids.push_back(node.start_id);
+    contents.push_back(node.contents + 1);
+  }
+  s2coding::EncodeS2CellIdVector(start_ids, encoder);
+  s2coding::EncodeUintVector<uint32>(contents, encoder);
+}
+
+bool S2CellIndex::Init(Decoder* decoder) {
+  Clear();
+  if (decoder->avail() < 1) return false;
+  unsigned char version = decoder->get8();
+  if (version != kCurrentEncodingVersionNumber) return false;
+
+  s2coding::EncodedS2CellIdVector cell_ids;
+  s2coding::EncodedUintVector<uint32> labels, parents;
+  if (!cell_ids.Init(decoder)) return false;
+  if (!labels.Init(decoder)) return false;
+  if (!parents.Init(decoder)) return false;
+  if (labels.size() != cell_ids.size()) return false;
+  if (parents.size() != cell_ids.size()) return false;
+  const size_t num_cells = cell_ids.size();
+  cell_tree_.reserve(num_cells);
+  for (size_t i = 0; i < num_cells; ++i) {
+    int32 parent = static_cast<int32>(parents[i]) - 1;
+    if (parent < -1 || parent >= static_cast<int32>(num_cells)) return false;
+    cell_tree_.push_back(
+        {cell_ids[i], static_cast<Label>(labels[i]), parent});
+  }
+
+  s2coding::EncodedS2CellIdVector start_ids;
+  s2coding::EncodedUintVector<uint32> contents;
+  if (!start_ids.Init(decoder)) return false;
+  if (!contents.Init(decoder)) return false;
+  if (contents.size() != start_ids.size()) return false;
+  if (start_ids.size() == 0) return false;  // The sentinel node at least.
+  range_nodes_.reserve(start_ids.size());
+  for (size_t i = 0; i < start_ids.size(); ++i) {
+    int32 node_contents = static_cast<int32>(contents[i]) - 1;
+    if (node_contents < -1 ||
+        node_contents >= static_cast<int32>(num_cells)) {
+      return false;
+    }
+    range_nodes_.push_back({start_ids[i], node_contents});
+  }
+  return true;
+}
+
 flat_hash_set<Label> S2CellIndex::GetIntersectingLabels(
     const S2CellUnion& target) const {
   flat_hash_set<Label> labels;
@@ -153,3 +258,16 @@ void S2CellIndex::GetIntersectingLabels(const S2CellUnion& target,
     return true;
   });
 }
+
+bool S2CellIndex::VisitIntersectingLabels(const S2CellUnion& target,
+                                          const LabelVisitor& visitor) const {
+  // VisitIntersectingCells merges the target against range_nodes_ in a
+  // single pass, and ContentsIterator suppresses (cell_id, label) pairs whose
+  // ancestor chains have already been walked.  The hash set below additionally
+  // suppresses duplicate labels contributed by distinct cells.
+  flat_hash_set<Label> seen;
+  return VisitIntersectingCells(
+      target, [&visitor, &seen](S2CellId cell_id, Label label) {
+        return !seen.insert(label).second || visitor(label);
+      });
+}
@@ -30,6 +30,7 @@
 #include "s2/base/log_severity.h"
 #include "s2/s2cell_id.h"
 #include "s2/s2cell_union.h"
+#include "s2/util/coding/coder.h"
 
 // S2CellIndex stores a collection of (cell_id, label) pairs.  The S2CellIds
 // may be overlapping or contain duplicate values.  For example, an
@@ -160,11 +161,31 @@ class S2CellIndex {
 
   // Constructs the index.  This method may only be called once.  No iterators
   // may be used until the index is built.
-  void Build();
+  //
+  // Sorting the (cell_id, label) pairs dominates the build time for large
+  // indexes; passing "num_threads" > 1 splits the sort among that many
+  // threads.
+  void Build(int num_threads = 1);
 
   // Clears the index so that it can be re-used.
   void Clear();
 
+  // Stores an encoded representation of the built index (i.e., the cell tree
+  // and leaf cell ranges) into the given encoder.  A large index can thus be
+  // built and encoded once, and then restored with Init() at each process
+  // start without repeating the work done by Build().
+  //
+  // REQUIRES: Build() has been called.
+  // REQUIRES: "encoder" uses the default constructor, so that its buffer
+  //           can be enlarged as necessary by calling Ensure(int).
+  void Encode(Encoder* encoder) const;
+
+  // Initializes this index from its encoded form.  The index is ready to use
+  // immediately; Build() must not be called.  Returns true on success.
+  // Restoring an index this way is much faster than re-adding the original
+  // (cell_id, label) pairs and calling Build(), since no sorting is needed.
+  bool Init(Decoder* decoder);
+
   // A function that is called with each (cell_id, label) pair to be visited.
   // The function may return false in order to indicate that no further
   // (cell_id, label) pairs are needed.
@@ -178,6 +199,24 @@ class S2CellIndex {
   bool VisitIntersectingCells(const S2CellUnion& target,
                               const CellVisitor& visitor) const;
 
+  // A function that is called with each distinct label to be visited.  The
+  // function may return false in order to indicate that no further labels
+  // are needed.
+  using LabelVisitor = std::function<bool (Label label)>;
+
+  // Visits the distinct labels of all indexed cells that intersect the given
+  // S2CellUnion "target", terminating early if the given LabelVisitor
+  // function returns false (in which case VisitIntersectingLabels returns
+  // false as well).  Each label is visited at most once.
+  //
+  // This is equivalent to iterating over GetIntersectingLabels(), except that
+  // the entire target is merged against the index in a single pass (rather
+  // than re-walking shared ancestor chains once per target cell, as a loop
+  // over the individual cells would), and the traversal stops as soon as the
+  // caller has seen enough labels.
+  bool VisitIntersectingLabels(const S2CellUnion& target,
+                               const LabelVisitor& visitor) const;
+
   // Convenience function that returns the labels of all indexed cells that
   // intersect the given S2CellUnion "target".
   absl::flat_hash_set<Label> GetIntersectingLabels(const S2CellUnion& target)
@@ -195,6 +234,10 @@ class S2CellIndex {
   // A special label indicating that ContentsIterator::done() is true.
   static Label constexpr kDoneContents = -1;
 
+  // When adding a new encoding, be aware that old binaries will not be able
+  // to decode it.
+  static constexpr unsigned char kCurrentEncodingVersionNumber = 0;
+
   // Represents a node in the (cell_id, label) tree.  Cells are organized in a
   // tree such that the ancestors of a given node contain that node.
   struct CellNode {
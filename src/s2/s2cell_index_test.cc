@@ -18,6 +18,7 @@
 #include "s2/s2cell_index.h"
 
 #include <algorithm>
+#include <cstring>
 #include <string>
 #include <utility>
 #include <vector>
@@ -32,6 +33,7 @@
 #include "s2/s2cell_id.h"
 #include "s2/s2cell_union.h"
 #include "s2/s2testing.h"
+#include "s2/util/coding/coder.h"
 
 using absl::flat_hash_set;
 using absl::string_view;
@@ -343,8 +345,8 @@ TEST_F(S2CellIndexTest, ContentsIteratorSuppressesDuplicates) {
   ExpectContents("2/31112", &contents, {{"2/31", 7}});
 }
 
-// Tests that VisitIntersectingCells() and GetIntersectingLabels() return
-// correct results for the given target.
+// Tests that VisitIntersectingCells(), GetIntersectingLabels(), and
+// VisitIntersectingLabels() return correct results for the given target.
 void S2CellIndexTest::TestIntersection(const S2CellUnion& target) {
   vector<LabelledCell> expected, actual;
   flat_hash_set<Label> expected_labels;
@@ -362,6 +364,24 @@ void S2CellIndexTest::TestIntersection(const S2CellUnion& target) {
   ExpectEqual(expected, actual);
   flat_hash_set<Label> actual_labels = index_.GetIntersectingLabels(target);
   EXPECT_EQ(expected_labels, actual_labels);
+
+  // VisitIntersectingLabels should visit each expected label exactly once.
+  flat_hash_set<Label> visited_labels;
+  EXPECT_TRUE(index_.VisitIntersectingLabels(target, [&](Label label) {
+    EXPECT_TRUE(visited_labels.insert(label).second);
+    return true;
+  }));
+  EXPECT_EQ(expected_labels, visited_labels);
+
+  // Early termination stops the traversal after the first label.
+  if (!expected_labels.empty()) {
+    int num_visited = 0;
+    EXPECT_FALSE(index_.VisitIntersectingLabels(target, [&](Label label) {
+      ++num_visited;
+      return false;
+    }));
+    EXPECT_EQ(1, num_visited);
+  }
 }
 
 S2CellUnion MakeCellUnion(const vector<string>& strs) {
@@ -418,4 +438,53 @@ TEST_F(S2CellIndexTest, IntersectionSemiRandomUnions) {
   }
 }
 
+TEST_F(S2CellIndexTest, ParallelBuild) {
+  // Verifies that a multi-threaded Build() produces the same index as a
+  // single-threaded one.
+  for (int i = 0; i < 100; ++i) {
+    Add(GetRandomCellUnion(), i);
+  }
+  index_.Build(/*num_threads=*/4);
+  VerifyCellIterator();
+  VerifyIndexContents();
+  VerifyRangeIterators();
+}
+
+TEST_F(S2CellIndexTest, EncodeDecode) {
+  for (int i = 0; i < 100; ++i) {
+    Add(GetRandomCellUnion(), i);
+  }
+  Build();
+  Encoder encoder;
+  index_.Encode(&encoder);
+
+  S2CellIndex decoded_index;
+  Decoder decoder(encoder.base(), encoder.length());
+  ASSERT_TRUE(decoded_index.Init(&decoder));
+
+  // The decoded index has exactly the same contents as the original.
+  vector<LabelledCell> actual;
+  for (S2CellIndex::CellIterator it(&decoded_index); !it.done(); it.Next()) {
+    actual.push_back(it.labelled_cell());
+  }
+  ExpectEqual(contents_, std::move(actual));
+
+  // And re-encoding it reproduces the original bytes.
+  Encoder reencoder;
+  decoded_index.Encode(&reencoder);
+  ASSERT_EQ(encoder.length(), reencoder.length());
+  EXPECT_EQ(0, memcmp(encoder.base(), reencoder.base(), encoder.length()));
+}
+
+TEST_F(S2CellIndexTest, DecodeFailsWithTruncatedBuffer) {
+  Add("1/0123", 5);
+  Build();
+  Encoder encoder;
+  index_.Encode(&encoder);
+
+  S2CellIndex decoded_index;
+  Decoder decoder(encoder.base(), encoder.length() / 2);
+  EXPECT_FALSE(decoded_index.Init(&decoder));
+}
+
 }  // namespace
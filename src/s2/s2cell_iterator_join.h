@@ -108,6 +108,35 @@ class S2CellIteratorJoin {
         iter_b_(MakeS2CellRangeIterator(iter_b)),
         tolerance_(tolerance) {}
 
+  // Specifies how an exact join (zero tolerance) is executed:
+  //
+  //   MERGE   - A merge join; both iterators are advanced alternately, seeking
+  //             each one past the other until an overlapping pair is found.
+  //             This is the best strategy when the two inputs are of similar
+  //             size, but when one side is much smaller (e.g. joining a small
+  //             point index against a planet-sized shape index) it degenerates
+  //             into one deep seek on the big side per cell of the small side,
+  //             interleaved with pointless relation tests.
+  //
+  //   PROBE_A - Iterates the cells of side A in order and probes side B once
+  //   PROBE_B   per cell (respectively with A and B swapped).  This visits the
+  //             same (A, B) pairs as MERGE but touches the probed side only
+  //             where the driving side has cells, so it is much faster when
+  //             the driving side is small.
+  //
+  //   AUTO    - Counts up to a bounded number of cells on each side and
+  //             chooses one of the strategies above: a probe join driven by
+  //             the small side if one side is much smaller than the other,
+  //             and a merge join otherwise.
+  //
+  // Tolerant joins use a covering-based algorithm that is not affected by
+  // this setting.
+  //
+  // DEFAULT: AUTO
+  enum JoinMethod { AUTO, MERGE, PROBE_A, PROBE_B };
+  void set_join_method(JoinMethod method) { join_method_ = method; }
+  JoinMethod join_method() const { return join_method_; }
+
   // Executes the join.  Explicitly supports type inference for the visitor.
   //
   // Returns false if the visitor ever does, true otherwise.
@@ -123,7 +152,18 @@ class S2CellIteratorJoin {
         "references to the iterators");
 
     if (tolerance_ == S1ChordAngle::Zero()) {
-      return ExactJoin(visitor);
+      JoinMethod method = join_method_;
+      if (method == AUTO) {
+        method = ChooseJoinMethod();
+      }
+      switch (method) {
+        case PROBE_A:
+          return ProbeJoinA(visitor);
+        case PROBE_B:
+          return ProbeJoinB(visitor);
+        default:
+          return ExactJoin(visitor);
+      }
     } else {
       return TolerantJoin(visitor);
     }
@@ -133,14 +173,37 @@ class S2CellIteratorJoin {
   S2CellRangeIterator<IteratorA> iter_a_;
   S2CellRangeIterator<IteratorB> iter_b_;
   S1ChordAngle tolerance_;
+  JoinMethod join_method_ = AUTO;
 
   // Reusable storage for S2Cells on one side of the join.
   std::vector<S2Cell> matched_cells_;
 
-  // Performs an exact inner join (when the tolerance is zero).
+  // Number of cells counted on each side by ChooseJoinMethod() before giving
+  // up, and the minimum size ratio between the sides before a probe join is
+  // preferred over a merge join.
+  static constexpr int kSkewSampleLimit = 512;
+  static constexpr int kSkewFactor = 8;
+
+  // Counts up to kSkewSampleLimit cells on each side and returns the join
+  // method to use: PROBE_A or PROBE_B if the corresponding side is at least
+  // kSkewFactor times smaller than the other, MERGE otherwise.
+  JoinMethod ChooseJoinMethod();
+
+  // Performs an exact inner join (when the tolerance is zero) as a merge
+  // join, advancing both iterators alternately.
   template <typename Visitor>
   bool ExactJoin(Visitor& visitor);
 
+  // Performs an exact inner join by iterating the cells of one side in order
+  // and probing the other side once per cell for the range of positions that
+  // intersect it.  These visit the same pairs as ExactJoin() but are much
+  // faster when the driving side is small relative to the probed side.
+  template <typename Visitor>
+  bool ProbeJoinA(Visitor& visitor);
+
+  template <typename Visitor>
+  bool ProbeJoinB(Visitor& visitor);
+
   // ---- Tolerant join related code.
 
   // Maximum number of cross-terms before we recurse.
@@ -264,6 +327,61 @@ bool S2CellIteratorJoin<A, B>::ExactJoin(Visitor& visitor) {
   return true;
 }
 
+template <typename A, typename B>
+typename S2CellIteratorJoin<A, B>::JoinMethod
+S2CellIteratorJoin<A, B>::ChooseJoinMethod() {
+  const auto CountCells = [](auto& iter) {
+    int count = 0;
+    for (iter.Begin(); count < kSkewSampleLimit && !iter.done(); iter.Next()) {
+      ++count;
+    }
+    return count;
+  };
+
+  // Note that the counts are capped at kSkewSampleLimit, so the skew must be
+  // apparent within the sample for a probe join to be chosen; moderately
+  // skewed inputs fall back to a merge join, which handles them well.
+  const int count_a = CountCells(iter_a_);
+  const int count_b = CountCells(iter_b_);
+  if (count_a * kSkewFactor <= count_b) {
+    return PROBE_A;
+  }
+  if (count_b * kSkewFactor <= count_a) {
+    return PROBE_B;
+  }
+  return MERGE;
+}
+
+template <typename A, typename B>
+template <typename Visitor>
+bool S2CellIteratorJoin<A, B>::ProbeJoinA(Visitor& visitor) {
+  for (iter_a_.Begin(); !iter_a_.done(); iter_a_.Next()) {
+    const bool keep_going =
+        ScanCellRange(iter_b_, iter_a_.id(), [&](const auto& iter_b) {
+          return visitor(iter_a_.iterator(), iter_b.iterator());
+        });
+    if (!keep_going) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename A, typename B>
+template <typename Visitor>
+bool S2CellIteratorJoin<A, B>::ProbeJoinB(Visitor& visitor) {
+  for (iter_b_.Begin(); !iter_b_.done(); iter_b_.Next()) {
+    const bool keep_going =
+        ScanCellRange(iter_a_, iter_b_.id(), [&](const auto& iter_a) {
+          return visitor(iter_a.iterator(), iter_b_.iterator());
+        });
+    if (!keep_going) {
+      return false;
+    }
+  }
+  return true;
+}
+
 template <typename A, typename B>
 template <typename Iterator, typename Visitor>
 inline bool S2CellIteratorJoin<A, B>::ScanCellRange(Iterator& iter, S2CellId id,
@@ -189,6 +189,52 @@ TEST(S2CellIteratorJoin, ExactJoinSeekingWorks) {
   }
 }
 
+TEST(S2CellIteratorJoin, ProbeJoinMatchesMergeJoin) {
+  // Build a large index on one side and a much smaller iterator on the other;
+  // every join method must report the same set of pairs, and AUTO must handle
+  // the skew (by choosing a probe join) without changing the results.
+  const Matrix3x3_d kFrame = UpFrameAt(0, -45);
+
+  S2Fractal fractal;
+  fractal.SetLevelForApproxMaxEdges(1000);
+
+  S2Polygon polygon(fractal.MakeLoop(kFrame, S1Angle::Degrees(10)));
+  const MutableS2ShapeIndex& index = polygon.index();
+  index.ForceBuild();
+
+  // Take every 50th cell of the index for the small side.
+  absl::btree_map<S2CellId, int> small_map;
+  int count = 0;
+  for (MutableS2ShapeIndex::Iterator iter(&index, S2ShapeIndex::BEGIN);
+       !iter.done(); iter.Next()) {
+    if (++count % 50 == 0) {
+      small_map.emplace(iter.id(), count);
+    }
+  }
+  ASSERT_THAT(small_map.empty(), IsFalse());
+
+  auto join = MakeS2CellIteratorJoin(MutableS2ShapeIndex::Iterator(&index),
+                                     MakeMockS2CellIterator(&small_map));
+  using Join = decltype(join);
+
+  const auto RunJoin = [&](typename Join::JoinMethod method) {
+    join.set_join_method(method);
+    absl::flat_hash_set<std::pair<S2CellId, S2CellId>> pairs;
+    join.Join([&](const MutableS2ShapeIndex::Iterator& iter_a,
+                  const MockS2CellIterator<int>& iter_b) {
+      pairs.emplace(iter_a.id(), iter_b.id());
+      return true;
+    });
+    return pairs;
+  };
+
+  const auto merge_pairs = RunJoin(Join::MERGE);
+  EXPECT_THAT(small_map.size(), Le(merge_pairs.size()));
+  EXPECT_THAT(RunJoin(Join::PROBE_A), Eq(merge_pairs));
+  EXPECT_THAT(RunJoin(Join::PROBE_B), Eq(merge_pairs));
+  EXPECT_THAT(RunJoin(Join::AUTO), Eq(merge_pairs));
+}
+
 TEST(S2CellIteratorJoin, NearJoinWorks) {
   auto cpa_map = TokenMap(absl::MakeSpan(kCentralParkATokens));
   auto cpb_map = TokenMap(absl::MakeSpan(kCentralParkBTokens));
@@ -0,0 +1,170 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef S2_S2CELL_ITERATOR_MERGE_H_
+#define S2_S2CELL_ITERATOR_MERGE_H_
+
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "s2/s2cell_id.h"
+#include "s2/s2cell_iterator.h"
+#include "s2/s2cell_range_iterator.h"
+#include "s2/s2shape_index.h"
+
+// Defines a class which performs a streaming k-way merge over any number of
+// S2CellIterator iterators of the same type, visiting the cells of all inputs
+// in a single pass in Hilbert curve order (i.e., by non-decreasing
+// range_min()).
+//
+// Because different indexes subdivide space differently, a cell in one input
+// may correspond to one larger or several smaller cells in another.  The
+// merge therefore organizes the output into "aligned groups": maximal runs of
+// cells whose leaf-cell ranges form one contiguous overlapping region across
+// all inputs.  Cells in different groups are guaranteed not to overlap in any
+// input, so each group can be processed independently.  In particular, a cell
+// that appears in only one input forms a group by itself and can be copied
+// through to the output unchanged (e.g. without re-clipping its edges when
+// merging shape indexes).
+//
+// The visitor is called once per cell with the index of the input it came
+// from, a reference to the correctly positioned underlying iterator, and a
+// flag indicating whether the cell starts a new group.  It may return false
+// to stop the merge early.  Only one cell per input is buffered at a time, so
+// the memory required is O(num_inputs) regardless of index size.
+//
+// Example usage:
+//
+//   // Merge the cells of several encoded shard indexes.
+//   bool ProcessCell(int input, const EncodedS2ShapeIndex::Iterator& it,
+//                    bool new_group) {
+//     ...
+//     return true;
+//   }
+//
+//   std::vector<const EncodedS2ShapeIndex*> shards = ...;
+//   MakeS2CellIteratorMerge(absl::MakeSpan(shards)).Merge(ProcessCell);
+//
+// As with S2CellIteratorJoin, the visitor is a template parameter so that
+// calls to it can be inlined.  It must be callable as:
+//
+//     std::function<bool(int, const Iterator&, bool)>
+//
+// where Iterator is the concrete type of the input iterators.
+template <typename Iter>
+class S2CellIteratorMerge {
+ public:
+  // Expose the iterator type.
+  using Iterator = Iter;
+
+  static_assert(S2CellIterator::ImplementedBy<Iterator>{},
+                "S2CellIteratorMerge requires S2CellIterator iterators");
+
+  S2CellIteratorMerge() = default;
+
+  // Constructs a merge over the given iterators.  The inputs may be in any
+  // state; the merge repositions them at the beginning.
+  explicit S2CellIteratorMerge(std::vector<Iterator> iters) {
+    iters_.reserve(iters.size());
+    for (Iterator& iter : iters) {
+      iters_.push_back(MakeS2CellRangeIterator(std::move(iter)));
+    }
+  }
+
+  // Returns the number of input iterators.
+  int num_inputs() const { return iters_.size(); }
+
+  // Executes the merge.  Explicitly supports type inference for the visitor.
+  //
+  // Returns false if the visitor ever does, true otherwise.
+  template <typename Visitor>
+  bool Merge(Visitor visitor) {
+    static_assert(
+        std::is_convertible<
+            Visitor, std::function<bool(int, const Iterator&, bool)>>{},
+        "Visitor must return bool and be callable with an input index, a "
+        "const reference to an iterator, and a new-group flag");
+
+    for (auto& iter : iters_) iter.Begin();
+    while (true) {
+      // Find the input whose current cell has the smallest range_min (ties
+      // are broken towards the earliest input).
+      int best = SmallestInput(S2CellId::Sentinel());
+      if (best < 0) return true;  // All inputs are exhausted.
+
+      // Emit the aligned group starting at this cell: keep taking the cell
+      // with the smallest range_min for as long as it starts within the
+      // group's leaf-cell window, extending the window as cells are added.
+      S2CellId group_max = iters_[best].range_max();
+      bool new_group = true;
+      do {
+        if (!visitor(best, iters_[best].iterator(), new_group)) return false;
+        new_group = false;
+        if (iters_[best].range_max() > group_max) {
+          group_max = iters_[best].range_max();
+        }
+        iters_[best].Next();
+        best = SmallestInput(group_max);
+      } while (best >= 0);
+    }
+  }
+
+ private:
+  // Returns the index of the non-exhausted input whose current cell has the
+  // smallest range_min, provided that it does not exceed "limit"; returns -1
+  // if there is no such input.
+  int SmallestInput(S2CellId limit) const {
+    int best = -1;
+    for (size_t i = 0; i < iters_.size(); ++i) {
+      if (iters_[i].done() || iters_[i].range_min() > limit) continue;
+      if (best < 0 || iters_[i].range_min() < iters_[best].range_min()) {
+        best = i;
+      }
+    }
+    return best;
+  }
+
+  std::vector<S2CellRangeIterator<Iterator>> iters_;
+};
+
+// Builds a new S2CellIteratorMerge from a span of index pointers, supporting
+// type inference.  The indexes must live for the duration of the merge.
+template <typename IndexType,
+          typename std::enable_if<S2ShapeIndex::ImplementedBy<IndexType>{},
+                                  bool>::type = true>
+S2CellIteratorMerge<typename IndexType::Iterator> MakeS2CellIteratorMerge(
+    absl::Span<const IndexType* const> indexes) {
+  using Iterator = typename IndexType::Iterator;
+  std::vector<Iterator> iters;
+  iters.reserve(indexes.size());
+  for (const IndexType* index : indexes) {
+    iters.push_back(Iterator(index, S2ShapeIndex::BEGIN));
+  }
+  return S2CellIteratorMerge<Iterator>(std::move(iters));
+}
+
+// Builds a new S2CellIteratorMerge directly from iterators.
+template <typename Iterator,
+          typename std::enable_if<S2CellIterator::ImplementedBy<Iterator>{},
+                                  bool>::type = true>
+S2CellIteratorMerge<Iterator> MakeS2CellIteratorMerge(
+    std::vector<Iterator> iters) {
+  return S2CellIteratorMerge<Iterator>(std::move(iters));
+}
+
+#endif  // S2_S2CELL_ITERATOR_MERGE_H_
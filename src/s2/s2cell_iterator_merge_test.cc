@@ -0,0 +1,131 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2cell_iterator_merge.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "absl/types/span.h"
+#include "s2/mutable_s2shape_index.h"
+#include "s2/s2cell_id.h"
+#include "s2/s2shape_index.h"
+#include "s2/s2text_format.h"
+
+namespace {
+
+using std::vector;
+
+// Returns the cell ids of the given index in iteration order.
+vector<S2CellId> GetCellIds(const S2ShapeIndex& index) {
+  vector<S2CellId> ids;
+  for (S2ShapeIndex::Iterator it(&index, S2ShapeIndex::BEGIN); !it.done();
+       it.Next()) {
+    ids.push_back(it.id());
+  }
+  return ids;
+}
+
+TEST(S2CellIteratorMerge, VisitsAllCellsInOrderWithAlignedGroups) {
+  // Three indexes with different geometry, so that their cells subdivide
+  // space differently, plus an empty index.
+  auto index0 = s2textformat::MakeIndexOrDie("1:1 | 2:2 | 3:3 # #");
+  auto index1 = s2textformat::MakeIndexOrDie(
+      "# 0:0, 0:2, 2:2, 2:0, 0:0, 1:1, 3:3 #");
+  auto index2 = s2textformat::MakeIndexOrDie(
+      "# # 0:0, 0:4, 4:4, 4:0; 10:10, 10:11, 11:11");
+  auto index3 = s2textformat::MakeIndexOrDie("# #");
+  const vector<const MutableS2ShapeIndex*> indexes = {
+      index0.get(), index1.get(), index2.get(), index3.get()};
+
+  vector<vector<S2CellId>> seen(indexes.size());
+  S2CellId prev_min = S2CellId::Begin(S2CellId::kMaxLevel);
+  S2CellId group_max;
+  bool first = true;
+  auto merge = MakeS2CellIteratorMerge(absl::MakeConstSpan(indexes));
+  EXPECT_EQ(4, merge.num_inputs());
+  EXPECT_TRUE(merge.Merge(
+      [&](int input, const MutableS2ShapeIndex::Iterator& it, bool new_group) {
+        const S2CellId id = it.id();
+        // Cells arrive in Hilbert order.
+        EXPECT_GE(id.range_min(), prev_min);
+        // Cells overlap the current group window if and only if they belong
+        // to the current group.
+        if (first) {
+          EXPECT_TRUE(new_group);
+        } else if (new_group) {
+          EXPECT_GT(id.range_min(), group_max);
+        } else {
+          EXPECT_LE(id.range_min(), group_max);
+        }
+        first = false;
+        prev_min = id.range_min();
+        group_max = new_group ? id.range_max()
+                              : std::max(group_max, id.range_max());
+        seen[input].push_back(id);
+        return true;
+      }));
+
+  // Every cell of every input is visited exactly once, in order.
+  for (size_t i = 0; i < indexes.size(); ++i) {
+    EXPECT_EQ(GetCellIds(*indexes[i]), seen[i]) << "input " << i;
+  }
+}
+
+TEST(S2CellIteratorMerge, IdenticalInputsFormAlignedGroups) {
+  // Merging an index with itself yields groups that each contain the same
+  // cell once per input.
+  auto index = s2textformat::MakeIndexOrDie("# 0:0, 0:5, 5:5 #");
+  const vector<const MutableS2ShapeIndex*> indexes = {index.get(),
+                                                      index.get()};
+  int num_cells = 0;
+  S2CellId group_id;
+  EXPECT_TRUE(MakeS2CellIteratorMerge(absl::MakeConstSpan(indexes))
+                  .Merge([&](int input,
+                             const MutableS2ShapeIndex::Iterator& it,
+                             bool new_group) {
+                    if (new_group) {
+                      EXPECT_EQ(0, input);
+                      group_id = it.id();
+                    } else {
+                      EXPECT_EQ(1, input);
+                      EXPECT_EQ(group_id, it.id());
+                    }
+                    ++num_cells;
+                    return true;
+                  }));
+  EXPECT_EQ(2 * static_cast<int>(GetCellIds(*index).size()), num_cells);
+}
+
+TEST(S2CellIteratorMerge, VisitorCanStopEarly) {
+  auto index = s2textformat::MakeIndexOrDie("# 0:0, 0:5, 5:5 #");
+  const vector<const MutableS2ShapeIndex*> indexes = {index.get()};
+  int num_cells = 0;
+  EXPECT_FALSE(MakeS2CellIteratorMerge(absl::MakeConstSpan(indexes))
+                   .Merge([&](int, const MutableS2ShapeIndex::Iterator&,
+                              bool) { return ++num_cells < 2; }));
+  EXPECT_EQ(2, num_cells);
+}
+
+TEST(S2CellIteratorMerge, NoInputs) {
+  S2CellIteratorMerge<MutableS2ShapeIndex::Iterator> merge;
+  EXPECT_TRUE(merge.Merge(
+      [](int, const MutableS2ShapeIndex::Iterator&, bool) { return false; }));
+}
+
+}  // namespace
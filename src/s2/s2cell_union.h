@@ -266,6 +266,19 @@ class S2CellUnion final : public S2Region {
   // Returns the difference of the two given cell unions.
   S2CellUnion Difference(const S2CellUnion& y) const;
 
+  // In-place version of Union() that replaces this cell union with its union
+  // with "y".  This reuses the receiver's storage (aside from any growth
+  // needed to hold the combined cells) rather than building a new vector for
+  // every operation.
+  void UnionWith(const S2CellUnion& y);
+
+  // In-place version of Intersection() that replaces this cell union with
+  // its intersection with "y".  Note that the underlying merge cannot run in
+  // place, so one temporary vector is still used; clients that need complete
+  // control over storage should use the static GetIntersection() method with
+  // a reused output vector instead.
+  void IntersectWith(const S2CellUnion& y);
+
   // Expands the cell union by adding a buffer of cells at "expand_level"
   // around the union boundary.
   //
@@ -384,6 +397,17 @@ class S2CellUnion final : public S2Region {
                               const std::vector<S2CellId>& y,
                               std::vector<S2CellId>* out);
 
+  // Like Union(), but works directly with vectors of sorted S2CellIds and
+  // reuses the capacity of "out".  Equivalent to:
+  //
+  //    *out = S2CellUnion(x).Union(S2CellUnion(y)).Release()
+  //
+  // REQUIRES: "x" and "y" are sorted.
+  // REQUIRES: out != &x and out != &y
+  static void GetUnion(const std::vector<S2CellId>& x,
+                       const std::vector<S2CellId>& y,
+                       std::vector<S2CellId>* out);
+
   // Returns a human-readable string describing the S2CellUnion, consisting of
   // the number of cells and the list of S2CellIds in S2CellId::ToToken()
   // format (limited to at most 500 cells).
@@ -400,6 +424,9 @@ class S2CellUnion final : public S2Region {
   // Converts a vector of uint64 to a vector of S2CellIds.
   static std::vector<S2CellId> ToS2CellIds(const std::vector<uint64>& ids);
 
+  // Like Normalize(vector), but requires that "ids" is already sorted.
+  static void NormalizeSorted(std::vector<S2CellId>* ids);
+
   std::vector<S2CellId> cell_ids_;
 };
 
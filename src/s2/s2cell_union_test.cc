@@ -261,6 +261,29 @@ TEST(S2CellUnion, ContainsInputCells) {
   }
 }
 
+TEST(S2CellUnion, ContainsMatchesLinearSearch) {
+  // Guards the branch-free binary search used by Contains(S2CellId) and
+  // Intersects(S2CellId) against a simple linear reference implementation.
+  const int num_iters = absl::GetFlag(FLAGS_iters);
+  for (int i = 0; i < num_iters; ++i) {
+    vector<S2CellId> input;
+    AddCells(S2CellId::None(), /*selected=*/false, &input,
+             /*expected=*/nullptr);
+    S2CellUnion cellunion(input);
+
+    for (int j = 0; j < 20; ++j) {
+      const S2CellId id = S2Testing::GetRandomCellId();
+      bool contains = false, intersects = false;
+      for (S2CellId cell_id : cellunion) {
+        contains |= cell_id.contains(id);
+        intersects |= cell_id.intersects(id);
+      }
+      EXPECT_EQ(contains, cellunion.Contains(id));
+      EXPECT_EQ(intersects, cellunion.Intersects(id));
+    }
+  }
+}
+
 TEST(S2CellUnion, DoesNotContainParentsOfExpectedCell) {
   const int num_iters = absl::GetFlag(FLAGS_iters);
   for (int i = 0; i < num_iters; ++i) {
@@ -351,6 +374,35 @@ TEST(S2CellUnion, IntersectionIsAnd) {
   }
 }
 
+TEST(S2CellUnion, InPlaceOperationsMatchOutOfPlace) {
+  const int num_iters = absl::GetFlag(FLAGS_iters);
+  for (int i = 0; i < num_iters; ++i) {
+    vector<S2CellId> input;
+    AddCells(S2CellId::None(), /*selected=*/false, &input,
+             /*expected=*/nullptr);
+
+    vector<S2CellId> x, y;
+    for (S2CellId input_id : input) {
+      if (rnd.OneIn(2)) x.push_back(input_id);
+      if (rnd.OneIn(2)) y.push_back(input_id);
+    }
+    S2CellUnion xcells(std::move(x));
+    S2CellUnion ycells(std::move(y));
+
+    S2CellUnion x_or_y = xcells;
+    x_or_y.UnionWith(ycells);
+    EXPECT_THAT(x_or_y, Eq(xcells.Union(ycells)));
+
+    vector<S2CellId> x_or_y_ids;
+    S2CellUnion::GetUnion(xcells.cell_ids(), ycells.cell_ids(), &x_or_y_ids);
+    EXPECT_THAT(S2CellUnion::FromVerbatim(std::move(x_or_y_ids)), Eq(x_or_y));
+
+    S2CellUnion x_and_y = xcells;
+    x_and_y.IntersectWith(ycells);
+    EXPECT_THAT(x_and_y, Eq(xcells.Intersection(ycells)));
+  }
+}
+
 TEST(S2CellUnion, IntersectionWithCellIdNotInUnionIsEmpty) {
   S2CellUnion xcells =
       s2textformat::MakeCellUnionOrDie("2/1021322000001121003");
@@ -0,0 +1,82 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2cell_union_view.h"
+
+#include <memory>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+#include "absl/types/span.h"
+#include "s2/s2cell_id.h"
+#include "s2/s2cell_union.h"
+
+using std::vector;
+
+S2CellUnionView::S2CellUnionView(absl::Span<const S2CellUnion* const> unions)
+    : unions_(unions.begin(), unions.end()) {
+  for (const S2CellUnion* cell_union : unions_) {
+    ABSL_DCHECK(cell_union != nullptr);
+    ABSL_DCHECK(cell_union->IsNormalized());
+  }
+}
+
+S2CellUnionView::S2CellUnionView(absl::Span<const S2CellUnion> unions) {
+  unions_.reserve(unions.size());
+  for (const S2CellUnion& cell_union : unions) {
+    ABSL_DCHECK(cell_union.IsNormalized());
+    unions_.push_back(&cell_union);
+  }
+}
+
+void S2CellUnionView::Add(const S2CellUnion* cell_union) {
+  ABSL_DCHECK(cell_union != nullptr);
+  ABSL_DCHECK(cell_union->IsNormalized());
+  unions_.push_back(cell_union);
+  normalized_ = nullptr;
+}
+
+bool S2CellUnionView::Contains(S2CellId id) const {
+  if (normalized_ != nullptr) return normalized_->Contains(id);
+  for (const S2CellUnion* cell_union : unions_) {
+    if (cell_union->Contains(id)) return true;
+  }
+  return false;
+}
+
+bool S2CellUnionView::Intersects(S2CellId id) const {
+  if (normalized_ != nullptr) return normalized_->Intersects(id);
+  for (const S2CellUnion* cell_union : unions_) {
+    if (cell_union->Intersects(id)) return true;
+  }
+  return false;
+}
+
+const S2CellUnion& S2CellUnionView::GetNormalized() const {
+  if (normalized_ == nullptr) {
+    size_t num_cells = 0;
+    for (const S2CellUnion* cell_union : unions_) {
+      num_cells += cell_union->num_cells();
+    }
+    vector<S2CellId> cell_ids;
+    cell_ids.reserve(num_cells);
+    for (const S2CellUnion* cell_union : unions_) {
+      cell_ids.insert(cell_ids.end(), cell_union->cell_ids().begin(),
+                      cell_union->cell_ids().end());
+    }
+    normalized_ = std::make_unique<S2CellUnion>(std::move(cell_ids));
+  }
+  return *normalized_;
+}
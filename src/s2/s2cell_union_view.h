@@ -0,0 +1,91 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef S2_S2CELL_UNION_VIEW_H_
+#define S2_S2CELL_UNION_VIEW_H_
+
+#include <memory>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "s2/_fp_contract_off.h"
+#include "s2/s2cell_id.h"
+#include "s2/s2cell_union.h"
+#include "s2/s2point.h"
+
+// S2CellUnionView represents the union of a collection of S2CellUnions
+// without materializing it.  This is useful when many cell unions are
+// combined only to answer a handful of containment queries: whereas
+// S2CellUnion::Union() does O(total cells) work to merge and normalize its
+// inputs, the view answers Contains() and Intersects() by probing each
+// member union with a binary search and exiting as soon as one matches.
+//
+// If a query pattern does justify merging (e.g. iterating over the union or
+// issuing very many probes), GetNormalized() materializes the normalized
+// union on first use and caches it, after which queries consult the cached
+// union with a single binary search.
+//
+// The view does not take ownership of the S2CellUnions, which must remain
+// valid and unmodified for the lifetime of the view.  Like most S2 query
+// classes, S2CellUnionView is not thread-safe because GetNormalized()
+// updates the cache; use one view per thread or materialize up front.
+class S2CellUnionView {
+ public:
+  // The default constructor yields an empty union.
+  S2CellUnionView() = default;
+
+  // Constructs a view over the given cell unions, which must satisfy
+  // S2CellUnion::IsNormalized() (as unions built by the normalizing
+  // constructors do).
+  explicit S2CellUnionView(absl::Span<const S2CellUnion* const> unions);
+
+  // Convenience constructor for a contiguous array of cell unions.
+  explicit S2CellUnionView(absl::Span<const S2CellUnion> unions);
+
+  // Adds another cell union to the view and discards any cached normalized
+  // union.
+  void Add(const S2CellUnion* cell_union);
+
+  // The number of member cell unions (not the number of cells).
+  int num_unions() const { return unions_.size(); }
+
+  // Returns true if any member union contains the given cell id.
+  bool Contains(S2CellId id) const;
+
+  // Returns true if any member union intersects the given cell id.
+  bool Intersects(S2CellId id) const;
+
+  // Returns true if any member union contains the given point.  Containment
+  // is defined with respect to the S2CellId covering, exactly as for
+  // S2CellUnion::Contains(const S2Point&).
+  bool Contains(const S2Point& p) const { return Contains(S2CellId(p)); }
+
+  // Returns the normalized union of all members, materializing and caching
+  // it on first call.  Subsequent queries on this view use the cached union
+  // (a single binary search rather than one per member).
+  const S2CellUnion& GetNormalized() const;
+
+  // Returns true if GetNormalized() has been called (i.e., further queries
+  // cost a single binary search regardless of the number of members).
+  bool is_normalized() const { return normalized_ != nullptr; }
+
+ private:
+  std::vector<const S2CellUnion*> unions_;
+
+  // Lazily initialized by GetNormalized().
+  mutable std::unique_ptr<S2CellUnion> normalized_;
+};
+
+#endif  // S2_S2CELL_UNION_VIEW_H_
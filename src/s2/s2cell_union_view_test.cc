@@ -0,0 +1,104 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2cell_union_view.h"
+
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "absl/flags/flag.h"
+#include "absl/types/span.h"
+#include "s2/s2cell_id.h"
+#include "s2/s2cell_union.h"
+#include "s2/s2testing.h"
+
+using std::vector;
+
+namespace {
+
+// Returns a small random normalized cell union.
+S2CellUnion GetRandomCellUnion(int num_cells) {
+  vector<S2CellId> ids;
+  for (int i = 0; i < num_cells; ++i) {
+    ids.push_back(S2Testing::GetRandomCellId());
+  }
+  return S2CellUnion(std::move(ids));
+}
+
+TEST(S2CellUnionView, EmptyView) {
+  S2CellUnionView view;
+  EXPECT_EQ(0, view.num_unions());
+  EXPECT_FALSE(view.Contains(S2Testing::GetRandomCellId()));
+  EXPECT_FALSE(view.Intersects(S2Testing::GetRandomCellId()));
+  EXPECT_EQ(0, view.GetNormalized().num_cells());
+}
+
+TEST(S2CellUnionView, MatchesMaterializedUnion) {
+  S2Testing::rnd.Reset(absl::GetFlag(FLAGS_s2_random_seed));
+  for (int iter = 0; iter < 20; ++iter) {
+    vector<S2CellUnion> unions;
+    for (int i = 0; i < 10; ++i) {
+      unions.push_back(GetRandomCellUnion(1 + S2Testing::rnd.Uniform(8)));
+    }
+    S2CellUnionView view{absl::Span<const S2CellUnion>(unions)};
+    ASSERT_EQ(10, view.num_unions());
+
+    // Compute the same union the expensive way.
+    S2CellUnion expected;
+    for (const S2CellUnion& u : unions) expected = expected.Union(u);
+
+    // Probe with cell ids related to the members as well as random ones.
+    vector<S2CellId> probes;
+    for (const S2CellUnion& u : unions) {
+      for (S2CellId id : u) {
+        probes.push_back(id);
+        probes.push_back(id.parent(id.level() / 2));
+        if (!id.is_leaf()) probes.push_back(id.child_begin());
+      }
+    }
+    for (int i = 0; i < 100; ++i) {
+      probes.push_back(S2Testing::GetRandomCellId());
+    }
+    for (S2CellId probe : probes) {
+      EXPECT_EQ(expected.Contains(probe), view.Contains(probe));
+      EXPECT_EQ(expected.Intersects(probe), view.Intersects(probe));
+    }
+
+    // Materializing gives the normalized union and does not change answers.
+    EXPECT_FALSE(view.is_normalized());
+    EXPECT_EQ(expected, view.GetNormalized());
+    EXPECT_TRUE(view.is_normalized());
+    for (S2CellId probe : probes) {
+      EXPECT_EQ(expected.Contains(probe), view.Contains(probe));
+      EXPECT_EQ(expected.Intersects(probe), view.Intersects(probe));
+    }
+  }
+}
+
+TEST(S2CellUnionView, AddInvalidatesCache) {
+  S2CellUnion a(vector<S2CellId>{S2CellId::FromFace(0)});
+  S2CellUnion b(vector<S2CellId>{S2CellId::FromFace(1)});
+  S2CellUnionView view;
+  view.Add(&a);
+  EXPECT_EQ(1, view.GetNormalized().num_cells());
+  view.Add(&b);
+  EXPECT_FALSE(view.is_normalized());
+  EXPECT_TRUE(view.Contains(S2CellId::FromFace(1)));
+  EXPECT_EQ(2, view.GetNormalized().num_cells());
+}
+
+}  // namespace
@@ -19,10 +19,18 @@
 #include <vector>
 
 #include "absl/log/absl_check.h"
+#include "absl/types/span.h"
+#include "s2/base/types.h"
 #include "s2/s1angle.h"
 #include "s2/s2edge_distances.h"
 #include "s2/s2point.h"
 #include "s2/s2shape.h"
+#include "s2/util/coding/coder.h"
+#include "s2/util/coding/varint.h"
+
+// When adding a new encoding, be aware that old binaries will not be able
+// to decode it.
+static const unsigned char kCurrentEncodingVersionNumber = 1;
 
 S2ChainInterpolationQuery::S2ChainInterpolationQuery(const S2Shape* shape,
                                                      int chain_id) {
@@ -122,6 +130,90 @@ S2ChainInterpolationQuery::Result S2ChainInterpolationQuery::AtFraction(
   return AtDistance(fraction * GetLength());
 }
 
+void S2ChainInterpolationQuery::AtFractions(
+    absl::Span<const double> fractions, std::vector<Result>* results) const {
+  results->clear();
+  // Return invalid results for uninitialized queries or for shapes containing
+  // no edges.
+  if (cumulative_values_.empty()) {
+    results->resize(fractions.size());
+    return;
+  }
+
+  results->reserve(fractions.size());
+  const S1Angle total_length = GetLength();
+
+  // Walk the cumulative values and the (sorted) fractions in lockstep,
+  // reproducing the lower_bound position that AtDistance() would compute for
+  // each fraction.  Since both sequences are non-decreasing the table is
+  // scanned at most once.
+  size_t index = 0;
+  double prev_fraction = fractions.empty() ? 0 : fractions.front();
+  for (const double fraction : fractions) {
+    ABSL_DCHECK_GE(fraction, prev_fraction);
+    prev_fraction = fraction;
+    const S1Angle distance = fraction * total_length;
+    while (index < cumulative_values_.size() &&
+           cumulative_values_[index] < distance) {
+      ++index;
+    }
+    if (index == 0) {
+      // Corner case: the first vertex of the shape at distance = 0.
+      results->push_back(Result(shape_->edge(first_edge_id_).v0,
+                                first_edge_id_, cumulative_values_.front()));
+    } else if (index == cumulative_values_.size()) {
+      // Corner case: the input distance is greater than the total length,
+      // hence we snap the result to the last vertex of the shape.
+      results->push_back(Result(shape_->edge(last_edge_id_).v1, last_edge_id_,
+                                cumulative_values_.back()));
+    } else {
+      const int edge_id = static_cast<int>(index) + first_edge_id_ - 1;
+      const S2Shape::Edge edge = shape_->edge(edge_id);
+      results->push_back(Result(
+          S2::GetPointOnLine(edge.v0, edge.v1,
+                             distance - cumulative_values_[index - 1]),
+          edge_id, distance));
+    }
+  }
+}
+
+void S2ChainInterpolationQuery::Encode(Encoder* encoder) const {
+  encoder->Ensure(1 + 2 * Varint::kMax32);
+  encoder->put8(kCurrentEncodingVersionNumber);
+  encoder->put_varint32(first_edge_id_);
+  encoder->put_varint32(cumulative_values_.size());
+  encoder->Ensure(cumulative_values_.size() * sizeof(double));
+  for (const S1Angle& value : cumulative_values_) {
+    encoder->putdouble(value.radians());
+  }
+}
+
+bool S2ChainInterpolationQuery::Init(const S2Shape* shape, Decoder* decoder) {
+  if (decoder->avail() < 1) return false;
+  const uint8 version = decoder->get8();
+  if (version != kCurrentEncodingVersionNumber) return false;
+
+  uint32 first_edge_id, num_values;
+  if (!decoder->get_varint32(&first_edge_id)) return false;
+  if (!decoder->get_varint32(&num_values)) return false;
+  if (decoder->avail() < num_values * sizeof(double)) return false;
+
+  cumulative_values_.clear();
+  cumulative_values_.reserve(num_values);
+  for (uint32 i = 0; i < num_values; ++i) {
+    cumulative_values_.push_back(S1Angle::Radians(decoder->getdouble()));
+  }
+
+  shape_ = shape;
+  first_edge_id_ = first_edge_id;
+  // The table stores one value per edge plus one for the final vertex, so
+  // num_values == 0 means the shape (or chain) contains no edges.
+  last_edge_id_ = num_values == 0
+                      ? first_edge_id_ - 1
+                      : first_edge_id_ + static_cast<int>(num_values) - 2;
+  return true;
+}
+
 std::vector<S2Point> S2ChainInterpolationQuery::Slice(
     double begin_fraction, double end_fraction) const {
   std::vector<S2Point> slice;
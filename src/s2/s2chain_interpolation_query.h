@@ -20,9 +20,12 @@
 #include <memory>
 #include <vector>
 
+#include "absl/types/span.h"
+
 #include "s2/s1angle.h"
 #include "s2/s2point.h"
 #include "s2/s2shape.h"
+#include "s2/util/coding/coder.h"
 
 // S2ChainInterpolationQuery is a helper class for querying points on S2Shape's
 // edges by spherical distance.  The distance is computed cumulatively along the
@@ -135,6 +138,34 @@ class S2ChainInterpolationQuery {
   // fraction to distance by multiplying it by the total length.
   Result AtFraction(double fraction) const;
 
+  // Like AtFraction(), but resolves many fractions in a single pass over the
+  // cumulative length table: (*results)[i] equals AtFraction(fractions[i]).
+  // This is faster than calling AtFraction() repeatedly when many points are
+  // interpolated at once (e.g. animating along a polyline), since the table
+  // is scanned once instead of binary searched per fraction.
+  //
+  // REQUIRES: "fractions" is sorted in non-decreasing order.
+  void AtFractions(absl::Span<const double> fractions,
+                   std::vector<Result>* results) const;
+
+  // Appends an encoded representation of the precomputed cumulative lengths
+  // to "encoder".  This allows the O(number of edges) initialization cost to
+  // be paid once and shared: the encoding can be stored alongside an encoded
+  // shape and reattached with the Decoder overload of Init() below.
+  //
+  // REQUIRES: this query has been initialized.
+  // REQUIRES: "encoder" uses the default constructor, so that its buffer
+  //           can be enlarged as necessary by calling Ensure(int).
+  void Encode(Encoder* encoder) const;
+
+  // Initializes the query from the given shape and cumulative lengths
+  // previously produced by Encode(), skipping the per-edge length
+  // computation.  Returns true on success.
+  //
+  // REQUIRES: "shape" has the same edges as the shape from which the
+  //           encoding was produced.
+  bool Init(const S2Shape* shape, Decoder* decoder);
+
   // Returns the vector of points that is a slice of the chain from
   // begin_fraction to end_fraction. If begin_fraction is greater than
   // end_fraction, then the points are returned in reverse order.
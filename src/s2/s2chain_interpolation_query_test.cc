@@ -28,6 +28,7 @@
 #include "s2/s2polyline.h"
 #include "s2/s2shape.h"
 #include "s2/s2text_format.h"
+#include "s2/util/coding/coder.h"
 
 using std::vector;
 
@@ -305,3 +306,59 @@ TEST(S2ChainInterpolationQueryTest, Slice) {
   EXPECT_EQ(s2textformat::ToString(query.Slice(0.25, 0.75)),
             "0:0.5, 0:1, 0:1.5");
 }
+
+TEST(S2ChainInterpolationQueryTest, AtFractionsMatchesAtFraction) {
+  auto polyline = s2textformat::MakeLaxPolylineOrDie("0:0, 1:0, 2.5:0, 2.5:2");
+  S2ChainInterpolationQuery query(polyline.get());
+
+  // Include fractions below 0 and above 1 to exercise the snapping cases.
+  vector<double> fractions;
+  for (int i = -2; i <= 22; ++i) fractions.push_back(0.05 * i);
+  vector<S2ChainInterpolationQuery::Result> results;
+  query.AtFractions(fractions, &results);
+  ASSERT_EQ(results.size(), fractions.size());
+  for (size_t i = 0; i < fractions.size(); ++i) {
+    const auto expected = query.AtFraction(fractions[i]);
+    ASSERT_TRUE(results[i].is_valid());
+    EXPECT_EQ(results[i].edge_id(), expected.edge_id());
+    EXPECT_EQ(results[i].point(), expected.point());
+    EXPECT_EQ(results[i].distance(), expected.distance());
+  }
+
+  // An uninitialized query yields one invalid result per fraction.
+  S2ChainInterpolationQuery empty_query;
+  empty_query.AtFractions(fractions, &results);
+  ASSERT_EQ(results.size(), fractions.size());
+  for (const auto& result : results) EXPECT_FALSE(result.is_valid());
+}
+
+TEST(S2ChainInterpolationQueryTest, EncodeDecodeRoundTrip) {
+  auto polyline = s2textformat::MakeLaxPolylineOrDie("0:0, 1:0, 2.5:0, 2.5:2");
+  S2ChainInterpolationQuery query(polyline.get());
+
+  Encoder encoder;
+  query.Encode(&encoder);
+  Decoder decoder(encoder.base(), encoder.length());
+  S2ChainInterpolationQuery decoded;
+  ASSERT_TRUE(decoded.Init(polyline.get(), &decoder));
+
+  EXPECT_EQ(decoded.GetLength(), query.GetLength());
+  for (double fraction : {-0.5, 0.0, 0.25, 0.7, 1.0, 1.5}) {
+    const auto expected = query.AtFraction(fraction);
+    const auto actual = decoded.AtFraction(fraction);
+    EXPECT_EQ(actual.edge_id(), expected.edge_id());
+    EXPECT_EQ(actual.point(), expected.point());
+    EXPECT_EQ(actual.distance(), expected.distance());
+  }
+
+  // An empty shape round-trips to an empty query.
+  S2LaxPolylineShape empty_shape;
+  S2ChainInterpolationQuery empty_query(&empty_shape);
+  Encoder empty_encoder;
+  empty_query.Encode(&empty_encoder);
+  Decoder empty_decoder(empty_encoder.base(), empty_encoder.length());
+  S2ChainInterpolationQuery empty_decoded;
+  ASSERT_TRUE(empty_decoded.Init(&empty_shape, &empty_decoder));
+  EXPECT_EQ(empty_decoded.GetLength(), S1Angle::Zero());
+  EXPECT_FALSE(empty_decoded.AtFraction(0.5).is_valid());
+}
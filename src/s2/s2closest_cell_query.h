@@ -376,7 +376,7 @@ inline void S2ClosestCellQuery::FindClosestCells(Target* target,
 
 inline S2ClosestCellQuery::Result S2ClosestCellQuery::FindClosestCell(
     Target* target) {
-  static_assert(sizeof(Options) <= 32, "Consider not copying Options here");
+  static_assert(sizeof(Options) <= 40, "Consider not copying Options here");
   Options tmp_options = options_;
   tmp_options.set_max_results(1);
   return base_.FindClosestCell(target, tmp_options);
@@ -25,6 +25,7 @@
 #include <algorithm>
 #include <iterator>
 #include <limits>
+#include <optional>
 #include <queue>
 #include <type_traits>
 #include <vector>
@@ -41,7 +42,9 @@
 #include "s2/s2cell_id.h"
 #include "s2/s2cell_index.h"
 #include "s2/s2cell_union.h"
+#include "s2/s2density_tree.h"
 #include "s2/s2distance_target.h"
+#include "s2/s2error.h"
 #include "s2/s2region.h"
 #include "s2/s2region_coverer.h"
 
@@ -140,6 +143,22 @@ class S2ClosestCellQueryBase {
     const S2Region* region() const;
     void set_region(const S2Region* region);
 
+    // Specifies an optional S2DensityTree describing the approximate
+    // distribution of the indexed cells.  When supplied, candidate cells at
+    // the same distance from the target are expanded in decreasing order of
+    // density weight, so that regions likely to yield many results are
+    // explored first and the distance limit tightens sooner.  This is purely
+    // a search heuristic: it does not affect which cells are returned, only
+    // the order in which candidates are examined.
+    //
+    // "density_tree" is owned by the caller and must persist during the
+    // lifetime of this object.  The value may be changed between calls to
+    // FindClosestCells(), or reset by calling set_density_tree(nullptr).
+    //
+    // DEFAULT: nullptr
+    const S2DensityTree* density_tree() const;
+    void set_density_tree(const S2DensityTree* density_tree);
+
     // Specifies that distances should be computed by examining every cell
     // rather than using the S2ShapeIndex.  This is useful for testing,
     // benchmarking, and debugging.
@@ -152,6 +171,7 @@ class S2ClosestCellQueryBase {
     Distance max_distance_ = Distance::Infinity();
     Delta max_error_ = Delta::Zero();
     const S2Region* region_ = nullptr;
+    const S2DensityTree* density_tree_ = nullptr;
     int max_results_ = kMaxMaxResults;
     bool use_brute_force_ = false;
   };
@@ -261,6 +281,23 @@ class S2ClosestCellQueryBase {
   // REQUIRES: options.max_results() == 1
   Result FindClosestCell(Target* target, const Options& options);
 
+  // Resumable version of FindClosestCells(), analogous to
+  // S2ClosestEdgeQueryBase::StartFindClosestEdges() and friends: the setup,
+  // traversal, and result extraction phases are exposed separately so that a
+  // caller (e.g. an event loop serving demand-paged index data) can advance
+  // the traversal in bounded steps instead of blocking for the whole query.
+  // FindClosestCellsStep() processes at most "max_cells" entries of the
+  // internal cell queue and returns true once the traversal is complete.  A
+  // sequence of calls produces exactly the same results as a single
+  // FindClosestCells() call.
+  //
+  // REQUIRES: "target" and "options" must remain valid and unchanged until
+  //           FinishFindClosestCells() is called, and no other query methods
+  //           may be called in the meantime.
+  void StartFindClosestCells(Target* target, const Options& options);
+  bool FindClosestCellsStep(int max_cells);
+  void FinishFindClosestCells(std::vector<Result>* results);
+
  private:
   using CellIterator = S2CellIndex::CellIterator;
   using ContentsIterator = S2CellIndex::ContentsIterator;
@@ -269,14 +306,17 @@ class S2ClosestCellQueryBase {
 
   const Options& options() const { return *options_; }
   void FindClosestCellsInternal(Target* target, const Options& options);
+  bool StartTraversal(Target* target, const Options& options);
+  bool ProcessQueueEntries(int max_cells);
+  void ExtractResults(std::vector<Result>* results);
   void FindClosestCellsBruteForce();
-  void FindClosestCellsOptimized();
   void InitQueue();
   void InitCovering();
   void AddInitialRange(S2CellId first_id, S2CellId last_id);
   void MaybeAddResult(S2CellId cell_id, Label label);
   bool ProcessOrEnqueue(S2CellId id, NonEmptyRangeIterator* iter, bool seek);
   void AddRange(const RangeIterator& range);
+  int64 GetDensityWeight(S2CellId id);
 
   const S2CellIndex* index_;
   const Options* options_;
@@ -340,6 +380,10 @@ class S2ClosestCellQueryBase {
   bool avoid_duplicates_;
   absl::flat_hash_set<LabelledCell> tested_cells_;
 
+  // True when a query started via StartFindClosestCells() still has
+  // unprocessed entries in the cell queue.
+  bool traversal_pending_ = false;
+
   // The algorithm maintains a priority queue of unprocessed S2CellIds, sorted
   // in increasing order of distance from the target.
   struct QueueEntry {
@@ -350,13 +394,21 @@ class S2ClosestCellQueryBase {
     // The cell being queued.
     S2CellId id;
 
-    QueueEntry(Distance _distance, S2CellId _id)
-        : distance(_distance), id(_id) {}
+    // The density prior weight of "id", or zero if Options::density_tree()
+    // was not specified.  Used only to break ties between equal distances.
+    int64 weight;
+
+    QueueEntry(Distance _distance, S2CellId _id, int64 _weight)
+        : distance(_distance), id(_id), weight(_weight) {}
 
     bool operator<(const QueueEntry& other) const {
       // The priority queue returns the largest elements first, so we want the
-      // "largest" entry to have the smallest distance.
-      return other.distance < distance;
+      // "largest" entry to have the smallest distance.  Among entries at the
+      // same distance, we prefer the one with the largest density weight
+      // since it is expected to yield more results (see density_tree()).
+      if (other.distance < distance) return true;
+      if (distance < other.distance) return false;
+      return weight < other.weight;
     }
   };
   using CellQueue =
@@ -368,6 +420,10 @@ class S2ClosestCellQueryBase {
   // in increasing order, duplicates can automatically be eliminated.
   S2CellIndex::ContentsIterator contents_it_;
 
+  // Caches partially decoded paths of Options::density_tree() (if any)
+  // across density weight lookups, which are typically for nearby cells.
+  std::optional<S2DensityTree::DecodedPath> density_path_;
+
   // Temporaries, defined here to avoid multiple allocations / initializations.
 
   std::vector<S2CellId> max_distance_covering_;
@@ -428,6 +484,18 @@ inline void S2ClosestCellQueryBase<Distance>::Options::set_region(
   region_ = region;
 }
 
+template <class Distance>
+inline const S2DensityTree*
+S2ClosestCellQueryBase<Distance>::Options::density_tree() const {
+  return density_tree_;
+}
+
+template <class Distance>
+inline void S2ClosestCellQueryBase<Distance>::Options::set_density_tree(
+    const S2DensityTree* density_tree) {
+  density_tree_ = density_tree;
+}
+
 template <class Distance>
 inline bool S2ClosestCellQueryBase<Distance>::Options::use_brute_force() const {
   return use_brute_force_;
@@ -495,12 +563,41 @@ template <class Distance>
 void S2ClosestCellQueryBase<Distance>::FindClosestCells(
     Target* target, const Options& options, std::vector<Result>* results) {
   FindClosestCellsInternal(target, options);
+  ExtractResults(results);
+}
+
+template <class Distance>
+void S2ClosestCellQueryBase<Distance>::StartFindClosestCells(
+    Target* target, const Options& options) {
+  traversal_pending_ = StartTraversal(target, options);
+}
+
+template <class Distance>
+bool S2ClosestCellQueryBase<Distance>::FindClosestCellsStep(int max_cells) {
+  if (traversal_pending_) {
+    traversal_pending_ = !ProcessQueueEntries(max_cells);
+  }
+  return !traversal_pending_;
+}
+
+template <class Distance>
+void S2ClosestCellQueryBase<Distance>::FinishFindClosestCells(
+    std::vector<Result>* results) {
+  // Complete any remaining traversal so that a caller who stops stepping
+  // early still gets correct results.
+  FindClosestCellsStep(std::numeric_limits<int>::max());
+  ExtractResults(results);
+}
+
+template <class Distance>
+void S2ClosestCellQueryBase<Distance>::ExtractResults(
+    std::vector<Result>* results) {
   results->clear();
-  if (options.max_results() == 1) {
+  if (options().max_results() == 1) {
     if (!result_singleton_.is_empty()) {
       results->push_back(result_singleton_);
     }
-  } else if (options.max_results() == Options::kMaxMaxResults) {
+  } else if (options().max_results() == Options::kMaxMaxResults) {
     std::sort(result_vector_.begin(), result_vector_.end());
     std::unique_copy(result_vector_.begin(), result_vector_.end(),
                      std::back_inserter(*results));
@@ -514,17 +611,35 @@ void S2ClosestCellQueryBase<Distance>::FindClosestCells(
 template <class Distance>
 void S2ClosestCellQueryBase<Distance>::FindClosestCellsInternal(
     Target* target, const Options& options) {
+  if (StartTraversal(target, options)) {
+    ProcessQueueEntries(std::numeric_limits<int>::max());
+  }
+}
+
+// Performs the query setup and either runs the query to completion (brute
+// force, or when the distance limit is already zero) or initializes the cell
+// queue for the optimized algorithm.  Returns true if queue entries remain to
+// be processed by ProcessQueueEntries().
+template <class Distance>
+bool S2ClosestCellQueryBase<Distance>::StartTraversal(
+    Target* target, const Options& options) {
   target_ = target;
   options_ = &options;
 
   tested_cells_.clear();
   contents_it_.Clear();
+  if (options.density_tree() == nullptr) {
+    density_path_.reset();
+  } else if (!density_path_ ||
+             &density_path_->tree() != options.density_tree()) {
+    density_path_.emplace(options.density_tree());
+  }
   distance_limit_ = options.max_distance();
   result_singleton_ = Result();
   ABSL_DCHECK(result_vector_.empty());
   ABSL_DCHECK(result_set_.empty());
   ABSL_DCHECK_GE(target->max_brute_force_index_size(), 0);
-  if (distance_limit_ == Distance::Zero()) return;
+  if (distance_limit_ == Distance::Zero()) return false;
 
   if (options.max_results() == Options::kMaxMaxResults &&
       options.max_distance() == Distance::Infinity() &&
@@ -568,12 +683,13 @@ void S2ClosestCellQueryBase<Distance>::FindClosestCellsInternal(
       index_->num_cells() <= target_->max_brute_force_index_size()) {
     avoid_duplicates_ = false;
     FindClosestCellsBruteForce();
-  } else {
-    // If the target takes advantage of max_error() then we need to avoid
-    // duplicate edges explicitly.  (Otherwise it happens automatically.)
-    avoid_duplicates_ = (target_uses_max_error && options.max_results() > 1);
-    FindClosestCellsOptimized();
+    return false;
   }
+  // If the target takes advantage of max_error() then we need to avoid
+  // duplicate edges explicitly.  (Otherwise it happens automatically.)
+  avoid_duplicates_ = (target_uses_max_error && options.max_results() > 1);
+  InitQueue();
+  return true;
 }
 
 template <class Distance>
@@ -583,10 +699,11 @@ void S2ClosestCellQueryBase<Distance>::FindClosestCellsBruteForce() {
   }
 }
 
+// Processes up to "max_cells" entries of the cell queue, and returns true
+// once the queue is empty (i.e., the traversal is complete).
 template <class Distance>
-void S2ClosestCellQueryBase<Distance>::FindClosestCellsOptimized() {
-  InitQueue();
-  while (!queue_.empty()) {
+bool S2ClosestCellQueryBase<Distance>::ProcessQueueEntries(int max_cells) {
+  for (; max_cells > 0 && !queue_.empty(); --max_cells) {
     // We need to copy the top entry before removing it, and we need to remove
     // it before adding any new entries to the queue.
     QueueEntry entry = queue_.top();
@@ -608,6 +725,7 @@ void S2ClosestCellQueryBase<Distance>::FindClosestCellsOptimized() {
       seek = ProcessOrEnqueue(child, &range, seek);
     }
   }
+  return queue_.empty();
 }
 
 template <class Distance>
@@ -818,7 +936,7 @@ bool S2ClosestCellQueryBase<Distance>::ProcessOrEnqueue(
         // Ensure that "distance" is a lower bound on distance to the cell.
         distance = distance - options().max_error();
       }
-      queue_.push(QueueEntry(distance, id));
+      queue_.push(QueueEntry(distance, id, GetDensityWeight(id)));
     }
     return true;  // Seek to next child.
   }
@@ -829,6 +947,18 @@ bool S2ClosestCellQueryBase<Distance>::ProcessOrEnqueue(
   return false;  // No need to seek to next child.
 }
 
+// Returns the density prior weight of the given cell, or zero if no density
+// tree was specified (or if the cell could not be decoded; an incomplete
+// prior merely costs performance, not correctness).
+template <class Distance>
+int64 S2ClosestCellQueryBase<Distance>::GetDensityWeight(S2CellId id) {
+  if (!density_path_) return 0;
+  S2Error error;
+  int64 weight = options().density_tree()->GetCellWeight(
+      id, &*density_path_, &error);
+  return error.ok() ? weight : 0;
+}
+
 template <class Distance>
 void S2ClosestCellQueryBase<Distance>::AddRange(const RangeIterator& range) {
   for (contents_it_.StartUnion(range);
@@ -65,4 +65,34 @@ TEST(S2ClosestCellQueryBase, MaxDistance) {
   EXPECT_EQ(4.0, S1ChordAngle(results[0].distance()).length2());
 }
 
+TEST(S2ClosestCellQueryBase, ResumableQueryMatchesFindClosestCells) {
+  // Build an index with enough cells to use the optimized algorithm, so that
+  // the traversal actually suspends when stepped one cell at a time.
+  S2CellIndex index;
+  S2CellId id = S2CellId::Begin(10);
+  for (int i = 0; i < 100; ++i, id = id.next()) {
+    index.Add(id, i /*label*/);
+  }
+  index.Build();
+  FurthestCellQuery query(&index);
+  FurthestCellQuery::Options options;
+  options.set_max_results(3);
+  FurthestPointTarget target(MakeCellIdOrDie("3/123").ToPoint());
+  auto expected = query.FindClosestCells(&target, options);
+  ASSERT_EQ(3, expected.size());
+
+  query.StartFindClosestCells(&target, options);
+  int num_steps = 1;
+  while (!query.FindClosestCellsStep(1)) ++num_steps;
+  std::vector<FurthestCellQuery::Result> results;
+  query.FinishFindClosestCells(&results);
+  EXPECT_GT(num_steps, 1);
+  EXPECT_EQ(expected, results);
+
+  // Finishing without stepping completes the remaining traversal.
+  query.StartFindClosestCells(&target, options);
+  query.FinishFindClosestCells(&results);
+  EXPECT_EQ(expected, results);
+}
+
 }  // namespace
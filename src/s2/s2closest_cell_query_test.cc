@@ -42,11 +42,14 @@
 #include "s2/s2cell_union.h"
 #include "s2/s2closest_cell_query_base.h"
 #include "s2/s2closest_edge_query_testing.h"
+#include "s2/s2density_tree.h"
 #include "s2/s2edge_distances.h"
+#include "s2/s2error.h"
 #include "s2/s2latlng.h"
 #include "s2/s2latlng_rect.h"
 #include "s2/s2metrics.h"
 #include "s2/s2min_distance_targets.h"
+#include "s2/s2point_vector_shape.h"
 #include "s2/s2point.h"
 #include "s2/s2region.h"
 #include "s2/s2region_coverer.h"
@@ -421,6 +424,34 @@ TEST(S2ClosestCellQuery, CapsCells) {
                        kNumIndexes, kNumCells, kNumQueries);
 }
 
+TEST(S2ClosestCellQuery, DensityTreePriorDoesNotAffectResults) {
+  // The density tree prior only affects the order in which candidate cells
+  // are examined, so queries must return identical results with and without
+  // it (even when the tree is built from unrelated geometry).
+  S2CellIndex index;
+  vector<S2Point> centers;
+  for (int i = 0; i < 500; ++i) {
+    S2CellId cell_id = S2Testing::GetRandomCellId();
+    index.Add(cell_id, i);
+    centers.push_back(cell_id.ToPoint());
+  }
+  index.Build();
+  MutableS2ShapeIndex density_index;
+  density_index.Add(make_unique<S2PointVectorShape>(centers));
+  S2DensityTree tree;
+  S2Error error;
+  ASSERT_TRUE(tree.InitToVertexDensity(density_index, 10000, 12, &error));
+  S2ClosestCellQuery query(&index);
+  query.mutable_options()->set_max_results(10);
+  for (int i = 0; i < 20; ++i) {
+    S2ClosestCellQuery::PointTarget target(S2Testing::RandomPoint());
+    query.mutable_options()->set_density_tree(nullptr);
+    const auto expected = query.FindClosestCells(&target);
+    query.mutable_options()->set_density_tree(&tree);
+    EXPECT_EQ(expected, query.FindClosestCells(&target));
+  }
+}
+
 TEST(S2ClosestCellQuery, ConservativeCellDistanceIsUsed) {
   // Don't use absl::FlagSaver, so it works in opensource without gflags.
   const int saved_seed = absl::GetFlag(FLAGS_s2_random_seed);
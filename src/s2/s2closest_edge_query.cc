@@ -17,10 +17,21 @@
 
 #include "s2/s2closest_edge_query.h"
 
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+#include "absl/types/span.h"
 #include "s2/s1angle.h"
 #include "s2/s1chord_angle.h"
+#include "s2/s2cell_id.h"
 #include "s2/s2closest_edge_query_base.h"
 #include "s2/s2edge_distances.h"
+#include "s2/s2point.h"
+#include "s2/s2shape_index.h"
+#include "s2/s2shapeutil_count_edges.h"
 
 void S2ClosestEdgeQuery::Options::set_conservative_max_distance(
     S1ChordAngle max_distance) {
@@ -62,6 +73,65 @@ int S2ClosestEdgeQuery::ShapeIndexTarget::max_brute_force_index_size() const {
   return 25;
 }
 
+int S2ClosestEdgeQuery::MeasureMaxBruteForceIndexSize(const S2ShapeIndex& index,
+                                                      int num_targets) {
+  ABSL_DCHECK_GT(num_targets, 0);
+  const int num_edges = s2shapeutil::CountEdges(index);
+  ABSL_DCHECK_GT(num_edges, 0);
+  if (num_edges == 0) return 0;
+
+  // Draw sample target points from the index cells themselves so that the
+  // measurement exercises the same regions of the index (and of its backing
+  // storage) that real queries would.
+  std::vector<S2Point> targets;
+  int num_cells = 0;
+  for (S2ShapeIndex::Iterator it(&index, S2ShapeIndex::BEGIN); !it.done();
+       it.Next()) {
+    ++num_cells;
+  }
+  const int stride = std::max(1, num_cells / num_targets);
+  int i = 0;
+  for (S2ShapeIndex::Iterator it(&index, S2ShapeIndex::BEGIN); !it.done();
+       it.Next(), ++i) {
+    if (i % stride == 0) targets.push_back(it.id().ToPoint());
+  }
+
+  // Times one query per target with the given strategy and returns the
+  // average seconds per query.  Each strategy gets an untimed warmup pass so
+  // that one-time costs (index construction, lazy decoding of the underlying
+  // storage) are not attributed to whichever strategy runs first.
+  const auto seconds_per_query = [&index, &targets](bool use_brute_force) {
+    S2ClosestEdgeQuery query(&index);
+    query.mutable_options()->set_use_brute_force(use_brute_force);
+    double min_distance = 0;
+    for (const S2Point& point : targets) {
+      PointTarget target(point);
+      min_distance += query.GetDistance(&target).length2();
+    }
+    const auto start = std::chrono::steady_clock::now();
+    for (const S2Point& point : targets) {
+      PointTarget target(point);
+      min_distance += query.GetDistance(&target).length2();
+    }
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    // Keep the accumulated distances observable so that the timed work
+    // cannot be optimized away.
+    ABSL_DCHECK_GE(min_distance, 0);
+    return elapsed.count() / targets.size();
+  };
+  const double brute_seconds = seconds_per_query(true);
+  const double indexed_seconds = seconds_per_query(false);
+
+  // The brute force strategy visits each edge exactly once, so its per-query
+  // cost scales linearly with index size; the break-even index size is the
+  // number of per-edge costs that fit in one indexed query.
+  const double brute_seconds_per_edge = brute_seconds / num_edges;
+  if (brute_seconds_per_edge <= 0) return num_edges;
+  const double cutover = indexed_seconds / brute_seconds_per_edge;
+  return std::max(1, static_cast<int>(std::min(cutover, 1e9)));
+}
+
 S2ClosestEdgeQuery::S2ClosestEdgeQuery() {
   // Prevent inline constructor bloat by defining here.
 }
@@ -70,6 +140,43 @@ S2ClosestEdgeQuery::~S2ClosestEdgeQuery() {
   // Prevent inline destructor bloat by defining here.
 }
 
+std::vector<S2ClosestEdgeQuery::Result>
+S2ClosestEdgeQuery::FindClosestEdgePerTarget(
+    absl::Span<const S2Point> targets, ShapeFilter filter) {
+  // Process the target points in S2CellId (Hilbert curve) order, so that
+  // consecutive points are spatially close together.
+  std::vector<int> order(targets.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&targets](int i, int j) {
+    return S2CellId(targets[i]) < S2CellId(targets[j]);
+  });
+
+  static_assert(sizeof(Options) <= 32, "Consider not copying Options here");
+  Options tmp_options = options_;
+  tmp_options.set_max_results(1);
+  std::vector<Result> results(targets.size());
+  Result prev;
+  for (int i : order) {
+    // The edge closest to the previous point provides an upper bound on the
+    // distance to the current point's closest edge, which lets the search
+    // prune most of the index cells that would otherwise be visited.  (Note
+    // that the bound is inclusive of the seed edge itself, so the search
+    // cannot fail to return a result because of it.)
+    S1ChordAngle limit = options_.max_distance();
+    if (!prev.is_empty() && !prev.is_interior()) {
+      S2Shape::Edge edge = GetEdge(prev);
+      S1ChordAngle seed = S1ChordAngle::Infinity();
+      S2::UpdateMinDistance(targets[i], edge.v0, edge.v1, &seed);
+      limit = std::min(limit, seed.Successor());
+    }
+    tmp_options.set_max_distance(limit);
+    PointTarget target(targets[i]);
+    results[i] = base_.FindClosestEdge(&target, tmp_options, filter);
+    if (!results[i].is_empty()) prev = results[i];
+  }
+  return results;
+}
+
 bool S2ClosestEdgeQuery::IsDistanceLess(Target* target, S1ChordAngle limit,
                                         ShapeFilter filter) {
   static_assert(sizeof(Options) <= 32, "Consider not copying Options here");
@@ -25,6 +25,7 @@
 
 #include "absl/base/macros.h"
 #include "absl/container/inlined_vector.h"
+#include "absl/types/span.h"
 #include "s2/_fp_contract_off.h"
 #include "s2/s1angle.h"
 #include "s2/s1chord_angle.h"
@@ -184,6 +185,7 @@ class S2ClosestEdgeQuery {
     using Base::Options::set_max_results;
     using Base::Options::set_include_interiors;
     using Base::Options::set_use_brute_force;
+    using Base::Options::set_max_brute_force_index_size;
   };
 
   // "Target" represents the geometry to which the distance is measured.
@@ -249,6 +251,39 @@ class S2ClosestEdgeQuery {
   // underlying S2ShapeIndex is modified.
   void ReInit();
 
+  // Measures the index size at which the brute force and indexed search
+  // strategies break even for the given index on the current machine, by
+  // timing both strategies against sample targets drawn from the index
+  // itself.  The built-in per-target cutover constants were calibrated on
+  // RAM-resident indexes; for indexes with very different storage
+  // characteristics (e.g. lazily decoded or disk-backed), measuring once per
+  // index/hardware pair and passing the result to
+  // Options::set_max_brute_force_index_size() makes strategy selection
+  // reflect actual query costs.  The measurement typically takes a few
+  // milliseconds; "num_targets" trades measurement time for accuracy.
+  //
+  // REQUIRES: "index" contains at least one edge.
+  static int MeasureMaxBruteForceIndexSize(const S2ShapeIndex& index,
+                                           int num_targets = 32);
+
+  // Queries are copyable and movable.  Copying a fully initialized query is
+  // a cheap way to give each thread or request its own query object while
+  // sharing the expensive parts: the copy refers to the same index (which
+  // must not be modified while any copy is in use) and inherits the
+  // precomputed traversal metadata (see Prepare()) along with the capacity
+  // of the internal scratch containers.  A typical server builds one warm
+  // query per index at startup and hands each handler a copy; the copies are
+  // independent and may be used concurrently.
+  S2ClosestEdgeQuery(const S2ClosestEdgeQuery&) = default;
+  S2ClosestEdgeQuery& operator=(const S2ClosestEdgeQuery&) = default;
+  S2ClosestEdgeQuery(S2ClosestEdgeQuery&&) = default;
+  S2ClosestEdgeQuery& operator=(S2ClosestEdgeQuery&&) = default;
+
+  // Precomputes the traversal metadata that is otherwise computed lazily on
+  // the first query, so that copies made afterwards (see above) do not each
+  // recompute it.  Never required; see S2ClosestEdgeQueryBase::Prepare().
+  void Prepare() { base_.Prepare(); }
+
   // Returns a reference to the underlying S2ShapeIndex.
   const S2ShapeIndex& index() const;
 
@@ -256,6 +291,10 @@ class S2ClosestEdgeQuery {
   const Options& options() const;
   Options* mutable_options();
 
+  // Returns statistics about the work done by the most recent query (see
+  // S2ClosestEdgeQueryBase::Stats).
+  const Base::Stats& stats() const { return base_.stats(); }
+
   // Returns the closest edges to the given target that satisfy the current
   // options.  This method may be called multiple times.
   //
@@ -280,6 +319,18 @@ class S2ClosestEdgeQuery {
   // (in which case edge_id() == -1).
   Result FindClosestEdge(Target* target, ShapeFilter filter = {});
 
+  // Returns the closest edge to each of the given target points, i.e.
+  // results[i] is the result that FindClosestEdge() would return for
+  // targets[i].  (As with FindClosestEdge(), max_results() is ignored.)
+  //
+  // This method is equivalent to calling FindClosestEdge() once per point
+  // but is often much faster for large batches of nearby points: the points
+  // are processed in S2CellId order, and the edge found for each point is
+  // used to seed the distance bound for the next one, which greatly reduces
+  // the number of index cells visited.
+  std::vector<Result> FindClosestEdgePerTarget(
+      absl::Span<const S2Point> targets, ShapeFilter filter = {});
+
   // Returns the minimum distance to the target.  If the index or target is
   // empty, returns S1ChordAngle::Infinity().
   //
@@ -325,9 +376,6 @@ class S2ClosestEdgeQuery {
  private:
   Options options_;
   Base base_;
-
-  S2ClosestEdgeQuery(const S2ClosestEdgeQuery&) = delete;
-  void operator=(const S2ClosestEdgeQuery&) = delete;
 };
 
 
@@ -25,13 +25,11 @@
 #include <limits>
 #include <memory>
 #include <optional>
-#include <queue>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "s2/base/types.h"
-#include "absl/container/btree_set.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/functional/function_ref.h"
@@ -158,10 +156,24 @@ class S2ClosestEdgeQueryBase {
     bool use_brute_force() const;
     void set_use_brute_force(bool use_brute_force);
 
+    // Overrides the index size (number of edges) at or below which distances
+    // are computed by brute force rather than using the S2ShapeIndex.  By
+    // default the cutover is a per-target-type constant that was calibrated
+    // on RAM-resident indexes (see Target::max_brute_force_index_size()); the
+    // best value can differ by an order of magnitude for indexes with other
+    // storage characteristics.  A value measured for a particular index and
+    // machine can be obtained from
+    // S2ClosestEdgeQuery::MeasureMaxBruteForceIndexSize().
+    //
+    // DEFAULT: -1 (uses the target's built-in cutover)
+    int max_brute_force_index_size() const;
+    void set_max_brute_force_index_size(int max_brute_force_index_size);
+
    private:
     Distance max_distance_ = Distance::Infinity();
     Delta max_error_ = Delta::Zero();
     int max_results_ = kMaxMaxResults;
+    int max_brute_force_index_size_ = -1;
     bool include_interiors_ = true;
     bool use_brute_force_ = false;
   };
@@ -247,9 +259,16 @@ class S2ClosestEdgeQueryBase {
   // Convenience constructor that calls Init().
   explicit S2ClosestEdgeQueryBase(const S2ShapeIndex* index);
 
-  // S2ClosestEdgeQueryBase is not copyable.
-  S2ClosestEdgeQueryBase(const S2ClosestEdgeQueryBase&) = delete;
-  void operator=(const S2ClosestEdgeQueryBase&) = delete;
+  // Queries are copyable and movable.  Copying a fully initialized query is
+  // a cheap way to give each thread its own query object while sharing the
+  // expensive parts: the copy refers to the same index (which must not be
+  // modified while any copy is in use) and inherits the precomputed index
+  // covering (see Prepare()) along with the capacity of the internal scratch
+  // containers.  Copies are independent and may be used concurrently.
+  S2ClosestEdgeQueryBase(const S2ClosestEdgeQueryBase&) = default;
+  S2ClosestEdgeQueryBase& operator=(const S2ClosestEdgeQueryBase&) = default;
+  S2ClosestEdgeQueryBase(S2ClosestEdgeQueryBase&&) = default;
+  S2ClosestEdgeQueryBase& operator=(S2ClosestEdgeQueryBase&&) = default;
 
   // Initializes the query.
   // REQUIRES: ReInit() must be called if "index" is modified.
@@ -259,6 +278,15 @@ class S2ClosestEdgeQueryBase {
   // underlying index is modified.
   void ReInit();
 
+  // Precomputes the traversal metadata (the top-level covering of the index)
+  // that is otherwise computed lazily on the first query.  This is useful
+  // when a warmed-up query object is built once at startup and then copied
+  // for use by other threads (see the copy constructor above); without it the
+  // first query on every copy would recompute the covering.  Calling this is
+  // never required, and calling it again after the covering has been computed
+  // is a no-op.
+  void Prepare();
+
   // Returns a reference to the underlying S2ShapeIndex.
   const S2ShapeIndex& index() const;
 
@@ -272,7 +300,10 @@ class S2ClosestEdgeQueryBase {
                                        ShapeFilter filter = {});
 
   // This version can be more efficient when this method is called many times,
-  // since it does not require allocating a new vector on each call.
+  // since it does not require allocating a new vector on each call.  The
+  // query object's internal scratch storage (priority queue, result storage,
+  // etc.) also retains its capacity between calls, so once both have warmed
+  // up, repeated queries perform no heap allocations.
   void FindClosestEdges(Target* target, const Options& options,
                         std::vector<Result>* results, ShapeFilter filter = {});
 
@@ -288,13 +319,60 @@ class S2ClosestEdgeQueryBase {
   Result FindClosestEdge(Target* target, const Options& options,
                          ShapeFilter filter = {});
 
+  // Resumable version of FindClosestEdges(), for callers that cannot afford
+  // to block for the duration of an entire query (e.g. when the index bytes
+  // are demand-paged from remote storage and a cell access may stall on a
+  // fetch).  StartFindClosestEdges() performs the query setup,
+  // FindClosestEdgesStep() advances the traversal by a bounded amount and
+  // returns true once it is complete, and FinishFindClosestEdges() returns
+  // the results.  For example, an event loop can interleave the steps of
+  // several queries, or issue EncodedS2ShapeIndex::Prefetch() requests for
+  // other work between steps:
+  //
+  //   query.StartFindClosestEdges(&target, options);
+  //   while (!query.FindClosestEdgesStep(kCellsPerStep)) {
+  //     ... yield to the event loop ...
+  //   }
+  //   query.FinishFindClosestEdges(&results);
+  //
+  // Each step processes at most "max_cells" entries of the internal cell
+  // queue, so the number of index cells touched per step is bounded.  Note
+  // that the setup phase may itself access the index (and for small indexes
+  // may run the entire query by brute force), and that a sequence of calls
+  // produces exactly the same results as a single FindClosestEdges() call.
+  //
+  // REQUIRES: "target" and "options" must remain valid and unchanged until
+  //           FinishFindClosestEdges() is called, and no other query methods
+  //           may be called in the meantime.
+  void StartFindClosestEdges(Target* target, const Options& options,
+                             ShapeFilter filter = {});
+  bool FindClosestEdgesStep(int max_cells);
+  void FinishFindClosestEdges(std::vector<Result>* results);
+
+  // Statistics about the work done by the most recent query, for clients
+  // that want to monitor or attribute query cost (e.g. on a serving
+  // dashboard).  The counters cost only an integer increment per cell and
+  // edge, so they are always collected.
+  struct Stats {
+    // The number of index cells whose edges were examined.
+    int num_cells_visited = 0;
+
+    // The number of edges whose distance to the target was computed.
+    int num_edges_tested = 0;
+  };
+
+  // Returns the statistics for the most recent FindClosestEdge[s]() call.
+  const Stats& stats() const { return stats_; }
+
  private:
   struct QueueEntry;
 
   const Options& options() const { return *options_; }
   void FindClosestEdgesInternal(Target* target, const Options& options);
+  bool StartTraversal(Target* target, const Options& options);
+  bool ProcessQueueEntries(int max_cells);
+  void ExtractResults(std::vector<Result>* results);
   void FindClosestEdgesBruteForce();
-  void FindClosestEdgesOptimized();
   void InitQueue();
   void InitCovering();
   void AddInitialRange(const S2ShapeIndex::Iterator& first,
@@ -354,25 +432,26 @@ class S2ClosestEdgeQueryBase {
   //  - If max_results() == "infinity", results are appended to result_vector_
   //    and sorted/uniqued at the end.
   //
-  //  - Otherwise results are kept in a btree_set so that we can progressively
-  //    reduce the distance limit once max_results() results have been found.
-  //    (A priority queue is not sufficient because we need to be able to
-  //    check whether a candidate edge is already in the result set.)
-  //
-  // TODO(ericv): Check whether it would be faster to use avoid_duplicates_
-  // when result_set_ is used so that we could use a priority queue instead.
+  //  - Otherwise results are kept in a vector sorted by increasing distance
+  //    so that we can progressively reduce the distance limit once
+  //    max_results() results have been found.  (A priority queue is not
+  //    sufficient because we need to be able to check whether a candidate
+  //    edge is already in the result set.)  Since max_results() is small in
+  //    this case, sorted insertion is cheap, and unlike a node-based set the
+  //    vector retains its capacity across queries so that steady-state
+  //    queries do not allocate any memory.
   Result result_singleton_;
   std::vector<Result> result_vector_;
-  absl::btree_set<Result> result_set_;
+  std::vector<Result> result_set_;
 
-  // When the result edges are stored in a btree_set (see above), usually
+  // When the result edges are stored in result_set_ (see above), usually
   // duplicates can be removed simply by inserting candidate edges in the
   // current set.  However this is not true if Options::max_error() > 0 and
   // the Target subtype takes advantage of this by returning suboptimal
   // distances.  This is because when UpdateMinDistance() is called with
   // different "min_dist" parameters (i.e., the distance to beat), the
   // implementation may return a different distance for the same edge.  Since
-  // the btree_set is keyed by (distance, shape_id, edge_id) this can create
+  // result_set_ is ordered by (distance, shape_id, edge_id) this can create
   // duplicate edges in the results.
   //
   // The flag below is true when duplicates must be avoided explicitly.  This
@@ -386,6 +465,10 @@ class S2ClosestEdgeQueryBase {
   using ShapeEdgeId = s2shapeutil::ShapeEdgeId;
   absl::flat_hash_set<ShapeEdgeId> tested_edges_;
 
+  // True when a query started via StartFindClosestEdges() still has
+  // unprocessed entries in the cell queue.
+  bool traversal_pending_ = false;
+
   // The algorithm maintains a priority queue of unprocessed S2CellIds, sorted
   // in increasing order of distance from the target.
   struct QueueEntry {
@@ -412,10 +495,68 @@ class S2ClosestEdgeQueryBase {
       return other.distance < distance;
     }
   };
-  using CellQueue =
-      std::priority_queue<QueueEntry, absl::InlinedVector<QueueEntry, 16>>;
+  // A priority queue of QueueEntry implemented as a 4-ary heap rather than
+  // the binary heap of std::priority_queue.  The wider nodes keep parents
+  // and children on fewer cache lines and roughly halve the tree depth,
+  // which measurably reduces push/pop cost once the frontier grows to many
+  // thousands of cells (e.g. large-radius queries).  Like the heap ordering
+  // of std::priority_queue, the entry that sorts *last* by operator< is on
+  // top; QueueEntry::operator< is inverted so this is the entry with the
+  // smallest distance.  clear() discards the contents without releasing the
+  // backing store, so that the storage is reused by subsequent queries.
+  class CellQueue {
+   public:
+    bool empty() const { return c_.empty(); }
+    size_t size() const { return c_.size(); }
+    const QueueEntry& top() const { return c_.front(); }
+
+    void push(const QueueEntry& entry) {
+      size_t i = c_.size();
+      c_.push_back(entry);
+      // Sift the hole up until the parent no longer sorts before "entry".
+      while (i > 0) {
+        const size_t parent = (i - 1) / kArity;
+        if (!(c_[parent] < entry)) break;
+        c_[i] = c_[parent];
+        i = parent;
+      }
+      c_[i] = entry;
+    }
+
+    void pop() {
+      const QueueEntry last = c_.back();
+      c_.pop_back();
+      if (c_.empty()) return;
+      // Sift the hole down, promoting the top-most child at each step.
+      size_t i = 0;
+      const size_t n = c_.size();
+      for (;;) {
+        const size_t first_child = kArity * i + 1;
+        if (first_child >= n) break;
+        const size_t end_child = std::min(first_child + kArity, n);
+        size_t best = first_child;
+        for (size_t child = first_child + 1; child < end_child; ++child) {
+          if (c_[best] < c_[child]) best = child;
+        }
+        if (!(last < c_[best])) break;
+        c_[i] = c_[best];
+        i = best;
+      }
+      c_[i] = last;
+    }
+
+    void clear() { c_.clear(); }
+
+   private:
+    static constexpr size_t kArity = 4;
+
+    absl::InlinedVector<QueueEntry, 16> c_;
+  };
   CellQueue queue_;
 
+  // Statistics for the most recent query (see stats() above).
+  Stats stats_;
+
   // Temporaries, defined here to avoid multiple allocations / initializations.
 
   S2ShapeIndex::Iterator iter_;
@@ -488,6 +629,18 @@ inline void S2ClosestEdgeQueryBase<Distance>::Options::set_use_brute_force(
   use_brute_force_ = use_brute_force;
 }
 
+template <class Distance>
+inline int S2ClosestEdgeQueryBase<Distance>::Options::
+    max_brute_force_index_size() const {
+  return max_brute_force_index_size_;
+}
+
+template <class Distance>
+inline void S2ClosestEdgeQueryBase<Distance>::Options::
+    set_max_brute_force_index_size(int max_brute_force_index_size) {
+  max_brute_force_index_size_ = max_brute_force_index_size;
+}
+
 template <class Distance>
 S2ClosestEdgeQueryBase<Distance>::S2ClosestEdgeQueryBase()
     : tested_edges_(/*bucket_count=*/1) {}
@@ -519,6 +672,18 @@ void S2ClosestEdgeQueryBase<Distance>::ReInit() {
   // faster (i.e., where brute force is used).
 }
 
+template <class Distance>
+void S2ClosestEdgeQueryBase<Distance>::Prepare() {
+  if (!index_covering_.empty()) return;
+  // An index with no cells has an empty covering (InitCovering() requires at
+  // least one cell, but InitQueue() is never reached in that case).
+  if (S2ShapeIndex::Iterator(index_, S2ShapeIndex::BEGIN).done()) return;
+  // InitQueue() skips iterator initialization once the covering exists, so
+  // the iterator must be initialized here (see the comment there).
+  iter_.Init(index_, S2ShapeIndex::UNPOSITIONED);
+  InitCovering();
+}
+
 template <class Distance>
 inline const S2ShapeIndex& S2ClosestEdgeQueryBase<Distance>::index() const {
   return *index_;
@@ -561,13 +726,45 @@ void S2ClosestEdgeQueryBase<Distance>::FindClosestEdges(
   }
   FindClosestEdgesInternal(target, options);
   shape_filter_.reset();
+  ExtractResults(results);
+}
+
+template <class Distance>
+void S2ClosestEdgeQueryBase<Distance>::StartFindClosestEdges(
+    Target* target, const Options& options, ShapeFilter filter) {
+  if (filter) {
+    shape_filter_.emplace(*filter);
+  }
+  traversal_pending_ = StartTraversal(target, options);
+}
+
+template <class Distance>
+bool S2ClosestEdgeQueryBase<Distance>::FindClosestEdgesStep(int max_cells) {
+  if (traversal_pending_) {
+    traversal_pending_ = !ProcessQueueEntries(max_cells);
+  }
+  return !traversal_pending_;
+}
+
+template <class Distance>
+void S2ClosestEdgeQueryBase<Distance>::FinishFindClosestEdges(
+    std::vector<Result>* results) {
+  // Complete any remaining traversal so that a caller who stops stepping
+  // early still gets correct results.
+  FindClosestEdgesStep(std::numeric_limits<int>::max());
+  shape_filter_.reset();
+  ExtractResults(results);
+}
 
+template <class Distance>
+void S2ClosestEdgeQueryBase<Distance>::ExtractResults(
+    std::vector<Result>* results) {
   results->clear();
-  if (options.max_results() == 1) {
+  if (options().max_results() == 1) {
     if (result_singleton_.shape_id() >= 0) {
       results->push_back(result_singleton_);
     }
-  } else if (options.max_results() == Options::kMaxMaxResults) {
+  } else if (options().max_results() == Options::kMaxMaxResults) {
     std::sort(result_vector_.begin(), result_vector_.end());
     std::unique_copy(result_vector_.begin(), result_vector_.end(),
                      std::back_inserter(*results));
@@ -581,16 +778,29 @@ void S2ClosestEdgeQueryBase<Distance>::FindClosestEdges(
 template <class Distance>
 void S2ClosestEdgeQueryBase<Distance>::FindClosestEdgesInternal(
     Target* target, const Options& options) {
+  if (StartTraversal(target, options)) {
+    ProcessQueueEntries(std::numeric_limits<int>::max());
+  }
+}
+
+// Performs the query setup and either runs the query to completion (brute
+// force, or when the distance limit is already zero) or initializes the cell
+// queue for the optimized algorithm.  Returns true if queue entries remain to
+// be processed by ProcessQueueEntries().
+template <class Distance>
+bool S2ClosestEdgeQueryBase<Distance>::StartTraversal(
+    Target* target, const Options& options) {
   target_ = target;
   options_ = &options;
 
+  stats_ = Stats();
   tested_edges_.clear();
   distance_limit_ = options.max_distance();
   result_singleton_ = Result();
   ABSL_DCHECK(result_vector_.empty());
   ABSL_DCHECK(result_set_.empty());
   ABSL_DCHECK_GE(target->max_brute_force_index_size(), 0);
-  if (distance_limit_ == Distance::Zero()) return;
+  if (distance_limit_ == Distance::Zero()) return false;
 
   if (options.max_results() == Options::kMaxMaxResults &&
       options.max_distance() == Distance::Infinity()) {
@@ -599,14 +809,20 @@ void S2ClosestEdgeQueryBase<Distance>::FindClosestEdgesInternal(
   }
 
   if (options.include_interiors()) {
-    absl::btree_set<int32> shape_ids;
+    // Kept in sorted order; uses inline storage to avoid heap allocation
+    // for typical result sizes.
+    absl::InlinedVector<int32, 16> shape_ids;
+    const auto insert_shape_id = [&shape_ids](int id) {
+      auto pos = std::lower_bound(shape_ids.begin(), shape_ids.end(), id);
+      if (pos == shape_ids.end() || *pos != id) shape_ids.insert(pos, id);
+    };
 
     const size_t max_results = static_cast<size_t>(options.max_results());
     if (!shape_filter_) {
       // By default just insert shape ids into the output set.
       (void)target->VisitContainingShapeIds(
           *index_, [&](int id, const S2Point&) {
-            shape_ids.insert(id);
+            insert_shape_id(id);
             return shape_ids.size() < max_results;
           });
     } else {
@@ -614,7 +830,7 @@ void S2ClosestEdgeQueryBase<Distance>::FindClosestEdgesInternal(
       (void)target->VisitContainingShapeIds(
           *index_, [&](int id, const S2Point&) {
             if ((*shape_filter_)(id)) {
-              shape_ids.insert(id);
+              insert_shape_id(id);
             }
             return shape_ids.size() < max_results;
           });
@@ -623,7 +839,7 @@ void S2ClosestEdgeQueryBase<Distance>::FindClosestEdgesInternal(
     for (int shape_id : shape_ids) {
       AddResult(Result(Distance::Zero(), shape_id, -1));
     }
-    if (distance_limit_ == Distance::Zero()) return;
+    if (distance_limit_ == Distance::Zero()) return false;
   }
 
   // If max_error() > 0 and the target takes advantage of this, then we may
@@ -660,7 +876,9 @@ void S2ClosestEdgeQueryBase<Distance>::FindClosestEdgesInternal(
   // spending too much time counting edges when there are many shapes, we stop
   // counting once there are too many edges.  We may need to recount the edges
   // if we later see a target with a larger brute force edge threshold.
-  int min_optimized_edges = target_->max_brute_force_index_size() + 1;
+  int min_optimized_edges = (options.max_brute_force_index_size() >= 0
+                                 ? options.max_brute_force_index_size()
+                                 : target_->max_brute_force_index_size()) + 1;
   if (min_optimized_edges > index_num_edges_limit_ &&
       index_num_edges_ >= index_num_edges_limit_) {
     index_num_edges_ = s2shapeutil::CountEdgesUpTo(*index_,
@@ -672,12 +890,13 @@ void S2ClosestEdgeQueryBase<Distance>::FindClosestEdgesInternal(
     // The brute force algorithm considers each edge exactly once.
     avoid_duplicates_ = false;
     FindClosestEdgesBruteForce();
-  } else {
-    // If the target takes advantage of max_error() then we need to avoid
-    // duplicate edges explicitly.  (Otherwise it happens automatically.)
-    avoid_duplicates_ = (target_uses_max_error && options.max_results() > 1);
-    FindClosestEdgesOptimized();
+    return false;
   }
+  // If the target takes advantage of max_error() then we need to avoid
+  // duplicate edges explicitly.  (Otherwise it happens automatically.)
+  avoid_duplicates_ = (target_uses_max_error && options.max_results() > 1);
+  InitQueue();
+  return true;
 }
 
 template <class Distance>
@@ -697,12 +916,13 @@ void S2ClosestEdgeQueryBase<Distance>::FindClosestEdgesBruteForce() {
   }
 }
 
+// Processes up to "max_cells" entries of the cell queue, and returns true
+// once the queue is empty (i.e., the traversal is complete).
 template <class Distance>
-void S2ClosestEdgeQueryBase<Distance>::FindClosestEdgesOptimized() {
-  InitQueue();
+bool S2ClosestEdgeQueryBase<Distance>::ProcessQueueEntries(int max_cells) {
   // Repeatedly find the closest S2Cell to "target" and either split it into
   // its four children or process all of its edges.
-  while (!queue_.empty()) {
+  for (; max_cells > 0 && !queue_.empty(); --max_cells) {
     // We need to copy the top entry before removing it, and we need to
     // remove it before adding any new entries to the queue.
     QueueEntry entry = queue_.top();
@@ -711,7 +931,7 @@ void S2ClosestEdgeQueryBase<Distance>::FindClosestEdgesOptimized() {
     // entry.distance.
     Distance distance = entry.distance;
     if (!(distance < distance_limit_)) {
-      queue_ = CellQueue();  // Clear any remaining entries.
+      queue_.clear();  // Discard any remaining entries.
       break;
     }
     // If this is already known to be an index cell, just process it.
@@ -739,6 +959,7 @@ void S2ClosestEdgeQueryBase<Distance>::FindClosestEdgesOptimized() {
       ProcessOrEnqueue(id.child(2));
     }
   }
+  return queue_.empty();
 }
 
 template <class Distance>
@@ -901,6 +1122,7 @@ void S2ClosestEdgeQueryBase<Distance>::MaybeAddResult(const S2Shape& shape,
   }
   auto edge = shape.edge(edge_id);
   Distance distance = distance_limit_;
+  ++stats_.num_edges_tested;
   if (target_->UpdateMinDistance(edge.v0, edge.v1, &distance)) {
     AddResult(Result(distance, shape_id, edge_id));
   }
@@ -915,17 +1137,19 @@ void S2ClosestEdgeQueryBase<Distance>::AddResult(const Result& result) {
   } else if (options().max_results() == Options::kMaxMaxResults) {
     result_vector_.push_back(result);  // Sort/unique at end.
   } else {
-    // Add this edge to result_set_.  Note that even if we already have enough
-    // edges, we can't erase an element before insertion because the "new"
-    // edge might in fact be a duplicate.
-    result_set_.insert(result);
+    // Add this edge to result_set_ (which is kept sorted).  Note that even
+    // if we already have enough edges, we can't discard an element before
+    // insertion because the "new" edge might in fact be a duplicate.
+    auto pos = std::lower_bound(result_set_.begin(), result_set_.end(),
+                                result);
+    if (pos != result_set_.end() && *pos == result) return;  // Duplicate.
+    result_set_.insert(pos, result);
     int size = result_set_.size();
     if (size >= options().max_results()) {
       if (size > options().max_results()) {
-        result_set_.erase(--result_set_.end());
+        result_set_.pop_back();
       }
-      distance_limit_ = (--result_set_.end())->distance() -
-                        options().max_error();
+      distance_limit_ = result_set_.back().distance() - options().max_error();
     }
   }
 }
@@ -944,6 +1168,7 @@ template <class Distance>
 void S2ClosestEdgeQueryBase<Distance>::ProcessEdges(const QueueEntry& entry) {
   const S2ShapeIndexCell* index_cell = entry.index_cell;
 
+  ++stats_.num_cells_visited;
   for (int s = 0; s < index_cell->num_clipped(); ++s) {
     const S2ClippedShape& clipped = index_cell->clipped(s);
 
@@ -21,9 +21,11 @@
 #include "s2/s2closest_edge_query_base.h"
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include <gtest/gtest.h>
+#include "absl/strings/str_cat.h"
 #include "s2/mutable_s2shape_index.h"
 #include "s2/s1angle.h"
 #include "s2/s1chord_angle.h"
@@ -62,4 +64,35 @@ TEST(S2ClosestEdgeQueryBase, MaxDistance) {
               1e-13);
 }
 
+TEST(S2ClosestEdgeQueryBase, ResumableQueryMatchesFindClosestEdges) {
+  // Build an index with enough edges to use the optimized algorithm, so that
+  // the traversal actually suspends when stepped one cell at a time.
+  std::string points;
+  for (int i = 0; i < 40; ++i) {
+    for (int j = 0; j < 40; ++j) {
+      absl::StrAppend(&points, points.empty() ? "" : " | ", i, ":", j);
+    }
+  }
+  auto index = s2textformat::MakeIndexOrDie(points + " # #");
+  FurthestEdgeQuery query(index.get());
+  FurthestEdgeQuery::Options options;
+  options.set_max_results(3);
+  FurthestPointTarget target(s2textformat::MakePointOrDie("4:4"));
+  auto expected = query.FindClosestEdges(&target, options);
+  ASSERT_EQ(3, expected.size());
+
+  query.StartFindClosestEdges(&target, options);
+  int num_steps = 1;
+  while (!query.FindClosestEdgesStep(1)) ++num_steps;
+  std::vector<FurthestEdgeQuery::Result> results;
+  query.FinishFindClosestEdges(&results);
+  EXPECT_GT(num_steps, 1);
+  EXPECT_EQ(expected, results);
+
+  // Finishing without stepping completes the remaining traversal.
+  query.StartFindClosestEdges(&target, options);
+  query.FinishFindClosestEdges(&results);
+  EXPECT_EQ(expected, results);
+}
+
 }  // namespace
@@ -21,6 +21,7 @@
 #include <cmath>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -102,6 +103,44 @@ TEST(S2ClosestEdgeQuery, OptionsNotModified) {
   EXPECT_EQ(options.max_error(), query.options().max_error());
 }
 
+TEST(S2ClosestEdgeQuery, StatsReflectMostRecentQuery) {
+  auto index = MakeIndexOrDie("# 0:0, 0:1, 0:2, 0:3 | 5:5, 5:6 #");
+  S2ClosestEdgeQuery query(index.get());
+  S2ClosestEdgeQuery::PointTarget target(MakePointOrDie("1:1"));
+  query.FindClosestEdge(&target);
+  EXPECT_GT(query.stats().num_edges_tested, 0);
+
+  // The counters are reset on each call; a query with a tiny distance limit
+  // visits no cells at all.
+  query.mutable_options()->set_max_distance(S1ChordAngle::Zero());
+  query.FindClosestEdge(&target);
+  EXPECT_EQ(0, query.stats().num_cells_visited);
+  EXPECT_EQ(0, query.stats().num_edges_tested);
+}
+
+TEST(S2ClosestEdgeQuery, MaxBruteForceIndexSizeOverride) {
+  // A 3-edge index is far below the default PointTarget cutover, so brute
+  // force is selected; overriding the cutover to 0 forces the indexed
+  // strategy, which must return the same result.
+  auto index = MakeIndexOrDie("# 0:0, 0:1, 0:2, 0:3 #");
+  S2ClosestEdgeQuery query(index.get());
+  S2ClosestEdgeQuery::PointTarget target(MakePointOrDie("1:1"));
+  const auto brute_result = query.FindClosestEdge(&target);
+  EXPECT_EQ(0, query.stats().num_cells_visited);
+
+  query.mutable_options()->set_max_brute_force_index_size(0);
+  const auto indexed_result = query.FindClosestEdge(&target);
+  EXPECT_GT(query.stats().num_cells_visited, 0);
+  EXPECT_TRUE(brute_result == indexed_result);
+}
+
+TEST(S2ClosestEdgeQuery, MeasureMaxBruteForceIndexSize) {
+  // The measured cutover is hardware-dependent, so just check that the
+  // measurement runs and produces a usable (positive) value.
+  auto index = MakeIndexOrDie("# 0:0, 0:1, 0:2, 0:3, 1:3, 1:2, 1:1, 1:0 #");
+  EXPECT_GT(S2ClosestEdgeQuery::MeasureMaxBruteForceIndexSize(*index, 4), 0);
+}
+
 TEST(S2ClosestEdgeQuery, OptionsS1AngleSetters) {
   // Verify that the S1Angle and S1ChordAngle versions do the same thing.
   // This is mainly to prevent the (so far unused) S1Angle versions from
@@ -182,6 +221,41 @@ TEST(S2ClosestEdgeQuery, TestReuseOfQuery) {
   EXPECT_EQ(results1.size(), results2.size());
 }
 
+TEST(S2ClosestEdgeQuery, CopiedQueryMatchesOriginal) {
+  // A warmed-up query can be copied and the copies used independently (e.g.
+  // one per server thread).  Use enough edges that the optimized algorithm
+  // and its precomputed index covering are exercised.
+  MutableS2ShapeIndex index;
+  index.Add(make_unique<S2Loop::OwningShape>(S2Loop::MakeRegularLoop(
+      S2Point(1, 2, 3).Normalize(), S1Angle::Degrees(5), 1000)));
+  S2ClosestEdgeQuery::Options options;
+  options.set_max_results(5);
+  S2ClosestEdgeQuery prototype(&index, options);
+  prototype.Prepare();
+
+  S2ClosestEdgeQuery::PointTarget target(MakePointOrDie("30:40"));
+  auto expected = prototype.FindClosestEdges(&target);
+  ASSERT_EQ(5, expected.size());
+
+  // A copy produces the same results as the original.
+  S2ClosestEdgeQuery copy = prototype;
+  EXPECT_EQ(expected, copy.FindClosestEdges(&target));
+
+  // Several copies may run concurrently (each with its own target, since
+  // targets are mutated during a query).
+  std::vector<std::thread> threads;
+  std::vector<std::vector<S2ClosestEdgeQuery::Result>> results(4);
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&prototype, &results, i]() {
+      S2ClosestEdgeQuery thread_copy = prototype;
+      S2ClosestEdgeQuery::PointTarget thread_target(MakePointOrDie("30:40"));
+      results[i] = thread_copy.FindClosestEdges(&thread_target);
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+  for (const auto& result : results) EXPECT_EQ(expected, result);
+}
+
 TEST(S2ClosestEdgeQuery, TargetPointInsideIndexedPolygon) {
   // Tests a target point in the interior of an indexed polygon.
   // (The index also includes a polyline loop with no interior.)
@@ -394,6 +468,36 @@ static const S1Angle kTestCapRadius = S2Testing::KmToAngle(10);
 // distances (say, less than Pi/2) due to using S1ChordAngle.
 static const double kTestChordAngleError = 1e-15;
 
+TEST(S2ClosestEdgeQuery, FindClosestEdgePerTargetMatchesSingleQueries) {
+  // Verifies that the batch API returns the same result for each point as an
+  // individual FindClosestEdge() call, including when max_distance() causes
+  // some points to have no result and when interiors are included.
+  S2Testing::rnd.Reset(absl::GetFlag(FLAGS_s2_random_seed));
+  S2Cap cap(S2Testing::RandomPoint(), kTestCapRadius);
+  MutableS2ShapeIndex index;
+  s2testing::FractalLoopShapeIndexFactory().AddEdges(cap, 500, &index);
+
+  S2ClosestEdgeQuery::Options options;
+  options.set_include_interiors(true);
+  options.set_max_distance(0.1 * kTestCapRadius);
+  S2ClosestEdgeQuery query(&index, options);
+
+  vector<S2Point> targets;
+  for (int i = 0; i < 100; ++i) {
+    targets.push_back(S2Testing::SamplePoint(cap));
+  }
+  vector<S2ClosestEdgeQuery::Result> batch =
+      query.FindClosestEdgePerTarget(targets);
+  ASSERT_EQ(targets.size(), batch.size());
+  for (size_t i = 0; i < targets.size(); ++i) {
+    S2ClosestEdgeQuery::PointTarget target(targets[i]);
+    S2ClosestEdgeQuery::Result expected = query.FindClosestEdge(&target);
+    EXPECT_EQ(expected.distance(), batch[i].distance());
+    EXPECT_EQ(expected.is_empty(), batch[i].is_empty());
+    EXPECT_EQ(expected.is_interior(), batch[i].is_interior());
+  }
+}
+
 using TestingResult = pair<S2MinDistance, ShapeEdgeId>;
 
 // Converts to the format required by CheckDistanceResults() in s2testing.h.
@@ -119,11 +119,22 @@ class S2ClosestPointQueryBaseOptions {
   bool use_brute_force() const;
   void set_use_brute_force(bool use_brute_force);
 
+  // Overrides the index size (number of points) at or below which distances
+  // are computed by brute force rather than using the S2PointIndex.  By
+  // default the cutover is a per-target-type constant that was calibrated on
+  // RAM-resident indexes (see Target::max_brute_force_index_size()); a value
+  // measured for a particular index and machine may be substituted here.
+  //
+  // DEFAULT: -1 (uses the target's built-in cutover)
+  int max_brute_force_index_size() const;
+  void set_max_brute_force_index_size(int max_brute_force_index_size);
+
  private:
   Distance max_distance_ = Distance::Infinity();
   Delta max_error_ = Delta::Zero();
   const S2Region* region_ = nullptr;
   int max_results_ = kMaxMaxResults;
+  int max_brute_force_index_size_ = -1;
   bool use_brute_force_ = false;
 };
 
@@ -401,6 +412,18 @@ inline void S2ClosestPointQueryBaseOptions<Distance>::set_use_brute_force(
   use_brute_force_ = use_brute_force;
 }
 
+template <class Distance>
+inline int S2ClosestPointQueryBaseOptions<Distance>::
+    max_brute_force_index_size() const {
+  return max_brute_force_index_size_;
+}
+
+template <class Distance>
+inline void S2ClosestPointQueryBaseOptions<Distance>::
+    set_max_brute_force_index_size(int max_brute_force_index_size) {
+  max_brute_force_index_size_ = max_brute_force_index_size;
+}
+
 template <class Distance, class Data>
 S2ClosestPointQueryBase<Distance, Data>::S2ClosestPointQueryBase() = default;
 
@@ -531,7 +554,9 @@ void S2ClosestPointQueryBase<Distance, Data>::FindClosestPointsInternal(
   // and therefore we don't need to worry about the possibility of having
   // duplicate points in the results.
   if (options.use_brute_force() ||
-      index_->num_points() <= target_->max_brute_force_index_size()) {
+      index_->num_points() <= (options.max_brute_force_index_size() >= 0
+                                   ? options.max_brute_force_index_size()
+                                   : target_->max_brute_force_index_size())) {
     FindClosestPointsBruteForce();
   } else {
     FindClosestPointsOptimized();
@@ -24,9 +24,11 @@
 
 #include "s2/base/casts.h"
 #include <gtest/gtest.h>
+#include "absl/types/span.h"
 #include "s2/mutable_s2shape_index.h"
 #include "s2/s1angle.h"
 #include "s2/s2cap.h"
+#include "s2/s2lax_polygon_shape.h"
 #include "s2/s2loop.h"
 #include "s2/s2point.h"
 #include "s2/s2shape.h"
@@ -112,6 +114,21 @@ TEST(S2ContainsPointQuery, VertexModelClosed) {
   EXPECT_TRUE(q2.ShapeContains(2, MakePointOrDie("0:7")));
 }
 
+TEST(S2ContainsPointQuery, CopiedQueryMatchesOriginal) {
+  // Copying an initialized query (e.g. one per server thread) must produce
+  // the same answers as the original.
+  auto index = MakeIndexOrDie("0:0 # -1:1, 1:1 # 0:5, 0:7, 2:6");
+  auto q = MakeS2ContainsPointQuery(index.get(),
+                                    S2ContainsPointQueryOptions(
+                                        S2VertexModel::SEMI_OPEN));
+  q.Contains(MakePointOrDie("1:6"));  // Warm up the iterator.
+  auto copy = q;
+  for (const char* point : {"0:0", "1:6", "0:5", "10:10"}) {
+    EXPECT_EQ(q.Contains(MakePointOrDie(point)),
+              copy.Contains(MakePointOrDie(point)));
+  }
+}
+
 TEST(S2ContainsPointQuery, VisitContainingShapesCanStopEarly) {
   auto index = MakeIndexOrDie("0:0 # 0:0, 1:1 # -1:0, 0:1, 1:0, 0:-1");
   const S2Point kPoint = S2LatLng::FromDegrees(0, 0).ToPoint();
@@ -167,6 +184,70 @@ TEST(S2ContainsPointQuery, GetContainingShapes) {
   }
 }
 
+TEST(S2ContainsPointQuery, ShapeTypeSpecializationMatchesGeneric) {
+  // A query specialized for the concrete shape type must return the same
+  // answers as the generic query under every vertex model.
+  const int kNumVerticesPerLoop = 10;
+  const S1Angle kMaxLoopRadius = S2Testing::KmToAngle(10);
+  const S2Cap center_cap(S2Testing::RandomPoint(), kMaxLoopRadius);
+  MutableS2ShapeIndex index;
+  for (int i = 0; i < 20; ++i) {
+    vector<S2Point> vertices = S2Testing::MakeRegularPoints(
+        S2Testing::SamplePoint(center_cap),
+        S2Testing::rnd.RandDouble() * kMaxLoopRadius, kNumVerticesPerLoop);
+    index.Add(make_unique<S2LaxPolygonShape>(
+        vector<vector<S2Point>>{vertices}));
+  }
+  for (auto model : {S2VertexModel::OPEN, S2VertexModel::SEMI_OPEN,
+                     S2VertexModel::CLOSED}) {
+    S2ContainsPointQueryOptions options(model);
+    auto query = MakeS2ContainsPointQuery(&index, options);
+    auto lax_query =
+        MakeS2ContainsPointQueryForShapeType<S2LaxPolygonShape>(&index,
+                                                                options);
+    for (int i = 0; i < 100; ++i) {
+      S2Point p = S2Testing::SamplePoint(center_cap);
+      EXPECT_EQ(query.Contains(p), lax_query.Contains(p));
+      EXPECT_EQ(query.GetContainingShapeIds(p),
+                lax_query.GetContainingShapeIds(p));
+    }
+    // Vertices exercise the vertex-model specific code paths.
+    const S2Shape* shape0 = index.shape(0);
+    for (int e = 0; e < shape0->num_edges(); ++e) {
+      S2Point p = shape0->edge(e).v0;
+      EXPECT_EQ(query.Contains(p), lax_query.Contains(p));
+    }
+  }
+}
+
+TEST(S2ContainsPointQuery, ContainsPointsMatchesContains) {
+  const int kNumVerticesPerLoop = 10;
+  const S1Angle kMaxLoopRadius = S2Testing::KmToAngle(10);
+  const S2Cap center_cap(S2Testing::RandomPoint(), kMaxLoopRadius);
+  MutableS2ShapeIndex index;
+  for (int i = 0; i < 100; ++i) {
+    unique_ptr<S2Loop> loop = S2Loop::MakeRegularLoop(
+        S2Testing::SamplePoint(center_cap),
+        S2Testing::rnd.RandDouble() * kMaxLoopRadius, kNumVerticesPerLoop);
+    index.Add(make_unique<S2Loop::OwningShape>(std::move(loop)));
+  }
+  // Include some points well outside all of the index cells.
+  vector<S2Point> points;
+  for (int i = 0; i < 200; ++i) {
+    points.push_back(S2Testing::SamplePoint(center_cap));
+  }
+  for (int i = 0; i < 20; ++i) {
+    points.push_back(S2Testing::RandomPoint());
+  }
+  auto query = MakeS2ContainsPointQuery(&index);
+  // Note that absl::Span<bool> cannot be backed by vector<bool>.
+  unique_ptr<bool[]> results(new bool[points.size()]);
+  query.ContainsPoints(points, absl::MakeSpan(results.get(), points.size()));
+  for (size_t i = 0; i < points.size(); ++i) {
+    EXPECT_EQ(query.Contains(points[i]), results[i]);
+  }
+}
+
 using EdgeIdVector = vector<ShapeEdgeId>;
 
 void ExpectIncidentEdgeIds(const EdgeIdVector& expected,
@@ -18,7 +18,9 @@
 #ifndef S2_S2CONTAINS_VERTEX_QUERY_H_
 #define S2_S2CONTAINS_VERTEX_QUERY_H_
 
-#include "absl/container/btree_map.h"
+#include <utility>
+
+#include "absl/container/inlined_vector.h"
 #include "s2/s2point.h"
 
 // This class determines whether a polygon contains one of its vertices given
@@ -31,13 +33,25 @@
 // (see S2VertexModel), which means that if several polygons tile the region
 // around a vertex, then exactly one of those polygons contains that vertex.
 //
+// A single query object may be reused for many vertices by calling Init()
+// between them, which retains the storage for the incident edges.  (Most
+// vertices have few enough incident edges that no allocation happens at all,
+// so constructing a fresh query per vertex is also cheap.)
+//
 // This class is not thread-safe.  To use it in parallel, each thread should
 // construct its own instance (this is not expensive).
 class S2ContainsVertexQuery {
  public:
+  // Creates a query that must be initialized by calling Init().
+  S2ContainsVertexQuery() = default;
+
   // "target" is the vertex whose containment will be determined.
   explicit S2ContainsVertexQuery(const S2Point& target);
 
+  // Starts a new query for the given target vertex, discarding any incident
+  // edges added previously but retaining their storage.
+  void Init(const S2Point& target);
+
   // Indicates that the polygon has an edge between "target" and "v" in the
   // given direction (+1 = outgoing, -1 = incoming, 0 = degenerate).
   void AddEdge(const S2Point& v, int direction);
@@ -48,7 +62,12 @@ class S2ContainsVertexQuery {
 
  private:
   S2Point target_;
-  absl::btree_map<S2Point, int> edge_map_;
+  // The incident edges are stored as a flat map from vertex to direction
+  // sum.  A vertex typically has only a handful of incident edges, so a
+  // linear scan over an inlined vector is faster than an ordered container
+  // and usually avoids heap allocation entirely.  (ContainsSign() does not
+  // depend on the iteration order.)
+  absl::InlinedVector<std::pair<S2Point, int>, 8> edge_map_;
 };
 
 
@@ -59,8 +78,19 @@ inline S2ContainsVertexQuery::S2ContainsVertexQuery(const S2Point& target)
     : target_(target) {
 }
 
+inline void S2ContainsVertexQuery::Init(const S2Point& target) {
+  target_ = target;
+  edge_map_.clear();  // Retains the allocated capacity, if any.
+}
+
 inline void S2ContainsVertexQuery::AddEdge(const S2Point& v, int direction) {
-  edge_map_[v] += direction;
+  for (auto& e : edge_map_) {
+    if (e.first == v) {
+      e.second += direction;
+      return;
+    }
+  }
+  edge_map_.push_back({v, direction});
 }
 
 #endif  // S2_S2CONTAINS_VERTEX_QUERY_H_
@@ -80,3 +80,24 @@ TEST(S2ContainsVertexQuery, CompatibleWithAngleContainsVertexDegenerate) {
   q.AddEdge(a, 1);
   EXPECT_EQ(q.ContainsSign() > 0, S2::AngleContainsVertex(a, b, a));
 }
+
+TEST(S2ContainsVertexQuery, InitReusesQuery) {
+  // A single query object can be reused for several vertices.
+  S2ContainsVertexQuery q;
+  q.Init(MakePointOrDie("0:0"));
+  q.AddEdge(MakePointOrDie("3:-3"), -1);
+  q.AddEdge(MakePointOrDie("1:-5"), 1);
+  EXPECT_EQ(1, q.ContainsSign());
+
+  // Previously added edges must not leak into the next vertex.
+  q.Init(MakePointOrDie("1:1"));
+  q.AddEdge(MakePointOrDie("1:-5"), 1);
+  q.AddEdge(MakePointOrDie("2:-4"), -1);
+  q.AddEdge(MakePointOrDie("3:-3"), 1);
+  EXPECT_EQ(-1, q.ContainsSign());
+
+  q.Init(MakePointOrDie("1:2"));
+  q.AddEdge(MakePointOrDie("3:4"), 1);
+  q.AddEdge(MakePointOrDie("3:4"), -1);
+  EXPECT_EQ(0, q.ContainsSign());
+}
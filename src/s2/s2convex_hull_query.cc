@@ -52,6 +52,7 @@ S2ConvexHullQuery::S2ConvexHullQuery()
 void S2ConvexHullQuery::AddPoint(const S2Point& point) {
   bound_.AddPoint(point);
   points_.push_back(point);
+  MaybeCompactPoints();
 }
 
 void S2ConvexHullQuery::AddPolyline(const S2Polyline& polyline) {
@@ -59,6 +60,7 @@ void S2ConvexHullQuery::AddPolyline(const S2Polyline& polyline) {
   for (int i = 0; i < polyline.num_vertices(); ++i) {
     points_.push_back(polyline.vertex(i));
   }
+  MaybeCompactPoints();
 }
 
 void S2ConvexHullQuery::AddLoop(const S2Loop& loop) {
@@ -71,6 +73,7 @@ void S2ConvexHullQuery::AddLoop(const S2Loop& loop) {
   for (int i = 0; i < loop.num_vertices(); ++i) {
     points_.push_back(loop.vertex(i));
   }
+  MaybeCompactPoints();
 }
 
 void S2ConvexHullQuery::AddPolygon(const S2Polygon& polygon) {
@@ -120,6 +123,36 @@ unique_ptr<S2Loop> S2ConvexHullQuery::GetConvexHull() {
   if (cap.height() >= 1 - 10 * s2pred::DBL_ERR) {
     return make_unique<S2Loop>(S2Loop::kFull());
   }
+  ReducePointsToHull(cap.center().Ortho());
+
+  // Special cases for fewer than 3 points.
+  if (points_.size() < 3) {
+    if (points_.empty()) {
+      return make_unique<S2Loop>(S2Loop::kEmpty());
+    } else if (points_.size() == 1) {
+      return GetSinglePointLoop(points_[0]);
+    } else {
+      return GetSingleEdgeLoop(points_[0], points_[1]);
+    }
+  }
+  // ReducePointsToHull() left the hull vertices in CCW loop order.
+  return make_unique<S2Loop>(points_);
+}
+
+unique_ptr<S2Loop> S2ConvexHullQuery::GetConvexHullAndReset() {
+  unique_ptr<S2Loop> hull = GetConvexHull();
+  bound_ = S2LatLngRect::Empty();
+  points_.clear();  // Retains the allocated capacity.
+  compact_threshold_ = kMinCompactThreshold;
+  return hull;
+}
+
+// Replaces points_ by the vertices of its convex hull, in CCW loop order.
+// (If there are fewer than 3 distinct points, they are simply sorted and
+// deduplicated.)
+//
+// REQUIRES: all points lie within a 180 degree span around "origin".
+void S2ConvexHullQuery::ReducePointsToHull(const S2Point& origin) {
   // This code implements Andrew's monotone chain algorithm, which is a simple
   // variant of the Graham scan.  Rather than sorting by x-coordinate, instead
   // we sort the points in CCW order around an origin O such that all points
@@ -127,23 +160,12 @@ unique_ptr<S2Loop> S2ConvexHullQuery::GetConvexHull() {
   // ensures that as we scan through the points, each new point can only
   // belong at the end of the chain (i.e., the chain is monotone in terms of
   // the angle around O from the starting point).
-  S2Point origin = cap.center().Ortho();
   std::sort(points_.begin(), points_.end(), OrderedCcwAround(origin));
 
   // Remove duplicates.  We need to do this before checking whether there are
   // fewer than 3 points.
   points_.erase(std::unique(points_.begin(), points_.end()), points_.end());
-
-  // Special cases for fewer than 3 points.
-  if (points_.size() < 3) {
-    if (points_.empty()) {
-      return make_unique<S2Loop>(S2Loop::kEmpty());
-    } else if (points_.size() == 1) {
-      return GetSinglePointLoop(points_[0]);
-    } else {
-      return GetSingleEdgeLoop(points_[0], points_[1]);
-    }
-  }
+  if (points_.size() < 3) return;
 
   // Verify that all points lie within a 180 degree span around the origin.
   ABSL_DCHECK_GE(s2pred::Sign(origin, points_.front(), points_.back()), 0);
@@ -151,18 +173,34 @@ unique_ptr<S2Loop> S2ConvexHullQuery::GetConvexHull() {
   // Generate the lower and upper halves of the convex hull.  Each half
   // consists of the maximal subset of vertices such that the edge chain makes
   // only left (CCW) turns.
-  vector<S2Point> lower, upper;
-  GetMonotoneChain(&lower);
+  lower_.clear();
+  upper_.clear();
+  GetMonotoneChain(&lower_);
   std::reverse(points_.begin(), points_.end());
-  GetMonotoneChain(&upper);
+  GetMonotoneChain(&upper_);
 
   // Remove the duplicate vertices and combine the chains.
-  ABSL_DCHECK_EQ(lower.front(), upper.back());
-  ABSL_DCHECK_EQ(lower.back(), upper.front());
-  lower.pop_back();
-  upper.pop_back();
-  lower.insert(lower.end(), upper.begin(), upper.end());
-  return make_unique<S2Loop>(lower);
+  ABSL_DCHECK_EQ(lower_.front(), upper_.back());
+  ABSL_DCHECK_EQ(lower_.back(), upper_.front());
+  lower_.pop_back();
+  upper_.pop_back();
+  lower_.insert(lower_.end(), upper_.begin(), upper_.end());
+  points_.swap(lower_);
+}
+
+// Compacts the buffered points down to their convex hull once enough of
+// them accumulate (see set_incremental).  The threshold doubles with the
+// hull size so that compaction adds only amortized constant work per point.
+void S2ConvexHullQuery::MaybeCompactPoints() {
+  if (!incremental_ || points_.size() < compact_threshold_) return;
+  S2Cap cap = GetCapBound();
+  // Once the bound is no longer convex the hull is the full sphere and no
+  // useful reduction is possible (GetConvexHull() doesn't look at the points
+  // in that case).
+  if (cap.height() < 1 - 10 * s2pred::DBL_ERR) {
+    ReducePointsToHull(cap.center().Ortho());
+  }
+  compact_threshold_ = std::max(kMinCompactThreshold, 2 * points_.size());
 }
 
 // Iterate through the given points, selecting the maximal subset of points
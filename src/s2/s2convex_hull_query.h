@@ -18,6 +18,8 @@
 #ifndef S2_S2CONVEX_HULL_QUERY_H_
 #define S2_S2CONVEX_HULL_QUERY_H_
 
+#include <cstddef>
+
 #include <memory>
 #include <vector>
 
@@ -54,8 +56,9 @@
 // To use this class, call the Add*() methods to add your input geometry, and
 // then call GetConvexHull().  Note that GetConvexHull() does *not* reset the
 // state; you can continue adding geometry if desired and compute the convex
-// hull again.  If you want to start from scratch, simply declare a new
-// S2ConvexHullQuery object (they are cheap to create).
+// hull again.  If you want to start from scratch, call
+// GetConvexHullAndReset() instead, or simply declare a new S2ConvexHullQuery
+// object (they are cheap to create).
 //
 // This class is not thread-safe.  There are no "const" methods.
 class S2ConvexHullQuery {
@@ -96,13 +99,44 @@ class S2ConvexHullQuery {
   // adding to it and call this method again if desired.
   std::unique_ptr<S2Loop> GetConvexHull();
 
+  // Computes the convex hull as in GetConvexHull() and then resets the query
+  // to its initial empty state, retaining the allocated internal buffers.
+  // This is cheaper than constructing a new S2ConvexHullQuery when many
+  // hulls are computed in succession.
+  std::unique_ptr<S2Loop> GetConvexHullAndReset();
+
+  // Specifies that the buffered points should periodically be replaced by
+  // the vertices of their convex hull as further geometry is added.  (This
+  // yields the same results, since the convex hull of a hull's vertices
+  // together with any later input equals the hull of the original input.)
+  // It keeps the memory usage and the amortized cost of each addition
+  // proportional to the size of the hull rather than to the total amount of
+  // geometry added, which matters when maintaining a hull over a long stream
+  // of positions.
+  //
+  // DEFAULT: false
+  bool incremental() const { return incremental_; }
+  void set_incremental(bool incremental) { incremental_ = incremental; }
+
  private:
   void GetMonotoneChain(std::vector<S2Point>* output);
+  void ReducePointsToHull(const S2Point& origin);
+  void MaybeCompactPoints();
   std::unique_ptr<S2Loop> GetSinglePointLoop(const S2Point& p);
   std::unique_ptr<S2Loop> GetSingleEdgeLoop(const S2Point& a, const S2Point& b);
 
+  // The minimum number of buffered points before incremental compaction is
+  // attempted (see set_incremental).
+  static constexpr size_t kMinCompactThreshold = 32;
+
   S2LatLngRect bound_;
   std::vector<S2Point> points_;
+  bool incremental_ = false;
+  size_t compact_threshold_ = kMinCompactThreshold;
+
+  // Scratch space for the monotone chains, retained across hull computations
+  // to avoid reallocation.
+  std::vector<S2Point> lower_, upper_;
 
   S2ConvexHullQuery(const S2ConvexHullQuery&) = delete;
   void operator=(const S2ConvexHullQuery&) = delete;
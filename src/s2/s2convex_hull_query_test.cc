@@ -238,4 +238,44 @@ TEST(S2ConvexHullQuery, PointsInsideHull) {
   }
 }
 
+TEST(S2ConvexHullQuery, IncrementalMatchesBatch) {
+  // Incremental mode periodically compacts the buffered points down to their
+  // convex hull, which must not change the final result.
+  const int kIters = 100;
+  for (int iter = 0; iter < kIters; ++iter) {
+    S2Testing::rnd.Reset(iter + 1);  // Easier to reproduce a specific case.
+    S2Cap cap = S2Testing::GetRandomCap(1e-15, 1.999 * M_PI);
+    S2ConvexHullQuery batch_query, incremental_query;
+    incremental_query.set_incremental(true);
+    for (int i = 0; i < 500; ++i) {
+      S2Point p = S2Testing::SamplePoint(cap);
+      batch_query.AddPoint(p);
+      incremental_query.AddPoint(p);
+    }
+    unique_ptr<S2Loop> expected(batch_query.GetConvexHull());
+    unique_ptr<S2Loop> actual(incremental_query.GetConvexHull());
+    EXPECT_TRUE(actual->BoundaryEquals(*expected)) << "Iteration: " << iter;
+  }
+}
+
+TEST(S2ConvexHullQuery, GetConvexHullAndReset) {
+  S2ConvexHullQuery query;
+  query.AddPoint(MakePointOrDie("0:0"));
+  query.AddPoint(MakePointOrDie("0:10"));
+  query.AddPoint(MakePointOrDie("10:5"));
+  unique_ptr<S2Loop> hull(query.GetConvexHullAndReset());
+  EXPECT_EQ(3, hull->num_vertices());
+
+  // The query is now empty, and can be reused for an unrelated hull.
+  EXPECT_TRUE(query.GetConvexHull()->is_empty());
+  query.AddPoint(MakePointOrDie("-20:0"));
+  query.AddPoint(MakePointOrDie("-20:10"));
+  query.AddPoint(MakePointOrDie("-30:5"));
+  unique_ptr<S2Loop> hull2(query.GetConvexHullAndReset());
+  EXPECT_EQ(3, hull2->num_vertices());
+  for (int i = 0; i < hull2->num_vertices(); ++i) {
+    EXPECT_FALSE(hull->Contains(hull2->vertex(i)));
+  }
+}
+
 }  // namespace
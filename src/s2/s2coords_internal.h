@@ -41,7 +41,13 @@ int constexpr kInvertMask = 0x02;
 // Given a cell orientation and the (i,j)-index of a subcell (0=(0,0),
 // 1=(0,1), 2=(1,0), 3=(1,1)), return the order in which this subcell is
 // visited by the Hilbert curve (a position in the range [0..3]).
-extern const int kIJtoPos[4][4];
+inline constexpr int kIJtoPos[4][4] = {
+  // (0,0) (0,1) (1,0) (1,1)
+  {     0,    1,    3,    2  },  // canonical order
+  {     0,    3,    1,    2  },  // axes swapped
+  {     2,    3,    1,    0  },  // bits inverted
+  {     2,    1,    3,    0  },  // swapped & inverted
+};
 
 // kPosToIJ[orientation][pos] -> ij
 //
@@ -50,7 +56,13 @@ extern const int kIJtoPos[4][4];
 // inverse of the previous table:
 //
 //   kPosToIJ[r][kIJtoPos[r][ij]] == ij
-extern const int kPosToIJ[4][4];
+inline constexpr int kPosToIJ[4][4] = {
+  // 0  1  2  3
+  {  0, 1, 3, 2 },    // canonical order:    (0,0), (0,1), (1,1), (1,0)
+  {  0, 2, 3, 1 },    // axes swapped:       (0,0), (1,0), (1,1), (0,1)
+  {  3, 2, 0, 1 },    // bits inverted:      (1,1), (1,0), (0,0), (0,1)
+  {  3, 1, 0, 2 },    // swapped & inverted: (1,1), (0,1), (0,0), (1,0)
+};
 
 // kPosToOrientation[pos] -> orientation_modifier
 //
@@ -58,7 +70,12 @@ extern const int kPosToIJ[4][4];
 // with the given traversal position [0..3] is related to the orientation
 // of the parent cell.  The modifier should be XOR-ed with the parent
 // orientation to obtain the curve orientation in the child.
-extern const int kPosToOrientation[4];
+inline constexpr int kPosToOrientation[4] = {
+  kSwapMask,
+  0,
+  0,
+  kInvertMask + kSwapMask,
+};
 
 // The U,V,W axes for each face.
 extern const double kFaceUVWAxes[6][3][3];
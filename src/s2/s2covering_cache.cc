@@ -0,0 +1,103 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2covering_cache.h"
+
+#include <utility>
+
+#include "absl/base/casts.h"
+#include "s2/s2cell_id.h"
+#include "s2/s2region.h"
+
+S2CoveringCache::S2CoveringCache(const Options& options)
+    : options_(options), coverer_(options.coverer_options()) {
+  if (options_.memory_tracker() != nullptr) {
+    tracker_client_.Init(options_.memory_tracker(), "S2CoveringCache");
+  }
+}
+
+S2CoveringCache::RegionKey S2CoveringCache::MakeKey(const S2Cap& cap) {
+  const S2Point& center = cap.center();
+  return RegionKey{kCap,
+                   {absl::bit_cast<uint64>(center.x()),
+                    absl::bit_cast<uint64>(center.y()),
+                    absl::bit_cast<uint64>(center.z()),
+                    absl::bit_cast<uint64>(cap.radius().length2())}};
+}
+
+S2CoveringCache::RegionKey S2CoveringCache::MakeKey(const S2LatLngRect& rect) {
+  return RegionKey{kLatLngRect,
+                   {absl::bit_cast<uint64>(rect.lat_lo().radians()),
+                    absl::bit_cast<uint64>(rect.lat_hi().radians()),
+                    absl::bit_cast<uint64>(rect.lng_lo().radians()),
+                    absl::bit_cast<uint64>(rect.lng_hi().radians())}};
+}
+
+int64 S2CoveringCache::EntryBytes(const S2CellUnion& covering) {
+  // An entry consists of a list node, the covering's heap storage, and a
+  // hash table slot (estimated at 2 pointers including the load factor).
+  return sizeof(Entry) + 2 * sizeof(void*) +  // List node links.
+         covering.cell_ids().capacity() * sizeof(S2CellId) +
+         2 * sizeof(void*);  // Hash table slot.
+}
+
+S2CellUnion S2CoveringCache::GetCovering(const S2Cap& cap) {
+  return GetCoveringInternal(MakeKey(cap), cap);
+}
+
+S2CellUnion S2CoveringCache::GetCovering(const S2LatLngRect& rect) {
+  return GetCoveringInternal(MakeKey(rect), rect);
+}
+
+S2CellUnion S2CoveringCache::GetCoveringInternal(const RegionKey& key,
+                                                 const S2Region& region) {
+  auto it = map_.find(key);
+  if (it != map_.end()) {
+    ++hits_;
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return it->second->covering;
+  }
+  ++misses_;
+  S2CellUnion covering = coverer_.GetCovering(region);
+
+  lru_.push_front(Entry{key, covering});
+  map_[key] = lru_.begin();
+  const int64 entry_bytes = EntryBytes(covering);
+  size_bytes_ += entry_bytes;
+  tracker_client_.Tally(entry_bytes);
+
+  // Evict the least-recently-used entries until the cache fits again.  (If a
+  // single covering is larger than max_size_bytes() this evicts the entry we
+  // just inserted, which simply means that such coverings are not cached.)
+  while (size_bytes_ > options_.max_size_bytes() && !lru_.empty()) {
+    RemoveEntry(std::prev(lru_.end()));
+  }
+  return covering;
+}
+
+void S2CoveringCache::RemoveEntry(EntryList::iterator it) {
+  const int64 entry_bytes = EntryBytes(it->covering);
+  size_bytes_ -= entry_bytes;
+  tracker_client_.Tally(-entry_bytes);
+  map_.erase(it->key);
+  lru_.erase(it);
+}
+
+void S2CoveringCache::Clear() {
+  tracker_client_.Tally(-size_bytes_);
+  size_bytes_ = 0;
+  map_.clear();
+  lru_.clear();
+}
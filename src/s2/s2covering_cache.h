@@ -0,0 +1,190 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef S2_S2COVERING_CACHE_H_
+#define S2_S2COVERING_CACHE_H_
+
+#include <array>
+#include <cstddef>
+#include <list>
+
+#include "absl/container/flat_hash_map.h"
+#include "s2/_fp_contract_off.h"
+#include "s2/base/types.h"
+#include "s2/s2cap.h"
+#include "s2/s2cell_union.h"
+#include "s2/s2latlng_rect.h"
+#include "s2/s2memory_tracker.h"
+#include "s2/s2region_coverer.h"
+
+// S2CoveringCache memoizes the output of S2RegionCoverer for region types
+// whose geometry can be fingerprinted exactly (currently S2Cap and
+// S2LatLngRect).  Many serving systems cover the same small set of regions
+// over and over, e.g. viewport rectangles that have been quantized to a
+// fixed grid; with this class each distinct (region, options) combination is
+// covered once and subsequent requests are satisfied by a hash lookup.
+//
+// Example usage:
+//
+//   S2CoveringCache::Options options;
+//   options.mutable_coverer_options()->set_max_cells(8);
+//   S2CoveringCache cache(options);
+//   for (const S2LatLngRect& viewport : requests) {
+//     S2CellUnion covering = cache.GetCovering(viewport);
+//     ...
+//   }
+//
+// Regions are fingerprinted by the bit patterns of their defining
+// coordinates, so two regions hit the same cache entry only if they are
+// bit-for-bit identical (e.g. produced by the same quantization code).  The
+// covering options are fixed when the cache is constructed and therefore do
+// not need to be part of the fingerprint.
+//
+// The cache is bounded: once the memory used by the cached coverings exceeds
+// max_size_bytes(), entries are evicted in least-recently-used order.  The
+// memory usage may also be reported to an S2MemoryTracker, which allows the
+// cache to share a memory budget with other S2 operations.
+//
+// This class is not thread-safe.  Clients that cover regions on multiple
+// threads should use one cache per thread.
+class S2CoveringCache {
+ public:
+  class Options {
+   public:
+    Options() = default;
+
+    // The options used to compute coverings (see S2RegionCoverer).  These
+    // are fixed once the cache is constructed, since cached coverings are
+    // only valid for the options they were computed with.
+    //
+    // DEFAULT: S2RegionCoverer::Options()
+    const S2RegionCoverer::Options& coverer_options() const {
+      return coverer_options_;
+    }
+    S2RegionCoverer::Options* mutable_coverer_options() {
+      return &coverer_options_;
+    }
+
+    // The maximum memory used by cached coverings, including the hash table
+    // and LRU bookkeeping.  When this limit would be exceeded the
+    // least-recently-used entries are evicted.
+    //
+    // DEFAULT: 1 MB (several thousand coverings at the default max_cells).
+    static constexpr int64 kDefaultMaxSizeBytes = 1 << 20;
+    int64 max_size_bytes() const { return max_size_bytes_; }
+    void set_max_size_bytes(int64 max_size_bytes) {
+      max_size_bytes_ = max_size_bytes;
+    }
+
+    // Specifies that memory usage should be tracked by the given object
+    // (which may be shared with other S2 operations).  Note that the cache
+    // is bounded by max_size_bytes() in any case; the tracker is purely
+    // informational.  The tracker is not owned and must outlive the cache.
+    //
+    // DEFAULT: nullptr (memory usage is not tracked)
+    S2MemoryTracker* memory_tracker() const { return memory_tracker_; }
+    void set_memory_tracker(S2MemoryTracker* tracker) {
+      memory_tracker_ = tracker;
+    }
+
+   private:
+    S2RegionCoverer::Options coverer_options_;
+    int64 max_size_bytes_ = kDefaultMaxSizeBytes;
+    S2MemoryTracker* memory_tracker_ = nullptr;
+  };
+
+  S2CoveringCache() : S2CoveringCache(Options()) {}
+  explicit S2CoveringCache(const Options& options);
+
+  // S2CoveringCache is neither copyable nor movable (cached entries refer to
+  // bookkeeping that would be expensive to fix up).
+  S2CoveringCache(const S2CoveringCache&) = delete;
+  S2CoveringCache& operator=(const S2CoveringCache&) = delete;
+
+  const Options& options() const { return options_; }
+
+  // Returns the covering of the given region under coverer_options(),
+  // computing and caching it if no bit-identical region has been covered
+  // recently.
+  S2CellUnion GetCovering(const S2Cap& cap);
+  S2CellUnion GetCovering(const S2LatLngRect& rect);
+
+  // The number of cached coverings.
+  int num_entries() const { return static_cast<int>(lru_.size()); }
+
+  // The estimated memory currently used by the cache.
+  int64 size_bytes() const { return size_bytes_; }
+
+  // The number of GetCovering() calls satisfied from the cache, and the
+  // number that required computing a covering.  Useful for verifying that a
+  // workload actually repeats regions often enough to justify the cache.
+  int64 hits() const { return hits_; }
+  int64 misses() const { return misses_; }
+
+  // Removes all cached entries (the hit/miss counters are unaffected).
+  void Clear();
+
+ private:
+  // A fingerprint of a region's defining coordinates.  Regions of different
+  // types never collide because of the "type" field; within a type, the
+  // coordinate bit patterns are compared exactly.
+  struct RegionKey {
+    int type;                       // One of the RegionType values below.
+    std::array<uint64, 4> params;   // Coordinate bit patterns.
+
+    friend bool operator==(const RegionKey& x, const RegionKey& y) {
+      return x.type == y.type && x.params == y.params;
+    }
+    template <typename H>
+    friend H AbslHashValue(H h, const RegionKey& key) {
+      return H::combine(std::move(h), key.type, key.params);
+    }
+  };
+  enum RegionType { kCap, kLatLngRect };
+
+  struct Entry {
+    RegionKey key;
+    S2CellUnion covering;
+  };
+  using EntryList = std::list<Entry>;
+
+  static RegionKey MakeKey(const S2Cap& cap);
+  static RegionKey MakeKey(const S2LatLngRect& rect);
+
+  // Returns the estimated memory used by an entry with the given covering.
+  static int64 EntryBytes(const S2CellUnion& covering);
+
+  // Looks up "key", computing and caching the covering of "region" on a miss.
+  S2CellUnion GetCoveringInternal(const RegionKey& key,
+                                  const S2Region& region);
+
+  // Removes the given entry and updates the memory bookkeeping.
+  void RemoveEntry(EntryList::iterator it);
+
+  Options options_;
+  S2RegionCoverer coverer_;
+
+  // Entries in most-recently-used order, plus an index into them by region
+  // fingerprint.
+  EntryList lru_;
+  absl::flat_hash_map<RegionKey, EntryList::iterator> map_;
+
+  S2MemoryTracker::Client tracker_client_;
+  int64 size_bytes_ = 0;
+  int64 hits_ = 0;
+  int64 misses_ = 0;
+};
+
+#endif  // S2_S2COVERING_CACHE_H_
@@ -0,0 +1,90 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2covering_cache.h"
+
+#include <gtest/gtest.h>
+
+#include "s2/s1angle.h"
+#include "s2/s2cap.h"
+#include "s2/s2cell_union.h"
+#include "s2/s2latlng.h"
+#include "s2/s2latlng_rect.h"
+#include "s2/s2memory_tracker.h"
+#include "s2/s2region_coverer.h"
+#include "s2/s2testing.h"
+
+namespace {
+
+S2LatLngRect MakeRect(double lat, double lng) {
+  return S2LatLngRect(S2LatLng::FromDegrees(lat, lng),
+                      S2LatLng::FromDegrees(lat + 1, lng + 1));
+}
+
+TEST(S2CoveringCache, MatchesUncachedCoverer) {
+  S2CoveringCache::Options options;
+  options.mutable_coverer_options()->set_max_cells(8);
+  S2CoveringCache cache(options);
+  S2RegionCoverer coverer(options.coverer_options());
+  for (int i = 0; i < 20; ++i) {
+    S2Cap cap(S2Testing::RandomPoint(), S1Angle::Degrees(1));
+    S2LatLngRect rect = MakeRect(-60 + 5 * i, 10 * i);
+    // Query each region twice so that both the miss and hit paths are
+    // exercised.
+    for (int pass = 0; pass < 2; ++pass) {
+      EXPECT_EQ(coverer.GetCovering(cap), cache.GetCovering(cap));
+      EXPECT_EQ(coverer.GetCovering(rect), cache.GetCovering(rect));
+    }
+  }
+  EXPECT_EQ(cache.misses(), 40);
+  EXPECT_EQ(cache.hits(), 40);
+  EXPECT_EQ(cache.num_entries(), 40);
+}
+
+TEST(S2CoveringCache, EvictsLeastRecentlyUsed) {
+  S2CoveringCache::Options options;
+  options.set_max_size_bytes(2000);
+  S2CoveringCache cache(options);
+  int num_entries_at_capacity = 0;
+  for (int i = 0; i < 100; ++i) {
+    cache.GetCovering(MakeRect(-50 + i, 2 * i));
+    EXPECT_LE(cache.size_bytes(), options.max_size_bytes());
+    num_entries_at_capacity = cache.num_entries();
+  }
+  EXPECT_LT(num_entries_at_capacity, 100);
+  EXPECT_GT(num_entries_at_capacity, 0);
+
+  // The most recent region is still cached, the oldest one was evicted.
+  cache.GetCovering(MakeRect(-50 + 99, 2 * 99));
+  EXPECT_EQ(cache.hits(), 1);
+  cache.GetCovering(MakeRect(-50, 0));
+  EXPECT_EQ(cache.misses(), 101);
+}
+
+TEST(S2CoveringCache, TracksMemory) {
+  S2MemoryTracker tracker;
+  S2CoveringCache::Options options;
+  options.set_memory_tracker(&tracker);
+  S2CoveringCache cache(options);
+  EXPECT_EQ(tracker.usage_bytes(), 0);
+  cache.GetCovering(MakeRect(10, 20));
+  EXPECT_EQ(tracker.usage_bytes(), cache.size_bytes());
+  EXPECT_GT(tracker.usage_bytes(), 0);
+  cache.Clear();
+  EXPECT_EQ(tracker.usage_bytes(), 0);
+  EXPECT_EQ(cache.num_entries(), 0);
+}
+
+}  // namespace
@@ -18,9 +18,11 @@
 #include "s2/s2crossing_edge_query.h"
 
 #include <algorithm>
+#include <utility>
 #include <vector>
 
 #include "absl/log/absl_check.h"
+#include "absl/types/span.h"
 #include "s2/r1interval.h"
 #include "s2/r2.h"
 #include "s2/r2rect.h"
@@ -157,6 +159,168 @@ void S2CrossingEdgeQuery::GetCandidates(const S2Point& a0, const S2Point& a1,
   }
 }
 
+void S2CrossingEdgeQuery::GetCandidates(
+    absl::Span<const S2Shape::Edge> query_edges,
+    vector<vector<ShapeEdgeId>>* candidates) {
+  candidates->clear();
+  candidates->resize(query_edges.size());
+  if (query_edges.empty()) return;
+  int num_edges = s2shapeutil::CountEdgesUpTo(*index_, kMaxBruteForceEdges + 1);
+  if (num_edges <= kMaxBruteForceEdges) {
+    // For small indexes every index edge is a candidate for every query edge
+    // (see VisitRawCandidates).
+    vector<ShapeEdgeId> all_edges;
+    all_edges.reserve(num_edges);
+    int num_shape_ids = index_->num_shape_ids();
+    for (int s = 0; s < num_shape_ids; ++s) {
+      const S2Shape* shape = index_->shape(s);
+      if (shape == nullptr) continue;
+      int num_shape_edges = shape->num_edges();
+      for (int e = 0; e < num_shape_edges; ++e) {
+        all_edges.push_back(ShapeEdgeId(s, e));
+      }
+    }
+    for (auto& edges : *candidates) edges = all_edges;
+    return;
+  }
+
+  // Bucket the face segments of every query edge by face, then process each
+  // face with a single recursive traversal shared by all of its segments.
+  batch_candidates_ = candidates;
+  vector<BatchEntry> face_entries[6];
+  for (auto& entries : face_entries) entries = AcquireEntries();
+  S2::FaceSegmentVector segments;
+  for (size_t i = 0; i < query_edges.size(); ++i) {
+    S2::GetFaceSegments(query_edges[i].v0, query_edges[i].v1, &segments);
+    for (const auto& segment : segments) {
+      BatchEntry entry;
+      entry.edge = i;
+      entry.a0 = segment.a;
+      entry.a1 = segment.b;
+      entry.bound = R2Rect::FromPointPair(segment.a, segment.b);
+      face_entries[segment.face].push_back(entry);
+    }
+  }
+  for (int face = 0; face < 6; ++face) {
+    if (!face_entries[face].empty()) {
+      VisitBatchCells(S2PaddedCell(S2CellId::FromFace(face), 0),
+                      face_entries[face]);
+    }
+  }
+  for (auto& entries : face_entries) ReleaseEntries(std::move(entries));
+  batch_candidates_ = nullptr;
+  for (auto& edges : *candidates) {
+    if (edges.size() > 1) {
+      std::sort(edges.begin(), edges.end());
+      edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    }
+  }
+}
+
+// Computes the index cells that are descendants of "pcell" and intersected
+// by one or more of the given batch entries, and records the contents of
+// each such cell as candidates for every entry that reaches it.
+//
+// This is the batch analog of VisitCells() below: instead of one traversal
+// per query edge, all edges that reach "pcell" are clipped and distributed
+// among its children together, so each index cell is located exactly once.
+void S2CrossingEdgeQuery::VisitBatchCells(const S2PaddedCell& pcell,
+                                          const vector<BatchEntry>& entries) {
+  ABSL_DCHECK_EQ(pcell.padding(), 0);
+  iter_.Seek(pcell.id().range_min());
+  if (iter_.done() || iter_.id() > pcell.id().range_max()) {
+    // The index does not contain "pcell" or any of its descendants.
+    return;
+  }
+  if (iter_.id() == pcell.id()) {
+    const S2ShapeIndexCell& cell = iter_.cell();
+    for (int s = 0; s < cell.num_clipped(); ++s) {
+      const S2ClippedShape& clipped = cell.clipped(s);
+      for (int j = 0; j < clipped.num_edges(); ++j) {
+        ShapeEdgeId id(clipped.shape_id(), clipped.edge(j));
+        for (const BatchEntry& entry : entries) {
+          (*batch_candidates_)[entry.edge].push_back(id);
+        }
+      }
+    }
+    return;
+  }
+
+  // Otherwise, split each entry among the four children of "pcell".  The
+  // buffers come from a pool owned by the query so that repeated batches do
+  // not allocate.
+  vector<BatchEntry> child_entries[2][2];
+  for (int i = 0; i < 2; ++i) {
+    for (int j = 0; j < 2; ++j) child_entries[i][j] = AcquireEntries();
+  }
+  R2Point center = pcell.middle().lo();
+  auto add_entry = [&](const BatchEntry& entry, const R2Rect& bound,
+                       int i, int j) {
+    child_entries[i][j].push_back(BatchEntry{entry.edge, entry.a0, entry.a1,
+                                             bound});
+  };
+  // The equivalent of ClipVAxis() below for a single batch entry.
+  auto clip_v_axis = [&](const BatchEntry& entry, const R2Rect& bound, int i) {
+    if (bound[1].hi() < center[1]) {
+      add_entry(entry, bound, i, 0);
+    } else if (bound[1].lo() >= center[1]) {
+      add_entry(entry, bound, i, 1);
+    } else {
+      R2Rect child_bounds[2];
+      SplitVBound(bound, center[1], child_bounds);
+      add_entry(entry, child_bounds[0], i, 0);
+      add_entry(entry, child_bounds[1], i, 1);
+    }
+  };
+  for (const BatchEntry& entry : entries) {
+    // SplitUBound/SplitVBound interpolate along the current edge (a0_, a1_).
+    a0_ = entry.a0;
+    a1_ = entry.a1;
+    if (entry.bound[0].hi() < center[0]) {
+      // Edge is entirely contained in the two left children.
+      clip_v_axis(entry, entry.bound, 0);
+    } else if (entry.bound[0].lo() >= center[0]) {
+      // Edge is entirely contained in the two right children.
+      clip_v_axis(entry, entry.bound, 1);
+    } else {
+      R2Rect child_bounds[2];
+      SplitUBound(entry.bound, center[0], child_bounds);
+      if (entry.bound[1].hi() < center[1]) {
+        // Edge is entirely contained in the two lower children.
+        add_entry(entry, child_bounds[0], 0, 0);
+        add_entry(entry, child_bounds[1], 1, 0);
+      } else if (entry.bound[1].lo() >= center[1]) {
+        // Edge is entirely contained in the two upper children.
+        add_entry(entry, child_bounds[0], 0, 1);
+        add_entry(entry, child_bounds[1], 1, 1);
+      } else {
+        clip_v_axis(entry, child_bounds[0], 0);
+        clip_v_axis(entry, child_bounds[1], 1);
+      }
+    }
+  }
+  for (int i = 0; i < 2; ++i) {
+    for (int j = 0; j < 2; ++j) {
+      if (!child_entries[i][j].empty()) {
+        VisitBatchCells(S2PaddedCell(pcell, i, j), child_entries[i][j]);
+      }
+      ReleaseEntries(std::move(child_entries[i][j]));
+    }
+  }
+}
+
+vector<S2CrossingEdgeQuery::BatchEntry> S2CrossingEdgeQuery::AcquireEntries() {
+  if (entry_pool_.empty()) return {};
+  vector<BatchEntry> entries = std::move(entry_pool_.back());
+  entry_pool_.pop_back();
+  entries.clear();
+  return entries;
+}
+
+void S2CrossingEdgeQuery::ReleaseEntries(vector<BatchEntry> entries) {
+  entry_pool_.push_back(std::move(entries));
+}
+
 bool S2CrossingEdgeQuery::VisitRawCandidates(
     const S2Point& a0, const S2Point& a1, const ShapeEdgeIdVisitor& visitor) {
   int num_edges = s2shapeutil::CountEdgesUpTo(*index_, kMaxBruteForceEdges + 1);
@@ -26,6 +26,7 @@
 #include "absl/base/macros.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/log/absl_check.h"
+#include "absl/types/span.h"
 #include "s2/_fp_contract_off.h"
 #include "s2/r2.h"
 #include "s2/r2rect.h"
@@ -80,8 +81,15 @@ class S2CrossingEdgeQuery {
   S2CrossingEdgeQuery();
   ~S2CrossingEdgeQuery();
 
-  S2CrossingEdgeQuery(const S2CrossingEdgeQuery&) = delete;
-  void operator=(const S2CrossingEdgeQuery&) = delete;
+  // Queries are copyable and movable.  Copying an initialized query gives
+  // each thread its own query object while sharing the underlying index
+  // (which must not be modified while any copy is in use); the copy also
+  // inherits the capacity of the internal scratch containers.  Copies are
+  // independent and may be used concurrently.
+  S2CrossingEdgeQuery(const S2CrossingEdgeQuery&) = default;
+  S2CrossingEdgeQuery& operator=(const S2CrossingEdgeQuery&) = default;
+  S2CrossingEdgeQuery(S2CrossingEdgeQuery&&) = default;
+  S2CrossingEdgeQuery& operator=(S2CrossingEdgeQuery&&) = default;
 
   const S2ShapeIndex& index() const { return *index_; }
 
@@ -139,6 +147,20 @@ class S2CrossingEdgeQuery {
                      const S2Shape& shape,
                      std::vector<s2shapeutil::ShapeEdgeId>* edges);
 
+  // Batch version of GetCandidates() that processes many query edges with a
+  // single traversal of the index.  All query edges that reach a given cell
+  // are clipped and distributed among its children together, so each index
+  // cell is located at most once no matter how many query edges intersect
+  // it.  On return candidates->size() == query_edges.size(), and
+  // (*candidates)[i] contains the sorted, unique candidates for
+  // query_edges[i].
+  //
+  // The temporary buffers used by the traversal are owned by the query
+  // object and reused across calls, so repeated batches do not allocate.
+  void GetCandidates(
+      absl::Span<const S2Shape::Edge> query_edges,
+      std::vector<std::vector<s2shapeutil::ShapeEdgeId>>* candidates);
+
   // A function that is called with each candidate intersecting edge.  The
   // function may return false in order to request that the algorithm should
   // be terminated, i.e. no further crossings are needed.
@@ -194,8 +216,21 @@ class S2CrossingEdgeQuery {
                 std::vector<const S2ShapeIndexCell*>* cells);
 
  private:
+  // A query edge being processed by the batch form of GetCandidates(),
+  // clipped to the current face: the index of the query edge it came from,
+  // the segment endpoints in (u,v)-space, and the clipped bound.
+  struct BatchEntry {
+    int edge;
+    R2Point a0, a1;
+    R2Rect bound;
+  };
+
   // Internal methods are documented with their definitions.
   bool VisitCells(const S2PaddedCell& pcell, const R2Rect& edge_bound);
+  void VisitBatchCells(const S2PaddedCell& pcell,
+                       const std::vector<BatchEntry>& entries);
+  std::vector<BatchEntry> AcquireEntries();
+  void ReleaseEntries(std::vector<BatchEntry> entries);
   bool ClipVAxis(const R2Rect& edge_bound, double center, int i,
                  const S2PaddedCell& pcell);
   void SplitUBound(const R2Rect& edge_bound, double u,
@@ -215,6 +250,13 @@ class S2CrossingEdgeQuery {
 
   // Avoids repeated allocation when methods are called many times.
   std::vector<s2shapeutil::ShapeEdgeId> tmp_candidates_;
+
+  // Output being accumulated by the batch form of GetCandidates().
+  std::vector<std::vector<s2shapeutil::ShapeEdgeId>>* batch_candidates_ =
+      nullptr;
+
+  // Pool of entry buffers reused by VisitBatchCells() across calls.
+  std::vector<std::vector<BatchEntry>> entry_pool_;
 };
 
 
@@ -260,6 +260,62 @@ TEST(GetCrossingCandidates, CapEdgesNearCubeVertex) {
   TestAllCrossings(edges);
 }
 
+TEST(GetCrossingCandidates, BatchMatchesSingleEdge) {
+  // Verifies that the batch version of GetCandidates() returns exactly the
+  // same candidates as querying each edge individually, including query
+  // edges that span multiple faces.
+  const S2Cap cap(S2Point(1, 1, 1).Normalize(), S1Angle::Radians(0.5));
+  vector<TestEdge> index_edges, query_edges;
+  GetCapEdges(cap, S1Angle::Radians(0.1), 100, &index_edges);
+  GetCapEdges(cap, S1Angle::Radians(1.5), 20, &query_edges);
+  auto shape = make_unique<S2EdgeVectorShape>();
+  for (const TestEdge& edge : index_edges) {
+    shape->Add(edge.first, edge.second);
+  }
+  MutableS2ShapeIndex::Options options;
+  options.set_max_edges_per_cell(1);
+  MutableS2ShapeIndex index(options);
+  index.Add(std::move(shape));
+
+  vector<S2Shape::Edge> edges;
+  for (const TestEdge& edge : query_edges) {
+    edges.push_back(S2Shape::Edge(edge.first, edge.second));
+  }
+  S2CrossingEdgeQuery query(&index);
+  vector<vector<ShapeEdgeId>> batch;
+  // Run the batch twice to exercise reuse of the pooled buffers.
+  query.GetCandidates(edges, &batch);
+  query.GetCandidates(edges, &batch);
+  ASSERT_EQ(edges.size(), batch.size());
+  for (size_t i = 0; i < edges.size(); ++i) {
+    EXPECT_EQ(query.GetCandidates(edges[i].v0, edges[i].v1), batch[i]);
+  }
+}
+
+TEST(GetCrossingCandidates, CopiedQueryMatchesOriginal) {
+  // Copying an initialized query (e.g. one per server thread) must produce
+  // the same candidates as the original.
+  const S2Cap cap(S2Point(1, 1, 1).Normalize(), S1Angle::Radians(0.5));
+  vector<TestEdge> index_edges, query_edges;
+  GetCapEdges(cap, S1Angle::Radians(0.1), 100, &index_edges);
+  GetCapEdges(cap, S1Angle::Radians(1.5), 20, &query_edges);
+  auto shape = make_unique<S2EdgeVectorShape>();
+  for (const TestEdge& edge : index_edges) {
+    shape->Add(edge.first, edge.second);
+  }
+  MutableS2ShapeIndex index;
+  index.Add(std::move(shape));
+
+  S2CrossingEdgeQuery query(&index);
+  // Run a query first so that the copy inherits warmed-up scratch storage.
+  query.GetCandidates(query_edges[0].first, query_edges[0].second);
+  S2CrossingEdgeQuery copy = query;
+  for (const TestEdge& edge : query_edges) {
+    EXPECT_EQ(query.GetCandidates(edge.first, edge.second),
+              copy.GetCandidates(edge.first, edge.second));
+  }
+}
+
 TEST(GetCrossingCandidates, DegenerateEdgeOnCellVertexIsItsOwnCandidate) {
   for (int i = 0; i < 100; ++i) {
     vector<TestEdge> edges;
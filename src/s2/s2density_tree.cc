@@ -33,7 +33,9 @@
 #include "absl/container/btree_set.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
+#include "absl/numeric/bits.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "s2/util/coding/coder.h"
 #include "s2/util/coding/varint.h"
 #include "s2/s2cell.h"
@@ -41,6 +43,7 @@
 #include "s2/s2cell_union.h"
 #include "s2/s2density_tree_internal.h"
 #include "s2/s2error.h"
+#include "s2/s2executor.h"
 #include "s2/s2shape.h"
 #include "s2/s2shape_index.h"
 #include "s2/s2shape_index_region.h"
@@ -208,25 +211,88 @@ bool S2DensityTree::InitToShapeDensity(const S2ShapeIndex& index,
       this, error);
 }
 
+bool S2DensityTree::InitToShapeDensity(const S2ShapeIndex& index,
+                                       const ShapeWeightFunction& weight_fn,
+                                       int64 approximate_size_bytes,
+                                       int max_level, S2Error* error,
+                                       int num_threads, S2Executor* executor) {
+  ABSL_DCHECK(error != nullptr) << "error must be non-nullptr";
+  ABSL_DCHECK_GE(num_threads, 1);
+  error->Clear();
+
+  if (num_threads == 1) {
+    return InitToShapeDensity(index, weight_fn, approximate_size_bytes,
+                              max_level, error);
+  }
+
+  // Each worker weighs cells through its own IndexCellWeightFunction, since
+  // the S2ShapeIndexRegion it wraps caches iterator state and is therefore
+  // not safe to share between threads.
+  std::vector<IndexCellWeightFunction> weight_fns;
+  weight_fns.reserve(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    weight_fns.emplace_back(&index, weight_fn);
+  }
+  std::vector<BreadthFirstTreeBuilder::CellWeightFunction> cell_weight_fns;
+  cell_weight_fns.reserve(num_threads);
+  for (IndexCellWeightFunction& fn : weight_fns) {
+    cell_weight_fns.push_back([&fn](const S2CellId cell_id, S2Error* error) {
+      return fn.WeighCell(cell_id, error);
+    });
+  }
+
+  TreeEncoder encoder;
+  BreadthFirstTreeBuilder builder(approximate_size_bytes, max_level, encoder);
+  return builder.Build(cell_weight_fns, executor, this, error);
+}
+
+// Returns the number of vertices in the given shape, which is the weight
+// used by InitToVertexDensity.
+static int64 VertexWeight(const S2Shape& shape) {
+  switch (shape.dimension()) {
+    case 0:
+      return shape.num_chains();
+    case 1:
+      return shape.num_chains() + shape.num_edges();
+    case 2:
+      return shape.num_edges();
+  }
+  ABSL_LOG(ERROR) << "unexpected shape with " << shape.dimension()
+                   << " dimensions";
+  return 0;
+}
+
 bool S2DensityTree::InitToVertexDensity(const S2ShapeIndex& index,
                                         int64 approximate_size_bytes,
                                         int max_level, S2Error* error) {
-  return InitToShapeDensity(
-      index,
-      [&](const S2Shape& shape) {
-        switch (shape.dimension()) {
-          case 0:
-            return shape.num_chains();
-          case 1:
-            return shape.num_chains() + shape.num_edges();
-          case 2:
-            return shape.num_edges();
-        }
-        ABSL_LOG(ERROR) << "unexpected shape with " << shape.dimension()
-                         << " dimensions";
-        return 0;
-      },
-      approximate_size_bytes, max_level, error);
+  return InitToShapeDensity(index, VertexWeight, approximate_size_bytes,
+                            max_level, error);
+}
+
+bool S2DensityTree::InitToVertexDensity(const S2ShapeIndex& index,
+                                        int64 approximate_size_bytes,
+                                        int max_level, S2Error* error,
+                                        int num_threads, S2Executor* executor) {
+  return InitToShapeDensity(index, VertexWeight, approximate_size_bytes,
+                            max_level, error, num_threads, executor);
+}
+
+bool S2DensityTree::AddShapeDensity(const S2ShapeIndex& index,
+                                    const ShapeWeightFunction& weight_fn,
+                                    int64 approximate_size_bytes, int max_level,
+                                    S2Error* error) {
+  ABSL_DCHECK(error != nullptr) << "error must be non-nullptr";
+
+  // Measure just the given index, then fold the result into this tree.
+  S2DensityTree delta;
+  if (!delta.InitToShapeDensity(index, weight_fn, approximate_size_bytes,
+                                max_level, error)) {
+    return false;
+  }
+
+  const S2DensityTree current = std::move(*this);
+  vector<const S2DensityTree*> trees = {&current, &delta};
+  return InitToSumDensity(trees, approximate_size_bytes, max_level, error);
 }
 
 bool S2DensityTree::InitToSumDensity(vector<const S2DensityTree*>& trees,
@@ -515,6 +581,74 @@ btree_map<S2CellId, int64> S2DensityTree::Decode(S2Error* error) const {
   return weights;
 }
 
+bool S2DensityTree::DecodedTree::Init(const S2DensityTree& tree,
+                                      S2Error* error) {
+  ABSL_DCHECK(error != nullptr) << "error must be non-nullptr";
+  error->Clear();
+  face_nodes_.fill(-1);
+  weights_.clear();
+  masks_.clear();
+  first_child_.clear();
+
+  const btree_map<S2CellId, int64> cells = tree.Decode(error);
+  if (!error->ok()) {
+    return false;
+  }
+
+  // Lay the nodes out in level order, using the node arrays themselves as
+  // the breadth-first queue.  'ids' remembers the cell id of each node until
+  // its children have been appended.
+  vector<S2CellId> ids;
+  ids.reserve(cells.size());
+  const auto add_node = [&](S2CellId id, int64 weight) {
+    ids.push_back(id);
+    weights_.push_back(weight);
+    masks_.push_back(0);
+    first_child_.push_back(0);
+  };
+  for (int face = 0; face < S2CellId::kNumFaces; ++face) {
+    const auto iter = cells.find(S2CellId::FromFace(face));
+    if (iter == cells.end()) continue;
+    face_nodes_[face] = static_cast<int32>(ids.size());
+    add_node(iter->first, iter->second);
+  }
+  for (size_t i = 0; i < ids.size(); ++i) {
+    const S2CellId id = ids[i];  // Copied since add_node() reallocates.
+    first_child_[i] = static_cast<uint32>(ids.size());
+    if (id.is_leaf()) continue;
+    for (int k = 0; k < kNumChildrenPerCell; ++k) {
+      const auto iter = cells.find(id.child(k));
+      if (iter == cells.end()) continue;
+      masks_[i] |= 1 << k;
+      add_node(iter->first, iter->second);
+    }
+  }
+  return true;
+}
+
+int64 S2DensityTree::DecodedTree::GetCellWeight(const S2CellId cell_id) const {
+  int32 node = face_nodes_[cell_id.face()];
+  if (node < 0) {
+    return 0;
+  }
+  const int level = cell_id.level();
+  for (int i = 1; i <= level; ++i) {
+    const uint8 mask = masks_[node];
+    if (mask == 0) {
+      // Descendants of a leaf take the leaf's weight, matching
+      // DecodedPath::LoadCell().
+      return weights_[node];
+    }
+    const int child = cell_id.child_position(i);
+    if ((mask & (1 << child)) == 0) {
+      return 0;
+    }
+    node = first_child_[node] +
+           absl::popcount(static_cast<uint32>(mask & ((1 << child) - 1)));
+  }
+  return weights_[node];
+}
+
 bool S2DensityTree::Init(Decoder* decoder, S2Error& error) {
   encoded_ = {decoder->skip(0), decoder->avail()};
   if (encoded_.empty()) {
@@ -621,6 +755,98 @@ bool S2DensityTree::BreadthFirstTreeBuilder::Build(
   return true;
 }
 
+bool S2DensityTree::BreadthFirstTreeBuilder::Build(
+    absl::Span<const CellWeightFunction> weight_fns, S2Executor* executor,
+    S2DensityTree* tree, S2Error* error) const {
+  const int num_threads = static_cast<int>(weight_fns.size());
+  ABSL_DCHECK_GE(num_threads, 1);
+  if (num_threads == 1) {
+    return Build(weight_fns[0], tree, error);
+  }
+  if (executor == nullptr) executor = S2Executor::Default();
+
+  vector<std::pair<S2CellId, S2CellId>> ranges{{
+      S2CellId::Begin(S2CellId::kMaxLevel),
+      S2CellId::End(S2CellId::kMaxLevel),
+  }};
+  vector<std::pair<S2CellId, S2CellId>> next_level_ranges;
+  vector<S2CellId> cells;
+  vector<int64> weights;
+
+  for (int level = 0, size_estimate_bytes = 0;
+       !ranges.empty() && level <= max_level_ &&
+       size_estimate_bytes < approximate_size_bytes_;
+       ++level) {
+    // Gather the cells to be weighed at this level.  Weighing is by far the
+    // most expensive part of building, so the cells are weighed in parallel
+    // and everything else is done serially; this makes the resulting tree
+    // identical to the one built by the serial method above.
+    cells.clear();
+    for (const auto& range : ranges) {
+      for (S2CellId cell_id = range.first.parent(level); cell_id < range.second;
+           cell_id = cell_id.next()) {
+        cells.push_back(cell_id);
+      }
+    }
+
+    weights.resize(cells.size());
+    vector<S2Error> errors(num_threads);
+    executor->Run(num_threads, [&](int thread) {
+      for (size_t i = thread; i < cells.size(); i += num_threads) {
+        weights[i] = weight_fns[thread](cells[i], &errors[thread]);
+        if (!errors[thread].ok()) return;
+      }
+    });
+    for (const S2Error& thread_error : errors) {
+      if (!thread_error.ok()) {
+        *error = thread_error;
+        return false;
+      }
+    }
+
+    S2CellId last_range_end = S2CellId::Sentinel();
+    for (size_t i = 0; i < cells.size(); ++i) {
+      const S2CellId cell_id = cells[i];
+      int64 weight = weights[i];
+
+      if (weight == 0) {
+        // Skip disjoint cells.
+        continue;
+      } else if (weight < 0) {
+        // Get the absolute weight and skip searching the children.
+        weight = -weight;
+      } else {
+        // Add this hilbert range to the ranges to scan at the next level.
+        const S2CellId begin = cell_id.range_min();
+        const S2CellId end = cell_id.range_max().next();
+        if (begin == last_range_end) {
+          // Extend the existing range.
+          next_level_ranges.back().second = end;
+        } else {
+          // Add a new range.
+          next_level_ranges.push_back({begin, end});
+        }
+        last_range_end = end;
+      }
+
+      // Save the weight for repacking later and estimate the size it will
+      // consume.
+      ABSL_DCHECK_LE(weight, kMaxWeight)
+          << "CellIdWeightFn produced weight greater than kMaxWeight: "
+          << weight;
+      encoder_.Put(cell_id, std::min(weight, kMaxWeight));
+      size_estimate_bytes += TreeEncoder::EstimateSize(weight);
+    }
+
+    ranges = std::move(next_level_ranges);
+    // Ensure that the moved-from vector is reset to a known state.
+    next_level_ranges.clear();
+  }
+
+  encoder_.Build(tree);
+  return true;
+}
+
 // Cell ///////////////////////////////////////////
 
 bool S2DensityTree::Cell::Decode(Decoder& decoder, S2Error* error) {
@@ -30,12 +30,14 @@
 #include "absl/container/btree_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/absl_check.h"
+#include "absl/types/span.h"
 #include "s2/util/coding/coder.h"
 #include "s2/s2cell_id.h"
 #include "s2/s2cell_union.h"
 #include "s2/s2coder.h"
 #include "s2/s2density_tree_internal.h"
 #include "s2/s2error.h"
+#include "s2/s2executor.h"
 #include "s2/s2shape.h"
 #include "s2/s2shape_index.h"
 #include "s2/s2shape_index_region.h"
@@ -150,12 +152,48 @@ class S2DensityTree {
                           int64 approximate_size_bytes, int max_level,
                           S2Error* error);
 
+  // Like the method above, but measures the index using "num_threads"
+  // threads, which are run using "executor" (or S2Executor::Default() if
+  // "executor" is nullptr).  The cells at each level are weighed in parallel,
+  // so the resulting tree is identical to the one built by the serial method.
+  // "weight_fn" may be called concurrently from multiple threads.
+  //
+  // REQUIRES: num_threads >= 1
+  bool InitToShapeDensity(const S2ShapeIndex& index,
+                          const ShapeWeightFunction& weight_fn,
+                          int64 approximate_size_bytes, int max_level,
+                          S2Error* error, int num_threads,
+                          S2Executor* executor = nullptr);
+
   // A wrapper around InitToShapeDensity which uses the number of vertices in
   // each shape to calculate weights.
   bool InitToVertexDensity(const S2ShapeIndex& index,
                            int64 approximate_size_bytes, int max_level,
                            S2Error* error);
 
+  // Like the method above, but measures the index using "num_threads"
+  // threads (see InitToShapeDensity above).
+  //
+  // REQUIRES: num_threads >= 1
+  bool InitToVertexDensity(const S2ShapeIndex& index,
+                           int64 approximate_size_bytes, int max_level,
+                           S2Error* error, int num_threads,
+                           S2Executor* executor = nullptr);
+
+  // Replaces this tree with the sum of itself and the density measured from
+  // the given index.  This makes it possible to add the weight of newly
+  // arrived shapes incrementally: put just the new shapes in their own
+  // S2ShapeIndex, measure it, and fold the result into the existing tree
+  // rather than re-measuring everything.  The combined tree is held to the
+  // given size and level limits, so the operation may be lossy if this tree
+  // is more detailed than those limits allow.
+  //
+  // REQUIRES: this tree has been initialized.
+  bool AddShapeDensity(const S2ShapeIndex& index,
+                       const ShapeWeightFunction& weight_fn,
+                       int64 approximate_size_bytes, int max_level,
+                       S2Error* error);
+
   // Type definition for a function that returns a pointer to the associated T
   // for a given S2Shape. This function is allowed to return nullptr if the user
   // wishes not to create an association to a given S2Shape.
@@ -336,6 +374,45 @@ class S2DensityTree {
     S2CellId last_ = S2CellId::Sentinel();
   };
 
+  // A flat, fully-decoded representation of the tree for lookup-heavy
+  // workloads.  The nodes are stored in level order with the weights in one
+  // contiguous array, and child navigation is done through per-node child
+  // masks and first-child offsets, so a weight lookup costs a few array
+  // probes per level instead of re-parsing varints.  Compared with Decode()
+  // this avoids the per-lookup map search, and compared with DecodedPath
+  // there is a one-time build cost but no decoding at all afterwards.  A
+  // DecodedTree is immutable once built and may be shared freely between
+  // threads.
+  class DecodedTree {
+   public:
+    DecodedTree() = default;
+
+    // Builds the decoded form of the given tree, replacing any previous
+    // contents.  Returns false if the tree could not be decoded, in which
+    // case 'error' describes the problem.  The tree is not retained and may
+    // be destroyed once this method returns.
+    bool Init(const S2DensityTree& tree, S2Error* error);
+
+    // Returns the weight of the given cell.  The result matches
+    // S2DensityTree::GetCellWeight(): descendants of a leaf of the tree
+    // return the leaf's weight, and cells that are otherwise not present
+    // return zero.
+    int64 GetCellWeight(S2CellId cell_id) const;
+
+    // Returns the number of cells in the tree.
+    size_t num_cells() const { return weights_.size(); }
+
+   private:
+    // Nodes are stored in level order (the face cells, then all their
+    // children, and so on).  Node i has a bit set in masks_[i] for each
+    // child present in the tree, and its children are stored consecutively
+    // in child position order starting at node first_child_[i].
+    std::array<int32, S2CellId::kNumFaces> face_nodes_{-1, -1, -1, -1, -1, -1};
+    std::vector<int64> weights_;
+    std::vector<uint8> masks_;
+    std::vector<uint32> first_child_;
+  };
+
  private:
   // A reusable measurer of shape index density that computes the weight at
   // each cell the index intersects, as the sum of the weight_fn for each shape
@@ -432,6 +509,13 @@ class S2DensityTree {
     bool Build(const CellWeightFunction& weight_fn, S2DensityTree* tree,
                S2Error* error) const;
 
+    // Like the method above, but weighs the cells at each level in parallel,
+    // with worker i weighing cells through weight_fns[i].  The workers are
+    // run using "executor" (or S2Executor::Default() if "executor" is
+    // nullptr).  The resulting tree is identical to the serial build.
+    bool Build(absl::Span<const CellWeightFunction> weight_fns,
+               S2Executor* executor, S2DensityTree* tree, S2Error* error) const;
+
    private:
     const int64 approximate_size_bytes_;
     const int max_level_;
@@ -374,6 +374,68 @@ TEST(S2DensityTreeTest, S2CoderWorks_UninitializedTree) {
   EXPECT_THAT(cell_map, testing::IsEmpty());
 }
 
+TEST(S2DensityTreeTest, ParallelInitMatchesSerial) {
+  MutableS2ShapeIndex index;
+  vector<S2Point> points;
+  for (int i = 0; i < 1000; ++i) {
+    points.push_back(S2Testing::RandomPoint());
+  }
+  index.Add(make_unique<S2PointVectorShape>(points));
+
+  S2DensityTree serial;
+  S2Error error;
+  ASSERT_TRUE(serial.InitToVertexDensity(index, 10'000, 12, &error)) << error;
+  absl::btree_map<S2CellId, int64> expected = serial.Decode(&error);
+  ASSERT_TRUE(error.ok()) << error;
+
+  for (int num_threads : {2, 4}) {
+    SCOPED_TRACE(num_threads);
+    S2DensityTree parallel;
+    ASSERT_TRUE(parallel.InitToVertexDensity(index, 10'000, 12, &error,
+                                             num_threads))
+        << error;
+    EXPECT_EQ(expected, parallel.Decode(&error));
+    EXPECT_TRUE(error.ok()) << error;
+  }
+}
+
+TEST(S2DensityTreeTest, AddShapeDensity) {
+  // Measure two indexes incrementally and verify that the result matches an
+  // explicit sum of the two individually measured trees.
+  MutableS2ShapeIndex index1, index2;
+  vector<S2Point> points1, points2;
+  for (int i = 0; i < 100; ++i) {
+    points1.push_back(S2Testing::RandomPoint());
+    points2.push_back(S2Testing::RandomPoint());
+  }
+  index1.Add(make_unique<S2PointVectorShape>(points1));
+  index2.Add(make_unique<S2PointVectorShape>(points2));
+
+  const auto weight_fn = [](const S2Shape& shape) -> int64 {
+    return shape.num_chains();
+  };
+
+  S2Error error;
+  S2DensityTree incremental;
+  ASSERT_TRUE(incremental.InitToShapeDensity(index1, weight_fn, 10'000, 12,
+                                             &error))
+      << error;
+  ASSERT_TRUE(incremental.AddShapeDensity(index2, weight_fn, 10'000, 12,
+                                          &error))
+      << error;
+
+  S2DensityTree tree1, tree2, sum;
+  ASSERT_TRUE(tree1.InitToShapeDensity(index1, weight_fn, 10'000, 12, &error))
+      << error;
+  ASSERT_TRUE(tree2.InitToShapeDensity(index2, weight_fn, 10'000, 12, &error))
+      << error;
+  vector<const S2DensityTree*> trees = {&tree1, &tree2};
+  ASSERT_TRUE(sum.InitToSumDensity(trees, 10'000, 12, &error)) << error;
+
+  EXPECT_EQ(sum.Decode(&error), incremental.Decode(&error));
+  EXPECT_TRUE(error.ok()) << error;
+}
+
 TEST(S2DensityTreeTest, InitToFeatureDensity) {
   MutableS2ShapeIndex index;
 
@@ -537,6 +599,50 @@ TEST_F(DecodedPathTest, DecodesPathsCorrectly) {
   }
 }
 
+class DecodedTreeTest : public TreeEncoderTest {};
+
+TEST_F(DecodedTreeTest, MatchesDecodedPathLookups) {
+  const S2CellId kCell22 = S2CellId::FromFace(2).child(2);
+
+  const absl::btree_map<S2CellId, int64> base = {{kCell22.child(2), 100},
+                                                   {kCell22.child(3), 120},
+                                                   {S2CellId::FromFace(4), 7}};
+
+  for (const auto& weighted_cell : SumToRoot(base)) {
+    Put(weighted_cell.first, weighted_cell.second);
+  }
+  S2DensityTree tree = BuildTree();
+
+  S2Error error;
+  S2DensityTree::DecodedTree decoded;
+  ASSERT_TRUE(decoded.Init(tree, &error)) << error;
+  EXPECT_EQ(tree.Decode(&error).size(), decoded.num_cells());
+
+  // The decoded form must agree with DecodedPath-based lookups everywhere:
+  // for cells in the tree, for their missing siblings, for cells below the
+  // leaves, and on faces that are absent entirely.
+  S2DensityTree::DecodedPath path(&tree);
+  const auto ExpectSameWeight = [&](S2CellId id) {
+    S2Error error;
+    EXPECT_EQ(tree.GetCellWeight(id, &path, &error),
+              decoded.GetCellWeight(id))
+        << id;
+    EXPECT_TRUE(error.ok());
+  };
+  for (int face = 0; face < S2CellId::kNumFaces; ++face) {
+    ExpectSameWeight(S2CellId::FromFace(face));
+  }
+  for (const auto& [cell_id, weight] : tree.Decode(&error)) {
+    ExpectSameWeight(cell_id);
+    if (cell_id.is_leaf()) continue;
+    for (int k = 0; k < 4; ++k) {
+      ExpectSameWeight(cell_id.child(k));
+      // Descendants of leaves of the tree resolve to the leaf's weight.
+      ExpectSameWeight(cell_id.child(k).child_begin(S2CellId::kMaxLevel));
+    }
+  }
+}
+
 class GetPartitioningTest : public TreeEncoderTest {};
 
 TEST_F(GetPartitioningTest, RemovesPointlessSplits) {
@@ -20,8 +20,11 @@
 #include <algorithm>
 #include <cfloat>
 #include <cmath>
+#include <cstddef>
+#include <vector>
 
 #include "absl/log/absl_check.h"
+#include "absl/types/span.h"
 #include "s2/r1interval.h"
 #include "s2/r2.h"
 #include "s2/r2rect.h"
@@ -361,6 +364,59 @@ bool ClipToPaddedFace(const S2Point& a_xyz, const S2Point& b_xyz, int face,
   return a_score + b_score < 3;
 }
 
+void ClipEdgesToPaddedFace(absl::Span<const S2Point> a,
+                           absl::Span<const S2Point> b, int face,
+                           double padding,
+                           std::vector<ClippedBatchEdge>* clipped) {
+  ABSL_DCHECK_EQ(a.size(), b.size());
+  ABSL_DCHECK_GE(padding, 0);
+
+  // Edges are processed in small chunks.  A first, branch-free pass over
+  // each chunk projects both endpoints into the (u,v,w) coordinates of the
+  // given face and tests whether they lie strictly on it; this loop consists
+  // of independent multiply/compare operations that compilers can vectorize.
+  // A second pass emits the results, falling back to ClipToPaddedFace() for
+  // the edges that the first pass could not decide.  (An endpoint exactly on
+  // a face boundary fails the strict test and takes the fallback, which
+  // applies the same tie-breaking rules as the scalar code.)
+  constexpr int kChunkSize = 32;
+  double a_u[kChunkSize], a_v[kChunkSize], a_w[kChunkSize];
+  double b_u[kChunkSize], b_v[kChunkSize], b_w[kChunkSize];
+  bool on_face[kChunkSize];
+  const S2Point u_axis = GetUAxis(face);
+  const S2Point v_axis = GetVAxis(face);
+  const S2Point n_axis = GetNorm(face);
+  for (size_t begin = 0; begin < a.size(); begin += kChunkSize) {
+    const int n = std::min(a.size() - begin, size_t{kChunkSize});
+    for (int j = 0; j < n; ++j) {
+      const S2Point& p = a[begin + j];
+      const S2Point& q = b[begin + j];
+      a_u[j] = p.DotProd(u_axis);
+      a_v[j] = p.DotProd(v_axis);
+      a_w[j] = p.DotProd(n_axis);
+      b_u[j] = q.DotProd(u_axis);
+      b_v[j] = q.DotProd(v_axis);
+      b_w[j] = q.DotProd(n_axis);
+      // Equivalent to GetFace(p) == face && GetFace(q) == face, except that
+      // ties (which GetFace breaks by axis order) are left to the fallback.
+      on_face[j] = fabs(a_u[j]) < a_w[j] && fabs(a_v[j]) < a_w[j] &&
+                   fabs(b_u[j]) < b_w[j] && fabs(b_v[j]) < b_w[j];
+    }
+    for (int j = 0; j < n; ++j) {
+      const int i = begin + j;
+      if (on_face[j]) {
+        clipped->push_back({i, R2Point(a_u[j] / a_w[j], a_v[j] / a_w[j]),
+                            R2Point(b_u[j] / b_w[j], b_v[j] / b_w[j])});
+      } else {
+        ClippedBatchEdge edge{i, R2Point(), R2Point()};
+        if (ClipToPaddedFace(a[i], b[i], face, padding, &edge.a, &edge.b)) {
+          clipped->push_back(edge);
+        }
+      }
+    }
+  }
+}
+
 bool IntersectsRect(const R2Point& a, const R2Point& b, const R2Rect& rect) {
   // First check whether the bound of AB intersects "rect".
   R2Rect bound = R2Rect::FromPointPair(a, b);
@@ -449,4 +505,38 @@ bool ClipEdge(const R2Point& a, const R2Point& b, const R2Rect& clip,
   return false;
 }
 
+void ClipEdgesToRect(absl::Span<const R2Point> a, absl::Span<const R2Point> b,
+                     const R2Rect& clip,
+                     std::vector<ClippedBatchEdge>* clipped) {
+  ABSL_DCHECK_EQ(a.size(), b.size());
+
+  // Like ClipEdgesToPaddedFace(), edges are processed in small chunks.  The
+  // first pass over each chunk tests the bounding box of every edge against
+  // "clip" with branch-free interval comparisons that compilers can
+  // vectorize, and the second pass runs ClipEdge() only on the edges that
+  // survive.  The prefilter matches the initial bound rejection in
+  // ClipEdgeBound(), so the results are identical to per-edge calls.
+  constexpr int kChunkSize = 32;
+  bool maybe[kChunkSize];
+  const double x_lo = clip[0].lo(), x_hi = clip[0].hi();
+  const double y_lo = clip[1].lo(), y_hi = clip[1].hi();
+  for (size_t begin = 0; begin < a.size(); begin += kChunkSize) {
+    const int n = std::min(a.size() - begin, size_t{kChunkSize});
+    for (int j = 0; j < n; ++j) {
+      const R2Point& p = a[begin + j];
+      const R2Point& q = b[begin + j];
+      maybe[j] = max(p[0], q[0]) >= x_lo && min(p[0], q[0]) <= x_hi &&
+                 max(p[1], q[1]) >= y_lo && min(p[1], q[1]) <= y_hi;
+    }
+    for (int j = 0; j < n; ++j) {
+      const int i = begin + j;
+      if (!maybe[j]) continue;
+      ClippedBatchEdge edge{i, R2Point(), R2Point()};
+      if (ClipEdge(a[i], b[i], clip, &edge.a, &edge.b)) {
+        clipped->push_back(edge);
+      }
+    }
+  }
+}
+
 }  // namespace S2
@@ -30,9 +30,11 @@
 
 #include <cfloat>
 #include <cmath>
+#include <vector>
 
 #include "absl/container/inlined_vector.h"
 #include "absl/log/absl_check.h"
+#include "absl/types/span.h"
 #include "s2/_fp_contract_off.h"
 #include "s2/r2.h"
 #include "s2/r2rect.h"
@@ -79,6 +81,29 @@ bool ClipToFace(const S2Point& a, const S2Point& b, int face,
 bool ClipToPaddedFace(const S2Point& a, const S2Point& b, int face,
                       double padding, R2Point* a_uv, R2Point* b_uv);
 
+// The result of clipping one edge of a batch (see ClipEdgesToPaddedFace and
+// ClipEdgesToRect).  "index" is the position of the edge within the input
+// spans, and (a, b) are the clipped endpoints.
+struct ClippedBatchEdge {
+  int index;
+  R2Point a, b;
+};
+
+// Batch version of ClipToPaddedFace().  Clips every edge (a[i], b[i]) to the
+// given padded face, appending an entry to "clipped" for each edge that
+// intersects it, in order of increasing input index.  The results are
+// identical to calling ClipToPaddedFace() once per edge, but the common case
+// where both endpoints project directly onto the face is detected by a
+// branch-free pass over the input that compilers can vectorize.  (This is
+// the typical case during index construction, where most edges are short and
+// far from any face boundary.)
+//
+// REQUIRES: a.size() == b.size()
+void ClipEdgesToPaddedFace(absl::Span<const S2Point> a,
+                           absl::Span<const S2Point> b, int face,
+                           double padding,
+                           std::vector<ClippedBatchEdge>* clipped);
+
 // The maximum error in the vertices returned by GetFaceSegments and
 // ClipToFace (compared to an exact calculation):
 //
@@ -117,6 +142,18 @@ constexpr double kIntersectsRectErrorUVDist = 3 * M_SQRT2 * DBL_EPSILON;
 bool ClipEdge(const R2Point& a, const R2Point& b, const R2Rect& clip,
               R2Point* a_clipped, R2Point* b_clipped);
 
+// Batch version of ClipEdge().  Clips every (u,v) edge (a[i], b[i]) to the
+// given rectangle, appending an entry to "clipped" for each edge with a
+// non-empty intersection, in order of increasing input index.  The results
+// are identical to calling ClipEdge() once per edge, but edges whose
+// bounding box misses "clip" are rejected by a branch-free pass over the
+// input that compilers can vectorize.
+//
+// REQUIRES: a.size() == b.size()
+void ClipEdgesToRect(absl::Span<const R2Point> a, absl::Span<const R2Point> b,
+                     const R2Rect& clip,
+                     std::vector<ClippedBatchEdge>* clipped);
+
 // Given an edge AB and a rectangle "clip", returns the bounding rectangle of
 // the portion of AB intersected by "clip".  The resulting bound may be
 // empty.  This is a convenience function built on top of ClipEdgeBound.
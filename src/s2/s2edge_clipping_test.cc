@@ -344,3 +344,73 @@ TEST(S2, EdgeClipping) {
   TestEdgeClipping(R2Rect::FromPoint(R2Point(0.3, 0.8)));
   TestEdgeClipping(R2Rect::Empty());
 }
+
+TEST(S2, ClipEdgesToPaddedFaceMatchesScalar) {
+  // The batch kernel must produce exactly the same clipped edges as calling
+  // ClipToPaddedFace() once per edge, including for edges that lie on or
+  // near face boundaries.
+  S2Testing::Random* rnd = &S2Testing::rnd;
+  vector<S2Point> a, b;
+  for (int i = 0; i < 500; ++i) {
+    // A mix of short edges well inside a face (the vectorized fast path),
+    // and edges between random faces (the fallback path).
+    if (rnd->OneIn(2)) {
+      S2Point p = S2Testing::RandomPoint();
+      a.push_back(p);
+      b.push_back((p + 1e-6 * S2Testing::RandomPoint()).Normalize());
+    } else {
+      a.push_back(S2Testing::RandomPoint());
+      b.push_back(S2Testing::RandomPoint());
+    }
+  }
+  // Some edges with endpoints exactly on face boundaries.
+  a.push_back(S2Point(1, 1, 0).Normalize());
+  b.push_back(S2Point(1, -1, 0).Normalize());
+  a.push_back(S2Point(1, 1, 1).Normalize());
+  b.push_back(S2Point(0, 0, 1));
+  for (int face = 0; face < 6; ++face) {
+    for (double padding : {0.0, 1e-3}) {
+      vector<S2::ClippedBatchEdge> batch;
+      S2::ClipEdgesToPaddedFace(a, b, face, padding, &batch);
+      size_t n = 0;
+      for (size_t i = 0; i < a.size(); ++i) {
+        R2Point a_uv, b_uv;
+        if (!S2::ClipToPaddedFace(a[i], b[i], face, padding, &a_uv, &b_uv)) {
+          continue;
+        }
+        ASSERT_LT(n, batch.size());
+        EXPECT_EQ(static_cast<int>(i), batch[n].index);
+        EXPECT_EQ(a_uv, batch[n].a);
+        EXPECT_EQ(b_uv, batch[n].b);
+        ++n;
+      }
+      EXPECT_EQ(n, batch.size());
+    }
+  }
+}
+
+TEST(S2, ClipEdgesToRectMatchesScalar) {
+  S2Testing::Random* rnd = &S2Testing::rnd;
+  const R2Rect clip(R1Interval(-0.4, 0.3), R1Interval(0.1, 0.6));
+  vector<R2Point> a, b;
+  for (int i = 0; i < 500; ++i) {
+    a.push_back(ChooseEndpoint(clip));
+    b.push_back(ChooseEndpoint(clip));
+    // Also include edges entirely outside the clip rectangle.
+    a.push_back(R2Point(rnd->UniformDouble(0.5, 1), rnd->UniformDouble(-1, 0)));
+    b.push_back(R2Point(rnd->UniformDouble(0.5, 1), rnd->UniformDouble(-1, 0)));
+  }
+  vector<S2::ClippedBatchEdge> batch;
+  S2::ClipEdgesToRect(a, b, clip, &batch);
+  size_t n = 0;
+  for (size_t i = 0; i < a.size(); ++i) {
+    R2Point a_clipped, b_clipped;
+    if (!S2::ClipEdge(a[i], b[i], clip, &a_clipped, &b_clipped)) continue;
+    ASSERT_LT(n, batch.size());
+    EXPECT_EQ(static_cast<int>(i), batch[n].index);
+    EXPECT_EQ(a_clipped, batch[n].a);
+    EXPECT_EQ(b_clipped, batch[n].b);
+    ++n;
+  }
+  EXPECT_EQ(n, batch.size());
+}
@@ -19,12 +19,17 @@
 
 #include <cfloat>
 #include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
 
 #include "absl/log/absl_check.h"
+#include "absl/types/span.h"
 #include "s2/s2edge_crossings.h"
 #include "s2/s2edge_crossings_internal.h"
 #include "s2/s2point.h"
 #include "s2/s2predicates.h"
+#include "s2/s2shape.h"
 
 template <class PointRep>
 int S2EdgeCrosserBase<PointRep>::CrossingSignInternal(PointRep d) {
@@ -96,7 +101,84 @@ inline int S2EdgeCrosserBase<PointRep>::CrossingSignInternal2(
   return (dac != acb_) ? -1 : 1;
 }
 
+template <class PointRep>
+void S2EdgeCrosserBase<PointRep>::CrossingSigns(
+    absl::Span<const S2Shape::Edge> edges, absl::Span<int> crossing_signs) {
+  ABSL_DCHECK_EQ(edges.size(), crossing_signs.size());
+
+  // First pass: triage both endpoints of every edge against the great circle
+  // through AB in one tight loop, keeping the precomputed values A, B, and
+  // A x B hot.  If C and D are strictly on the same side of the great circle
+  // then CD cannot cross AB; this resolves the vast majority of candidates
+  // (see CrossingSign).  When consecutive edges form a chain, the previous
+  // result for D is reused as the result for C, just as the edge chain
+  // methods do.
+  int prev_sign = 0;
+  const S2Point* prev_d = nullptr;
+  for (size_t i = 0; i < edges.size(); ++i) {
+    const S2Shape::Edge& edge = edges[i];
+    int c_sign = (prev_d != nullptr && edge.v0 == *prev_d)
+                     ? prev_sign
+                     : s2pred::TriageSign(*a_, *b_, edge.v0, a_cross_b_);
+    int d_sign = s2pred::TriageSign(*a_, *b_, edge.v1, a_cross_b_);
+    prev_sign = d_sign;
+    prev_d = &edge.v1;
+    // The value 2 is not a legal crossing sign; it marks edges that need the
+    // full test in the second pass.
+    crossing_signs[i] = (c_sign == d_sign && c_sign != 0) ? -1 : 2;
+  }
+
+  // Second pass: resolve the remaining candidates with the full test.
+  for (size_t i = 0; i < edges.size(); ++i) {
+    if (crossing_signs[i] != 2) continue;
+    const S2Shape::Edge& edge = edges[i];
+    if constexpr (std::is_pointer<ArgType>::value) {
+      crossing_signs[i] = CrossingSign(&edge.v0, &edge.v1);
+    } else {
+      crossing_signs[i] = CrossingSign(edge.v0, edge.v1);
+    }
+  }
+}
+
 // Explicitly instantiate the classes we need so that the methods above can be
 // omitted from the .h file (and to reduce compilation time).
 template class S2EdgeCrosserBase<S2::internal::S2Point_PointerRep>;
 template class S2EdgeCrosserBase<S2::internal::S2Point_ValueRep>;
+
+namespace S2 {
+
+bool ChainsCross(absl::Span<const S2Point> a, absl::Span<const S2Point> b) {
+  if (a.size() < 2 || b.size() < 2) return false;
+  S2EdgeCrosser crosser(&a[0], &a[1], &b[0]);
+  for (size_t i = 1;;) {
+    for (size_t j = 1; j < b.size(); ++j) {
+      if (crosser.CrossingSign(&b[j]) >= 0) return true;
+    }
+    if (++i >= a.size()) return false;
+    crosser.Init(&a[i - 1], &a[i]);
+    crosser.RestartAt(&b[0]);
+  }
+}
+
+void GetChainCrossingsBitmap(absl::Span<const S2Point> a,
+                             absl::Span<const S2Point> b,
+                             std::vector<uint64>* bitmap) {
+  size_t num_a_edges = a.size() < 2 ? 0 : a.size() - 1;
+  size_t num_b_edges = b.size() < 2 ? 0 : b.size() - 1;
+  size_t words_per_row = (num_b_edges + 63) / 64;
+  bitmap->assign(num_a_edges * words_per_row, 0);
+  if (num_a_edges == 0 || num_b_edges == 0) return;
+  S2EdgeCrosser crosser;
+  for (size_t i = 0; i < num_a_edges; ++i) {
+    crosser.Init(&a[i], &a[i + 1]);
+    crosser.RestartAt(&b[0]);
+    uint64* row = bitmap->data() + i * words_per_row;
+    for (size_t j = 0; j < num_b_edges; ++j) {
+      if (crosser.CrossingSign(&b[j + 1]) >= 0) {
+        row[j / 64] |= uint64{1} << (j % 64);
+      }
+    }
+  }
+}
+
+}  // namespace S2
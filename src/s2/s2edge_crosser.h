@@ -18,13 +18,18 @@
 #ifndef S2_S2EDGE_CROSSER_H_
 #define S2_S2EDGE_CROSSER_H_
 
+#include <vector>
+
 #include "absl/log/absl_check.h"
+#include "absl/types/span.h"
 #include "s2/_fp_contract_off.h"
+#include "s2/base/types.h"
 #include "s2/s2edge_crossings.h"
 #include "s2/s2edge_crossings_internal.h"
 #include "s2/s2point.h"
 #include "s2/s2pointutil.h"
 #include "s2/s2predicates.h"
+#include "s2/s2shape.h"
 
 // This file defines two classes S2EdgeCrosser and S2CopyingEdgeCrosser that
 // allow edges to be efficiently tested for intersection with a given fixed
@@ -135,6 +140,22 @@ class S2EdgeCrosserBase {
   // int S2CopyingEdgeCrosser::CrossingSign(const S2Point& c, const S2Point& d);
   int CrossingSign(ArgType c, ArgType d);
 
+  // Computes CrossingSign(edge.v0, edge.v1) for a batch of candidate edges,
+  // writing the results to "crossing_signs".  This is equivalent to (but
+  // faster than) calling CrossingSign() once per edge: the endpoints of all
+  // edges are first triaged against the great circle through AB in one tight
+  // loop, which resolves the vast majority of candidates, and only the
+  // remaining edges are passed to the full crossing test.  When consecutive
+  // edges form a chain (edges[i].v1 == edges[i+1].v0) the shared vertex is
+  // only triaged once.
+  //
+  // Afterwards the state used by the edge chain methods below is unspecified;
+  // call RestartAt() before using the single-argument methods again.
+  //
+  // REQUIRES: crossing_signs.size() == edges.size()
+  void CrossingSigns(absl::Span<const S2Shape::Edge> edges,
+                     absl::Span<int> crossing_signs);
+
   // This method extends the concept of a "crossing" to the case where AB
   // and CD have a vertex in common.  The two edges may or may not cross,
   // according to the rules defined in VertexCrossing() below.  The rules
@@ -292,6 +313,34 @@ using S2EdgeCrosser = S2EdgeCrosserBase<S2::internal::S2Point_PointerRep>;
 // are generated on demand and cannot conveniently be stored by the client.
 using S2CopyingEdgeCrosser = S2EdgeCrosserBase<S2::internal::S2Point_ValueRep>;
 
+namespace S2 {
+
+// Returns true if any edge of the vertex chain A crosses or touches any edge
+// of the vertex chain B, i.e. CrossingSign() >= 0 for some pair of edges.  A
+// chain with fewer than two vertices has no edges and never crosses.
+//
+// This walks both chains with a single S2EdgeCrosser, so the coherence
+// optimizations in CrossingSign() (the saved triangle orientation and the
+// tangent outside-check for the fixed edge) are exploited across all of B's
+// edges for each edge of A, instead of restarting a fresh crosser per edge
+// pair.  Since the tangent check is amortized over the inner chain, it is
+// slightly more efficient to pass the shorter chain as A.
+bool ChainsCross(absl::Span<const S2Point> a, absl::Span<const S2Point> b);
+
+// Computes whether edge i of chain A crosses or touches edge j of chain B
+// for every pair (i, j), recording the results in a bitmap: bit (j % 64) of
+// word (*bitmap)[i * words_per_row + j / 64] is set iff
+// CrossingSign(a[i], a[i+1], b[j], b[j+1]) >= 0, where words_per_row is
+// (b.size() - 1 + 63) / 64.  The bitmap is sized by this function.  This is
+// useful for screening pairs of polylines when all crossing pairs are needed
+// rather than a yes/no answer (use ChainsCross for that, since it exits
+// early).
+void GetChainCrossingsBitmap(absl::Span<const S2Point> a,
+                             absl::Span<const S2Point> b,
+                             std::vector<uint64>* bitmap);
+
+}  // namespace S2
+
 
 //////////////////   Implementation details follow   ////////////////////
 
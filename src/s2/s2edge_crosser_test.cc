@@ -24,11 +24,15 @@
 #include <gtest/gtest.h>
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
+#include "absl/types/span.h"
+#include "s2/s1angle.h"
+#include "s2/s2cap.h"
 #include "s2/s2edge_crossings.h"
 #include "s2/s2edge_distances.h"
 #include "s2/s2point.h"
 #include "s2/s2pointutil.h"
 #include "s2/s2predicates.h"
+#include "s2/s2shape.h"
 #include "s2/s2testing.h"
 
 using std::vector;
@@ -306,3 +310,108 @@ TEST(S2, CoincidentZeroLengthEdgesThatDontTouch) {
   }
 }
 
+
+TEST(S2, CrossingSignsMatchesCrossingSign) {
+  // Verifies that the batch CrossingSigns() method returns exactly the same
+  // results as calling CrossingSign() once per edge, for both crossers.  The
+  // candidate edges include chained edges, chain breaks, and edges that share
+  // a vertex with AB.
+  const int kIters = 100;
+  for (int iter = 0; iter < kIters; ++iter) {
+    S2Point a = S2Testing::RandomPoint();
+    S2Point b = S2Testing::SamplePoint(S2Cap(a, S1Angle::Radians(0.2)));
+    vector<S2Shape::Edge> edges;
+    S2Point v = S2Testing::SamplePoint(S2Cap(a, S1Angle::Radians(0.5)));
+    for (int i = 0; i < 20; ++i) {
+      if (S2Testing::rnd.OneIn(4)) {
+        // Break the chain.
+        v = S2Testing::SamplePoint(S2Cap(a, S1Angle::Radians(0.5)));
+      }
+      S2Point w = S2Testing::rnd.OneIn(8)
+          ? b  // Shares a vertex with AB.
+          : S2Testing::SamplePoint(S2Cap(v, S1Angle::Radians(0.3)));
+      edges.push_back({v, w});
+      v = w;
+    }
+    vector<int> actual(edges.size());
+    S2EdgeCrosser crosser(&a, &b);
+    crosser.CrossingSigns(edges, absl::MakeSpan(actual));
+    S2CopyingEdgeCrosser copying_crosser(a, b);
+    vector<int> actual_copying(edges.size());
+    copying_crosser.CrossingSigns(edges, absl::MakeSpan(actual_copying));
+    S2EdgeCrosser expected_crosser(&a, &b);
+    for (size_t i = 0; i < edges.size(); ++i) {
+      int expected = expected_crosser.CrossingSign(&edges[i].v0, &edges[i].v1);
+      EXPECT_EQ(expected, actual[i]) << "Iteration " << iter << ", edge " << i;
+      EXPECT_EQ(expected, actual_copying[i]);
+    }
+  }
+}
+
+// Returns a random vertex chain where consecutive vertices are near each
+// other, with occasional vertices reused from "other" so that shared-vertex
+// cases are exercised.
+static vector<S2Point> MakeRandomChain(int num_vertices,
+                                       const vector<S2Point>& other) {
+  vector<S2Point> chain;
+  S2Point v = S2Testing::RandomPoint();
+  for (int i = 0; i < num_vertices; ++i) {
+    if (!other.empty() && S2Testing::rnd.OneIn(8)) {
+      v = other[S2Testing::rnd.Uniform(other.size())];
+    }
+    chain.push_back(v);
+    v = S2Testing::SamplePoint(S2Cap(v, S1Angle::Radians(0.3)));
+  }
+  return chain;
+}
+
+TEST(S2, ChainsCrossMatchesPairwiseCrossingSign) {
+  const int kIters = 200;
+  for (int iter = 0; iter < kIters; ++iter) {
+    vector<S2Point> a = MakeRandomChain(1 + S2Testing::rnd.Uniform(6), {});
+    vector<S2Point> b = MakeRandomChain(1 + S2Testing::rnd.Uniform(6), a);
+    bool expected = false;
+    for (size_t i = 0; i + 1 < a.size() && !expected; ++i) {
+      for (size_t j = 0; j + 1 < b.size() && !expected; ++j) {
+        expected = S2::CrossingSign(a[i], a[i + 1], b[j], b[j + 1]) >= 0;
+      }
+    }
+    EXPECT_EQ(expected, S2::ChainsCross(a, b)) << "Iteration " << iter;
+    EXPECT_EQ(expected, S2::ChainsCross(b, a)) << "Iteration " << iter;
+  }
+}
+
+TEST(S2, GetChainCrossingsBitmapMatchesPairwiseCrossingSign) {
+  const int kIters = 100;
+  for (int iter = 0; iter < kIters; ++iter) {
+    // Use enough edges that rows span multiple bitmap words occasionally.
+    vector<S2Point> a = MakeRandomChain(2 + S2Testing::rnd.Uniform(8), {});
+    vector<S2Point> b = MakeRandomChain(2 + S2Testing::rnd.Uniform(100), a);
+    vector<uint64> bitmap;
+    S2::GetChainCrossingsBitmap(a, b, &bitmap);
+    size_t num_b_edges = b.size() - 1;
+    size_t words_per_row = (num_b_edges + 63) / 64;
+    ASSERT_EQ((a.size() - 1) * words_per_row, bitmap.size());
+    for (size_t i = 0; i + 1 < a.size(); ++i) {
+      for (size_t j = 0; j < num_b_edges; ++j) {
+        bool expected = S2::CrossingSign(a[i], a[i + 1], b[j], b[j + 1]) >= 0;
+        bool actual = (bitmap[i * words_per_row + j / 64] >>
+                       (j % 64)) & 1;
+        EXPECT_EQ(expected, actual)
+            << "Iteration " << iter << ", pair (" << i << ", " << j << ")";
+      }
+    }
+  }
+}
+
+TEST(S2, ChainsCrossDegenerateChains) {
+  vector<S2Point> empty;
+  vector<S2Point> single = {S2Point(1, 0, 0)};
+  vector<S2Point> edge = {S2Point(1, 0, 0), S2Point(0, 1, 0)};
+  EXPECT_FALSE(S2::ChainsCross(empty, edge));
+  EXPECT_FALSE(S2::ChainsCross(single, edge));
+  EXPECT_FALSE(S2::ChainsCross(edge, single));
+  vector<uint64> bitmap = {123};
+  S2::GetChainCrossingsBitmap(single, edge, &bitmap);
+  EXPECT_TRUE(bitmap.empty());
+}
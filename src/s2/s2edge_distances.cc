@@ -24,12 +24,14 @@
 
 #include "absl/base/optimization.h"
 #include "absl/log/absl_check.h"
+#include "absl/types/span.h"
 #include "s2/s1angle.h"
 #include "s2/s1chord_angle.h"
 #include "s2/s2edge_crossings.h"
 #include "s2/s2point.h"
 #include "s2/s2pointutil.h"
 #include "s2/s2predicates.h"
+#include "s2/s2shape.h"
 
 using std::max;
 using std::min;
@@ -233,6 +235,35 @@ bool UpdateMinDistance(const S2Point& x, const S2Point& a, const S2Point& b,
   return AlwaysUpdateMinDistance<false>(x, a, b, min_dist);
 }
 
+bool UpdateMinDistanceToEdges(const S2Point& x,
+                              absl::Span<const S2Shape::Edge> edges,
+                              S1ChordAngle* min_dist) {
+  bool updated = false;
+  // The squared chord distance from "x" to the second vertex of the previous
+  // edge, which can be reused when consecutive edges share a vertex.
+  const S2Point* prev_v1 = nullptr;
+  double xb2 = 0;
+  for (const S2Shape::Edge& edge : edges) {
+    double xa2 = (prev_v1 != nullptr && edge.v0 == *prev_v1)
+                     ? xb2
+                     : (x - edge.v0).Norm2();
+    xb2 = (x - edge.v1).Norm2();
+    prev_v1 = &edge.v1;
+    if (AlwaysUpdateMinInteriorDistance<false>(x, edge.v0, edge.v1, xa2, xb2,
+                                               min_dist)) {
+      updated = true;  // Minimum distance is attained along the edge interior.
+      continue;
+    }
+    // Otherwise the minimum distance is to one of the endpoints.
+    double dist2 = min(xa2, xb2);
+    if (dist2 < min_dist->length2()) {
+      *min_dist = S1ChordAngle::FromLength2(dist2);
+      updated = true;
+    }
+  }
+  return updated;
+}
+
 bool UpdateMaxDistance(const S2Point& x, const S2Point& a, const S2Point& b,
                        S1ChordAngle* max_dist) {
   auto dist = max(S1ChordAngle(x, a), S1ChordAngle(x, b));
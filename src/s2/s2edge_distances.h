@@ -26,12 +26,14 @@
 
 #include "absl/base/macros.h"
 #include "absl/log/absl_check.h"
+#include "absl/types/span.h"
 #include "s2/s1angle.h"
 #include "s2/s1chord_angle.h"
 #include "s2/s2edge_crossings.h"
 #include "s2/s2point.h"
 #include "s2/s2pointutil.h"
 #include "s2/s2predicates_internal.h"
+#include "s2/s2shape.h"
 
 namespace S2 {
 
@@ -70,6 +72,18 @@ bool IsDistanceLess(const S2Point& x, const S2Point& a, const S2Point& b,
 bool UpdateMinDistance(const S2Point& x, const S2Point& a, const S2Point& b,
                        S1ChordAngle* min_dist);
 
+// Like UpdateMinDistance(), but processes a batch of edges.  If the minimum
+// distance from X to any of the given edges is less than "min_dist", this
+// method updates "min_dist" and returns true.  Otherwise it returns false.
+//
+// This is faster than calling UpdateMinDistance() on each edge separately
+// because when consecutive edges share a vertex (as in polyline and polygon
+// loop chains, which is how edges are stored in S2ShapeIndex cells), the
+// distance to the shared vertex is computed only once.
+bool UpdateMinDistanceToEdges(const S2Point& x,
+                              absl::Span<const S2Shape::Edge> edges,
+                              S1ChordAngle* min_dist);
+
 // If the maximum distance from X to the edge AB is greater than "max_dist",
 // this method updates "max_dist" and returns true.  Otherwise it returns false.
 // The case A == B is handled correctly.
@@ -23,6 +23,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -38,6 +39,7 @@
 #include "s2/s2pointutil.h"
 #include "s2/s2polyline.h"
 #include "s2/s2predicates.h"
+#include "s2/s2shape.h"
 #include "s2/s2testing.h"
 #include "s2/s2text_format.h"
 
@@ -170,6 +172,34 @@ TEST(S2, Distance) {
                 M_PI, S2Point(1, 0, 0));
 }
 
+TEST(S2, UpdateMinDistanceToEdgesMatchesUpdateMinDistance) {
+  // Verifies the batch kernel against per-edge UpdateMinDistance() calls,
+  // using chains of connected edges (the vertex-sharing fast path) as well as
+  // disconnected edges.
+  for (int iter = 0; iter < 100; ++iter) {
+    std::vector<S2Shape::Edge> edges;
+    S2Point v = S2Testing::RandomPoint();
+    for (int i = 0; i < 10; ++i) {
+      if (i == 5) v = S2Testing::RandomPoint();  // Break the chain.
+      S2Point w = S2Testing::SamplePoint(
+          S2Cap(v, S1Angle::Radians(0.1)));
+      edges.push_back(S2Shape::Edge(v, w));
+      v = w;
+    }
+    S2Point x = S2Testing::RandomPoint();
+    S1ChordAngle expected = S1ChordAngle::Infinity();
+    for (const S2Shape::Edge& edge : edges) {
+      S2::UpdateMinDistance(x, edge.v0, edge.v1, &expected);
+    }
+    S1ChordAngle actual = S1ChordAngle::Infinity();
+    EXPECT_TRUE(S2::UpdateMinDistanceToEdges(x, edges, &actual));
+    EXPECT_EQ(expected, actual);
+    // A second pass with the minimum already attained should not update.
+    EXPECT_FALSE(S2::UpdateMinDistanceToEdges(x, edges, &actual));
+    EXPECT_EQ(expected, actual);
+  }
+}
+
 TEST(S2, UpdateMinInteriorDistanceLowerBoundOptimizationIsConservative) {
   // Verifies that AlwaysUpdateMinInteriorDistance() computes the lower bound
   // on the true distance conservatively.  (This test used to fail.)
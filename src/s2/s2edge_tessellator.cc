@@ -18,6 +18,7 @@
 #include "s2/s2edge_tessellator.h"
 
 #include <algorithm>
+#include <cmath>
 #include <vector>
 
 #include "absl/log/absl_check.h"
@@ -25,10 +26,13 @@
 #include "s2/r2.h"
 #include "s2/s1angle.h"
 #include "s2/s1chord_angle.h"
+#include "s2/s1interval.h"
 #include "s2/s2edge_distances.h"
 #include "s2/s2point.h"
 #include "s2/s2pointutil.h"
 #include "s2/s2projections.h"
+#include "s2/s2shape.h"
+#include "s2/s2shape_measures.h"
 
 using std::vector;
 // Tessellation is implemented by subdividing the edge until the estimated
@@ -194,8 +198,11 @@ S2EdgeTessellator::S2EdgeTessellator(const S2::Projection* projection,
 
   // Rather than scaling the error estimate as described above, instead we scale
   // the tolerance.  See algorithm description at the top of this file.
-  scaled_tolerance_ = S1ChordAngle(kScaleFactor *
-                                   std::max(tolerance, kMinTolerance()));
+  scaled_tolerance_ = ScaledTolerance(tolerance);
+}
+
+S1ChordAngle S2EdgeTessellator::ScaledTolerance(S1Angle tolerance) {
+  return S1ChordAngle(kScaleFactor * std::max(tolerance, kMinTolerance()));
 }
 
 S1ChordAngle S2EdgeTessellator::EstimateMaxError(
@@ -226,7 +233,132 @@ void S2EdgeTessellator::AppendProjected(
     ABSL_DCHECK_EQ(vertices->back(), pa) << "Appended edges must form a chain";
   }
   R2Point pb = proj_.Project(b);
-  AppendProjected(pa, a, pb, b, vertices);
+  AppendProjected(pa, a, pb, b, scaled_tolerance_, vertices);
+}
+
+void S2EdgeTessellator::AppendProjected(
+    const S2Point& a, const S2Point& b, S1Angle tolerance,
+    vector<R2Point>* vertices) const {
+  R2Point pa = proj_.Project(a);
+  if (vertices->empty()) {
+    vertices->push_back(pa);
+  } else {
+    pa = proj_.WrapDestination(vertices->back(), pa);
+    ABSL_DCHECK_EQ(vertices->back(), pa) << "Appended edges must form a chain";
+  }
+  R2Point pb = proj_.Project(b);
+  AppendProjected(pa, a, pb, b, ScaledTolerance(tolerance), vertices);
+}
+
+// Returns an estimate of the number of vertices that tessellating the
+// geodesic edge AB will append to the output.  Each subdivision halves the
+// edge and reduces the error by roughly a factor of 4, so the number of
+// output segments grows as the square root of the error ratio.
+int S2EdgeTessellator::EstimateNumVertices(
+    const R2Point& pa, const S2Point& a, const R2Point& pb, const S2Point& b)
+    const {
+  S1ChordAngle error = EstimateMaxError(pa, a, pb, b);
+  if (error <= scaled_tolerance_) return 1;
+
+  // Edges longer than 90 degrees yield an infinite error estimate.  Such
+  // edges are rare, and the estimate only affects the initial reservation,
+  // so a fixed guess is sufficient.
+  if (error.is_infinity()) return 8;
+  double ratio = error.ToAngle().radians() /
+                 scaled_tolerance_.ToAngle().radians();
+  return 1 + static_cast<int>(std::sqrt(ratio));
+}
+
+void S2EdgeTessellator::AppendProjectedChain(
+    const S2Shape& shape, int chain_id, vector<R2Point>* vertices) const {
+  if (shape.chain(chain_id).length == 0) return;
+
+  // Decode the chain vertices once; polygon chains are closed implicitly.
+  vector<S2Point> points;
+  S2::GetChainVertices(shape, chain_id, &points);
+  const bool closed = shape.dimension() == 2;
+  const int num_edges = closed ? points.size() : points.size() - 1;
+
+  // Project each chain vertex once, wrapping toward its predecessor.
+  vector<R2Point> projected(num_edges + 1);
+  projected[0] = proj_.Project(points[0]);
+  if (!vertices->empty()) {
+    projected[0] = proj_.WrapDestination(vertices->back(), projected[0]);
+    ABSL_DCHECK_EQ(vertices->back(), projected[0])
+        << "Appended edges must form a chain";
+  }
+  for (int i = 1; i <= num_edges; ++i) {
+    const S2Point& p = points[i == static_cast<int>(points.size()) ? 0 : i];
+    projected[i] = proj_.WrapDestination(projected[i - 1], proj_.Project(p));
+  }
+
+  // Estimate the total number of output vertices so that the output grows
+  // with a single reservation.
+  size_t num_vertices = vertices->empty() ? 1 : 0;
+  for (int j = 0; j < num_edges; ++j) {
+    const S2Point& b = points[j + 1 == static_cast<int>(points.size()) ?
+                              0 : j + 1];
+    num_vertices += EstimateNumVertices(projected[j], points[j],
+                                        projected[j + 1], b);
+  }
+  vertices->reserve(vertices->size() + num_vertices);
+
+  if (vertices->empty()) vertices->push_back(projected[0]);
+  for (int j = 0; j < num_edges; ++j) {
+    const S2Point& b = points[j + 1 == static_cast<int>(points.size()) ?
+                              0 : j + 1];
+    AppendProjected(projected[j], points[j], projected[j + 1], b,
+                    scaled_tolerance_, vertices);
+  }
+}
+
+// Simplifies vertices[begin..end) in place and returns the new end index.
+// This is the planar analogue of the S2PolylineSimplifier algorithm: starting
+// from the last kept vertex, an S1Interval tracks the window of edge
+// directions that pass within "tolerance" of every vertex skipped so far,
+// and a vertex can be elided only while the direction to its successor stays
+// inside the window.  Kept vertices are compacted toward the front of the
+// vector, so no extra storage is needed.
+static size_t SimplifyProjectedRange(double tolerance, size_t begin,
+                                     vector<R2Point>* vertices) {
+  vector<R2Point>& v = *vertices;
+  const size_t end = v.size();
+  if (end - begin <= 2) return end;
+  size_t out = begin;  // Position of the last kept vertex.
+  size_t i = begin;
+  while (i + 1 < end) {
+    const R2Point src = v[i];
+    S1Interval window = S1Interval::Full();
+    size_t next = i + 1;
+    for (size_t j = i + 1; j < end; ++j) {
+      const R2Point delta = v[j] - src;
+      const double theta = std::atan2(delta.y(), delta.x());
+      if (!window.Contains(theta)) break;
+      next = j;
+      if (j + 1 == end) break;
+      const double d = delta.Norm();
+      // A vertex within "tolerance" of the source constrains nothing; any
+      // direction passes within range of it.
+      if (d <= tolerance) continue;
+      window = window.Intersection(
+          S1Interval::FromPoint(theta).Expanded(std::asin(tolerance / d)));
+    }
+    v[++out] = v[next];
+    i = next;
+  }
+  return out + 1;
+}
+
+void S2EdgeTessellator::AppendSimplifiedProjectedChain(
+    const S2Shape& shape, int chain_id, double projected_tolerance,
+    vector<R2Point>* vertices) const {
+  ABSL_DCHECK_GE(projected_tolerance, 0);
+  // Simplification may consider elision of the shared vertex's successors,
+  // so the range to simplify starts at the last previously appended vertex.
+  const size_t begin = vertices->empty() ? 0 : vertices->size() - 1;
+  AppendProjectedChain(shape, chain_id, vertices);
+  vertices->resize(
+      SimplifyProjectedRange(projected_tolerance, begin, vertices));
 }
 
 // Given a geodesic edge AB, split the edge as necessary and append all
@@ -236,15 +368,16 @@ void S2EdgeTessellator::AppendProjected(
 // frame size is small so stack overflow should not be an issue.
 void S2EdgeTessellator::AppendProjected(const R2Point& pa, const S2Point& a,
                                         const R2Point& pb_in, const S2Point& b,
+                                        S1ChordAngle scaled_tolerance,
                                         vector<R2Point>* vertices) const {
   R2Point pb = proj_.WrapDestination(pa, pb_in);
-  if (EstimateMaxError(pa, a, pb, b) <= scaled_tolerance_) {
+  if (EstimateMaxError(pa, a, pb, b) <= scaled_tolerance) {
     vertices->push_back(pb);
   } else {
     S2Point mid = (a + b).Normalize();
     R2Point pmid = proj_.WrapDestination(pa, proj_.Project(mid));
-    AppendProjected(pa, a, pmid, mid, vertices);
-    AppendProjected(pmid, mid, pb, b, vertices);
+    AppendProjected(pa, a, pmid, mid, scaled_tolerance, vertices);
+    AppendProjected(pmid, mid, pb, b, scaled_tolerance, vertices);
   }
 }
 
@@ -25,6 +25,7 @@
 #include "s2/s1chord_angle.h"
 #include "s2/s2point.h"
 #include "s2/s2projections.h"
+#include "s2/s2shape.h"
 
 // Given an edge in some 2D projection (e.g., Mercator), S2EdgeTessellator
 // converts the edge into a chain of spherical geodesic edges such that the
@@ -61,6 +62,41 @@ class S2EdgeTessellator {
   void AppendProjected(const S2Point& a, const S2Point& b,
                        std::vector<R2Point>* vertices) const;
 
+  // Like the method above, but uses the given tolerance for this edge
+  // instead of the tolerance passed to the constructor.  This is useful for
+  // rendering applications where the appropriate tolerance varies per edge
+  // (e.g., proportional to each feature's on-screen size).
+  void AppendProjected(const S2Point& a, const S2Point& b, S1Angle tolerance,
+                       std::vector<R2Point>* vertices) const;
+
+  // Converts every edge of the given chain of "shape" to planar edges in the
+  // given projection and appends the corresponding vertices to "vertices"
+  // (see AppendProjected above for the exact semantics).  The chain vertices
+  // are decoded once, and the number of output vertices is estimated first
+  // so that "vertices" grows with a single reservation rather than repeated
+  // reallocation.  For polygon chains the closing edge is included.
+  void AppendProjectedChain(const S2Shape& shape, int chain_id,
+                            std::vector<R2Point>* vertices) const;
+
+  // Like AppendProjectedChain, but additionally simplifies the projected
+  // chain with the given tolerance, expressed in projected coordinate units
+  // (e.g. pixels).  The chain is projected and tessellated directly into
+  // "vertices" with a single reservation and then simplified in place, so no
+  // intermediate copy of the unsimplified polyline is made; the output vector
+  // can therefore serve directly as a rendering or tile buffer.
+  //
+  // Simplification uses the disc-constraint technique of S2PolylineSimplifier
+  // adapted to the plane: a vertex is elided only if the edge that replaces
+  // it passes within "projected_tolerance" of it, so the simplified chain
+  // stays within that tolerance of every vertex of the tessellated chain.
+  // The first and last vertices of the chain are always preserved.  Note
+  // that the two tolerances serve different purposes: the tolerance passed
+  // to the constructor bounds the (spherical) tessellation error, while
+  // "projected_tolerance" controls how much detail is retained on screen.
+  void AppendSimplifiedProjectedChain(const S2Shape& shape, int chain_id,
+                                      double projected_tolerance,
+                                      std::vector<R2Point>* vertices) const;
+
   // Converts the planar edge AB in the given projection to a chain of
   // spherical geodesic edges and appends the vertices to "vertices".
   //
@@ -82,15 +118,21 @@ class S2EdgeTessellator {
   static S1Angle kMinTolerance();
 
  private:
+  static S1ChordAngle ScaledTolerance(S1Angle tolerance);
+
   S1ChordAngle EstimateMaxError(const R2Point& pa, const S2Point& a,
                                 const R2Point& pb, const S2Point& b) const;
 
+  int EstimateNumVertices(const R2Point& pa, const S2Point& a,
+                          const R2Point& pb, const S2Point& b) const;
+
   void AppendUnprojected(const R2Point& pa, const S2Point& a,
                          const R2Point& pb, const S2Point& b,
                          std::vector<S2Point>* vertices) const;
 
   void AppendProjected(const R2Point& pa, const S2Point& a,
                        const R2Point& pb, const S2Point& b,
+                       S1ChordAngle scaled_tolerance,
                        std::vector<R2Point>* vertices) const;
 
   const S2::Projection& proj_;
@@ -35,9 +35,12 @@
 #include "s2/s1angle.h"
 #include "s2/s1chord_angle.h"
 #include "s2/s2edge_distances.h"
+#include "s2/mutable_s2shape_index.h"
 #include "s2/s2latlng.h"
+#include "s2/s2lax_polyline_shape.h"
 #include "s2/s2point.h"
 #include "s2/s2projections.h"
+#include "s2/s2shape.h"
 #include "s2/s2testing.h"
 #include "s2/s2text_format.h"
 
@@ -507,4 +510,85 @@ TEST(S2EdgeTessellator, ProjectedAccuracyRandomCheck) {
   }
 }
 
+TEST(S2EdgeTessellator, AppendProjectedPerEdgeTolerance) {
+  // The per-edge tolerance overload should match a tessellator constructed
+  // with that tolerance.
+  S2::PlateCarreeProjection proj(180);
+  S2EdgeTessellator coarse(&proj, S1Angle::Degrees(10));
+  S2EdgeTessellator fine(&proj, S1Angle::E7(1));
+  S2Point a = S2LatLng::FromDegrees(30, -80).ToPoint();
+  S2Point b = S2LatLng::FromDegrees(40, 80).ToPoint();
+  vector<R2Point> expected, actual;
+  fine.AppendProjected(a, b, &expected);
+  coarse.AppendProjected(a, b, S1Angle::E7(1), &actual);
+  EXPECT_GT(actual.size(), 2);
+  EXPECT_EQ(expected, actual);
+}
+
+TEST(S2EdgeTessellator, AppendProjectedChainMatchesPerEdge) {
+  // AppendProjectedChain should produce exactly the same vertices as calling
+  // AppendProjected on each edge of the chain in turn, for both open
+  // (polyline) and implicitly closed (polygon) chains.
+  S2::MercatorProjection proj(0.5);
+  S2EdgeTessellator tess(&proj, S1Angle::E7(1));
+  auto index = s2textformat::MakeIndexOrDie(
+      "# 10:10, 40:30, 20:-20 # 0:0, 0:30, 30:30, 30:0");
+  for (const S2Shape* shape : *index) {
+    for (int c = 0; c < shape->num_chains(); ++c) {
+      vector<R2Point> expected, actual;
+      const S2Shape::Chain chain = shape->chain(c);
+      for (int j = 0; j < chain.length; ++j) {
+        const S2Shape::Edge edge = shape->chain_edge(c, j);
+        tess.AppendProjected(edge.v0, edge.v1, &expected);
+      }
+      tess.AppendProjectedChain(*shape, c, &actual);
+      EXPECT_EQ(expected, actual);
+    }
+  }
+}
+
+// Returns the distance from "p" to the polyline defined by "vertices".
+static double GetPlanarDistance(const R2Point& p,
+                                const vector<R2Point>& vertices) {
+  double best = std::numeric_limits<double>::max();
+  for (size_t i = 0; i + 1 < vertices.size(); ++i) {
+    const R2Point ab = vertices[i + 1] - vertices[i];
+    const R2Point ap = p - vertices[i];
+    const double t = ab.Norm2() > 0 ?
+        max(0.0, min(1.0, ap.DotProd(ab) / ab.Norm2())) : 0.0;
+    best = min(best, (p - (vertices[i] + t * ab)).Norm());
+  }
+  return best;
+}
+
+TEST(S2EdgeTessellator, AppendSimplifiedProjectedChain) {
+  // A polyline that zig-zags slightly around a straight course: with a
+  // tolerance larger than the zig-zag amplitude nearly all vertices can be
+  // elided, but every tessellated vertex must remain within the tolerance of
+  // the simplified chain and the endpoints must be preserved exactly.
+  S2::PlateCarreeProjection proj(180);
+  S2EdgeTessellator tess(&proj, S1Angle::Degrees(0.01));
+  vector<S2Point> points;
+  for (int i = 0; i <= 100; ++i) {
+    points.push_back(
+        S2LatLng::FromDegrees(0.001 * ((i % 2) ? 1 : -1), 0.1 * i).ToPoint());
+  }
+  S2LaxPolylineShape shape(points);
+  vector<R2Point> full, simplified;
+  tess.AppendProjectedChain(shape, 0, &full);
+  const double kTolerance = 0.01;
+  tess.AppendSimplifiedProjectedChain(shape, 0, kTolerance, &simplified);
+  EXPECT_LT(simplified.size(), full.size() / 10);
+  EXPECT_EQ(simplified.front(), full.front());
+  EXPECT_EQ(simplified.back(), full.back());
+  for (const R2Point& p : full) {
+    EXPECT_LE(GetPlanarDistance(p, simplified), kTolerance);
+  }
+
+  // With zero tolerance every tessellated vertex is retained.
+  vector<R2Point> exact;
+  tess.AppendSimplifiedProjectedChain(shape, 0, 0.0, &exact);
+  EXPECT_EQ(exact, full);
+}
+
 }  // namespace
@@ -33,6 +33,10 @@
 
 // This class is intended to be copied by value as desired.  It uses
 // the default copy constructor and assignment operator.
+//
+// Callers that only need to convey an error code should use the code-only
+// constructor or Init() overload below, which allocate nothing and skip
+// message formatting entirely.
 class S2Error {
  public:
   enum Code {
@@ -125,6 +129,11 @@ class S2Error {
   };
   S2Error() : code_(OK), text_() {}
 
+  // Constructs an error with the given code and an empty message.  This
+  // performs no allocation and is the cheapest way to report an error when
+  // the code alone is sufficient.
+  explicit S2Error(Code code) : code_(code) {}
+
   // Convenience constructor that calls Init().
   template <typename... Args>
   S2Error(Code code, const absl::FormatSpec<Args...>& format,
@@ -144,9 +153,15 @@ class S2Error {
     text_ = absl::StrFormat(format, args...);
   }
 
+  // Like the above, but sets an empty message without allocating.
+  void Init(Code code) {
+    code_ = code;
+    text_.clear();
+  }
+
   bool ok() const { return code_ == OK; }
   Code code() const { return code_; }
-  std::string text() const { return text_; }
+  const std::string& text() const { return text_; }
 
   // Clear the error to contain the OK code and no error message.
   void Clear();
@@ -40,6 +40,36 @@ TEST(S2Error, Constructor) {
   EXPECT_EQ(error.text(), "Memory limit exceeded (100 vs 50)");
 }
 
+TEST(S2Error, CodeOnly) {
+  S2Error error(S2Error::CANCELLED);
+  EXPECT_EQ(error.code(), S2Error::CANCELLED);
+  EXPECT_EQ(error.text(), "");
+
+  error.Init(S2Error::INTERNAL);
+  EXPECT_EQ(error.code(), S2Error::INTERNAL);
+  EXPECT_EQ(error.text(), "");
+}
+
+TEST(S2Error, StringArgumentsAreCapturedByValue) {
+  // The message must not depend on the argument storage after Init() returns.
+  S2Error error;
+  {
+    std::string name = "polygon";
+    error.Init(S2Error::DATA_LOSS, "Cannot decode %s", name);
+    name = "something else";
+  }
+  EXPECT_EQ(error.text(), "Cannot decode polygon");
+}
+
+TEST(S2Error, CopiesAreIndependent) {
+  S2Error error(S2Error::UNKNOWN, "Error %d", 42);
+  S2Error copy = error;
+  error.Clear();
+  EXPECT_EQ(copy.code(), S2Error::UNKNOWN);
+  EXPECT_EQ(copy.text(), "Error 42");
+  EXPECT_EQ(error.text(), "");
+}
+
 TEST(S2Error, ToS2Error) {
   const S2Error ok = ToS2Error(absl::Status());
   EXPECT_EQ(ok.code(), S2Error::OK);
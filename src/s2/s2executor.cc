@@ -0,0 +1,50 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2executor.h"
+
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+
+namespace {
+
+// The default executor spawns one std::thread per worker.  Threads are not
+// reused across calls; this matches the cost model of the call sites, which
+// only parallelize when there is enough work per worker to amortize the
+// thread creation overhead (see the various kMin*PerThread constants).
+class DefaultExecutor final : public S2Executor {
+ public:
+  void Run(int num_workers, const std::function<void(int)>& work) override {
+    ABSL_DCHECK_GE(num_workers, 1);
+    std::vector<std::thread> threads;
+    threads.reserve(num_workers - 1);
+    for (int i = 0; i + 1 < num_workers; ++i) {
+      threads.emplace_back([&work, i]() { work(i); });
+    }
+    work(num_workers - 1);  // The calling thread helps out too.
+    for (auto& thread : threads) thread.join();
+  }
+};
+
+}  // namespace
+
+S2Executor* S2Executor::Default() {
+  // Intentionally leaked so that it is safe to use during program shutdown.
+  static S2Executor* default_executor = new DefaultExecutor;
+  return default_executor;
+}
@@ -0,0 +1,72 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef S2_S2EXECUTOR_H_
+#define S2_S2EXECUTOR_H_
+
+#include <functional>
+
+// S2Executor abstracts the mechanism used to run S2 operations on multiple
+// threads.  Like S2MemoryTracker, it is an injectable policy object: classes
+// that support parallelism accept an optional S2Executor through their
+// Options (see e.g. MutableS2ShapeIndex::Options::set_executor,
+// S2BooleanOperation::Options::set_executor, and
+// S2RegionCoverer::Options::set_executor).  Clients that have their own
+// scheduler or thread pool can subclass S2Executor to route all of S2's
+// parallel work through it.
+//
+// The interface is deliberately small.  S2 divides each parallel phase into
+// a fixed number of workers up front (the various num_threads() options
+// control how many) and asks the executor to run them; how the workers are
+// mapped onto threads is entirely up to the executor.  When no executor is
+// supplied, Default() is used, which runs each worker on its own
+// std::thread.
+//
+// Example usage:
+//
+//   class MyExecutor : public S2Executor {
+//    public:
+//     void Run(int num_workers,
+//              const std::function<void(int)>& work) override {
+//       // Schedule work(0) .. work(num_workers - 1) on my thread pool and
+//       // wait for them to finish.
+//     }
+//   };
+//
+//   MyExecutor executor;
+//   MutableS2ShapeIndex::Options options;
+//   options.set_num_index_threads(8);
+//   options.set_executor(&executor);
+//   MutableS2ShapeIndex index(options);
+class S2Executor {
+ public:
+  virtual ~S2Executor() = default;
+
+  // Invokes work(i) for every i in [0, num_workers), possibly concurrently,
+  // and returns once all invocations have completed.  "work" must be safe to
+  // invoke concurrently from multiple threads; implementations are free to
+  // invoke it from the calling thread as well as from worker threads.
+  //
+  // REQUIRES: num_workers >= 1
+  virtual void Run(int num_workers, const std::function<void(int)>& work) = 0;
+
+  // Returns the executor used when none is supplied by the client.  It runs
+  // each worker on its own std::thread (with the calling thread executing
+  // the last worker itself).  The returned object is shared and never
+  // destroyed.
+  static S2Executor* Default();
+};
+
+#endif  // S2_S2EXECUTOR_H_
@@ -0,0 +1,86 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2executor.h"
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "s2/s1angle.h"
+#include "s2/s2cap.h"
+#include "s2/s2cell_union.h"
+#include "s2/s2region.h"
+#include "s2/s2region_coverer.h"
+#include "s2/s2testing.h"
+
+TEST(S2Executor, DefaultRunsEveryWorkerExactlyOnce) {
+  constexpr int kNumWorkers = 8;
+  std::vector<std::atomic<int>> counts(kNumWorkers);
+  for (auto& count : counts) count = 0;
+  S2Executor::Default()->Run(kNumWorkers, [&counts](int i) { ++counts[i]; });
+  for (const auto& count : counts) EXPECT_EQ(1, count);
+}
+
+TEST(S2Executor, DefaultSupportsSingleWorker) {
+  int calls = 0;
+  S2Executor::Default()->Run(1, [&calls](int i) {
+    EXPECT_EQ(0, i);
+    ++calls;
+  });
+  EXPECT_EQ(1, calls);
+}
+
+namespace {
+
+// An executor that runs all workers sequentially on the calling thread and
+// counts how many times it was used.
+class SerialExecutor : public S2Executor {
+ public:
+  void Run(int num_workers, const std::function<void(int)>& work) override {
+    ++num_runs_;
+    for (int i = 0; i < num_workers; ++i) work(i);
+  }
+  int num_runs() const { return num_runs_; }
+
+ private:
+  int num_runs_ = 0;
+};
+
+}  // namespace
+
+TEST(S2Executor, CustomExecutorIsUsedByRegionCoverer) {
+  // Verifies that a client-supplied executor receives the parallel work.
+  SerialExecutor executor;
+  S2RegionCoverer::Options options;
+  options.set_max_cells(8);
+  options.set_executor(&executor);
+  S2RegionCoverer coverer(options);
+
+  std::vector<S2CellUnion> coverings;
+  std::vector<const S2Region*> regions;
+  std::vector<S2Cap> caps;
+  for (int i = 0; i < 64; ++i) {
+    caps.push_back(S2Cap(S2Testing::RandomPoint(), S1Angle::Degrees(1)));
+  }
+  for (const S2Cap& cap : caps) regions.push_back(&cap);
+  coverer.GetCoverings(regions, 4, &coverings);
+  EXPECT_EQ(1, executor.num_runs());
+  ASSERT_EQ(regions.size(), coverings.size());
+  for (size_t i = 0; i < regions.size(); ++i) {
+    EXPECT_EQ(coverer.GetCovering(*regions[i]), coverings[i]);
+  }
+}
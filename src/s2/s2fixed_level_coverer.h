@@ -0,0 +1,150 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef S2_S2FIXED_LEVEL_COVERER_H_
+#define S2_S2FIXED_LEVEL_COVERER_H_
+
+#include <algorithm>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "s2/_fp_contract_off.h"
+#include "s2/s2cap.h"
+#include "s2/s2cell.h"
+#include "s2/s2cell_id.h"
+#include "s2/s2latlng_rect.h"
+#include "s2/s2point.h"
+
+// S2FixedLevelCoverer computes coverings that consist entirely of cells at a
+// single level fixed at compile time.  This is a common pattern in realtime
+// serving systems (e.g. geofencing at level 12, or map tiles at level 16)
+// where the generality of S2RegionCoverer -- candidate expansion, a priority
+// queue, interior/exterior accounting -- is pure overhead.
+//
+// Cells and cell ids are covered with closed-form loops, and caps and lat/lng
+// rectangles with a simple flood fill seeded at the region's center (the same
+// technique as S2RegionCoverer::GetSimpleCovering, but with the containment
+// tests inlined rather than dispatched through S2Region since the region type
+// is concrete).  There is no heap or priority queue.  The result contains
+// exactly the cells at the given level that may intersect the region, in
+// sorted order, and so can be passed directly to S2CellUnion::Init (note that
+// such a union is not normalized: four sibling cells are never merged into
+// their parent, since that would change the level).
+//
+// Example usage:
+//
+//   std::vector<S2CellId> covering;
+//   S2FixedLevelCoverer<12>::GetCovering(cap, &covering);
+//
+// CAVEAT: The number of cells at a given level grows by a factor of four per
+// level, so covering a large region at a fine level can produce an enormous
+// number of cells.  Callers are expected to know that their regions are small
+// relative to the chosen level; for the adaptive case use S2RegionCoverer.
+//
+// This class is thread-safe (it has no state).
+template <int kLevel>
+class S2FixedLevelCoverer {
+ public:
+  static_assert(kLevel >= 0 && kLevel <= S2CellId::kMaxLevel,
+                "Level must be in the range [0, S2CellId::kMaxLevel]");
+
+  // Stores the level-kLevel covering of the given cell id in "covering",
+  // replacing its previous contents.  If "id" is at kLevel or finer this is
+  // its ancestor at kLevel, otherwise it is all of its descendants at kLevel.
+  static void GetCovering(S2CellId id, std::vector<S2CellId>* covering);
+
+  static void GetCovering(const S2Cell& cell, std::vector<S2CellId>* covering) {
+    GetCovering(cell.id(), covering);
+  }
+
+  // Stores the sorted level-kLevel covering of the given cap or rectangle in
+  // "covering", replacing its previous contents.  The covering contains every
+  // cell at kLevel that intersects the region; for an empty region the
+  // covering is empty.
+  static void GetCovering(const S2Cap& cap, std::vector<S2CellId>* covering);
+
+  static void GetCovering(const S2LatLngRect& rect,
+                          std::vector<S2CellId>* covering);
+
+ private:
+  // Flood fills outward from the level-kLevel cell containing "start",
+  // keeping the cells that intersect "region".  Requires that the region is
+  // connected and contains "start" (otherwise some cells may be missed).
+  template <typename Region>
+  static void FloodFill(const Region& region, const S2Point& start,
+                        std::vector<S2CellId>* covering);
+};
+
+//////////////////   Implementation details follow   ////////////////////
+
+template <int kLevel>
+void S2FixedLevelCoverer<kLevel>::GetCovering(S2CellId id,
+                                              std::vector<S2CellId>* covering) {
+  covering->clear();
+  if (id.level() >= kLevel) {
+    covering->push_back(id.parent(kLevel));
+    return;
+  }
+  covering->reserve(int64{1} << (2 * (kLevel - id.level())));
+  for (S2CellId child = id.child_begin(kLevel); child != id.child_end(kLevel);
+       child = child.next()) {
+    covering->push_back(child);
+  }
+}
+
+template <int kLevel>
+void S2FixedLevelCoverer<kLevel>::GetCovering(const S2Cap& cap,
+                                              std::vector<S2CellId>* covering) {
+  covering->clear();
+  if (cap.is_empty()) return;
+  FloodFill(cap, cap.center(), covering);
+}
+
+template <int kLevel>
+void S2FixedLevelCoverer<kLevel>::GetCovering(const S2LatLngRect& rect,
+                                              std::vector<S2CellId>* covering) {
+  covering->clear();
+  if (rect.is_empty()) return;
+  FloodFill(rect, rect.GetCenter().ToPoint(), covering);
+}
+
+template <int kLevel>
+template <typename Region>
+void S2FixedLevelCoverer<kLevel>::FloodFill(const Region& region,
+                                            const S2Point& start,
+                                            std::vector<S2CellId>* covering) {
+  const S2CellId start_id = S2CellId(start).parent(kLevel);
+  absl::flat_hash_set<S2CellId, S2CellIdHash> all;
+  std::vector<S2CellId> frontier;
+  all.insert(start_id);
+  frontier.push_back(start_id);
+  while (!frontier.empty()) {
+    S2CellId id = frontier.back();
+    frontier.pop_back();
+    if (!region.MayIntersect(S2Cell(id))) continue;
+    covering->push_back(id);
+
+    S2CellId neighbors[4];
+    id.GetEdgeNeighbors(neighbors);
+    for (S2CellId nbr : neighbors) {
+      if (all.insert(nbr).second) {
+        frontier.push_back(nbr);
+      }
+    }
+  }
+  std::sort(covering->begin(), covering->end());
+}
+
+#endif  // S2_S2FIXED_LEVEL_COVERER_H_
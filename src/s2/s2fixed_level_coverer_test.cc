@@ -0,0 +1,107 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2fixed_level_coverer.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "s2/s1angle.h"
+#include "s2/s2cap.h"
+#include "s2/s2cell.h"
+#include "s2/s2cell_id.h"
+#include "s2/s2latlng.h"
+#include "s2/s2latlng_rect.h"
+#include "s2/s2testing.h"
+
+namespace {
+
+using std::vector;
+
+// Computes the expected fixed-level covering of a region by checking every
+// cell at the given level.
+template <typename Region>
+vector<S2CellId> BruteForceCovering(const Region& region, int level) {
+  vector<S2CellId> result;
+  for (S2CellId id = S2CellId::Begin(level); id != S2CellId::End(level);
+       id = id.next()) {
+    if (region.MayIntersect(S2Cell(id))) result.push_back(id);
+  }
+  return result;
+}
+
+TEST(S2FixedLevelCoverer, CellIdCoverings) {
+  // A cell at a finer level is covered by its ancestor.
+  const S2CellId id = S2CellId(S2LatLng::FromDegrees(12, 34)).parent(10);
+  vector<S2CellId> covering;
+  S2FixedLevelCoverer<6>::GetCovering(id, &covering);
+  ASSERT_EQ(covering.size(), 1);
+  EXPECT_EQ(covering[0], id.parent(6));
+
+  // A cell at the target level is covered by itself.
+  S2FixedLevelCoverer<10>::GetCovering(id, &covering);
+  ASSERT_EQ(covering.size(), 1);
+  EXPECT_EQ(covering[0], id);
+
+  // A cell at a coarser level is covered by all of its descendants.
+  S2FixedLevelCoverer<12>::GetCovering(S2Cell(id), &covering);
+  ASSERT_EQ(covering.size(), 16);
+  int i = 0;
+  for (S2CellId child = id.child_begin(12); child != id.child_end(12);
+       child = child.next()) {
+    EXPECT_EQ(covering[i++], child);
+  }
+}
+
+TEST(S2FixedLevelCoverer, CapCoveringsMatchBruteForce) {
+  constexpr int kLevel = 5;
+  S2Testing::rnd.Reset(1);
+  for (int i = 0; i < 20; ++i) {
+    const S2Cap cap(S2Testing::RandomPoint(),
+                    S1Angle::Degrees(0.1 + 10 * S2Testing::rnd.RandDouble()));
+    vector<S2CellId> covering;
+    S2FixedLevelCoverer<kLevel>::GetCovering(cap, &covering);
+    EXPECT_EQ(covering, BruteForceCovering(cap, kLevel));
+  }
+}
+
+TEST(S2FixedLevelCoverer, RectCoveringsMatchBruteForce) {
+  constexpr int kLevel = 5;
+  // Includes rectangles that span face boundaries and contain a pole.
+  const S2LatLngRect rects[] = {
+      S2LatLngRect(S2LatLng::FromDegrees(-5, 170), S2LatLng::FromDegrees(5, -170)),
+      S2LatLngRect(S2LatLng::FromDegrees(80, -180), S2LatLng::FromDegrees(90, 180)),
+      S2LatLngRect(S2LatLng::FromDegrees(40, 40), S2LatLng::FromDegrees(50, 60)),
+  };
+  for (const S2LatLngRect& rect : rects) {
+    vector<S2CellId> covering;
+    S2FixedLevelCoverer<kLevel>::GetCovering(rect, &covering);
+    EXPECT_EQ(covering, BruteForceCovering(rect, kLevel));
+  }
+}
+
+TEST(S2FixedLevelCoverer, EmptyAndFullRegions) {
+  vector<S2CellId> covering;
+  S2FixedLevelCoverer<8>::GetCovering(S2Cap::Empty(), &covering);
+  EXPECT_TRUE(covering.empty());
+  S2FixedLevelCoverer<8>::GetCovering(S2LatLngRect::Empty(), &covering);
+  EXPECT_TRUE(covering.empty());
+
+  // A full cap covers every cell at the level.
+  S2FixedLevelCoverer<3>::GetCovering(S2Cap::Full(), &covering);
+  EXPECT_EQ(covering.size(), 6 * (1 << (2 * 3)));
+}
+
+}  // namespace
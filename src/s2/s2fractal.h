@@ -22,6 +22,7 @@
 #include <vector>
 
 #include "absl/synchronization/mutex.h"
+#include "s2/base/types.h"
 #include "s2/r2.h"
 #include "s2/s2loop.h"
 
@@ -75,6 +76,14 @@ class S2Fractal {
   void set_fractal_dimension(double dimension);
   double fractal_dimension() const { return dimension_; }
 
+  // Set the seed used to reset the PRNG at the start of each MakeLoop()
+  // call.  When min_level() < max_level(), fractals with different seeds
+  // make different random subdivision choices; this allows generating many
+  // distinct fractals deterministically (e.g. one seed per loop).
+  //
+  // DEFAULT: std::default_random_engine::default_seed
+  void set_seed(uint32 seed) { seed_ = seed; }
+
   // Return a lower bound on ratio (Rmin / R), where "R" is the radius
   // passed to MakeLoop() and "Rmin" is the minimum distance from the
   // fractal boundary to its center, where all distances are measured in the
@@ -106,10 +115,10 @@ class S2Fractal {
   void GetR2VerticesHelper(const R2Point& v0, const R2Point& v4, int level,
                            std::vector<R2Point>* vertices) const;
 
-  // Reset the PRNG to the default seed.
+  // Reset the PRNG to the configured seed.
   void Reseed() const {
     absl::WriterMutexLock lock(&lock_);
-    random_.seed();
+    random_.seed(seed_);
   }
 
   bool OneIn(int32 n) const {
@@ -120,6 +129,7 @@ class S2Fractal {
   // Mutable source of randomness and a lock to synchronize it.
   mutable std::default_random_engine random_;
   mutable absl::Mutex lock_;
+  uint32 seed_ = std::default_random_engine::default_seed;
 
   int max_level_ = -1;
   int min_level_arg_ = -1;  // Value set by user
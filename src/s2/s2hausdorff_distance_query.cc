@@ -157,9 +157,53 @@ bool S2HausdorffDistanceQuery::IsDirectedDistanceLess(
   return !max_distance.is_negative();
 }
 
+bool S2HausdorffDistanceQuery::IsDirectedDistanceGreater(
+    const S2ShapeIndex* target, const S2ShapeIndex* source,
+    S1ChordAngle distance_limit) const {
+  S2ClosestEdgeQuery closest_edge_query(source);
+  closest_edge_query.mutable_options()->set_include_interiors(
+      options_.include_interiors());
+
+  // With a non-zero max_error a vertex is only counted as exceeding the
+  // limit if it exceeds limit + max_error, which makes the per-vertex
+  // rejection tests cheaper (any source edge within the slackened limit is
+  // an acceptable witness).
+  const S1ChordAngle limit = distance_limit + options_.max_error();
+
+  // The directed Hausdorff distance exceeds the limit iff some target vertex
+  // is farther than the limit from all of the source geometry, so the scan
+  // can be abandoned at the first such vertex.  Unlike the methods that
+  // compute the actual distance, each per-vertex test also terminates as
+  // soon as the closest edge query finds any source edge within the limit.
+  bool has_vertices = false;
+  for (const S2Shape* shape : *target) {
+    for (auto chain : shape->chains()) {
+      for (const S2Point& vertex : shape->vertices(chain)) {
+        has_vertices = true;
+        S2ClosestEdgeQuery::PointTarget point_target(vertex);
+        if (!closest_edge_query.IsDistanceLessOrEqual(&point_target, limit)) {
+          return true;
+        }
+      }
+    }
+  }
+  // If the target index is empty the Hausdorff distance is infinite,
+  // matching the Infinity() convention used by GetDirectedDistance().  (An
+  // empty source index is handled above, since no vertex can be within the
+  // limit of it.)
+  return !has_vertices;
+}
+
 bool S2HausdorffDistanceQuery::IsDistanceLess(
     const S2ShapeIndex* target, const S2ShapeIndex* source,
     S1ChordAngle distance_limit) const {
   return IsDirectedDistanceLess(target, source, distance_limit) &&
          IsDirectedDistanceLess(source, target, distance_limit);
 }
+
+bool S2HausdorffDistanceQuery::IsDistanceGreater(
+    const S2ShapeIndex* target, const S2ShapeIndex* source,
+    S1ChordAngle distance_limit) const {
+  return IsDirectedDistanceGreater(target, source, distance_limit) ||
+         IsDirectedDistanceGreater(source, target, distance_limit);
+}
@@ -104,8 +104,21 @@ class S2HausdorffDistanceQuery {
       include_interiors_ = include_interiors;
     }
 
+    // Specifies the allowed error for the IsDistanceGreater() and
+    // IsDirectedDistanceGreater() predicates (zero by default, i.e. the
+    // predicates are exact).  With a non-zero max_error those methods may
+    // return false when the true Hausdorff distance exceeds the limit by at
+    // most max_error; in exchange the per-vertex distance tests can
+    // terminate sooner, which speeds up the common case where most vertex
+    // distances are well below the limit.  The other query methods are not
+    // affected by this option.
+    S1ChordAngle max_error() const { return max_error_; }
+
+    void set_max_error(S1ChordAngle max_error) { max_error_ = max_error; }
+
    private:
     bool include_interiors_ = true;
+    S1ChordAngle max_error_ = S1ChordAngle::Zero();
   };
 
   // DirectedResult stores the results of directed Hausdorff distance queries
@@ -188,6 +201,21 @@ class S2HausdorffDistanceQuery {
                               const S2ShapeIndex* source,
                               S1ChordAngle distance_limit) const;
 
+  // Computes if the directed Hausdorff distance from the target index to the
+  // source index is greater than the distance limit.  This is much faster
+  // than computing the full distance and comparing: the scan stops at the
+  // first target vertex whose minimum distance to the source exceeds the
+  // limit, and each per-vertex test stops as soon as any source edge within
+  // the limit is found.  If options().max_error() is non-zero the result is
+  // approximate as described there.
+  //
+  // If either index is empty the Hausdorff distance is infinite and true is
+  // returned, consistent with the Infinity() convention used by
+  // GetDirectedDistance().
+  bool IsDirectedDistanceGreater(const S2ShapeIndex* target,
+                                 const S2ShapeIndex* source,
+                                 S1ChordAngle distance_limit) const;
+
   // Compute the [undirected] Hausdorff distance between the target index
   // and the source index.  Returns nullopt iff at least one of the shape
   // indexes is empty.
@@ -210,6 +238,13 @@ class S2HausdorffDistanceQuery {
                       const S2ShapeIndex* source,
                       S1ChordAngle distance_limit) const;
 
+  // Computes if the undirected Hausdorff distance is greater than the
+  // distance limit, terminating as early as possible (see
+  // IsDirectedDistanceGreater() above).
+  bool IsDistanceGreater(const S2ShapeIndex* target,
+                         const S2ShapeIndex* source,
+                         S1ChordAngle distance_limit) const;
+
  private:
   Options options_;
 };
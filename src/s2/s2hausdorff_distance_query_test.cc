@@ -403,3 +403,46 @@ TEST(S2HausdorffDistanceQueryTest, WholeWorldSameReference) {
   EXPECT_FALSE(a_to_b_distance_less_inf);
   EXPECT_FALSE(a_to_a_distance_less_inf);
 }
+
+// Test the early-exit IsDistanceGreater predicates against the distances
+// computed by the full queries.
+TEST(S2HausdorffDistanceQueryTest, IsDistanceGreaterMatchesDistance) {
+  auto a = s2textformat::MakeIndexOrDie("# 0:0, 0:1, 0:2 #");
+  auto b = s2textformat::MakeIndexOrDie("# 1:0, 1:1, 1:2 #");
+  S2HausdorffDistanceQuery query;
+
+  const S1ChordAngle directed_a_b = query.GetDirectedDistance(a.get(), b.get());
+  const S1ChordAngle distance = query.GetDistance(a.get(), b.get());
+
+  EXPECT_TRUE(query.IsDirectedDistanceGreater(
+      a.get(), b.get(), S1ChordAngle::Degrees(0.5)));
+  EXPECT_FALSE(query.IsDirectedDistanceGreater(a.get(), b.get(), directed_a_b));
+  EXPECT_TRUE(query.IsDistanceGreater(a.get(), b.get(),
+                                      S1ChordAngle::Degrees(0.5)));
+  EXPECT_FALSE(query.IsDistanceGreater(a.get(), b.get(), distance));
+
+  // Empty indexes have infinite Hausdorff distance, so any finite limit is
+  // exceeded.
+  auto empty = s2textformat::MakeIndexOrDie("# #");
+  EXPECT_TRUE(query.IsDistanceGreater(empty.get(), b.get(),
+                                      S1ChordAngle::Degrees(90)));
+  EXPECT_TRUE(query.IsDistanceGreater(a.get(), empty.get(),
+                                      S1ChordAngle::Degrees(90)));
+  EXPECT_TRUE(query.IsDirectedDistanceGreater(empty.get(), b.get(),
+                                              S1ChordAngle::Degrees(90)));
+}
+
+// Test the approximate mode: with max_error set, a distance that exceeds the
+// limit by more than max_error must still be reported as greater, and a
+// distance within the limit must never be.
+TEST(S2HausdorffDistanceQueryTest, IsDistanceGreaterWithMaxError) {
+  auto a = s2textformat::MakeIndexOrDie("# 0:0, 0:1, 0:2 #");
+  auto b = s2textformat::MakeIndexOrDie("# 1:0, 1:1, 1:2 #");
+  S2HausdorffDistanceQuery query;
+  query.mutable_options()->set_max_error(S1ChordAngle::Degrees(0.25));
+
+  const S1ChordAngle distance = query.GetDistance(a.get(), b.get());
+  EXPECT_TRUE(query.IsDistanceGreater(
+      a.get(), b.get(), distance - S1ChordAngle::Degrees(0.5)));
+  EXPECT_FALSE(query.IsDistanceGreater(a.get(), b.get(), distance));
+}
@@ -17,6 +17,7 @@
 
 #include <algorithm>
 #include <atomic>
+#include <memory>
 #include <utility>
 
 #include "absl/log/absl_check.h"
@@ -204,3 +205,31 @@ bool S2IndexCellData::ShapeContains(const S2ClippedShape& clipped,
   }
   return inside;
 }
+
+// S2IndexCellDataPool ///////////////////////////////////////
+
+S2IndexCellDataPool::Loan S2IndexCellDataPool::Borrow() {
+  {
+    absl::MutexLock lock(&lock_);
+    if (!idle_.empty()) {
+      std::unique_ptr<S2IndexCellData> data = std::move(idle_.back());
+      idle_.pop_back();
+      return Loan(this, std::move(data));
+    }
+  }
+  return Loan(this, std::make_unique<S2IndexCellData>());
+}
+
+void S2IndexCellDataPool::Return(std::unique_ptr<S2IndexCellData> data) {
+  // Reset the instance so that it keeps its buffer capacity but drops any
+  // pointers into the borrower's index, and restore the default decoding
+  // configuration for the next borrower.
+  data->Reset();
+  for (int dim = 0; dim <= 2; ++dim) {
+    data->set_dim_wanted(dim, true);
+  }
+  absl::MutexLock lock(&lock_);
+  if (static_cast<int>(idle_.size()) < max_retained_) {
+    idle_.push_back(std::move(data));
+  }
+}
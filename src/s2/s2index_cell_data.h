@@ -17,6 +17,7 @@
 #define S2_S2INDEX_CELL_DATA_H_
 
 #include <atomic>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -260,4 +261,95 @@ class S2IndexCellData {
   Region dim_regions_[3];
 };
 
+// A pool of reusable S2IndexCellData instances.  Decoding a cell allocates
+// buffers for its edges and shape regions, and those buffers are retained
+// when an instance is returned to the pool, so query objects that share a
+// pool (e.g. several joins or validation passes over the same index) decode
+// into warm buffers instead of each allocating, discarding, and re-growing
+// their own.
+//
+// Borrow() hands out an instance wrapped in a Loan, an RAII handle that
+// returns the instance to the pool when it is destroyed.  Returned instances
+// are Reset(), so a borrower always sees a freshly-configured instance (all
+// dimensions wanted, no cell loaded) that merely keeps its capacity.
+//
+// The pool retains at most "max_retained" idle instances; instances returned
+// beyond that are simply freed, which bounds the memory kept alive by bursts
+// of concurrent queries.
+//
+// Thread-safe: a single pool may be shared by query objects running on
+// multiple threads.  Borrowing and returning take a short lock, which
+// queries typically do once per query rather than once per cell.
+class S2IndexCellDataPool {
+ public:
+  // Creates a pool that retains up to "max_retained" idle instances.
+  explicit S2IndexCellDataPool(int max_retained = 8)
+      : max_retained_(max_retained) {
+    ABSL_DCHECK_GE(max_retained, 0);
+  }
+
+  S2IndexCellDataPool(const S2IndexCellDataPool&) = delete;
+  S2IndexCellDataPool& operator=(const S2IndexCellDataPool&) = delete;
+
+  // An RAII handle to a borrowed S2IndexCellData.  The instance is returned
+  // to the pool when the Loan is destroyed.  Loans are movable but not
+  // copyable, and must not outlive the pool they came from.
+  class Loan {
+   public:
+    Loan() = default;
+
+    Loan(Loan&& other) noexcept
+        : pool_(std::exchange(other.pool_, nullptr)),
+          data_(std::move(other.data_)) {}
+
+    Loan& operator=(Loan&& other) noexcept {
+      Release();
+      pool_ = std::exchange(other.pool_, nullptr);
+      data_ = std::move(other.data_);
+      return *this;
+    }
+
+    ~Loan() { Release(); }
+
+    S2IndexCellData* get() const { return data_.get(); }
+    S2IndexCellData& operator*() const { return *data_; }
+    S2IndexCellData* operator->() const { return data_.get(); }
+
+   private:
+    friend class S2IndexCellDataPool;
+
+    Loan(S2IndexCellDataPool* pool, std::unique_ptr<S2IndexCellData> data)
+        : pool_(pool), data_(std::move(data)) {}
+
+    // Returns the instance to the pool, if any.
+    void Release() {
+      if (pool_ != nullptr) {
+        pool_->Return(std::move(data_));
+        pool_ = nullptr;
+      }
+    }
+
+    S2IndexCellDataPool* pool_ = nullptr;
+    std::unique_ptr<S2IndexCellData> data_;
+  };
+
+  // Returns an idle instance from the pool, or a new instance if the pool is
+  // empty.
+  Loan Borrow();
+
+  // Returns the number of idle instances currently retained.
+  int num_idle() const {
+    absl::MutexLock lock(&lock_);
+    return static_cast<int>(idle_.size());
+  }
+
+ private:
+  // Returns an instance to the pool, freeing it if the pool is full.
+  void Return(std::unique_ptr<S2IndexCellData> data);
+
+  const int max_retained_;
+  mutable absl::Mutex lock_;
+  std::vector<std::unique_ptr<S2IndexCellData>> idle_ ABSL_GUARDED_BY(lock_);
+};
+
 #endif  // S2_S2INDEX_CELL_DATA_H_
@@ -152,4 +152,42 @@ TEST(S2IndexCellData, CellAndCenterRecomputed) {
   EXPECT_THAT(center1, Eq(center2));
 }
 
+
+TEST(S2IndexCellDataPool, ReusesInstances) {
+  unique_ptr<MutableS2ShapeIndex> index =
+      s2textformat::MakeIndexOrDie("0:0 # 1:1, 2:2 #");
+  MutableS2ShapeIndex::Iterator iter(index.get(), S2ShapeIndex::BEGIN);
+
+  S2IndexCellDataPool pool;
+  S2IndexCellData* first;
+  {
+    S2IndexCellDataPool::Loan loan = pool.Borrow();
+    first = loan.get();
+    loan->LoadCell(index.get(), iter.id(), &iter.cell());
+    EXPECT_THAT(loan->edges(), Not(IsEmpty()));
+  }
+  EXPECT_THAT(pool.num_idle(), Eq(1));
+
+  // The same instance comes back, freshly reset.
+  S2IndexCellDataPool::Loan loan = pool.Borrow();
+  EXPECT_THAT(loan.get(), Eq(first));
+  EXPECT_THAT(pool.num_idle(), Eq(0));
+  EXPECT_THAT(loan->index(), Eq(nullptr));
+  EXPECT_TRUE(loan->dim_wanted(0));
+  EXPECT_TRUE(loan->dim_wanted(1));
+  EXPECT_TRUE(loan->dim_wanted(2));
+  loan->LoadCell(index.get(), iter.id(), &iter.cell());
+  EXPECT_THAT(loan->edges(), Not(IsEmpty()));
+}
+
+TEST(S2IndexCellDataPool, RetainsAtMostMaxRetained) {
+  S2IndexCellDataPool pool(/*max_retained=*/1);
+  {
+    S2IndexCellDataPool::Loan loan1 = pool.Borrow();
+    S2IndexCellDataPool::Loan loan2 = pool.Borrow();
+    EXPECT_THAT(loan1.get(), Ne(loan2.get()));
+  }
+  EXPECT_THAT(pool.num_idle(), Eq(1));
+}
+
 }  // namespace
@@ -0,0 +1,106 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2int_latlng_shapes.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+#include "absl/types/span.h"
+#include "s2/s2latlng.h"
+#include "s2/s2point.h"
+#include "s2/s2shape.h"
+#include "s2/s2shapeutil_get_reference_point.h"
+
+using std::vector;
+
+S2IntLatLng S2IntLatLng::FromPoint(const S2Point& p) {
+  S2LatLng ll(p);
+  return S2IntLatLng(ll.lat().e7(), ll.lng().e7());
+}
+
+bool S2IntLatLng::Representable(const S2Point& p) {
+  return FromPoint(p).ToPoint() == p;
+}
+
+vector<S2IntLatLng> S2IntLatLngsFromPoints(absl::Span<const S2Point> points) {
+  vector<S2IntLatLng> latlngs;
+  latlngs.reserve(points.size());
+  for (const S2Point& p : points) {
+    ABSL_DCHECK(S2IntLatLng::Representable(p));
+    latlngs.push_back(S2IntLatLng::FromPoint(p));
+  }
+  return latlngs;
+}
+
+vector<S2Point> S2PointsFromIntLatLngs(absl::Span<const S2IntLatLng> latlngs) {
+  vector<S2Point> points;
+  points.reserve(latlngs.size());
+  for (const S2IntLatLng& ll : latlngs) points.push_back(ll.ToPoint());
+  return points;
+}
+
+S2IntLatLngPolygonShape::S2IntLatLngPolygonShape(
+    const vector<vector<S2IntLatLng>>& loops) {
+  Init(loops);
+}
+
+S2IntLatLngPolygonShape::S2IntLatLngPolygonShape(
+    const vector<vector<S2Point>>& loops) {
+  vector<vector<S2IntLatLng>> e7_loops;
+  e7_loops.reserve(loops.size());
+  for (const auto& loop : loops) {
+    e7_loops.push_back(S2IntLatLngsFromPoints(loop));
+  }
+  Init(e7_loops);
+}
+
+void S2IntLatLngPolygonShape::Init(const vector<vector<S2IntLatLng>>& loops) {
+  vertices_.clear();
+  loop_starts_.assign(1, 0);
+  loop_starts_.reserve(loops.size() + 1);
+  for (const auto& loop : loops) {
+    vertices_.insert(vertices_.end(), loop.begin(), loop.end());
+    loop_starts_.push_back(static_cast<int32>(vertices_.size()));
+  }
+}
+
+S2Shape::Edge S2IntLatLngPolygonShape::edge(int e) const {
+  ChainPosition pos = S2IntLatLngPolygonShape::chain_position(e);
+  return S2IntLatLngPolygonShape::chain_edge(pos.chain_id, pos.offset);
+}
+
+S2Shape::ReferencePoint S2IntLatLngPolygonShape::GetReferencePoint() const {
+  return s2shapeutil::GetReferencePoint(*this);
+}
+
+S2Shape::Edge S2IntLatLngPolygonShape::chain_edge(int i, int j) const {
+  ABSL_DCHECK_LT(i, num_loops());
+  ABSL_DCHECK_LT(j, num_loop_vertices(i));
+  int start = loop_starts_[i];
+  int k = (j + 1 == num_loop_vertices(i)) ? 0 : j + 1;
+  return Edge(vertices_[start + j].ToPoint(), vertices_[start + k].ToPoint());
+}
+
+S2Shape::ChainPosition S2IntLatLngPolygonShape::chain_position(int e) const {
+  ABSL_DCHECK_LT(e, num_edges());
+  // Find the loop containing edge "e" by binary search over the cumulative
+  // vertex counts.
+  int i = static_cast<int>(std::upper_bound(loop_starts_.begin() + 1,
+                                            loop_starts_.end(), e) -
+                           (loop_starts_.begin() + 1));
+  return ChainPosition(i, e - loop_starts_[i]);
+}
@@ -0,0 +1,259 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// This file defines S2Shape types whose vertices are stored as fixed-point
+// E7 (latitude, longitude) pairs rather than as S2Points.  After snapping
+// with IntLatLngSnapFunction(7) every output vertex is of the form
+// S2LatLng::FromE7(lat_e7, lng_e7).ToPoint(), so for snapped data these
+// shapes are lossless while using 8 bytes per vertex instead of 24.  As a
+// bonus, vertex equality and deduplication become integer comparisons.
+//
+// The trade-off is that edge accessors convert from E7 back to S2Point on
+// every call, which involves trigonometry.  These shapes are therefore best
+// suited to geometry that is stored in bulk and indexed or scanned a small
+// number of times; for query-heavy workloads, convert to one of the
+// S2Point-based shapes first.
+//
+// S2IntLatLngPointVectorShape
+//   - like S2PointVectorShape, but with E7 vertex storage.
+//
+// S2IntLatLngPolylineShape
+//   - like S2LaxPolylineShape, but with E7 vertex storage.
+//
+// S2IntLatLngPolygonShape
+//   - like S2LaxPolygonShape, but with E7 vertex storage.
+
+#ifndef S2_S2INT_LATLNG_SHAPES_H_
+#define S2_S2INT_LATLNG_SHAPES_H_
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "s2/base/types.h"
+#include "absl/log/absl_check.h"
+#include "absl/types/span.h"
+#include "s2/s2latlng.h"
+#include "s2/s2point.h"
+#include "s2/s2shape.h"
+
+// A latitude-longitude pair in E7 fixed-point representation, i.e. degrees
+// multiplied by 1e7 and rounded to the nearest integer.  This is the vertex
+// representation produced by IntLatLngSnapFunction(7).
+struct S2IntLatLng {
+  int32 lat_e7 = 0;
+  int32 lng_e7 = 0;
+
+  S2IntLatLng() = default;
+  S2IntLatLng(int32 lat_e7_arg, int32 lng_e7_arg)
+      : lat_e7(lat_e7_arg), lng_e7(lng_e7_arg) {}
+
+  // Returns the E7 representation closest to the given point.  The result is
+  // lossless if and only if Representable(p) is true.
+  static S2IntLatLng FromPoint(const S2Point& p);
+
+  // Returns true if "p" converts to E7 and back without any loss, i.e. p is
+  // exactly a point that IntLatLngSnapFunction(7) could have produced.
+  static bool Representable(const S2Point& p);
+
+  S2LatLng ToLatLng() const { return S2LatLng::FromE7(lat_e7, lng_e7); }
+  S2Point ToPoint() const { return ToLatLng().ToPoint(); }
+
+  friend bool operator==(const S2IntLatLng& x, const S2IntLatLng& y) {
+    return x.lat_e7 == y.lat_e7 && x.lng_e7 == y.lng_e7;
+  }
+  friend bool operator!=(const S2IntLatLng& x, const S2IntLatLng& y) {
+    return !(x == y);
+  }
+  // Lexicographic order, for sorting and deduplication.
+  friend bool operator<(const S2IntLatLng& x, const S2IntLatLng& y) {
+    if (x.lat_e7 != y.lat_e7) return x.lat_e7 < y.lat_e7;
+    return x.lng_e7 < y.lng_e7;
+  }
+
+  template <typename H>
+  friend H AbslHashValue(H h, const S2IntLatLng& ll) {
+    return H::combine(std::move(h), ll.lat_e7, ll.lng_e7);
+  }
+};
+
+// Converts each point to its nearest E7 representation.
+//
+// REQUIRES (in debug mode): Every point satisfies S2IntLatLng::Representable.
+std::vector<S2IntLatLng> S2IntLatLngsFromPoints(
+    absl::Span<const S2Point> points);
+
+// Converts each E7 pair back to an S2Point.
+std::vector<S2Point> S2PointsFromIntLatLngs(
+    absl::Span<const S2IntLatLng> latlngs);
+
+// S2IntLatLngPointVectorShape is like S2PointVectorShape except that the
+// points are stored in E7 fixed-point form.  Each point is represented as a
+// degenerate edge with the same starting and ending vertices.
+class S2IntLatLngPointVectorShape : public S2Shape {
+ public:
+  // Constructs an empty point vector.
+  S2IntLatLngPointVectorShape() = default;
+
+  S2IntLatLngPointVectorShape(S2IntLatLngPointVectorShape&&) = default;
+  S2IntLatLngPointVectorShape& operator=(S2IntLatLngPointVectorShape&&) =
+      default;
+
+  // Constructs a shape from a vector of E7 pairs.
+  explicit S2IntLatLngPointVectorShape(std::vector<S2IntLatLng> points)
+      : points_(std::move(points)) {}
+
+  // Constructs a shape from a vector of points.
+  //
+  // REQUIRES (in debug mode): Every point satisfies S2IntLatLng::Representable.
+  explicit S2IntLatLngPointVectorShape(absl::Span<const S2Point> points)
+      : points_(S2IntLatLngsFromPoints(points)) {}
+
+  int num_points() const { return static_cast<int>(points_.size()); }
+  const S2IntLatLng& point(int i) const { return points_[i]; }
+
+  // S2Shape interface:
+  int num_edges() const final { return num_points(); }
+  Edge edge(int e) const final {
+    S2Point p = points_[e].ToPoint();
+    return Edge(p, p);
+  }
+  int dimension() const final { return 0; }
+  ReferencePoint GetReferencePoint() const final {
+    return ReferencePoint::Contained(false);
+  }
+  int num_chains() const final { return num_points(); }
+  Chain chain(int i) const final { return Chain(i, 1); }
+  Edge chain_edge(int i, int j) const final {
+    ABSL_DCHECK_EQ(j, 0);
+    return edge(i);
+  }
+  ChainPosition chain_position(int e) const final {
+    return ChainPosition(e, 0);
+  }
+
+ private:
+  std::vector<S2IntLatLng> points_;
+};
+
+// S2IntLatLngPolylineShape is like S2LaxPolylineShape except that the
+// vertices are stored in E7 fixed-point form.  Adjacent vertices may be
+// identical, and the polyline may have any number of vertices (a polyline
+// with one vertex defines a degenerate edge).
+class S2IntLatLngPolylineShape : public S2Shape {
+ public:
+  // Constructs an empty polyline.
+  S2IntLatLngPolylineShape() = default;
+
+  S2IntLatLngPolylineShape(S2IntLatLngPolylineShape&&) = default;
+  S2IntLatLngPolylineShape& operator=(S2IntLatLngPolylineShape&&) = default;
+
+  // Constructs a polyline from a vector of E7 pairs.
+  explicit S2IntLatLngPolylineShape(std::vector<S2IntLatLng> vertices)
+      : vertices_(std::move(vertices)) {}
+
+  // Constructs a polyline from a vector of points.
+  //
+  // REQUIRES (in debug mode): Every point satisfies S2IntLatLng::Representable.
+  explicit S2IntLatLngPolylineShape(absl::Span<const S2Point> vertices)
+      : vertices_(S2IntLatLngsFromPoints(vertices)) {}
+
+  int num_vertices() const { return static_cast<int>(vertices_.size()); }
+  const S2IntLatLng& vertex(int i) const { return vertices_[i]; }
+
+  // S2Shape interface:
+  int num_edges() const final { return std::max(0, num_vertices() - 1); }
+  Edge edge(int e) const final {
+    ABSL_DCHECK_LT(e, num_edges());
+    return Edge(vertices_[e].ToPoint(), vertices_[e + 1].ToPoint());
+  }
+  int dimension() const final { return 1; }
+  ReferencePoint GetReferencePoint() const final {
+    return ReferencePoint::Contained(false);
+  }
+  int num_chains() const final { return std::min(1, num_edges()); }
+  Chain chain(int i) const final {
+    ABSL_DCHECK_EQ(i, 0);
+    return Chain(0, num_edges());
+  }
+  Edge chain_edge(int i, int j) const final {
+    ABSL_DCHECK_EQ(i, 0);
+    return edge(j);
+  }
+  ChainPosition chain_position(int e) const final {
+    return ChainPosition(0, e);
+  }
+
+ private:
+  std::vector<S2IntLatLng> vertices_;
+};
+
+// S2IntLatLngPolygonShape is like S2LaxPolygonShape except that the vertices
+// are stored in E7 fixed-point form.  The polygon consists of zero or more
+// loops whose interior is on the left of all edges; degenerate loops and
+// duplicate vertices are allowed.  (Full polygons, whose single loop has no
+// vertices, are not supported since an empty loop cannot be distinguished
+// from them in this representation.)
+class S2IntLatLngPolygonShape : public S2Shape {
+ public:
+  // Constructs an empty polygon.
+  S2IntLatLngPolygonShape() = default;
+
+  S2IntLatLngPolygonShape(S2IntLatLngPolygonShape&&) = default;
+  S2IntLatLngPolygonShape& operator=(S2IntLatLngPolygonShape&&) = default;
+
+  // Constructs a polygon from a vector of loops of E7 pairs.
+  explicit S2IntLatLngPolygonShape(
+      const std::vector<std::vector<S2IntLatLng>>& loops);
+
+  // Constructs a polygon from a vector of loops of points.
+  //
+  // REQUIRES (in debug mode): Every point satisfies S2IntLatLng::Representable.
+  explicit S2IntLatLngPolygonShape(
+      const std::vector<std::vector<S2Point>>& loops);
+
+  int num_loops() const { return static_cast<int>(loop_starts_.size()) - 1; }
+  int num_vertices() const { return static_cast<int>(vertices_.size()); }
+  int num_loop_vertices(int i) const {
+    return loop_starts_[i + 1] - loop_starts_[i];
+  }
+  const S2IntLatLng& loop_vertex(int i, int j) const {
+    ABSL_DCHECK_LT(j, num_loop_vertices(i));
+    return vertices_[loop_starts_[i] + j];
+  }
+
+  // S2Shape interface:
+  int num_edges() const final { return num_vertices(); }
+  Edge edge(int e) const final;
+  int dimension() const final { return 2; }
+  ReferencePoint GetReferencePoint() const final;
+  int num_chains() const final { return num_loops(); }
+  Chain chain(int i) const final {
+    int start = loop_starts_[i];
+    return Chain(start, loop_starts_[i + 1] - start);
+  }
+  Edge chain_edge(int i, int j) const final;
+  ChainPosition chain_position(int e) const final;
+
+ private:
+  void Init(const std::vector<std::vector<S2IntLatLng>>& loops);
+
+  std::vector<S2IntLatLng> vertices_;
+  // Entry i is the index of the first vertex of loop i; a final sentinel
+  // entry is equal to num_vertices().  (So loop_starts_ is never empty.)
+  std::vector<int32> loop_starts_ = {0};
+};
+
+#endif  // S2_S2INT_LATLNG_SHAPES_H_
@@ -0,0 +1,161 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2int_latlng_shapes.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "absl/flags/flag.h"
+#include "absl/types/span.h"
+#include "s2/s2builder.h"
+#include "s2/s2builderutil_lax_polyline_layer.h"
+#include "s2/s2builderutil_snap_functions.h"
+#include "s2/s2error.h"
+#include "s2/s2latlng.h"
+#include "s2/s2lax_polygon_shape.h"
+#include "s2/s2lax_polyline_shape.h"
+#include "s2/s2point.h"
+#include "s2/s2shape.h"
+#include "s2/s2testing.h"
+#include "s2/s2text_format.h"
+
+using s2textformat::MakeLaxPolygonOrDie;
+using s2textformat::MakeLaxPolylineOrDie;
+using s2textformat::ParsePointsOrDie;
+using std::vector;
+
+namespace {
+
+// Verifies that "shape" has the same structure and edges as "expected".
+void ExpectShapesEqual(const S2Shape& expected, const S2Shape& actual) {
+  ASSERT_EQ(expected.num_edges(), actual.num_edges());
+  EXPECT_EQ(expected.dimension(), actual.dimension());
+  ASSERT_EQ(expected.num_chains(), actual.num_chains());
+  for (int i = 0; i < expected.num_chains(); ++i) {
+    EXPECT_EQ(expected.chain(i).start, actual.chain(i).start);
+    EXPECT_EQ(expected.chain(i).length, actual.chain(i).length);
+  }
+  for (int e = 0; e < expected.num_edges(); ++e) {
+    EXPECT_EQ(expected.edge(e).v0, actual.edge(e).v0);
+    EXPECT_EQ(expected.edge(e).v1, actual.edge(e).v1);
+    EXPECT_EQ(expected.chain_position(e).chain_id,
+              actual.chain_position(e).chain_id);
+    EXPECT_EQ(expected.chain_position(e).offset,
+              actual.chain_position(e).offset);
+  }
+}
+
+TEST(S2IntLatLng, PointConversionRoundTrip) {
+  S2IntLatLng ll(123456789, -987654321);
+  EXPECT_EQ(ll, S2IntLatLng::FromPoint(ll.ToPoint()));
+  EXPECT_TRUE(S2IntLatLng::Representable(ll.ToPoint()));
+}
+
+TEST(S2IntLatLng, RandomPointsAreNotRepresentable) {
+  // Unsnapped points round-trip through E7 with loss (with overwhelming
+  // probability), but FromPoint() still returns the nearest grid point.
+  S2Testing::rnd.Reset(absl::GetFlag(FLAGS_s2_random_seed));
+  for (int i = 0; i < 100; ++i) {
+    S2Point p = S2Testing::RandomPoint();
+    S2IntLatLng ll = S2IntLatLng::FromPoint(p);
+    EXPECT_LE(S2LatLng(p).GetDistance(ll.ToLatLng()).degrees(), 1e-7);
+  }
+}
+
+TEST(S2IntLatLng, ComparisonAndHashing) {
+  S2IntLatLng a(1, 2), b(1, 3), c(2, 0);
+  EXPECT_TRUE(a == a);
+  EXPECT_TRUE(a != b);
+  EXPECT_TRUE(a < b);
+  EXPECT_TRUE(b < c);
+}
+
+TEST(S2IntLatLngPointVectorShape, MatchesS2PointVectorShape) {
+  auto points = ParsePointsOrDie("10:20, -30:150.5, 0:0, 10:20");
+  S2IntLatLngPointVectorShape shape((absl::Span<const S2Point>(points)));
+  EXPECT_EQ(4, shape.num_points());
+  EXPECT_EQ(0, shape.dimension());
+  for (int i = 0; i < shape.num_points(); ++i) {
+    EXPECT_EQ(points[i], shape.edge(i).v0);
+    EXPECT_EQ(points[i], shape.edge(i).v1);
+  }
+  // Deduplication is an integer comparison.
+  EXPECT_EQ(shape.point(0), shape.point(3));
+}
+
+TEST(S2IntLatLngPolylineShape, MatchesLaxPolylineShape) {
+  auto expected = MakeLaxPolylineOrDie("10:20, 10:30, 20:30, 20:40");
+  vector<S2Point> vertices;
+  for (int i = 0; i < expected->num_vertices(); ++i) {
+    vertices.push_back(expected->vertex(i));
+  }
+  S2IntLatLngPolylineShape shape((absl::Span<const S2Point>(vertices)));
+  ExpectShapesEqual(*expected, shape);
+}
+
+TEST(S2IntLatLngPolylineShape, Empty) {
+  S2IntLatLngPolylineShape shape;
+  EXPECT_EQ(0, shape.num_edges());
+  EXPECT_EQ(0, shape.num_chains());
+}
+
+TEST(S2IntLatLngPolygonShape, MatchesLaxPolygonShape) {
+  auto expected = MakeLaxPolygonOrDie(
+      "0:0, 0:10, 10:10, 10:0; 2:2, 8:2, 8:8, 2:8; 40:40, 40:41, 41:41");
+  vector<vector<S2Point>> loops;
+  for (int i = 0; i < expected->num_loops(); ++i) {
+    vector<S2Point> loop;
+    for (int j = 0; j < expected->num_loop_vertices(i); ++j) {
+      loop.push_back(expected->loop_vertex(i, j));
+    }
+    loops.push_back(std::move(loop));
+  }
+  S2IntLatLngPolygonShape shape(loops);
+  ExpectShapesEqual(*expected, shape);
+  EXPECT_EQ(expected->GetReferencePoint().contained,
+            shape.GetReferencePoint().contained);
+}
+
+TEST(S2IntLatLngPolygonShape, Empty) {
+  S2IntLatLngPolygonShape shape;
+  EXPECT_EQ(0, shape.num_loops());
+  EXPECT_EQ(0, shape.num_edges());
+  EXPECT_EQ(0, shape.num_chains());
+}
+
+TEST(S2IntLatLngShapes, SnappedBuilderOutputIsRepresentable) {
+  // Geometry snapped with IntLatLngSnapFunction(7) can be stored in E7 form
+  // without any loss.
+  S2Builder builder{S2Builder::Options(s2builderutil::IntLatLngSnapFunction(7))};
+  S2LaxPolylineShape output;
+  builder.StartLayer(
+      std::make_unique<s2builderutil::LaxPolylineLayer>(&output));
+  builder.AddShape(*MakeLaxPolylineOrDie(
+      "10.1234567891:20.9876543219, 15.5:25.5, -30.00000001:150"));
+  S2Error error;
+  ASSERT_TRUE(builder.Build(&error)) << error;
+  vector<S2Point> vertices;
+  for (int i = 0; i < output.num_vertices(); ++i) {
+    ASSERT_TRUE(S2IntLatLng::Representable(output.vertex(i)));
+    vertices.push_back(output.vertex(i));
+  }
+  S2IntLatLngPolylineShape compact((absl::Span<const S2Point>(vertices)));
+  ExpectShapesEqual(output, compact);
+}
+
+}  // namespace
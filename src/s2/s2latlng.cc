@@ -23,7 +23,9 @@
 #include <ostream>
 #include <string>
 
+#include "absl/log/absl_check.h"
 #include "absl/strings/str_format.h"
+#include "absl/types/span.h"
 #include "s2/util/coding/coder.h"
 #include "s2/r2.h"
 #include "s2/s1angle.h"
@@ -68,6 +70,32 @@ S2Point S2LatLng::ToPoint() const {
   return S2Point(cos(theta) * cosphi, sin(theta) * cosphi, sin(phi));
 }
 
+void S2LatLng::ToPoints(absl::Span<const S2LatLng> latlngs,
+                        absl::Span<S2Point> points) {
+  ABSL_DCHECK_EQ(latlngs.size(), points.size());
+  for (size_t i = 0; i < latlngs.size(); ++i) {
+    points[i] = latlngs[i].ToPoint();
+  }
+}
+
+void S2LatLng::FromPoints(absl::Span<const S2Point> points,
+                          absl::Span<S2LatLng> latlngs) {
+  ABSL_DCHECK_EQ(points.size(), latlngs.size());
+  for (size_t i = 0; i < points.size(); ++i) {
+    latlngs[i] = S2LatLng(points[i]);
+  }
+}
+
+void S2LatLng::NormalizedFromDegrees(absl::Span<const double> lat_degrees,
+                                     absl::Span<const double> lng_degrees,
+                                     absl::Span<S2LatLng> latlngs) {
+  ABSL_DCHECK_EQ(lat_degrees.size(), lng_degrees.size());
+  ABSL_DCHECK_EQ(lat_degrees.size(), latlngs.size());
+  for (size_t i = 0; i < latlngs.size(); ++i) {
+    latlngs[i] = FromDegrees(lat_degrees[i], lng_degrees[i]).Normalized();
+  }
+}
+
 S2LatLng::S2LatLng(const S2Point& p)
   : coords_(Latitude(p).radians(), Longitude(p).radians()) {
   // The latitude and longitude are already normalized.
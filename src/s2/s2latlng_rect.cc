@@ -22,9 +22,11 @@
 #include <algorithm>
 #include <cmath>
 #include <ostream>
+#include <vector>
 
 #include "absl/flags/flag.h"
 #include "absl/log/absl_check.h"
+#include "absl/types/span.h"
 #include "s2/util/coding/coder.h"
 #include "s2/r1interval.h"
 #include "s2/s1angle.h"
@@ -741,3 +743,54 @@ bool S2LatLngRect::ApproxEquals(const S2LatLngRect& other,
 std::ostream& operator<<(std::ostream& os, const S2LatLngRect& r) {
   return os << "[Lo" << r.lo() << ", Hi" << r.hi() << "]";
 }
+
+void S2LatLngRectFilter::Init(absl::Span<const S2LatLngRect> rects) {
+  num_rects_ = rects.size();
+  lat_lo_.resize(num_rects_);
+  lat_hi_.resize(num_rects_);
+  lng_lo_.resize(num_rects_);
+  lng_hi_.resize(num_rects_);
+  for (int i = 0; i < num_rects_; ++i) {
+    ABSL_DCHECK(rects[i].is_valid());
+    lat_lo_[i] = rects[i].lat_lo().radians();
+    lat_hi_[i] = rects[i].lat_hi().radians();
+    lng_lo_[i] = rects[i].lng_lo().radians();
+    lng_hi_[i] = rects[i].lng_hi().radians();
+  }
+}
+
+void S2LatLngRectFilter::GetIntersecting(const S2LatLngRect& query,
+                                         vector<uint64>* bitmap) const {
+  bitmap->assign((num_rects_ + 63) >> 6, 0);
+  if (query.is_empty()) return;
+  const double q_lat_lo = query.lat().lo();
+  const double q_lat_hi = query.lat().hi();
+  const double q_lng_lo = query.lng().lo();
+  const double q_lng_hi = query.lng().hi();
+  const bool q_inverted = query.lng().is_inverted();
+  for (int base = 0; base < num_rects_; base += 64) {
+    const int count = min(64, num_rects_ - base);
+    uint64 word = 0;
+    for (int j = 0; j < count; ++j) {
+      const int i = base + j;
+      // R1Interval::Intersects for the latitude intervals.
+      const bool lat_ok = (q_lat_lo <= lat_hi_[i]) & (lat_lo_[i] <= q_lat_hi);
+
+      // S1Interval::Intersects for the longitude intervals, rewritten without
+      // branches.  "c1 & c2" covers two non-inverted intervals; any inverted
+      // interval intersects everything that satisfies c1 or c2; and two
+      // inverted intervals always intersect (both contain longitude Pi).
+      // The empty interval [Pi, -Pi] is excluded explicitly since it is
+      // also inverted.
+      const bool inverted = lng_lo_[i] > lng_hi_[i];
+      const bool empty = (lng_lo_[i] == M_PI) & (lng_hi_[i] == -M_PI);
+      const bool c1 = q_lng_lo <= lng_hi_[i];
+      const bool c2 = q_lng_hi >= lng_lo_[i];
+      const bool lng_ok =
+          !empty & ((c1 & c2) | ((inverted | q_inverted) & (c1 | c2)) |
+                    (inverted & q_inverted));
+      word |= uint64{lat_ok & lng_ok} << j;
+    }
+    (*bitmap)[base >> 6] = word;
+  }
+}
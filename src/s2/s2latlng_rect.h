@@ -22,7 +22,9 @@
 #include <iosfwd>
 #include <iostream>
 #include <ostream>
+#include <vector>
 
+#include "absl/types/span.h"
 #include "s2/util/coding/coder.h"
 #include "s2/_fp_contract_off.h"
 #include "s2/r1interval.h"
@@ -443,4 +445,41 @@ inline bool S2LatLngRect::operator!=(const S2LatLngRect& other) const {
 
 std::ostream& operator<<(std::ostream& os, const S2LatLngRect& r);
 
+// S2LatLngRectFilter is a building block for coarse batch filtering: it
+// stores a collection of rectangles in structure-of-arrays form (separate
+// lat_lo/lat_hi/lng_lo/lng_hi arrays) and tests all of them against a single
+// query rectangle, producing a bitmap of the survivors.  The intersection
+// test is evaluated branchlessly (including the longitude wraparound cases)
+// so that the compiler can vectorize the inner loop, which makes this much
+// faster than calling S2LatLngRect::Intersects once per stored rectangle.
+//
+// REQUIRES: All rectangles satisfy S2LatLngRect::is_valid().
+class S2LatLngRectFilter {
+ public:
+  // Constructs an empty filter; requires Init() to be called.
+  S2LatLngRectFilter() = default;
+
+  // Convenience constructor that calls Init().
+  explicit S2LatLngRectFilter(absl::Span<const S2LatLngRect> rects) {
+    Init(rects);
+  }
+
+  // Initializes the filter with the given collection of rectangles.
+  void Init(absl::Span<const S2LatLngRect> rects);
+
+  // Returns the number of stored rectangles.
+  int num_rects() const { return num_rects_; }
+
+  // Computes a bitmap such that bit (i % 64) of word (i / 64) is set if and
+  // only if stored rectangle "i" intersects "query".  The bitmap is resized
+  // to (num_rects() + 63) / 64 words.  The results are identical to calling
+  // rect.Intersects(query) for each stored rectangle in turn.
+  void GetIntersecting(const S2LatLngRect& query,
+                       std::vector<uint64>* bitmap) const;
+
+ private:
+  int num_rects_ = 0;
+  std::vector<double> lat_lo_, lat_hi_, lng_lo_, lng_hi_;
+};
+
 #endif  // S2_S2LATLNG_RECT_H_
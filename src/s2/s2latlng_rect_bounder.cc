@@ -43,6 +43,27 @@ void S2LatLngRectBounder::AddLatLng(const S2LatLng& b_latlng) {
   AddInternal(b_latlng.ToPoint(), b_latlng);
 }
 
+void S2LatLngRectBounder::AddPoints(absl::Span<const S2Point> points) {
+  // The vertices are converted to S2LatLng in fixed-size blocks ahead of the
+  // per-edge bound logic.  The conversions (two atan2 calls per vertex) have
+  // no data dependencies between vertices, so a separate conversion loop
+  // pipelines much better than interleaving the conversions with the branchy
+  // per-edge latitude adjustment in AddInternal().
+  constexpr int kBlockSize = 16;
+  S2LatLng latlngs[kBlockSize];
+  while (!points.empty()) {
+    const int n = static_cast<int>(std::min(size_t{kBlockSize}, points.size()));
+    for (int i = 0; i < n; ++i) {
+      ABSL_DCHECK(S2::IsUnitLength(points[i]));
+      latlngs[i] = S2LatLng(points[i]);
+    }
+    for (int i = 0; i < n; ++i) {
+      AddInternal(points[i], latlngs[i]);
+    }
+    points.remove_prefix(n);
+  }
+}
+
 void S2LatLngRectBounder::AddInternal(const S2Point& b,
                                       const S2LatLng& b_latlng) {
   // Simple consistency check to verify that b and b_latlng are alternate
@@ -18,6 +18,8 @@
 #ifndef S2_S2LATLNG_RECT_BOUNDER_H_
 #define S2_S2LATLNG_RECT_BOUNDER_H_
 
+#include "absl/types/span.h"
+
 #include "s2/s2latlng.h"
 #include "s2/s2latlng_rect.h"
 #include "s2/s2point.h"
@@ -42,6 +44,12 @@ class S2LatLngRectBounder {
   // vertices are ignored.
   void AddPoint(const S2Point& b);
 
+  // Adds a chain of vertices in order.  This is equivalent to calling
+  // AddPoint() on each vertex in turn, but converts the vertices to S2LatLng
+  // in blocks ahead of the per-edge bound logic, which is noticeably faster
+  // for large vertex arrays.  Requires that all points have unit length.
+  void AddPoints(absl::Span<const S2Point> points);
+
   // This method is called to add a vertex to the chain when the vertex is
   // represented as an S2LatLng.  Repeated vertices are ignored.
   void AddLatLng(const S2LatLng& b_latlng);
@@ -27,6 +27,7 @@
 
 #include "absl/log/absl_check.h"
 #include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 
 #include "s2/base/types.h"
 #include "s2/r1interval.h"
@@ -342,3 +343,28 @@ TEST(RectBounder, AccuracyBug) {
   EXPECT_GE(ac_expanded.lat().hi(), ac.lat().hi());
 }
 
+TEST(RectBounder, AddPointsMatchesAddPoint) {
+  // AddPoints() must produce exactly the same bound as repeated AddPoint(),
+  // including for chains longer than its internal conversion block size.
+  for (int num_points : {0, 1, 2, 15, 16, 17, 100}) {
+    vector<S2Point> points;
+    for (int i = 0; i < num_points; ++i) {
+      points.push_back(S2Testing::RandomPoint());
+    }
+    S2LatLngRectBounder expected;
+    for (const S2Point& p : points) {
+      expected.AddPoint(p);
+    }
+    S2LatLngRectBounder bounder;
+    bounder.AddPoints(points);
+    EXPECT_EQ(expected.GetBound(), bounder.GetBound()) << num_points;
+
+    // AddPoints() may also continue an existing chain.
+    S2LatLngRectBounder split;
+    const size_t mid = points.size() / 2;
+    split.AddPoints(absl::MakeSpan(points.data(), mid));
+    split.AddPoints(absl::MakeSpan(points.data() + mid, points.size() - mid));
+    EXPECT_EQ(expected.GetBound(), split.GetBound()) << num_points;
+  }
+}
+
@@ -1054,3 +1054,43 @@ TEST(S2LatLngRect, Hash) {
       {RectFromDegrees(-89, 0, 89, 1), RectFromDegrees(1, 5, 1, 5),
        S2LatLngRect::Empty(), S2LatLngRect::Full()}));
 }
+
+TEST(S2LatLngRectFilter, MatchesIntersects) {
+  // Build a collection of rectangles that exercises the longitude wraparound
+  // and degenerate cases, then verify that the filter bitmap agrees exactly
+  // with S2LatLngRect::Intersects for a variety of queries.
+  std::vector<S2LatLngRect> rects;
+  rects.push_back(S2LatLngRect::Empty());
+  rects.push_back(S2LatLngRect::Full());
+  for (int i = 0; i < 200; ++i) {
+    rects.push_back(
+        S2LatLngRect::FromPointPair(S2LatLng(S2Testing::RandomPoint()),
+                                    S2LatLng(S2Testing::RandomPoint())));
+  }
+  // Some rectangles that cross the anti-meridian (inverted lng intervals).
+  rects.push_back(RectFromDegrees(-10, 170, 10, -170));
+  rects.push_back(RectFromDegrees(-90, 100, 90, -100));
+
+  S2LatLngRectFilter filter(rects);
+  ASSERT_EQ(static_cast<int>(rects.size()), filter.num_rects());
+
+  std::vector<S2LatLngRect> queries;
+  queries.push_back(S2LatLngRect::Empty());
+  queries.push_back(S2LatLngRect::Full());
+  queries.push_back(RectFromDegrees(-5, 175, 5, -175));
+  for (int i = 0; i < 50; ++i) {
+    queries.push_back(
+        S2LatLngRect::FromPointPair(S2LatLng(S2Testing::RandomPoint()),
+                                    S2LatLng(S2Testing::RandomPoint())));
+  }
+  std::vector<uint64> bitmap;
+  for (const S2LatLngRect& query : queries) {
+    filter.GetIntersecting(query, &bitmap);
+    ASSERT_EQ((rects.size() + 63) / 64, bitmap.size());
+    for (size_t i = 0; i < rects.size(); ++i) {
+      bool survived = (bitmap[i >> 6] >> (i & 63)) & 1;
+      EXPECT_EQ(rects[i].Intersects(query), survived)
+          << "rect: " << rects[i] << ", query: " << query;
+    }
+  }
+}
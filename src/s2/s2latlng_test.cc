@@ -19,12 +19,14 @@
 
 #include <cmath>
 #include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
 
 #include "absl/base/macros.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 
 #include "s2/s1angle.h"
 #include "s2/s2coder_testing.h"
@@ -103,6 +105,35 @@ TEST(S2LatLng, TestConversion) {
   }
 }
 
+TEST(S2LatLng, TestBulkConversion) {
+  // The batch conversions must match their per-element equivalents exactly.
+  std::vector<S2Point> points;
+  std::vector<S2LatLng> latlngs;
+  std::vector<double> lat_degrees, lng_degrees;
+  for (int i = 0; i < 1000; ++i) {
+    points.push_back(S2Testing::RandomPoint());
+    latlngs.push_back(S2LatLng(points.back()));
+    // Include unnormalized coordinates as seen in wire formats.
+    lat_degrees.push_back(200 * S2Testing::rnd.RandDouble() - 100);
+    lng_degrees.push_back(800 * S2Testing::rnd.RandDouble() - 400);
+  }
+  std::vector<S2Point> bulk_points(latlngs.size());
+  S2LatLng::ToPoints(latlngs, absl::MakeSpan(bulk_points));
+  std::vector<S2LatLng> bulk_latlngs(points.size());
+  S2LatLng::FromPoints(points, absl::MakeSpan(bulk_latlngs));
+  std::vector<S2LatLng> bulk_normalized(lat_degrees.size());
+  S2LatLng::NormalizedFromDegrees(lat_degrees, lng_degrees,
+                                  absl::MakeSpan(bulk_normalized));
+  for (size_t i = 0; i < points.size(); ++i) {
+    EXPECT_EQ(latlngs[i].ToPoint(), bulk_points[i]);
+    EXPECT_EQ(S2LatLng(points[i]), bulk_latlngs[i]);
+    EXPECT_EQ(
+        S2LatLng::FromDegrees(lat_degrees[i], lng_degrees[i]).Normalized(),
+        bulk_normalized[i]);
+    EXPECT_TRUE(bulk_normalized[i].is_valid());
+  }
+}
+
 bool IsIdentical(double x, double y) {
   return x == y && signbit(x) == signbit(y);
 }
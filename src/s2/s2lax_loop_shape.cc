@@ -92,6 +92,24 @@ S2Shape::ReferencePoint S2LaxLoopShape::GetReferencePoint() const {
   return s2shapeutil::GetReferencePoint(*this);
 }
 
+S2Shape::Edge S2LaxLoopViewShape::edge(int e0) const {
+  ABSL_DCHECK_LT(e0, num_edges());
+  int e1 = e0 + 1;
+  if (e1 == num_vertices()) e1 = 0;
+  return Edge(vertices_[e0], vertices_[e1]);
+}
+
+S2Shape::Edge S2LaxLoopViewShape::chain_edge(int i, int j) const {
+  ABSL_DCHECK_EQ(i, 0);
+  ABSL_DCHECK_LT(j, num_edges());
+  int k = (j + 1 == num_vertices()) ? 0 : j + 1;
+  return Edge(vertices_[j], vertices_[k]);
+}
+
+S2Shape::ReferencePoint S2LaxLoopViewShape::GetReferencePoint() const {
+  return s2shapeutil::GetReferencePoint(*this);
+}
+
 S2VertexIdLaxLoopShape::S2VertexIdLaxLoopShape(S2VertexIdLaxLoopShape&& other)
     : S2Shape(std::move(other)),
       num_vertices_(std::exchange(other.num_vertices_, 0)),
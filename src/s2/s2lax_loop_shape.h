@@ -25,6 +25,13 @@
 //   - like S2LaxLoopShape, but defines a loop that does not have an interior
 //     (a closed polyline).
 //
+// S2LaxLoopViewShape
+//   - like S2LaxLoopShape, but does not own its vertices; useful for
+//     building transient indexes over existing vertex arrays.
+//
+// S2LaxClosedPolylineViewShape
+//   - like S2LaxClosedPolylineShape, but does not own its vertices.
+//
 // S2VertexIdLaxLoopShape
 //   - like S2LaxLoopShape, but vertices are specified as indices into an
 //     existing vertex array.
@@ -113,6 +120,58 @@ class S2LaxClosedPolylineShape : public S2LaxLoopShape {
   }
 };
 
+// S2LaxLoopViewShape is like S2LaxLoopShape except that it does not own its
+// vertices; it simply references a contiguous array provided by the caller.
+// This makes it possible to build a transient index over columnar data
+// without copying any vertices.  The vertices are not owned by this class
+// and must persist unchanged for the lifetime of this object (and of any
+// index built over it).
+class S2LaxLoopViewShape : public S2Shape {
+ public:
+  // Constructs an empty loop.
+  S2LaxLoopViewShape() = default;
+
+  // Constructs a loop viewing the given vertices, which are not copied.
+  explicit S2LaxLoopViewShape(absl::Span<const S2Point> vertices)
+      : vertices_(vertices) {}
+
+  // Initializes a loop viewing the given vertices, which are not copied.
+  void Init(absl::Span<const S2Point> vertices) { vertices_ = vertices; }
+
+  int num_vertices() const { return static_cast<int>(vertices_.size()); }
+  const S2Point& vertex(int i) const { return vertices_[i]; }
+
+  // S2Shape interface (identical to S2LaxLoopShape):
+  int num_edges() const final { return num_vertices(); }
+  Edge edge(int e) const final;
+  // Not final; overridden by S2LaxClosedPolylineViewShape.
+  int dimension() const override { return 2; }
+  // Not final; overridden by S2LaxClosedPolylineViewShape.
+  ReferencePoint GetReferencePoint() const override;
+  int num_chains() const final { return std::min(1, num_vertices()); }
+  Chain chain(int i) const final { return Chain(0, num_vertices()); }
+  Edge chain_edge(int i, int j) const final;
+  ChainPosition chain_position(int e) const final {
+    return ChainPosition(0, e);
+  }
+
+ private:
+  absl::Span<const S2Point> vertices_;
+};
+
+// S2LaxClosedPolylineViewShape is like S2LaxClosedPolylineShape except that
+// it does not own its vertices (see S2LaxLoopViewShape).
+class S2LaxClosedPolylineViewShape : public S2LaxLoopViewShape {
+ public:
+  // See S2LaxLoopViewShape for constructors.
+  using S2LaxLoopViewShape::S2LaxLoopViewShape;
+
+  int dimension() const final { return 1; }
+  ReferencePoint GetReferencePoint() const final {
+    return ReferencePoint::Contained(false);
+  }
+};
+
 // S2VertexIdLaxLoopShape is just like S2LaxLoopShape, except that vertices are
 // specified as indices into a vertex array.  This representation can be more
 // compact when many loops are arranged in a mesh structure.
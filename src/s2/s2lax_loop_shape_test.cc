@@ -25,6 +25,7 @@
 #include "s2/base/casts.h"
 #include "s2/base/types.h"
 #include <gtest/gtest.h>
+#include "absl/types/span.h"
 #include "s2/mutable_s2shape_index.h"
 #include "s2/s2loop.h"
 #include "s2/s2point.h"
@@ -164,3 +165,23 @@ TEST(S2VertexIdLaxLoopShape, InvertedLoop) {
   EXPECT_FALSE(shape.is_full());
   EXPECT_TRUE(s2shapeutil::ContainsBruteForce(shape, S2::Origin()));
 }
+
+TEST(S2LaxLoopViewShape, ViewsWithoutCopying) {
+  vector<S2Point> vertices =
+      s2textformat::ParsePointsOrDie("0:0, 0:1, 1:1, 1:0");
+  S2LaxLoopShape owned(vertices);
+  S2LaxLoopViewShape view((absl::Span<const S2Point>(vertices)));
+  s2testing::ExpectEqual(owned, view);
+  // The view references the caller's array rather than copying it.
+  EXPECT_EQ(&vertices[0], &view.vertex(0));
+}
+
+TEST(S2LaxClosedPolylineViewShape, NoInterior) {
+  vector<S2Point> vertices =
+      s2textformat::ParsePointsOrDie("0:0, 0:1, 1:1, 1:0");
+  S2LaxClosedPolylineViewShape shape((absl::Span<const S2Point>(vertices)));
+  EXPECT_EQ(1, shape.dimension());
+  EXPECT_FALSE(shape.is_empty());
+  EXPECT_FALSE(shape.is_full());
+  EXPECT_FALSE(shape.GetReferencePoint().contained);
+}
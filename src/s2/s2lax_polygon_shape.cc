@@ -23,6 +23,7 @@
 #include <utility>
 #include <vector>
 
+#include "absl/container/fixed_array.h"
 #include "absl/log/absl_check.h"
 #include "absl/types/span.h"
 
@@ -79,7 +80,8 @@ S2LaxPolygonShape::S2LaxPolygonShape(S2LaxPolygonShape&& b)
       prev_loop_(b.prev_loop_.exchange(0, std::memory_order_relaxed)),
       num_vertices_(std::exchange(b.num_vertices_, 0)),
       vertices_(std::move(b.vertices_)),
-      loop_starts_(std::move(b.loop_starts_)) {}
+      loop_starts_(std::move(b.loop_starts_)),
+      chain_samples_(std::move(b.chain_samples_)) {}
 
 S2LaxPolygonShape& S2LaxPolygonShape::operator=(S2LaxPolygonShape&& b) {
   using std::memory_order_relaxed;
@@ -94,6 +96,7 @@ S2LaxPolygonShape& S2LaxPolygonShape::operator=(S2LaxPolygonShape&& b) {
   num_vertices_ = std::exchange(b.num_vertices_, 0);
   vertices_ = std::move(b.vertices_);
   loop_starts_ = std::move(b.loop_starts_);
+  chain_samples_ = std::move(b.chain_samples_);
   return *this;
 }
 
@@ -129,6 +132,7 @@ void S2LaxPolygonShape::Init(const S2Polygon& polygon) {
 }
 
 void S2LaxPolygonShape::Init(Span<const Span<const S2Point>> loops) {
+  chain_samples_.reset();
   num_loops_ = loops.size();
   if (num_loops_ == 0) {
     num_vertices_ = 0;
@@ -180,6 +184,34 @@ const S2Point& S2LaxPolygonShape::loop_vertex(int i, int j) const {
   }
 }
 
+void S2LaxPolygonShape::PrepareChainPositions() {
+  if (num_loops() <= 1 || num_vertices() == 0) return;
+  const int num_samples = ((num_vertices_ - 1) >> kChainSampleShift) + 1;
+  // Don't use make_unique<> here in order to avoid zero initialization.
+  chain_samples_ = make_unique_for_overwrite<uint32[]>(num_samples);
+  uint32 i = 0;
+  for (int k = 0; k < num_samples; ++k) {
+    const uint32 e = static_cast<uint32>(k) << kChainSampleShift;
+    while (loop_starts_[i + 1] <= e) ++i;
+    chain_samples_[k] = i;
+  }
+}
+
+void S2LaxPolygonShape::GetChainEdges(int i, int j,
+                                      Span<Edge> edges) const {
+  ABSL_DCHECK_LT(i, num_loops());
+  ABSL_DCHECK_GE(j, 0);
+  const int n = num_loop_vertices(i);
+  ABSL_DCHECK_LE(j + static_cast<int64>(edges.size()), n);
+  const S2Point* base =
+      vertices_.get() + (num_loops() == 1 ? 0 : loop_starts_[i]);
+  for (Edge& edge : edges) {
+    const int k = (j + 1 == n) ? 0 : j + 1;
+    edge = Edge(base[j], base[k]);
+    j = k;
+  }
+}
+
 void S2LaxPolygonShape::Encode(Encoder* encoder,
                                s2coding::CodingHint hint) const {
   encoder->Ensure(1 + Varint::kMax32);
@@ -197,6 +229,7 @@ bool S2LaxPolygonShape::Init(Decoder* decoder) {
   if (decoder->avail() < 1) return false;
   uint8 version = decoder->get8();
   if (version != kCurrentEncodingVersionNumber) return false;
+  chain_samples_.reset();
 
   uint32 num_loops;
   if (!decoder->get_varint32(&num_loops)) return false;
@@ -239,6 +272,20 @@ S2Shape::Edge S2LaxPolygonShape::edge(int e) const {
   return S2LaxPolygonShape::chain_edge(pos.chain_id, pos.offset);
 }
 
+void S2LaxPolygonShape::GetEdges(int begin, int count, Edge* out) const {
+  ABSL_DCHECK_GE(begin, 0);
+  ABSL_DCHECK_LE(begin + count, num_edges());
+  // Resolve the containing loop once per run of edges rather than per edge.
+  while (count > 0) {
+    ChainPosition pos = S2LaxPolygonShape::chain_position(begin);
+    int n = std::min(count, num_loop_vertices(pos.chain_id) - pos.offset);
+    GetChainEdges(pos.chain_id, pos.offset, MakeSpan(out, n));
+    begin += n;
+    out += n;
+    count -= n;
+  }
+}
+
 S2Shape::ReferencePoint S2LaxPolygonShape::GetReferencePoint() const {
   return s2shapeutil::GetReferencePoint(*this);
 }
@@ -343,6 +390,32 @@ S2Shape::Edge EncodedS2LaxPolygonShape::edge(int e) const {
   }
 }
 
+void EncodedS2LaxPolygonShape::GetEdges(int begin, int count,
+                                        Edge* out) const {
+  ABSL_DCHECK_GE(begin, 0);
+  ABSL_DCHECK_LE(begin + count, num_edges());
+  while (count > 0) {
+    ChainPosition pos = EncodedS2LaxPolygonShape::chain_position(begin);
+    const int start = (num_loops() == 1) ? 0 : loop_starts_[pos.chain_id];
+    const int loop_size = num_loop_vertices(pos.chain_id);
+    const int n = std::min(count, loop_size - pos.offset);
+    // Decode the whole run of vertices at once.  This performs the lazy
+    // decoding checks once per run rather than twice per edge (each vertex
+    // is the v1 of one edge and the v0 of the next).
+    const bool wraps = (pos.offset + n == loop_size);
+    absl::FixedArray<S2Point> vertices(n + 1);
+    vertices_.DecodeRange(start + pos.offset, wraps ? n : n + 1,
+                          vertices.data());
+    if (wraps) vertices[n] = vertices_[start];
+    for (int k = 0; k < n; ++k) {
+      out[k] = Edge(vertices[k], vertices[k + 1]);
+    }
+    begin += n;
+    out += n;
+    count -= n;
+  }
+}
+
 S2Shape::ReferencePoint EncodedS2LaxPolygonShape::GetReferencePoint() const {
   return s2shapeutil::GetReferencePoint(*this);
 }
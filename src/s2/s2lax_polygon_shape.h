@@ -134,6 +134,27 @@ class S2LaxPolygonShape : public S2Shape {
   // REQUIRES: 0 <= j < num_loop_vertices(i)
   const S2Point& loop_vertex(int i, int j) const;
 
+  // Builds an optional table that accelerates chain_position() to
+  // near-constant time per call regardless of the number of loops, at a cost
+  // of four bytes per (1 << kChainSampleShift) edges.  Without the table,
+  // random edge ids are resolved by binary search over the loop starts; with
+  // it the search starts at the sampled loop and only scans the loops that
+  // begin within one sample interval.  The table has no effect for polygons
+  // with fewer than two loops, and is discarded if the shape is
+  // re-initialized.
+  //
+  // This method is not thread-safe and must not be called concurrently with
+  // any other method (typically it is called right after Init).
+  void PrepareChainPositions();
+
+  // Fills "edges" with consecutive edges of loop "i" starting at offset "j",
+  // such that edges[k] == chain_edge(i, j + k).  This is equivalent to
+  // calling chain_edge() once per edge but avoids the per-edge virtual
+  // dispatch and loop lookup.
+  // REQUIRES: 0 <= i < num_loops()
+  // REQUIRES: 0 <= j && j + edges.size() <= num_loop_vertices(i)
+  void GetChainEdges(int i, int j, absl::Span<Edge> edges) const;
+
   // Appends an encoded representation of the S2LaxPolygonShape to "encoder".
   //
   // REQUIRES: "encoder" uses the default constructor, so that its buffer
@@ -150,6 +171,7 @@ class S2LaxPolygonShape : public S2Shape {
   // S2Shape interface:
   int num_edges() const final { return num_vertices(); }
   Edge edge(int e) const final;
+  void GetEdges(int begin, int count, Edge* out) const final;
   int dimension() const final { return 2; }
   ReferencePoint GetReferencePoint() const final;
   int num_chains() const final { return num_loops(); }
@@ -175,6 +197,14 @@ class S2LaxPolygonShape : public S2Shape {
   // When num_loops_ > 1, stores an array of size (num_loops_ + 1) where
   // element "i" represents the total number of vertices in loops 0..i-1.
   std::unique_ptr<uint32[]> loop_starts_;
+
+  // Number of edges covered by each entry of chain_samples_ (a power of two
+  // so that an edge id can be mapped to its sample with a shift).
+  static constexpr int kChainSampleShift = 6;
+
+  // Optional table built by PrepareChainPositions(): entry "k" is the loop
+  // containing edge (k << kChainSampleShift).
+  std::unique_ptr<uint32[]> chain_samples_;
 };
 
 // Exactly like S2LaxPolygonShape, except that the vertices are kept in an
@@ -213,6 +243,7 @@ class EncodedS2LaxPolygonShape : public S2Shape {
   // S2Shape interface:
   int num_edges() const final { return num_vertices(); }
   Edge edge(int e) const final;
+  void GetEdges(int begin, int count, Edge* out) const final;
   int dimension() const final { return 2; }
   ReferencePoint GetReferencePoint() const final;
   int num_chains() const final { return num_loops(); }
@@ -268,6 +299,11 @@ inline S2Shape::ChainPosition S2LaxPolygonShape::chain_position(int e) const {
       do {
         ++start;
       } while (static_cast<uint32>(e) == start[1]);
+    } else if (chain_samples_ != nullptr) {
+      // Start at the loop containing the nearest preceding sampled edge; at
+      // most (1 << kChainSampleShift) loops can begin between two samples.
+      start = &loop_starts_[chain_samples_[e >> kChainSampleShift]];
+      while (start[1] <= static_cast<uint32>(e)) ++start;
     } else {
       start = &loop_starts_[0];
       constexpr int kMaxLinearSearchLoops = 12;  // From benchmarks.
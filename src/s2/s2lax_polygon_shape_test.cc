@@ -30,6 +30,7 @@
 
 #include "absl/log/absl_log.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 
 #include "s2/base/casts.h"
 #include "s2/util/coding/coder.h"
@@ -319,6 +320,83 @@ TEST(S2LaxPolygonShape, ManyLoopPolygon) {
   TestEncodedS2LaxPolygonShape(shape);
 }
 
+TEST(S2LaxPolygonShape, PreparedChainPositions) {
+  // PrepareChainPositions() must not change any chain_position() results.
+  // Use loop sizes that are both smaller and larger than the sample spacing.
+  vector<vector<S2Point>> loops;
+  for (int i = 0; i < 50; ++i) {
+    S2Point center(S2LatLng::FromDegrees(0, i));
+    loops.push_back(S2Testing::MakeRegularPoints(
+        center, S1Angle::Degrees(0.1), 1 + S2Testing::rnd.Uniform(100)));
+  }
+  S2LaxPolygonShape shape(loops);
+  shape.PrepareChainPositions();
+  vector<std::tuple<int, int, int>> edges;
+  for (int i = 0, e = 0; i < loops.size(); ++i) {
+    for (int j = 0; j < loops[i].size(); ++j, ++e) {
+      edges.push_back({e, i, j});
+    }
+  }
+  std::shuffle(edges.begin(), edges.end(), std::mt19937_64());
+  for (const auto t : edges) {
+    int e, i, j;
+    std::tie(e, i, j) = t;
+    EXPECT_EQ(shape.chain_position(e), S2Shape::ChainPosition(i, j));
+  }
+}
+
+TEST(S2LaxPolygonShape, GetChainEdges) {
+  vector<vector<S2Point>> loops;
+  for (int i = 0; i < 10; ++i) {
+    S2Point center(S2LatLng::FromDegrees(0, i));
+    loops.push_back(S2Testing::MakeRegularPoints(
+        center, S1Angle::Degrees(0.1), 3 + S2Testing::rnd.Uniform(10)));
+  }
+  S2LaxPolygonShape shape(loops);
+  for (int i = 0; i < shape.num_loops(); ++i) {
+    const int n = shape.num_loop_vertices(i);
+    // Fill the whole chain and also a subrange that wraps past the end.
+    vector<S2Shape::Edge> edges(n);
+    shape.GetChainEdges(i, 0, absl::MakeSpan(edges));
+    for (int j = 0; j < n; ++j) {
+      EXPECT_EQ(edges[j], shape.chain_edge(i, j));
+    }
+    vector<S2Shape::Edge> tail(2);
+    shape.GetChainEdges(i, n - 2, absl::MakeSpan(tail));
+    EXPECT_EQ(tail[0], shape.chain_edge(i, n - 2));
+    EXPECT_EQ(tail[1], shape.chain_edge(i, n - 1));
+  }
+}
+
+TEST(S2LaxPolygonShape, GetEdgesMatchesEdge) {
+  // Test the batched GetEdges() overrides (plain and encoded) against
+  // per-edge edge() calls for random subranges that span loop boundaries.
+  vector<vector<S2Point>> loops;
+  for (int i = 0; i < 20; ++i) {
+    S2Point center(S2LatLng::FromDegrees(0, i));
+    loops.push_back(S2Testing::MakeRegularPoints(
+        center, S1Angle::Degrees(0.1), 1 + S2Testing::rnd.Uniform(8)));
+  }
+  S2LaxPolygonShape shape(loops);
+  Encoder encoder;
+  shape.Encode(&encoder, s2coding::CodingHint::COMPACT);
+  Decoder decoder(encoder.base(), encoder.length());
+  EncodedS2LaxPolygonShape encoded;
+  ASSERT_TRUE(encoded.Init(&decoder));
+  const int num_edges = shape.num_edges();
+  for (int iter = 0; iter < 100; ++iter) {
+    const int begin = S2Testing::rnd.Uniform(num_edges);
+    const int count = S2Testing::rnd.Uniform(num_edges - begin + 1);
+    vector<S2Shape::Edge> expected(count);
+    for (int k = 0; k < count; ++k) expected[k] = shape.edge(begin + k);
+    vector<S2Shape::Edge> actual(count);
+    shape.GetEdges(begin, count, actual.data());
+    EXPECT_EQ(expected, actual);
+    encoded.GetEdges(begin, count, actual.data());
+    EXPECT_EQ(expected, actual);
+  }
+}
+
 TEST(S2LaxPolygonShape, DegenerateLoops) {
   vector<S2LaxPolygonShape::Loop> loops = {
       s2textformat::ParsePointsOrDie("1:1, 1:2, 2:2, 1:2, 1:3, 1:2, 1:1"),
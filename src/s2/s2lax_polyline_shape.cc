@@ -21,6 +21,7 @@
 #include <memory>
 #include <utility>
 
+#include "absl/container/fixed_array.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/types/span.h"
@@ -123,6 +124,12 @@ S2Shape::ChainPosition S2LaxPolylineShape::chain_position(int e) const {
   return S2Shape::ChainPosition(0, e);
 }
 
+void EncodeS2LaxPolylineShape(const S2Polyline& polyline,
+                              s2coding::CodingHint hint, Encoder* encoder) {
+  // The encoding must be identical to S2LaxPolylineShape::Encode().
+  s2coding::EncodeS2PointVector(polyline.vertices_span(), hint, encoder);
+}
+
 bool EncodedS2LaxPolylineShape::Init(Decoder* decoder) {
   return vertices_.Init(decoder);
 }
@@ -138,6 +145,19 @@ S2Shape::Edge EncodedS2LaxPolylineShape::edge(int e) const {
   return Edge(vertex(e), vertex(e + 1));
 }
 
+void EncodedS2LaxPolylineShape::GetEdges(int begin, int count,
+                                         Edge* out) const {
+  ABSL_DCHECK_LE(begin + count, num_edges());
+  if (count == 0) return;
+  // Edges begin..begin+count-1 use vertices begin..begin+count, which can be
+  // decoded in a single pass over the underlying blocks.
+  absl::FixedArray<S2Point> vertices(count + 1);
+  vertices_.DecodeRange(begin, count + 1, vertices.data());
+  for (int i = 0; i < count; ++i) {
+    out[i] = Edge(vertices[i], vertices[i + 1]);
+  }
+}
+
 int EncodedS2LaxPolylineShape::num_chains() const {
   return std::min(1, EncodedS2LaxPolylineShape::num_edges());
 }
@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "s2/base/types.h"
+#include "absl/log/absl_check.h"
 #include "absl/types/span.h"
 #include "s2/util/coding/coder.h"
 #include "s2/encoded_s2point_vector.h"
@@ -106,6 +107,74 @@ class S2LaxPolylineShape : public S2Shape {
   std::unique_ptr<S2Point[]> vertices_;
 };
 
+// Appends an encoding of the given polyline's vertices to "encoder" in the
+// S2LaxPolylineShape format, without copying the vertices into an
+// intermediate shape.  With CodingHint::COMPACT the vertices are stored as
+// fixed-size compressed blocks together with a block offset table, so unlike
+// S2Polyline's own compressed encoding (which must be decoded front to
+// back), the result supports random vertex access when decoded as an
+// EncodedS2LaxPolylineShape.
+//
+// REQUIRES: "encoder" uses the default constructor, so that its buffer
+//           can be enlarged as necessary by calling Ensure(int).
+void EncodeS2LaxPolylineShape(const S2Polyline& polyline,
+                              s2coding::CodingHint hint, Encoder* encoder);
+
+// S2LaxPolylineViewShape is like S2LaxPolylineShape except that it does not
+// own its vertices; it simply references a contiguous array provided by the
+// caller.  This makes it possible to build a transient index over columnar
+// data without copying any vertices.  The vertices are not owned by this
+// class and must persist unchanged for the lifetime of this object (and of
+// any index built over it).
+class S2LaxPolylineViewShape : public S2Shape {
+ public:
+  // Constructs an empty polyline.
+  S2LaxPolylineViewShape() = default;
+
+  // Constructs a polyline viewing the given vertices, which are not copied.
+  explicit S2LaxPolylineViewShape(absl::Span<const S2Point> vertices)
+      : vertices_(vertices) {}
+
+  // Initializes a polyline viewing the given vertices, which are not copied.
+  void Init(absl::Span<const S2Point> vertices) { vertices_ = vertices; }
+
+  int num_vertices() const { return static_cast<int>(vertices_.size()); }
+  const S2Point& vertex(int i) const { return vertices_[i]; }
+
+  // Appends an encoded representation to "encoder" in the same format as
+  // S2LaxPolylineShape (so the result can be decoded as one).
+  //
+  // REQUIRES: "encoder" uses the default constructor, so that its buffer
+  //           can be enlarged as necessary by calling Ensure(int).
+  void Encode(Encoder* encoder, s2coding::CodingHint hint) const override {
+    s2coding::EncodeS2PointVector(vertices_, hint, encoder);
+  }
+
+  // S2Shape interface (identical to S2LaxPolylineShape):
+  int num_edges() const final { return std::max(0, num_vertices() - 1); }
+  Edge edge(int e) const final {
+    ABSL_DCHECK_LT(e, num_edges());
+    return Edge(vertices_[e], vertices_[e + 1]);
+  }
+  int dimension() const final { return 1; }
+  ReferencePoint GetReferencePoint() const final {
+    return ReferencePoint::Contained(false);
+  }
+  int num_chains() const final { return std::min(1, num_edges()); }
+  Chain chain(int i) const final { return Chain(0, num_edges()); }
+  Edge chain_edge(int i, int j) const final {
+    ABSL_DCHECK_EQ(i, 0);
+    return edge(j);
+  }
+  ChainPosition chain_position(int e) const final {
+    return ChainPosition(0, e);
+  }
+  TypeTag type_tag() const override { return S2LaxPolylineShape::kTypeTag; }
+
+ private:
+  absl::Span<const S2Point> vertices_;
+};
+
 // Exactly like S2LaxPolylineShape, except that the vertices are kept in an
 // encoded form and are decoded only as they are accessed.  This allows for
 // very fast initialization and no additional memory use beyond the encoded
@@ -137,9 +206,20 @@ class EncodedS2LaxPolylineShape : public S2Shape {
   int num_vertices() const { return vertices_.size(); }
   S2Point vertex(int i) const { return vertices_[i]; }
 
+  // Decodes the "count" vertices starting at index "begin" and stores them at
+  // "out".  Only the compressed blocks overlapping the requested range are
+  // decoded, so reading a window of a long polyline does not require decoding
+  // the entire line.
+  //
+  // REQUIRES: 0 <= begin && begin + count <= num_vertices()
+  void GetVertices(int begin, int count, S2Point* out) const {
+    vertices_.DecodeRange(begin, count, out);
+  }
+
   // S2Shape interface:
   int num_edges() const final { return std::max(0, num_vertices() - 1); }
   Edge edge(int e) const final;
+  void GetEdges(int begin, int count, Edge* out) const final;
   int dimension() const final { return 1; }
   ReferencePoint GetReferencePoint() const final {
     return ReferencePoint::Contained(false);
@@ -17,16 +17,20 @@
 
 #include "s2/s2lax_polyline_shape.h"
 
+#include <cstring>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include <gtest/gtest.h>
+#include "absl/types/span.h"
 #include "s2/util/coding/coder.h"
 #include "s2/s2coder.h"
 #include "s2/s2coder_testing.h"
 #include "s2/s2error.h"
+#include "s2/s2latlng.h"
 #include "s2/s2point.h"
+#include "s2/s2polyline.h"
 #include "s2/s2shape.h"
 #include "s2/s2shapeutil_testing.h"
 #include "s2/s2text_format.h"
@@ -116,6 +120,50 @@ TEST(EncodedS2LaxPolylineShape, RoundtripEncoding) {
   s2testing::ExpectEqual(shape, b_shape);
 }
 
+TEST(EncodedS2LaxPolylineShape, EncodeS2PolylineDirectly) {
+  // EncodeS2LaxPolylineShape should produce exactly the same bytes as
+  // copying the polyline into an S2LaxPolylineShape and encoding that.
+  auto polyline = s2textformat::MakePolylineOrDie("0:0, 0:1, 1:1, 2:2");
+  Encoder direct_encoder;
+  EncodeS2LaxPolylineShape(*polyline, s2coding::CodingHint::COMPACT,
+                           &direct_encoder);
+  Encoder copied_encoder;
+  S2LaxPolylineShape(*polyline).Encode(&copied_encoder,
+                                       s2coding::CodingHint::COMPACT);
+  ASSERT_EQ(direct_encoder.length(), copied_encoder.length());
+  EXPECT_EQ(0, memcmp(direct_encoder.base(), copied_encoder.base(),
+                      direct_encoder.length()));
+}
+
+TEST(EncodedS2LaxPolylineShape, RandomAccessToVerticesAndEdges) {
+  // Uses enough vertices to span several compressed blocks.
+  vector<S2Point> vertices;
+  for (int i = 0; i < 100; ++i) {
+    vertices.push_back(S2LatLng::FromDegrees(0.1 * i, 0.2 * i).ToPoint());
+  }
+  S2Polyline polyline(vertices);
+  Encoder encoder;
+  EncodeS2LaxPolylineShape(polyline, s2coding::CodingHint::COMPACT, &encoder);
+  Decoder decoder(encoder.base(), encoder.length());
+  EncodedS2LaxPolylineShape shape;
+  ASSERT_TRUE(shape.Init(&decoder));
+  ASSERT_EQ(100, shape.num_vertices());
+
+  // Decode a window in the middle of the polyline and compare it against
+  // single-vertex and single-edge access.
+  const int kBegin = 30, kCount = 25;
+  vector<S2Point> window(kCount);
+  shape.GetVertices(kBegin, kCount, window.data());
+  for (int i = 0; i < kCount; ++i) {
+    EXPECT_EQ(shape.vertex(kBegin + i), window[i]);
+  }
+  vector<S2Shape::Edge> edges(kCount);
+  shape.GetEdges(kBegin, kCount, edges.data());
+  for (int i = 0; i < kCount; ++i) {
+    EXPECT_EQ(shape.edge(kBegin + i), edges[i]);
+  }
+}
+
 // TODO(b/222446546): Decoding EncodedS2PointVector on ARM isn't currently
 // supported, so comment out S2Coder test on ARM for now.
 #ifndef __arm__
@@ -191,3 +239,25 @@ TEST(S2LaxPolylineShape, ChainVertexIteratorWorks) {
 }
 
 #endif
+
+TEST(S2LaxPolylineViewShape, ViewsWithoutCopying) {
+  vector<S2Point> vertices =
+      s2textformat::ParsePointsOrDie("0:0, 0:1, 1:1, 1:0");
+  S2LaxPolylineShape owned(vertices);
+  S2LaxPolylineViewShape view((absl::Span<const S2Point>(vertices)));
+  s2testing::ExpectEqual(owned, view);
+  // The view references the caller's array rather than copying it.
+  EXPECT_EQ(&vertices[0], &view.vertex(0));
+}
+
+TEST(S2LaxPolylineViewShape, EncodingMatchesOwningShape) {
+  vector<S2Point> vertices =
+      s2textformat::ParsePointsOrDie("0:0, 0:1, 1:1");
+  S2LaxPolylineViewShape view((absl::Span<const S2Point>(vertices)));
+  Encoder encoder;
+  view.Encode(&encoder, s2coding::CodingHint::COMPACT);
+  Decoder decoder(encoder.base(), encoder.length());
+  S2LaxPolylineShape decoded;
+  ASSERT_TRUE(decoded.Init(&decoder));
+  s2testing::ExpectEqual(view, decoded);
+}
@@ -66,6 +66,7 @@
 #include "s2/s2pointutil.h"
 #include "s2/s2predicates.h"
 #include "s2/s2region.h"
+#include "s2/s2region_coverer.h"
 #include "s2/s2shape.h"
 #include "s2/s2shape_index.h"
 #include "s2/s2shapeutil_visit_crossing_edge_pairs.h"
@@ -179,6 +180,9 @@ S2Debug S2Loop::s2debug_override() const {
 
 void S2Loop::ClearIndex() {
   unindexed_contains_calls_.store(0, std::memory_order_relaxed);
+  contains_tables_built_ = false;
+  interior_cells_.Clear();
+  boundary_cells_.Clear();
   index_.Clear();
 }
 
@@ -314,9 +318,8 @@ void S2Loop::InitBound() {
   // Note that a small clockwise loop near the equator contains both poles.
 
   S2LatLngRectBounder bounder;
-  for (int i = 0; i <= num_vertices(); ++i) {
-    bounder.AddPoint(vertex(i));
-  }
+  bounder.AddPoints(vertices_span());
+  if (num_vertices() > 0) bounder.AddPoint(vertex(0));  // Close the loop.
   S2LatLngRect b = bounder.GetBound();
   if (Contains(S2Point(0, 0, 1))) {
     b = S2LatLngRect(R1Interval(b.lat().lo(), M_PI_2), S1Interval::Full());
@@ -344,6 +347,45 @@ void S2Loop::InitIndex() {
   }
 }
 
+void S2Loop::ForceBuildIndex(int num_threads, S2Executor* executor) {
+  ABSL_DCHECK_GE(num_threads, 1);
+  if (index_.is_fresh()) return;
+  if (num_threads > 1) {
+    // The threading options can only be set while the index is empty, so the
+    // shape is re-added.  (No work is discarded since the index has not been
+    // built yet.)
+    MutableS2ShapeIndex::Options options;
+    options.set_num_index_threads(num_threads);
+    options.set_executor(executor);
+    ClearIndex();
+    index_.Init(options);
+    InitIndex();
+  }
+  index_.ForceBuild();
+}
+
+void S2Loop::PrecomputeContainsTables(int max_cells) {
+  ABSL_DCHECK_GE(max_cells, 1);
+  S2RegionCoverer::Options options;
+  options.set_max_cells(max_cells);
+  S2RegionCoverer coverer(options);
+  // Classify each covering cell by whether it lies entirely inside the loop.
+  // Contains(S2Cell) is conservative (it can return false for a cell that is
+  // actually contained when the boundary passes nearby), which only causes
+  // such cells to take the exact fallback path in Contains(S2Point).
+  std::vector<S2CellId> interior, boundary;
+  for (S2CellId id : coverer.GetCovering(*this)) {
+    if (Contains(S2Cell(id))) {
+      interior.push_back(id);
+    } else {
+      boundary.push_back(id);
+    }
+  }
+  interior_cells_ = S2CellUnion(std::move(interior));
+  boundary_cells_ = S2CellUnion(std::move(boundary));
+  contains_tables_built_ = true;
+}
+
 S2Loop::S2Loop(const S2Cell& cell)
     : depth_(0),
       num_vertices_(4),
@@ -368,7 +410,10 @@ S2Loop::S2Loop(const S2Loop& src)
       origin_inside_(src.origin_inside_),
       unindexed_contains_calls_(0),
       bound_(src.bound_),
-      subregion_bound_(src.subregion_bound_) {
+      subregion_bound_(src.subregion_bound_),
+      contains_tables_built_(src.contains_tables_built_),
+      interior_cells_(src.interior_cells_),
+      boundary_cells_(src.boundary_cells_) {
   std::copy(&src.vertices_[0], &src.vertices_[num_vertices_], &vertices_[0]);
   InitIndex();
 }
@@ -566,6 +611,16 @@ bool S2Loop::BoundaryApproxIntersects(const MutableS2ShapeIndex::Iterator& it,
 }
 
 bool S2Loop::Contains(const S2Point& p) const {
+  if (contains_tables_built_) {
+    // Points in a cell that is entirely inside (or entirely outside) the
+    // loop are resolved by binary search, with no edge tests; see
+    // PrecomputeContainsTables().  Only points in cells that may intersect
+    // the boundary fall through to the exact test below.
+    S2CellId leaf = S2CellId(p);
+    if (interior_cells_.Contains(leaf)) return true;
+    if (!boundary_cells_.Contains(leaf)) return false;
+  }
+
   // NOTE(ericv): A bounds check slows down this function by about 50%.  It is
   // worthwhile only when it might allow us to delay building the index.
   if (!index_.is_fresh() && !bound_.Contains(p)) return false;
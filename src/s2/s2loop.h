@@ -34,6 +34,7 @@
 #include "s2/mutable_s2shape_index.h"
 #include "s2/s1angle.h"
 #include "s2/s1chord_angle.h"
+#include "s2/s2cell_union.h"
 #include "s2/s2debug.h"
 #include "s2/s2error.h"
 #include "s2/s2latlng_rect.h"
@@ -393,6 +394,38 @@ class S2Loop final : public S2Region {
   // Returns the total number of bytes used by the loop.
   size_t SpaceUsed() const;
 
+  // Builds the spatial index used by query methods such as Contains() and
+  // Intersects() if it has not been built yet.  The index is normally built
+  // lazily the first time it is needed, which means that concurrent first
+  // queries on a freshly constructed or decoded loop serialize while one
+  // thread builds it.  Calling this method at load time avoids such stalls.
+  //
+  // If "num_threads" is greater than 1 then the initial build is done in
+  // parallel (see MutableS2ShapeIndex::Options::num_index_threads()), with
+  // the threads run on "executor" (or S2Executor::Default() if nullptr).
+  // The executor, if given, is retained by the index and therefore must
+  // outlive the loop (see MutableS2ShapeIndex::Options::executor()).
+  //
+  // REQUIRES: num_threads >= 1
+  void ForceBuildIndex(int num_threads = 1, S2Executor* executor = nullptr);
+
+  // Precomputes acceleration tables for Contains(S2Point): a covering of the
+  // loop with at most "max_cells" cells, with each cell classified as either
+  // entirely inside the loop or possibly intersecting its boundary.
+  // Subsequent Contains(S2Point) calls classify the query point with a
+  // binary search over these tables, so points that are not close to the
+  // boundary are resolved without any edge tests.  Only points in cells
+  // crossed by the boundary fall back to the usual containment test.
+  //
+  // This is worthwhile for loops that receive very large numbers of point
+  // queries (e.g., geofences).  Larger values of "max_cells" make the tables
+  // bigger and slower to build but resolve more queries without edge tests.
+  // The tables are copied by Clone(), cleared whenever the loop is modified
+  // (Init(), Decode(), Invert()), and not preserved by Encode().
+  //
+  // REQUIRES: max_cells >= 1
+  void PrecomputeContainsTables(int max_cells = 256);
+
   ////////////////////////////////////////////////////////////////////////
   // S2Region interface (see s2region.h for details):
 
@@ -679,6 +712,14 @@ class S2Loop final : public S2Region {
   // Spatial index for this loop.
   MutableS2ShapeIndex index_;
 
+  // Optional acceleration tables for Contains(S2Point); see
+  // PrecomputeContainsTables().  "interior_cells_" holds covering cells that
+  // are entirely inside the loop and "boundary_cells_" covering cells that
+  // may intersect its boundary; points in neither union are outside.
+  bool contains_tables_built_ = false;
+  S2CellUnion interior_cells_;
+  S2CellUnion boundary_cells_;
+
   // SWIG doesn't understand "= delete".
 #ifndef SWIG
   void operator=(const S2Loop&) = delete;
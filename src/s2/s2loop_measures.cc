@@ -28,9 +28,11 @@
 #include "absl/log/absl_check.h"
 #include "s2/s1angle.h"
 #include "s2/s2centroids.h"
+#include "s2/s2edge_crossings.h"
 #include "s2/s2measures.h"
 #include "s2/s2point.h"
 #include "s2/s2point_span.h"
+#include "s2/s2predicates.h"
 
 using std::fabs;
 using std::max;
@@ -55,6 +57,15 @@ double GetArea(S2PointLoopSpan loop) {
   return area;
 }
 
+namespace {
+
+// Converts the raw signed triangle sum for "loop" into the signed area,
+// normalizing the range and double-checking the sign of near-zero results
+// against the loop curvature (see the comments in GetSignedArea).
+double SignedAreaFromTriangleSum(S2PointLoopSpan loop, double area);
+
+}  // namespace
+
 double GetSignedArea(S2PointLoopSpan loop) {
   // It is surprisingly difficult to compute the area of a loop robustly.  The
   // main issues are (1) whether degenerate loops are considered to be CCW or
@@ -122,7 +133,25 @@ double GetSignedArea(S2PointLoopSpan loop) {
 
   // The signed area should be between approximately -4*Pi and 4*Pi.
   // Normalize it to be in the range [-2*Pi, 2*Pi].
-  double area = GetSurfaceIntegralKahan(loop, S2::SignedArea);
+  return SignedAreaFromTriangleSum(
+      loop, GetSurfaceIntegralKahan(loop, S2::SignedArea));
+}
+
+double GetSignedAreaParallel(S2PointLoopSpan loop, int num_threads) {
+  return SignedAreaFromTriangleSum(
+      loop, GetSurfaceIntegralParallel(loop, S2::SignedArea, num_threads));
+}
+
+double GetAreaParallel(S2PointLoopSpan loop, int num_threads) {
+  double area = GetSignedAreaParallel(loop, num_threads);
+  ABSL_DCHECK_LE(fabs(area), 2 * M_PI);
+  if (area < 0.0) area += 4 * M_PI;
+  return area;
+}
+
+namespace {
+
+double SignedAreaFromTriangleSum(S2PointLoopSpan loop, double area) {
   double max_error = GetCurvatureMaxError(loop);
 
   // Normalize the area to be in the range (-2*Pi, 2*Pi].  Effectively this
@@ -148,6 +177,8 @@ double GetSignedArea(S2PointLoopSpan loop) {
   return area;
 }
 
+}  // namespace
+
 double GetApproxArea(S2PointLoopSpan loop) {
   return 2 * M_PI - GetCurvature(loop);
 }
@@ -227,12 +258,28 @@ double GetCurvature(S2PointLoopSpan loop) {
   // algorithm (http://en.wikipedia.org/wiki/Kahan_summation_algorithm).
   LoopOrder order = GetCanonicalLoopOrder(loop);
   int i = order.first, dir = order.dir, n = loop.size();
-  double sum = S2::TurnAngle(loop[(i + n - dir) % n], loop[i],
-                             loop[(i + dir) % n]);
+
+  // Each turn angle is the angle between RobustCrossProd(a, b) and
+  // RobustCrossProd(b, c), so consecutive turns share one cross product.
+  // Computing each cross product once (rather than expanding S2::TurnAngle
+  // per vertex) halves the calls to RobustCrossProd without changing the
+  // result: the reused value is bit-identical to what would be recomputed.
+  const S2Point* a = &loop[(i + n - dir) % n];
+  const S2Point* b = &loop[i];
+  const S2Point* c = &loop[(i + dir) % n];
+  S2Point bc = S2::RobustCrossProd(*b, *c);
+  double sum = S2::RobustCrossProd(*a, *b).Angle(bc);
+  if (s2pred::Sign(*a, *b, *c) <= 0) sum = -sum;
   double compensation = 0;  // Kahan summation algorithm
   while (--n > 0) {
     i += dir;
-    double angle = S2::TurnAngle(loop[i - dir], loop[i], loop[i + dir]);
+    a = b;
+    b = c;
+    c = &loop[i + dir];
+    S2Point ab = bc;
+    bc = S2::RobustCrossProd(*b, *c);
+    double angle = ab.Angle(bc);
+    if (s2pred::Sign(*a, *b, *c) <= 0) angle = -angle;
     double old_sum = sum;
     angle += compensation;
     sum += angle;
@@ -271,6 +318,10 @@ S2Point GetCentroid(S2PointLoopSpan loop) {
   return GetSurfaceIntegral(loop, S2::TrueCentroid);
 }
 
+S2Point GetCentroidParallel(S2PointLoopSpan loop, int num_threads) {
+  return GetSurfaceIntegralParallel(loop, S2::TrueCentroid, num_threads);
+}
+
 static inline bool IsOrderLess(LoopOrder order1, LoopOrder order2,
                                S2PointLoopSpan loop) {
   if (order1 == order2) return false;
@@ -26,8 +26,12 @@
 #ifndef S2_S2LOOP_MEASURES_H_
 #define S2_S2LOOP_MEASURES_H_
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstddef>
 #include <ostream>
+#include <thread>
 #include <vector>
 
 #include "absl/log/absl_check.h"
@@ -76,6 +80,17 @@ double GetApproxArea(S2PointLoopSpan loop);
 //    (This is the "signed equivalent" of having an area of 4*Pi.)
 double GetSignedArea(S2PointLoopSpan loop);
 
+// Versions of GetArea() and GetSignedArea() that accumulate the triangle sum
+// in fixed-size blocks using up to "num_threads" threads (see
+// GetSurfaceIntegralParallel below).  This is worthwhile for very large loops
+// (hundreds of thousands of vertices or more); smaller loops are computed
+// serially.  The result is deterministic for a given loop regardless of the
+// number of threads, but may differ from the serial functions in the last few
+// bits since the compensated sums are grouped differently.  The error bounds
+// are the same as for the serial versions.
+double GetAreaParallel(S2PointLoopSpan loop, int num_threads);
+double GetSignedAreaParallel(S2PointLoopSpan loop, int num_threads);
+
 // Returns the geodesic curvature of the loop, defined as the sum of the turn
 // angles at each vertex (see S2::TurnAngle).  The result is positive if the
 // loop is counter-clockwise, negative if the loop is clockwise, and zero if
@@ -112,6 +127,12 @@ double GetCurvatureMaxError(S2PointLoopSpan loop);
 // their centroids).
 S2Point GetCentroid(S2PointLoopSpan loop);
 
+// Like GetCentroid(), but accumulates the triangle sum in fixed-size blocks
+// using up to "num_threads" threads and compensated summation (see
+// GetSurfaceIntegralParallel below).  Deterministic for a given loop
+// regardless of the number of threads.
+S2Point GetCentroidParallel(S2PointLoopSpan loop, int num_threads);
+
 // Returns true if the loop area is at most 2*Pi.  (A small amount of error is
 // allowed in order to ensure that loops representing an entire hemisphere are
 // always considered normalized.)
@@ -223,6 +244,23 @@ T GetSurfaceIntegralKahan(S2PointLoopSpan loop,
   return (T)sum;
 }
 
+// Like GetSurfaceIntegralKahan(), but splits the triangle fan into fixed-size
+// blocks, accumulates each block with a compensated sum using up to
+// "num_threads" threads, and combines the block results in block order.
+// Because the blocks do not depend on the number of threads, the result is
+// deterministic for a given loop.
+//
+// The parallel decomposition requires the fan origin to remain at vertex 0,
+// which is guaranteed when every vertex is well-separated from its antipode
+// (see the comments in internal::GetSurfaceIntegral).  Loops that do not
+// satisfy this, and loops too small to benefit, are evaluated serially with
+// GetSurfaceIntegralKahan().
+template <class T>
+T GetSurfaceIntegralParallel(S2PointLoopSpan loop,
+                             T f_tri(const S2Point&, const S2Point&,
+                                     const S2Point&),
+                             int num_threads);
+
 // Returns a new loop obtained by removing all degeneracies from "loop"
 // that can be detected by only comparing adjacent vertices and edges
 // for equality (not doing any geometric examination of them).
@@ -360,6 +398,69 @@ void internal::GetSurfaceIntegral(S2PointLoopSpan loop,
   }
 }
 
+template <class T>
+T GetSurfaceIntegralParallel(S2PointLoopSpan loop,
+                             T f_tri(const S2Point&, const S2Point&,
+                                     const S2Point&),
+                             int num_threads) {
+  // Each block covers kBlockSize triangles of the fan from vertex 0.  The
+  // block size is fixed so that the result does not depend on "num_threads".
+  static constexpr size_t kBlockSize = 8192;
+  if (num_threads <= 1 || loop.size() < 2 * kBlockSize) {
+    return GetSurfaceIntegralKahan(loop, f_tri);
+  }
+  // If any vertex approaches the antipode of vertex 0, the serial algorithm
+  // would move the fan origin and the decomposition is no longer a simple
+  // reduction.  The threshold below is conservative relative to kMaxLength in
+  // internal::GetSurfaceIntegral (cos of about 172 degrees), so the fallback
+  // triggers slightly more often than strictly necessary.
+  static constexpr double kMaxStableDotProd = -0.99;
+
+  const S2Point& origin = loop[0];
+  const size_t num_triangles = loop.size() - 2;
+  const size_t num_blocks = (num_triangles + kBlockSize - 1) / kBlockSize;
+  std::vector<T> block_sums(num_blocks);
+  std::vector<T> block_errs(num_blocks);
+  std::atomic<size_t> next_block{0};
+  std::atomic<bool> unstable{false};
+  const auto worker = [&]() {
+    for (;;) {
+      size_t block = next_block.fetch_add(1, std::memory_order_relaxed);
+      if (block >= num_blocks || unstable.load(std::memory_order_relaxed)) {
+        return;
+      }
+      size_t begin = 1 + block * kBlockSize;
+      size_t end = std::min(begin + kBlockSize, loop.size() - 1);
+      internal::KahanSum<T> sum;
+      for (size_t i = begin; i < end; ++i) {
+        if (loop[i + 1].DotProd(origin) < kMaxStableDotProd) {
+          unstable.store(true, std::memory_order_relaxed);
+          return;
+        }
+        sum += f_tri(origin, loop[i], loop[i + 1]);
+      }
+      block_sums[block] = (T)sum;
+      block_errs[block] = sum.Compensation();
+    }
+  };
+  std::vector<std::thread> threads;
+  const int threads_to_spawn =
+      static_cast<int>(std::min<size_t>(num_threads, num_blocks));
+  threads.reserve(threads_to_spawn);
+  for (int t = 0; t < threads_to_spawn; ++t) threads.emplace_back(worker);
+  for (auto& thread : threads) thread.join();
+  if (unstable.load(std::memory_order_relaxed)) {
+    return GetSurfaceIntegralKahan(loop, f_tri);
+  }
+  // Combine the per-block sums and their compensation terms in block order.
+  internal::KahanSum<T> total;
+  for (size_t b = 0; b < num_blocks; ++b) {
+    total += block_sums[b];
+    total += -block_errs[b];
+  }
+  return (T)total;
+}
+
 }  // namespace S2
 
 #endif  // S2_S2LOOP_MEASURES_H_
@@ -578,3 +578,50 @@ TEST(KahanSum, SumOfSquares) {
 }
 
 }  // namespace
+
+TEST(GetAreaParallel, MatchesSerialComputation) {
+  // A loop large enough to take the blocked parallel path (the block size is
+  // 8192 triangles).
+  vector<S2Point> vertices = S2Testing::MakeRegularPoints(
+      S2Point(1, 2, 3).Normalize(), S1Angle::Degrees(10), 20000);
+  S2PointLoopSpan loop(vertices);
+
+  double serial_area = S2::GetArea(loop);
+  double parallel_area = S2::GetAreaParallel(loop, 4);
+  // The compensated sums are grouped differently, so the results may differ
+  // in the last few bits but must agree to within the serial error bound.
+  EXPECT_NEAR(serial_area, parallel_area, S2::GetCurvatureMaxError(loop));
+
+  // The result must not depend on the number of threads.
+  EXPECT_EQ(parallel_area, S2::GetAreaParallel(loop, 2));
+  EXPECT_EQ(parallel_area, S2::GetAreaParallel(loop, 8));
+
+  S2Point serial_centroid = S2::GetCentroid(loop);
+  S2Point parallel_centroid = S2::GetCentroidParallel(loop, 4);
+  // The serial centroid uses an uncompensated sum, so allow for its
+  // accumulation error over 20000 triangles.
+  EXPECT_LE((serial_centroid - parallel_centroid).Norm(), 1e-11);
+  EXPECT_EQ(parallel_centroid, S2::GetCentroidParallel(loop, 2));
+}
+
+TEST(GetAreaParallel, SmallLoopsUseSerialPath) {
+  // Loops below the blocking threshold are computed serially, so the results
+  // are identical to the serial functions.
+  vector<S2Point> vertices = S2Testing::MakeRegularPoints(
+      S2Point(1, 2, 3).Normalize(), S1Angle::Degrees(10), 100);
+  S2PointLoopSpan loop(vertices);
+  EXPECT_EQ(S2::GetArea(loop), S2::GetAreaParallel(loop, 4));
+  EXPECT_EQ(S2::GetSignedArea(loop), S2::GetSignedAreaParallel(loop, 4));
+  EXPECT_EQ(S2::GetCentroid(loop), S2::GetCentroidParallel(loop, 4));
+}
+
+TEST(GetAreaParallel, NearAntipodalVerticesFallBackToSerial) {
+  // A large loop whose vertices approach the antipode of vertex 0 makes the
+  // triangle fan move its origin, which the parallel decomposition cannot
+  // handle; such loops must fall back to the serial algorithm exactly.
+  vector<S2Point> vertices = S2Testing::MakeRegularPoints(
+      S2Point(1, 2, 3).Normalize(), S1Angle::Degrees(89), 20000);
+  S2PointLoopSpan loop(vertices);
+  EXPECT_EQ(S2::GetArea(loop), S2::GetAreaParallel(loop, 4));
+  EXPECT_EQ(S2::GetCentroid(loop), S2::GetCentroidParallel(loop, 4));
+}
@@ -34,6 +34,7 @@
 #include "absl/flags/flag.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 
 #include "s2/base/casts.h"
@@ -43,6 +44,7 @@
 #include "s2/r1interval.h"
 #include "s2/s1angle.h"
 #include "s2/s1interval.h"
+#include "s2/s2cap.h"
 #include "s2/s2cell.h"
 #include "s2/s2cell_id.h"
 #include "s2/s2debug.h"
@@ -1013,6 +1015,60 @@ static void TestEncodeDecode(const S2Loop& loop) {
   CheckIdentical(loop, loop2);
 }
 
+TEST(S2Loop, ForceBuildIndex) {
+  unique_ptr<S2Loop> loop = S2Loop::MakeRegularLoop(
+      S2Testing::RandomPoint(), S1Angle::Degrees(5), 1000);
+  for (int num_threads : {1, 2}) {
+    SCOPED_TRACE(absl::StrCat("num_threads ", num_threads));
+    unique_ptr<S2Loop> copy(loop->Clone());
+    copy->ForceBuildIndex(num_threads);
+    // Queries served by the prebuilt index match the lazily built one.
+    for (int i = 0; i < 100; ++i) {
+      S2Point p = S2Testing::SamplePoint(
+          S2Cap(loop->vertex(0), S1Angle::Degrees(10)));
+      EXPECT_EQ(loop->Contains(p), copy->Contains(p));
+    }
+    // Calling it again is a no-op.
+    copy->ForceBuildIndex();
+  }
+}
+
+TEST(S2Loop, PrecomputeContainsTables) {
+  unique_ptr<S2Loop> loop = S2Loop::MakeRegularLoop(
+      S2Testing::RandomPoint(), S1Angle::Degrees(5), 1000);
+  for (int max_cells : {1, 8, 256}) {
+    SCOPED_TRACE(absl::StrCat("max_cells ", max_cells));
+    unique_ptr<S2Loop> copy(loop->Clone());
+    copy->PrecomputeContainsTables(max_cells);
+    // Accelerated queries match the exact containment test, both for points
+    // near the boundary and for points well inside or outside the loop.
+    for (int i = 0; i < 1000; ++i) {
+      S2Point p = S2Testing::SamplePoint(
+          S2Cap(loop->vertex(0), S1Angle::Degrees(10)));
+      EXPECT_EQ(loop->Contains(p), copy->Contains(p));
+    }
+    // The tables survive cloning and are cleared by Invert().
+    unique_ptr<S2Loop> inverted(copy->Clone());
+    inverted->Invert();
+    for (int i = 0; i < 100; ++i) {
+      S2Point p = S2Testing::RandomPoint();
+      EXPECT_EQ(!loop->Contains(p), inverted->Contains(p));
+    }
+  }
+}
+
+TEST(S2Loop, PrecomputeContainsTablesEmptyAndFull) {
+  S2Loop empty(S2Loop::kEmpty());
+  empty.PrecomputeContainsTables();
+  S2Loop full(S2Loop::kFull());
+  full.PrecomputeContainsTables();
+  for (int i = 0; i < 100; ++i) {
+    S2Point p = S2Testing::RandomPoint();
+    EXPECT_FALSE(empty.Contains(p));
+    EXPECT_TRUE(full.Contains(p));
+  }
+}
+
 TEST(S2Loop, EncodeDecode) {
   unique_ptr<S2Loop> l(MakeLoopOrDie("30:20, 40:20, 39:43, 33:35"));
   l->set_depth(3);
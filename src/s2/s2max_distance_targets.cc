@@ -192,12 +192,23 @@ bool S2MaxDistanceShapeIndexTarget::set_max_error(
   return true;  // Indicates that we may return suboptimal results.
 }
 
+void S2MaxDistanceShapeIndexTarget::ReInit() {
+  query_->ReInit();
+  cap_bound_valid_ = false;
+}
+
 // This method returns an S2Cap that bounds the antipode of the target.  (This
 // is the set of points whose S2MaxDistance to the target is
 // S2MaxDistance::Zero().)
 S2Cap S2MaxDistanceShapeIndexTarget::GetCapBound() {
-  S2Cap cap = MakeS2ShapeIndexRegion(index_).GetCapBound();
-  return S2Cap(-cap.center(), cap.radius());
+  // Computing the cap bound traverses the entire index, so the result is
+  // cached for reuse across queries against the same target.
+  if (!cap_bound_valid_) {
+    S2Cap cap = MakeS2ShapeIndexRegion(index_).GetCapBound();
+    cap_bound_ = S2Cap(-cap.center(), cap.radius());
+    cap_bound_valid_ = true;
+  }
+  return cap_bound_;
 }
 
 bool S2MaxDistanceShapeIndexTarget::UpdateMinDistance(
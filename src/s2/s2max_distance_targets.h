@@ -178,6 +178,15 @@ class S2MaxDistanceShapeIndexTarget : public S2MaxDistanceTarget {
   void set_use_brute_force(bool use_brute_force);
 
   bool set_max_error(const S1ChordAngle& max_error) override;
+
+  // Repeated UpdateMinDistance() calls reuse the traversal state of the
+  // internal S2FurthestEdgeQuery (its priority queue, iterator, and cached
+  // index covering), as does the cap bound below, so reusing one target
+  // object is significantly faster than constructing a new target per call.
+  // This method resets all such cached state; it must be called whenever the
+  // underlying index is modified.
+  void ReInit();
+
   S2Cap GetCapBound() final;
   bool UpdateMinDistance(const S2Point& p, S2MaxDistance* min_dist) final;
   bool UpdateMinDistance(const S2Point& v0, const S2Point& v1,
@@ -192,6 +201,11 @@ class S2MaxDistanceShapeIndexTarget : public S2MaxDistanceTarget {
  private:
   const S2ShapeIndex* index_;
   std::unique_ptr<S2FurthestEdgeQuery> query_;
+
+  // Cached result of GetCapBound(), which requires a full traversal of the
+  // index to compute (see ReInit).
+  S2Cap cap_bound_;
+  bool cap_bound_valid_ = false;
 };
 
 
@@ -231,6 +231,27 @@ TEST(CellTarget, UpdateMaxDistanceToCellWhenEqual) {
   EXPECT_FALSE(target.UpdateMinDistance(cell, &dist));
 }
 
+TEST(ShapeIndexTarget, ReInitAfterIndexChange) {
+  MutableS2ShapeIndex target_index;
+  target_index.Add(make_unique<S2PointVectorShape>(
+      vector<S2Point>{MakePointOrDie("1:0")}));
+  S2MaxDistanceShapeIndexTarget target(&target_index);
+  // The cap bound is cached after first use.
+  S2Cap cap = target.GetCapBound();
+  EXPECT_EQ(cap, target.GetCapBound());
+  S2MaxDistance dist = S2MaxDistance::Infinity();
+  EXPECT_TRUE(target.UpdateMinDistance(MakePointOrDie("0:0"), &dist));
+
+  // After modifying the index, ReInit() discards the cached state.
+  target_index.Add(make_unique<S2PointVectorShape>(
+      vector<S2Point>{MakePointOrDie("-20:0")}));
+  target.ReInit();
+  EXPECT_NE(cap, target.GetCapBound());
+  dist = S2MaxDistance::Infinity();
+  EXPECT_TRUE(target.UpdateMinDistance(MakePointOrDie("20:0"), &dist));
+  EXPECT_GT(S1ChordAngle(dist), S1ChordAngle::Degrees(39));
+}
+
 TEST(ShapeIndexTarget, UpdateMaxDistanceToEdgeWhenEqual) {
   auto target_index = MakeIndexOrDie("1:0 # #");
   S2MaxDistanceShapeIndexTarget target(target_index.get());
@@ -17,7 +17,9 @@
 
 #include "s2/s2memory_tracker.h"
 
+#include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "s2/base/types.h"
 #include "s2/s2error.h"
@@ -26,6 +28,19 @@ void S2MemoryTracker::SetError(S2Error error) {
   error_ = std::move(error);
 }
 
+// Not inline in order to avoid code bloat.
+void S2MemoryTracker::HandleLimitExceeded() {
+  // Give the limit-exceeded callback (if any) a chance to grant additional
+  // budget before cancelling the operation.  The loop allows the callback to
+  // meter out budget in increments smaller than the current overshoot.
+  while (limit_callback_ && usage_bytes_ > limit_bytes_) {
+    int64 granted_bytes = limit_callback_(usage_bytes_, limit_bytes_);
+    if (granted_bytes <= 0) break;
+    limit_bytes_ += granted_bytes;
+  }
+  if (usage_bytes_ > limit_bytes_) SetLimitExceededError();
+}
+
 // Not inline in order to avoid code bloat.
 void S2MemoryTracker::SetLimitExceededError() {
   error_.Init(S2Error::RESOURCE_EXHAUSTED,
@@ -33,6 +48,42 @@ void S2MemoryTracker::SetLimitExceededError() {
               usage_bytes_, limit_bytes_);
 }
 
+void S2MemoryTracker::RegisterClient(Client* client) {
+  clients_.push_back(client);
+}
+
+void S2MemoryTracker::UnregisterClient(Client* client) {
+  clients_.erase(std::remove(clients_.begin(), clients_.end(), client),
+                 clients_.end());
+}
+
+std::vector<S2MemoryTracker::TaggedUsage> S2MemoryTracker::GetTaggedUsage()
+    const {
+  // There are typically only a handful of clients, so aggregating with a
+  // linear scan is cheaper than building a hash map.
+  std::vector<TaggedUsage> result;
+  for (const Client* client : clients_) {
+    auto it = std::find_if(result.begin(), result.end(),
+                           [client](const TaggedUsage& entry) {
+                             return entry.tag == client->tag();
+                           });
+    if (it == result.end()) {
+      result.push_back({client->tag(), client->client_usage_bytes()});
+    } else {
+      it->usage_bytes += client->client_usage_bytes();
+    }
+  }
+  return result;
+}
+
+// Not inline in order to avoid code bloat.
+void S2MemoryTracker::Client::HandleLimitExceeded() {
+  tracker_->SetError(S2Error::RESOURCE_EXHAUSTED,
+                     "Memory limit exceeded for client \"%s\" "
+                     "(tracked usage %d bytes, limit %d bytes)",
+                     tag_, client_usage_bytes_, limit_bytes_);
+}
+
 bool S2MemoryTracker::Client::TallyTemp(int64 delta_bytes) {
   Tally(delta_bytes);
   return Tally(-delta_bytes);
@@ -22,11 +22,14 @@
 #include <cstdint>
 #include <functional>
 #include <limits>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
 #include "s2/s2error.h"
 #include "s2/util/gtl/compact_array.h"
 
@@ -39,6 +42,11 @@
 //  - Supports cancelling the current operation if a given memory limit would
 //    otherwise be exceeded.
 //
+//  - Attributes memory usage to named clients (e.g. "S2Builder" vs.
+//    "MutableS2ShapeIndex") and provides a cheap snapshot of the usage
+//    broken down by client tag (see GetTaggedUsage).  Individual clients
+//    may also be given their own memory limits.
+//
 //  - Invokes an optional callback after every N bytes of memory allocation,
 //    and periodically within certain calculations that might take a long
 //    time.  This gives the client an opportunity to cancel the current
@@ -128,6 +136,30 @@ class S2MemoryTracker {
   // Indicates that memory usage is unlimited.
   static constexpr int64 kNoLimit = std::numeric_limits<int64>::max();
 
+  // A function that is called when the tracked memory usage would exceed
+  // limit_bytes().  It returns the number of additional bytes of budget
+  // granted; the limit is raised by that amount and the operation continues.
+  // Returning 0 (or a value too small to cover the overshoot) declines the
+  // request and the operation is cancelled with RESOURCE_EXHAUSTED as usual.
+  //
+  // This allows giant one-off operations to complete (possibly slowly, e.g.
+  // relying on OS paging once the process exceeds physical memory) instead of
+  // failing and being re-run with smaller inputs.  The callback is invoked
+  // again whenever the raised limit is exceeded, so it can meter out budget
+  // incrementally and log or alert as the overdraft grows.
+  using LimitExceededCallback =
+      std::function<int64 (int64 usage_bytes, int64 limit_bytes)>;
+
+  // Sets the function called when the memory limit would be exceeded.
+  //
+  // DEFAULT: nullptr (the operation is cancelled, as described above)
+  void set_limit_exceeded_callback(LimitExceededCallback callback) {
+    limit_callback_ = std::move(callback);
+  }
+  const LimitExceededCallback& limit_exceeded_callback() const {
+    return limit_callback_;
+  }
+
   // Returns the tracker's current error status.  Whenever an error exists
   // the current S2 operation will be cancelled.
   const S2Error& error() const { return error_; }
@@ -174,6 +206,23 @@ class S2MemoryTracker {
   }
   const PeriodicCallback& periodic_callback() const { return callback_; }
 
+  // One entry of a memory usage snapshot: the total tracked usage of all
+  // active clients that share a tag (see Client::Init below).  Clients that
+  // were not given a tag are aggregated under the empty string.
+  struct TaggedUsage {
+    std::string tag;
+    int64 usage_bytes;
+  };
+
+  // Returns a snapshot of the current tracked memory usage broken down by
+  // client tag.  The cost is linear in the number of active clients (which
+  // is typically a handful), so this method is cheap enough to be called
+  // from production monitoring code.
+  //
+  // CAVEAT: As with usage_bytes(), the values reported after an operation
+  // has been cancelled may be wildly inaccurate.
+  std::vector<TaggedUsage> GetTaggedUsage() const;
+
   // Resets usage() and max_usage() to zero and clears any error.  Leaves all
   // other parameters unchanged.
   void Reset() {
@@ -216,10 +265,13 @@ class S2MemoryTracker {
     // Init(), but in that case memory usage is not tracked.
     Client() = default;
 
-    // Convenience constructor that calls Init().
+    // Convenience constructors that call the corresponding Init() method.
     explicit Client(S2MemoryTracker* tracker) {
       Init(tracker);
     }
+    Client(S2MemoryTracker* tracker, absl::string_view tag) {
+      Init(tracker, tag);
+    }
 
     // Initializes this client to use the given memory tracker.  This function
     // may be called more than once (which is equivalent to destroying this
@@ -227,10 +279,44 @@ class S2MemoryTracker {
     void Init(S2MemoryTracker* tracker) {
       int64 usage_bytes = client_usage_bytes_;
       Tally(-usage_bytes);
-      tracker_ = tracker;
+      if (tracker_ != tracker) {
+        if (tracker_) tracker_->UnregisterClient(this);
+        tracker_ = tracker;
+        if (tracker_) tracker_->RegisterClient(this);
+      }
       Tally(usage_bytes);
     }
 
+    // Like Init() above, but additionally labels this client with "tag".
+    // The tag is used to attribute memory usage in snapshots; see
+    // S2MemoryTracker::GetTaggedUsage().  Tags need not be unique; the usage
+    // of all clients sharing a tag is aggregated.
+    void Init(S2MemoryTracker* tracker, absl::string_view tag) {
+      Init(tracker);
+      set_tag(tag);
+    }
+
+    // The tag used to attribute this client's memory usage in snapshots.
+    //
+    // DEFAULT: "" (the empty string)
+    const std::string& tag() const { return tag_; }
+    void set_tag(absl::string_view tag) {
+      tag_.assign(tag.data(), tag.size());
+    }
+
+    // Specifies a limit on the memory tracked by this client alone, in
+    // addition to any limit on the S2MemoryTracker as a whole.  This makes
+    // it possible to give individual stages or structures of an operation
+    // their own budgets.  Whenever this client's tracked usage would exceed
+    // the given value, an error of type S2Error::RESOURCE_EXHAUSTED is
+    // generated just as for the tracker-wide limit.  (Note that the
+    // tracker's limit-exceeded callback is not consulted for per-client
+    // limits.)
+    //
+    // DEFAULT: kNoLimit
+    int64 limit_bytes() const { return limit_bytes_; }
+    void set_limit_bytes(int64 limit_bytes) { limit_bytes_ = limit_bytes; }
+
     // Returns the memory tracker associated with this client object.
     S2MemoryTracker* tracker() const { return tracker_; }
 
@@ -240,7 +326,10 @@ class S2MemoryTracker {
     // When a Client object is destroyed, any remaining memory is subtracted
     // from the associated S2MemoryTracker (under the assumption that the
     // associated S2 operation has been destroyed as well).
-    ~Client() { Tally(-client_usage_bytes_); }
+    ~Client() {
+      Tally(-client_usage_bytes_);
+      if (tracker_) tracker_->UnregisterClient(this);
+    }
 
     // Returns the current tracked memory usage.
     // XXX(ericv): Return 0 when not active.
@@ -264,6 +353,7 @@ class S2MemoryTracker {
     bool Tally(int64 delta_bytes) {
       if (!is_active()) return true;
       client_usage_bytes_ += delta_bytes;
+      if (client_usage_bytes_ > limit_bytes_ && ok()) HandleLimitExceeded();
       return tracker_->Tally(delta_bytes);
     }
 
@@ -333,15 +423,22 @@ class S2MemoryTracker {
     static int64 GetBtreeMinBytesPerEntry();
 
    private:
+    void HandleLimitExceeded();
+
     S2MemoryTracker* tracker_ = nullptr;
     int64 client_usage_bytes_ = 0;
+    int64 limit_bytes_ = kNoLimit;
+    std::string tag_;
   };
 
  private:
   friend class Client;
 
   bool Tally(int64 delta_bytes);
+  void HandleLimitExceeded();
   void SetLimitExceededError();
+  void RegisterClient(Client* client);
+  void UnregisterClient(Client* client);
 
   int64 usage_bytes_ = 0;
   int64 max_usage_bytes_ = 0;
@@ -349,8 +446,13 @@ class S2MemoryTracker {
   int64 alloc_bytes_ = 0;
   S2Error error_;
   PeriodicCallback callback_;
+  LimitExceededCallback limit_callback_;
   int64 callback_alloc_delta_bytes_ = 0;
   int64 callback_alloc_limit_bytes_ = kNoLimit;
+
+  // The active clients of this tracker, used to attribute memory usage by
+  // tag (see GetTaggedUsage).  Maintained by Client::Init() and ~Client().
+  std::vector<Client*> clients_;
 };
 
 
@@ -367,7 +469,7 @@ inline bool S2MemoryTracker::Tally(int64 delta_bytes) {
   usage_bytes_ += delta_bytes;
   alloc_bytes_ += std::max(int64{0}, delta_bytes);
   max_usage_bytes_ = std::max(max_usage_bytes_, usage_bytes_);
-  if (usage_bytes_ > limit_bytes_ && ok()) SetLimitExceededError();
+  if (usage_bytes_ > limit_bytes_ && ok()) HandleLimitExceeded();
   if (callback_ && alloc_bytes_ >= callback_alloc_limit_bytes_) {
     callback_alloc_limit_bytes_ = alloc_bytes_ + callback_alloc_delta_bytes_;
     if (ok()) callback_();
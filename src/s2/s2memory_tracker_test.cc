@@ -48,3 +48,84 @@ TEST(S2MemoryTracker, PeriodicCallback) {
   client.Tally(1);
   EXPECT_EQ(callback_count, 4);
 }
+
+TEST(S2MemoryTracker, LimitExceededCallback) {
+  S2MemoryTracker tracker;
+  tracker.set_limit_bytes(100);
+  S2MemoryTracker::Client client(&tracker);
+
+  // The callback can grant additional budget instead of cancelling.
+  int callback_count = 0;
+  tracker.set_limit_exceeded_callback([&](int64 usage_bytes,
+                                          int64 limit_bytes) -> int64 {
+    ++callback_count;
+    EXPECT_GT(usage_bytes, limit_bytes);
+    return 50;
+  });
+  EXPECT_TRUE(client.Tally(120));
+  EXPECT_EQ(callback_count, 1);
+  EXPECT_EQ(tracker.limit_bytes(), 150);
+  EXPECT_TRUE(tracker.ok());
+
+  // Budget may be metered out in increments smaller than the overshoot, in
+  // which case the callback is invoked repeatedly within a single tally.
+  EXPECT_TRUE(client.Tally(130));  // Usage 250, limit 150.
+  EXPECT_EQ(callback_count, 3);
+  EXPECT_EQ(tracker.limit_bytes(), 250);
+
+  // Declining the request cancels the operation as usual.
+  tracker.set_limit_exceeded_callback([](int64, int64) -> int64 { return 0; });
+  EXPECT_FALSE(client.Tally(10));
+  EXPECT_EQ(tracker.error().code(), S2Error::RESOURCE_EXHAUSTED);
+}
+
+TEST(S2MemoryTracker, GetTaggedUsage) {
+  S2MemoryTracker tracker;
+  S2MemoryTracker::Client builder(&tracker, "S2Builder");
+  S2MemoryTracker::Client index(&tracker, "MutableS2ShapeIndex");
+  builder.Tally(100);
+  index.Tally(50);
+
+  // Usage is attributed by tag, and clients sharing a tag are aggregated.
+  {
+    S2MemoryTracker::Client builder2(&tracker, "S2Builder");
+    builder2.Tally(25);
+    auto snapshot = tracker.GetTaggedUsage();
+    ASSERT_EQ(snapshot.size(), 2);
+    int64 builder_bytes = 0, index_bytes = 0;
+    for (const auto& entry : snapshot) {
+      if (entry.tag == "S2Builder") builder_bytes = entry.usage_bytes;
+      if (entry.tag == "MutableS2ShapeIndex") index_bytes = entry.usage_bytes;
+    }
+    EXPECT_EQ(builder_bytes, 125);
+    EXPECT_EQ(index_bytes, 50);
+  }
+
+  // Destroyed clients no longer appear in the snapshot.
+  auto snapshot = tracker.GetTaggedUsage();
+  ASSERT_EQ(snapshot.size(), 2);
+  EXPECT_EQ(tracker.usage_bytes(), 150);
+
+  // Untagged clients are aggregated under the empty string.
+  S2MemoryTracker::Client untagged(&tracker);
+  untagged.Tally(10);
+  snapshot = tracker.GetTaggedUsage();
+  ASSERT_EQ(snapshot.size(), 3);
+  for (const auto& entry : snapshot) {
+    if (entry.tag.empty()) EXPECT_EQ(entry.usage_bytes, 10);
+  }
+}
+
+TEST(S2MemoryTracker, ClientLimitBytes) {
+  // Per-client limits generate an error even when the tracker-wide limit is
+  // not exceeded, and the error message identifies the client by tag.
+  S2MemoryTracker tracker;
+  S2MemoryTracker::Client sites(&tracker, "sites");
+  S2MemoryTracker::Client edges(&tracker, "input_edges");
+  sites.set_limit_bytes(100);
+  EXPECT_TRUE(edges.Tally(500));
+  EXPECT_TRUE(sites.Tally(100));
+  EXPECT_FALSE(sites.Tally(1));
+  EXPECT_EQ(tracker.error().code(), S2Error::RESOURCE_EXHAUSTED);
+  EXPECT_NE(tracker.error().text().find("sites"), std::string::npos);
+}
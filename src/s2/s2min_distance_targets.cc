@@ -17,8 +17,10 @@
 
 #include "s2/s2min_distance_targets.h"
 
+#include <cfloat>
 #include <cmath>
 
+#include <array>
 #include <memory>
 #include <utility>
 
@@ -34,6 +36,7 @@
 #include "s2/s2contains_point_query.h"
 #include "s2/s2distance_target.h"
 #include "s2/s2edge_distances.h"
+#include "s2/s2metrics.h"
 #include "s2/s2point.h"
 #include "s2/s2shape.h"
 #include "s2/s2shape_index.h"
@@ -104,8 +107,30 @@ bool S2MinDistanceEdgeTarget::VisitContainingShapeIds(
   return target.VisitContainingShapeIds(index, visitor);
 }
 
+namespace {
+
+// A conservative upper bound on the angular distance from the center of a
+// cell at the given level to any point of that cell.  The bound is padded
+// slightly (matching S2CellIdSnapFunction::MinSnapRadiusForLevel) so that it
+// remains valid despite rounding in the chord angle arithmetic below.
+S1ChordAngle MaxCircumradius(int level) {
+  static const std::array<S1ChordAngle, S2CellId::kMaxLevel + 1> kRadius = [] {
+    std::array<S1ChordAngle, S2CellId::kMaxLevel + 1> radius;
+    for (int level = 0; level <= S2CellId::kMaxLevel; ++level) {
+      radius[level] = S1ChordAngle::Radians(
+          0.5 * S2::kMaxDiag.GetValue(level) + 4 * DBL_EPSILON);
+    }
+    return radius;
+  }();
+  return kRadius[level];
+}
+
+}  // namespace
+
 S2MinDistanceCellTarget::S2MinDistanceCellTarget(const S2Cell& cell)
-    : cell_(cell) {
+    : cell_(cell),
+      center_(cell.GetCenter()),
+      radius_(MaxCircumradius(cell.level())) {
 }
 
 S2Cap S2MinDistanceCellTarget::GetCapBound() {
@@ -124,6 +149,16 @@ bool S2MinDistanceCellTarget::UpdateMinDistance(
 
 bool S2MinDistanceCellTarget::UpdateMinDistance(
     const S2Cell& cell, S2MinDistance* min_dist) {
+  // Cheap conservative pre-filter: by the triangle inequality the distance
+  // between two cells is at least the distance between their centers minus
+  // both circumradii.  Candidates that cannot possibly improve "min_dist"
+  // are rejected without computing the exact cell-to-cell distance, which
+  // compares every vertex and edge pair and is far more expensive.
+  S1ChordAngle center_dist(center_, cell.GetCenter());
+  center_dist =
+      center_dist.PlusError(-center_dist.GetS2PointConstructorMaxError());
+  S1ChordAngle bound = center_dist - radius_ - MaxCircumradius(cell.level());
+  if (bound >= *min_dist) return false;
   return min_dist->UpdateMin(S2MinDistance(cell_.GetDistance(cell)));
 }
 
@@ -244,8 +279,19 @@ bool S2MinDistanceShapeIndexTarget::set_max_error(
   return true;  // Indicates that we may return suboptimal results.
 }
 
+void S2MinDistanceShapeIndexTarget::ReInit() {
+  query_->ReInit();
+  cap_bound_valid_ = false;
+}
+
 S2Cap S2MinDistanceShapeIndexTarget::GetCapBound() {
-  return MakeS2ShapeIndexRegion(index_).GetCapBound();
+  // Computing the cap bound traverses the entire index, so the result is
+  // cached for reuse across queries against the same target.
+  if (!cap_bound_valid_) {
+    cap_bound_ = MakeS2ShapeIndexRegion(index_).GetCapBound();
+    cap_bound_valid_ = true;
+  }
+  return cap_bound_;
 }
 
 inline bool S2MinDistanceShapeIndexTarget::UpdateMinDistance(
@@ -126,6 +126,10 @@ class S2MinDistanceCellTarget : public S2MinDistanceTarget {
 
  private:
   S2Cell cell_;
+  // The center of "cell_" and a conservative bound on its circumradius,
+  // used by UpdateMinDistance(S2Cell) to reject faraway candidates cheaply.
+  S2Point center_;
+  S1ChordAngle radius_;
 };
 
 // An S2DistanceTarget subtype for computing the minimum distance to an
@@ -221,6 +225,14 @@ class S2MinDistanceShapeIndexTarget : public S2MinDistanceTarget {
   // used internally by the S2Closest*Query implementations.
   bool set_max_error(const S1ChordAngle& max_error) override;
 
+  // Repeated UpdateMinDistance() calls reuse the traversal state of the
+  // internal S2ClosestEdgeQuery (its priority queue, iterator, and cached
+  // index covering), as does the cap bound below, so reusing one target
+  // object is significantly faster than constructing a new target per call.
+  // This method resets all such cached state; it must be called whenever the
+  // underlying index is modified.
+  void ReInit();
+
   S2Cap GetCapBound() final;
   bool UpdateMinDistance(const S2Point& p, S2MinDistance* min_dist) final;
   bool UpdateMinDistance(const S2Point& v0, const S2Point& v1,
@@ -236,6 +248,11 @@ class S2MinDistanceShapeIndexTarget : public S2MinDistanceTarget {
 
   const S2ShapeIndex* index_;
   std::unique_ptr<S2ClosestEdgeQuery> query_;
+
+  // Cached result of GetCapBound(), which requires a full traversal of the
+  // index to compute (see ReInit).
+  S2Cap cap_bound_;
+  bool cap_bound_valid_ = false;
 };
 
 
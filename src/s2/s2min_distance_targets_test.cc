@@ -25,14 +25,18 @@
 #include "s2/base/types.h"
 #include <gtest/gtest.h>
 #include "absl/container/btree_set.h"
+#include "absl/flags/flag.h"
 #include "s2/mutable_s2shape_index.h"
 #include "s2/s1chord_angle.h"
+#include "s2/s2cap.h"
 #include "s2/s2cell.h"
 #include "s2/s2cell_id.h"
 #include "s2/s2cell_union.h"
+#include "s2/s2lax_polyline_shape.h"
 #include "s2/s2point.h"
 #include "s2/s2shape.h"
 #include "s2/s2shape_index.h"
+#include "s2/s2testing.h"
 #include "s2/s2text_format.h"
 
 using s2textformat::MakeIndexOrDie;
@@ -96,6 +100,36 @@ TEST(CellTarget, UpdateMinDistanceToCellWhenEqual) {
   EXPECT_FALSE(target.UpdateMinDistance(cell, &dist));
 }
 
+TEST(CellTarget, UpdateMinDistanceToCellMatchesExactDistance) {
+  // UpdateMinDistance(S2Cell, ...) uses a conservative center/circumradius
+  // pre-filter to reject faraway candidates cheaply; verify that the filter
+  // never changes the result compared to the exact distance computation.
+  S2Testing::rnd.Reset(absl::GetFlag(FLAGS_s2_random_seed));
+  for (int iter = 0; iter < 50; ++iter) {
+    S2CellId target_id = S2Testing::GetRandomCellId();
+    S2Cell target_cell(target_id);
+    S2MinDistanceCellTarget target(target_cell);
+    S2MinDistance dist(S1ChordAngle::Infinity());
+    S2MinDistance exact_dist(S1ChordAngle::Infinity());
+    // Mix faraway candidates with the target cell's own neighborhood so
+    // that both the rejected and the exact code paths are exercised.
+    vector<S2CellId> candidates;
+    for (int i = 0; i < 50; ++i) {
+      candidates.push_back(S2Testing::GetRandomCellId());
+    }
+    candidates.push_back(target_id);
+    if (!target_id.is_face()) candidates.push_back(target_id.parent());
+    if (!target_id.is_leaf()) candidates.push_back(target_id.child_begin());
+    for (S2CellId id : candidates) {
+      S2Cell cell(id);
+      bool exact_updated =
+          exact_dist.UpdateMin(S2MinDistance(target_cell.GetDistance(cell)));
+      EXPECT_EQ(exact_updated, target.UpdateMinDistance(cell, &dist));
+      EXPECT_EQ(exact_dist, dist);
+    }
+  }
+}
+
 TEST(CellUnionTarget, MinDistanceUseBruteForce) {
   // Provide some test coverage so this isn't marked as dead code.
   S2MinDistanceCellUnionTarget target{(S2CellUnion())};
@@ -131,6 +165,27 @@ TEST(ShapeIndexTarget, MinDistanceUseBruteForce) {
   EXPECT_TRUE(target.use_brute_force());
 }
 
+TEST(ShapeIndexTarget, ReInitAfterIndexChange) {
+  MutableS2ShapeIndex target_index;
+  target_index.Add(s2textformat::MakeLaxPolylineOrDie("1:0, 1:1"));
+  S2MinDistanceShapeIndexTarget target(&target_index);
+  // The cap bound is cached after first use.
+  S2Cap cap = target.GetCapBound();
+  EXPECT_EQ(cap, target.GetCapBound());
+  S2MinDistance dist(S1ChordAngle::Infinity());
+  EXPECT_TRUE(target.UpdateMinDistance(MakePointOrDie("0:0"), &dist));
+
+  // After modifying the index, ReInit() discards the cached state.
+  target_index.Add(s2textformat::MakeLaxPolylineOrDie("-20:0, -20:1"));
+  target.ReInit();
+  S2Cap new_cap = target.GetCapBound();
+  EXPECT_NE(cap, new_cap);
+  EXPECT_TRUE(new_cap.Contains(MakePointOrDie("-20:0")));
+  dist = S2MinDistance(S1ChordAngle::Infinity());
+  EXPECT_TRUE(target.UpdateMinDistance(MakePointOrDie("-21:0"), &dist));
+  EXPECT_LT(S1ChordAngle(dist), S1ChordAngle::Degrees(2));
+}
+
 TEST(ShapeIndexTarget, UpdateMinDistanceToEdgeWhenEqual) {
   auto target_index = MakeIndexOrDie("1:0 # #");
   S2MinDistanceShapeIndexTarget target(target_index.get());
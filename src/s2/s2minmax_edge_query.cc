@@ -0,0 +1,64 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2minmax_edge_query.h"
+
+#include "s2/s1chord_angle.h"
+#include "s2/s2cell.h"
+#include "s2/s2edge_distances.h"
+#include "s2/s2point.h"
+#include "s2/s2shape.h"
+#include "s2/s2shape_index.h"
+
+S2MinMaxEdgeQuery::S2MinMaxEdgeQuery(const S2ShapeIndex* index) {
+  Init(index);
+}
+
+void S2MinMaxEdgeQuery::Init(const S2ShapeIndex* index) {
+  index_ = index;
+}
+
+S2MinMaxEdgeQuery::DistanceBounds S2MinMaxEdgeQuery::GetDistanceBounds(
+    const S2Point& target) const {
+  DistanceBounds bounds;
+  for (S2ShapeIndex::Iterator it(index_, S2ShapeIndex::BEGIN); !it.done();
+       it.Next()) {
+    // Skip any cell whose distance range cannot improve either bound.  Note
+    // that every edge clipped to this cell intersects it, so the cell's
+    // distance range contains the distance range of each such edge.
+    const S2Cell cell(it.id());
+    if (cell.GetDistance(target) >= bounds.min_distance &&
+        cell.GetMaxDistance(target) <= bounds.max_distance) {
+      continue;
+    }
+    const S2ShapeIndexCell& index_cell = it.cell();
+    for (int s = 0; s < index_cell.num_clipped(); ++s) {
+      const S2ClippedShape& clipped = index_cell.clipped(s);
+      const S2Shape* shape = index_->shape(clipped.shape_id());
+      if (shape == nullptr) continue;
+      for (int j = 0; j < clipped.num_edges(); ++j) {
+        // Each edge is visited once per cell it intersects; recomputing the
+        // occasional duplicate is cheaper than deduplicating.  Both bounds
+        // are updated from a single decoded edge.
+        const S2Shape::Edge edge = shape->edge(clipped.edge(j));
+        S2::UpdateMinDistance(target, edge.v0, edge.v1,
+                              &bounds.min_distance);
+        S2::UpdateMaxDistance(target, edge.v0, edge.v1,
+                              &bounds.max_distance);
+      }
+    }
+  }
+  return bounds;
+}
@@ -0,0 +1,67 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef S2_S2MINMAX_EDGE_QUERY_H_
+#define S2_S2MINMAX_EDGE_QUERY_H_
+
+#include "s2/s1chord_angle.h"
+#include "s2/s2point.h"
+#include "s2/s2shape_index.h"
+
+// S2MinMaxEdgeQuery computes both the minimum and the maximum distance from
+// a query point to the edges of an S2ShapeIndex in a single pass over the
+// index.  This is useful when both bounds are needed at once (e.g. radius
+// culling, where geometry is kept only if its distance range overlaps an
+// annulus): running S2ClosestEdgeQuery plus S2FurthestEdgeQuery traverses
+// the index twice and decodes each cell twice, whereas this query visits
+// each index cell once and skips cells whose distance bounds can improve
+// neither result.
+//
+// Only distances to edges are considered; unlike S2ClosestEdgeQuery there is
+// no include_interiors option, so a point inside a polygon reports the
+// distance to the polygon's boundary rather than zero.
+//
+// This class is not thread-safe, but it is cheap to construct one per
+// thread.
+class S2MinMaxEdgeQuery {
+ public:
+  // Holds the two distance bounds computed by GetDistanceBounds().  For an
+  // index containing no edges, min_distance is S1ChordAngle::Infinity() and
+  // max_distance is S1ChordAngle::Negative(), mirroring the conventions of
+  // S2ClosestEdgeQuery and S2FurthestEdgeQuery for empty results.
+  struct DistanceBounds {
+    S1ChordAngle min_distance = S1ChordAngle::Infinity();
+    S1ChordAngle max_distance = S1ChordAngle::Negative();
+  };
+
+  // Convenience constructor that calls Init().
+  explicit S2MinMaxEdgeQuery(const S2ShapeIndex* index);
+
+  // Default constructor; requires Init() to be called.
+  S2MinMaxEdgeQuery() = default;
+
+  // Initializes the query.
+  // REQUIRES: "index" must persist for the lifetime of this object.
+  void Init(const S2ShapeIndex* index);
+
+  // Returns the minimum and maximum distance from "target" to the edges of
+  // the index.
+  DistanceBounds GetDistanceBounds(const S2Point& target) const;
+
+ private:
+  const S2ShapeIndex* index_ = nullptr;
+};
+
+#endif  // S2_S2MINMAX_EDGE_QUERY_H_
@@ -0,0 +1,63 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2minmax_edge_query.h"
+
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "s2/mutable_s2shape_index.h"
+#include "s2/s1chord_angle.h"
+#include "s2/s2closest_edge_query.h"
+#include "s2/s2furthest_edge_query.h"
+#include "s2/s2point.h"
+#include "s2/s2shape_index.h"
+#include "s2/s2testing.h"
+#include "s2/s2text_format.h"
+
+namespace {
+
+TEST(S2MinMaxEdgeQuery, EmptyIndex) {
+  auto index = s2textformat::MakeIndexOrDie("# #");
+  S2MinMaxEdgeQuery query(index.get());
+  const auto bounds = query.GetDistanceBounds(S2Testing::RandomPoint());
+  EXPECT_EQ(bounds.min_distance, S1ChordAngle::Infinity());
+  EXPECT_EQ(bounds.max_distance, S1ChordAngle::Negative());
+}
+
+TEST(S2MinMaxEdgeQuery, MatchesClosestAndFurthestQueries) {
+  auto index = s2textformat::MakeIndexOrDie(
+      "1:1 | 3:4 # 0:0, 0:5, 3:5 | 7:7, 8:8 # 10:10, 10:12, 12:12");
+  S2MinMaxEdgeQuery query(index.get());
+
+  S2ClosestEdgeQuery closest_query(index.get());
+  closest_query.mutable_options()->set_include_interiors(false);
+  S2FurthestEdgeQuery furthest_query(index.get());
+  furthest_query.mutable_options()->set_include_interiors(false);
+
+  for (int iter = 0; iter < 100; ++iter) {
+    const S2Point target = S2Testing::RandomPoint();
+    const auto bounds = query.GetDistanceBounds(target);
+    S2ClosestEdgeQuery::PointTarget closest_target(target);
+    S2FurthestEdgeQuery::PointTarget furthest_target(target);
+    EXPECT_EQ(bounds.min_distance,
+              closest_query.GetDistance(&closest_target));
+    EXPECT_EQ(bounds.max_distance,
+              furthest_query.GetDistance(&furthest_target));
+  }
+}
+
+}  // namespace
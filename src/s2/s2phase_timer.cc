@@ -0,0 +1,46 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2phase_timer.h"
+
+#include <atomic>
+
+#include "absl/strings/string_view.h"
+
+namespace s2internal {
+
+std::atomic<S2PhaseCallback> g_phase_callback{nullptr};
+
+}  // namespace s2internal
+
+absl::string_view S2PhaseName(S2Phase phase) {
+  switch (phase) {
+    case S2Phase::kIndexApplyUpdates:
+      return "index_apply_updates";
+    case S2Phase::kIndexEncode:
+      return "index_encode";
+    case S2Phase::kIndexDecode:
+      return "index_decode";
+    case S2Phase::kBuilderSnap:
+      return "builder_snap";
+    case S2Phase::kBooleanOpGraphBuild:
+      return "boolean_op_graph_build";
+  }
+  return "unknown";
+}
+
+void S2SetPhaseCallback(S2PhaseCallback callback) {
+  s2internal::g_phase_callback.store(callback, std::memory_order_relaxed);
+}
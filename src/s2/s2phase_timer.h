@@ -0,0 +1,102 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef S2_S2PHASE_TIMER_H_
+#define S2_S2PHASE_TIMER_H_
+
+#include <atomic>
+#include <chrono>
+
+#include "absl/strings/string_view.h"
+#include "s2/base/types.h"
+
+// This file lets production tracing attribute latency to the expensive
+// internal phases of S2 operations without wrapping every call site.
+// Clients register a process-wide callback with S2SetPhaseCallback(); the
+// library then reports the start time and duration of each instrumented
+// phase as it completes.  When no callback is registered the markers cost a
+// single relaxed atomic load and the clock is never read.
+
+// Identifies an instrumented library phase.  New phases may be added over
+// time; callbacks should tolerate values they do not recognize.
+enum class S2Phase {
+  kIndexApplyUpdates,    // MutableS2ShapeIndex applying pending updates.
+  kIndexEncode,          // MutableS2ShapeIndex::Encode().
+  kIndexDecode,          // MutableS2ShapeIndex::Init(Decoder*).
+  kBuilderSnap,          // S2Builder snapping (site selection).
+  kBooleanOpGraphBuild,  // S2BooleanOperation building its output edges.
+};
+
+// Returns a stable lowercase name for "phase", suitable for trace labels.
+absl::string_view S2PhaseName(S2Phase phase);
+
+// Invoked when an instrumented phase completes.  "start_ns" is the start of
+// the phase in nanoseconds on the std::chrono::steady_clock timeline, and
+// "duration_ns" is how long the phase took.  The callback may be invoked
+// concurrently from multiple threads and must not re-enter the library.
+using S2PhaseCallback = void (*)(S2Phase phase, int64 start_ns,
+                                 int64 duration_ns);
+
+// Registers "callback" to receive phase completions, replacing any previous
+// callback; pass nullptr to unregister.  A plain function pointer is used
+// rather than std::function so that the unregistered fast path is a single
+// atomic load.  This function is safe to call concurrently with running
+// phases, but note that phases already in progress report to whichever
+// callback was registered when they started.
+void S2SetPhaseCallback(S2PhaseCallback callback);
+
+namespace s2internal {
+
+// The registered callback.  Not part of the public API; use
+// S2SetPhaseCallback() above.
+extern std::atomic<S2PhaseCallback> g_phase_callback;
+
+inline int64 PhaseClockNowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace s2internal
+
+// An RAII marker placed around instrumented phases.  The callback is
+// captured at construction so that the start and completion of a phase are
+// always reported consistently.
+class S2PhaseTimer {
+ public:
+  explicit S2PhaseTimer(S2Phase phase)
+      : phase_(phase),
+        callback_(
+            s2internal::g_phase_callback.load(std::memory_order_relaxed)) {
+    if (callback_ != nullptr) start_ns_ = s2internal::PhaseClockNowNs();
+  }
+
+  ~S2PhaseTimer() {
+    if (callback_ != nullptr) {
+      callback_(phase_, start_ns_,
+                s2internal::PhaseClockNowNs() - start_ns_);
+    }
+  }
+
+  S2PhaseTimer(const S2PhaseTimer&) = delete;
+  S2PhaseTimer& operator=(const S2PhaseTimer&) = delete;
+
+ private:
+  S2Phase phase_;
+  S2PhaseCallback callback_;
+  int64 start_ns_ = 0;
+};
+
+#endif  // S2_S2PHASE_TIMER_H_
@@ -0,0 +1,100 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2phase_timer.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "s2/base/types.h"
+#include "s2/mutable_s2shape_index.h"
+#include "s2/s2text_format.h"
+
+namespace {
+
+// The callback is a plain function pointer, so recorded phases are kept in
+// file-level state.  A mutex is required because phases may complete on
+// library-internal threads.
+struct PhaseRecord {
+  S2Phase phase;
+  int64 start_ns;
+  int64 duration_ns;
+};
+std::mutex record_mutex;
+std::vector<PhaseRecord> records;  // GUARDED_BY(record_mutex)
+
+void RecordPhase(S2Phase phase, int64 start_ns, int64 duration_ns) {
+  std::lock_guard<std::mutex> lock(record_mutex);
+  records.push_back({phase, start_ns, duration_ns});
+}
+
+std::vector<PhaseRecord> TakeRecords() {
+  std::lock_guard<std::mutex> lock(record_mutex);
+  return std::move(records);
+}
+
+// Registers RecordPhase for the duration of a test.
+class ScopedPhaseRecorder {
+ public:
+  ScopedPhaseRecorder() {
+    TakeRecords();
+    S2SetPhaseCallback(RecordPhase);
+  }
+  ~ScopedPhaseRecorder() { S2SetPhaseCallback(nullptr); }
+};
+
+TEST(S2PhaseTimer, ReportsPhaseWhenRegistered) {
+  ScopedPhaseRecorder recorder;
+  int64 before_ns = s2internal::PhaseClockNowNs();
+  { S2PhaseTimer timer(S2Phase::kBuilderSnap); }
+  int64 after_ns = s2internal::PhaseClockNowNs();
+
+  std::vector<PhaseRecord> recorded = TakeRecords();
+  ASSERT_EQ(recorded.size(), 1);
+  EXPECT_EQ(recorded[0].phase, S2Phase::kBuilderSnap);
+  EXPECT_GE(recorded[0].start_ns, before_ns);
+  EXPECT_GE(recorded[0].duration_ns, 0);
+  EXPECT_LE(recorded[0].start_ns + recorded[0].duration_ns, after_ns);
+}
+
+TEST(S2PhaseTimer, SilentWhenUnregistered) {
+  { S2PhaseTimer timer(S2Phase::kIndexApplyUpdates); }
+  EXPECT_TRUE(TakeRecords().empty());
+}
+
+TEST(S2PhaseTimer, IndexBuildReportsApplyUpdates) {
+  ScopedPhaseRecorder recorder;
+  auto index = s2textformat::MakeIndexOrDie("1:1 # 2:2, 3:3 #");
+  index->ForceBuild();
+
+  bool saw_apply = false;
+  for (const PhaseRecord& record : TakeRecords()) {
+    if (record.phase == S2Phase::kIndexApplyUpdates) saw_apply = true;
+  }
+  EXPECT_TRUE(saw_apply);
+}
+
+TEST(S2PhaseName, AllPhasesNamed) {
+  EXPECT_EQ(S2PhaseName(S2Phase::kIndexApplyUpdates), "index_apply_updates");
+  EXPECT_EQ(S2PhaseName(S2Phase::kIndexEncode), "index_encode");
+  EXPECT_EQ(S2PhaseName(S2Phase::kIndexDecode), "index_decode");
+  EXPECT_EQ(S2PhaseName(S2Phase::kBuilderSnap), "builder_snap");
+  EXPECT_EQ(S2PhaseName(S2Phase::kBooleanOpGraphBuild),
+            "boolean_op_graph_build");
+}
+
+}  // namespace
@@ -227,45 +227,42 @@ void EncodeFirstPointFixedLength(const pair<int, int>& vertex_pi_qi,
   ABSL_DCHECK_GE(encoder->avail(), 0);
 }
 
-void EncodePointCompressed(const pair<int, int>& vertex_pi_qi,
-                           int level,
-                           NthDerivativeCoder* pi_coder,
-                           NthDerivativeCoder* qi_coder,
-                           Encoder* encoder) {
-  // ZigZagEncode, as varint requires the maximum number of bytes for
-  // negative numbers.
-  const uint32 zig_zag_encoded_deriv_pi =
-      ZigZagEncode(pi_coder->Encode(vertex_pi_qi.first));
-  const uint32 zig_zag_encoded_deriv_qi =
-      ZigZagEncode(qi_coder->Encode(vertex_pi_qi.second));
-  // Interleave to reduce overhead from two partial bytes to one.
-  const uint64 interleaved_zig_zag_encoded_derivs =
-      util_bits::InterleaveUint32(zig_zag_encoded_deriv_pi,
-                                  zig_zag_encoded_deriv_qi);
-
-  encoder->Ensure(Encoder::kVarintMax64);
-  encoder->put_varint64(interleaved_zig_zag_encoded_derivs);
-  ABSL_DCHECK_GE(encoder->avail(), 0);
-}
-
 void EncodePointsCompressed(Span<const pair<int, int>> vertices_pi_qi,
                             int level, Encoder* encoder) {
+  if (vertices_pi_qi.empty()) return;
+
   NthDerivativeCoder pi_coder(kDerivativeEncodingOrder);
   NthDerivativeCoder qi_coder(kDerivativeEncodingOrder);
-  for (size_t i = 0; i < vertices_pi_qi.size(); ++i) {
-    if (i == 0) {
-      // The first point will be just the (pi, qi) coordinates
-      // of the S2Point.  NthDerivativeCoder will not save anything
-      // in that case, so we encode in fixed format rather than varint
-      // to avoid the varint overhead.
-      EncodeFirstPointFixedLength(vertices_pi_qi[i], level,
-                                  &pi_coder, &qi_coder, encoder);
-    } else {
-      EncodePointCompressed(vertices_pi_qi[i], level,
-                            &pi_coder, &qi_coder, encoder);
-    }
+
+  // The first point will be just the (pi, qi) coordinates of the S2Point.
+  // NthDerivativeCoder will not save anything in that case, so we encode in
+  // fixed format rather than varint to avoid the varint overhead.
+  EncodeFirstPointFixedLength(vertices_pi_qi[0], level, &pi_coder, &qi_coder,
+                              encoder);
+
+  // Run the derivative, zig-zag, and interleave stages over the remaining
+  // points in a tight loop that does not touch the encoder, so that the
+  // integer transforms are not interleaved with buffer management.
+  // (ZigZagEncode is used because varint requires the maximum number of
+  // bytes for negative numbers; interleaving reduces overhead from two
+  // partial bytes to one.)
+  const size_t num_rest = vertices_pi_qi.size() - 1;
+  absl::FixedArray<uint64> interleaved(num_rest);
+  for (size_t i = 0; i < num_rest; ++i) {
+    const uint32 zig_zag_encoded_deriv_pi =
+        ZigZagEncode(pi_coder.Encode(vertices_pi_qi[i + 1].first));
+    const uint32 zig_zag_encoded_deriv_qi =
+        ZigZagEncode(qi_coder.Encode(vertices_pi_qi[i + 1].second));
+    interleaved[i] = util_bits::InterleaveUint32(zig_zag_encoded_deriv_pi,
+                                                 zig_zag_encoded_deriv_qi);
   }
 
+  // Reserve space for the whole varint stream at once rather than once per
+  // point.
+  encoder->Ensure(num_rest * Encoder::kVarintMax64);
+  for (size_t i = 0; i < num_rest; ++i) {
+    encoder->put_varint64(interleaved[i]);
+  }
   ABSL_DCHECK_GE(encoder->avail(), 0);
 }
 
@@ -344,6 +341,27 @@ void S2EncodePointsCompressed(Span<const S2XYZFaceSiTi> points,
   }
 }
 
+void S2EncodePointsCompressedBatch(
+    Span<const Span<const S2XYZFaceSiTi>> points, int level,
+    Encoder* encoder) {
+  // Reserve space for the worst case of the whole batch: every point on a
+  // different face, every derivative at maximum varint size, and every point
+  // off-center.  The encodings are usually much smaller, but a single
+  // over-sized reservation is cheaper than growing the buffer incrementally
+  // as the batch is appended.
+  const size_t first_point_bytes = (level + 7) / 8 * 2;
+  size_t max_bytes = 0;
+  for (Span<const S2XYZFaceSiTi> polyline : points) {
+    max_bytes += Encoder::kVarintMax32 + first_point_bytes +
+                 polyline.size() * (2 * Encoder::kVarintMax64 +
+                                    Encoder::kVarintMax32 + sizeof(S2Point));
+  }
+  encoder->Ensure(max_bytes);
+  for (Span<const S2XYZFaceSiTi> polyline : points) {
+    S2EncodePointsCompressed(polyline, level, encoder);
+  }
+}
+
 bool S2DecodePointsCompressed(Decoder* decoder, int level,
                               Span<S2Point> points) {
   ABSL_DCHECK_LE(level, S2::kMaxCellLevel);
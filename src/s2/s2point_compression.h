@@ -71,6 +71,16 @@ struct S2XYZFaceSiTi {
 void S2EncodePointsCompressed(absl::Span<const S2XYZFaceSiTi> points,
                               int level, Encoder* encoder);
 
+// Encodes each span of points in "points" consecutively, producing exactly
+// the same bytes as calling S2EncodePointsCompressed once per span, but
+// reserves encoder space for the worst case of the whole batch up front so
+// that the output buffer is grown at most once.  This is useful when
+// encoding many polylines into a single buffer.  The individual encodings
+// must be decoded in order with S2DecodePointsCompressed.
+void S2EncodePointsCompressedBatch(
+    absl::Span<const absl::Span<const S2XYZFaceSiTi>> points, int level,
+    Encoder* encoder);
+
 // Decode points encoded with S2EncodePointsCompressed. Requires that the
 // level is the level that was used in S2EncodePointsCompressed. Ensures
 // that the decoded points equal the encoded points. Returns true on success.
@@ -16,7 +16,9 @@
 
 #include "s2/s2point_compression.h"
 
+#include <cstring>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -309,4 +311,37 @@ TEST_F(S2PointCompressionTest, FirstPointOnFaceEdge) {
   ABSL_CHECK(result[1] == points[1].xyz);
 }
 
+TEST_F(S2PointCompressionTest, BatchEncodeMatchesIndividualEncodings) {
+  const vector<S2Point>* loops[] = {&loop_4_, &loop_100_mixed_15_, &line_};
+  vector<vector<S2XYZFaceSiTi>> batch;
+  for (const vector<S2Point>* loop : loops) {
+    vector<S2XYZFaceSiTi> pts(loop->size());
+    MakeXYZFaceSiTiPoints(*loop, MakeSpan(pts));
+    batch.push_back(std::move(pts));
+  }
+
+  // The batch entry point should produce exactly the same bytes as encoding
+  // each span individually.
+  Encoder individual;
+  vector<Span<const S2XYZFaceSiTi>> spans;
+  for (const auto& pts : batch) {
+    spans.push_back(pts);
+    S2EncodePointsCompressed(spans.back(), S2::kMaxCellLevel, &individual);
+  }
+  Encoder batched;
+  S2EncodePointsCompressedBatch(spans, S2::kMaxCellLevel, &batched);
+  ASSERT_EQ(individual.length(), batched.length());
+  EXPECT_EQ(0, memcmp(individual.base(), batched.base(),
+                      individual.length()));
+
+  // The concatenated encodings can be decoded in order.
+  Decoder decoder(batched.base(), batched.length());
+  for (size_t i = 0; i < batch.size(); ++i) {
+    vector<S2Point> decoded(loops[i]->size());
+    ASSERT_TRUE(S2DecodePointsCompressed(&decoder, S2::kMaxCellLevel,
+                                         MakeSpan(decoded)));
+    EXPECT_TRUE(*loops[i] == decoded);
+  }
+}
+
 }  // namespace
@@ -0,0 +1,72 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2point_fingerprint.h"
+
+#include "absl/base/casts.h"
+#include "absl/log/absl_check.h"
+#include "absl/types/span.h"
+
+#include "s2/base/types.h"
+#include "s2/s2point.h"
+
+namespace S2 {
+
+namespace {
+
+// Returns the coordinate bits to be fingerprinted.  Adding positive zero
+// canonicalizes negative zero (-0.0 + 0.0 == +0.0) without a branch, which
+// keeps the kernel vectorizable; all other values are unchanged.
+inline uint64 CanonicalBits(double d) {
+  return absl::bit_cast<uint64>(d + 0.0);
+}
+
+// The 64-bit finalizer of the SplitMix64 generator, a well-studied bijective
+// mixing function.  The constants below are part of the fingerprint contract
+// and must never change (see the stability guarantee in the header).
+inline uint64 Mix(uint64 v) {
+  v ^= v >> 30;
+  v *= 0xbf58476d1ce4e5b9;
+  v ^= v >> 27;
+  v *= 0x94d049bb133111eb;
+  v ^= v >> 31;
+  return v;
+}
+
+// An arbitrary non-zero seed so that the origin does not fingerprint to the
+// fixed point Mix(0) chain.
+constexpr uint64 kSeed = 0xa5b4c3d2e1f00123;
+
+inline uint64 FingerprintKernel(const S2Point& p) {
+  uint64 h = Mix(kSeed ^ CanonicalBits(p.x()));
+  h = Mix(h ^ CanonicalBits(p.y()));
+  return Mix(h ^ CanonicalBits(p.z()));
+}
+
+}  // namespace
+
+uint64 PointFingerprint(const S2Point& p) {
+  return FingerprintKernel(p);
+}
+
+void GetPointFingerprints(absl::Span<const S2Point> points,
+                          absl::Span<uint64> fingerprints) {
+  ABSL_DCHECK_EQ(points.size(), fingerprints.size());
+  for (size_t i = 0; i < points.size(); ++i) {
+    fingerprints[i] = FingerprintKernel(points[i]);
+  }
+}
+
+}  // namespace S2
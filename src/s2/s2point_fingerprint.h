@@ -0,0 +1,61 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef S2_S2POINT_FINGERPRINT_H_
+#define S2_S2POINT_FINGERPRINT_H_
+
+#include <cstddef>
+
+#include "absl/types/span.h"
+
+#include "s2/_fp_contract_off.h"
+#include "s2/base/types.h"
+#include "s2/s2point.h"
+
+namespace S2 {
+
+// Returns a 64-bit fingerprint of "p".  Unlike S2PointHash, whose values are
+// randomly seeded per process, the fingerprint is a pure function of the
+// coordinate bits and is guaranteed to be stable across processes, platforms,
+// and library versions, so it may safely be persisted (e.g. to cache vertex
+// deduplication results across runs).  Like S2PointHash, it is defined such
+// that if two S2Points compare equal to each other, they have the same
+// fingerprint (this requires that positive and negative zero coordinates
+// fingerprint identically).
+uint64 PointFingerprint(const S2Point& p);
+
+// The batch form of PointFingerprint: sets
+//
+//   fingerprints[i] = PointFingerprint(points[i])
+//
+// for every input point.  "fingerprints" must be the same size as "points".
+// The mixing kernel is branch-free so that the compiler can vectorize this
+// loop; prefer it over repeated PointFingerprint calls when fingerprinting
+// whole vertex arrays.
+void GetPointFingerprints(absl::Span<const S2Point> points,
+                          absl::Span<uint64> fingerprints);
+
+}  // namespace S2
+
+// A hash functor for standard and absl containers keyed on S2Point.  It can
+// be used as a drop-in replacement for S2PointHash when hash values must not
+// vary from run to run.
+struct S2PointFingerprintHash {
+  size_t operator()(const S2Point& p) const {
+    return static_cast<size_t>(S2::PointFingerprint(p));
+  }
+};
+
+#endif  // S2_S2POINT_FINGERPRINT_H_
@@ -0,0 +1,73 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2point_fingerprint.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/span.h"
+
+#include "s2/base/types.h"
+#include "s2/s2point.h"
+#include "s2/s2testing.h"
+
+namespace {
+
+// These values are part of the fingerprint contract: they must be stable
+// across processes, platforms, and library versions.  Do not update them; a
+// failure here means the fingerprint function changed, which would invalidate
+// any persisted fingerprints.
+TEST(S2PointFingerprint, GoldenValues) {
+  EXPECT_EQ(S2::PointFingerprint(S2Point(1, 0, 0)), 0xe13537deee7a57a1ull);
+  EXPECT_EQ(S2::PointFingerprint(S2Point(0, 1, 0)), 0x46c0e8353595b225ull);
+  EXPECT_EQ(S2::PointFingerprint(S2Point(0, 0, 1)), 0x9562d4f2b175c038ull);
+  EXPECT_EQ(
+      S2::PointFingerprint(S2Point(0.5, -0.5, 0.7071067811865476)),
+      0xe1f59dd1e94637faull);
+}
+
+TEST(S2PointFingerprint, NegativeZeroMatchesPositiveZero) {
+  // S2Points whose coordinates compare equal must fingerprint identically,
+  // which requires canonicalizing the sign of zero.
+  EXPECT_EQ(S2::PointFingerprint(S2Point(0.0, -0.0, 1)),
+            S2::PointFingerprint(S2Point(-0.0, 0.0, 1)));
+}
+
+TEST(S2PointFingerprint, BatchMatchesScalar) {
+  std::vector<S2Point> points;
+  for (int i = 0; i < 100; ++i) {
+    points.push_back(S2Testing::RandomPoint());
+  }
+  std::vector<uint64> fingerprints(points.size());
+  S2::GetPointFingerprints(points, absl::MakeSpan(fingerprints));
+  for (size_t i = 0; i < points.size(); ++i) {
+    EXPECT_EQ(fingerprints[i], S2::PointFingerprint(points[i]));
+  }
+}
+
+TEST(S2PointFingerprint, UsableAsContainerHash) {
+  absl::flat_hash_map<S2Point, int, S2PointFingerprintHash> map;
+  for (int i = 0; i < 100; ++i) {
+    map[S2Testing::RandomPoint()] = i;
+  }
+  EXPECT_EQ(map.size(), 100);
+  map[S2Point(0.0, -0.0, 1)] = -1;
+  EXPECT_EQ(map.at(S2Point(-0.0, 0.0, 1)), -1);
+}
+
+}  // namespace
@@ -20,12 +20,16 @@
 
 #include <cstddef>
 
+#include <algorithm>
+#include <thread>
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "absl/container/btree_map.h"
 #include "absl/log/absl_check.h"
+#include "absl/types/span.h"
 
 #include "s2/s2cell_id.h"
 #include "s2/s2cell_iterator.h"
@@ -88,6 +92,12 @@ class BTreeMultimap : public absl::btree_multimap<Key, Value> {
 //   it.Init(&index);
 //   it.Seek(target.range_min());
 //
+// For large batches of points, Build() is much faster than repeated calls to
+// Add() and produces a more compact index (see its comments for details):
+//
+//   std::vector<S2PointIndex<int>::PointData> points = ...;
+//   index.Build(std::move(points), /*num_threads=*/8);
+//
 // You can also access the index directly using the iterator interface.  For
 // example, here is how to iterate through all the points in a given S2CellId
 // "target_id":
@@ -145,6 +155,49 @@ class S2PointIndex {
   // Convenience function for the case when Data is an empty class.
   void Add(const S2Point& point);
 
+  // Adds all the given points to the index in one bulk operation and
+  // "freezes" the result into a compact sorted-array representation.  This
+  // is equivalent to calling Add() on each point but is much faster for
+  // large inputs: the points are keyed and sorted by leaf S2CellId (using up
+  // to "num_threads" threads) rather than inserted into the btree one at a
+  // time, and the resulting array uses less memory and is faster to iterate
+  // than btree nodes.  Any points already in the index are retained.
+  //
+  // The index remains fully dynamic: a subsequent call to Add() or Remove()
+  // simply moves the entries back into the btree first.  Like Add() and
+  // Remove(), this method invalidates all iterators.
+  void Build(std::vector<PointData> points, int num_threads = 1);
+
+  // Columnar versions of Build() for use with column-oriented storage: the
+  // points and their data are supplied as separate parallel arrays rather
+  // than as materialized PointData rows.  The second version additionally
+  // accepts a precomputed leaf cell id column (e.g. one saved by
+  // ExportColumns() below), which avoids recomputing S2CellId(point) for
+  // every row.  The input buffers are not modified and may be freed as soon
+  // as the call returns.
+  //
+  // REQUIRES: points.size() == data.size()
+  // REQUIRES: cell_ids.size() == points.size()
+  // REQUIRES: cell_ids[i] == S2CellId(points[i]) for all i
+  void Build(absl::Span<const S2Point> points, absl::Span<const Data> data,
+             int num_threads = 1);
+  void Build(absl::Span<const S2CellId> cell_ids,
+             absl::Span<const S2Point> points, absl::Span<const Data> data,
+             int num_threads = 1);
+
+  // Convenience function for the case when Data is an empty class.
+  void Build(absl::Span<const S2Point> points, int num_threads = 1);
+
+  // Exports the contents of the index in columnar form by appending the leaf
+  // S2CellId, point, and data of every entry (in increasing S2CellId order)
+  // to the given output vectors.  Any of the pointers may be nullptr if that
+  // column is not needed.  Together with the columnar Build() overloads this
+  // allows an index to be saved to and rehydrated from column-oriented
+  // storage without materializing row tuples.
+  void ExportColumns(std::vector<S2CellId>* cell_ids,
+                     std::vector<S2Point>* points,
+                     std::vector<Data>* data) const;
+
   // Removes the given point from the index.  Both the "point" and "data"
   // fields must match the point to be removed.  Returns false if the given
   // point was not present.  Invalidates all iterators.
@@ -161,8 +214,9 @@ class S2PointIndex {
   size_t SpaceUsed() const;
 
  private:
-  // Defined here because the Iterator class below uses it.
+  // Defined here because the Iterator class below uses them.
   using Map = s2internal::BTreeMultimap<S2CellId, PointData>;
+  using Entry = std::pair<S2CellId, PointData>;
 
  public:
   class Iterator final : public S2CellIterator {
@@ -234,13 +288,40 @@ class S2PointIndex {
     }
 
    private:
+    // Returns true if the index entries are stored in the sorted array (see
+    // Build) rather than in the btree.
+    bool frozen() const { return !sorted_->empty(); }
+
     const Map* map_;
     typename Map::const_iterator iter_, end_;
+    const std::vector<Entry>* sorted_;
+    size_t pos_;  // Current position in *sorted_ when frozen().
   };
 
  private:
   friend class Iterator;
+
+  // Moves the entries of the sorted array back into the btree so that the
+  // index can be modified incrementally again.
+  void Unfreeze();
+
+  // Shared implementation of the Build() overloads: appends "n" new entries
+  // produced by make_entry(i) for i in [0, n) to the sorted array, sorting
+  // the new entries with up to "num_threads" threads and merging them with
+  // any existing index contents.  "make_entry" may be called concurrently
+  // from multiple threads.
+  template <class MakeEntry>
+  void BuildImpl(size_t n, const MakeEntry& make_entry, int num_threads);
+
+  // The minimum number of points per thread for Build(); using more threads
+  // than this allows would only add synchronization overhead.
+  static constexpr size_t kMinPointsPerThread = 1 << 14;
+
+  // At most one of the following containers is non-empty: points added with
+  // Add() live in map_, while points added with Build() live in sorted_ (in
+  // increasing order) until the next call to Add() or Remove().
   Map map_;
+  std::vector<Entry> sorted_;
 
   S2PointIndex(const S2PointIndex&) = delete;
   void operator=(const S2PointIndex&) = delete;
@@ -251,11 +332,12 @@ class S2PointIndex {
 
 template <class Data>
 inline int S2PointIndex<Data>::num_points() const {
-  return map_.size();
+  return map_.size() + sorted_.size();
 }
 
 template <class Data>
 void S2PointIndex<Data>::Add(const PointData& point_data) {
+  if (!sorted_.empty()) Unfreeze();
   S2CellId id(point_data.point());
   map_.insert(std::make_pair(id, point_data));
 }
@@ -271,8 +353,139 @@ void S2PointIndex<Data>::Add(const S2Point& point) {
   Add(point, {});
 }
 
+template <class Data>
+template <class MakeEntry>
+void S2PointIndex<Data>::BuildImpl(size_t n, const MakeEntry& make_entry,
+                                   int num_threads) {
+  // Move any entries already in the btree into the sorted array, so that
+  // Build() is equivalent to calling Add() on each point.  Note that both
+  // runs being concatenated here are already sorted.
+  const size_t old_size = sorted_.size();
+  sorted_.reserve(old_size + map_.size() + n);
+  for (const auto& entry : map_) sorted_.push_back(entry);
+  map_.clear();
+  const size_t base = sorted_.size();
+  sorted_.resize(base + n);
+
+  // Each worker keys and sorts one contiguous chunk of the new points; the
+  // sorted chunks are then merged below.
+  auto build_chunk = [this, base, &make_entry](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      sorted_[base + i] = make_entry(i);
+    }
+    std::sort(sorted_.begin() + base + begin, sorted_.begin() + base + end);
+  };
+  const size_t num_chunks = std::max<size_t>(
+      1, std::min<size_t>(num_threads, n / kMinPointsPerThread));
+  if (num_chunks == 1) {
+    build_chunk(0, n);
+  } else {
+    std::vector<std::thread> threads;
+    threads.reserve(num_chunks);
+    for (size_t c = 0; c < num_chunks; ++c) {
+      threads.emplace_back(build_chunk, c * n / num_chunks,
+                           (c + 1) * n / num_chunks);
+    }
+    for (auto& thread : threads) thread.join();
+    for (size_t c = 1; c < num_chunks; ++c) {
+      std::inplace_merge(sorted_.begin() + base,
+                         sorted_.begin() + base + c * n / num_chunks,
+                         sorted_.begin() + base + (c + 1) * n / num_chunks);
+    }
+  }
+  // Finally merge in the pre-existing entries, if any.
+  if (base > 0) {
+    std::inplace_merge(sorted_.begin(), sorted_.begin() + old_size,
+                       sorted_.begin() + base);
+    std::inplace_merge(sorted_.begin(), sorted_.begin() + base, sorted_.end());
+  }
+}
+
+template <class Data>
+void S2PointIndex<Data>::Build(std::vector<PointData> points, int num_threads) {
+  BuildImpl(
+      points.size(),
+      [&points](size_t i) {
+        return Entry(S2CellId(points[i].point()), std::move(points[i]));
+      },
+      num_threads);
+}
+
+template <class Data>
+void S2PointIndex<Data>::Build(absl::Span<const S2Point> points,
+                               absl::Span<const Data> data, int num_threads) {
+  ABSL_DCHECK_EQ(points.size(), data.size());
+  BuildImpl(
+      points.size(),
+      [points, data](size_t i) {
+        return Entry(S2CellId(points[i]), PointData(points[i], data[i]));
+      },
+      num_threads);
+}
+
+template <class Data>
+void S2PointIndex<Data>::Build(absl::Span<const S2CellId> cell_ids,
+                               absl::Span<const S2Point> points,
+                               absl::Span<const Data> data, int num_threads) {
+  ABSL_DCHECK_EQ(cell_ids.size(), points.size());
+  ABSL_DCHECK_EQ(points.size(), data.size());
+  BuildImpl(
+      points.size(),
+      [cell_ids, points, data](size_t i) {
+        ABSL_DCHECK_EQ(cell_ids[i], S2CellId(points[i]));
+        return Entry(cell_ids[i], PointData(points[i], data[i]));
+      },
+      num_threads);
+}
+
+template <class Data>
+void S2PointIndex<Data>::Build(absl::Span<const S2Point> points,
+                               int num_threads) {
+  static_assert(std::is_empty<Data>::value, "Data must be empty");
+  BuildImpl(
+      points.size(),
+      [points](size_t i) {
+        return Entry(S2CellId(points[i]), PointData(points[i], {}));
+      },
+      num_threads);
+}
+
+template <class Data>
+void S2PointIndex<Data>::ExportColumns(std::vector<S2CellId>* cell_ids,
+                                       std::vector<S2Point>* points,
+                                       std::vector<Data>* data) const {
+  const size_t n = num_points();
+  if (cell_ids) cell_ids->reserve(cell_ids->size() + n);
+  if (points) points->reserve(points->size() + n);
+  if (data) data->reserve(data->size() + n);
+  // At most one of the two containers is non-empty, and both iterate in
+  // increasing S2CellId order.
+  for (const auto& entry : sorted_) {
+    if (cell_ids) cell_ids->push_back(entry.first);
+    if (points) points->push_back(entry.second.point());
+    if (data) data->push_back(entry.second.data());
+  }
+  for (const auto& entry : map_) {
+    if (cell_ids) cell_ids->push_back(entry.first);
+    if (points) points->push_back(entry.second.point());
+    if (data) data->push_back(entry.second.data());
+  }
+}
+
+template <class Data>
+void S2PointIndex<Data>::Unfreeze() {
+  // The entries are already sorted, so inserting them with an end() hint
+  // builds the btree in a single left-to-right pass.
+  for (auto& entry : sorted_) {
+    map_.insert(map_.end(), std::move(entry));
+  }
+  sorted_.clear();
+  sorted_.shrink_to_fit();
+}
+
 template <class Data>
 bool S2PointIndex<Data>::Remove(const PointData& point_data) {
+  if (!sorted_.empty()) Unfreeze();
   S2CellId id(point_data.point());
   for (typename Map::iterator it = map_.lower_bound(id), end = map_.end();
        it != end && it->first == id; ++it) {
@@ -298,15 +511,19 @@ void S2PointIndex<Data>::Remove(const S2Point& point) {
 template <class Data>
 void S2PointIndex<Data>::Clear() {
   map_.clear();
+  sorted_.clear();
+  sorted_.shrink_to_fit();
 }
 
 template <class Data>
 size_t S2PointIndex<Data>::SpaceUsed() const {
-  return sizeof(*this) - sizeof(map_) + map_.bytes_used();
+  return sizeof(*this) - sizeof(map_) + map_.bytes_used() +
+         sorted_.capacity() * sizeof(Entry);
 }
 
 template <class Data>
-inline S2PointIndex<Data>::Iterator::Iterator() : map_(nullptr) {
+inline S2PointIndex<Data>::Iterator::Iterator()
+    : map_(nullptr), sorted_(nullptr), pos_(0) {
 }
 
 template <class Data>
@@ -321,64 +538,83 @@ inline void S2PointIndex<Data>::Iterator::Init(
   map_ = &index->map_;
   iter_ = map_->begin();
   end_ = map_->end();
+  sorted_ = &index->sorted_;
+  pos_ = 0;
 }
 
 template <class Data>
 inline S2CellId S2PointIndex<Data>::Iterator::id() const {
   ABSL_DCHECK(!done());
-  return iter_->first;
+  return frozen() ? (*sorted_)[pos_].first : iter_->first;
 }
 
 template <class Data>
 inline const S2Point& S2PointIndex<Data>::Iterator::point() const {
-  ABSL_DCHECK(!done());
-  return iter_->second.point();
+  return point_data().point();
 }
 
 template <class Data>
 inline const Data& S2PointIndex<Data>::Iterator::data() const {
-  ABSL_DCHECK(!done());
-  return iter_->second.data();
+  return point_data().data();
 }
 
 template <class Data>
 inline const typename S2PointIndex<Data>::PointData&
 S2PointIndex<Data>::Iterator::point_data() const {
   ABSL_DCHECK(!done());
-  return iter_->second;
+  return frozen() ? (*sorted_)[pos_].second : iter_->second;
 }
 
 template <class Data>
 inline bool S2PointIndex<Data>::Iterator::done() const {
-  return iter_ == end_;
+  return frozen() ? pos_ == sorted_->size() : iter_ == end_;
 }
 
 template <class Data>
 inline void S2PointIndex<Data>::Iterator::Begin() {
   iter_ = map_->begin();
+  pos_ = 0;
 }
 
 template <class Data>
 inline void S2PointIndex<Data>::Iterator::Finish() {
   iter_ = end_;
+  pos_ = sorted_->size();
 }
 
 template <class Data>
 inline void S2PointIndex<Data>::Iterator::Next() {
   ABSL_DCHECK(!done());
-  ++iter_;
+  if (frozen()) {
+    ++pos_;
+  } else {
+    ++iter_;
+  }
 }
 
 template <class Data>
 inline bool S2PointIndex<Data>::Iterator::Prev() {
-  if (iter_ == map_->begin()) return false;
-  --iter_;
+  if (frozen()) {
+    if (pos_ == 0) return false;
+    --pos_;
+  } else {
+    if (iter_ == map_->begin()) return false;
+    --iter_;
+  }
   return true;
 }
 
 template <class Data>
 inline void S2PointIndex<Data>::Iterator::Seek(S2CellId target) {
-  iter_ = map_->lower_bound(target);
+  if (frozen()) {
+    pos_ = std::lower_bound(sorted_->begin(), sorted_->end(), target,
+                            [](const Entry& entry, S2CellId id) {
+                              return entry.first < id;
+                            }) -
+           sorted_->begin();
+  } else {
+    iter_ = map_->lower_bound(target);
+  }
 }
 
 #endif  // S2_S2POINT_INDEX_H_
@@ -17,9 +17,12 @@
 
 #include "s2/s2point_index.h"
 
+#include <algorithm>
 #include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
+#include "absl/types/span.h"
 #include "s2/s2cell_id.h"
 #include "s2/s2cell_union.h"
 #include "s2/s2point.h"
@@ -136,6 +139,72 @@ TEST_F(S2PointIndexTest, RandomPoints) {
   }
 }
 
+TEST_F(S2PointIndexTest, BulkBuild) {
+  std::vector<PointData> points;
+  for (int i = 0; i < 1000; ++i) {
+    PointData point_data(S2Testing::RandomPoint(), S2Testing::rnd.Uniform(100));
+    points.push_back(point_data);
+    contents_.insert(point_data);
+  }
+  index_.Build(std::move(points));
+  Verify();
+
+  // Adding and removing points un-freezes the index transparently.
+  Add(S2Testing::RandomPoint(), 17);
+  Verify();
+  PointData first = *contents_.begin();
+  Remove(first.point(), first.data());
+  Verify();
+}
+
+TEST_F(S2PointIndexTest, BulkBuildParallelWithExistingPoints) {
+  // Build on an index that already contains points, using enough new points
+  // that the work is split among several threads.
+  for (int i = 0; i < 100; ++i) {
+    Add(S2Testing::RandomPoint(), S2Testing::rnd.Uniform(100));
+  }
+  std::vector<PointData> points;
+  for (int i = 0; i < 50000; ++i) {
+    PointData point_data(S2Testing::RandomPoint(), S2Testing::rnd.Uniform(100));
+    points.push_back(point_data);
+    contents_.insert(point_data);
+  }
+  index_.Build(std::move(points), /*num_threads=*/4);
+  VerifyContents();
+}
+
+TEST_F(S2PointIndexTest, ColumnarBuildAndExport) {
+  std::vector<S2Point> points;
+  std::vector<int> data;
+  for (int i = 0; i < 1000; ++i) {
+    points.push_back(S2Testing::RandomPoint());
+    data.push_back(S2Testing::rnd.Uniform(100));
+    contents_.insert(PointData(points.back(), data.back()));
+  }
+  index_.Build(points, absl::MakeConstSpan(data));
+  Verify();
+
+  // Export the columns and rebuild a second index from them, reusing the
+  // exported cell id column.
+  std::vector<S2CellId> cell_ids;
+  std::vector<S2Point> out_points;
+  std::vector<int> out_data;
+  index_.ExportColumns(&cell_ids, &out_points, &out_data);
+  ASSERT_EQ(1000, cell_ids.size());
+  EXPECT_TRUE(std::is_sorted(cell_ids.begin(), cell_ids.end()));
+
+  Index index2;
+  index2.Build(absl::MakeConstSpan(cell_ids), absl::MakeConstSpan(out_points),
+               absl::MakeConstSpan(out_data));
+  Contents remaining = contents_;
+  for (Index::Iterator it(&index2); !it.done(); it.Next()) {
+    Contents::iterator element = remaining.find(it.point_data());
+    ASSERT_TRUE(element != remaining.end());
+    remaining.erase(element);
+  }
+  EXPECT_TRUE(remaining.empty());
+}
+
 TEST(S2PointIndex, EmptyData) {
   // Verify that when Data is an empty class, no space is used.
   EXPECT_EQ(sizeof(S2Point), sizeof(S2PointIndex<>::PointData));
@@ -145,4 +214,9 @@ TEST(S2PointIndex, EmptyData) {
   index.Add(S2Point(1, 0, 0));
   index.Remove(S2Point(1, 0, 0));
   EXPECT_EQ(0, index.num_points());
+
+  // Verify the columnar Build() convenience overload.
+  std::vector<S2Point> points{S2Point(1, 0, 0), S2Point(0, 1, 0)};
+  index.Build(absl::MakeConstSpan(points));
+  EXPECT_EQ(2, index.num_points());
 }
@@ -22,6 +22,7 @@
 #include <vector>
 
 #include "absl/log/absl_check.h"
+#include "absl/types/span.h"
 #include "s2/util/coding/coder.h"
 #include "s2/encoded_s2point_vector.h"
 #include "s2/s2coder.h"
@@ -100,6 +101,58 @@ class S2PointVectorShape : public S2Shape {
   std::vector<S2Point> points_;
 };
 
+// S2PointVectorViewShape is like S2PointVectorShape except that it does not
+// own its points; it simply references a contiguous array provided by the
+// caller.  This makes it possible to build a transient index over columnar
+// data without copying any vertices.  The points are not owned by this class
+// and must persist unchanged for the lifetime of this object (and of any
+// index built over it).
+class S2PointVectorViewShape : public S2Shape {
+ public:
+  // Constructs an empty point vector.
+  S2PointVectorViewShape() = default;
+
+  // Constructs a shape viewing the given points, which are not copied.
+  explicit S2PointVectorViewShape(absl::Span<const S2Point> points)
+      : points_(points) {}
+
+  // Initializes a shape viewing the given points, which are not copied.
+  void Init(absl::Span<const S2Point> points) { points_ = points; }
+
+  int num_points() const { return static_cast<int>(points_.size()); }
+  const S2Point& point(int i) const { return points_[i]; }
+
+  // Appends an encoded representation to "encoder" in the same format as
+  // S2PointVectorShape (so the result can be decoded as one).
+  //
+  // REQUIRES: "encoder" uses the default constructor, so that its buffer
+  //           can be enlarged as necessary by calling Ensure(int).
+  void Encode(Encoder* encoder, s2coding::CodingHint hint) const override {
+    s2coding::EncodeS2PointVector(points_, hint, encoder);
+  }
+
+  // S2Shape interface (identical to S2PointVectorShape):
+  int num_edges() const final { return num_points(); }
+  Edge edge(int e) const final { return Edge(points_[e], points_[e]); }
+  int dimension() const final { return 0; }
+  ReferencePoint GetReferencePoint() const final {
+    return ReferencePoint::Contained(false);
+  }
+  int num_chains() const final { return num_points(); }
+  Chain chain(int i) const final { return Chain(i, 1); }
+  Edge chain_edge(int i, int j) const final {
+    ABSL_DCHECK_EQ(j, 0);
+    return Edge(points_[i], points_[i]);
+  }
+  ChainPosition chain_position(int e) const final {
+    return ChainPosition(e, 0);
+  }
+  TypeTag type_tag() const override { return S2PointVectorShape::kTypeTag; }
+
+ private:
+  absl::Span<const S2Point> points_;
+};
+
 // Exactly like S2PointVectorShape, except that the points are kept in an
 // encoded form and are decoded only as they are accessed.  This allows for
 // very fast initialization and no additional memory use beyond the encoded
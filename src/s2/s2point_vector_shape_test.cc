@@ -23,6 +23,7 @@
 
 #include <gtest/gtest.h>
 #include "absl/flags/flag.h"
+#include "absl/types/span.h"
 #include "s2/s2point.h"
 #include "s2/s2shape.h"
 #include "s2/s2shapeutil_testing.h"
@@ -145,3 +146,14 @@ TEST(S2PointVectorShape, ChainVertexIteratorWorks) {
     ++chain_counter;
   }
 }
+
+TEST(S2PointVectorViewShape, ViewsWithoutCopying) {
+  vector<S2Point> points;
+  S2Testing::rnd.Reset(absl::GetFlag(FLAGS_s2_random_seed));
+  for (int i = 0; i < 10; ++i) points.push_back(S2Testing::RandomPoint());
+  S2PointVectorShape owned((vector<S2Point>(points)));
+  S2PointVectorViewShape view((absl::Span<const S2Point>(points)));
+  s2testing::ExpectEqual(owned, view);
+  // The view references the caller's array rather than copying it.
+  EXPECT_EQ(&points[0], &view.point(0));
+}
@@ -26,6 +26,7 @@
 #include <queue>
 #include <stack>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -272,6 +273,69 @@ bool S2Polygon::FindValidationError(S2Error* error) const {
   return FindLoopNestingError(error);
 }
 
+bool S2Polygon::FindValidationError(S2Error* error, int num_threads,
+                                    S2Executor* executor) const {
+  ABSL_DCHECK_GE(num_threads, 1);
+  if (num_threads == 1) return FindValidationError(error);
+  if (executor == nullptr) executor = S2Executor::Default();
+
+  // Distribute the per-loop checks (which do not use the index) across the
+  // threads.  Each thread records the first error it finds and the loop it
+  // was found at; the error at the lowest-numbered loop is then reported so
+  // that the result matches the serial version.
+  std::vector<S2Error> loop_errors(num_threads);
+  std::vector<int> error_loops(num_threads, num_loops());
+  executor->Run(num_threads, [&](int t) {
+    for (int i = t; i < num_loops(); i += num_threads) {
+      S2Error* loop_error = &loop_errors[t];
+      // Check for loop errors that don't require building an S2ShapeIndex.
+      if (loop(i)->FindValidationErrorNoIndex(loop_error)) {
+        loop_error->Init(loop_error->code(), "Loop %d: %s", i,
+                         loop_error->text());
+        error_loops[t] = i;
+        return;
+      }
+      // Check that the full loop only appears in the full polygon.
+      if (loop(i)->is_full() && num_loops() > 1) {
+        loop_error->Init(S2Error::POLYGON_EXCESS_FULL_LOOP,
+                         "Loop %d: full loop appears in non-full polygon", i);
+        error_loops[t] = i;
+        return;
+      }
+    }
+  });
+  int first_error_thread = -1;
+  for (int t = 0; t < num_threads; ++t) {
+    if (error_loops[t] < num_loops() &&
+        (first_error_thread < 0 ||
+         error_loops[t] < error_loops[first_error_thread])) {
+      first_error_thread = t;
+    }
+  }
+  if (first_error_thread >= 0) {
+    *error = loop_errors[first_error_thread];
+    return true;
+  }
+
+  // Check for loop self-intersections and loop pairs that cross
+  // (including duplicate edges and vertices).
+  if (s2shapeutil::FindSelfIntersection(index_, error, num_threads,
+                                        executor)) {
+    return true;
+  }
+
+  // Check whether InitOriented detected inconsistent loop orientations.
+  if (error_inconsistent_loop_orientations_) {
+    error->Init(S2Error::POLYGON_INCONSISTENT_LOOP_ORIENTATIONS,
+                "Inconsistent loop orientations detected");
+    return true;
+  }
+
+  // The loop nesting hierarchy check is cheap (it does not look at any
+  // vertices), so it is not worth parallelizing.
+  return FindLoopNestingError(error);
+}
+
 bool S2Polygon::FindLoopNestingError(S2Error* error) const {
   // First check that the loop depths make sense.
   for (int last_depth = -1, i = 0; i < num_loops(); ++i) {
@@ -375,6 +439,23 @@ void S2Polygon::ClearIndex() {
   index_.Clear();
 }
 
+void S2Polygon::ForceBuildIndex(int num_threads, S2Executor* executor) {
+  ABSL_DCHECK_GE(num_threads, 1);
+  if (index_.is_fresh()) return;
+  if (num_threads > 1) {
+    // The threading options can only be set while the index is empty, so the
+    // shape is re-added.  (No work is discarded since the index has not been
+    // built yet.)
+    MutableS2ShapeIndex::Options options;
+    options.set_num_index_threads(num_threads);
+    options.set_executor(executor);
+    ClearIndex();
+    index_.Init(options);
+    InitIndex();
+  }
+  index_.ForceBuild();
+}
+
 void S2Polygon::InitNested(vector<unique_ptr<S2Loop>> loops) {
   using std::swap;
 
@@ -960,6 +1041,38 @@ void S2Polygon::InitToOperation(S2BooleanOperation::OpType op_type,
   }
 }
 
+PolygonOperation::PolygonOperation(S2BooleanOperation::OpType op_type)
+    : PolygonOperation(op_type,
+                       IdentitySnapFunction(S2::kIntersectionMergeRadius)) {}
+
+PolygonOperation::PolygonOperation(S2BooleanOperation::OpType op_type,
+                                   const S2Builder::SnapFunction& snap_function)
+    : op_type_(op_type) {
+  options_.set_snap_function(snap_function);
+}
+
+bool PolygonOperation::Build(const S2Polygon& a, const S2Polygon& b,
+                             S2Polygon* result, S2Error* error) {
+  error->Clear();
+  // When the bounds are disjoint some operations can be resolved without
+  // running the builder at all.
+  if (!a.bound_.Intersects(b.bound_)) {
+    switch (op_type_) {
+      case S2BooleanOperation::OpType::INTERSECTION:
+        result->InitNested({});
+        return true;
+      case S2BooleanOperation::OpType::DIFFERENCE:
+        result->Copy(a);
+        return true;
+      default:
+        break;  // The result contains both inputs; run the builder.
+    }
+  }
+  S2BooleanOperation op(op_type_, make_unique<S2PolygonLayer>(result),
+                        options_);
+  return op.Build(a.index_, b.index_, error);
+}
+
 void S2Polygon::InitToIntersection(const S2Polygon& a, const S2Polygon& b) {
   InitToIntersection(a, b, IdentitySnapFunction(S2::kIntersectionMergeRadius));
 }
@@ -1361,6 +1474,67 @@ unique_ptr<S2Polygon> S2Polygon::DestructiveUnion(
   return std::move(*queue.top());
 }
 
+unique_ptr<S2Polygon> S2Polygon::DestructiveUnion(
+    vector<unique_ptr<S2Polygon>> polygons, int num_threads) {
+  return DestructiveApproxUnion(std::move(polygons),
+                                S2::kIntersectionMergeRadius, num_threads);
+}
+
+unique_ptr<S2Polygon> S2Polygon::DestructiveApproxUnion(
+    vector<unique_ptr<S2Polygon>> polygons, S1Angle snap_radius,
+    int num_threads) {
+  return DestructiveUnion(std::move(polygons),
+                          IdentitySnapFunction(snap_radius), num_threads);
+}
+
+unique_ptr<S2Polygon> S2Polygon::DestructiveUnion(
+    vector<unique_ptr<S2Polygon>> polygons,
+    const S2Builder::SnapFunction& snap_function, int num_threads) {
+  // Threading does not pay off unless each thread performs at least a few
+  // unions in the first round.
+  static constexpr int kMinPolygonsPerThread = 8;
+  num_threads = std::min(
+      num_threads, static_cast<int>(polygons.size()) / kMinPolygonsPerThread);
+  if (num_threads <= 1) {
+    return DestructiveUnion(std::move(polygons), snap_function);
+  }
+
+  // Union the polygons as a merge tree: each round pairs up the current
+  // polygons and unions the pairs independently across threads, halving the
+  // number of polygons until one remains.  Sorting each round by number of
+  // vertices pairs small polygons with each other first, like the priority
+  // queue in the serial version, and makes the pairing (and hence the
+  // result) deterministic.
+  while (polygons.size() > 1) {
+    std::stable_sort(polygons.begin(), polygons.end(),
+                     [](const unique_ptr<S2Polygon>& a,
+                        const unique_ptr<S2Polygon>& b) {
+                       return a->num_vertices() < b->num_vertices();
+                     });
+    const int num_pairs = polygons.size() / 2;
+    vector<unique_ptr<S2Polygon>> results(polygons.size() - num_pairs);
+    const int round_threads = std::min(num_threads, num_pairs);
+    vector<std::thread> threads;
+    threads.reserve(round_threads);
+    for (int t = 0; t < round_threads; ++t) {
+      threads.emplace_back([&, t]() {
+        for (int i = t; i < num_pairs; i += round_threads) {
+          auto union_polygon = make_unique<S2Polygon>();
+          union_polygon->InitToUnion(*polygons[2 * i], *polygons[2 * i + 1],
+                                     snap_function);
+          results[i] = std::move(union_polygon);
+        }
+      });
+    }
+    for (auto& thread : threads) thread.join();
+    if (polygons.size() % 2 != 0) {
+      results.back() = std::move(polygons.back());
+    }
+    polygons = std::move(results);
+  }
+  return std::move(polygons[0]);
+}
+
 void S2Polygon::InitToCellUnionBorder(const S2CellUnion& cells) {
   // We use S2Builder to compute the union.  Due to rounding errors, we can't
   // compute an exact union - when a small cell is adjacent to a larger cell,
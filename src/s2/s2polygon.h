@@ -236,6 +236,21 @@ class S2Polygon final : public S2Region {
   // REQUIRES: error != nullptr
   bool FindValidationError(S2Error* error) const;
 
+  // Like the above, but distributes the per-loop checks and the
+  // edge-crossing scan of the S2ShapeIndex over "num_threads" threads.
+  // Validation only reads the polygon and its index, so no synchronization
+  // with other readers is needed.  If the polygon contains several errors
+  // then which one is reported may differ from the serial version (but it is
+  // always an error that the serial version could report).
+  //
+  // If an executor is given then the threads are run on it; otherwise
+  // S2Executor::Default() is used.
+  //
+  // REQUIRES: error != nullptr
+  // REQUIRES: num_threads >= 1
+  bool FindValidationError(S2Error* error, int num_threads,
+                           S2Executor* executor = nullptr) const;
+
   // Return true if this is the empty polygon (consisting of no loops).
   bool is_empty() const { return loops_.empty(); }
 
@@ -585,6 +600,21 @@ class S2Polygon final : public S2Region {
   static std::unique_ptr<S2Polygon> DestructiveUnion(
       std::vector<std::unique_ptr<S2Polygon> > polygons,
       const S2Builder::SnapFunction& snap_function);
+
+  // Like the methods above, but unions the polygons as a merge tree using up
+  // to "num_threads" threads (each pairwise union is independent work).  The
+  // result is the same region, but since the polygons are paired differently
+  // than in the serial version the output may differ by up to the snap
+  // radius.  Falls back to the serial algorithm when "num_threads" is 1 or
+  // there are too few polygons for threading to pay off.
+  static std::unique_ptr<S2Polygon> DestructiveUnion(
+      std::vector<std::unique_ptr<S2Polygon> > polygons, int num_threads);
+  static std::unique_ptr<S2Polygon> DestructiveApproxUnion(
+      std::vector<std::unique_ptr<S2Polygon> > polygons,
+      S1Angle snap_radius, int num_threads);
+  static std::unique_ptr<S2Polygon> DestructiveUnion(
+      std::vector<std::unique_ptr<S2Polygon> > polygons,
+      const S2Builder::SnapFunction& snap_function, int num_threads);
 #endif  // !defined(SWIG)
 
   // Initialize this polygon to the outline of the given cell union.
@@ -813,6 +843,21 @@ class S2Polygon final : public S2Region {
   // The index contains a single S2Polygon::Shape object.
   const MutableS2ShapeIndex& index() const { return index_; }
 
+  // Builds the spatial index used by query methods such as Contains() and
+  // Intersects() if it has not been built yet.  The index is normally built
+  // lazily the first time it is needed, which means that concurrent first
+  // queries on a freshly constructed or decoded polygon serialize while one
+  // thread builds it.  Calling this method at load time avoids such stalls.
+  //
+  // If "num_threads" is greater than 1 then the initial build is done in
+  // parallel (see MutableS2ShapeIndex::Options::num_index_threads()), with
+  // the threads run on "executor" (or S2Executor::Default() if nullptr).
+  // The executor, if given, is retained by the index and therefore must
+  // outlive the polygon (see MutableS2ShapeIndex::Options::executor()).
+  //
+  // REQUIRES: num_threads >= 1
+  void ForceBuildIndex(int num_threads = 1, S2Executor* executor = nullptr);
+
  private:
   friend class S2Stats;
   friend class PolygonOperation;
@@ -940,6 +985,46 @@ class S2Polygon final : public S2Region {
 #endif
 };
 
+// PolygonOperation applies one type of boolean operation repeatedly while
+// reusing state across calls.  It is intended for pipelines that apply the
+// same operation to many polygon pairs (e.g. intersecting one subject
+// polygon against thousands of clips): the snap function and operation
+// options are set up once rather than being copied on every call, and pairs
+// with disjoint bounds are resolved without running the builder at all.
+//
+// Example:
+//   PolygonOperation op(S2BooleanOperation::OpType::INTERSECTION);
+//   S2Polygon result;
+//   S2Error error;
+//   for (const S2Polygon* clip : clips) {
+//     if (!op.Build(subject, *clip, &result, &error)) break;
+//     Process(result);
+//   }
+class PolygonOperation {
+ public:
+  // Creates an operation of the given type using the same default snap
+  // function as S2Polygon::InitToIntersection() and friends (an
+  // IdentitySnapFunction with S2::kIntersectionMergeRadius).
+  explicit PolygonOperation(S2BooleanOperation::OpType op_type);
+
+  PolygonOperation(S2BooleanOperation::OpType op_type,
+                   const S2Builder::SnapFunction& snap_function);
+
+  // The options passed to each S2BooleanOperation, e.g. to set a memory
+  // tracker or executor.  (The snap function is set by the constructor.)
+  const S2BooleanOperation::Options& options() const { return options_; }
+  S2BooleanOperation::Options* mutable_options() { return &options_; }
+
+  // Applies the operation to the given pair of polygons, reinitializing
+  // "result" with the outcome.  Returns true on success.
+  bool Build(const S2Polygon& a, const S2Polygon& b, S2Polygon* result,
+             S2Error* error);
+
+ private:
+  S2BooleanOperation::OpType op_type_;
+  S2BooleanOperation::Options options_;
+};
+
 
 //////////////////   Implementation details follow   ////////////////////
 
@@ -290,6 +290,65 @@ TEST(S2Polygon, Init) {
   CheckContainsPoint(kSouthHemi, kSouthPoint);
 }
 
+TEST(S2Polygon, PolygonOperationMatchesInitToOperation) {
+  unique_ptr<S2Polygon> subject(
+      s2textformat::MakePolygonOrDie("0:0, 0:4, 4:4, 4:0"));
+  const vector<string> clips = {
+      "1:1, 1:5, 5:5, 5:1",    // Overlapping.
+      "2:2, 2:3, 3:3, 3:2",    // Contained.
+      "20:20, 20:21, 21:21"};  // Disjoint bounds (builder-free fast path).
+  PolygonOperation intersection(S2BooleanOperation::OpType::INTERSECTION);
+  PolygonOperation difference(S2BooleanOperation::OpType::DIFFERENCE);
+  S2Polygon result, expected;
+  S2Error error;
+  for (const string& clip_str : clips) {
+    SCOPED_TRACE(clip_str);
+    unique_ptr<S2Polygon> clip(s2textformat::MakePolygonOrDie(clip_str));
+    ASSERT_TRUE(intersection.Build(*subject, *clip, &result, &error)) << error;
+    expected.InitToIntersection(*subject, *clip);
+    EXPECT_TRUE(expected.BoundaryApproxEquals(result));
+    ASSERT_TRUE(difference.Build(*subject, *clip, &result, &error)) << error;
+    expected.InitToDifference(*subject, *clip);
+    EXPECT_TRUE(expected.BoundaryApproxEquals(result));
+  }
+}
+
+TEST(S2Polygon, FindValidationErrorParallel) {
+  // A valid polygon and several invalid ones (constructed with
+  // S2Debug::DISABLE so that validation is not triggered on construction).
+  // The parallel overload must agree with the serial one.
+  for (const char* polygon_str :
+       {"0:0, 0:4, 4:4, 4:0; 1:1, 3:1, 3:3, 1:3",       // Valid.
+        "0:0, 0:1, 1:0, 1:1",                           // Self-intersection.
+        "0:0, 0:1, 0:2, 1:2, 0:1, 1:0",                 // Duplicate vertex.
+        "0:0, 0:3, 3:3, 3:0; 1:1, 1:4, 4:4, 4:1"}) {    // Crossing loops.
+    SCOPED_TRACE(polygon_str);
+    unique_ptr<S2Polygon> polygon =
+        s2textformat::MakePolygonOrDie(polygon_str, S2Debug::DISABLE);
+    S2Error serial_error;
+    const bool expected = polygon->FindValidationError(&serial_error);
+    for (int num_threads : {1, 2, 4}) {
+      S2Error parallel_error;
+      EXPECT_EQ(expected,
+                polygon->FindValidationError(&parallel_error, num_threads));
+      EXPECT_EQ(serial_error.code(), parallel_error.code());
+    }
+  }
+}
+
+TEST(S2Polygon, ForceBuildIndex) {
+  unique_ptr<S2Polygon> polygon(
+      s2textformat::MakePolygonOrDie("0:0, 0:5, 5:5, 5:0"));
+  EXPECT_FALSE(polygon->index().is_fresh());
+  polygon->ForceBuildIndex(2);
+  EXPECT_TRUE(polygon->index().is_fresh());
+  EXPECT_TRUE(polygon->Contains(s2textformat::MakePointOrDie("2:2")));
+  EXPECT_FALSE(polygon->Contains(s2textformat::MakePointOrDie("10:10")));
+  // Calling it again is a no-op.
+  polygon->ForceBuildIndex();
+  EXPECT_TRUE(polygon->index().is_fresh());
+}
+
 TEST(S2Polygon, OverlapFractions) {
   unique_ptr<S2Polygon> a(MakePolygon(kEmpty));
   unique_ptr<S2Polygon> b(MakePolygon(kEmpty));
@@ -942,6 +1001,25 @@ TEST_F(S2PolygonTestBase, Operations) {
   }
 }
 
+TEST(S2Polygon, DestructiveUnionParallelMatchesSerial) {
+  // Checks that the threaded merge-tree version of DestructiveUnion()
+  // produces the same region as the serial version.  The pairing order
+  // differs, so the boundaries may differ by up to the snap radius.
+  vector<unique_ptr<S2Polygon>> serial, parallel;
+  for (int i = 0; i < 40; ++i) {
+    S2Cell cell(S2Testing::GetRandomCellId(4));
+    serial.emplace_back(make_unique<S2Polygon>(cell));
+    parallel.emplace_back(make_unique<S2Polygon>(cell));
+  }
+  unique_ptr<S2Polygon> expected =
+      S2Polygon::DestructiveUnion(std::move(serial));
+  unique_ptr<S2Polygon> actual =
+      S2Polygon::DestructiveUnion(std::move(parallel), 4);
+  EXPECT_TRUE(expected->BoundaryNear(*actual, S1Angle::Radians(1e-12)))
+      << "\nActual:\n" << s2textformat::ToString(*actual)
+      << "\nExpected:\n" << s2textformat::ToString(*expected);
+}
+
 TEST(S2Polygon, IntersectionSnapFunction) {
   // This tests that an intersection point is rounded to the nearest allowable
   // vertex position (using E0 coordinates, i.e. integer lat/lng values).
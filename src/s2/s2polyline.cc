@@ -355,15 +355,7 @@ bool S2Polyline::Intersects(const S2Polyline& line) const {
   }
 
   // TODO(ericv): Use S2ShapeIndex here.
-  for (int i = 1; i < num_vertices(); ++i) {
-    S2EdgeCrosser crosser(&vertex(i - 1), &vertex(i), &line.vertex(0));
-    for (int j = 1; j < line.num_vertices(); ++j) {
-      if (crosser.CrossingSign(&line.vertex(j)) >= 0) {
-        return true;
-      }
-    }
-  }
-  return false;
+  return S2::ChainsCross(vertices_span(), line.vertices_span());
 }
 
 void S2Polyline::Reverse() {
@@ -374,9 +366,7 @@ void S2Polyline::Reverse() {
 
 S2LatLngRect S2Polyline::GetRectBound() const {
   S2LatLngRectBounder bounder;
-  for (int i = 0; i < num_vertices(); ++i) {
-    bounder.AddPoint(vertex(i));
-  }
+  bounder.AddPoints(vertices_span());
   return bounder.GetBound();
 }
 
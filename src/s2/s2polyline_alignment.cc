@@ -22,6 +22,7 @@
 #include <ostream>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -149,15 +150,19 @@ bool Window::IsValid() const {
   return true;
 }
 
+// The cost table is stored as a single flat allocation of rows * cols
+// entries (row-major) rather than a vector of rows; this avoids a separate
+// heap allocation per row and keeps neighboring rows contiguous in memory.
 inline double BoundsCheckedTableCost(const int row, const int col,
                                      const ColumnStride& stride,
-                                     const CostTable& table) {
+                                     const vector<double>& table,
+                                     const int cols) {
   if (row < 0 && col < 0) {
     return 0.0;
   } else if (row < 0 || col < 0 || !stride.InRange(col)) {
     return DOUBLE_MAX;
   } else {
-    return table[row][col];
+    return table[row * cols + col];
   }
 }
 
@@ -187,22 +192,30 @@ VertexAlignment DynamicTimewarp(const S2Polyline& a, const S2Polyline& b,
                                 const Window& w) {
   const int rows = a.num_vertices();
   const int cols = b.num_vertices();
-  auto costs = CostTable(rows, vector<double>(cols));
+  vector<double> costs(rows * cols);
 
   ColumnStride curr;
   ColumnStride prev = ColumnStride::All();
   for (int row = 0; row < rows; ++row) {
     curr = w.GetColumnStride(row);
+    // The cost to the left of the first cell in the stride is always
+    // DOUBLE_MAX (either the column is negative or it is outside the
+    // stride), and within the stride it is simply the value computed on the
+    // previous iteration, so it can be carried in a local instead of being
+    // re-read from the table.
+    double l_cost = DOUBLE_MAX;
     for (int col = curr.start; col < curr.end; ++col) {
       // The total cost up to (row,col) is the minimum of the cost up, down,
       // left and the distance between the points in row and col. We use
       // the distance between the points, as we are trying to minimize the
       // distance between the two polylines.
-      double d_cost = BoundsCheckedTableCost(row - 1, col - 1, prev, costs);
-      double u_cost = BoundsCheckedTableCost(row - 1, col - 0, prev, costs);
-      double l_cost = BoundsCheckedTableCost(row - 0, col - 1, curr, costs);
-      costs[row][col] = std::min({d_cost, u_cost, l_cost}) +
-                        (a.vertex(row) - b.vertex(col)).Norm();
+      double d_cost =
+          BoundsCheckedTableCost(row - 1, col - 1, prev, costs, cols);
+      double u_cost =
+          BoundsCheckedTableCost(row - 1, col - 0, prev, costs, cols);
+      l_cost = std::min({d_cost, u_cost, l_cost}) +
+               (a.vertex(row) - b.vertex(col)).Norm();
+      costs[row * cols + col] = l_cost;
     }
     prev = curr;
   }
@@ -224,9 +237,9 @@ VertexAlignment DynamicTimewarp(const S2Polyline& a, const S2Polyline& b,
   prev = w.GetCheckedColumnStride(row - 1);
   while (row >= 0 && col >= 0) {
     warp_path.push_back({row, col});
-    double d_cost = BoundsCheckedTableCost(row - 1, col - 1, prev, costs);
-    double u_cost = BoundsCheckedTableCost(row - 1, col - 0, prev, costs);
-    double l_cost = BoundsCheckedTableCost(row - 0, col - 1, curr, costs);
+    double d_cost = BoundsCheckedTableCost(row - 1, col - 1, prev, costs, cols);
+    double u_cost = BoundsCheckedTableCost(row - 1, col - 0, prev, costs, cols);
+    double l_cost = BoundsCheckedTableCost(row - 0, col - 1, curr, costs, cols);
     if (d_cost <= u_cost && d_cost <= l_cost) {
       row -= 1;
       col -= 1;
@@ -241,7 +254,7 @@ VertexAlignment DynamicTimewarp(const S2Polyline& a, const S2Polyline& b,
     }
   }
   std::reverse(warp_path.begin(), warp_path.end());
-  return VertexAlignment(costs.back().back(), warp_path);
+  return VertexAlignment(costs.back(), warp_path);
 }
 
 unique_ptr<S2Polyline> HalfResolution(const S2Polyline& in) {
@@ -344,6 +357,147 @@ VertexAlignment GetApproxVertexAlignment(const S2Polyline& a,
   return GetApproxVertexAlignment(a, b, radius);
 }
 
+StreamingVertexAligner::StreamingVertexAligner(
+    const S2Polyline* b, const StreamingAlignmentOptions& options)
+    : b_(b), options_(options) {
+  ABSL_CHECK(b_->num_vertices() > 0) << "B is empty polyline.";
+  ABSL_CHECK(options_.radius() >= 0) << "Radius is negative.";
+  ABSL_CHECK(options_.max_latency() > 0) << "Latency is non-positive.";
+}
+
+// Fills in one new row of the banded DP recurrence. This is the streaming
+// analogue of the row loop in DynamicTimewarp, with two differences: the
+// band for each row is derived incrementally (centered on the best cell of
+// the previous row) instead of being read from a precomputed Window, and the
+// direction chosen for each cell is persisted in `enter`/`parent` so that the
+// path can be recovered later from only the buffered rows.
+WarpPath StreamingVertexAligner::AddVertex(const S2Point& a_vertex) {
+  ABSL_DCHECK(!finished_) << "AddVertex() called after Finish().";
+  const int b_n = b_->num_vertices();
+  const int radius = options_.radius();
+  RowState row;
+  if (rows_.empty()) {
+    // The first row is reachable only by leftward steps from (0, 0).
+    row.start = 0;
+    const int end = std::min(b_n, radius + 1);
+    double cost = 0;
+    for (int col = 0; col < end; ++col) {
+      cost += (a_vertex - b_->vertex(col)).Norm();
+      row.costs.push_back(cost);
+      row.enter.push_back(0);
+      row.parent.push_back(-1);
+    }
+  } else {
+    const RowState& prev = rows_.back();
+    const int prev_end = prev.start + static_cast<int>(prev.costs.size());
+    const int best = prev.start + static_cast<int>(std::min_element(
+        prev.costs.begin(), prev.costs.end()) - prev.costs.begin());
+    // Since warp paths never move leftward, the band never needs to extend
+    // behind the previous row's first column.
+    const int start = std::max(prev.start, best - radius);
+    const int end = std::min(b_n, std::max(start + 1, best + radius + 1));
+    row.start = start;
+    const auto prev_cost = [&prev, prev_end](int col) {
+      return (col >= prev.start && col < prev_end) ? prev.costs[col - prev.start]
+                                                   : DOUBLE_MAX;
+    };
+    // As in DynamicTimewarp, the cost to the left of the current cell is
+    // carried in a local rather than re-read from the row.
+    double l_cost = DOUBLE_MAX;
+    for (int col = start; col < end; ++col) {
+      const double d_cost = prev_cost(col - 1);
+      const double u_cost = prev_cost(col);
+      if (d_cost <= u_cost && d_cost <= l_cost) {
+        row.enter.push_back(col);
+        row.parent.push_back(col - 1);
+      } else if (u_cost <= l_cost) {
+        row.enter.push_back(col);
+        row.parent.push_back(col);
+      } else {
+        row.enter.push_back(row.enter[col - 1 - start]);
+        row.parent.push_back(row.parent[col - 1 - start]);
+      }
+      l_cost = std::min({d_cost, u_cost, l_cost}) +
+               (a_vertex - b_->vertex(col)).Norm();
+      row.costs.push_back(l_cost);
+    }
+  }
+  rows_.push_back(std::move(row));
+  if (static_cast<int>(rows_.size()) > options_.max_latency()) {
+    return CommitRows(/*commit_all=*/false);
+  }
+  return WarpPath();
+}
+
+WarpPath StreamingVertexAligner::Finish() {
+  ABSL_DCHECK(!finished_) << "Finish() called twice.";
+  ABSL_CHECK(!rows_.empty()) << "A is empty polyline.";
+  WarpPath path = CommitRows(/*commit_all=*/true);
+  finished_ = true;
+  return path;
+}
+
+double StreamingVertexAligner::alignment_cost() const {
+  ABSL_DCHECK(finished_) << "alignment_cost() called before Finish().";
+  return alignment_cost_;
+}
+
+// Traces the best path through the buffered rows and emits its warp path
+// entries for the oldest rows. If `commit_all` is false, every buffered row
+// except the newest is emitted, and the newest row is narrowed to the run of
+// cells whose paths enter the row at the traced column; every such cell lies
+// on a horizontal extension of the traced path, which guarantees that the
+// entries emitted by future commits connect to the ones emitted here. If
+// `commit_all` is true, all rows are emitted and the total path cost is
+// recorded.
+WarpPath StreamingVertexAligner::CommitRows(const bool commit_all) {
+  const int num_rows = static_cast<int>(rows_.size());
+  // Walk back from the best cell in the newest row, recording the column at
+  // which the path exits each buffered row. The stored `parent` pointers
+  // reproduce the minimizing direction chosen when each cell was filled, so
+  // the cost of the traced path is exactly the DP cost of its final cell.
+  vector<int> exits(num_rows);
+  {
+    const RowState& newest = rows_.back();
+    int col = newest.start + static_cast<int>(std::min_element(
+        newest.costs.begin(), newest.costs.end()) - newest.costs.begin());
+    if (commit_all) alignment_cost_ = newest.costs[col - newest.start];
+    for (int r = num_rows - 1; r >= 0; --r) {
+      exits[r] = col;
+      col = rows_[r].parent[col - rows_[r].start];
+    }
+  }
+
+  const int num_commit = commit_all ? num_rows : num_rows - 1;
+  WarpPath path;
+  for (int r = 0; r < num_commit; ++r) {
+    const RowState& row = rows_[r];
+    for (int col = row.enter[exits[r] - row.start]; col <= exits[r]; ++col) {
+      path.push_back({base_row_ + r, col});
+    }
+  }
+
+  if (commit_all) {
+    rows_.clear();
+  } else {
+    RowState& row = rows_.back();
+    const int enter = row.enter[exits[num_rows - 1] - row.start];
+    const int begin = enter - row.start;
+    const int size = static_cast<int>(row.costs.size());
+    int end = begin;
+    while (end < size && row.enter[end] == enter) ++end;
+    row.costs = vector<double>(row.costs.begin() + begin,
+                               row.costs.begin() + end);
+    row.enter = vector<int>(row.enter.begin() + begin, row.enter.begin() + end);
+    row.parent = vector<int>(row.parent.begin() + begin,
+                             row.parent.begin() + end);
+    row.start = enter;
+    rows_.erase(rows_.begin(), rows_.end() - 1);
+  }
+  base_row_ += num_commit;
+  return path;
+}
+
 // We use some of the symmetry of our metric to avoid computing all N^2
 // alignments. Specifically, because cost_fn(a, b) = cost_fn(b, a), and
 // cost_fn(a, a) = 0, we can compute only the lower triangle of cost matrix
@@ -356,11 +510,40 @@ int GetMedoidPolyline(const vector<unique_ptr<S2Polyline>>& polylines,
 
   // costs[i] stores total cost of aligning [i] with all other polylines.
   vector<double> costs(num_polylines, 0.0);
-  for (int i = 0; i < num_polylines; ++i) {
-    for (int j = i + 1; j < num_polylines; ++j) {
-      double cost = CostFn(*polylines[i], *polylines[j], approx);
-      costs[i] += cost;
-      costs[j] += cost;
+  const int num_pairs = num_polylines * (num_polylines - 1) / 2;
+  const int num_threads = std::min(options.num_threads(), num_pairs);
+  if (num_threads > 1) {
+    // Distribute the pairs round-robin across the threads; each thread
+    // accumulates into its own cost vector, and the vectors are summed after
+    // the threads are joined.
+    vector<vector<double>> thread_costs(num_threads,
+                                        vector<double>(num_polylines, 0.0));
+    vector<std::thread> threads;
+    threads.reserve(num_threads);
+    for (int t = 0; t < num_threads; ++t) {
+      threads.emplace_back([&, t]() {
+        int pair = 0;
+        for (int i = 0; i < num_polylines; ++i) {
+          for (int j = i + 1; j < num_polylines; ++j) {
+            if (pair++ % num_threads != t) continue;
+            double cost = CostFn(*polylines[i], *polylines[j], approx);
+            thread_costs[t][i] += cost;
+            thread_costs[t][j] += cost;
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) thread.join();
+    for (const auto& thread_cost : thread_costs) {
+      for (int i = 0; i < num_polylines; ++i) costs[i] += thread_cost[i];
+    }
+  } else {
+    for (int i = 0; i < num_polylines; ++i) {
+      for (int j = i + 1; j < num_polylines; ++j) {
+        double cost = CostFn(*polylines[i], *polylines[j], approx);
+        costs[i] += cost;
+        costs[j] += cost;
+      }
     }
   }
   return std::min_element(costs.begin(), costs.end()) - costs.begin();
@@ -398,20 +581,49 @@ unique_ptr<S2Polyline> GetConsensusPolyline(
   if (options.seed_medoid()) {
     MedoidOptions medoid_options;
     medoid_options.set_approx(approx);
+    medoid_options.set_num_threads(options.num_threads());
     seed_index = GetMedoidPolyline(polylines, medoid_options);
   }
   auto consensus = unique_ptr<S2Polyline>(polylines[seed_index]->Clone());
   const int num_consensus_vertices = consensus->num_vertices();
   ABSL_DCHECK_GT(num_consensus_vertices, 1);
 
+  const int num_threads = std::min(options.num_threads(), num_polylines);
   bool converged = false;
   int iterations = 0;
   while (!converged && iterations < options.iteration_cap()) {
     vector<S2Point> points(num_consensus_vertices, S2Point());
-    for (const auto& polyline : polylines) {
-      const auto alignment = AlignmentFn(*consensus, *polyline, approx);
-      for (const auto& pair : alignment.warp_path) {
-        points[pair.first] += polyline->vertex(pair.second);
+    if (num_threads > 1) {
+      // Each alignment against the current consensus is independent work;
+      // each thread accumulates barycenter sums into its own point vector,
+      // and the vectors are summed after the threads are joined.
+      vector<vector<S2Point>> thread_points(
+          num_threads, vector<S2Point>(num_consensus_vertices, S2Point()));
+      vector<std::thread> threads;
+      threads.reserve(num_threads);
+      for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t]() {
+          for (int i = t; i < num_polylines; i += num_threads) {
+            const auto alignment = AlignmentFn(*consensus, *polylines[i],
+                                               approx);
+            for (const auto& pair : alignment.warp_path) {
+              thread_points[t][pair.first] += polylines[i]->vertex(pair.second);
+            }
+          }
+        });
+      }
+      for (auto& thread : threads) thread.join();
+      for (const auto& thread_point : thread_points) {
+        for (int i = 0; i < num_consensus_vertices; ++i) {
+          points[i] += thread_point[i];
+        }
+      }
+    } else {
+      for (const auto& polyline : polylines) {
+        const auto alignment = AlignmentFn(*consensus, *polyline, approx);
+        for (const auto& pair : alignment.warp_path) {
+          points[pair.first] += polyline->vertex(pair.second);
+        }
       }
     }
     for (S2Point& p : points) {
@@ -17,6 +17,7 @@
 #ifndef S2_S2POLYLINE_ALIGNMENT_H_
 #define S2_S2POLYLINE_ALIGNMENT_H_
 
+#include <deque>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -157,6 +158,96 @@ VertexAlignment GetApproxVertexAlignment(const S2Polyline& a,
 VertexAlignment GetApproxVertexAlignment(const S2Polyline& a,
                                          const S2Polyline& b);
 
+class StreamingAlignmentOptions {
+ public:
+  // options.radius controls the half-width of the search band maintained over
+  // the vertices of `b`: each arriving vertex of `a` is matched against at
+  // most 2 * radius + 1 candidate vertices of `b`, centered on the best match
+  // of the previous vertex. Smaller values of `radius` are faster but may miss
+  // the optimal alignment; this is the same quality/speed trade-off as the
+  // `radius` parameter of GetApproxVertexAlignment.
+  int radius() const { return radius_; }
+  void set_radius(int radius) { radius_ = radius; }
+
+  // options.max_latency controls how many vertices of `a` may be buffered
+  // before a prefix of the warp path is forced out. Larger values give the
+  // aligner more look-ahead before it has to commit to a prefix (and therefore
+  // better alignments), at the expense of higher output latency and more
+  // buffered state. Memory usage is O(max_latency * radius), independent of
+  // the length of the stream.
+  int max_latency() const { return max_latency_; }
+  void set_max_latency(int max_latency) { max_latency_ = max_latency; }
+
+ private:
+  int radius_ = 16;
+  int max_latency_ = 64;
+};
+
+// StreamingVertexAligner incrementally aligns a stream of points (the vertices
+// of a conceptual polyline `a` that need not ever exist in memory) against a
+// fixed polyline `b`. Unlike the batch methods above, which require both
+// polylines up front, points are fed in one at a time with AddVertex() and
+// warp-path prefixes are emitted with bounded latency: each point is matched
+// within a bounded search band of `b` (see StreamingAlignmentOptions::radius),
+// and once options.max_latency points have accumulated, the best path through
+// the buffered band is traced and all but the most recent row of its entries
+// are committed and returned. Committed entries never change, and the
+// concatenation of all returned prefixes is a valid warp path: it begins at
+// (0, 0), and consecutive entries differ by (0, 1), (1, 0) or (1, 1).
+//
+// Because prefixes are committed before the stream ends, the result is an
+// approximation: it is the optimal alignment subject to the band and latency
+// constraints, and converges to GetExactVertexAlignment as `radius` and
+// `max_latency` grow. Note also that the final warp path entry pairs the last
+// stream point with its best matching vertex of `b`, which need not be the
+// final vertex of `b` (a stream may end partway along a route).
+//
+// Example usage, aligning a live stream against a route polyline:
+//
+//   StreamingVertexAligner aligner(&route, options);
+//   while (HasMorePoints()) {
+//     for (const auto& pair : aligner.AddVertex(NextPoint())) Emit(pair);
+//   }
+//   for (const auto& pair : aligner.Finish()) Emit(pair);
+class StreamingVertexAligner {
+ public:
+  // `b` must be non-empty and must persist for the lifetime of this object.
+  explicit StreamingVertexAligner(
+      const S2Polyline* b,
+      const StreamingAlignmentOptions& options = StreamingAlignmentOptions());
+
+  // Processes the next point of the stream, returning the (possibly empty)
+  // sequence of warp path entries committed as a result.
+  WarpPath AddVertex(const S2Point& a_vertex);
+
+  // Signals the end of the stream and returns the remaining warp path entries.
+  // Must be called exactly once, after at least one call to AddVertex().
+  WarpPath Finish();
+
+  // The summed cost of the emitted warp path, in the same units as
+  // VertexAlignment::alignment_cost. Only valid after Finish() is called.
+  double alignment_cost() const;
+
+ private:
+  // Dynamic programming state for one buffered row (one stream point). The
+  // vectors cover the band columns [start, start + costs.size()) of `b`.
+  struct RowState {
+    int start;                  // First column of `b` covered by this row.
+    std::vector<double> costs;  // Accumulated DP cost per band column.
+    std::vector<int> enter;     // Column at which the path enters this row.
+    std::vector<int> parent;    // Exit column in the previous row.
+  };
+
+  WarpPath CommitRows(bool commit_all);
+
+  const S2Polyline* b_;
+  StreamingAlignmentOptions options_;
+  std::deque<RowState> rows_;
+  int base_row_ = 0;  // Stream index of rows_.front().
+  bool finished_ = false;
+  double alignment_cost_ = 0;
+};
+
 // GetMedoidPolyline returns the index `p` of a "medoid" polyline from a
 // non-empty collection of `polylines` such that
 //
@@ -179,8 +270,17 @@ class MedoidOptions {
   bool approx() const { return approx_; }
   void set_approx(bool approx) { approx_ = approx; }
 
+  // options.num_threads controls the number of threads used to compute the
+  // pairwise alignment costs (each pairwise alignment is independent work).
+  // Note that the per-polyline cost sums are accumulated in a different order
+  // when more than one thread is used, so in the case of a floating-point tie
+  // the returned index may differ from the serial result.
+  int num_threads() const { return num_threads_; }
+  void set_num_threads(int num_threads) { num_threads_ = num_threads; }
+
  private:
   bool approx_ = true;
+  int num_threads_ = 1;
 };
 
 int GetMedoidPolyline(const std::vector<std::unique_ptr<S2Polyline>>& polylines,
@@ -233,10 +333,19 @@ class ConsensusOptions {
   int iteration_cap() const { return iteration_cap_; }
   void set_iteration_cap(int iteration_cap) { iteration_cap_ = iteration_cap; }
 
+  // options.num_threads controls the number of threads used to compute the
+  // per-polyline alignments within each refining step (and to compute the
+  // medoid seed, if requested).  The barycenter sums are accumulated in a
+  // different order when more than one thread is used, so the result may
+  // differ from the serial result by floating-point rounding.
+  int num_threads() const { return num_threads_; }
+  void set_num_threads(int num_threads) { num_threads_ = num_threads; }
+
  private:
   bool approx_ = true;
   bool seed_medoid_ = false;
   int iteration_cap_ = 5;
+  int num_threads_ = 1;
 };
 
 std::unique_ptr<S2Polyline> GetConsensusPolyline(
@@ -30,6 +30,7 @@
 
 #include "s2/s1angle.h"
 #include "s2/s2cap.h"
+#include "s2/s2latlng.h"
 #include "s2/s2point.h"
 #include "s2/s2polyline.h"
 #include "s2/s2polyline_alignment_internal.h"
@@ -486,6 +487,99 @@ TEST(S2PolylineAlignmentTest, FuzzedWithBruteForce) {
   }
 }
 
+// Feeds the vertices of `a` to a StreamingVertexAligner one at a time and
+// returns the concatenation of all emitted warp path prefixes.
+WarpPath StreamAlignment(const S2Polyline& a, const S2Polyline& b,
+                         const StreamingAlignmentOptions& options,
+                         double* cost) {
+  StreamingVertexAligner aligner(&b, options);
+  WarpPath path;
+  for (int i = 0; i < a.num_vertices(); ++i) {
+    for (const auto& pair : aligner.AddVertex(a.vertex(i))) {
+      path.push_back(pair);
+    }
+  }
+  for (const auto& pair : aligner.Finish()) {
+    path.push_back(pair);
+  }
+  *cost = aligner.alignment_cost();
+  return path;
+}
+
+TEST(S2PolylineAlignmentTest, StreamingMatchesExactWithGenerousBounds) {
+  // With a band wide enough to cover all of `b` and a latency cap longer than
+  // the stream, no prefix is forced out early and the streaming aligner
+  // reproduces the exact alignment of the header file example.
+  const auto a = s2textformat::MakePolylineOrDie("1:0, 5:0, 6:0, 9:0");
+  const auto b = s2textformat::MakePolylineOrDie("2:0, 7:0, 8:0");
+  StreamingAlignmentOptions options;
+  options.set_radius(10);
+  options.set_max_latency(10);
+  double cost;
+  const WarpPath path = StreamAlignment(*a, *b, options, &cost);
+  const VertexAlignment exact = GetExactVertexAlignment(*a, *b);
+  EXPECT_FLOAT_EQ(cost, exact.alignment_cost);
+  EXPECT_EQ(path, exact.warp_path);
+}
+
+TEST(S2PolylineAlignmentTest, StreamingIdenticalPolylinesAreDiagonal) {
+  // Aligning a stream against itself yields the zero-cost diagonal path even
+  // with a narrow band and frequent forced commits.
+  vector<S2Point> pts;
+  for (int i = 0; i < 12; ++i) {
+    pts.push_back(S2LatLng::FromDegrees(i, 2 * i).ToPoint());
+  }
+  const S2Polyline line(pts);
+  StreamingAlignmentOptions options;
+  options.set_radius(2);
+  options.set_max_latency(3);
+  double cost;
+  const WarpPath path = StreamAlignment(line, line, options, &cost);
+  ASSERT_EQ(path.size(), 12);
+  for (int i = 0; i < 12; ++i) {
+    EXPECT_EQ(path[i], std::make_pair(i, i));
+  }
+  EXPECT_FLOAT_EQ(cost, 0.0);
+}
+
+TEST(S2PolylineAlignmentTest, StreamingFuzzedPathsAreValid) {
+  // With a narrow band and a small latency cap the streaming result is an
+  // approximation, but the emitted entries must always form a valid warp path
+  // whose summed cost matches alignment_cost() and is never better than the
+  // exact alignment cost.
+  const int kNumPolylines = 5;
+  const int kNumVertices = 64;
+  const double kPerturbation = 1.5;
+  const auto lines = GenPolylines(kNumPolylines, kNumVertices, kPerturbation);
+  StreamingAlignmentOptions options;
+  options.set_radius(4);
+  options.set_max_latency(8);
+  for (int i = 0; i < kNumPolylines; ++i) {
+    for (int j = 0; j < kNumPolylines; ++j) {
+      if (i == j) continue;
+      double cost;
+      const WarpPath path = StreamAlignment(*lines[i], *lines[j], options,
+                                            &cost);
+      ASSERT_FALSE(path.empty());
+      EXPECT_EQ(path.front(), std::make_pair(0, 0));
+      EXPECT_EQ(path.back().first, kNumVertices - 1);
+      double path_cost = 0;
+      for (int k = 0; k < path.size(); ++k) {
+        path_cost += (lines[i]->vertex(path[k].first) -
+                      lines[j]->vertex(path[k].second)).Norm();
+        if (k == 0) continue;
+        const int d_row = path[k].first - path[k - 1].first;
+        const int d_col = path[k].second - path[k - 1].second;
+        EXPECT_TRUE((d_row == 0 && d_col == 1) || (d_row == 1 && d_col == 0) ||
+                    (d_row == 1 && d_col == 1))
+            << "Invalid step at index " << k;
+      }
+      EXPECT_FLOAT_EQ(cost, path_cost);
+      EXPECT_GE(cost, GetExactVertexAlignmentCost(*lines[i], *lines[j]));
+    }
+  }
+}
+
 // TESTS FOR TRAJECTORY CONSENSUS ALGORITHMS
 
 // Tests for GetMedoidPolyline
@@ -597,6 +691,21 @@ TEST(S2PolylineAlignmentTest, MedoidPolylineFewLargePolylines) {
   EXPECT_EQ(approx_medoid, approx_medoid_index);
 }
 
+TEST(S2PolylineAlignmentTest, MedoidPolylineMultiThreadedMatchesSerial) {
+  const int num_polylines = 16;
+  const int num_vertices = 64;
+  const double perturb = 0.9;
+  const auto polylines = GenPolylines(num_polylines, num_vertices, perturb);
+
+  MedoidOptions serial_opts;
+  const auto expected = GetMedoidPolyline(polylines, serial_opts);
+
+  MedoidOptions parallel_opts;
+  parallel_opts.set_num_threads(4);
+  const auto actual = GetMedoidPolyline(polylines, parallel_opts);
+  EXPECT_EQ(expected, actual);
+}
+
 // Tests for GetConsensusPolyline
 #if GTEST_HAS_DEATH_TEST
 TEST(S2PolylineAlignmentDeathTest, ConsensusPolylineNoPolylines) {
@@ -638,4 +747,21 @@ TEST(S2PolylineAlignmentTest, ConsensusPolylineOverlappingPolylines) {
   EXPECT_TRUE(result->ApproxEquals(*expected));
 }
 
+TEST(S2PolylineAlignmentTest, ConsensusPolylineMultiThreadedMatchesSerial) {
+  const int num_polylines = 12;
+  const int num_vertices = 48;
+  const double perturb = 0.5;
+  const auto polylines = GenPolylines(num_polylines, num_vertices, perturb);
+
+  ConsensusOptions serial_opts;
+  serial_opts.set_seed_medoid(true);
+  const auto expected = GetConsensusPolyline(polylines, serial_opts);
+
+  ConsensusOptions parallel_opts;
+  parallel_opts.set_seed_medoid(true);
+  parallel_opts.set_num_threads(4);
+  const auto actual = GetConsensusPolyline(polylines, parallel_opts);
+  EXPECT_TRUE(expected->ApproxEquals(*actual));
+}
+
 }  // namespace s2polyline_alignment
@@ -0,0 +1,68 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2polyline_streaming_simplifier.h"
+
+#include <optional>
+
+#include "s2/s1angle.h"
+#include "s2/s1chord_angle.h"
+#include "s2/s2point.h"
+
+S2StreamingPolylineSimplifier::S2StreamingPolylineSimplifier(S1Angle tolerance)
+    : S2StreamingPolylineSimplifier(tolerance, Options()) {}
+
+S2StreamingPolylineSimplifier::S2StreamingPolylineSimplifier(
+    S1Angle tolerance, const Options& options)
+    : tolerance_(tolerance), options_(options) {}
+
+std::optional<S2Point> S2StreamingPolylineSimplifier::AddPoint(
+    const S2Point& p) {
+  if (!started_) {
+    started_ = true;
+    simplifier_.Init(p);
+    last_ = p;
+    edge_vertices_ = 0;
+    // The first vertex is always part of the output.
+    return p;
+  }
+  std::optional<S2Point> emitted;
+  bool force = options_.max_edge_vertices() > 0 &&
+               edge_vertices_ >= options_.max_edge_vertices();
+  if (force || !simplifier_.Extend(p)) {
+    // The current output edge cannot be extended to "p"; it ends at the
+    // previous input vertex, which therefore becomes final.
+    emitted = last_;
+    simplifier_.Init(last_);
+    edge_vertices_ = 0;
+  }
+  // Constrain the (possibly restarted) output edge to pass near "p".  If the
+  // target cannot be satisfied, the next call to Extend() will fail and the
+  // edge will end here.
+  simplifier_.TargetDisc(p, tolerance_);
+  ++edge_vertices_;
+  last_ = p;
+  have_pending_ = true;
+  return emitted;
+}
+
+std::optional<S2Point> S2StreamingPolylineSimplifier::Finish() {
+  std::optional<S2Point> emitted;
+  if (started_ && have_pending_) emitted = last_;
+  started_ = false;
+  have_pending_ = false;
+  edge_vertices_ = 0;
+  return emitted;
+}
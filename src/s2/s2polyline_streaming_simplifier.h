@@ -0,0 +1,105 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// This is a helper class for simplifying polylines of unbounded length with
+// O(1) memory.  Unlike S2Polyline::SubsampleVertices, which requires the full
+// polyline in memory, this class consumes one vertex at a time and emits the
+// kept vertices as soon as they are known.  It is built on the disc-targeting
+// math of S2PolylineSimplifier, so each output edge is guaranteed to pass
+// within "tolerance" of every input vertex it replaces.
+//
+// Typical usage for a stream of points:
+//
+//   S2StreamingPolylineSimplifier simplifier(S1Angle::Degrees(1e-4));
+//   for (const S2Point& p : stream) {
+//     if (auto kept = simplifier.AddPoint(p)) Output(*kept);
+//   }
+//   if (auto kept = simplifier.Finish()) Output(*kept);
+//
+// Each call emits at most one vertex, and a vertex is emitted as soon as the
+// simplifier determines that no longer output edge can cover it.  With the
+// default options the lag (the number of input vertices consumed before a
+// given vertex is emitted or discarded) is unbounded for nearly-straight
+// input; set max_edge_vertices() to force emission after a fixed number of
+// input vertices when bounded lag matters more than maximum compression.
+//
+// Like the example in s2polyline_simplifier.h, this class simplifies
+// greedily: each output edge is extended as far as possible before starting
+// the next one.  The result is a valid simplification but not necessarily
+// the one with the fewest vertices.
+
+#ifndef S2_S2POLYLINE_STREAMING_SIMPLIFIER_H_
+#define S2_S2POLYLINE_STREAMING_SIMPLIFIER_H_
+
+#include <optional>
+
+#include "s2/_fp_contract_off.h"
+#include "s2/s1angle.h"
+#include "s2/s1chord_angle.h"
+#include "s2/s2point.h"
+#include "s2/s2polyline_simplifier.h"
+
+class S2StreamingPolylineSimplifier {
+ public:
+  class Options {
+   public:
+    Options() = default;
+
+    // The maximum number of input vertices that a single output edge may
+    // replace.  This bounds the emission lag: a vertex is emitted or
+    // discarded within max_edge_vertices() calls of being added.  A value of
+    // zero (the default) means unlimited.
+    //
+    // DEFAULT: 0 (unlimited)
+    int max_edge_vertices() const { return max_edge_vertices_; }
+    void set_max_edge_vertices(int max_edge_vertices) {
+      max_edge_vertices_ = max_edge_vertices;
+    }
+
+   private:
+    int max_edge_vertices_ = 0;
+  };
+
+  // Creates a simplifier where every output edge passes within "tolerance"
+  // of the input vertices it replaces.
+  explicit S2StreamingPolylineSimplifier(S1Angle tolerance);
+  S2StreamingPolylineSimplifier(S1Angle tolerance, const Options& options);
+
+  const Options& options() const { return options_; }
+  S1Angle tolerance() const { return tolerance_.ToAngle(); }
+
+  // Adds the next vertex of the input polyline.  Returns the next output
+  // vertex if one has become final, and std::nullopt otherwise.  The first
+  // input vertex is always emitted (as the first output vertex).
+  std::optional<S2Point> AddPoint(const S2Point& p);
+
+  // Indicates that the input polyline is complete and returns the last
+  // output vertex, if any.  (The result is std::nullopt only if fewer than
+  // two vertices were added.)  The simplifier is reset and may be
+  // reused for a new polyline.
+  std::optional<S2Point> Finish();
+
+ private:
+  S1ChordAngle tolerance_;
+  Options options_;
+
+  S2PolylineSimplifier simplifier_;
+  S2Point last_;            // The most recently added input vertex.
+  bool started_ = false;    // True if at least one vertex has been added.
+  bool have_pending_ = false;  // True if "last_" has not yet been emitted.
+  int edge_vertices_ = 0;   // Input vertices covered by the current edge.
+};
+
+#endif  // S2_S2POLYLINE_STREAMING_SIMPLIFIER_H_
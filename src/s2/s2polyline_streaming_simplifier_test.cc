@@ -0,0 +1,152 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2polyline_streaming_simplifier.h"
+
+#include <optional>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "absl/flags/flag.h"
+#include "s2/s1angle.h"
+#include "s2/s1chord_angle.h"
+#include "s2/s2edge_distances.h"
+#include "s2/s2point.h"
+#include "s2/s2polyline_simplifier.h"
+#include "s2/s2testing.h"
+#include "s2/s2text_format.h"
+
+using s2textformat::ParsePointsOrDie;
+using std::vector;
+
+namespace {
+
+// Feeds "input" to a streaming simplifier and returns the emitted vertices.
+vector<S2Point> Simplify(
+    const vector<S2Point>& input, S1Angle tolerance,
+    const S2StreamingPolylineSimplifier::Options& options = {}) {
+  S2StreamingPolylineSimplifier simplifier(tolerance, options);
+  vector<S2Point> output;
+  for (const S2Point& p : input) {
+    if (auto kept = simplifier.AddPoint(p)) output.push_back(*kept);
+  }
+  if (auto kept = simplifier.Finish()) output.push_back(*kept);
+  return output;
+}
+
+TEST(S2StreamingPolylineSimplifier, FirstVertexEmittedImmediately) {
+  S2StreamingPolylineSimplifier simplifier(S1Angle::Degrees(1));
+  S2Point p = ParsePointsOrDie("10:20")[0];
+  auto kept = simplifier.AddPoint(p);
+  ASSERT_TRUE(kept.has_value());
+  EXPECT_EQ(p, *kept);
+  EXPECT_FALSE(simplifier.Finish().has_value());
+}
+
+TEST(S2StreamingPolylineSimplifier, NearlyStraightLineCollapses) {
+  auto input = ParsePointsOrDie("0:0, 0:1, 0:2, 0:3, 0:4, 0:5");
+  auto output = Simplify(input, S1Angle::Degrees(0.01));
+  ASSERT_EQ(2, output.size());
+  EXPECT_EQ(input.front(), output.front());
+  EXPECT_EQ(input.back(), output.back());
+}
+
+TEST(S2StreamingPolylineSimplifier, ZigzagBeyondToleranceIsKept) {
+  auto input = ParsePointsOrDie("0:0, 1:1, 0:2, 1:3, 0:4");
+  auto output = Simplify(input, S1Angle::Degrees(0.1));
+  EXPECT_EQ(input, output);
+}
+
+TEST(S2StreamingPolylineSimplifier, MatchesBatchGreedySimplification) {
+  // The streaming simplifier implements exactly the loop documented in
+  // s2polyline_simplifier.h, so the outputs must be identical.
+  S2Testing::rnd.Reset(absl::GetFlag(FLAGS_s2_random_seed));
+  const S1Angle tolerance = S1Angle::Degrees(0.05);
+  for (int iter = 0; iter < 20; ++iter) {
+    vector<S2Point> v;
+    S2Point p = S2Testing::RandomPoint();
+    v.push_back(p);
+    for (int i = 0; i < 200; ++i) {
+      p = S2::GetPointOnLine(p, S2Testing::RandomPoint(),
+                             S1Angle::Degrees(0.02 * S2Testing::rnd.RandDouble()));
+      v.push_back(p);
+    }
+    vector<S2Point> expected;
+    S2PolylineSimplifier batch;
+    batch.Init(v[0]);
+    expected.push_back(v[0]);
+    for (size_t i = 1; i < v.size(); ++i) {
+      if (!batch.Extend(v[i])) {
+        expected.push_back(v[i - 1]);
+        batch.Init(v[i - 1]);
+      }
+      batch.TargetDisc(v[i], S1ChordAngle(tolerance));
+    }
+    expected.push_back(v.back());
+    EXPECT_EQ(expected, Simplify(v, tolerance));
+  }
+}
+
+TEST(S2StreamingPolylineSimplifier, OutputStaysWithinTolerance) {
+  S2Testing::rnd.Reset(absl::GetFlag(FLAGS_s2_random_seed));
+  const S1Angle tolerance = S1Angle::Degrees(0.1);
+  vector<S2Point> v;
+  S2Point p = S2Testing::RandomPoint();
+  v.push_back(p);
+  for (int i = 0; i < 500; ++i) {
+    p = S2::GetPointOnLine(p, S2Testing::RandomPoint(),
+                           S1Angle::Degrees(0.05 * S2Testing::rnd.RandDouble()));
+    v.push_back(p);
+  }
+  auto output = Simplify(v, tolerance);
+  ASSERT_GE(output.size(), 2);
+  for (const S2Point& x : v) {
+    S1ChordAngle min_dist = S1ChordAngle::Infinity();
+    for (size_t i = 0; i + 1 < output.size(); ++i) {
+      S2::UpdateMinDistance(x, output[i], output[i + 1], &min_dist);
+    }
+    EXPECT_LE(min_dist.ToAngle(), tolerance * 1.0001);
+  }
+}
+
+TEST(S2StreamingPolylineSimplifier, MaxEdgeVerticesBoundsLag) {
+  S2StreamingPolylineSimplifier::Options options;
+  options.set_max_edge_vertices(3);
+  auto input = ParsePointsOrDie(
+      "0:0, 0:1, 0:2, 0:3, 0:4, 0:5, 0:6, 0:7, 0:8, 0:9");
+  S2StreamingPolylineSimplifier simplifier(S1Angle::Degrees(0.01), options);
+  int pending = 0;
+  for (const S2Point& p : input) {
+    ++pending;
+    if (simplifier.AddPoint(p).has_value()) pending = 1;
+    // A vertex becomes final within max_edge_vertices() calls of being added.
+    EXPECT_LE(pending, options.max_edge_vertices() + 1);
+  }
+}
+
+TEST(S2StreamingPolylineSimplifier, ReusableAfterFinish) {
+  S2StreamingPolylineSimplifier simplifier(S1Angle::Degrees(0.01));
+  auto input = ParsePointsOrDie("0:0, 0:1, 0:2");
+  for (int pass = 0; pass < 2; ++pass) {
+    vector<S2Point> output;
+    for (const S2Point& p : input) {
+      if (auto kept = simplifier.AddPoint(p)) output.push_back(*kept);
+    }
+    if (auto kept = simplifier.Finish()) output.push_back(*kept);
+    EXPECT_EQ(2, output.size());
+  }
+}
+
+}  // namespace
@@ -23,7 +23,9 @@
 #include <ostream>
 #include <utility>
 
+#include "absl/base/casts.h"
 #include "absl/log/absl_check.h"
+#include "s2/base/types.h"
 #include "s2/s1chord_angle.h"
 #include "s2/s2edge_crossings.h"
 #include "s2/s2point.h"
@@ -47,6 +49,25 @@ int Sign(const S2Point& a, const S2Point& b, const S2Point& c) {
   return Sign(a, b, c, a.CrossProd(b));
 }
 
+void SignChain(absl::Span<const S2Point> vertices, absl::Span<int> signs) {
+  ABSL_DCHECK_EQ(signs.size() + 2, vertices.size());
+
+  // First pass: evaluate the triage determinants in one tight loop, which
+  // keeps the (branch-predictable) error-bound test and the surrounding
+  // vector arithmetic in registers.  TriageSign() decides almost all triples.
+  const size_t n = signs.size();
+  for (size_t i = 0; i < n; ++i) {
+    signs[i] = TriageSign(vertices[i], vertices[i + 1], vertices[i + 2],
+                          vertices[i].CrossProd(vertices[i + 1]));
+  }
+  // Second pass: resolve the rare uncertain triples exactly.
+  for (size_t i = 0; i < n; ++i) {
+    if (signs[i] == 0) {
+      signs[i] = ExpensiveSign(vertices[i], vertices[i + 1], vertices[i + 2]);
+    }
+  }
+}
+
 // Compute the determinant in a numerically stable way.  Unlike TriageSign(),
 // this method can usually compute the correct determinant sign even when all
 // three points are as collinear as possible.  For example if three points are
@@ -60,13 +81,15 @@ int Sign(const S2Point& a, const S2Point& b, const S2Point& c) {
 // in fact an earlier version of this code did exactly that), but antipodal
 // points are rare in practice so it seems better to simply fall back to
 // exact arithmetic in that case.
-int StableSign(const S2Point& a, const S2Point& b, const S2Point& c) {
-  Vector3_d ab = b - a;
-  Vector3_d bc = c - b;
-  Vector3_d ca = a - c;
-  double ab2 = ab.Norm2();
-  double bc2 = bc.Norm2();
-  double ca2 = ca.Norm2();
+template <class T>
+static int StableSign(const Vector3<T>& a, const Vector3<T>& b,
+                      const Vector3<T>& c) {
+  Vector3<T> ab = b - a;
+  Vector3<T> bc = c - b;
+  Vector3<T> ca = a - c;
+  T ab2 = ab.Norm2();
+  T bc2 = bc.Norm2();
+  T ca2 = ca.Norm2();
 
   // Now compute the determinant ((A-C)x(B-C)).C, where the vertices have been
   // cyclically permuted if necessary so that AB is the longest edge.  (This
@@ -76,10 +99,10 @@ int StableSign(const S2Point& a, const S2Point& b, const S2Point& c) {
   //
   //   |d| <= (3 + 6/sqrt(3)) * |A-C| * |B-C| * e
   //
-  // where e = 0.5 * DBL_EPSILON.  If the determinant magnitude is larger than
-  // this value then we know its sign with certainty.
-  const double kDetErrorMultiplier = 3.2321 * DBL_EPSILON;  // see above
-  double det, max_error;
+  // where e = rounding_epsilon<T>().  If the determinant magnitude is larger
+  // than this value then we know its sign with certainty.
+  const T kDetErrorMultiplier = 6.4642 * rounding_epsilon<T>();  // see above
+  T det, max_error;
   if (ab2 >= bc2 && ab2 >= ca2) {
     // AB is the longest edge, so compute (A-C)x(B-C).C.
     det = -(ca.CrossProd(bc).DotProd(c));
@@ -94,12 +117,17 @@ int StableSign(const S2Point& a, const S2Point& b, const S2Point& c) {
     max_error = kDetErrorMultiplier * sqrt(bc2 * ab2);
   }
   // Errors smaller than this value may not be accurate due to underflow.
-  const double kMinNoUnderflowError = kDetErrorMultiplier * sqrt(DBL_MIN);
+  const T kMinNoUnderflowError =
+      kDetErrorMultiplier * sqrt(std::numeric_limits<T>::min());
   if (max_error < kMinNoUnderflowError) return 0;
 
   return (fabs(det) <= max_error) ? 0 : (det > 0) ? 1 : -1;
 }
 
+int StableSign(const S2Point& a, const S2Point& b, const S2Point& c) {
+  return StableSign<double>(a, b, c);
+}
+
 // The following function returns the sign of the determinant of three points
 // A, B, C under a model where every possible S2Point is slightly perturbed by
 // a unique infinitesmal amount such that no three perturbed points are
@@ -220,6 +248,85 @@ int SymbolicallyPerturbedSign(
   return 1;                                     // dc[2] * db[1] * da[0]
 }
 
+namespace {
+
+// The bounded thread-local memo table used by ScopedExactSignCache.  The
+// table is direct-mapped: each triple hashes to a single slot, which is
+// simply overwritten on collision.  This bounds the memory per thread to
+// the size of the table and keeps lookups and insertions branch-light, at
+// the cost of some evictions; snap-heavy workloads re-evaluate a small
+// working set of degenerate triples, which is exactly what a direct-mapped
+// table retains well.
+class ExactSignCache {
+ public:
+  // Returns true and sets "*sign" if a result for this key is cached.
+  bool Lookup(const S2Point& a, const S2Point& b, const S2Point& c,
+              bool perturb, int* sign) const {
+    const Entry& entry = entries_[Slot(a, b, c, perturb)];
+    if (!entry.valid || entry.perturb != perturb || entry.a != a ||
+        entry.b != b || entry.c != c) {
+      return false;
+    }
+    *sign = entry.sign;
+    return true;
+  }
+
+  void Insert(const S2Point& a, const S2Point& b, const S2Point& c,
+              bool perturb, int sign) {
+    Entry& entry = entries_[Slot(a, b, c, perturb)];
+    entry.a = a;
+    entry.b = b;
+    entry.c = c;
+    entry.perturb = perturb;
+    entry.sign = sign;
+    entry.valid = true;
+  }
+
+ private:
+  struct Entry {
+    S2Point a, b, c;
+    int sign = 0;
+    bool perturb = false;
+    bool valid = false;
+  };
+  static constexpr int kNumSlots = 1024;  // Must be a power of two.
+
+  static size_t Slot(const S2Point& a, const S2Point& b, const S2Point& c,
+                     bool perturb) {
+    // Multiplicative hash over the bit patterns of the nine coordinates.
+    uint64 h = perturb ? 0x9ddfea08eb382d69ULL : 0;
+    for (const S2Point* p : {&a, &b, &c}) {
+      for (int i = 0; i < 3; ++i) {
+        h = (h ^ absl::bit_cast<uint64>((*p)[i])) * 0x9ddfea08eb382d69ULL;
+        h ^= h >> 32;
+      }
+    }
+    return h & (kNumSlots - 1);
+  }
+
+  Entry entries_[kNumSlots];
+};
+
+// The cache is reference-counted so that nested scopes on the same thread
+// share one table.
+thread_local ExactSignCache* exact_sign_cache = nullptr;
+thread_local int exact_sign_cache_depth = 0;
+
+}  // namespace
+
+ScopedExactSignCache::ScopedExactSignCache() {
+  if (exact_sign_cache_depth++ == 0) {
+    exact_sign_cache = new ExactSignCache;
+  }
+}
+
+ScopedExactSignCache::~ScopedExactSignCache() {
+  if (--exact_sign_cache_depth == 0) {
+    delete exact_sign_cache;
+    exact_sign_cache = nullptr;
+  }
+}
+
 // Compute the determinant using exact arithmetic and/or symbolic
 // permutations.  Requires that the three points are distinct.
 int ExactSign(const S2Point& a, const S2Point& b, const S2Point& c,
@@ -236,6 +343,15 @@ int ExactSign(const S2Point& a, const S2Point& b, const S2Point& c,
   if (*pa > *pb) { swap(pa, pb); perm_sign = -perm_sign; }
   ABSL_DCHECK(*pa < *pb && *pb < *pc);
 
+  // If a scoped cache is active, check it before doing any multiple-
+  // precision arithmetic.  Keying on the sorted triple means that all six
+  // argument orders of the same three points share a single entry.
+  int det_sign;
+  if (exact_sign_cache != nullptr &&
+      exact_sign_cache->Lookup(*pa, *pb, *pc, perturb, &det_sign)) {
+    return perm_sign * det_sign;
+  }
+
   // Construct multiple-precision versions of the sorted points and compute
   // their exact 3x3 determinant.
   Vector3_xf xa = ToExact(*pa);
@@ -250,13 +366,16 @@ int ExactSign(const S2Point& a, const S2Point& b, const S2Point& c,
   ABSL_DCHECK_LT(det.prec(), det.max_prec());
 
   // If the exact determinant is non-zero, we're done.
-  int det_sign = det.sgn();
+  det_sign = det.sgn();
   if (det_sign == 0 && perturb) {
     // Otherwise, we need to resort to symbolic perturbations to resolve the
     // sign of the determinant.
     det_sign = SymbolicallyPerturbedSign(xa, xb, xc, xb_cross_xc);
     ABSL_DCHECK_NE(0, det_sign);
   }
+  if (exact_sign_cache != nullptr) {
+    exact_sign_cache->Insert(*pa, *pb, *pc, perturb, det_sign);
+  }
   return perm_sign * det_sign;
 }
 
@@ -285,8 +404,15 @@ int ExpensiveSign(const S2Point& a, const S2Point& b, const S2Point& c,
   int det_sign = StableSign(a, b, c);
   if (det_sign != 0) return det_sign;
 
-  // TODO(ericv): Create a templated version of StableSign so that we can
-  // retry in "long double" precision before falling back to ExactFloat.
+  // Retry in "long double" precision before falling back to ExactFloat.
+  // On platforms where "long double" has extra precision this resolves
+  // virtually all remaining cases (e.g. points snapped to a grid and then
+  // revalidated), avoiding the multiple-precision arithmetic below and the
+  // memory allocations it performs.
+  if (kHasLongDouble) {
+    det_sign = StableSign(ToLD(a), ToLD(b), ToLD(c));
+    if (det_sign != 0) return det_sign;
+  }
 
   // TODO(ericv): Optimize ExactFloat so that it stores up to 32 bytes of
   // mantissa inline (without requiring memory allocation).
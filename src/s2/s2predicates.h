@@ -54,6 +54,7 @@
 
 #include "absl/flags/flag.h"
 #include "absl/log/absl_check.h"
+#include "absl/types/span.h"
 #include "s2/_fp_contract_off.h"
 #include "s2/s1chord_angle.h"
 #include "s2/s2debug.h"
@@ -86,6 +87,42 @@ namespace s2pred {
 // involving antipodal points.
 int Sign(const S2Point& a, const S2Point& b, const S2Point& c);
 
+// Like Sign(), but evaluates every consecutive vertex triple of a chain:
+//
+//   signs[i] = Sign(vertices[i], vertices[i+1], vertices[i+2])
+//
+// This is faster than calling Sign() on each triple separately because the
+// triage determinants (which almost always decide the result) are computed
+// in a single tight loop, and the expensive exact predicate is invoked in a
+// second pass only for the rare uncertain triples.
+//
+// REQUIRES: signs.size() + 2 == vertices.size()
+void SignChain(absl::Span<const S2Point> vertices, absl::Span<int> signs);
+
+// While an instance of this class exists, the results of the exact
+// arbitrary-precision path of Sign() are memoized in a bounded, thread-local
+// table.  Snap-heavy operations such as S2Builder evaluate the same
+// degenerate vertex triples many times (shared vertices appear in many
+// triples), and each exact evaluation performs multiple-precision arithmetic
+// and memory allocation, so memoizing them can be a significant win.  The
+// cache only affects triples that reach the exact path; the fast triage
+// path is already much cheaper than any table lookup.
+//
+// The cache is keyed on the point coordinates (not addresses), uses a fixed
+// amount of memory per thread, and is discarded when the outermost scope on
+// the thread is destroyed.  Scopes may be nested.  Typical usage:
+//
+//   s2pred::ScopedExactSignCache cache;
+//   builder.Build(...);  // Exact sign results are now reused.
+class ScopedExactSignCache {
+ public:
+  ScopedExactSignCache();
+  ~ScopedExactSignCache();
+
+  ScopedExactSignCache(const ScopedExactSignCache&) = delete;
+  ScopedExactSignCache& operator=(const ScopedExactSignCache&) = delete;
+};
+
 // Given 4 points on the unit sphere, return true if the edges OA, OB, and
 // OC are encountered in that order while sweeping CCW around the point O.
 // You can think of this as testing whether A <= B <= C with respect to the
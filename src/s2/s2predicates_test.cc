@@ -130,6 +130,62 @@ TEST(Sign, CollinearPoints) {
   EXPECT_EQ(Sign(y1, y2, -y1), -Sign(-y1, y2, y1));
 }
 
+TEST(Sign, ScopedExactSignCacheMatchesUncached) {
+  // These triples all reach the exact arbitrary-precision path (they are the
+  // collinear configurations from CollinearPoints above).
+  S2Point a(0.72571927877036835, 0.46058825605889098, 0.51106749730504852);
+  S2Point b(0.7257192746638208, 0.46058826573818168, 0.51106749441312738);
+  S2Point c(0.72571927671709457, 0.46058826089853633, 0.51106749585908795);
+  S2Point x1(0.99999999999999989, 1.4901161193847655e-08, 0);
+  S2Point x2(1, 1.4901161193847656e-08, 0);
+
+  const int abc = Sign(a, b, c);
+  const int x12 = Sign(x1, x2, -x1);
+  {
+    ScopedExactSignCache cache;
+    for (int i = 0; i < 3; ++i) {
+      // The first iteration populates the cache; later iterations hit it.
+      EXPECT_EQ(Sign(a, b, c), abc);
+      EXPECT_EQ(Sign(b, c, a), abc);
+      EXPECT_EQ(Sign(c, b, a), -abc);
+      EXPECT_EQ(Sign(x1, x2, -x1), x12);
+      ScopedExactSignCache nested;
+      EXPECT_EQ(Sign(x2, -x1, x1), x12);
+    }
+  }
+  // Results are unchanged after the cache is destroyed.
+  EXPECT_EQ(Sign(a, b, c), abc);
+  EXPECT_EQ(Sign(x1, x2, -x1), x12);
+}
+
+TEST(Sign, SignChainMatchesSign) {
+  // Checks the batch chain evaluation against per-triple Sign() calls, using
+  // chains of nearby random points as well as degenerate chains (collinear
+  // and repeated vertices) that force the exact predicate to be used.
+  for (int iter = 0; iter < 100; ++iter) {
+    vector<S2Point> vertices;
+    S2Point v = S2Testing::RandomPoint();
+    for (int i = 0; i < 12; ++i) {
+      vertices.push_back(v);
+      switch (S2Testing::rnd.Uniform(3)) {
+        case 0:  // A nearby point.
+          v = (v + 1e-10 * S2Testing::RandomPoint()).Normalize();
+          break;
+        case 1:  // A repeated vertex (Sign() == 0 is resolved exactly).
+          break;
+        default:
+          v = S2Testing::RandomPoint();
+      }
+    }
+    vector<int> signs(vertices.size() - 2);
+    SignChain(vertices, absl::MakeSpan(signs));
+    for (size_t i = 0; i + 2 < vertices.size(); ++i) {
+      EXPECT_EQ(signs[i],
+                Sign(vertices[i], vertices[i + 1], vertices[i + 2]));
+    }
+  }
+}
+
 TEST(Sign, StableSignUnderflow) {
   // Verify that StableSign returns zero (indicating that the result is
   // uncertain) when its error calculation underflows.
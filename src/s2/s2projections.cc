@@ -18,7 +18,10 @@
 #include "s2/s2projections.h"
 
 #include <cmath>
+#include <cstddef>
 
+#include "absl/log/absl_check.h"
+#include "absl/types/span.h"
 #include "s2/r2.h"
 #include "s2/s1angle.h"
 #include "s2/s2latlng.h"
@@ -48,6 +51,23 @@ R2Point Projection::Interpolate(double f,
   return (1 - f) * a + f * b;
 }
 
+// Default implementations that simply convert one point per call.
+void Projection::ProjectBatch(absl::Span<const S2Point> points,
+                              absl::Span<R2Point> out) const {
+  ABSL_DCHECK_EQ(points.size(), out.size());
+  for (size_t i = 0; i < points.size(); ++i) {
+    out[i] = Project(points[i]);
+  }
+}
+
+void Projection::UnprojectBatch(absl::Span<const R2Point> points,
+                                absl::Span<S2Point> out) const {
+  ABSL_DCHECK_EQ(points.size(), out.size());
+  for (size_t i = 0; i < points.size(); ++i) {
+    out[i] = Unproject(points[i]);
+  }
+}
+
 PlateCarreeProjection::PlateCarreeProjection(double x_scale)
     : x_wrap_(2 * x_scale),
       to_radians_(M_PI / x_scale),
@@ -72,6 +92,30 @@ S2LatLng PlateCarreeProjection::ToLatLng(const R2Point& p) const {
                                to_radians_ * remainder(p.x(), x_wrap_));
 }
 
+// The batch methods below expand the per-point conversions inline so that
+// the loop body contains no virtual calls; the formulas (and therefore the
+// results) are identical to the single-point methods above.
+void PlateCarreeProjection::ProjectBatch(absl::Span<const S2Point> points,
+                                         absl::Span<R2Point> out) const {
+  ABSL_DCHECK_EQ(points.size(), out.size());
+  for (size_t i = 0; i < points.size(); ++i) {
+    const S2LatLng ll(points[i]);
+    out[i] = R2Point(from_radians_ * ll.lng().radians(),
+                     from_radians_ * ll.lat().radians());
+  }
+}
+
+void PlateCarreeProjection::UnprojectBatch(absl::Span<const R2Point> points,
+                                           absl::Span<S2Point> out) const {
+  ABSL_DCHECK_EQ(points.size(), out.size());
+  for (size_t i = 0; i < points.size(); ++i) {
+    const R2Point& p = points[i];
+    out[i] = S2LatLng::FromRadians(to_radians_ * p.y(),
+                                   to_radians_ * remainder(p.x(), x_wrap_))
+                 .ToPoint();
+  }
+}
+
 R2Point PlateCarreeProjection::wrap_distance() const {
   return R2Point(x_wrap_, 0);
 }
@@ -106,6 +150,30 @@ S2LatLng MercatorProjection::ToLatLng(const R2Point& p) const {
   return S2LatLng::FromRadians(y, x);
 }
 
+// See the comment above the PlateCarreeProjection batch methods.
+void MercatorProjection::ProjectBatch(absl::Span<const S2Point> points,
+                                      absl::Span<R2Point> out) const {
+  ABSL_DCHECK_EQ(points.size(), out.size());
+  for (size_t i = 0; i < points.size(); ++i) {
+    const S2LatLng ll(points[i]);
+    double sin_phi = sin(ll.lat());
+    double y = 0.5 * log((1 + sin_phi) / (1 - sin_phi));
+    out[i] = R2Point(from_radians_ * ll.lng().radians(), from_radians_ * y);
+  }
+}
+
+void MercatorProjection::UnprojectBatch(absl::Span<const R2Point> points,
+                                        absl::Span<S2Point> out) const {
+  ABSL_DCHECK_EQ(points.size(), out.size());
+  for (size_t i = 0; i < points.size(); ++i) {
+    const R2Point& p = points[i];
+    double x = to_radians_ * remainder(p.x(), x_wrap_);
+    double k = exp(2 * to_radians_ * p.y());
+    double y = std::isinf(k) ? M_PI_2 : asin((k - 1) / (k + 1));
+    out[i] = S2LatLng::FromRadians(y, x).ToPoint();
+  }
+}
+
 R2Point MercatorProjection::wrap_distance() const {
   return R2Point(x_wrap_, 0);
 }
@@ -24,6 +24,7 @@
 
 #include <cmath>
 
+#include "absl/types/span.h"
 #include "s2/r2.h"
 #include "s2/s2latlng.h"
 #include "s2/s2point.h"
@@ -46,6 +47,24 @@ class Projection {
   // should accept any real number for the corresponding coordinate.
   virtual S2Point Unproject(const R2Point& p) const = 0;
 
+  // Converts each element of "points" to a projected 2D point, storing the
+  // result in the corresponding element of "out".  The results are identical
+  // to calling Project() on each point, but implementations may process the
+  // points more efficiently (e.g., avoiding a virtual call per point).
+  //
+  // REQUIRES: points.size() == out.size()
+  virtual void ProjectBatch(absl::Span<const S2Point> points,
+                            absl::Span<R2Point> out) const;
+
+  // Converts each element of "points" to a point on the sphere, storing the
+  // result in the corresponding element of "out".  The results are identical
+  // to calling Unproject() on each point, but implementations may process
+  // the points more efficiently.
+  //
+  // REQUIRES: points.size() == out.size()
+  virtual void UnprojectBatch(absl::Span<const R2Point> points,
+                              absl::Span<S2Point> out) const;
+
   // Convenience function equivalent to Project(ll.ToPoint()), but the
   // implementation may be more efficient.
   virtual R2Point FromLatLng(const S2LatLng& ll) const = 0;
@@ -114,6 +133,10 @@ class PlateCarreeProjection final : public Projection {
 
   R2Point Project(const S2Point& p) const override;
   S2Point Unproject(const R2Point& p) const override;
+  void ProjectBatch(absl::Span<const S2Point> points,
+                    absl::Span<R2Point> out) const override;
+  void UnprojectBatch(absl::Span<const R2Point> points,
+                      absl::Span<S2Point> out) const override;
   R2Point FromLatLng(const S2LatLng& ll) const override;
   S2LatLng ToLatLng(const R2Point& p) const override;
   R2Point wrap_distance() const override;
@@ -147,6 +170,10 @@ class MercatorProjection final : public Projection {
 
   R2Point Project(const S2Point& p) const override;
   S2Point Unproject(const R2Point& p) const override;
+  void ProjectBatch(absl::Span<const S2Point> points,
+                    absl::Span<R2Point> out) const override;
+  void UnprojectBatch(absl::Span<const R2Point> points,
+                      absl::Span<S2Point> out) const override;
   R2Point FromLatLng(const S2LatLng& ll) const override;
   S2LatLng ToLatLng(const R2Point& p) const override;
   R2Point wrap_distance() const override;
@@ -17,10 +17,13 @@
 
 #include "s2/s2projections.h"
 
+#include <cstddef>
 #include <limits>
 #include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
+#include "absl/types/span.h"
 #include "s2/r2.h"
 #include "s2/s2latlng.h"
 #include "s2/s2point.h"
@@ -78,4 +81,35 @@ TEST(MercatorProjection, ProjectUnproject) {
                        S2LatLng::FromRadians(1, 0).ToPoint());
 }
 
+// Verifies that the batch methods produce exactly the same results as the
+// corresponding single-point methods.
+void TestBatchMatchesSinglePoint(const Projection& projection) {
+  std::vector<S2Point> points;
+  for (double lat : {-89.9, -45.0, 0.0, 1e-10, 30.5, 89.9}) {
+    for (double lng : {-179.0, -90.0, 0.0, 60.25, 180.0}) {
+      points.push_back(S2LatLng::FromDegrees(lat, lng).ToPoint());
+    }
+  }
+  std::vector<R2Point> projected(points.size());
+  projection.ProjectBatch(points, absl::MakeSpan(projected));
+  for (size_t i = 0; i < points.size(); ++i) {
+    EXPECT_EQ(projection.Project(points[i]), projected[i]);
+  }
+  std::vector<S2Point> unprojected(points.size());
+  projection.UnprojectBatch(projected, absl::MakeSpan(unprojected));
+  for (size_t i = 0; i < points.size(); ++i) {
+    EXPECT_EQ(projection.Unproject(projected[i]), unprojected[i]);
+  }
+}
+
+TEST(PlateCarreeProjection, BatchMatchesSinglePoint) {
+  PlateCarreeProjection proj(180);
+  TestBatchMatchesSinglePoint(proj);
+}
+
+TEST(MercatorProjection, BatchMatchesSinglePoint) {
+  MercatorProjection proj(180);
+  TestBatchMatchesSinglePoint(proj);
+}
+
 }  //  namespace S2
@@ -0,0 +1,28 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2region.h"
+
+#include <cstddef>
+
+#include "absl/types/span.h"
+#include "s2/s2cell.h"
+
+void S2Region::MayIntersectCells(absl::Span<const S2Cell> cells,
+                                 bool* may_intersect) const {
+  for (size_t i = 0; i < cells.size(); ++i) {
+    may_intersect[i] = MayIntersect(cells[i]);
+  }
+}
@@ -20,6 +20,7 @@
 
 #include <vector>
 
+#include "absl/types/span.h"
 #include "s2/_fp_contract_off.h"
 #include "s2/s1angle.h"
 #include "s2/s2point.h"
@@ -95,6 +96,18 @@ class S2Region {
   // returns true if the region intersect the cell and false otherwise.
   virtual bool MayIntersect(const S2Cell& cell) const = 0;
 
+  // Computes MayIntersect(cells[i]) for a batch of cells at once, writing
+  // the result for cells[i] into may_intersect[i].  The default
+  // implementation simply calls MayIntersect() once per cell; subtypes that
+  // can answer several nearby cells with shared work override it (see
+  // S2ShapeIndexRegion).  S2RegionCoverer evaluates each frontier of
+  // candidate cells through this method.
+  //
+  // REQUIRES: the cells are sorted by S2CellId and non-overlapping.
+  // REQUIRES: "may_intersect" points to an array of cells.size() elements.
+  virtual void MayIntersectCells(absl::Span<const S2Cell> cells,
+                                 bool* may_intersect) const;
+
   // Returns true if and only if the given point is contained by the region.
   // The point 'p' is generally required to be unit length, although some
   // subtypes may relax this restriction.
@@ -18,6 +18,8 @@
 #include "s2/s2region_coverer.h"
 
 #include <algorithm>
+#include <memory>
+#include <new>
 #include <utility>
 #include <vector>
 
@@ -29,6 +31,7 @@
 #include "s2/s2cell.h"
 #include "s2/s2cell_id.h"
 #include "s2/s2cell_union.h"
+#include "s2/s2executor.h"
 #include "s2/s2point.h"
 #include "s2/s2region.h"
 
@@ -80,13 +83,23 @@ void S2RegionCoverer::Options::set_level_mod(int level_mod) {
   level_mod_ = max(1, min(3, level_mod));
 }
 
+void S2RegionCoverer::Options::set_num_threads(int num_threads) {
+  ABSL_DCHECK_GE(num_threads, 1);
+  num_threads_ = max(1, num_threads);
+}
+
 int S2RegionCoverer::Options::true_max_level() const {
   if (level_mod_ == 1) return max_level_;
   return max_level_ - (max_level_ - min_level_) % level_mod_;
 }
 
-S2RegionCoverer::Candidate* S2RegionCoverer::NewCandidate(const S2Cell& cell) {
-  if (!region_->MayIntersect(cell)) return nullptr;
+S2RegionCoverer::Candidate* S2RegionCoverer::NewCandidate(
+    const S2Cell& cell, bool known_to_intersect) {
+  if (!known_to_intersect && !region_->MayIntersect(cell)) return nullptr;
+
+  // Skip cells whose area is already covered by a reused cell, since the
+  // reused cell is part of the output (see GetIncrementalCovering).
+  if (reused_ != nullptr && reused_->Contains(cell.id())) return nullptr;
 
   bool is_terminal = false;
   if (cell.level() >= options_.min_level()) {
@@ -105,16 +118,31 @@ S2RegionCoverer::Candidate* S2RegionCoverer::NewCandidate(const S2Cell& cell) {
   }
   ++candidates_created_counter_;
   const std::size_t max_children = is_terminal ? 0 : 1 << max_children_shift();
-  return new (max_children) Candidate(cell, max_children);
+  void* storage = arena_.Alloc(sizeof(Candidate) +
+                               max_children * sizeof(Candidate*));
+  return new (storage) Candidate(cell, max_children);
 }
 
-void S2RegionCoverer::DeleteCandidate(Candidate* candidate,
-                                      bool delete_children) {
-  if (delete_children) {
-    for (int i = 0; i < candidate->num_children; ++i)
-      DeleteCandidate(candidate->children[i], true);
+void* S2RegionCoverer::CandidateArena::Alloc(std::size_t size) {
+  // Round up so that all allocations remain suitably aligned.
+  size = (size + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1);
+  ABSL_DCHECK_LE(size, kBlockSize);
+  if (static_cast<std::size_t>(block_end_ - block_pos_) < size) {
+    if (next_block_ == blocks_.size()) {
+      blocks_.push_back(std::make_unique<char[]>(kBlockSize));
+    }
+    block_pos_ = blocks_[next_block_].get();
+    block_end_ = block_pos_ + kBlockSize;
+    ++next_block_;
   }
-  delete candidate;
+  void* result = block_pos_;
+  block_pos_ += size;
+  return result;
+}
+
+void S2RegionCoverer::CandidateArena::Reset() {
+  next_block_ = 0;
+  block_pos_ = block_end_ = nullptr;
 }
 
 int S2RegionCoverer::ExpandChildren(Candidate* candidate,
@@ -122,15 +150,18 @@ int S2RegionCoverer::ExpandChildren(Candidate* candidate,
   num_levels--;
   S2Cell child_cells[4];
   cell.Subdivide(child_cells);
+  // Test the whole frontier of children at once; regions backed by an index
+  // can resolve nearby cells together (see S2Region::MayIntersectCells).
+  bool may_intersect[4];
+  region_->MayIntersectCells(child_cells, may_intersect);
   int num_terminals = 0;
   for (int i = 0; i < 4; ++i) {
+    if (!may_intersect[i]) continue;
     if (num_levels > 0) {
-      if (region_->MayIntersect(child_cells[i])) {
-        num_terminals += ExpandChildren(candidate, child_cells[i], num_levels);
-      }
+      num_terminals += ExpandChildren(candidate, child_cells[i], num_levels);
       continue;
     }
-    Candidate* child = NewCandidate(child_cells[i]);
+    Candidate* child = NewCandidate(child_cells[i], /*known_to_intersect=*/true);
     if (child) {
       candidate->children[candidate->num_children++] = child;
       if (child->is_terminal) ++num_terminals;
@@ -143,8 +174,9 @@ void S2RegionCoverer::AddCandidate(Candidate* candidate) {
   if (candidate == nullptr) return;
 
   if (candidate->is_terminal) {
+    // The candidate itself is abandoned; its storage is reclaimed when the
+    // arena is reset at the end of the covering.
     result_.push_back(candidate->cell.id());
-    DeleteCandidate(candidate, true);
     return;
   }
   ABSL_DCHECK_EQ(0, candidate->num_children);
@@ -156,7 +188,7 @@ void S2RegionCoverer::AddCandidate(Candidate* candidate) {
   int num_terminals = ExpandChildren(candidate, candidate->cell, num_levels);
 
   if (candidate->num_children == 0) {
-    DeleteCandidate(candidate, false);
+    // Nothing to do; the candidate is simply abandoned.
 
   } else if (!interior_covering_ &&
              num_terminals == 1 << max_children_shift() &&
@@ -244,6 +276,10 @@ void S2RegionCoverer::GetCoveringInternal(const S2Region& region) {
   region_ = &region;
   candidates_created_counter_ = 0;
 
+  // For incremental coverings the reused cells are part of the output (see
+  // GetIncrementalCovering).
+  if (reused_ != nullptr) result_ = reused_->cell_ids();
+
   GetInitialCandidates();
   while (!pq_.empty() &&
          (!interior_covering_ ||
@@ -263,16 +299,14 @@ void S2RegionCoverer::GetCoveringInternal(const S2Region& region) {
         candidate->num_children == 1 ||
         (result_.size() + pq_.size() + candidate->num_children <=
          static_cast<size_t>(options_.max_cells()))) {
-      // Expand this candidate into its children.
+      // Expand this candidate into its children.  (Children beyond
+      // max_cells() for interior coverings are simply abandoned.)
       for (int i = 0; i < candidate->num_children; ++i) {
-        if (interior_covering_ &&
-            result_.size() >= static_cast<size_t>(options_.max_cells())) {
-          DeleteCandidate(candidate->children[i], true);
-        } else {
+        if (!(interior_covering_ &&
+              result_.size() >= static_cast<size_t>(options_.max_cells()))) {
           AddCandidate(candidate->children[i]);
         }
       }
-      DeleteCandidate(candidate, false);
     } else {
       candidate->is_terminal = true;
       AddCandidate(candidate);
@@ -281,10 +315,8 @@ void S2RegionCoverer::GetCoveringInternal(const S2Region& region) {
   ABSL_VLOG(2) << "Created " << result_.size() << " cells, "
                << candidates_created_counter_ << " candidates created, "
                << pq_.size() << " left";
-  while (!pq_.empty()) {
-    DeleteCandidate(pq_.top().second, true);
-    pq_.pop();
-  }
+  pq_.clear();
+  arena_.Reset();
   region_ = nullptr;
 
   // Rather than just returning the raw list of cell ids, we construct a cell
@@ -299,6 +331,137 @@ void S2RegionCoverer::GetCoveringInternal(const S2Region& region) {
     S2CellUnion::Denormalize(result_copy, options_.min_level(),
                              options_.level_mod(), &result_);
   }
+  // Incremental coverings may exceed max_cells(); the caller canonicalizes
+  // the result in that case.
+  ABSL_DCHECK(reused_ != nullptr || IsCanonical(result_));
+}
+
+void S2RegionCoverer::ExpandFrontierCell(const S2Cell& cell, int num_levels,
+                                         FrontierShard* shard) const {
+  num_levels--;
+  S2Cell child_cells[4];
+  cell.Subdivide(child_cells);
+  bool may_intersect[4];
+  region_->MayIntersectCells(child_cells, may_intersect);
+  for (int i = 0; i < 4; ++i) {
+    if (!may_intersect[i]) continue;
+    if (num_levels > 0) {
+      ExpandFrontierCell(child_cells[i], num_levels, shard);
+      continue;
+    }
+    // Classify the child the same way that NewCandidate() does for interior
+    // coverings, but without materializing a Candidate.
+    ++shard->candidates_created;
+    if (child_cells[i].level() >= options_.min_level()) {
+      if (region_->Contains(child_cells[i])) {
+        shard->contained.push_back(child_cells[i].id());
+        continue;
+      }
+      if (child_cells[i].level() + options_.level_mod() >
+          options_.max_level()) {
+        continue;
+      }
+    }
+    shard->frontier.push_back(child_cells[i].id());
+  }
+}
+
+// Computes an interior covering by expanding the entire frontier of
+// partially contained cells in parallel rounds, rather than refining one
+// candidate at a time in priority order.  Each round distributes a
+// contiguous chunk of the frontier to every worker and then concatenates
+// the per-chunk results, which keeps both the frontier and the output in
+// S2CellId order.  The merged output depends only on the frontier contents
+// (not on the number of workers or the chunk boundaries), so the result is
+// deterministic.
+void S2RegionCoverer::GetInteriorCoveringParallel(const S2Region& region) {
+  // We check this on each call because of mutable_options().
+  ABSL_DCHECK_LE(options_.min_level(), options_.max_level());
+  ABSL_DCHECK(interior_covering_);
+  ABSL_DCHECK(result_.empty());
+  region_ = &region;
+  candidates_created_counter_ = 0;
+
+  // Compute the initial frontier from the same starting cells as
+  // GetInitialCandidates(), classifying each cell as in NewCandidate().
+  vector<S2CellId> frontier;
+  {
+    S2RegionCoverer tmp_coverer;
+    tmp_coverer.mutable_options()->set_max_cells(min(4, options_.max_cells()));
+    tmp_coverer.mutable_options()->set_max_level(options_.max_level());
+    vector<S2CellId> cells;
+    tmp_coverer.GetFastCovering(region, &cells);
+    AdjustCellLevels(&cells);
+    for (S2CellId id : cells) {
+      S2Cell cell(id);
+      if (!region.MayIntersect(cell)) continue;
+      ++candidates_created_counter_;
+      if (cell.level() >= options_.min_level()) {
+        if (region.Contains(cell)) {
+          result_.push_back(id);
+          continue;
+        }
+        if (cell.level() + options_.level_mod() > options_.max_level()) {
+          continue;
+        }
+      }
+      frontier.push_back(id);
+    }
+  }
+
+  S2Executor* executor = options_.executor();
+  if (executor == nullptr) executor = S2Executor::Default();
+
+  vector<FrontierShard> shards;
+  vector<S2CellId> next_frontier;
+  while (!frontier.empty() &&
+         result_.size() < static_cast<size_t>(options_.max_cells())) {
+    // Don't bother splitting a small frontier across every worker.
+    static constexpr size_t kMinCellsPerChunk = 4;
+    const int num_chunks = max(1, min(options_.num_threads(),
+        static_cast<int>(frontier.size() / kMinCellsPerChunk)));
+    const size_t chunk_size = (frontier.size() + num_chunks - 1) / num_chunks;
+    shards.clear();
+    shards.resize(num_chunks);
+    executor->Run(num_chunks, [this, &frontier, &shards, chunk_size](int t) {
+      FrontierShard* shard = &shards[t];
+      const size_t limit = min(frontier.size(), (t + 1) * chunk_size);
+      for (size_t i = t * chunk_size; i < limit; ++i) {
+        const S2Cell cell(frontier[i]);
+        // Expand one level at a time until we hit min_level() to ensure
+        // that we don't skip over it (as in AddCandidate).
+        const int num_levels = (cell.level() < options_.min_level()) ?
+                               1 : options_.level_mod();
+        ExpandFrontierCell(cell, num_levels, shard);
+      }
+    });
+    // Merge the shards in S2CellId order.  (Contained cells beyond
+    // max_cells() are simply abandoned, as in GetCoveringInternal.)
+    next_frontier.clear();
+    for (const FrontierShard& shard : shards) {
+      candidates_created_counter_ += shard.candidates_created;
+      for (S2CellId id : shard.contained) {
+        if (result_.size() >= static_cast<size_t>(options_.max_cells())) break;
+        result_.push_back(id);
+      }
+      next_frontier.insert(next_frontier.end(),
+                           shard.frontier.begin(), shard.frontier.end());
+    }
+    frontier.swap(next_frontier);
+  }
+  ABSL_VLOG(2) << "Created " << result_.size() << " cells, "
+               << candidates_created_counter_ << " candidates created, "
+               << frontier.size() << " left";
+  region_ = nullptr;
+
+  // See GetCoveringInternal() for why the result is normalized and then
+  // denormalized.
+  S2CellUnion::Normalize(&result_);
+  if (options_.min_level() > 0 || options_.level_mod() > 1) {
+    auto result_copy = result_;
+    S2CellUnion::Denormalize(result_copy, options_.min_level(),
+                             options_.level_mod(), &result_);
+  }
   ABSL_DCHECK(IsCanonical(result_));
 }
 
@@ -312,7 +475,11 @@ void S2RegionCoverer::GetCovering(const S2Region& region,
 void S2RegionCoverer::GetInteriorCovering(const S2Region& region,
                                           vector<S2CellId>* interior) {
   interior_covering_ = true;
-  GetCoveringInternal(region);
+  if (options_.num_threads() > 1) {
+    GetInteriorCoveringParallel(region);
+  } else {
+    GetCoveringInternal(region);
+  }
   *interior = std::move(result_);
 }
 
@@ -324,10 +491,79 @@ S2CellUnion S2RegionCoverer::GetCovering(const S2Region& region) {
 
 S2CellUnion S2RegionCoverer::GetInteriorCovering(const S2Region& region) {
   interior_covering_ = true;
-  GetCoveringInternal(region);
+  if (options_.num_threads() > 1) {
+    GetInteriorCoveringParallel(region);
+  } else {
+    GetCoveringInternal(region);
+  }
   return S2CellUnion::FromVerbatim(std::move(result_));
 }
 
+S2CellUnion S2RegionCoverer::GetIncrementalCovering(
+    const S2Region& region, const S2CellUnion& previous) {
+  vector<S2CellId> covering;
+  GetIncrementalCovering(region, previous.cell_ids(), &covering);
+  return S2CellUnion::FromVerbatim(std::move(covering));
+}
+
+void S2RegionCoverer::GetIncrementalCovering(const S2Region& region,
+                                             const vector<S2CellId>& previous,
+                                             vector<S2CellId>* covering) {
+  ABSL_DCHECK(is_sorted(previous.begin(), previous.end()));
+
+  // Keep the cells of the previous covering that still intersect the region;
+  // their interiors do not need to be examined again.  (A subset of a valid
+  // covering is itself sorted and non-overlapping.)
+  vector<S2CellId> kept;
+  for (S2CellId id : previous) {
+    if (region.MayIntersect(S2Cell(id))) kept.push_back(id);
+  }
+  if (kept.empty()) {
+    GetCovering(region, covering);
+    return;
+  }
+  S2CellUnion reused = S2CellUnion::FromVerbatim(std::move(kept));
+  reused_ = &reused;
+  interior_covering_ = false;
+  GetCoveringInternal(region);
+  reused_ = nullptr;
+  *covering = std::move(result_);
+
+  // The reused cells can push the result over max_cells(), in which case we
+  // merge cells into ancestors until the options are satisfied again.
+  if (!IsCanonical(*covering)) CanonicalizeCovering(covering);
+}
+
+void S2RegionCoverer::GetCoverings(absl::Span<const S2Region* const> regions,
+                                   int num_threads,
+                                   vector<S2CellUnion>* coverings) {
+  ABSL_DCHECK_GE(num_threads, 1);
+  coverings->resize(regions.size());
+
+  // Don't bother spawning threads unless there is enough work per thread to
+  // justify the overhead.
+  static constexpr int kMinRegionsPerThread = 8;
+  int num_chunks = max(1, min(num_threads, static_cast<int>(
+      regions.size() / kMinRegionsPerThread)));
+  if (num_chunks == 1) {
+    for (size_t i = 0; i < regions.size(); ++i) {
+      (*coverings)[i] = GetCovering(*regions[i]);
+    }
+    return;
+  }
+  // Each worker covers every num_chunks-th region with its own coverer (this
+  // class is not thread-safe), so that the regions are processed in parallel
+  // while expensive regions tend to be spread across the workers.
+  S2Executor* executor = options_.executor();
+  if (executor == nullptr) executor = S2Executor::Default();
+  executor->Run(num_chunks, [this, num_chunks, regions, coverings](int t) {
+    S2RegionCoverer coverer(options_);
+    for (size_t i = t; i < regions.size(); i += num_chunks) {
+      (*coverings)[i] = coverer.GetCovering(*regions[i]);
+    }
+  });
+}
+
 void S2RegionCoverer::GetFastCovering(const S2Region& region,
                                       vector<S2CellId>* covering) {
   region.GetCellUnionBound(covering);
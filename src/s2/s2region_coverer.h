@@ -20,6 +20,7 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <memory>
 #include <new>
 #include <queue>
 #include <utility>
@@ -27,10 +28,12 @@
 
 #include "absl/base/casts.h"
 #include "absl/base/macros.h"
+#include "absl/types/span.h"
 #include "s2/_fp_contract_off.h"
 #include "s2/s2cell.h"
 #include "s2/s2cell_id.h"
 #include "s2/s2cell_union.h"
+#include "s2/s2executor.h"
 #include "s2/s2point.h"
 #include "s2/s2region.h"
 
@@ -155,11 +158,41 @@ class S2RegionCoverer {
     // This is the maximum level that will actually be used in coverings.
     int true_max_level() const;
 
+    // Specifies the number of threads used by GetInteriorCovering() to
+    // subdivide candidate cells.  Interior coverings of large regions spend
+    // nearly all of their time in the containment tests of individual cells,
+    // and those tests are independent, so with num_threads() > 1 the frontier
+    // of partially contained cells is expanded in parallel rounds and the
+    // per-thread results are merged in S2CellId order.  The result does not
+    // depend on the number of threads, but when max_cells() cuts the search
+    // short it may differ from the single-threaded result (which refines
+    // cells in priority order rather than S2CellId order).
+    //
+    // The region being covered must support concurrent calls to Contains()
+    // and MayIntersect(), which is true for all S2Region types in this
+    // library.
+    //
+    // REQUIRES: num_threads >= 1
+    // DEFAULT: 1
+    int num_threads() const { return num_threads_; }
+    void set_num_threads(int num_threads);
+
+    // The executor used to run the threads requested by GetCoverings() and
+    // by num_threads().  This allows clients with their own scheduler to
+    // control how the coverings are parallelized (see S2Executor).  The
+    // executor is not owned and must outlive the coverer.
+    //
+    // DEFAULT: nullptr (meaning S2Executor::Default() is used)
+    S2Executor* executor() const { return executor_; }
+    void set_executor(S2Executor* executor) { executor_ = executor; }
+
    protected:
     int max_cells_ = kDefaultMaxCells;
     int min_level_ = 0;
     int max_level_ = S2CellId::kMaxLevel;
     int level_mod_ = 1;
+    int num_threads_ = 1;
+    S2Executor* executor_ = nullptr;
   };
 
   // Constructs an S2RegionCoverer with the given options.
@@ -189,6 +222,18 @@ class S2RegionCoverer {
   S2CellUnion GetCovering(const S2Region& region);
   S2CellUnion GetInteriorCovering(const S2Region& region);
 
+  // Computes a covering for each of the given regions using the current
+  // options, such that (*coverings)[i] is the covering of *regions[i].  The
+  // coverings are computed in parallel using up to "num_threads" threads
+  // (each thread covers its regions with a private S2RegionCoverer), so this
+  // method is useful when a large number of coverings are needed.  The
+  // threads are run on options().executor() if one was supplied.  The
+  // results are identical to calling GetCovering() on each region in turn.
+  //
+  // REQUIRES: num_threads >= 1
+  void GetCoverings(absl::Span<const S2Region* const> regions,
+                    int num_threads, std::vector<S2CellUnion>* coverings);
+
   // Like the methods above, but works directly with a vector of S2CellIds.
   // This version can be more efficient when this method is called many times,
   // since it does not require allocating a new vector on each call.
@@ -196,6 +241,30 @@ class S2RegionCoverer {
   void GetInteriorCovering(const S2Region& region,
                            std::vector<S2CellId>* interior);
 
+  // Like GetCovering(), except that cells of "previous" (a covering computed
+  // earlier with the same options, typically for a slightly different region)
+  // are reused wherever possible.  Cells of the previous covering that still
+  // intersect "region" are emitted directly, and the covering algorithm only
+  // expands candidates outside the reused cells.  When the region moves
+  // slightly between calls (e.g. when repeatedly covering the cap around a
+  // moving object), this touches only the cells near the boundary of the
+  // change rather than rebuilding the candidate tree from scratch.
+  //
+  // The result covers "region" and conforms to the current options, but it
+  // is generally not identical to what GetCovering() would return, since
+  // reused cells are kept even where a fresh covering would choose different
+  // ones.  Calling this method with an empty "previous" is equivalent to
+  // calling GetCovering().
+  //
+  // REQUIRES: "previous" is a valid covering (sorted and non-overlapping),
+  //           e.g. the result of an earlier call to GetCovering() or
+  //           GetIncrementalCovering() with the same options.
+  S2CellUnion GetIncrementalCovering(const S2Region& region,
+                                     const S2CellUnion& previous);
+  void GetIncrementalCovering(const S2Region& region,
+                              const std::vector<S2CellId>& previous,
+                              std::vector<S2CellId>* covering);
+
   // Like GetCovering(), except that this method is much faster and the
   // coverings are not as tight.  All of the usual parameters are respected
   // (max_cells, min_level, max_level, and level_mod), except that the
@@ -251,22 +320,14 @@ class S2RegionCoverer {
 
  private:
   struct Candidate {
-    void* operator new(std::size_t size, std::size_t max_children) {
-      return ::operator new (size + max_children * sizeof(Candidate *));
-    }
-
-    void operator delete(void* p) {
-      ::operator delete (p);
-    }
-
     Candidate(const S2Cell& cell, const std::size_t max_children)
         : cell(cell), is_terminal(max_children == 0) {
       std::fill_n(&children[0], max_children,
                   absl::implicit_cast<Candidate*>(nullptr));
     }
 
-    // Default destructor is fine; Candidate* is trivially destructible.
-    // children must be deleted by DeleteCandidate.
+    // Candidates are allocated from arena_ (see below), which never invokes
+    // destructors, so this type must remain trivially destructible.
     ~Candidate() = default;
 
     S2Cell cell;
@@ -275,17 +336,40 @@ class S2RegionCoverer {
     Candidate* children[0];  // Actual size may be 0, 4, 16, or 64 elements.
   };
 
+  // A simple bump allocator for Candidates.  All of the candidates created
+  // while computing a covering are discarded at once by calling Reset() when
+  // the covering is complete.  The underlying blocks are retained, so that
+  // computing many coverings with the same S2RegionCoverer performs no
+  // per-candidate heap allocations in the steady state.
+  class CandidateArena {
+   public:
+    // Returns a pointer to "size" bytes of storage suitably aligned for a
+    // Candidate.  REQUIRES: size <= kBlockSize.
+    void* Alloc(std::size_t size);
+
+    // Discards all allocated objects (without invoking any destructors) and
+    // makes their storage available for reuse.
+    void Reset();
+
+   private:
+    static constexpr std::size_t kBlockSize = 1 << 14;
+
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    std::size_t next_block_ = 0;  // Index of the next unused block.
+    char* block_pos_ = nullptr;   // Allocation position in the current block.
+    char* block_end_ = nullptr;   // End of the current block.
+  };
+
   // If the cell intersects the given region, return a new candidate with no
   // children, otherwise return nullptr.  Also marks the candidate as "terminal"
-  // if it should not be expanded further.
-  Candidate* NewCandidate(const S2Cell& cell);
+  // if it should not be expanded further.  Callers that have already tested
+  // the cell (see S2Region::MayIntersectCells) pass "known_to_intersect" to
+  // skip the redundant intersection test.
+  Candidate* NewCandidate(const S2Cell& cell, bool known_to_intersect = false);
 
   // Returns the log base 2 of the maximum number of children of a candidate.
   int max_children_shift() const { return 2 * options().level_mod(); }
 
-  // Frees the memory associated with a candidate.
-  static void DeleteCandidate(Candidate* candidate, bool delete_children);
-
   // Processes a candidate by either adding it to the result_ vector or
   // expanding its children and inserting it into the priority queue.
   // Passing an argument of nullptr does nothing.
@@ -302,6 +386,25 @@ class S2RegionCoverer {
   // Generates a covering and stores it in result_.
   void GetCoveringInternal(const S2Region& region);
 
+  // Accumulates the results of one worker during a round of parallel
+  // frontier expansion (see Options::num_threads).
+  struct FrontierShard {
+    std::vector<S2CellId> contained;  // Cells contained by the region.
+    std::vector<S2CellId> frontier;   // Cells to be subdivided further.
+    int candidates_created = 0;
+  };
+
+  // Classifies the descendants of "cell" that are "num_levels" levels below
+  // it, appending contained cells and partially intersecting cells to the
+  // given shard.  This is the parallel counterpart of ExpandChildren().
+  void ExpandFrontierCell(const S2Cell& cell, int num_levels,
+                          FrontierShard* shard) const;
+
+  // Like GetCoveringInternal(), but expands the frontier of partially
+  // contained cells in parallel using options().num_threads() workers.
+  // REQUIRES: interior_covering_ is true.
+  void GetInteriorCoveringParallel(const S2Region& region);
+
   // If level > min_level(), then reduces "level" if necessary so that it also
   // satisfies level_mod().  Levels smaller than min_level() are not affected
   // (since cells at these levels are eventually expanded).
@@ -330,6 +433,11 @@ class S2RegionCoverer {
   // only valid) for the duration of a single GetCovering() call.
   const S2Region* region_ = nullptr;
 
+  // The cells being reused from a previous covering.  This is only non-null
+  // for the duration of a GetIncrementalCovering() call; candidates whose
+  // area is already covered by one of these cells are pruned.
+  const S2CellUnion* reused_ = nullptr;
+
   // The set of S2CellIds that have been added to the covering so far.
   std::vector<S2CellId> result_;
 
@@ -347,9 +455,19 @@ class S2RegionCoverer {
     }
   };
   typedef std::priority_queue<QueueEntry, std::vector<QueueEntry>,
-                              CompareQueueEntries> CandidateQueue;
+                              CompareQueueEntries> CandidateQueueBase;
+
+  // Exposes clear() so that the queue's backing store can be reused by
+  // subsequent coverings.
+  class CandidateQueue : public CandidateQueueBase {
+   public:
+    void clear() { c.clear(); }
+  };
   CandidateQueue pq_;
 
+  // The storage for all candidates created during a covering.
+  CandidateArena arena_;
+
   // True if we're computing an interior covering.
   bool interior_covering_;
 
@@ -45,6 +45,7 @@
 #include "s2/s2cell.h"
 #include "s2/s2cell_id.h"
 #include "s2/s2cell_union.h"
+#include "s2/s2edge_distances.h"
 #include "s2/s2latlng.h"
 #include "s2/s2point.h"
 #include "s2/s2polyline.h"
@@ -82,6 +83,73 @@ TEST(S2RegionCoverer, RandomCells) {
   }
 }
 
+TEST(S2RegionCoverer, GetCoveringsMatchesGetCovering) {
+  S2RegionCoverer::Options options;
+  options.set_max_cells(8);
+  S2RegionCoverer coverer(options);
+
+  vector<S2Cap> caps;
+  vector<const S2Region*> regions;
+  for (int i = 0; i < 100; ++i) {
+    caps.push_back(S2Cap(
+        S2Testing::RandomPoint(),
+        S1Angle::Radians(1e-7 * pow(1e6, S2Testing::rnd.RandDouble()))));
+  }
+  for (const S2Cap& cap : caps) regions.push_back(&cap);
+
+  for (int num_threads : {1, 4}) {
+    SCOPED_TRACE(StrCat("num_threads ", num_threads));
+    vector<S2CellUnion> coverings;
+    coverer.GetCoverings(regions, num_threads, &coverings);
+    ASSERT_EQ(regions.size(), coverings.size());
+    for (size_t i = 0; i < regions.size(); ++i) {
+      EXPECT_EQ(coverer.GetCovering(*regions[i]), coverings[i]);
+    }
+  }
+}
+
+TEST(S2RegionCoverer, IncrementalCoveringUnchangedRegion) {
+  // When the region has not moved, every cell of the previous covering is
+  // reused and the result is identical.
+  S2RegionCoverer coverer;
+  for (int i = 0; i < 100; ++i) {
+    S2Cap cap(S2Testing::RandomPoint(),
+              S1Angle::Radians(1e-5 * pow(1e4, S2Testing::rnd.RandDouble())));
+    S2CellUnion covering = coverer.GetCovering(cap);
+    EXPECT_EQ(covering, coverer.GetIncrementalCovering(cap, covering));
+  }
+}
+
+TEST(S2RegionCoverer, IncrementalCoveringEmptyPrevious) {
+  S2RegionCoverer coverer;
+  S2Cap cap(S2Testing::RandomPoint(), S1Angle::Degrees(1));
+  EXPECT_EQ(coverer.GetCovering(cap),
+            coverer.GetIncrementalCovering(cap, S2CellUnion()));
+}
+
+TEST(S2RegionCoverer, IncrementalCoveringMovingCap) {
+  // Repeatedly cover a cap that drifts a small fraction of its radius per
+  // step, checking that each incremental covering is a valid covering of the
+  // current cap that conforms to the options.
+  S2RegionCoverer::Options options;
+  options.set_max_cells(16);
+  S2RegionCoverer coverer(options);
+  for (int iter = 0; iter < 10; ++iter) {
+    S1Angle radius =
+        S1Angle::Radians(1e-4 * pow(100, S2Testing::rnd.RandDouble()));
+    S2Point center = S2Testing::RandomPoint();
+    S2Point target = S2Testing::RandomPoint();
+    S2CellUnion covering = coverer.GetCovering(S2Cap(center, radius));
+    for (int step = 0; step < 20; ++step) {
+      center = S2::GetPointOnLine(center, target, 0.05 * radius);
+      S2Cap cap(center, radius);
+      covering = coverer.GetIncrementalCovering(cap, covering);
+      EXPECT_TRUE(coverer.IsCanonical(covering));
+      S2Testing::CheckCovering(cap, covering, true);
+    }
+  }
+}
+
 static void CheckCovering(const S2RegionCoverer::Options& options,
                           const S2Region& region,
                           const vector<S2CellId>& covering,
@@ -323,6 +391,52 @@ TEST(S2RegionCoverer, InteriorCovering) {
   }
 }
 
+TEST(S2RegionCoverer, InteriorCoveringParallelMatchesSerial) {
+  // When max_cells() does not truncate the search, every partially contained
+  // cell is fully subdivided by both algorithms, so the parallel path must
+  // produce a covering identical to the serial one for any thread count.
+  for (int i = 0; i < 20; ++i) {
+    S2Cap cap(S2Testing::RandomPoint(),
+              S1Angle::Radians(0.05 * pow(10, S2Testing::rnd.RandDouble())));
+    S2RegionCoverer::Options options;
+    options.set_max_cells(10000);
+    options.set_max_level(8);
+    S2RegionCoverer coverer(options);
+    vector<S2CellId> expected;
+    coverer.GetInteriorCovering(cap, &expected);
+    for (int num_threads : {2, 4}) {
+      SCOPED_TRACE(StrCat("Iteration ", i, ", num_threads ", num_threads));
+      coverer.mutable_options()->set_num_threads(num_threads);
+      vector<S2CellId> interior;
+      coverer.GetInteriorCovering(cap, &interior);
+      EXPECT_EQ(expected, interior);
+      CheckCovering(coverer.options(), cap, interior, true);
+    }
+  }
+}
+
+TEST(S2RegionCoverer, InteriorCoveringParallelTruncated) {
+  // When max_cells() cuts the search short, the parallel result may differ
+  // from the serial one, but it must still be a valid interior covering and
+  // must not depend on the number of threads.
+  S2Cap cap(S2Testing::RandomPoint(), S1Angle::Radians(0.2));
+  S2RegionCoverer::Options options;
+  options.set_max_cells(12);
+  options.set_max_level(10);
+  options.set_num_threads(2);
+  S2RegionCoverer coverer(options);
+  vector<S2CellId> expected;
+  coverer.GetInteriorCovering(cap, &expected);
+  CheckCovering(coverer.options(), cap, expected, true);
+  for (int num_threads : {3, 4}) {
+    SCOPED_TRACE(StrCat("num_threads ", num_threads));
+    coverer.mutable_options()->set_num_threads(num_threads);
+    vector<S2CellId> interior;
+    coverer.GetInteriorCovering(cap, &interior);
+    EXPECT_EQ(expected, interior);
+  }
+}
+
 TEST(GetFastCovering, HugeFixedLevelCovering) {
   // Test a "fast covering" with a huge number of cells due to min_level().
   S2RegionCoverer::Options options;
@@ -15,17 +15,21 @@
 
 #include "s2/s2region_sharder.h"
 
+#include <algorithm>
 #include <cstdint>
 
 #include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/log/absl_check.h"
 #include "absl/meta/type_traits.h"
+#include "absl/types/span.h"
 #include "s2/s2cell.h"
 #include "s2/s2cell_id.h"
 #include "s2/s2cell_index.h"
 #include "s2/s2cell_union.h"
+#include "s2/s2executor.h"
 #include "s2/s2region.h"
 
 using std::vector;
@@ -136,6 +140,30 @@ int S2RegionSharder::GetMostIntersectingShard(const S2Region& region,
   return best_shard;
 }
 
+vector<int> S2RegionSharder::GetMostIntersectingShards(
+    absl::Span<const S2Region* const> regions, const int default_shard,
+    int num_threads, S2Executor* executor) const {
+  ABSL_DCHECK_GE(num_threads, 1);
+  vector<int> shards(regions.size());
+  // There is no point in using more threads than there are regions.
+  num_threads = std::min<int64>(num_threads, regions.size());
+  if (num_threads <= 1) {
+    for (size_t i = 0; i < regions.size(); ++i) {
+      shards[i] = GetMostIntersectingShard(*regions[i], default_shard);
+    }
+    return shards;
+  }
+  // Lookups only read the (immutable) S2CellIndex, so the threads need no
+  // synchronization beyond writing to disjoint elements of "shards".
+  if (executor == nullptr) executor = S2Executor::Default();
+  executor->Run(num_threads, [&](int thread) {
+    for (size_t i = thread; i < regions.size(); i += num_threads) {
+      shards[i] = GetMostIntersectingShard(*regions[i], default_shard);
+    }
+  });
+  return shards;
+}
+
 vector<int> S2RegionSharder::GetIntersectingShards(
     const S2Region& region) const {
   vector<int> shard_numbers;
@@ -19,8 +19,10 @@
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/types/span.h"
 #include "s2/s2cell_index.h"
 #include "s2/s2cell_union.h"
+#include "s2/s2executor.h"
 #include "s2/s2region.h"
 
 // S2RegionSharder implements a sharding function that provides shard IDs whose
@@ -44,6 +46,22 @@ class S2RegionSharder {
   // with the input region, returns 'default_shard'.
   int GetMostIntersectingShard(const S2Region& region, int default_shard) const;
 
+  // Returns the most intersecting shard for each region in "regions", as if
+  // GetMostIntersectingShard() had been called on each region in turn.  The
+  // regions are distributed over "num_threads" threads, which are run using
+  // "executor" (or S2Executor::Default() if "executor" is nullptr).  This is
+  // useful when assigning a large batch of regions to shards, e.g. when
+  // rebuilding a sharded index.  (Note that the underlying S2CellIndex
+  // already stores the shard coverings as a flat sorted table of leaf-cell
+  // ranges, so each lookup costs a binary search rather than a probe of
+  // every shard.)
+  //
+  // REQUIRES: num_threads >= 1
+  // REQUIRES: all pointers in "regions" are non-null.
+  std::vector<int> GetMostIntersectingShards(
+      absl::Span<const S2Region* const> regions, int default_shard,
+      int num_threads, S2Executor* executor = nullptr) const;
+
   // Returns a list of shard numbers which intersect with the input 'region'.
   // Shard numbers are not guaranteed to be sorted in any particular order.  If
   // no shards overlap, returns an empty vector.
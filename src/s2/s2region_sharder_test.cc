@@ -91,4 +91,35 @@ TEST(S2RegionSharderTest, GetIntersectingShards) {
               testing::IsEmpty());
 }
 
+TEST(S2RegionSharderTest, GetMostIntersectingShards) {
+  vector<S2CellUnion> coverings{
+      S2CellUnion({S2CellId::FromFacePosLevel(0, 0, 10)}),
+      S2CellUnion({
+          S2CellId::FromFacePosLevel(1, 1, 9),
+          S2CellId::FromFacePosLevel(3, 0, 8),
+      }),
+      S2CellUnion({S2CellId::FromFacePosLevel(5, 0, 10)}),
+  };
+
+  S2RegionSharder sharder(coverings);
+
+  // One region per face, covering the single-shard, multiple-shard, and
+  // no-shard cases exercised by the GetMostIntersectingShard test above.
+  vector<S2CellUnion> regions;
+  for (int face = 0; face < 6; ++face) {
+    regions.push_back(S2CellUnion({S2CellId::FromFacePosLevel(face, 0, 11)}));
+  }
+  vector<const S2Region*> region_ptrs;
+  vector<int> expected;
+  for (const S2CellUnion& region : regions) {
+    region_ptrs.push_back(&region);
+    expected.push_back(sharder.GetMostIntersectingShard(region, 42));
+  }
+
+  for (int num_threads : {1, 2, 4}) {
+    EXPECT_EQ(expected,
+              sharder.GetMostIntersectingShards(region_ptrs, 42, num_threads));
+  }
+}
+
 }  // namespace
@@ -117,19 +117,79 @@ S2RegionTermIndexer::S2RegionTermIndexer(S2RegionTermIndexer&&) = default;
 S2RegionTermIndexer& S2RegionTermIndexer::operator=(S2RegionTermIndexer&&) =
                                                    default;
 
-string S2RegionTermIndexer::GetTerm(TermType term_type, const S2CellId id,
-                                    string_view prefix) const {
+void S2RegionTermIndexer::AddTerm(TermType term_type, const S2CellId id,
+                                  string_view prefix,
+                                  TermBuffer* terms) const {
   // There are generally more ancestor terms than covering terms, so we add
   // the extra "marker" character to the covering terms to distinguish them.
+  // (Note that id.ToToken() is at most 16 characters and therefore does not
+  // allocate; appending it to the buffer avoids a per-term allocation.)
   if (term_type == TermType::ANCESTOR) {
-    return absl::StrCat(prefix, id.ToToken());
+    absl::StrAppend(&terms->data_, prefix, id.ToToken());
   } else {
-    return absl::StrCat(prefix, options_.marker(), id.ToToken());
+    absl::StrAppend(&terms->data_, prefix, options_.marker(), id.ToToken());
   }
+  terms->limits_.push_back(terms->data_.size());
+}
+
+// Returns true if the two Options yield identical terms for a given
+// canonical covering.  (Note that max_cells() does not affect the terms.)
+static bool TermOptionsEqual(const S2RegionTermIndexer::Options& a,
+                             const S2RegionTermIndexer::Options& b) {
+  return a.min_level() == b.min_level() && a.max_level() == b.max_level() &&
+         a.level_mod() == b.level_mod() &&
+         a.index_contains_points_only() == b.index_contains_points_only() &&
+         a.optimize_for_space() == b.optimize_for_space() &&
+         a.marker_character() == b.marker_character();
+}
+
+bool S2RegionTermIndexer::LookupMemo(bool index_terms,
+                                     const S2CellUnion& covering,
+                                     string_view prefix,
+                                     TermBuffer* terms) const {
+  if (!memo_.valid || memo_.index_terms != index_terms ||
+      memo_.prefix != prefix || !TermOptionsEqual(memo_.options, options_) ||
+      memo_.covering != covering.cell_ids()) {
+    return false;
+  }
+  *terms = memo_.terms;
+  return true;
+}
+
+void S2RegionTermIndexer::UpdateMemo(bool index_terms,
+                                     const S2CellUnion& covering,
+                                     string_view prefix,
+                                     const TermBuffer& terms) {
+  memo_.valid = true;
+  memo_.index_terms = index_terms;
+  memo_.covering = covering.cell_ids();
+  memo_.prefix = string(prefix);
+  memo_.options = options_;
+  memo_.terms = terms;
+}
+
+// Converts the contents of a TermBuffer to the vector<string> representation
+// used by the original API.
+static vector<string> ToStringVector(
+    const S2RegionTermIndexer::TermBuffer& terms) {
+  vector<string> result;
+  result.reserve(terms.size());
+  for (int i = 0; i < terms.size(); ++i) {
+    result.emplace_back(terms.term(i));
+  }
+  return result;
 }
 
 vector<string> S2RegionTermIndexer::GetIndexTerms(const S2Point& point,
                                                   string_view prefix) {
+  TermBuffer terms;
+  GetIndexTerms(point, prefix, &terms);
+  return ToStringVector(terms);
+}
+
+void S2RegionTermIndexer::GetIndexTerms(const S2Point& point,
+                                        string_view prefix,
+                                        TermBuffer* terms) {
   // See the top of this file for an overview of the indexing strategy.
   //
   // The last cell generated by this loop is effectively the covering for
@@ -140,15 +200,14 @@ vector<string> S2RegionTermIndexer::GetIndexTerms(const S2Point& point,
   // max_level() != true_max_level() (see S2RegionCoverer::Options).
 
   const S2CellId id(point);
-  vector<string> terms;
-  terms.reserve((options_.true_max_level() - options_.min_level()) /
-                    options_.level_mod() +
-                1);
+  terms->clear();
+  terms->limits_.reserve((options_.true_max_level() - options_.min_level()) /
+                             options_.level_mod() +
+                         1);
   for (int level = options_.min_level(); level <= options_.max_level();
        level += options_.level_mod()) {
-    terms.push_back(GetTerm(TermType::ANCESTOR, id.parent(level), prefix));
+    AddTerm(TermType::ANCESTOR, id.parent(level), prefix, terms);
   }
-  return terms;
 }
 
 vector<string> S2RegionTermIndexer::GetIndexTerms(const S2Region& region,
@@ -159,8 +218,24 @@ vector<string> S2RegionTermIndexer::GetIndexTerms(const S2Region& region,
   return GetIndexTermsForCanonicalCovering(covering, prefix);
 }
 
+void S2RegionTermIndexer::GetIndexTerms(const S2Region& region,
+                                        string_view prefix,
+                                        TermBuffer* terms) {
+  // Note that options may have changed since the last call.
+  *coverer_.mutable_options() = options_;
+  S2CellUnion covering = coverer_.GetCovering(region);
+  GetIndexTermsForCanonicalCovering(covering, prefix, terms);
+}
+
 vector<string> S2RegionTermIndexer::GetIndexTermsForCanonicalCovering(
     const S2CellUnion& covering, string_view prefix) {
+  TermBuffer terms;
+  GetIndexTermsForCanonicalCovering(covering, prefix, &terms);
+  return ToStringVector(terms);
+}
+
+void S2RegionTermIndexer::GetIndexTermsForCanonicalCovering(
+    const S2CellUnion& covering, string_view prefix, TermBuffer* terms) {
   // See the top of this file for an overview of the indexing strategy.
   //
   // Cells in the covering are normally indexed as covering terms.  If we are
@@ -175,10 +250,11 @@ vector<string> S2RegionTermIndexer::GetIndexTermsForCanonicalCovering(
     *coverer_.mutable_options() = options_;
     ABSL_CHECK(coverer_.IsCanonical(covering));
   }
-  vector<string> terms;
+  if (LookupMemo(/*index_terms=*/true, covering, prefix, terms)) return;
+  terms->clear();
   // `covering.size()` is necessary.  Double it because we'll probably add
   // more.  This could probably reasonably be even higher.
-  terms.reserve(2 * covering.size());
+  terms->limits_.reserve(2 * covering.size());
   S2CellId prev_id = S2CellId::None();
   int true_max_level = options_.true_max_level();
   for (S2CellId id : covering) {
@@ -191,11 +267,11 @@ vector<string> S2RegionTermIndexer::GetIndexTermsForCanonicalCovering(
 
     if (level < true_max_level) {
       // Add a covering term for this cell.
-      terms.push_back(GetTerm(TermType::COVERING, id, prefix));
+      AddTerm(TermType::COVERING, id, prefix, terms);
     }
     if (level == true_max_level || !options_.optimize_for_space()) {
       // Add an ancestor term for this cell at the constrained level.
-      terms.push_back(GetTerm(TermType::ANCESTOR, id.parent(level), prefix));
+      AddTerm(TermType::ANCESTOR, id.parent(level), prefix, terms);
     }
     // Finally, add ancestor terms for all the ancestors of this cell.
     while ((level -= options_.level_mod()) >= options_.min_level()) {
@@ -204,34 +280,42 @@ vector<string> S2RegionTermIndexer::GetIndexTermsForCanonicalCovering(
           prev_id.parent(level) == ancestor_id) {
         break;  // We have already processed this cell and its ancestors.
       }
-      terms.push_back(GetTerm(TermType::ANCESTOR, ancestor_id, prefix));
+      AddTerm(TermType::ANCESTOR, ancestor_id, prefix, terms);
     }
     prev_id = id;
   }
-  return terms;
+  UpdateMemo(/*index_terms=*/true, covering, prefix, *terms);
 }
 
 vector<string> S2RegionTermIndexer::GetQueryTerms(const S2Point& point,
                                                   string_view prefix) {
+  TermBuffer terms;
+  GetQueryTerms(point, prefix, &terms);
+  return ToStringVector(terms);
+}
+
+void S2RegionTermIndexer::GetQueryTerms(const S2Point& point,
+                                        string_view prefix,
+                                        TermBuffer* terms) {
   // See the top of this file for an overview of the indexing strategy.
 
   const S2CellId id(point);
-  vector<string> terms;
-  terms.reserve(options_.index_contains_points_only()
-                    ? 1
-                    : ((options_.true_max_level() - options_.min_level()) /
-                           options_.level_mod() +
-                       2));
+  terms->clear();
+  terms->limits_.reserve(
+      options_.index_contains_points_only()
+          ? 1
+          : ((options_.true_max_level() - options_.min_level()) /
+                 options_.level_mod() +
+             2));
   // Recall that all true_max_level() cells are indexed only as ancestor terms.
   int level = options_.true_max_level();
-  terms.push_back(GetTerm(TermType::ANCESTOR, id.parent(level), prefix));
-  if (options_.index_contains_points_only()) return terms;
+  AddTerm(TermType::ANCESTOR, id.parent(level), prefix, terms);
+  if (options_.index_contains_points_only()) return;
 
   // Add covering terms for all the ancestor cells.
   for (; level >= options_.min_level(); level -= options_.level_mod()) {
-    terms.push_back(GetTerm(TermType::COVERING, id.parent(level), prefix));
+    AddTerm(TermType::COVERING, id.parent(level), prefix, terms);
   }
-  return terms;
 }
 
 vector<string> S2RegionTermIndexer::GetQueryTerms(const S2Region& region,
@@ -242,16 +326,33 @@ vector<string> S2RegionTermIndexer::GetQueryTerms(const S2Region& region,
   return GetQueryTermsForCanonicalCovering(covering, prefix);
 }
 
+void S2RegionTermIndexer::GetQueryTerms(const S2Region& region,
+                                        string_view prefix,
+                                        TermBuffer* terms) {
+  // Note that options may have changed since the last call.
+  *coverer_.mutable_options() = options_;
+  S2CellUnion covering = coverer_.GetCovering(region);
+  GetQueryTermsForCanonicalCovering(covering, prefix, terms);
+}
+
 vector<string> S2RegionTermIndexer::GetQueryTermsForCanonicalCovering(
     const S2CellUnion& covering, string_view prefix) {
+  TermBuffer terms;
+  GetQueryTermsForCanonicalCovering(covering, prefix, &terms);
+  return ToStringVector(terms);
+}
+
+void S2RegionTermIndexer::GetQueryTermsForCanonicalCovering(
+    const S2CellUnion& covering, string_view prefix, TermBuffer* terms) {
   // See the top of this file for an overview of the indexing strategy.
 
   if (google::DEBUG_MODE) {
     *coverer_.mutable_options() = options_;
     ABSL_CHECK(coverer_.IsCanonical(covering));
   }
-  vector<string> terms;
-  terms.reserve(2 * covering.size());
+  if (LookupMemo(/*index_terms=*/false, covering, prefix, terms)) return;
+  terms->clear();
+  terms->limits_.reserve(2 * covering.size());
   S2CellId prev_id = S2CellId::None();
   int true_max_level = options_.true_max_level();
   for (S2CellId id : covering) {
@@ -263,7 +364,7 @@ vector<string> S2RegionTermIndexer::GetQueryTermsForCanonicalCovering(
     ABSL_DCHECK_EQ(0, (level - options_.min_level()) % options_.level_mod());
 
     // Cells in the covering are always queried as ancestor terms.
-    terms.push_back(GetTerm(TermType::ANCESTOR, id, prefix));
+    AddTerm(TermType::ANCESTOR, id, prefix, terms);
 
     // If the index only contains points, there are no covering terms.
     if (options_.index_contains_points_only()) continue;
@@ -272,7 +373,7 @@ vector<string> S2RegionTermIndexer::GetQueryTermsForCanonicalCovering(
     // also queried as covering terms (except for true_max_level() cells,
     // which are indexed and queried as ancestor cells only).
     if (options_.optimize_for_space() && level < true_max_level) {
-      terms.push_back(GetTerm(TermType::COVERING, id, prefix));
+      AddTerm(TermType::COVERING, id, prefix, terms);
     }
     // Finally, add covering terms for all the ancestors of this cell.
     while ((level -= options_.level_mod()) >= options_.min_level()) {
@@ -281,9 +382,9 @@ vector<string> S2RegionTermIndexer::GetQueryTermsForCanonicalCovering(
           prev_id.parent(level) == ancestor_id) {
         break;  // We have already processed this cell and its ancestors.
       }
-      terms.push_back(GetTerm(TermType::COVERING, ancestor_id, prefix));
+      AddTerm(TermType::COVERING, ancestor_id, prefix, terms);
     }
     prev_id = id;
   }
-  return terms;
+  UpdateMemo(/*index_terms=*/false, covering, prefix, *terms);
 }
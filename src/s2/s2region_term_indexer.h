@@ -97,6 +97,7 @@
 #ifndef S2_S2REGION_TERM_INDEXER_H_
 #define S2_S2REGION_TERM_INDEXER_H_
 
+#include <cstddef>
 #include <string>
 #include <vector>
 
@@ -228,6 +229,36 @@ class S2RegionTermIndexer {
     char marker_ = '$';
   };
 
+  // A reusable output buffer for the term generation methods below.  The
+  // terms are stored end-to-end in a single string, which avoids allocating
+  // a separate std::string for every term.  Reusing one TermBuffer across
+  // many documents amortizes the remaining allocations as well, since the
+  // buffer retains its capacity when cleared.
+  class TermBuffer {
+   public:
+    // Returns the number of terms in the buffer.
+    int size() const { return static_cast<int>(limits_.size()); }
+    bool empty() const { return limits_.empty(); }
+
+    // Returns the i-th term.  The returned view is valid until the buffer
+    // is modified or destroyed.
+    absl::string_view term(int i) const {
+      size_t begin = (i == 0) ? 0 : limits_[i - 1];
+      return absl::string_view(data_).substr(begin, limits_[i] - begin);
+    }
+
+    // Removes all terms, but keeps the allocated storage for reuse.
+    void clear() {
+      data_.clear();
+      limits_.clear();
+    }
+
+   private:
+    friend class S2RegionTermIndexer;
+    std::string data_;            // All terms, concatenated.
+    std::vector<size_t> limits_;  // End offset of each term within "data_".
+  };
+
   // Default constructor.  Options can be set using mutable_options().
   S2RegionTermIndexer();
   ~S2RegionTermIndexer();
@@ -289,14 +320,56 @@ class S2RegionTermIndexer {
   std::vector<std::string> GetQueryTermsForCanonicalCovering(
       const S2CellUnion& covering, absl::string_view prefix);
 
+  // Variants of the methods above that write the terms into a caller-owned
+  // TermBuffer rather than returning a std::vector<std::string>.  The buffer
+  // is cleared first.  These methods are recommended when indexing large
+  // numbers of documents, since reusing a single TermBuffer eliminates the
+  // per-term string allocations of the methods above.
+  //
+  // As a further optimization, the terms generated for the most recent
+  // covering are memoized: when consecutive documents have identical
+  // coverings (and the prefix and options are unchanged), the terms are
+  // copied from the previous result rather than being regenerated.
+  void GetIndexTerms(const S2Region& region, absl::string_view prefix,
+                     TermBuffer* terms);
+  void GetQueryTerms(const S2Region& region, absl::string_view prefix,
+                     TermBuffer* terms);
+  void GetIndexTerms(const S2Point& point, absl::string_view prefix,
+                     TermBuffer* terms);
+  void GetQueryTerms(const S2Point& point, absl::string_view prefix,
+                     TermBuffer* terms);
+  void GetIndexTermsForCanonicalCovering(const S2CellUnion& covering,
+                                         absl::string_view prefix,
+                                         TermBuffer* terms);
+  void GetQueryTermsForCanonicalCovering(const S2CellUnion& covering,
+                                         absl::string_view prefix,
+                                         TermBuffer* terms);
+
  private:
   enum TermType { ANCESTOR, COVERING };
 
-  std::string GetTerm(TermType term_type, const S2CellId id,
-                      absl::string_view prefix) const;
+  // Memoizes the terms generated for the most recent covering, so that
+  // consecutive documents with identical coverings can reuse them.  The
+  // prefix and the term-affecting options are part of the key.
+  struct TermMemo {
+    bool valid = false;
+    bool index_terms;  // Distinguishes index terms from query terms.
+    std::vector<S2CellId> covering;
+    std::string prefix;
+    Options options;
+    TermBuffer terms;
+  };
+
+  void AddTerm(TermType term_type, const S2CellId id, absl::string_view prefix,
+               TermBuffer* terms) const;
+  bool LookupMemo(bool index_terms, const S2CellUnion& covering,
+                  absl::string_view prefix, TermBuffer* terms) const;
+  void UpdateMemo(bool index_terms, const S2CellUnion& covering,
+                  absl::string_view prefix, const TermBuffer& terms);
 
   Options options_;
   S2RegionCoverer coverer_;
+  TermMemo memo_;
 };
 
 #endif  // S2_S2REGION_TERM_INDEXER_H_
@@ -29,6 +29,7 @@
 #include "absl/strings/str_format.h"
 
 #include "s2/base/commandlineflags.h"
+#include "s2/s1angle.h"
 #include "s2/s2cap.h"
 #include "s2/s2cell.h"
 #include "s2/s2cell_id.h"
@@ -212,6 +213,82 @@ TEST(S2RegionTermIndexer, MaxLevelSetLoosely) {
             indexer2.GetQueryTerms(cap, ""));
 }
 
+vector<string> ToVector(const S2RegionTermIndexer::TermBuffer& terms) {
+  vector<string> result;
+  result.reserve(terms.size());
+  for (int i = 0; i < terms.size(); ++i) {
+    result.emplace_back(terms.term(i));
+  }
+  return result;
+}
+
+TEST(S2RegionTermIndexer, TermBufferMatchesStringVector) {
+  // Verify that the TermBuffer variants generate exactly the same terms as
+  // the std::vector<std::string> API.  Two indexers are used so that the two
+  // code paths cannot share a memoized result.
+  S2RegionTermIndexer::Options options;
+  options.set_max_cells(8);
+  S2RegionTermIndexer indexer1(options), indexer2(options);
+  S2RegionTermIndexer::TermBuffer buffer;
+  for (int i = 0; i < 100; ++i) {
+    const S2Cap cap = S2Testing::GetRandomCap(
+        0.3 * S2Cell::AverageArea(options.max_level()),
+        4.0 * S2Cell::AverageArea(options.min_level()));
+    indexer2.GetIndexTerms(cap, "s2:", &buffer);
+    EXPECT_EQ(indexer1.GetIndexTerms(cap, "s2:"), ToVector(buffer));
+    indexer2.GetQueryTerms(cap, "s2:", &buffer);
+    EXPECT_EQ(indexer1.GetQueryTerms(cap, "s2:"), ToVector(buffer));
+
+    const S2Point point = S2Testing::RandomPoint();
+    indexer2.GetIndexTerms(point, "s2:", &buffer);
+    EXPECT_EQ(indexer1.GetIndexTerms(point, "s2:"), ToVector(buffer));
+    indexer2.GetQueryTerms(point, "s2:", &buffer);
+    EXPECT_EQ(indexer1.GetQueryTerms(point, "s2:"), ToVector(buffer));
+  }
+}
+
+TEST(S2RegionTermIndexer, MemoizedCoveringTerms) {
+  // Consecutive calls with the same canonical covering are served from a
+  // memoized copy of the previous result.  Verify that the memo is bypassed
+  // whenever the covering, term type, prefix, or options change.
+  S2RegionTermIndexer::Options options;
+  options.set_max_cells(8);
+  S2RegionTermIndexer indexer(options);
+  S2RegionCoverer coverer(options);
+  const S2Cap cap_a(S2LatLng::FromDegrees(10, 20).ToPoint(),
+                    S1Angle::Degrees(1));
+  const S2Cap cap_b(S2LatLng::FromDegrees(-30, 40).ToPoint(),
+                    S1Angle::Degrees(2));
+  const S2CellUnion covering_a = coverer.GetCovering(cap_a);
+  const S2CellUnion covering_b = coverer.GetCovering(cap_b);
+
+  S2RegionTermIndexer::TermBuffer buffer;
+  for (const S2CellUnion* covering :
+       {&covering_a, &covering_b, &covering_a, &covering_a}) {
+    indexer.GetIndexTermsForCanonicalCovering(*covering, "", &buffer);
+    EXPECT_EQ(S2RegionTermIndexer(options).GetIndexTermsForCanonicalCovering(
+                  *covering, ""),
+              ToVector(buffer));
+  }
+  // Index terms and query terms for the same covering must not be confused.
+  indexer.GetQueryTermsForCanonicalCovering(covering_a, "", &buffer);
+  EXPECT_EQ(S2RegionTermIndexer(options).GetQueryTermsForCanonicalCovering(
+                covering_a, ""),
+            ToVector(buffer));
+  // A prefix change must invalidate the memo...
+  indexer.GetQueryTermsForCanonicalCovering(covering_a, "x:", &buffer);
+  EXPECT_EQ(S2RegionTermIndexer(options).GetQueryTermsForCanonicalCovering(
+                covering_a, "x:"),
+            ToVector(buffer));
+  // ... as must an options change that affects the generated terms.
+  indexer.mutable_options()->set_optimize_for_space(true);
+  options.set_optimize_for_space(true);
+  indexer.GetQueryTermsForCanonicalCovering(covering_a, "x:", &buffer);
+  EXPECT_EQ(S2RegionTermIndexer(options).GetQueryTermsForCanonicalCovering(
+                covering_a, "x:"),
+            ToVector(buffer));
+}
+
 TEST(S2RegionTermIndexer, MoveConstructor) {
   S2RegionTermIndexer x;
   x.mutable_options()->set_max_cells(12345);
@@ -181,6 +181,18 @@ class S2Shape {
   // REQUIRES: 0 <= id < num_edges()
   virtual Edge edge(int edge_id) const = 0;
 
+  // Fills out[0..count-1] with the edges whose ids are begin..begin+count-1.
+  // Equivalent to calling edge() once per id, but a single virtual call, so
+  // hot loops can amortize the dispatch over many edges at a time.  Shapes
+  // that store their edges in a batch-friendly form (e.g. encoded shapes
+  // with per-edge lazy decoding checks) may override this with a more
+  // efficient implementation.
+  //
+  // REQUIRES: 0 <= begin && begin + count <= num_edges()
+  virtual void GetEdges(int begin, int count, Edge* out) const {
+    for (int i = 0; i < count; ++i) out[i] = edge(begin + i);
+  }
+
   // Returns the dimension of the geometry represented by this shape.
   //
   //  0 - Point geometry.  Each point is represented as a degenerate edge.
@@ -17,13 +17,22 @@
 
 #include "s2/s2shape_index.h"
 
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
 #include "s2/base/types.h"
+#include "absl/functional/function_ref.h"
 #include "absl/log/absl_check.h"
 #include "s2/util/coding/coder.h"
 #include "s2/util/coding/varint.h"
 #include "s2/util/gtl/compact_array.h"
 
 bool S2ClippedShape::ContainsEdge(int id) const {
+  if (single_run_) {
+    return id >= inline_edges_[0] && id < inline_edges_[0] + num_edges();
+  }
   // Linear search is fast because the number of edges per shape is typically
   // very small (less than 10).
   for (int e = 0; e < num_edges(); ++e) {
@@ -32,6 +41,62 @@ bool S2ClippedShape::ContainsEdge(int id) const {
   return false;
 }
 
+int S2ShapeIndex::num_edges() const {
+  int num_edges = 0;
+  for (const S2Shape* shape : *this) {
+    if (shape == nullptr) continue;
+    num_edges += shape->num_edges();
+  }
+  return num_edges;
+}
+
+bool S2ShapeIndex::ParallelVisitCells(
+    int num_threads,
+    absl::FunctionRef<bool(S2CellId, const S2ShapeIndexCell&)> visitor) const {
+  if (num_threads <= 1) {
+    for (Iterator it(this, BEGIN); !it.done(); it.Next()) {
+      if (!visitor(it.id(), it.cell())) return false;
+    }
+    return true;
+  }
+  // Partition the leaf cell space into the ranges of the cells at some fixed
+  // level, using enough chunks per thread that dynamically claiming them
+  // keeps the work balanced even when the index cells are distributed very
+  // unevenly.  Each index cell id lies in the range of exactly one chunk, so
+  // every cell is visited exactly once.
+  static constexpr int kChunksPerThread = 8;
+  int level = 0;
+  while ((6 << (2 * level)) < kChunksPerThread * num_threads &&
+         level < S2CellId::kMaxLevel) {
+    ++level;
+  }
+  const int num_chunks = 6 << (2 * level);
+  std::atomic<int> next_chunk{0};
+  std::atomic<bool> stopped{false};
+  const auto worker = [&]() {
+    Iterator it(this);
+    for (;;) {
+      int chunk = next_chunk.fetch_add(1, std::memory_order_relaxed);
+      if (chunk >= num_chunks || stopped.load(std::memory_order_relaxed)) {
+        return;
+      }
+      S2CellId chunk_id = S2CellId::Begin(level).advance(chunk);
+      it.Seek(chunk_id.range_min());
+      for (; !it.done() && it.id() <= chunk_id.range_max(); it.Next()) {
+        if (!visitor(it.id(), it.cell())) {
+          stopped.store(true, std::memory_order_relaxed);
+          return;
+        }
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (int t = 0; t < num_threads; ++t) threads.emplace_back(worker);
+  for (auto& thread : threads) thread.join();
+  return !stopped.load(std::memory_order_relaxed);
+}
+
 S2ShapeIndexCell::~S2ShapeIndexCell() {
   // Free memory for all shapes owned by this cell.
   for (S2ClippedShape& s : shapes_)
@@ -193,11 +258,9 @@ bool S2ShapeIndexCell::Decode(int num_shape_ids, Decoder* decoder) {
     if ((header & 1) == 0) {
       // The cell contains a contiguous range of edges.
       int num_edges = ((header >> 2) & 15) + 2;
-      clipped->Init(0 /*shape_id*/, num_edges);
+      clipped->InitRun(0 /*shape_id*/, static_cast<int32>(header >> 6),
+                       num_edges);
       clipped->set_contains_center((header & 2) != 0);
-      for (int i = 0, edge_id = header >> 6; i < num_edges; ++i) {
-        clipped->set_edge(i, edge_id + i);
-      }
       return true;
     }
     if ((header & 2) == 0) {
@@ -232,11 +295,8 @@ bool S2ShapeIndexCell::Decode(int num_shape_ids, Decoder* decoder) {
       if (!decoder->get_varint32(&shape_id_count)) return false;
       shape_id += shape_id_count >> 4;
       int num_edges = (shape_id_count & 15) + 1;
-      clipped->Init(shape_id, num_edges);
+      clipped->InitRun(shape_id, header >> 2, num_edges);
       clipped->set_contains_center((header & 2) != 0);
-      for (int i = 0, edge_id = header >> 2; i < num_edges; ++i) {
-        clipped->set_edge(i, edge_id + i);
-      }
     } else if ((header & 7) == 7) {
       // The clipped shape has no edges.
       shape_id += header >> 4;
@@ -51,6 +51,7 @@
 
 #include "absl/base/macros.h"
 #include "absl/base/thread_annotations.h"
+#include "absl/functional/function_ref.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/synchronization/mutex.h"
@@ -79,7 +80,7 @@ class S2PaddedCell;
 // original shape.
 class S2ClippedShape {
  public:
-  S2ClippedShape() : num_edges_(0) {}
+  S2ClippedShape() : single_run_(false), num_edges_(0) {}
 
   // The shape id of the clipped shape.
   int shape_id() const;
@@ -104,29 +105,39 @@ class S2ClippedShape {
   // This class may be copied by value, but note that it does *not* own its
   // underlying data.  (It is owned by the containing S2ShapeIndexCell.)
 
+  friend class EncodedS2ShapeIndex;
+  friend class FrozenS2ShapeIndex;
   friend class MutableS2ShapeIndex;
   friend class S2ShapeIndexCell;
   friend class S2Stats;
 
   // Internal methods are documented with their definition.
   void Init(int32 shape_id, int32 num_edges);
+  void InitRun(int32 shape_id, int32 first_edge, int32 num_edges);
   void Destruct();
   bool is_inline() const;
+  bool is_single_run() const;
   void set_contains_center(bool contains_center);
   void set_edge(int i, int edge);
 
   // All fields are packed into 16 bytes (assuming 64-bit pointers).  Up to
   // two edge ids are stored inline; this is an important optimization for
-  // clients that use S2Shapes consisting of a single edge.
+  // clients that use S2Shapes consisting of a single edge.  In addition, any
+  // number of edges with consecutive ids are stored inline as a single
+  // (first_edge, num_edges) run; this is an important optimization for
+  // polylines, where consecutive edges of a chain typically intersect the
+  // same cell.
   int32 shape_id_;
   uint32 contains_center_ : 1;  // shape contains the cell center
-  uint32 num_edges_ : 31;
+  uint32 single_run_ : 1;       // edge ids form a single contiguous run
+  uint32 num_edges_ : 30;
 
   // The maximum number of edges that we can store inline in the union.
   static constexpr int kMaxInlineEdges = 2;
 
-  // If there are more than two edges, this field holds a pointer.
-  // Otherwise it holds an array of edge ids.
+  // If there are more than two edges and they do not form a contiguous run,
+  // this field holds a pointer.  Otherwise it holds an array of edge ids, or
+  // (if single_run_ is set) the first edge id of the run.
   union {
     int32* edges_;  // Owned by the containing S2ShapeIndexCell.
     std::array<int32, kMaxInlineEdges> inline_edges_;
@@ -180,6 +191,7 @@ class S2ShapeIndexCell {
  private:
   friend class MutableS2ShapeIndex;
   friend class EncodedS2ShapeIndex;
+  friend class FrozenS2ShapeIndex;
   friend class S2Stats;
 
   // Internal methods are documented with their definitions.
@@ -318,6 +330,13 @@ class S2ShapeIndex {
   // has been removed from the index.
   virtual const S2Shape* shape(int id) const = 0;
 
+  // Returns the total number of edges and points in all indexed shapes.  The
+  // default implementation takes time linear in the number of shapes; some
+  // subclasses maintain this count incrementally and return it in constant
+  // time (e.g. MutableS2ShapeIndex), which makes it suitable for per-query
+  // strategy selection such as the brute force cutover in S2ClosestEdgeQuery.
+  virtual int num_edges() const;
+
   // Stores an encoded representation of the index into the given encoder.
   virtual void Encode(Encoder* encoder) const = 0;
 
@@ -366,6 +385,26 @@ class S2ShapeIndex {
   // Like all non-const methods, this method is not thread-safe.
   virtual void Minimize() = 0;
 
+  // Visits every cell of the index exactly once using up to "num_threads"
+  // threads, and returns true unless some visitor call returned false.  The
+  // leaf cell space is partitioned into many more chunks than threads, and
+  // the chunks are claimed dynamically so that the work stays balanced even
+  // when the cells are distributed very unevenly.  This gives read-side batch
+  // jobs (measurement, validation, export) a correct parallel foundation
+  // without manually partitioning iterators.
+  //
+  // Note that there is no guaranteed visitation order, and that cells of one
+  // chunk are visited by a single thread; "visitor" must be safe to invoke
+  // concurrently.  If a visitor call returns false the traversal stops early,
+  // in which case other threads may each still visit a bounded number of
+  // additional cells before observing the stop.
+  //
+  // REQUIRES: The index is not modified for the duration of the call.
+  bool ParallelVisitCells(
+      int num_threads,
+      absl::FunctionRef<bool(S2CellId, const S2ShapeIndexCell&)> visitor)
+      const;
+
   // When passed to an Iterator constructor, specifies whether the iterator
   // should be positioned at the beginning of the index (BEGIN), the end of
   // the index (END), or arbitrarily (UNPOSITIONED).  By default iterators are
@@ -538,12 +577,14 @@ inline int S2ClippedShape::num_edges() const {
 }
 
 inline int S2ClippedShape::edge(int i) const {
+  if (single_run_) return inline_edges_[0] + i;
   return is_inline() ? inline_edges_[i] : edges_[i];
 }
 
 // Initialize an S2ClippedShape to hold the given number of edges.
 inline void S2ClippedShape::Init(int32 shape_id, int32 num_edges) {
   shape_id_ = shape_id;
+  single_run_ = false;
   num_edges_ = num_edges;
   contains_center_ = false;
   if (!is_inline()) {
@@ -551,6 +592,18 @@ inline void S2ClippedShape::Init(int32 shape_id, int32 num_edges) {
   }
 }
 
+// Initialize an S2ClippedShape whose edge ids are the contiguous run
+// [first_edge, first_edge + num_edges).  No edge array is allocated
+// regardless of the number of edges, and set_edge() must not be called.
+inline void S2ClippedShape::InitRun(int32 shape_id, int32 first_edge,
+                                    int32 num_edges) {
+  shape_id_ = shape_id;
+  single_run_ = true;
+  num_edges_ = num_edges;
+  contains_center_ = false;
+  inline_edges_[0] = first_edge;
+}
+
 // Free any memory allocated by this S2ClippedShape.  We don't do this in
 // the destructor because S2ClippedShapes are copied by STL code, and we
 // don't want to repeatedly copy and free the edge data.  Instead the data
@@ -560,7 +613,11 @@ inline void S2ClippedShape::Destruct() {
 }
 
 inline bool S2ClippedShape::is_inline() const {
-  return num_edges_ <= kMaxInlineEdges;
+  return single_run_ || num_edges_ <= kMaxInlineEdges;
+}
+
+inline bool S2ClippedShape::is_single_run() const {
+  return single_run_;
 }
 
 // Set "contains_center_" to indicate whether this clipped shape contains the
@@ -18,6 +18,7 @@
 #include "s2/s2shape_index_buffered_region.h"
 
 #include <algorithm>
+#include <utility>
 #include <vector>
 
 #include "s2/s1angle.h"
@@ -25,6 +26,7 @@
 #include "s2/s2cap.h"
 #include "s2/s2cell.h"
 #include "s2/s2cell_id.h"
+#include "s2/s2cell_union.h"
 #include "s2/s2closest_edge_query.h"
 #include "s2/s2latlng_rect.h"
 #include "s2/s2metrics.h"
@@ -43,6 +45,7 @@ void S2ShapeIndexBufferedRegion::Init(const S2ShapeIndex* index,
   radius_successor_ = radius.Successor();
   query_.Init(index);
   query_.mutable_options()->set_include_interiors(true);
+  contained_cells_.clear();
 }
 
 S2ShapeIndexBufferedRegion* S2ShapeIndexBufferedRegion::Clone() const {
@@ -87,17 +90,35 @@ void S2ShapeIndexBufferedRegion::GetCellUnionBound(vector<S2CellId> *cellids)
   }
 }
 
+bool S2ShapeIndexBufferedRegion::AncestorIsContained(S2CellId id) const {
+  if (contained_cells_.empty()) return false;
+  for (int level = id.level(); level >= 0; --level) {
+    if (contained_cells_.contains(id.parent(level))) return true;
+  }
+  return false;
+}
+
 bool S2ShapeIndexBufferedRegion::Contains(const S2Cell& cell) const {
   // Return true if the buffered region is guaranteed to cover whole globe.
   if (radius_successor_ > S1ChordAngle::Straight()) return true;
 
+  // Containment is inherited, so if an ancestor of this cell has already
+  // been classified as contained then no distance query is needed.  This
+  // situation arises frequently during S2RegionCoverer::GetCovering, which
+  // may visit the same interior subtrees repeatedly (e.g., via the
+  // overlapping cells returned by GetCellUnionBound).
+  if (AncestorIsContained(cell.id())) return true;
+
   // To implement this method perfectly would require computing the directed
   // Hausdorff distance, which is expensive (and not currently implemented).
   // However the following heuristic is almost as good in practice and much
   // cheaper to compute.
 
   // Return true if the unbuffered region contains this cell.
-  if (MakeS2ShapeIndexRegion(&index()).Contains(cell)) return true;
+  if (MakeS2ShapeIndexRegion(&index()).Contains(cell)) {
+    contained_cells_.insert(cell.id());
+    return true;
+  }
 
   // Otherwise approximate the cell by its bounding cap.
   //
@@ -111,17 +132,60 @@ bool S2ShapeIndexBufferedRegion::Contains(const S2Cell& cell) const {
   // Return true if the distance to the cell center plus the radius of the
   // cell's bounding cap is less than or equal to "radius_".
   S2ClosestEdgeQuery::PointTarget target(cell.GetCenter());
-  return query_.IsDistanceLess(&target, radius_successor_ - cap.radius());
+  if (!query_.IsDistanceLess(&target, radius_successor_ - cap.radius())) {
+    return false;
+  }
+  contained_cells_.insert(cell.id());
+  return true;
 }
 
 bool S2ShapeIndexBufferedRegion::MayIntersect(const S2Cell& cell) const {
+  // A cell whose ancestor is entirely contained certainly intersects.
+  if (AncestorIsContained(cell.id())) return true;
+
   // Return true if the distance is less than or equal to "radius_".
   S2ClosestEdgeQuery::CellTarget target(cell);
   return query_.IsDistanceLess(&target, radius_successor_);
 }
 
 bool S2ShapeIndexBufferedRegion::Contains(const S2Point& p) const {
+  if (AncestorIsContained(S2CellId(p))) return true;
+
   S2ClosestEdgeQuery::PointTarget target(p);
   // Return true if the distance is less than or equal to "radius_".
   return query_.IsDistanceLess(&target, radius_successor_);
 }
+
+S2CellUnion S2DilateCovering(const S2CellUnion& covering, S1Angle radius) {
+  // Find the deepest level whose cells are guaranteed to be at least
+  // "radius" wide, so that a ring of neighbors at that level around a cell
+  // contains all points within "radius" of it.  As in GetCellUnionBound
+  // above, one extra level of slack is subtracted to be conservative.
+  int max_level = S2::kMinWidth.GetLevelForMinValue(radius.radians()) - 1;
+  vector<S2CellId> output;
+  if (max_level < 0) {
+    S2Cap::Full().GetCellUnionBound(&output);
+    return S2CellUnion(std::move(output));
+  }
+  output.reserve(9 * covering.num_cells());
+  S2CellId last = S2CellId::None();
+  for (S2CellId id : covering) {
+    if (id.level() > max_level) id = id.parent(max_level);
+    // The input cells are sorted, so duplicate parents are adjacent.
+    if (id == last) continue;
+    last = id;
+    output.push_back(id);
+    id.AppendAllNeighbors(id.level(), &output);
+  }
+  return S2CellUnion(std::move(output));  // Normalizes the result.
+}
+
+S2CellUnion S2GetFastBufferedCovering(const S2ShapeIndex& index,
+                                      S1Angle radius) {
+  vector<S2CellId> cells;
+  for (S2ShapeIndex::Iterator it(&index, S2ShapeIndex::BEGIN); !it.done();
+       it.Next()) {
+    cells.push_back(it.id());
+  }
+  return S2DilateCovering(S2CellUnion(std::move(cells)), radius);
+}
@@ -20,6 +20,7 @@
 
 #include <vector>
 
+#include "absl/container/flat_hash_set.h"
 #include "s2/s1angle.h"
 #include "s2/s1chord_angle.h"
 #include "s2/s2cap.h"
@@ -107,6 +108,10 @@ class S2ShapeIndexBufferedRegion final : public S2Region {
   bool Contains(const S2Point& p) const override;
 
  private:
+  // Returns true if "id" or one of its ancestors has previously been
+  // determined to be entirely contained by the buffered region.
+  bool AncestorIsContained(S2CellId id) const;
+
   S1ChordAngle radius_;
 
   // In order to handle (radius_ == 0) corectly, we need to test whether
@@ -115,8 +120,35 @@ class S2ShapeIndexBufferedRegion final : public S2Region {
   S1ChordAngle radius_successor_;
 
   mutable S2ClosestEdgeQuery query_;  // This class is not thread-safe!
+
+  // Memoizes the cells that Contains() has determined to be entirely
+  // contained by the buffered region.  Since containment is inherited by all
+  // descendant cells, this makes repeated Contains/MayIntersect calls for
+  // interior subtrees during S2RegionCoverer::GetCovering amortized O(1)
+  // instead of requiring a closest-edge query per cell.
+  mutable absl::flat_hash_set<S2CellId> contained_cells_;
 };
 
+// Returns a cell union containing all points within "radius" of the given
+// covering.  The result is computed purely from the cell ids: each cell is
+// surrounded by a ring of neighbor cells at a level coarse enough that the
+// ring is guaranteed to be at least "radius" wide.  This is much cheaper
+// than covering an S2ShapeIndexBufferedRegion with S2RegionCoverer (which
+// runs a closest-edge query per candidate cell), but the result is
+// correspondingly less tight: the dilated covering may extend several radii
+// beyond the buffered geometry, particularly when "radius" is small compared
+// to the cells of the input covering.
+S2CellUnion S2DilateCovering(const S2CellUnion& covering, S1Angle radius);
+
+// Returns a covering of all points within "radius" of the geometry in
+// "index", computed by dilating the index's own covering cells with
+// S2DilateCovering (no distance queries are made).  The result is a
+// conservative superset of the buffered geometry and is suitable as a cheap
+// pre-filter for candidate retrieval; when a tight covering is needed, use
+// S2ShapeIndexBufferedRegion with S2RegionCoverer instead.
+S2CellUnion S2GetFastBufferedCovering(const S2ShapeIndex& index,
+                                      S1Angle radius);
+
 
 //////////////////   Implementation details follow   ////////////////////
 
@@ -193,3 +193,72 @@ TEST(S2ShapeIndexBufferedRegion, HugeBufferRadius) {
   coverer.mutable_options()->set_max_cells(100);
   TestBufferIndex("10:20 # #", S1Angle::Degrees(200), &coverer);
 }
+
+TEST(S2DilateCovering, HugeRadiusReturnsFullCovering) {
+  S2CellUnion covering({S2CellId(MakePointOrDie("10:20")).parent(5)});
+  S2CellUnion dilated = S2DilateCovering(covering, S1Angle::Degrees(180));
+  ASSERT_EQ(6, dilated.num_cells());
+  for (S2CellId id : dilated) {
+    EXPECT_TRUE(id.is_face());
+  }
+}
+
+TEST(S2DilateCovering, ContainsAllPointsWithinRadius) {
+  S2CellId id = S2CellId(MakePointOrDie("30:40")).parent(10);
+  S2CellUnion covering({id});
+  S1Angle radius = S1Angle::Degrees(0.1);
+  S2CellUnion dilated = S2DilateCovering(covering, radius);
+  EXPECT_TRUE(dilated.Contains(covering));
+
+  // Check random points within "radius" of the cell's vertices (the points
+  // of the cell farthest from the interior of the dilated covering).
+  S2Cell cell(id);
+  for (int k = 0; k < 4; ++k) {
+    S2Cap cap(cell.GetVertex(k), radius);
+    for (int i = 0; i < 50; ++i) {
+      EXPECT_TRUE(dilated.Contains(S2CellId(S2Testing::SamplePoint(cap))));
+    }
+  }
+}
+
+TEST(S2GetFastBufferedCovering, CoversBufferedGeometry) {
+  // Verify the covering the same way as TestBufferIndex: convert it to an
+  // S2Polygon and check that the polygon contains the original geometry with
+  // at least "radius" to spare.
+  auto index = MakeIndexOrDie("# 10:5, 20:30, -10:60 #");
+  S1Angle radius = S1Angle::Degrees(2);
+  S2CellUnion covering = S2GetFastBufferedCovering(*index, radius);
+  S2Polygon covering_polygon;
+  covering_polygon.InitToCellUnionBorder(covering);
+  MutableS2ShapeIndex covering_index;
+  covering_index.Add(make_unique<S2Polygon::Shape>(&covering_polygon));
+  EXPECT_TRUE(S2BooleanOperation::Contains(covering_index, *index));
+
+  S2ClosestEdgeQuery query(&covering_index);
+  query.mutable_options()->set_include_interiors(false);
+  S2ClosestEdgeQuery::ShapeIndexTarget target(index.get());
+  EXPECT_FALSE(query.IsDistanceLess(&target, S1ChordAngle(radius)));
+}
+
+TEST(S2ShapeIndexBufferedRegion, CachedContainmentMatchesFreshRegion) {
+  // Contains() memoizes cells classified as entirely contained, and later
+  // queries for their descendants are answered from the cache.  Verify that
+  // the answers for descendant cells match those of a freshly constructed
+  // region (which has an empty cache).
+  auto index = MakeIndexOrDie("10:20 # #");
+  S1ChordAngle radius(S1Angle::Degrees(5));
+  S2ShapeIndexBufferedRegion region(index.get(), radius);
+
+  S2CellId center_id(MakePointOrDie("10:20"));
+  S2CellId parent_id = center_id.parent(8);
+  ASSERT_TRUE(region.Contains(S2Cell(parent_id)));
+  for (S2CellId id = parent_id.child_begin(12); id != parent_id.child_end(12);
+       id = id.next()) {
+    S2ShapeIndexBufferedRegion fresh_region(index.get(), radius);
+    S2Cell cell(id);
+    EXPECT_TRUE(region.Contains(cell));
+    EXPECT_EQ(fresh_region.Contains(cell), region.Contains(cell));
+    EXPECT_TRUE(region.MayIntersect(cell));
+    EXPECT_TRUE(region.Contains(cell.GetCenter()));
+  }
+}
@@ -18,6 +18,9 @@
 #include "s2/s2shape_index_measures.h"
 
 #include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 #include "s2/s1angle.h"
 #include "s2/s2point.h"
@@ -27,6 +30,48 @@
 
 namespace S2 {
 
+namespace {
+
+// Evaluates "shape_fn" for every shape in the index using up to "num_threads"
+// threads and returns the sum of the results.  Shape ids are claimed
+// dynamically from a shared counter so that threads stay busy even when a few
+// shapes are much larger than the rest.  The per-shape values are stored in a
+// vector indexed by shape id and summed in shape id order, so the result is
+// identical to summing serially (and independent of the thread count).
+template <class T, class ShapeFn>
+T ParallelAccumulate(const S2ShapeIndex& index, int num_threads,
+                     const ShapeFn& shape_fn) {
+  const int num_shapes = index.num_shape_ids();
+  if (num_threads <= 1 || num_shapes <= 1) {
+    T sum = T();
+    for (int i = 0; i < num_shapes; ++i) {
+      const S2Shape* shape = index.shape(i);
+      if (shape) sum += shape_fn(*shape);
+    }
+    return sum;
+  }
+  std::vector<T> results(num_shapes, T());
+  std::atomic<int> next_shape{0};
+  const auto worker = [&]() {
+    for (;;) {
+      int i = next_shape.fetch_add(1, std::memory_order_relaxed);
+      if (i >= num_shapes) return;
+      const S2Shape* shape = index.shape(i);
+      if (shape) results[i] = shape_fn(*shape);
+    }
+  };
+  std::vector<std::thread> threads;
+  const int threads_to_spawn = std::min(num_threads, num_shapes);
+  threads.reserve(threads_to_spawn);
+  for (int t = 0; t < threads_to_spawn; ++t) threads.emplace_back(worker);
+  for (auto& thread : threads) thread.join();
+  T sum = T();
+  for (int i = 0; i < num_shapes; ++i) sum += results[i];
+  return sum;
+}
+
+}  // namespace
+
 int GetDimension(const S2ShapeIndex& index) {
   int dim = -1;
   for (int i = 0; i < index.num_shape_ids(); ++i) {
@@ -95,4 +140,36 @@ S2Point GetCentroid(const S2ShapeIndex& index) {
   return centroid;
 }
 
+S1Angle GetLength(const S2ShapeIndex& index, int num_threads) {
+  return ParallelAccumulate<S1Angle>(
+      index, num_threads,
+      [](const S2Shape& shape) { return S2::GetLength(shape); });
+}
+
+S1Angle GetPerimeter(const S2ShapeIndex& index, int num_threads) {
+  return ParallelAccumulate<S1Angle>(
+      index, num_threads,
+      [](const S2Shape& shape) { return S2::GetPerimeter(shape); });
+}
+
+double GetArea(const S2ShapeIndex& index, int num_threads) {
+  return ParallelAccumulate<double>(
+      index, num_threads,
+      [](const S2Shape& shape) { return S2::GetArea(shape); });
+}
+
+double GetApproxArea(const S2ShapeIndex& index, int num_threads) {
+  return ParallelAccumulate<double>(
+      index, num_threads,
+      [](const S2Shape& shape) { return S2::GetApproxArea(shape); });
+}
+
+S2Point GetCentroid(const S2ShapeIndex& index, int num_threads) {
+  int dim = GetDimension(index);
+  return ParallelAccumulate<S2Point>(
+      index, num_threads, [dim](const S2Shape& shape) {
+        return shape.dimension() == dim ? S2::GetCentroid(shape) : S2Point();
+      });
+}
+
 }  // namespace S2
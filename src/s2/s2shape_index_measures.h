@@ -95,6 +95,21 @@ double GetApproxArea(const S2ShapeIndex& index);
 // centroids can simply be summed).
 S2Point GetCentroid(const S2ShapeIndex& index);
 
+// Versions of the measures above that evaluate the shapes using up to
+// "num_threads" threads.  Shapes are claimed dynamically so that the work
+// stays balanced even when edge counts vary wildly between shapes, and the
+// per-shape results are summed in shape id order, so the results are
+// identical to the serial versions.  This is worthwhile for indexes with many
+// shapes and/or very large shapes (e.g. computing measures for every shape of
+// a continental dataset).
+//
+// REQUIRES: The index is not modified for the duration of the call.
+S1Angle GetLength(const S2ShapeIndex& index, int num_threads);
+S1Angle GetPerimeter(const S2ShapeIndex& index, int num_threads);
+double GetArea(const S2ShapeIndex& index, int num_threads);
+double GetApproxArea(const S2ShapeIndex& index, int num_threads);
+S2Point GetCentroid(const S2ShapeIndex& index, int num_threads);
+
 }  // namespace S2
 
 #endif  // S2_S2SHAPE_INDEX_MEASURES_H_
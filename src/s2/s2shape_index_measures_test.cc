@@ -27,6 +27,7 @@
 #include <string>
 
 #include <gtest/gtest.h>
+#include "absl/strings/str_cat.h"
 #include "s2/mutable_s2shape_index.h"
 #include "s2/s1angle.h"
 #include "s2/s2point.h"
@@ -138,4 +139,41 @@ TEST(GetCentroid, Polygon) {
       S2::GetCentroid(*MakeIndexOrDie("5:5 # 6:6, 7:7 # 0:0, 0:90, 90:0"))));
 }
 
+TEST(ParallelMeasures, MatchSerialMeasures) {
+  // Build an index with many shapes of all three dimensions so that the
+  // worker threads have a meaningful number of shapes to claim.
+  std::string points, lines, polygons;
+  for (int i = 0; i < 50; ++i) {
+    if (i > 0) {
+      points += " | ";
+      lines += " | ";
+      polygons += " | ";
+    }
+    absl::StrAppend(&points, i, ":", i);
+    absl::StrAppend(&lines, i, ":0, ", i, ":1");
+    absl::StrAppend(&polygons, i, ":10, ", i, ":11, ", i, ".5:10.5");
+  }
+  const auto index = MakeIndexOrDie(points + " # " + lines + " # " + polygons);
+
+  // The parallel versions sum the per-shape results in shape id order, so
+  // they are required to match the serial versions exactly.
+  for (int num_threads : {1, 4}) {
+    EXPECT_EQ(S2::GetLength(*index), S2::GetLength(*index, num_threads));
+    EXPECT_EQ(S2::GetPerimeter(*index), S2::GetPerimeter(*index, num_threads));
+    EXPECT_EQ(S2::GetArea(*index), S2::GetArea(*index, num_threads));
+    EXPECT_EQ(S2::GetApproxArea(*index),
+              S2::GetApproxArea(*index, num_threads));
+    EXPECT_EQ(S2::GetCentroid(*index), S2::GetCentroid(*index, num_threads));
+  }
+}
+
+TEST(ParallelMeasures, Empty) {
+  const auto index = MakeIndexOrDie("# #");
+  EXPECT_EQ(S1Angle::Zero(), S2::GetLength(*index, 4));
+  EXPECT_EQ(S1Angle::Zero(), S2::GetPerimeter(*index, 4));
+  EXPECT_EQ(0.0, S2::GetArea(*index, 4));
+  EXPECT_EQ(0.0, S2::GetApproxArea(*index, 4));
+  EXPECT_EQ(S2Point(0, 0, 0), S2::GetCentroid(*index, 4));
+}
+
 }  // namespace
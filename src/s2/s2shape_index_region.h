@@ -17,10 +17,12 @@
 #ifndef S2_S2SHAPE_INDEX_REGION_H_
 #define S2_S2SHAPE_INDEX_REGION_H_
 
+#include <cstddef>
 #include <utility>
 #include <vector>
 
 #include "absl/base/optimization.h"
+#include "absl/types/span.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/functional/function_ref.h"
 #include "absl/log/absl_check.h"
@@ -110,6 +112,14 @@ class S2ShapeIndexRegion final : public S2Region {
   // error is less than 10 * DBL_EPSILON radians (or about 15 nanometers).
   bool MayIntersect(const S2Cell& target) const override;
 
+  // Computes MayIntersect() for a sorted batch of cells in a single forward
+  // sweep of the index, reusing the iterator position from one cell to
+  // answer the next without a seek where possible.  This is the common case
+  // for the frontiers produced by S2RegionCoverer, where consecutive
+  // candidate cells often lie within a single index cell.
+  void MayIntersectCells(absl::Span<const S2Cell> cells,
+                         bool* may_intersect) const override;
+
   // Visits all shapes that intersect an S2Cell, passing a shape id and a flag
   // indicating whether the S2Cell was fully contained by the shape to a
   // visitor.  Each shape is visited at most once.
@@ -163,6 +173,11 @@ class S2ShapeIndexRegion final : public S2Region {
   // REQUIRES: iter_.id() contains "p".
   bool Contains(const S2ClippedShape& clipped, const S2Point& p) const;
 
+  // Returns MayIntersect(target) given that the index cell at iter_ is an
+  // ancestor of (or equal to) "target", i.e. Locate(target.id()) would
+  // return INDEXED with the iterator unmoved.
+  bool MayIntersectIndexed(const S2Cell& target) const;
+
   // Returns true if any edge of the indexed shape "clipped" intersects the
   // cell "target".  It may also return true if an edge is very close to
   // "target"; the maximum error is less than 10 * DBL_EPSILON radians (about
@@ -342,7 +357,12 @@ bool S2ShapeIndexRegion<IndexType>::MayIntersect(const S2Cell& target) const {
   if (relation == S2CellRelation::SUBDIVIDED) return true;
 
   // Otherwise, the iterator points to an index cell containing "target".
-  //
+  return MayIntersectIndexed(target);
+}
+
+template <class IndexType>
+bool S2ShapeIndexRegion<IndexType>::MayIntersectIndexed(
+    const S2Cell& target) const {
   // If "target" is an index cell itself, there is an intersection because index
   // cells are created only if they have at least one edge or they are
   // entirely contained by the loop.
@@ -359,6 +379,28 @@ bool S2ShapeIndexRegion<IndexType>::MayIntersect(const S2Cell& target) const {
   return false;
 }
 
+template <class IndexType>
+void S2ShapeIndexRegion<IndexType>::MayIntersectCells(
+    absl::Span<const S2Cell> cells, bool* may_intersect) const {
+  // The cells are resolved in order.  Whenever the iterator is already
+  // positioned on an ancestor of the next cell, the Locate() call inside
+  // MayIntersect() would return INDEXED with the iterator unmoved, so the
+  // seek can be skipped entirely.  This is the common case for the
+  // frontiers produced by S2RegionCoverer: the four children of a
+  // subdivided candidate usually all lie within one index cell, turning
+  // four index seeks into one.
+  for (size_t i = 0; i < cells.size(); ++i) {
+    const S2Cell& target = cells[i];
+    ABSL_DCHECK(i == 0 || cells[i - 1].id().range_max() <
+                              target.id().range_min());
+    if (!iter_.done() && iter_.id().contains(target.id())) {
+      may_intersect[i] = MayIntersectIndexed(target);
+    } else {
+      may_intersect[i] = MayIntersect(target);
+    }
+  }
+}
+
 template <class IndexType>
 bool S2ShapeIndexRegion<IndexType>::VisitIntersectingShapeIds(
     const S2Cell& target,
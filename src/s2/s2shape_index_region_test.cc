@@ -187,6 +187,35 @@ TEST(S2ShapeIndexRegion, IntersectsExactCell) {
   }
 }
 
+TEST(S2ShapeIndexRegion, MayIntersectCellsMatchesMayIntersect) {
+  // Verifies that batch evaluation of sorted cells returns exactly the same
+  // results as per-cell MayIntersect(), for frontiers like those produced by
+  // S2RegionCoverer (the four children of a cell) at a variety of levels.
+  MutableS2ShapeIndex index;
+  S2Cap center_cap(S2Point(1, 0, 0), S1Angle::Radians(0.5));
+  S2Fractal fractal;
+  for (int i = 0; i < 5; ++i) {
+    fractal.SetLevelForApproxMaxEdges(3 * 64);
+    S2Point center = S2Testing::SamplePoint(center_cap);
+    index.Add(make_unique<S2Loop::OwningShape>(
+        fractal.MakeLoop(S2Testing::GetRandomFrameAt(center),
+                         S1Angle::Radians(0.1 * S2Testing::rnd.RandDouble()))));
+  }
+  auto region = MakeS2ShapeIndexRegion(&index);
+  auto expected_region = MakeS2ShapeIndexRegion(&index);
+  for (int iter = 0; iter < 500; ++iter) {
+    S2CellId parent = S2Testing::GetRandomCellId(S2Testing::rnd.Uniform(20));
+    S2Cell children[4];
+    S2Cell(parent).Subdivide(children);
+    bool may_intersect[4];
+    region.MayIntersectCells(children, may_intersect);
+    for (int i = 0; i < 4; ++i) {
+      EXPECT_EQ(expected_region.MayIntersect(children[i]), may_intersect[i])
+          << children[i].id();
+    }
+  }
+}
+
 // Tests that VisitIntersectingShapes() produces results that are consistent
 // with MayIntersect() and Contains() for the given S2ShapeIndex.  It tests
 // all cells in the given index, all ancestors of those cells, and a randomly
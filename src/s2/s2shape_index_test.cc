@@ -17,10 +17,23 @@
 
 #include "s2/s2shape_index.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include <gtest/gtest.h>
+#include "absl/synchronization/mutex.h"
+#include "s2/mutable_s2shape_index.h"
+#include "s2/s1angle.h"
+#include "s2/s2cell_id.h"
+#include "s2/s2loop.h"
+#include "s2/s2point.h"
 #include "s2/s2shape.h"
 #include "s2/s2text_format.h"
 
+using std::make_unique;
+
 // TODO(ericv): Add tests for S2ShapeIndexCell and S2ClippedShape.
 // (Currently these are tested indirectly by MutableS2ShapeIndex.)
 // Also test the base Iterator type (which wraps another iterator).
@@ -46,3 +59,44 @@ TEST(S2ShapeIndexIterator, PostfixIncrement) {
   }
   EXPECT_EQ(count, 3);
 }
+
+TEST(S2ShapeIndex, ParallelVisitCellsMatchesSerialIteration) {
+  // Use a large loop so that the index contains many cells.
+  MutableS2ShapeIndex index;
+  index.Add(make_unique<S2Loop::OwningShape>(S2Loop::MakeRegularLoop(
+      S2Point(1, 2, 3).Normalize(), S1Angle::Degrees(20), 1000)));
+
+  std::vector<S2CellId> expected;
+  for (MutableS2ShapeIndex::Iterator it(&index, S2ShapeIndex::BEGIN);
+       !it.done(); it.Next()) {
+    expected.push_back(it.id());
+  }
+
+  for (int num_threads : {1, 4}) {
+    absl::Mutex mutex;
+    std::vector<S2CellId> actual;
+    EXPECT_TRUE(index.ParallelVisitCells(
+        num_threads, [&](S2CellId id, const S2ShapeIndexCell& cell) {
+          EXPECT_GT(cell.num_clipped(), 0);
+          absl::MutexLock lock(&mutex);
+          actual.push_back(id);
+          return true;
+        }));
+    std::sort(actual.begin(), actual.end());
+    EXPECT_EQ(expected, actual);
+  }
+}
+
+TEST(S2ShapeIndex, ParallelVisitCellsCanStopEarly) {
+  MutableS2ShapeIndex index;
+  index.Add(make_unique<S2Loop::OwningShape>(S2Loop::MakeRegularLoop(
+      S2Point(1, 2, 3).Normalize(), S1Angle::Degrees(20), 1000)));
+
+  std::atomic<int> num_visited{0};
+  EXPECT_FALSE(index.ParallelVisitCells(
+      4, [&](S2CellId id, const S2ShapeIndexCell& cell) {
+        num_visited.fetch_add(1);
+        return false;
+      }));
+  EXPECT_GT(num_visited.load(), 0);
+}
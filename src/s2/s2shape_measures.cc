@@ -23,6 +23,8 @@
 #include "s2/base/log_severity.h"
 #include "absl/log/absl_check.h"
 #include "s2/s1angle.h"
+#include "s2/s2latlng_rect.h"
+#include "s2/s2latlng_rect_bounder.h"
 #include "s2/s2loop_measures.h"
 #include "s2/s2point.h"
 #include "s2/s2point_span.h"
@@ -137,6 +139,52 @@ S2Point GetCentroid(const S2Shape& shape) {
   return centroid;
 }
 
+ShapeStats ComputeShapeStats(const S2Shape& shape, int stats_mask) {
+  ShapeStats stats;
+  const int dimension = shape.dimension();
+  if (stats_mask & kShapeStatsNumEdges) stats.num_edges = shape.num_edges();
+  const bool need_bound = (stats_mask & kShapeStatsBound) != 0;
+  const bool need_length = (stats_mask & kShapeStatsLength) && dimension == 1;
+  const bool need_centroid = (stats_mask & kShapeStatsCentroid) != 0;
+  if (!need_bound && !need_length && !need_centroid) return stats;
+
+  vector<S2Point> vertices;
+  int num_chains = shape.num_chains();
+  for (int chain_id = 0; chain_id < num_chains; ++chain_id) {
+    if (dimension == 0) {
+      const S2Point v = shape.edge(chain_id).v0;
+      if (need_bound) {
+        S2LatLngRectBounder bounder;
+        bounder.AddPoint(v);
+        stats.bound = stats.bound.Union(bounder.GetBound());
+      }
+      if (need_centroid) stats.centroid += v;
+      continue;
+    }
+    // Fetch the chain vertices once and update every requested accumulator
+    // from the same buffer.
+    GetChainVertices(shape, chain_id, &vertices);
+    if (need_bound) {
+      // Each chain gets its own bounder, since the bounder treats
+      // consecutive points as edges and consecutive chains are not
+      // connected.
+      S2LatLngRectBounder bounder;
+      for (const S2Point& v : vertices) bounder.AddPoint(v);
+      // Chains of 2-dimensional shapes are loops, so the bound must include
+      // the closing edge as well.
+      if (dimension == 2 && !vertices.empty()) bounder.AddPoint(vertices[0]);
+      stats.bound = stats.bound.Union(bounder.GetBound());
+    }
+    if (need_length) stats.length += S2::GetLength(S2PointSpan(vertices));
+    if (need_centroid) {
+      stats.centroid += dimension == 1
+                            ? S2::GetCentroid(S2PointSpan(vertices))
+                            : S2::GetCentroid(S2PointLoopSpan(vertices));
+    }
+  }
+  return stats;
+}
+
 void GetChainVertices(const S2Shape& shape, int chain_id,
                       vector<S2Point>* vertices) {
   S2Shape::Chain chain = shape.chain(chain_id);
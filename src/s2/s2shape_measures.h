@@ -25,6 +25,7 @@
 #include <vector>
 
 #include "s2/s1angle.h"
+#include "s2/s2latlng_rect.h"
 #include "s2/s2point.h"
 #include "s2/s2shape.h"
 
@@ -81,6 +82,38 @@ double GetApproxArea(const S2Shape& shape);
 // centroids of all shapes in the collection whose dimension is maximal.)
 S2Point GetCentroid(const S2Shape& shape);
 
+// Bit flags selecting which statistics ComputeShapeStats() gathers.  Values
+// may be bitwise-ORed together.
+enum ShapeStatsMask {
+  kShapeStatsBound = 1,     // A bounding rectangle of the shape.
+  kShapeStatsNumEdges = 2,  // The number of edges (or points) in the shape.
+  kShapeStatsLength = 4,    // GetLength(shape).
+  kShapeStatsCentroid = 8,  // GetCentroid(shape).
+  kShapeStatsAll = 15,
+};
+
+// The statistics gathered by ComputeShapeStats().  Fields whose flag was not
+// requested are left at their default (empty or zero) values.
+struct ShapeStats {
+  S2LatLngRect bound = S2LatLngRect::Empty();
+  int num_edges = 0;
+  S1Angle length = S1Angle::Zero();
+  S2Point centroid = S2Point();
+};
+
+// Computes the statistics selected by "stats_mask" in a single pass over the
+// shape.  The results are identical to calling GetLength(), GetCentroid(),
+// etc. separately, but the vertices of each chain are fetched from the shape
+// only once and all requested accumulators are updated from the same
+// in-memory buffer.  This matters for shapes whose edge accessors are
+// expensive (e.g. lazily decoded shapes), where separate calls would decode
+// every vertex once per statistic.
+//
+// The bound is computed with S2LatLngRectBounder and therefore contains the
+// geodesic edges of the shape, not just its vertices.
+ShapeStats ComputeShapeStats(const S2Shape& shape,
+                             int stats_mask = kShapeStatsAll);
+
 // Overwrites "vertices" with the vertices of the given edge chain of "shape".
 // If dimension == 1, the chain will have (chain.length + 1) vertices, and
 // otherwise it will have (chain.length) vertices.
@@ -145,4 +145,45 @@ TEST(GetCentroid, Polygon) {
       S2::GetCentroid(*MakeLaxPolygonOrDie("0:0, 0:90, 90:0"))));
 }
 
+// Checks that the fused statistics match the individual functions.
+void TestStatsMatchIndividualMeasures(const S2Shape& shape) {
+  S2::ShapeStats stats = S2::ComputeShapeStats(shape);
+  EXPECT_EQ(stats.num_edges, shape.num_edges());
+  EXPECT_EQ(stats.length, S2::GetLength(shape));
+  EXPECT_EQ(stats.centroid, S2::GetCentroid(shape));
+  for (int e = 0; e < shape.num_edges(); ++e) {
+    EXPECT_TRUE(stats.bound.Contains(shape.edge(e).v0));
+    EXPECT_TRUE(stats.bound.Contains(shape.edge(e).v1));
+  }
+}
+
+TEST(ComputeShapeStats, MatchesIndividualMeasures) {
+  TestStatsMatchIndividualMeasures(*MakeIndexOrDie("0:0 | 0:90 | 10:20 # #")
+                                        ->shape(0));
+  TestStatsMatchIndividualMeasures(
+      *MakeLaxPolylineOrDie("1:0, 2:1, 3:2, 4:3"));
+  TestStatsMatchIndividualMeasures(
+      *MakeLaxPolygonOrDie("0:0, 0:90, 90:0; 20:20, 20:25, 25:25"));
+}
+
+TEST(ComputeShapeStats, MultipleChainBoundsAreNotConnected) {
+  // Two short polylines on opposite sides of the equator; a bound that
+  // (incorrectly) included an edge connecting them would span the gap.
+  auto index = MakeIndexOrDie("# 10:10, 10:11 | -10:10, -10:11 #");
+  S2::ShapeStats stats = S2::ComputeShapeStats(*index->shape(0));
+  EXPECT_FALSE(stats.bound.Contains(
+      s2textformat::MakePointOrDie("0:10.5")));
+}
+
+TEST(ComputeShapeStats, MaskLimitsComputation) {
+  auto shape = MakeLaxPolylineOrDie("1:0, 2:1, 3:2");
+  S2::ShapeStats stats =
+      S2::ComputeShapeStats(*shape, S2::kShapeStatsLength);
+  EXPECT_EQ(stats.length, S2::GetLength(*shape));
+  // Unrequested fields keep their default values.
+  EXPECT_TRUE(stats.bound.is_empty());
+  EXPECT_EQ(stats.num_edges, 0);
+  EXPECT_EQ(stats.centroid, S2Point());
+}
+
 }  // namespace
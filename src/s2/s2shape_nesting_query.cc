@@ -17,7 +17,9 @@
 #include "s2/s2shape_nesting_query.h"
 
 #include <algorithm>
+#include <atomic>
 #include <limits>
+#include <thread>
 #include <vector>
 
 #include "s2/base/types.h"
@@ -124,13 +126,30 @@ S2ShapeNestingQuery::ComputeShapeNesting(int shape_id) {
   };
   const S2Point start_point = vertices[1];
 
-  S2CrossingEdgeQuery crossing_query(index_);
-  vector<s2shapeutil::ShapeEdge> edges;
-  for (int chain = 0; chain < num_chains; ++chain) {
-    if (chain == datum_shell) {
-      continue;
-    }
-    ABSL_VLOG(1) << "Processing chain " << chain;
+  // The classification of each chain relative to the datum shell only reads
+  // from the shape and the index, so chains can be classified independently
+  // (and optionally in parallel).  The results are merged into the parent and
+  // child bitmaps in chain order below, so the outcome is identical to
+  // processing each chain in turn.
+  struct ChainClassification {
+    // True if the classification segment starts by entering the interior of
+    // the datum shell.
+    bool starts_into_datum = false;
+
+    // True if the classification segment ends by arriving from the interior
+    // of the target chain.
+    bool ends_from_interior = false;
+
+    // The chains crossed by the classification segment, one entry per
+    // crossing (a chain may appear multiple times).
+    vector<int32> crossed_chains;
+  };
+  vector<ChainClassification> classifications(num_chains);
+
+  const auto classify_chain = [&](int chain,
+                                  S2CrossingEdgeQuery& crossing_query,
+                                  vector<s2shapeutil::ShapeEdge>& edges) {
+    ChainClassification* result = &classifications[chain];
 
     // Find a close point on the target chain out of 4 equally spaced ones.
     int end_idx = ClosestOfNPoints(start_point, *shape, chain, 4);
@@ -144,20 +163,14 @@ S2ShapeNestingQuery::ComputeShapeNesting(int shape_id) {
     // As we cross edges from the datum to the target chain the total number of
     // datum shell _or_ target chain edges we'll cross is either even or odd.
     // Each of these edges toggles our "insideness" relative to the datum shell,
-    if (s2pred::OrderedCCW(vertices[2], end_point, vertices[0], start_point)) {
-      ABSL_VLOG(1) << "  Edge starts into interior of datum chain";
-      parents[chain].Set(datum_shell, true);
-      children[datum_shell].Set(chain, true);
-    }
+    result->starts_into_datum =
+        s2pred::OrderedCCW(vertices[2], end_point, vertices[0], start_point);
 
     // Arriving from the interior of the target chain?
     S2Point next = NextChainEdge(shape, chain, end_idx).v0;
     S2Point prev = PrevChainEdge(shape, chain, end_idx).v0;
-    if (s2pred::OrderedCCW(next, start_point, prev, end_point)) {
-      ABSL_VLOG(1) << "  Edge ends from interior of target chain";
-      parents[chain].Set(chain, true);
-    }
-    ABSL_VLOG(2) << "    Initial set: " << parents[chain].ToString(8);
+    result->ends_from_interior =
+        s2pred::OrderedCCW(next, start_point, prev, end_point);
 
     // Query all the edges crossed by the line from the datum shell to a point
     // on this chain.  Only look at edges that belong to the requested shape.
@@ -166,11 +179,60 @@ S2ShapeNestingQuery::ComputeShapeNesting(int shape_id) {
     crossing_query.GetCrossingEdges(start_point, end_point, shape_id, *shape,
                                     s2shapeutil::CrossingType::INTERIOR,
                                     &edges);
-
-    // Walk through the intersected chains and toggle corresponding bits.
+    result->crossed_chains.reserve(edges.size());
     for (const auto& edge : edges) {
-      int32 other_chain = shape->chain_position(edge.id().edge_id).chain_id;
+      result->crossed_chains.push_back(
+          shape->chain_position(edge.id().edge_id).chain_id);
+    }
+  };
 
+  const int num_threads = std::min(options().num_threads(), num_chains);
+  if (num_threads <= 1) {
+    S2CrossingEdgeQuery crossing_query(index_);
+    vector<s2shapeutil::ShapeEdge> edges;
+    for (int chain = 0; chain < num_chains; ++chain) {
+      if (chain != datum_shell) classify_chain(chain, crossing_query, edges);
+    }
+  } else {
+    std::atomic<int> next_chain{0};
+    const auto worker = [&]() {
+      // Each thread gets its own crossing query and edge buffer; the
+      // underlying index is only read.
+      S2CrossingEdgeQuery crossing_query(index_);
+      vector<s2shapeutil::ShapeEdge> edges;
+      for (;;) {
+        int chain = next_chain.fetch_add(1, std::memory_order_relaxed);
+        if (chain >= num_chains) return;
+        if (chain != datum_shell) classify_chain(chain, crossing_query, edges);
+      }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    for (int t = 0; t < num_threads; ++t) threads.emplace_back(worker);
+    for (auto& thread : threads) thread.join();
+  }
+
+  for (int chain = 0; chain < num_chains; ++chain) {
+    if (chain == datum_shell) {
+      continue;
+    }
+    ABSL_VLOG(1) << "Processing chain " << chain;
+    const ChainClassification& classification = classifications[chain];
+
+    if (classification.starts_into_datum) {
+      ABSL_VLOG(1) << "  Edge starts into interior of datum chain";
+      parents[chain].Set(datum_shell, true);
+      children[datum_shell].Set(chain, true);
+    }
+
+    if (classification.ends_from_interior) {
+      ABSL_VLOG(1) << "  Edge ends from interior of target chain";
+      parents[chain].Set(chain, true);
+    }
+    ABSL_VLOG(2) << "    Initial set: " << parents[chain].ToString(8);
+
+    // Walk through the intersected chains and toggle corresponding bits.
+    for (int32 other_chain : classification.crossed_chains) {
       parents[chain].Toggle(other_chain);
       if (other_chain != chain) {
         children[other_chain].Toggle(chain);
@@ -90,8 +90,21 @@ class S2ShapeNestingQuery {
       return *this;
     }
 
+    // Specifies the number of threads used to classify chains against the
+    // datum shell.  Each chain is classified independently, so shapes with
+    // many chains benefit from using multiple threads.  The results are
+    // identical regardless of this setting.
+    //
+    // DEFAULT: 1 (all work is done on the calling thread).
+    int num_threads() const { return num_threads_; }
+    Options& set_num_threads(int num_threads) {
+      num_threads_ = num_threads;
+      return *this;
+    }
+
    private:
     S2DatumStrategy datum_strategy_;
+    int num_threads_ = 1;
   };
 
   // `ChainRelation` models the parent/child relationship between chains in a
@@ -373,6 +373,40 @@ TEST(S2ShapeNestingQuery, ExactPathIsIrrelevant) {
   }
 }
 
+TEST(S2ShapeNestingQuery, MultiThreadedMatchesSingleThreaded) {
+  const int kNumEdges = 16;
+
+  // A shell with several holes, one of which contains a nested shell with its
+  // own hole, so that the merge logic sees nontrivial parent/child sets.
+  MutableS2ShapeIndex index;
+  int id = index.Add(
+      RingShape(kNumEdges, {{S2LatLng::FromDegrees(0.5, 0.5), 2.0},
+                            {S2LatLng::FromDegrees(1.0, 0.5), 0.25, true},
+                            {S2LatLng::FromDegrees(0.0, 0.5), 0.45, true},
+                            {S2LatLng::FromDegrees(0.0, 0.5), 0.35},
+                            {S2LatLng::FromDegrees(0.0, 0.5), 0.25, true},
+                            {S2LatLng::FromDegrees(0.5, 0.0), 0.25, true}}));
+
+  S2ShapeNestingQuery serial_query(&index);
+  vector<S2ShapeNestingQuery::ChainRelation> expected =
+      serial_query.ComputeShapeNesting(id);
+
+  S2ShapeNestingQuery::Options options;
+  options.set_num_threads(4);
+  S2ShapeNestingQuery parallel_query(&index, options);
+  vector<S2ShapeNestingQuery::ChainRelation> actual =
+      parallel_query.ComputeShapeNesting(id);
+
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(expected[i].parent_id(), actual[i].parent_id());
+    ASSERT_EQ(expected[i].holes().size(), actual[i].holes().size());
+    for (size_t j = 0; j < expected[i].holes().size(); ++j) {
+      EXPECT_EQ(expected[i].holes()[j], actual[i].holes()[j]);
+    }
+  }
+}
+
 struct NestingTestCase {
   int depth;        // How many nested loops to generate
   int first_chain;  // Which nested loop is the first loop in the list
@@ -0,0 +1,117 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2shapeutil_cell_stats.h"
+
+#include <array>
+#include <atomic>
+#include <string>
+
+#include "absl/strings/str_format.h"
+#include "s2/base/types.h"
+#include "s2/s2cell_id.h"
+#include "s2/s2shape_index.h"
+
+namespace s2shapeutil {
+
+CellLevelStats& CellLevelStats::operator+=(const CellLevelStats& other) {
+  num_cells += other.num_cells;
+  num_clipped_shapes += other.num_clipped_shapes;
+  num_edges += other.num_edges;
+  num_bytes += other.num_bytes;
+  return *this;
+}
+
+bool CellLevelStats::operator==(const CellLevelStats& other) const {
+  return num_cells == other.num_cells &&
+         num_clipped_shapes == other.num_clipped_shapes &&
+         num_edges == other.num_edges && num_bytes == other.num_bytes;
+}
+
+CellLevelStats CellStats::totals() const {
+  CellLevelStats totals;
+  for (const CellLevelStats& level : levels) totals += level;
+  return totals;
+}
+
+std::string CellStats::ToString() const {
+  std::string result;
+  for (int level = 0; level <= S2CellId::kMaxLevel; ++level) {
+    const CellLevelStats& stats = levels[level];
+    if (stats.num_cells == 0) continue;
+    absl::StrAppendFormat(&result,
+                          "level %2d: %9d cells, %10d shapes, %11d edges, "
+                          "%12d bytes\n",
+                          level, stats.num_cells, stats.num_clipped_shapes,
+                          stats.num_edges, stats.num_bytes);
+  }
+  CellLevelStats all = totals();
+  absl::StrAppendFormat(&result,
+                        "total:    %9d cells, %10d shapes, %11d edges, "
+                        "%12d bytes\n",
+                        all.num_cells, all.num_clipped_shapes, all.num_edges,
+                        all.num_bytes);
+  return result;
+}
+
+CellStats GetCellStats(const S2ShapeIndex& index, int num_threads) {
+  // Accumulate with relaxed atomics rather than per-thread partial results
+  // so that the visitor can be invoked concurrently from any thread; the
+  // counters are uncontended enough in practice that this is not a
+  // bottleneck.
+  struct AtomicLevelStats {
+    std::atomic<int64> num_cells{0};
+    std::atomic<int64> num_clipped_shapes{0};
+    std::atomic<int64> num_edges{0};
+    std::atomic<int64> num_bytes{0};
+  };
+  std::array<AtomicLevelStats, S2CellId::kMaxLevel + 1> levels;
+  index.ParallelVisitCells(
+      num_threads, [&levels](S2CellId id, const S2ShapeIndexCell& cell) {
+        int64 num_edges = 0;
+        // Matches the accounting in MutableS2ShapeIndex::SpaceUsed(): edge
+        // ids are stored out of line when there are more than
+        // S2ClippedShape::kMaxInlineEdges (2) of them.
+        int64 num_bytes = sizeof(S2ShapeIndexCell) +
+                          int64{cell.num_clipped()} * sizeof(S2ClippedShape);
+        for (const S2ClippedShape& clipped : cell.clipped_shapes()) {
+          num_edges += clipped.num_edges();
+          if (clipped.num_edges() > 2) {
+            num_bytes += clipped.num_edges() * sizeof(int32);
+          }
+        }
+        AtomicLevelStats& stats = levels[id.level()];
+        stats.num_cells.fetch_add(1, std::memory_order_relaxed);
+        stats.num_clipped_shapes.fetch_add(cell.num_clipped(),
+                                           std::memory_order_relaxed);
+        stats.num_edges.fetch_add(num_edges, std::memory_order_relaxed);
+        stats.num_bytes.fetch_add(num_bytes, std::memory_order_relaxed);
+        return true;
+      });
+  CellStats result;
+  for (int level = 0; level <= S2CellId::kMaxLevel; ++level) {
+    result.levels[level].num_cells =
+        levels[level].num_cells.load(std::memory_order_relaxed);
+    result.levels[level].num_clipped_shapes =
+        levels[level].num_clipped_shapes.load(std::memory_order_relaxed);
+    result.levels[level].num_edges =
+        levels[level].num_edges.load(std::memory_order_relaxed);
+    result.levels[level].num_bytes =
+        levels[level].num_bytes.load(std::memory_order_relaxed);
+  }
+  return result;
+}
+
+}  // namespace s2shapeutil
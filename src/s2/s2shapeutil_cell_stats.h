@@ -0,0 +1,73 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef S2_S2SHAPEUTIL_CELL_STATS_H_
+#define S2_S2SHAPEUTIL_CELL_STATS_H_
+
+#include <array>
+#include <string>
+
+#include "s2/base/types.h"
+#include "s2/s2cell_id.h"
+#include "s2/s2shape_index.h"
+
+namespace s2shapeutil {
+
+// Statistics about the index cells at one S2CellId level.
+struct CellLevelStats {
+  int64 num_cells = 0;           // Number of index cells at this level.
+  int64 num_clipped_shapes = 0;  // Total clipped shapes over those cells.
+  int64 num_edges = 0;           // Total clipped edge references.
+  int64 num_bytes = 0;           // Estimated bytes of cell contents.
+
+  CellLevelStats& operator+=(const CellLevelStats& other);
+  bool operator==(const CellLevelStats& other) const;
+  bool operator!=(const CellLevelStats& other) const {
+    return !(*this == other);
+  }
+};
+
+// Per-level statistics for the cells of an S2ShapeIndex, as returned by
+// GetCellStats() below.  These describe how the index options played out for
+// the actual geometry (e.g. how edges distribute across levels and how many
+// shapes land in each cell), which is the raw material for tuning
+// max_edges_per_cell() and for capacity planning.
+struct CellStats {
+  // Statistics for the cells at each level, indexed by level.
+  std::array<CellLevelStats, S2CellId::kMaxLevel + 1> levels;
+
+  // Returns the statistics summed over all levels.
+  CellLevelStats totals() const;
+
+  // Returns a small human-readable multi-line summary listing the non-empty
+  // levels, suitable for logs and health-check output.
+  std::string ToString() const;
+};
+
+// Computes per-level statistics for the cells of the given index.  With
+// "num_threads" > 1 the cells are visited in parallel (see
+// S2ShapeIndex::ParallelVisitCells); the cost is a single pass over the
+// index cells with no decoding of shape data, so this is cheap enough to run
+// in production health checks.
+//
+// The byte counts estimate the memory used by cell contents (clipped shapes
+// and their edge id arrays, assuming out-of-line storage for cells with more
+// than two edges); they exclude the per-index overhead that
+// S2ShapeIndex::SpaceUsed() includes, and so sum to slightly less.
+CellStats GetCellStats(const S2ShapeIndex& index, int num_threads = 1);
+
+}  // namespace s2shapeutil
+
+#endif  // S2_S2SHAPEUTIL_CELL_STATS_H_
@@ -0,0 +1,90 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2shapeutil_cell_stats.h"
+
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "s2/base/types.h"
+#include "s2/mutable_s2shape_index.h"
+#include "s2/s1angle.h"
+#include "s2/s2cell_id.h"
+#include "s2/s2loop.h"
+#include "s2/s2point.h"
+#include "s2/s2shape_index.h"
+#include "s2/s2text_format.h"
+
+using std::make_unique;
+
+namespace s2shapeutil {
+
+TEST(GetCellStats, EmptyIndex) {
+  MutableS2ShapeIndex index;
+  CellStats stats = GetCellStats(index);
+  EXPECT_EQ(0, stats.totals().num_cells);
+  EXPECT_EQ(0, stats.totals().num_edges);
+}
+
+TEST(GetCellStats, MatchesManualIteration) {
+  // A large loop produces index cells at many different levels.
+  auto index = s2textformat::MakeIndexOrDie("1:1 | 2:2 # 3:3, 4:4 #");
+  index->Add(make_unique<S2Loop::OwningShape>(S2Loop::MakeRegularLoop(
+      S2Point(1, 2, 3).Normalize(), S1Angle::Degrees(20), 1000)));
+
+  CellStats expected;
+  int64 num_index_cells = 0;
+  for (MutableS2ShapeIndex::Iterator it(index.get(), S2ShapeIndex::BEGIN);
+       !it.done(); it.Next()) {
+    CellLevelStats& level = expected.levels[it.id().level()];
+    ++level.num_cells;
+    ++num_index_cells;
+    level.num_clipped_shapes += it.cell().num_clipped();
+    level.num_edges += it.cell().num_edges();
+  }
+  ASSERT_GT(num_index_cells, 100);
+
+  for (int num_threads : {1, 4}) {
+    SCOPED_TRACE(num_threads);
+    CellStats stats = GetCellStats(*index, num_threads);
+    for (int level = 0; level <= S2CellId::kMaxLevel; ++level) {
+      EXPECT_EQ(expected.levels[level].num_cells,
+                stats.levels[level].num_cells);
+      EXPECT_EQ(expected.levels[level].num_clipped_shapes,
+                stats.levels[level].num_clipped_shapes);
+      EXPECT_EQ(expected.levels[level].num_edges,
+                stats.levels[level].num_edges);
+      // The byte estimate should at least account for the cells themselves.
+      EXPECT_GE(stats.levels[level].num_bytes,
+                expected.levels[level].num_cells *
+                    static_cast<int64>(sizeof(S2ShapeIndexCell)));
+    }
+    EXPECT_EQ(num_index_cells, stats.totals().num_cells);
+    EXPECT_EQ(expected.totals().num_edges, stats.totals().num_edges);
+    EXPECT_LE(stats.totals().num_bytes,
+              static_cast<int64>(index->SpaceUsed()));
+  }
+}
+
+TEST(GetCellStats, ToStringListsNonEmptyLevels) {
+  auto index = s2textformat::MakeIndexOrDie("# # 0:0, 0:1, 1:1, 1:0");
+  CellStats stats = GetCellStats(*index);
+  std::string str = stats.ToString();
+  EXPECT_NE(std::string::npos, str.find("total:"));
+  EXPECT_NE(std::string::npos, str.find("cells"));
+}
+
+}  // namespace s2shapeutil
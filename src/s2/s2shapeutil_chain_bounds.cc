@@ -0,0 +1,58 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2shapeutil_chain_bounds.h"
+
+#include "absl/log/absl_check.h"
+#include "s2/s2latlng_rect.h"
+#include "s2/s2latlng_rect_bounder.h"
+#include "s2/s2shape.h"
+
+namespace s2shapeutil {
+
+void ChainBounds::Init(const S2Shape* shape) {
+  shape_ = shape;
+  chain_bounds_.resize(shape->num_chains());
+  for (int chain_id = 0; chain_id < num_chains(); ++chain_id) {
+    chain_bounds_[chain_id] = ComputeChainBound(chain_id);
+  }
+}
+
+void ChainBounds::UpdateChain(int chain_id) {
+  ABSL_DCHECK_EQ(num_chains(), shape_->num_chains());
+  chain_bounds_[chain_id] = ComputeChainBound(chain_id);
+}
+
+S2LatLngRect ChainBounds::GetBound() const {
+  S2LatLngRect bound = S2LatLngRect::Empty();
+  for (const S2LatLngRect& chain_bound : chain_bounds_) {
+    bound = bound.Union(chain_bound);
+  }
+  return bound;
+}
+
+S2LatLngRect ChainBounds::ComputeChainBound(int chain_id) const {
+  const S2Shape::Chain chain = shape_->chain(chain_id);
+  if (chain.length == 0) return S2LatLngRect::Empty();
+
+  S2LatLngRectBounder bounder;
+  bounder.AddPoint(shape_->chain_edge(chain_id, 0).v0);
+  for (int offset = 0; offset < chain.length; ++offset) {
+    bounder.AddPoint(shape_->chain_edge(chain_id, offset).v1);
+  }
+  return bounder.GetBound();
+}
+
+}  // namespace s2shapeutil
@@ -0,0 +1,96 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef S2_S2SHAPEUTIL_CHAIN_BOUNDS_H_
+#define S2_S2SHAPEUTIL_CHAIN_BOUNDS_H_
+
+#include <vector>
+
+#include "s2/_fp_contract_off.h"
+#include "s2/s2latlng_rect.h"
+#include "s2/s2shape.h"
+
+namespace s2shapeutil {
+
+// ChainBounds maintains the latitude-longitude bounding rectangle of each
+// chain of a shape, so that when an editor modifies a few vertices only the
+// affected chains need to be re-bounded rather than the entire shape.  This
+// bounds the cost of a bound update by the size of the edited chain instead
+// of the size of the shape.
+//
+// The object stores a pointer to the shape and is intended to be kept
+// alongside it: after mutating the vertices of a chain, call UpdateChain()
+// with its id, then read GetBound() to obtain the merged bound of the whole
+// shape (an O(num_chains) merge of the stored per-chain rectangles).  This
+// pairs naturally with the incremental update path of MutableS2ShapeIndex,
+// where releasing and re-adding an edited shape likewise costs time
+// proportional to the edit rather than the index.
+//
+// The per-chain rectangles bound the chain's *edges*, with the same
+// conservative expansion as S2LatLngRectBounder.  Note that for polygon
+// shapes the union of the edge bounds does not account for loop interiors:
+// a polygon that contains a pole must expand the bound itself, as S2Loop
+// does.
+//
+// Example usage:
+//
+//   s2shapeutil::ChainBounds bounds(&shape);
+//   ...
+//   MoveVertex(&shape, chain_id, offset, new_vertex);
+//   bounds.UpdateChain(chain_id);
+//   S2LatLngRect bound = bounds.GetBound();
+class ChainBounds {
+ public:
+  // Creates an object tracking no shape; Init() must be called before use.
+  ChainBounds() = default;
+
+  // Convenience constructor that calls Init().
+  explicit ChainBounds(const S2Shape* shape) { Init(shape); }
+
+  // Initializes this object to track the chains of the given shape, which
+  // must persist for the lifetime of this object (or until the next Init
+  // call).  Computes the bounds of every chain.
+  void Init(const S2Shape* shape);
+
+  // Returns the shape whose chain bounds are being maintained.
+  const S2Shape* shape() const { return shape_; }
+
+  int num_chains() const { return static_cast<int>(chain_bounds_.size()); }
+
+  // Returns the bound of the edges of the given chain.
+  const S2LatLngRect& chain_bound(int chain_id) const {
+    return chain_bounds_[chain_id];
+  }
+
+  // Recomputes the bound of the given chain.  Call this after the vertices
+  // of the chain have been modified in place; the cost is proportional to
+  // the number of edges in the chain.  Requires that the number of chains
+  // of the shape has not changed since Init().
+  void UpdateChain(int chain_id);
+
+  // Returns the bound of all edges of the shape, i.e. the union of the
+  // per-chain bounds.  Takes O(num_chains) time.
+  S2LatLngRect GetBound() const;
+
+ private:
+  S2LatLngRect ComputeChainBound(int chain_id) const;
+
+  const S2Shape* shape_ = nullptr;
+  std::vector<S2LatLngRect> chain_bounds_;
+};
+
+}  // namespace s2shapeutil
+
+#endif  // S2_S2SHAPEUTIL_CHAIN_BOUNDS_H_
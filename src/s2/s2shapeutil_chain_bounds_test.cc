@@ -0,0 +1,138 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2shapeutil_chain_bounds.h"
+
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "absl/base/optimization.h"
+#include "s2/s2latlng.h"
+#include "s2/s2latlng_rect.h"
+#include "s2/s2latlng_rect_bounder.h"
+#include "s2/s2point.h"
+#include "s2/s2shape.h"
+#include "s2/s2text_format.h"
+
+namespace {
+
+using std::vector;
+
+// A polyline-style shape whose vertices can be modified in place, emulating
+// an editor that moves vertices of an existing shape.
+class MutableChainsShape final : public S2Shape {
+ public:
+  explicit MutableChainsShape(vector<vector<S2Point>> chains)
+      : chains_(std::move(chains)) {}
+
+  void set_vertex(int chain_id, int offset, const S2Point& v) {
+    chains_[chain_id][offset] = v;
+  }
+
+  int num_edges() const final {
+    int num_edges = 0;
+    for (const auto& chain : chains_) num_edges += chain.size() - 1;
+    return num_edges;
+  }
+  Edge edge(int edge_id) const final {
+    for (int i = 0; i < static_cast<int>(chains_.size()); ++i) {
+      int length = chains_[i].size() - 1;
+      if (edge_id < length) return chain_edge(i, edge_id);
+      edge_id -= length;
+    }
+    ABSL_UNREACHABLE();
+  }
+  int dimension() const final { return 1; }
+  ReferencePoint GetReferencePoint() const final {
+    return ReferencePoint::Contained(false);
+  }
+  int num_chains() const final { return chains_.size(); }
+  Chain chain(int chain_id) const final {
+    int start = 0;
+    for (int i = 0; i < chain_id; ++i) start += chains_[i].size() - 1;
+    return Chain(start, chains_[chain_id].size() - 1);
+  }
+  Edge chain_edge(int chain_id, int offset) const final {
+    return Edge(chains_[chain_id][offset], chains_[chain_id][offset + 1]);
+  }
+  ChainPosition chain_position(int edge_id) const final {
+    for (int i = 0; i < static_cast<int>(chains_.size()); ++i) {
+      int length = chains_[i].size() - 1;
+      if (edge_id < length) return ChainPosition(i, edge_id);
+      edge_id -= length;
+    }
+    ABSL_UNREACHABLE();
+  }
+
+ private:
+  vector<vector<S2Point>> chains_;
+};
+
+MutableChainsShape MakeTestShape() {
+  return MutableChainsShape(
+      {s2textformat::ParsePointsOrDie("0:0, 1:1, 0:2"),
+       s2textformat::ParsePointsOrDie("10:10, 12:11, 10:12, 12:13"),
+       s2textformat::ParsePointsOrDie("-20:30, -21:31")});
+}
+
+// Computes the bound of one chain directly with S2LatLngRectBounder.
+S2LatLngRect DirectChainBound(const S2Shape& shape, int chain_id) {
+  S2LatLngRectBounder bounder;
+  bounder.AddPoint(shape.chain_edge(chain_id, 0).v0);
+  for (int i = 0; i < shape.chain(chain_id).length; ++i) {
+    bounder.AddPoint(shape.chain_edge(chain_id, i).v1);
+  }
+  return bounder.GetBound();
+}
+
+TEST(ChainBounds, MatchesDirectComputation) {
+  MutableChainsShape shape = MakeTestShape();
+  s2shapeutil::ChainBounds bounds(&shape);
+  ASSERT_EQ(bounds.num_chains(), 3);
+
+  S2LatLngRect expected_bound = S2LatLngRect::Empty();
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(bounds.chain_bound(i), DirectChainBound(shape, i));
+    expected_bound = expected_bound.Union(DirectChainBound(shape, i));
+  }
+  EXPECT_EQ(bounds.GetBound(), expected_bound);
+}
+
+TEST(ChainBounds, UpdateChainAfterVertexMove) {
+  MutableChainsShape shape = MakeTestShape();
+  s2shapeutil::ChainBounds bounds(&shape);
+  const S2LatLngRect old_bound_0 = bounds.chain_bound(0);
+  const S2LatLngRect old_bound_2 = bounds.chain_bound(2);
+
+  // Move a vertex of the middle chain far outside the previous bound and
+  // re-bound only that chain.
+  shape.set_vertex(1, 1, S2LatLng::FromDegrees(40, 11).ToPoint());
+  bounds.UpdateChain(1);
+
+  // The edited chain's bound matches a from-scratch computation and the
+  // other chains are untouched.
+  EXPECT_EQ(bounds.chain_bound(1), DirectChainBound(shape, 1));
+  EXPECT_EQ(bounds.chain_bound(0), old_bound_0);
+  EXPECT_EQ(bounds.chain_bound(2), old_bound_2);
+
+  // The merged bound matches what a fresh ChainBounds computes, and it
+  // includes the new vertex.
+  s2shapeutil::ChainBounds fresh(&shape);
+  EXPECT_EQ(bounds.GetBound(), fresh.GetBound());
+  EXPECT_TRUE(bounds.GetBound().Contains(S2LatLng::FromDegrees(40, 11)));
+}
+
+}  // namespace
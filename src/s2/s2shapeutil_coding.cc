@@ -17,11 +17,16 @@
 
 #include "s2/s2shapeutil_coding.h"
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
 #include "absl/cleanup/cleanup.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "s2/util/coding/coder.h"
@@ -146,14 +151,107 @@ bool EncodeTaggedShapes(const S2ShapeIndex& index,
   return true;
 }
 
+bool EncodeTaggedShapes(const S2ShapeIndex& index,
+                        const ShapeEncoder& shape_encoder,
+                        Encoder* encoder, int num_threads) {
+  // There is no point in spawning threads unless there are enough shapes per
+  // thread to amortize the cost of the per-shape encoders.
+  static constexpr int kMinShapesPerThread = 64;
+  const int num_shapes = index.num_shape_ids();
+  num_threads = std::min(num_threads, num_shapes / kMinShapesPerThread);
+  if (num_threads <= 1) {
+    return EncodeTaggedShapes(index, shape_encoder, encoder);
+  }
+  // Each shape is encoded independently into its own buffer, and the buffers
+  // are then concatenated via StringVectorEncoder so that the output is
+  // identical to the serial version.
+  std::vector<Encoder> shape_encoders(num_shapes);
+  std::atomic<bool> ok{true};
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int i = t; i < num_shapes; i += num_threads) {
+        const S2Shape* shape = index.shape(i);
+        if (shape == nullptr) continue;  // Encode as zero bytes.
+        Encoder* sub_encoder = &shape_encoders[i];
+        sub_encoder->Ensure(Encoder::kVarintMax32);
+        sub_encoder->put_varint32(shape->type_tag());
+        if (!shape_encoder(*shape, sub_encoder)) {
+          ok.store(false, std::memory_order_relaxed);
+          return;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  if (!ok.load(std::memory_order_relaxed)) return false;
+
+  s2coding::StringVectorEncoder shape_vector;
+  for (const Encoder& shape_encoded : shape_encoders) {
+    Encoder* sub_encoder = shape_vector.AddViaEncoder();
+    sub_encoder->Ensure(shape_encoded.length());
+    sub_encoder->putn(shape_encoded.base(), shape_encoded.length());
+  }
+  shape_vector.Encode(encoder);
+  return true;
+}
+
+bool EncodeDedupedTaggedShapes(const S2ShapeIndex& index,
+                               const ShapeEncoder& shape_encoder,
+                               Encoder* encoder) {
+  s2coding::StringVectorEncoder shape_vector;
+  // Maps each distinct shape encoding (including the type tag) to the id of
+  // the first shape that produced it.
+  absl::flat_hash_map<std::string, int> first_occurrence;
+  Encoder shape_encoded;
+  int shape_id = -1;
+  for (const S2Shape* shape : index) {
+    ++shape_id;
+    Encoder* sub_encoder = shape_vector.AddViaEncoder();
+    if (shape == nullptr) continue;  // Encode as zero bytes.
+
+    shape_encoded.clear();
+    shape_encoded.Ensure(Encoder::kVarintMax32);
+    shape_encoded.put_varint32(shape->type_tag());
+    if (!shape_encoder(*shape, &shape_encoded)) return false;
+
+    auto result = first_occurrence.emplace(
+        std::string(shape_encoded.base(), shape_encoded.length()), shape_id);
+    if (result.second) {
+      sub_encoder->Ensure(shape_encoded.length());
+      sub_encoder->putn(shape_encoded.base(), shape_encoded.length());
+    } else {
+      // A duplicate of an earlier shape; encode a reference to it instead.
+      // kNoTypeTag is never produced by a ShapeEncoder, so it unambiguously
+      // marks the entry as a reference.
+      sub_encoder->Ensure(2 * Encoder::kVarintMax32);
+      sub_encoder->put_varint32(S2Shape::kNoTypeTag);
+      sub_encoder->put_varint32(result.first->second);
+    }
+  }
+  shape_vector.Encode(encoder);
+  return true;
+}
+
 bool FastEncodeTaggedShapes(const S2ShapeIndex& index, Encoder* encoder) {
   return EncodeTaggedShapes(index, FastEncodeShape, encoder);
 }
 
+bool FastEncodeTaggedShapes(const S2ShapeIndex& index, Encoder* encoder,
+                            int num_threads) {
+  return EncodeTaggedShapes(index, FastEncodeShape, encoder, num_threads);
+}
+
 bool CompactEncodeTaggedShapes(const S2ShapeIndex& index, Encoder* encoder) {
   return EncodeTaggedShapes(index, CompactEncodeShape, encoder);
 }
 
+bool CompactEncodeTaggedShapes(const S2ShapeIndex& index, Encoder* encoder,
+                               int num_threads) {
+  return EncodeTaggedShapes(index, CompactEncodeShape, encoder, num_threads);
+}
+
 TaggedShapeFactory::TaggedShapeFactory(const ShapeDecoder& shape_decoder,
                                        Decoder* decoder, S2Error& error)
     : shape_decoder_(shape_decoder) {
@@ -167,6 +265,17 @@ unique_ptr<S2Shape> TaggedShapeFactory::operator[](int shape_id) const {
   Decoder decoder = encoded_shapes_.GetDecoder(shape_id);
   S2Shape::TypeTag tag;
   if (!decoder.get_varint32(&tag)) return nullptr;
+  if (tag == S2Shape::kNoTypeTag) {
+    // A reference to an identical shape encoded earlier in the vector (see
+    // EncodeDedupedTaggedShapes).  References always point backwards to a
+    // non-reference entry, so a single level of indirection suffices.
+    uint32 ref_id;
+    if (!decoder.get_varint32(&ref_id)) return nullptr;
+    if (ref_id >= static_cast<uint32>(shape_id)) return nullptr;
+    decoder = encoded_shapes_.GetDecoder(ref_id);
+    if (!decoder.get_varint32(&tag)) return nullptr;
+    if (tag == S2Shape::kNoTypeTag) return nullptr;
+  }
   return shape_decoder_(tag, &decoder);
 }
 
@@ -201,6 +310,60 @@ unique_ptr<S2Shape> VectorShapeFactory::operator[](int shape_id) const {
   return std::move((*shared_shapes_)[shape_id]);
 }
 
+VectorShapeFactory BatchDecodeShapeFactory(const ShapeDecoder& shape_decoder,
+                                           Decoder* decoder, S2Error& error,
+                                           int num_threads) {
+  s2coding::EncodedStringVector encoded_shapes;
+  if (!encoded_shapes.Init(decoder)) {
+    error.Init(S2Error::DATA_LOSS, "Corrupted encoded shapes.");
+    return VectorShapeFactory({});
+  }
+  const int num_shapes = encoded_shapes.size();
+  vector<unique_ptr<S2Shape>> shapes(num_shapes);
+
+  // Decodes one shape, using the same tag and reference handling as
+  // TaggedShapeFactory::operator[].  Failures leave a null shape.
+  const auto decode_one = [&](int shape_id) {
+    Decoder d = encoded_shapes.GetDecoder(shape_id);
+    S2Shape::TypeTag tag;
+    if (!d.get_varint32(&tag)) return;
+    if (tag == S2Shape::kNoTypeTag) {
+      // A reference to an identical shape encoded earlier in the vector (see
+      // EncodeDedupedTaggedShapes).
+      uint32 ref_id;
+      if (!d.get_varint32(&ref_id)) return;
+      if (ref_id >= static_cast<uint32>(shape_id)) return;
+      d = encoded_shapes.GetDecoder(ref_id);
+      if (!d.get_varint32(&tag)) return;
+      if (tag == S2Shape::kNoTypeTag) return;
+    }
+    shapes[shape_id] = shape_decoder(tag, &d);
+  };
+
+  // As with the parallel EncodeTaggedShapes, there is no point in spawning
+  // threads unless there are enough shapes per thread to amortize them.
+  static constexpr int kMinShapesPerThread = 64;
+  num_threads = std::min(num_threads, num_shapes / kMinShapesPerThread);
+  if (num_threads <= 1) {
+    for (int i = 0; i < num_shapes; ++i) decode_one(i);
+  } else {
+    // Each thread decodes a contiguous run of shapes so that it streams
+    // through its portion of the underlying buffer.
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    for (int t = 0; t < num_threads; ++t) {
+      const int begin = static_cast<int>(int64{num_shapes} * t / num_threads);
+      const int end =
+          static_cast<int>(int64{num_shapes} * (t + 1) / num_threads);
+      threads.emplace_back([&decode_one, begin, end]() {
+        for (int i = begin; i < end; ++i) decode_one(i);
+      });
+    }
+    for (auto& thread : threads) thread.join();
+  }
+  return VectorShapeFactory(std::move(shapes));
+}
+
 VectorShapeFactory SingletonShapeFactory(unique_ptr<S2Shape> shape) {
   vector<unique_ptr<S2Shape>> shapes;
   shapes.push_back(std::move(shape));
@@ -126,12 +126,44 @@ bool EncodeTaggedShapes(const S2ShapeIndex& index,
                         const ShapeEncoder& shape_encoder,
                         Encoder* encoder);
 
+// Like the above, but encodes shapes in parallel using up to "num_threads"
+// threads.  Each shape is encoded independently into a per-shape buffer, and
+// the buffers are then concatenated into the same format produced by the
+// serial version (the output is byte-for-byte identical).  This is useful
+// when encoding indexes with a very large number of shapes.
+//
+// REQUIRES: "encoder" uses the default constructor, so that its buffer
+//           can be enlarged as necessary by calling Ensure(int).
+bool EncodeTaggedShapes(const S2ShapeIndex& index,
+                        const ShapeEncoder& shape_encoder,
+                        Encoder* encoder, int num_threads);
+
+// Like EncodeTaggedShapes, but stores each distinct shape encoding only once.
+// Indexes built from tiled data often contain many byte-identical shapes
+// (shared tile borders, repeated symbols); with this function the payload of
+// each such shape is written once, and later duplicates are replaced by a
+// small entry that references the first occurrence.  The result can be
+// decoded by TaggedShapeFactory (and therefore by FullDecodeShapeFactory and
+// LazyDecodeShapeFactory), which resolves the references transparently.  Note
+// however that deduplicated output is not readable by versions of this
+// library that predate this function, so it should only be used where the
+// readers are known to support it.  When the index contains no duplicate
+// shapes the output is byte-for-byte identical to EncodeTaggedShapes.
+//
+// REQUIRES: "encoder" uses the default constructor, so that its buffer
+//           can be enlarged as necessary by calling Ensure(int).
+bool EncodeDedupedTaggedShapes(const S2ShapeIndex& index,
+                               const ShapeEncoder& shape_encoder,
+                               Encoder* encoder);
+
 // Convenience function that calls EncodeTaggedShapes using FastEncodeShape as
 // the ShapeEncoder.
 //
 // REQUIRES: "encoder" uses the default constructor, so that its buffer
 //           can be enlarged as necessary by calling Ensure(int).
 bool FastEncodeTaggedShapes(const S2ShapeIndex& index, Encoder* encoder);
+bool FastEncodeTaggedShapes(const S2ShapeIndex& index, Encoder* encoder,
+                            int num_threads);
 
 // Convenience function that calls EncodeTaggedShapes using CompactEncodeShape
 // as the ShapeEncoder.
@@ -139,6 +171,8 @@ bool FastEncodeTaggedShapes(const S2ShapeIndex& index, Encoder* encoder);
 // REQUIRES: "encoder" uses the default constructor, so that its buffer
 //           can be enlarged as necessary by calling Ensure(int).
 bool CompactEncodeTaggedShapes(const S2ShapeIndex& index, Encoder* encoder);
+bool CompactEncodeTaggedShapes(const S2ShapeIndex& index, Encoder* encoder,
+                               int num_threads);
 
 // A ShapeFactory that decodes a vector generated by EncodeTaggedShapes()
 // above.  Example usage:
@@ -209,6 +243,24 @@ class VectorShapeFactory : public S2ShapeIndex::ShapeFactory {
   std::shared_ptr<std::vector<std::unique_ptr<S2Shape>>> shared_shapes_;
 };
 
+// Decodes every shape in a vector generated by EncodeTaggedShapes() in a
+// single streaming pass and returns a VectorShapeFactory over the
+// materialized shapes.  This is much faster than faulting shapes in one at a
+// time through TaggedShapeFactory when most shapes will be touched anyway
+// (e.g., cold-starting an index that contains millions of tiny shapes), and
+// with "num_threads" > 1 the shape payloads are decoded in parallel over
+// contiguous runs of the shape vector.  Entries that fail to decode yield
+// null shapes, exactly as with TaggedShapeFactory.
+//
+// Note that because the result is a VectorShapeFactory, each shape may be
+// requested at most once and S2ShapeIndex::Minimize must not be called on an
+// index built from it.  Also note that shapes produced by LazyDecodeShape
+// still reference the Decoder data buffer; use FullDecodeShape if the buffer
+// will not outlive the shapes.
+VectorShapeFactory BatchDecodeShapeFactory(const ShapeDecoder& shape_decoder,
+                                           Decoder* decoder, S2Error& error,
+                                           int num_threads = 1);
+
 // A ShapeFactory that returns the single given S2Shape.  Useful for testing.
 VectorShapeFactory SingletonShapeFactory(std::unique_ptr<S2Shape> shape);
 
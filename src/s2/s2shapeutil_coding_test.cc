@@ -20,10 +20,12 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "s2/base/casts.h"
 #include <gtest/gtest.h>
 #include "absl/strings/escaping.h"
+#include "absl/strings/string_view.h"
 #include "s2/util/coding/coder.h"
 #include "s2/mutable_s2shape_index.h"
 #include "s2/s2lax_polygon_shape.h"
@@ -31,6 +33,8 @@
 #include "s2/s2point_vector_shape.h"
 #include "s2/s2polygon.h"
 #include "s2/s2shape.h"
+#include "s2/s2shapeutil_testing.h"
+#include "s2/s2testing.h"
 #include "s2/s2text_format.h"
 
 using std::make_unique;
@@ -64,6 +68,65 @@ TEST(FastEncodeTaggedShapes, MixedShapes) {
             s2textformat::ToString(decoded_index));
 }
 
+TEST(FastEncodeTaggedShapes, ParallelEncodingMatchesSerial) {
+  // The parallel encoding path is only used when there are enough shapes per
+  // thread, so create an index with a few hundred shapes.
+  MutableS2ShapeIndex index;
+  for (int i = 0; i < 300; ++i) {
+    std::vector<S2Point> vertices;
+    for (int j = 0; j < 3; ++j) {
+      vertices.push_back(S2Testing::RandomPoint());
+    }
+    if (i % 10 == 0) index.Add(nullptr);  // Encoded as zero bytes.
+    index.Add(make_unique<S2LaxPolylineShape>(vertices));
+  }
+  Encoder serial, parallel;
+  ASSERT_TRUE(s2shapeutil::FastEncodeTaggedShapes(index, &serial));
+  ASSERT_TRUE(s2shapeutil::FastEncodeTaggedShapes(index, &parallel, 4));
+  EXPECT_EQ(absl::string_view(serial.base(), serial.length()),
+            absl::string_view(parallel.base(), parallel.length()));
+}
+
+TEST(EncodeDedupedTaggedShapes, DuplicateShapesStoredOnce) {
+  // Indexes with byte-identical shapes (e.g. shared tile borders) should
+  // encode the payload once and decode back to the original geometry.
+  auto polyline = s2textformat::MakePolylineOrDie("1:1, 1:2, 1:3");
+  MutableS2ShapeIndex index;
+  for (int i = 0; i < 10; ++i) {
+    index.Add(make_unique<S2LaxPolylineShape>(*polyline));
+  }
+  index.Add(nullptr);  // Encoded as zero bytes.
+  index.Add(make_unique<S2PointVectorShape>(
+      s2textformat::ParsePointsOrDie("0:0, 0:1")));
+
+  Encoder plain, deduped;
+  ASSERT_TRUE(s2shapeutil::FastEncodeTaggedShapes(index, &plain));
+  ASSERT_TRUE(s2shapeutil::EncodeDedupedTaggedShapes(index, FastEncodeShape,
+                                                     &deduped));
+  EXPECT_LT(deduped.length(), plain.length());
+
+  index.Encode(&deduped);
+  Decoder decoder(deduped.base(), deduped.length());
+  MutableS2ShapeIndex decoded_index;
+  ASSERT_TRUE(decoded_index.Init(
+      &decoder, s2shapeutil::LazyDecodeShapeFactory(&decoder)));
+  EXPECT_EQ(s2textformat::ToString(index),
+            s2textformat::ToString(decoded_index));
+}
+
+TEST(EncodeDedupedTaggedShapes, DistinctShapesMatchPlainEncoding) {
+  // Without duplicates the output is byte-for-byte identical to
+  // EncodeTaggedShapes, and therefore readable by older decoders.
+  auto index = s2textformat::MakeIndexOrDie(
+      "0:0 | 0:1 # 1:1, 1:2, 1:3 # 2:2; 2:3, 2:4, 3:3");
+  Encoder plain, deduped;
+  ASSERT_TRUE(s2shapeutil::FastEncodeTaggedShapes(*index, &plain));
+  ASSERT_TRUE(s2shapeutil::EncodeDedupedTaggedShapes(*index, FastEncodeShape,
+                                                     &deduped));
+  EXPECT_EQ(absl::string_view(plain.base(), plain.length()),
+            absl::string_view(deduped.base(), deduped.length()));
+}
+
 TEST(DecodeTaggedShapes, DecodeFromByteString) {
   auto index = s2textformat::MakeIndexOrDie(
       "0:0 | 0:1 # 1:1, 1:2, 1:3 # 2:2; 2:3, 2:4, 3:3");
@@ -121,6 +184,71 @@ TEST(DecodeTaggedShapes, DecodeFromEncoded) {
   ASSERT_EQ(lazy_shape->type_tag(), S2PointVectorShape::kTypeTag);
 }
 
+TEST(BatchDecodeShapeFactory, MatchesTaggedShapeFactory) {
+  auto index = s2textformat::MakeIndexOrDie(
+      "0:0 | 0:1 # 1:1, 1:2, 1:3 # 2:2; 2:3, 2:4, 3:3");
+  Encoder encoder;
+  ASSERT_TRUE(s2shapeutil::FastEncodeTaggedShapes(*index, &encoder));
+
+  Decoder decoder(encoder.base(), encoder.length());
+  S2Error error;
+  auto expected = s2shapeutil::LazyDecodeShapeFactory(&decoder, error);
+  ASSERT_TRUE(error.ok());
+  decoder.reset(encoder.base(), encoder.length());
+  auto batch =
+      s2shapeutil::BatchDecodeShapeFactory(LazyDecodeShape, &decoder, error);
+  ASSERT_TRUE(error.ok());
+  ASSERT_EQ(expected.size(), batch.size());
+  for (int i = 0; i < expected.size(); ++i) {
+    s2testing::ExpectEqual(*expected[i], *batch[i]);
+  }
+}
+
+TEST(BatchDecodeShapeFactory, DecodesDedupedShapes) {
+  auto index = s2textformat::MakeIndexOrDie(
+      "# 1:1, 1:2 | 1:1, 1:2 | 2:2, 2:3 #");
+  Encoder encoder;
+  ASSERT_TRUE(s2shapeutil::EncodeDedupedTaggedShapes(*index, FastEncodeShape,
+                                                     &encoder));
+  Decoder decoder(encoder.base(), encoder.length());
+  S2Error error;
+  auto batch =
+      s2shapeutil::BatchDecodeShapeFactory(FullDecodeShape, &decoder, error);
+  ASSERT_TRUE(error.ok());
+  ASSERT_EQ(3, batch.size());
+  for (int i = 0; i < 3; ++i) {
+    auto shape = batch[i];
+    ASSERT_NE(nullptr, shape);
+    s2testing::ExpectEqual(*index->shape(i), *shape);
+  }
+}
+
+TEST(BatchDecodeShapeFactory, ParallelMatchesSerial) {
+  // The parallel decoding path is only used when there are enough shapes per
+  // thread, so create an index with a few hundred shapes.
+  MutableS2ShapeIndex index;
+  for (int i = 0; i < 300; ++i) {
+    std::vector<S2Point> vertices;
+    for (int j = 0; j < 3; ++j) {
+      vertices.push_back(S2Testing::RandomPoint());
+    }
+    index.Add(make_unique<S2LaxPolylineShape>(vertices));
+  }
+  Encoder encoder;
+  ASSERT_TRUE(s2shapeutil::FastEncodeTaggedShapes(index, &encoder));
+  Decoder decoder(encoder.base(), encoder.length());
+  S2Error error;
+  auto batch = s2shapeutil::BatchDecodeShapeFactory(FullDecodeShape, &decoder,
+                                                    error, /*num_threads=*/4);
+  ASSERT_TRUE(error.ok());
+  ASSERT_EQ(300, batch.size());
+  for (int i = 0; i < 300; ++i) {
+    auto shape = batch[i];
+    ASSERT_NE(nullptr, shape);
+    s2testing::ExpectEqual(*index.shape(i), *shape);
+  }
+}
+
 TEST(SingletonShapeFactory, S2Polygon) {
   auto polygon = s2textformat::MakePolygonOrDie("0:0, 0:1, 1:0");
   auto shape = make_unique<S2Polygon::Shape>(polygon.get());
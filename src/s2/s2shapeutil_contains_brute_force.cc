@@ -17,12 +17,21 @@
 
 #include "s2/s2shapeutil_contains_brute_force.h"
 
+#include <algorithm>
+
+#include "absl/container/fixed_array.h"
+#include "absl/log/absl_check.h"
+#include "absl/types/span.h"
 #include "s2/s2edge_crosser.h"
 #include "s2/s2point.h"
 #include "s2/s2shape.h"
 
 namespace s2shapeutil {
 
+// Edges are fetched in blocks of this size (using S2Shape::GetEdges) to
+// amortize the virtual call overhead of the edge accessors.
+static constexpr int kEdgeBlockSize = 16;
+
 bool ContainsBruteForce(const S2Shape& shape, const S2Point& point) {
   if (shape.dimension() < 2) return false;
 
@@ -31,11 +40,51 @@ bool ContainsBruteForce(const S2Shape& shape, const S2Point& point) {
 
   S2CopyingEdgeCrosser crosser(ref_point.point, point);
   bool inside = ref_point.contained;
-  for (int e = 0; e < shape.num_edges(); ++e) {
-    auto edge = shape.edge(e);
-    inside ^= crosser.EdgeOrVertexCrossing(edge.v0, edge.v1);
+  S2Shape::Edge edges[kEdgeBlockSize];
+  int num_edges = shape.num_edges();
+  for (int e = 0; e < num_edges; e += kEdgeBlockSize) {
+    int n = std::min(kEdgeBlockSize, num_edges - e);
+    shape.GetEdges(e, n, edges);
+    for (int i = 0; i < n; ++i) {
+      inside ^= crosser.EdgeOrVertexCrossing(edges[i].v0, edges[i].v1);
+    }
   }
   return inside;
 }
 
+void ContainsBruteForce(const S2Shape& shape, absl::Span<const S2Point> points,
+                        absl::Span<bool> contained) {
+  ABSL_DCHECK_EQ(points.size(), contained.size());
+  if (shape.dimension() < 2) {
+    std::fill(contained.begin(), contained.end(), false);
+    return;
+  }
+  S2Shape::ReferencePoint ref_point = shape.GetReferencePoint();
+  absl::FixedArray<S2CopyingEdgeCrosser> crossers(points.size());
+  for (size_t i = 0; i < points.size(); ++i) {
+    contained[i] = ref_point.contained;
+    crossers[i].Init(ref_point.point, points[i]);
+  }
+  // Stream the edges once, updating the crossing parity of every point; this
+  // gives the same answers as the single-point loop above because each
+  // crosser still sees the edges in their original order.
+  S2Shape::Edge edges[kEdgeBlockSize];
+  int num_edges = shape.num_edges();
+  for (int e = 0; e < num_edges; e += kEdgeBlockSize) {
+    int n = std::min(kEdgeBlockSize, num_edges - e);
+    shape.GetEdges(e, n, edges);
+    for (int i = 0; i < n; ++i) {
+      for (size_t j = 0; j < points.size(); ++j) {
+        contained[j] ^= crossers[j].EdgeOrVertexCrossing(edges[i].v0,
+                                                         edges[i].v1);
+      }
+    }
+  }
+  // The edge crossing tests are skipped when a query point is the reference
+  // point itself (matching the single-point version above).
+  for (size_t i = 0; i < points.size(); ++i) {
+    if (points[i] == ref_point.point) contained[i] = ref_point.contained;
+  }
+}
+
 }  // namespace s2shapeutil
@@ -18,6 +18,7 @@
 #ifndef S2_S2SHAPEUTIL_CONTAINS_BRUTE_FORCE_H_
 #define S2_S2SHAPEUTIL_CONTAINS_BRUTE_FORCE_H_
 
+#include "absl/types/span.h"
 #include "s2/s2point.h"
 #include "s2/s2shape.h"
 #include "s2/s2shape_index.h"
@@ -37,6 +38,16 @@ namespace s2shapeutil {
 //         linear in the number of shape edges.
 bool ContainsBruteForce(const S2Shape& shape, const S2Point& point);
 
+// Multi-point version of the method above: sets contained[i] to the result
+// of ContainsBruteForce(shape, points[i]).  The edges of the shape are
+// decoded only once and shared by all of the query points, so this is
+// considerably faster than testing the points individually when the edge
+// accessors are expensive (e.g. for encoded shapes).
+//
+// REQUIRES: points.size() == contained.size()
+void ContainsBruteForce(const S2Shape& shape, absl::Span<const S2Point> points,
+                        absl::Span<bool> contained);
+
 }  // namespace s2shapeutil
 
 #endif  // S2_S2SHAPEUTIL_CONTAINS_BRUTE_FORCE_H_
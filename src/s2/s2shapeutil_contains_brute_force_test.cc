@@ -19,13 +19,18 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
+#include "absl/container/fixed_array.h"
+#include "absl/types/span.h"
 #include "s2/s1angle.h"
 #include "s2/s2lax_polygon_shape.h"
 #include "s2/s2lax_polyline_shape.h"
 #include "s2/s2loop.h"
+#include "s2/s2point.h"
 #include "s2/s2shape.h"
+#include "s2/s2testing.h"
 #include "s2/s2text_format.h"
 
 using s2textformat::MakeLaxPolygonOrDie;
@@ -58,4 +63,40 @@ TEST(ContainsBruteForce, ConsistentWithS2Loop) {
   }
 }
 
+TEST(ContainsBruteForce, BatchMatchesSinglePoint) {
+  // Checks that the multi-point version agrees with the single-point version,
+  // using a loop with enough vertices to span several edge blocks.
+  auto loop = S2Loop::MakeRegularLoop(MakePointOrDie("40:50"),
+                                      S1Angle::Degrees(5), 100);
+  S2Loop::Shape shape(loop.get());
+  std::vector<S2Point> points;
+  for (int i = 0; i < loop->num_vertices(); ++i) {
+    points.push_back(loop->vertex(i));
+  }
+  for (int i = 0; i < 20; ++i) {
+    points.push_back(S2Testing::RandomPoint());
+  }
+  // Include the reference point itself, which is handled specially.
+  points.push_back(shape.GetReferencePoint().point);
+  std::vector<bool> expected;
+  for (const S2Point& point : points) {
+    expected.push_back(ContainsBruteForce(shape, point));
+  }
+  absl::FixedArray<bool> contained(points.size());
+  ContainsBruteForce(shape, points, absl::MakeSpan(contained));
+  for (size_t i = 0; i < points.size(); ++i) {
+    EXPECT_EQ(expected[i], contained[i]) << "point " << i;
+  }
+}
+
+TEST(ContainsBruteForce, BatchWithNoInterior) {
+  // Shapes of dimension < 2 contain nothing.
+  auto polyline = MakeLaxPolylineOrDie("0:0, 0:1, 1:-1, -1:-1, -1e9:1");
+  std::vector<S2Point> points = {MakePointOrDie("0:0"), MakePointOrDie("0:1")};
+  absl::FixedArray<bool> contained(points.size(), true);
+  ContainsBruteForce(*polyline, points, absl::MakeSpan(contained));
+  EXPECT_FALSE(contained[0]);
+  EXPECT_FALSE(contained[1]);
+}
+
 }  // namespace s2shapeutil
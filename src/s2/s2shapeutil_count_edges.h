@@ -18,15 +18,15 @@
 #ifndef S2_S2SHAPEUTIL_COUNT_EDGES_H_
 #define S2_S2SHAPEUTIL_COUNT_EDGES_H_
 
-#include <limits>
-
 #include "s2/s2shape.h"
 #include "s2/s2shape_index.h"
 
 namespace s2shapeutil {
 
 // Returns the total number of edges and points in all indexed shapes in the
-// given index.  This method takes time linear in the number of shapes.
+// given index.  This method takes time linear in the number of shapes for
+// most index types; MutableS2ShapeIndex maintains this count incrementally
+// and returns it in constant time (see S2ShapeIndex::num_edges).
 template <class S2ShapeIndexType>
 int CountEdges(const S2ShapeIndexType& index);
 
@@ -40,7 +40,7 @@ int CountEdgesUpTo(const S2ShapeIndexType& index, int max_edges);
 
 template <class S2ShapeIndexType>
 inline int CountEdges(const S2ShapeIndexType& index) {
-  return CountEdgesUpTo(index, std::numeric_limits<int>::max());
+  return index.num_edges();
 }
 
 template <class S2ShapeIndexType>
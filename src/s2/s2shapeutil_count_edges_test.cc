@@ -43,4 +43,20 @@ TEST(CountEdgesUpTo, StopsEarly) {
   EXPECT_EQ(s2shapeutil::CountEdgesUpTo(*index, 8), 9);
 }
 
+TEST(CountEdges, TracksIndexMutations) {
+  auto index = s2textformat::MakeIndexOrDie(
+      "0:0 | 0:1 | 0:2 | 0:3 | 0:4 # 1:0, 1:1 | 1:2, 1:3 | 1:4, 1:5, 1:6 #");
+  EXPECT_EQ(index->num_edges(), 9);
+  EXPECT_EQ(s2shapeutil::CountEdges(*index), 9);
+
+  index->Release(0);
+  EXPECT_EQ(index->num_edges(), 4);
+  index->Add(s2textformat::MakeLaxPolylineOrDie("2:0, 2:1, 2:2"));
+  EXPECT_EQ(index->num_edges(), 6);
+  EXPECT_EQ(s2shapeutil::CountEdges(*index), 6);
+
+  index->Clear();
+  EXPECT_EQ(index->num_edges(), 0);
+}
+
 }  // namespace
@@ -0,0 +1,162 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2shapeutil_distance_join.h"
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+
+#include "s2/s1chord_angle.h"
+#include "s2/s2cell_id.h"
+#include "s2/s2cell_iterator_join.h"
+#include "s2/s2edge_distances.h"
+#include "s2/s2shape.h"
+#include "s2/s2shape_index.h"
+
+using std::pair;
+using std::vector;
+
+namespace s2shapeutil {
+
+namespace {
+
+// Evaluates candidate cell pairs produced by the iterator join, accumulating
+// the shape pairs found to be within the distance limit.  The iterators and
+// edge buffers are scratch state reused across rows, so one RowProcessor
+// should be used for many rows (e.g. one per thread).
+class RowProcessor {
+ public:
+  RowProcessor(const S2ShapeIndex& index_a, const S2ShapeIndex& index_b,
+               S1ChordAngle distance_limit)
+      : index_a_(index_a),
+        index_b_(index_b),
+        iter_a_(&index_a),
+        iter_b_(&index_b),
+        distance_limit_(distance_limit) {}
+
+  // Processes one candidate row (a pair of index cells known to be within
+  // the distance limit of each other).
+  void ProcessRow(S2CellId id_a, S2CellId id_b) {
+    iter_a_.Seek(id_a);
+    iter_b_.Seek(id_b);
+    const S2ShapeIndexCell& cell_a = iter_a_.cell();
+    const S2ShapeIndexCell& cell_b = iter_b_.cell();
+    for (int sa = 0; sa < cell_a.num_clipped(); ++sa) {
+      const S2ClippedShape& clipped_a = cell_a.clipped(sa);
+      if (clipped_a.num_edges() == 0) continue;
+      GetClippedEdges(index_a_, clipped_a, &edges_a_);
+      for (int sb = 0; sb < cell_b.num_clipped(); ++sb) {
+        const S2ClippedShape& clipped_b = cell_b.clipped(sb);
+        if (clipped_b.num_edges() == 0) continue;
+        pair<int, int> shape_pair(clipped_a.shape_id(), clipped_b.shape_id());
+        if (pairs_.contains(shape_pair)) continue;
+        GetClippedEdges(index_b_, clipped_b, &edges_b_);
+        if (AnyEdgePairWithinLimit()) pairs_.insert(shape_pair);
+      }
+    }
+  }
+
+  const absl::flat_hash_set<pair<int, int>>& pairs() const { return pairs_; }
+
+ private:
+  static void GetClippedEdges(const S2ShapeIndex& index,
+                              const S2ClippedShape& clipped,
+                              vector<S2Shape::Edge>* edges) {
+    const S2Shape* shape = index.shape(clipped.shape_id());
+    edges->clear();
+    for (int i = 0; i < clipped.num_edges(); ++i) {
+      edges->push_back(shape->edge(clipped.edge(i)));
+    }
+  }
+
+  bool AnyEdgePairWithinLimit() const {
+    for (const S2Shape::Edge& a : edges_a_) {
+      for (const S2Shape::Edge& b : edges_b_) {
+        S1ChordAngle min_dist = distance_limit_;
+        if (S2::UpdateEdgePairMinDistance(a.v0, a.v1, b.v0, b.v1, &min_dist)) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  const S2ShapeIndex& index_a_;
+  const S2ShapeIndex& index_b_;
+  S2ShapeIndex::Iterator iter_a_, iter_b_;
+  S1ChordAngle distance_limit_;
+  vector<S2Shape::Edge> edges_a_, edges_b_;
+  absl::flat_hash_set<pair<int, int>> pairs_;
+};
+
+}  // namespace
+
+vector<pair<int, int>> GetShapePairsWithinDistance(
+    const S2ShapeIndex& index_a, const S2ShapeIndex& index_b,
+    S1ChordAngle distance_limit, int num_threads) {
+  // No distance is strictly less than zero (and the tolerant join requires a
+  // positive tolerance).
+  if (distance_limit <= S1ChordAngle::Zero()) return {};
+
+  // Phase 1: walk both cell trees simultaneously once, collecting the pairs
+  // of index cells within the distance limit of each other.  This is cheap
+  // compared to evaluating the edges, so it is done serially.
+  vector<pair<S2CellId, S2CellId>> rows;
+  MakeS2CellIteratorJoin(&index_a, &index_b, distance_limit)
+      .Join([&rows](const S2ShapeIndex::Iterator& it_a,
+                    const S2ShapeIndex::Iterator& it_b) {
+        rows.push_back({it_a.id(), it_b.id()});
+        return true;
+      });
+
+  // Phase 2: evaluate the edge distances for each candidate row.  The rows
+  // are independent, so they can be distributed across threads; each thread
+  // accumulates its own pair set and the sets are merged afterwards.
+  static constexpr int kMinRowsPerThread = 32;
+  num_threads = std::min(num_threads,
+                         static_cast<int>(rows.size()) / kMinRowsPerThread);
+  absl::flat_hash_set<pair<int, int>> pairs;
+  if (num_threads <= 1) {
+    RowProcessor processor(index_a, index_b, distance_limit);
+    for (const auto& row : rows) processor.ProcessRow(row.first, row.second);
+    pairs = processor.pairs();
+  } else {
+    std::mutex lock;
+    vector<std::thread> threads;
+    threads.reserve(num_threads);
+    for (int t = 0; t < num_threads; ++t) {
+      threads.emplace_back([&, t]() {
+        RowProcessor processor(index_a, index_b, distance_limit);
+        for (size_t i = t; i < rows.size(); i += num_threads) {
+          processor.ProcessRow(rows[i].first, rows[i].second);
+        }
+        std::lock_guard<std::mutex> hold(lock);
+        pairs.insert(processor.pairs().begin(), processor.pairs().end());
+      });
+    }
+    for (auto& thread : threads) thread.join();
+  }
+
+  vector<pair<int, int>> result(pairs.begin(), pairs.end());
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+}  // namespace s2shapeutil
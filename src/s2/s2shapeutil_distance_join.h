@@ -0,0 +1,50 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef S2_S2SHAPEUTIL_DISTANCE_JOIN_H_
+#define S2_S2SHAPEUTIL_DISTANCE_JOIN_H_
+
+#include <utility>
+#include <vector>
+
+#include "s2/s1chord_angle.h"
+#include "s2/s2shape_index.h"
+
+namespace s2shapeutil {
+
+// Returns all pairs (a_shape_id, b_shape_id) such that some edge of the
+// shape with id "a_shape_id" in "index_a" is at distance strictly less than
+// "distance_limit" from some edge of the shape with id "b_shape_id" in
+// "index_b".  The pairs are distinct and sorted lexicographically.
+//
+// This is much faster than testing every pair of shapes with
+// S2ClosestEdgeQuery::IsDistanceLess(): both index cell trees are walked
+// simultaneously exactly once (see S2CellIteratorJoin), and only the edges in
+// index cells within "distance_limit" of each other are ever compared.
+// "num_threads" additional threads may be used to evaluate the candidate
+// cell pairs produced by the walk.
+//
+// Note that only edge distances are considered: a shape whose interior
+// contains another shape is not reported unless their edges also come within
+// "distance_limit" of each other.  This matches S2ClosestEdgeQuery with
+// include_interiors() set to false.  Degenerate edges (points) participate
+// like any other edge.
+std::vector<std::pair<int, int>> GetShapePairsWithinDistance(
+    const S2ShapeIndex& index_a, const S2ShapeIndex& index_b,
+    S1ChordAngle distance_limit, int num_threads);
+
+}  // namespace s2shapeutil
+
+#endif  // S2_S2SHAPEUTIL_DISTANCE_JOIN_H_
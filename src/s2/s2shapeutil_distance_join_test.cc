@@ -0,0 +1,120 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2shapeutil_distance_join.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "s2/mutable_s2shape_index.h"
+#include "s2/s1angle.h"
+#include "s2/s1chord_angle.h"
+#include "s2/s2cap.h"
+#include "s2/s2edge_distances.h"
+#include "s2/s2lax_polyline_shape.h"
+#include "s2/s2point.h"
+#include "s2/s2shape.h"
+#include "s2/s2shape_index.h"
+#include "s2/s2testing.h"
+#include "s2/s2text_format.h"
+
+using std::pair;
+using std::vector;
+
+namespace s2shapeutil {
+namespace {
+
+// Computes the expected result by comparing every edge of every shape pair.
+vector<pair<int, int>> BruteForcePairs(const S2ShapeIndex& index_a,
+                                       const S2ShapeIndex& index_b,
+                                       S1ChordAngle distance_limit) {
+  vector<pair<int, int>> result;
+  for (int a = 0; a < index_a.num_shape_ids(); ++a) {
+    const S2Shape* shape_a = index_a.shape(a);
+    for (int b = 0; b < index_b.num_shape_ids(); ++b) {
+      const S2Shape* shape_b = index_b.shape(b);
+      bool within = false;
+      for (int i = 0; !within && i < shape_a->num_edges(); ++i) {
+        S2Shape::Edge ea = shape_a->edge(i);
+        for (int j = 0; !within && j < shape_b->num_edges(); ++j) {
+          S2Shape::Edge eb = shape_b->edge(j);
+          S1ChordAngle min_dist = distance_limit;
+          within = S2::UpdateEdgePairMinDistance(ea.v0, ea.v1, eb.v0, eb.v1,
+                                                 &min_dist);
+        }
+      }
+      if (within) result.push_back({a, b});
+    }
+  }
+  return result;
+}
+
+TEST(GetShapePairsWithinDistance, EmptyIndexes) {
+  MutableS2ShapeIndex index_a, index_b;
+  EXPECT_TRUE(GetShapePairsWithinDistance(index_a, index_b,
+                                          S1ChordAngle::Degrees(1), 1)
+                  .empty());
+}
+
+TEST(GetShapePairsWithinDistance, ZeroLimitReturnsNothing) {
+  auto index_a = s2textformat::MakeIndexOrDie("# 0:0, 0:1 #");
+  auto index_b = s2textformat::MakeIndexOrDie("# 0:0, 1:0 #");
+  EXPECT_TRUE(GetShapePairsWithinDistance(*index_a, *index_b,
+                                          S1ChordAngle::Zero(), 1)
+                  .empty());
+}
+
+TEST(GetShapePairsWithinDistance, SimplePolylines) {
+  auto index_a = s2textformat::MakeIndexOrDie("# 0:0, 0:10 | 5:0, 5:10 #");
+  auto index_b =
+      s2textformat::MakeIndexOrDie("# 1:0, 1:10 | 20:0, 20:10 #");
+  // Shape 0 of A is within 2 degrees of shape 0 of B; everything else is
+  // farther apart than that.
+  vector<pair<int, int>> expected = {{0, 0}};
+  EXPECT_EQ(expected,
+            GetShapePairsWithinDistance(*index_a, *index_b,
+                                        S1ChordAngle::Degrees(2), 1));
+}
+
+TEST(GetShapePairsWithinDistance, RandomPolylinesMatchBruteForce) {
+  const int kNumShapes = 20;
+  const int kNumVertices = 10;
+  auto make_index = [&]() {
+    auto index = std::make_unique<MutableS2ShapeIndex>();
+    for (int i = 0; i < kNumShapes; ++i) {
+      S2Cap cap(S2Testing::RandomPoint(), S1Angle::Degrees(5));
+      vector<S2Point> vertices;
+      for (int j = 0; j < kNumVertices; ++j) {
+        vertices.push_back(S2Testing::SamplePoint(cap));
+      }
+      index->Add(std::make_unique<S2LaxPolylineShape>(vertices));
+    }
+    return index;
+  };
+  auto index_a = make_index();
+  auto index_b = make_index();
+  const S1ChordAngle kLimit(S1Angle::Degrees(1));
+  vector<pair<int, int>> expected =
+      BruteForcePairs(*index_a, *index_b, kLimit);
+  EXPECT_EQ(expected,
+            GetShapePairsWithinDistance(*index_a, *index_b, kLimit, 1));
+  EXPECT_EQ(expected,
+            GetShapePairsWithinDistance(*index_a, *index_b, kLimit, 4));
+}
+
+}  // namespace
+}  // namespace s2shapeutil
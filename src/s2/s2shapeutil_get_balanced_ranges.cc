@@ -0,0 +1,108 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2shapeutil_get_balanced_ranges.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+#include "absl/types/span.h"
+
+#include "s2/base/types.h"
+#include "s2/s2cell_id.h"
+#include "s2/s2cell_range_iterator.h"
+#include "s2/s2shape_index.h"
+
+using std::pair;
+using std::vector;
+
+namespace s2shapeutil {
+
+// Returns the sorted (range_min, num_edges) pairs of every index cell.  The
+// cells of each index are already sorted, but merging the indexes by sorting
+// the combined vector keeps the code simple and is not a bottleneck.
+static vector<pair<S2CellId, int64>> GatherCellWeights(
+    absl::Span<const S2ShapeIndex* const> indexes) {
+  vector<pair<S2CellId, int64>> weights;
+  for (const S2ShapeIndex* index : indexes) {
+    for (auto it = MakeS2CellRangeIterator(index); !it.done(); it.Next()) {
+      const S2ShapeIndexCell& cell = it.iterator().cell();
+      int64 num_edges = 0;
+      for (int s = 0; s < cell.num_clipped(); ++s) {
+        num_edges += cell.clipped(s).num_edges();
+      }
+      weights.push_back({it.range_min(), num_edges});
+    }
+  }
+  std::sort(weights.begin(), weights.end());
+  return weights;
+}
+
+vector<CellIdRange> GetBalancedCellIdRanges(
+    absl::Span<const S2ShapeIndex* const> indexes, int64 max_edges_per_range) {
+  ABSL_DCHECK_GT(max_edges_per_range, 0);
+  vector<pair<S2CellId, int64>> weights = GatherCellWeights(indexes);
+
+  // Greedily extend the current range until adding the next index cell would
+  // exceed the edge budget, then cut the range at that cell's range_min().
+  vector<CellIdRange> ranges;
+  S2CellId begin = S2CellId::Begin(S2CellId::kMaxLevel);
+  int64 range_edges = 0;
+  for (const auto& weight : weights) {
+    if (range_edges > 0 && range_edges + weight.second > max_edges_per_range &&
+        weight.first > begin) {
+      ranges.push_back({begin, weight.first});
+      begin = weight.first;
+      range_edges = 0;
+    }
+    range_edges += weight.second;
+  }
+  ranges.push_back({begin, S2CellId::End(S2CellId::kMaxLevel)});
+  return ranges;
+}
+
+vector<CellIdRange> GetBalancedCellIdPartitions(
+    absl::Span<const S2ShapeIndex* const> indexes, int num_partitions) {
+  ABSL_DCHECK_GE(num_partitions, 1);
+  vector<pair<S2CellId, int64>> weights = GatherCellWeights(indexes);
+  int64 total_edges = 0;
+  for (const auto& weight : weights) total_edges += weight.second;
+
+  // Walk the index cells in order, cutting a partition boundary whenever the
+  // cumulative weight crosses the next ideal boundary (k * total / n).  The
+  // cut goes before or after the current cell, whichever lands closer to the
+  // ideal, except that partitions are never left empty.
+  vector<CellIdRange> ranges;
+  S2CellId begin = S2CellId::Begin(S2CellId::kMaxLevel);
+  if (total_edges > 0) {
+    int64 cumulative = 0;
+    for (const auto& weight : weights) {
+      if (static_cast<int>(ranges.size()) >= num_partitions - 1) break;
+      const int64 target = (ranges.size() + 1) * total_edges / num_partitions;
+      if (cumulative > 0 && weight.first > begin &&
+          cumulative + weight.second / 2 >= target) {
+        ranges.push_back({begin, weight.first});
+        begin = weight.first;
+      }
+      cumulative += weight.second;
+    }
+  }
+  ranges.push_back({begin, S2CellId::End(S2CellId::kMaxLevel)});
+  return ranges;
+}
+
+}  // namespace s2shapeutil
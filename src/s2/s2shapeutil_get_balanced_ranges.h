@@ -0,0 +1,84 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef S2_S2SHAPEUTIL_GET_BALANCED_RANGES_H_
+#define S2_S2SHAPEUTIL_GET_BALANCED_RANGES_H_
+
+#include <vector>
+
+#include "absl/types/span.h"
+
+#include "s2/base/types.h"
+#include "s2/s2cell_id.h"
+#include "s2/s2shape_index.h"
+
+namespace s2shapeutil {
+
+// A contiguous range of leaf S2CellIds, representing the half-open interval
+// [begin, limit).
+struct CellIdRange {
+  S2CellId begin;  // The first leaf cell contained by this range.
+  S2CellId limit;  // One past the last leaf cell contained by this range.
+
+  friend bool operator==(const CellIdRange& x, const CellIdRange& y) {
+    return x.begin == y.begin && x.limit == y.limit;
+  }
+};
+
+// Partitions the sphere into contiguous, non-overlapping leaf cell ranges
+// such that the edges of the given indexes are distributed approximately
+// evenly among the ranges.  The ranges cover the entire S2CellId space, are
+// returned in increasing order, and their boundaries always coincide with
+// index cell boundaries, so each index cell is assigned to exactly one range.
+//
+// This is intended as a building block for processing very large operations
+// in tiles of bounded size, e.g. intersecting two continent-scale
+// S2ShapeIndexes one S2CellId range at a time rather than all at once.  The
+// cell iterators of the input indexes can be positioned at the start of a
+// range with Seek(range.begin) and advanced until range_min() >= range.limit
+// (see S2CellRangeIterator).
+//
+// More precisely, each range contains index cells with a total of at most
+// "max_edges_per_range" edges, counting each index cell toward the range
+// containing its range_min().  (A single index cell with more than this many
+// edges gets a range to itself, and index cells larger than the range they
+// start in may also intersect subsequent ranges.)
+//
+// REQUIRES: max_edges_per_range > 0
+std::vector<CellIdRange> GetBalancedCellIdRanges(
+    absl::Span<const S2ShapeIndex* const> indexes, int64 max_edges_per_range);
+
+// Partitions the sphere into at most "num_partitions" contiguous,
+// non-overlapping leaf cell ranges whose total edge weights are as close to
+// equal as the index cell boundaries allow.  Whereas GetBalancedCellIdRanges
+// produces as many ranges as a fixed edge budget requires, this function
+// targets a fixed degree of parallelism, e.g. one partition per worker
+// thread.  Real datasets are typically very skewed, so partitions that
+// follow the actual edge density of the indexes balance far better than a
+// uniform split of the cell space.
+//
+// The ranges cover the entire S2CellId space, are returned in increasing
+// order, and their boundaries coincide with index cell boundaries (counting
+// each index cell toward the range containing its range_min()).  Fewer than
+// "num_partitions" ranges may be returned when the indexes do not have
+// enough cells to fill them.
+//
+// REQUIRES: num_partitions >= 1
+std::vector<CellIdRange> GetBalancedCellIdPartitions(
+    absl::Span<const S2ShapeIndex* const> indexes, int num_partitions);
+
+}  // namespace s2shapeutil
+
+#endif  // S2_S2SHAPEUTIL_GET_BALANCED_RANGES_H_
@@ -0,0 +1,197 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2shapeutil_get_balanced_ranges.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "s2/base/types.h"
+#include "s2/mutable_s2shape_index.h"
+#include "s2/s1angle.h"
+#include "s2/s2cell_id.h"
+#include "s2/s2cell_range_iterator.h"
+#include "s2/s2fractal.h"
+#include "s2/s2latlng.h"
+#include "s2/s2loop.h"
+#include "s2/s2pointutil.h"
+#include "s2/s2shape_index.h"
+#include "s2/s2text_format.h"
+
+using std::vector;
+
+namespace s2shapeutil {
+namespace {
+
+// Verifies that "ranges" forms an increasing, non-overlapping partition of
+// the entire S2CellId space, that range boundaries coincide with index cell
+// boundaries, and that no range contains index cells with more than
+// "max_edges_per_range" total edges unless a single cell exceeds the budget
+// by itself.
+void VerifyRanges(const vector<const S2ShapeIndex*>& indexes,
+                  const vector<CellIdRange>& ranges,
+                  int64 max_edges_per_range) {
+  ASSERT_FALSE(ranges.empty());
+  EXPECT_EQ(ranges.front().begin, S2CellId::Begin(S2CellId::kMaxLevel));
+  EXPECT_EQ(ranges.back().limit, S2CellId::End(S2CellId::kMaxLevel));
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    EXPECT_LT(ranges[i].begin, ranges[i].limit);
+    if (i > 0) EXPECT_EQ(ranges[i - 1].limit, ranges[i].begin);
+  }
+  // Count the edges of the index cells assigned to each range (i.e., whose
+  // range_min() it contains), and check that no cell straddles a boundary.
+  vector<int64> range_edges(ranges.size(), 0);
+  vector<int> range_cells(ranges.size(), 0);
+  for (const S2ShapeIndex* index : indexes) {
+    size_t r = 0;
+    for (auto it = MakeS2CellRangeIterator(index); !it.done(); it.Next()) {
+      while (it.range_min() >= ranges[r].limit) ++r;
+      ASSERT_GE(it.range_min(), ranges[r].begin);
+      int64 num_edges = 0;
+      const S2ShapeIndexCell& cell = it.iterator().cell();
+      for (int s = 0; s < cell.num_clipped(); ++s) {
+        num_edges += cell.clipped(s).num_edges();
+      }
+      range_edges[r] += num_edges;
+      range_cells[r] += 1;
+    }
+  }
+  for (size_t r = 0; r < ranges.size(); ++r) {
+    if (range_cells[r] > 1) {
+      EXPECT_LE(range_edges[r], max_edges_per_range);
+    }
+  }
+}
+
+TEST(GetBalancedCellIdRanges, EmptyIndexes) {
+  MutableS2ShapeIndex a_index, b_index;
+  vector<CellIdRange> ranges =
+      GetBalancedCellIdRanges({&a_index, &b_index}, 100);
+  ASSERT_EQ(1, ranges.size());
+  EXPECT_EQ(ranges[0].begin, S2CellId::Begin(S2CellId::kMaxLevel));
+  EXPECT_EQ(ranges[0].limit, S2CellId::End(S2CellId::kMaxLevel));
+}
+
+TEST(GetBalancedCellIdRanges, SingleIndex) {
+  auto index = s2textformat::MakeIndexOrDie(
+      "1:1 | 2:2 # 3:3, 4:4 | 5:5, 6:6 # 7:7, 7:8, 8:8, 8:7");
+  vector<CellIdRange> ranges = GetBalancedCellIdRanges({index.get()}, 2);
+  EXPECT_GT(ranges.size(), 1);
+  VerifyRanges({index.get()}, ranges, 2);
+}
+
+TEST(GetBalancedCellIdRanges, TwoFractalIndexes) {
+  MutableS2ShapeIndex a_index, b_index;
+  S2Fractal fractal;
+  fractal.SetLevelForApproxMaxEdges(1000);
+  a_index.Add(std::make_unique<S2Loop::OwningShape>(fractal.MakeLoop(
+      S2::GetFrame(S2LatLng::FromDegrees(10, 10).ToPoint()),
+      S1Angle::Degrees(5))));
+  b_index.Add(std::make_unique<S2Loop::OwningShape>(fractal.MakeLoop(
+      S2::GetFrame(S2LatLng::FromDegrees(12, 12).ToPoint()),
+      S1Angle::Degrees(5))));
+  vector<const S2ShapeIndex*> indexes = {&a_index, &b_index};
+  for (int64 max_edges : {50, 500, 5000}) {
+    vector<CellIdRange> ranges = GetBalancedCellIdRanges(
+        {&a_index, &b_index}, max_edges);
+    VerifyRanges(indexes, ranges, max_edges);
+  }
+}
+
+// Verifies that "ranges" is an increasing partition of the cell id space
+// with at most "num_partitions" entries, and returns the edge weight
+// assigned to each range.
+vector<int64> GetPartitionWeights(const vector<const S2ShapeIndex*>& indexes,
+                                  const vector<CellIdRange>& ranges,
+                                  int num_partitions) {
+  EXPECT_GE(num_partitions, static_cast<int>(ranges.size()));
+  EXPECT_EQ(ranges.front().begin, S2CellId::Begin(S2CellId::kMaxLevel));
+  EXPECT_EQ(ranges.back().limit, S2CellId::End(S2CellId::kMaxLevel));
+  for (size_t i = 1; i < ranges.size(); ++i) {
+    EXPECT_EQ(ranges[i - 1].limit, ranges[i].begin);
+  }
+  vector<int64> range_edges(ranges.size(), 0);
+  for (const S2ShapeIndex* index : indexes) {
+    size_t r = 0;
+    for (auto it = MakeS2CellRangeIterator(index); !it.done(); it.Next()) {
+      while (it.range_min() >= ranges[r].limit) ++r;
+      int64 num_edges = 0;
+      const S2ShapeIndexCell& cell = it.iterator().cell();
+      for (int s = 0; s < cell.num_clipped(); ++s) {
+        num_edges += cell.clipped(s).num_edges();
+      }
+      range_edges[r] += num_edges;
+    }
+  }
+  return range_edges;
+}
+
+TEST(GetBalancedCellIdPartitions, EmptyIndexes) {
+  MutableS2ShapeIndex index;
+  vector<CellIdRange> ranges = GetBalancedCellIdPartitions({&index}, 8);
+  ASSERT_EQ(1, ranges.size());
+  EXPECT_EQ(ranges[0].begin, S2CellId::Begin(S2CellId::kMaxLevel));
+  EXPECT_EQ(ranges[0].limit, S2CellId::End(S2CellId::kMaxLevel));
+}
+
+TEST(GetBalancedCellIdPartitions, SinglePartition) {
+  auto index = s2textformat::MakeIndexOrDie("1:1 | 2:2 # # 7:7, 7:8, 8:8");
+  vector<CellIdRange> ranges = GetBalancedCellIdPartitions({index.get()}, 1);
+  ASSERT_EQ(1, ranges.size());
+}
+
+TEST(GetBalancedCellIdPartitions, TwoFractalIndexes) {
+  MutableS2ShapeIndex a_index, b_index;
+  S2Fractal fractal;
+  fractal.SetLevelForApproxMaxEdges(1000);
+  a_index.Add(std::make_unique<S2Loop::OwningShape>(fractal.MakeLoop(
+      S2::GetFrame(S2LatLng::FromDegrees(10, 10).ToPoint()),
+      S1Angle::Degrees(5))));
+  b_index.Add(std::make_unique<S2Loop::OwningShape>(fractal.MakeLoop(
+      S2::GetFrame(S2LatLng::FromDegrees(12, 12).ToPoint()),
+      S1Angle::Degrees(5))));
+  vector<const S2ShapeIndex*> indexes = {&a_index, &b_index};
+  for (int num_partitions : {1, 2, 4, 16}) {
+    vector<CellIdRange> ranges =
+        GetBalancedCellIdPartitions({&a_index, &b_index}, num_partitions);
+    vector<int64> range_edges =
+        GetPartitionWeights(indexes, ranges, num_partitions);
+    // The fractals are small enough that every partition should be filled,
+    // and no partition should be more than twice the ideal weight plus the
+    // weight of a single index cell (the granularity of the cuts).
+    ASSERT_EQ(num_partitions, static_cast<int>(ranges.size()));
+    int64 total_edges = 0;
+    int64 max_cell_edges = 0;
+    for (const S2ShapeIndex* index : indexes) {
+      for (auto it = MakeS2CellRangeIterator(index); !it.done(); it.Next()) {
+        int64 num_edges = 0;
+        const S2ShapeIndexCell& cell = it.iterator().cell();
+        for (int s = 0; s < cell.num_clipped(); ++s) {
+          num_edges += cell.clipped(s).num_edges();
+        }
+        total_edges += num_edges;
+        max_cell_edges = std::max(max_cell_edges, num_edges);
+      }
+    }
+    for (int64 edges : range_edges) {
+      EXPECT_LE(edges, 2 * total_edges / num_partitions + max_cell_edges);
+    }
+  }
+}
+
+}  // namespace
+}  // namespace s2shapeutil
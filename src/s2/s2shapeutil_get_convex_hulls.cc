@@ -0,0 +1,91 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2shapeutil_get_convex_hulls.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+#include "s2/s2convex_hull_query.h"
+#include "s2/s2executor.h"
+#include "s2/s2loop.h"
+#include "s2/s2shape.h"
+#include "s2/s2shape_index.h"
+
+using std::make_unique;
+using std::unique_ptr;
+using std::vector;
+
+namespace s2shapeutil {
+
+namespace {
+
+// Computes the convex hull of a single shape using the given query, which is
+// left empty (with its buffers intact) for the next shape.
+unique_ptr<S2Loop> GetShapeConvexHull(const S2Shape& shape,
+                                      S2ConvexHullQuery* query) {
+  // A polygon with no edges is either empty or full; in the latter case its
+  // hull cannot be deduced from its (nonexistent) vertices.
+  if (shape.dimension() == 2 && shape.num_edges() == 0) {
+    return make_unique<S2Loop>(shape.GetReferencePoint().contained
+                                   ? S2Loop::kFull()
+                                   : S2Loop::kEmpty());
+  }
+  // The convex hull of the edge endpoints contains every edge, and for
+  // polygon shapes therefore also the interior.  Duplicate endpoints of
+  // adjacent edges are removed during the hull computation.
+  for (int e = 0; e < shape.num_edges(); ++e) {
+    const S2Shape::Edge edge = shape.edge(e);
+    query->AddPoint(edge.v0);
+    query->AddPoint(edge.v1);
+  }
+  return query->GetConvexHullAndReset();
+}
+
+}  // namespace
+
+vector<unique_ptr<S2Loop>> GetConvexHulls(const S2ShapeIndex& index,
+                                          int num_threads,
+                                          S2Executor* executor) {
+  ABSL_DCHECK_GE(num_threads, 1);
+  const int num_shapes = index.num_shape_ids();
+  vector<unique_ptr<S2Loop>> hulls(num_shapes);
+  if (num_shapes == 0) return hulls;
+  if (executor == nullptr) executor = S2Executor::Default();
+
+  // Shapes are claimed from a shared counter rather than split into
+  // contiguous chunks, since shape sizes can vary by many orders of
+  // magnitude.  Each worker reuses one query so that hull scratch space is
+  // allocated once per thread rather than once per shape.
+  std::atomic<int> next_shape{0};
+  const int num_workers = std::min(num_threads, num_shapes);
+  executor->Run(num_workers, [&index, &hulls, &next_shape, num_shapes](int) {
+    S2ConvexHullQuery query;
+    query.set_incremental(true);
+    int id;
+    while ((id = next_shape.fetch_add(1, std::memory_order_relaxed)) <
+           num_shapes) {
+      const S2Shape* shape = index.shape(id);
+      if (shape == nullptr) continue;
+      hulls[id] = GetShapeConvexHull(*shape, &query);
+    }
+  });
+  return hulls;
+}
+
+}  // namespace s2shapeutil
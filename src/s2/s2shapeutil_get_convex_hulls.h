@@ -0,0 +1,48 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef S2_S2SHAPEUTIL_GET_CONVEX_HULLS_H_
+#define S2_S2SHAPEUTIL_GET_CONVEX_HULLS_H_
+
+#include <memory>
+#include <vector>
+
+#include "s2/s2executor.h"
+#include "s2/s2loop.h"
+#include "s2/s2shape_index.h"
+
+namespace s2shapeutil {
+
+// Computes the convex hull of every shape in the given index, as defined by
+// S2ConvexHullQuery: each hull is a single convex loop containing all of the
+// shape's vertices and edges, and (for polygon shapes) its interior.  The
+// result contains one entry per shape id, in shape id order; entries for
+// shape ids that have been released from the index are nullptr.
+//
+// The hulls are computed in up to "num_threads" parallel tasks, each with
+// its own reusable S2ConvexHullQuery scratch space, which are run using
+// "executor" (or S2Executor::Default() if "executor" is nullptr).  Shapes
+// are handed out to tasks individually so that a few very large shapes do
+// not serialize the computation.  The result does not depend on the number
+// of threads.
+//
+// REQUIRES: num_threads >= 1
+std::vector<std::unique_ptr<S2Loop>> GetConvexHulls(
+    const S2ShapeIndex& index, int num_threads = 1,
+    S2Executor* executor = nullptr);
+
+}  // namespace s2shapeutil
+
+#endif  // S2_S2SHAPEUTIL_GET_CONVEX_HULLS_H_
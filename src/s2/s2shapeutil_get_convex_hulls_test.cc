@@ -0,0 +1,82 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2shapeutil_get_convex_hulls.h"
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "s2/mutable_s2shape_index.h"
+#include "s2/s2lax_polygon_shape.h"
+#include "s2/s2loop.h"
+#include "s2/s2shape.h"
+#include "s2/s2text_format.h"
+
+namespace s2shapeutil {
+namespace {
+
+using std::unique_ptr;
+using std::vector;
+
+TEST(GetConvexHulls, MixedDimensions) {
+  auto index = s2textformat::MakeIndexOrDie(
+      "0:0 | 2:1 | 1:3 # 10:10, 10:12, 12:11 # 20:20, 20:25, 25:25, 25:20");
+  vector<unique_ptr<S2Loop>> hulls = GetConvexHulls(*index);
+  ASSERT_EQ(3, hulls.size());
+  for (int id = 0; id < 3; ++id) {
+    const S2Shape& shape = *index->shape(id);
+    ASSERT_NE(hulls[id], nullptr);
+    for (int e = 0; e < shape.num_edges(); ++e) {
+      const S2Shape::Edge edge = shape.edge(e);
+      // Hull vertices are not necessarily contained by the (open) loop, but
+      // every edge midpoint lies strictly inside.
+      EXPECT_TRUE(hulls[id]->Contains((edge.v0 + edge.v1).Normalize()));
+    }
+  }
+  // The point set hull should not contain the polygon and vice versa.
+  EXPECT_FALSE(hulls[0]->Contains(*hulls[2]));
+  EXPECT_FALSE(hulls[2]->Contains(*hulls[0]));
+}
+
+TEST(GetConvexHulls, ParallelMatchesSerial) {
+  auto index = s2textformat::MakeIndexOrDie(
+      "0:0 | 2:1 | 1:3 | 4:4 | 5:1 # 10:10, 10:12, 12:11 | -5:0, -5:5 "
+      "# 20:20, 20:25, 25:25, 25:20");
+  vector<unique_ptr<S2Loop>> expected = GetConvexHulls(*index);
+  for (int num_threads : {2, 4}) {
+    vector<unique_ptr<S2Loop>> actual = GetConvexHulls(*index, num_threads);
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t id = 0; id < expected.size(); ++id) {
+      EXPECT_TRUE(actual[id]->BoundaryEquals(*expected[id]));
+    }
+  }
+}
+
+TEST(GetConvexHulls, SpecialCases) {
+  MutableS2ShapeIndex index;
+  index.Add(s2textformat::MakeLaxPolygonOrDie("full"));
+  index.Add(s2textformat::MakeLaxPolygonOrDie(""));
+  index.Add(s2textformat::MakeLaxPolylineOrDie("1:1, 2:2"));
+  index.Release(2);  // Leaves a released shape id.
+  vector<unique_ptr<S2Loop>> hulls = GetConvexHulls(index);
+  ASSERT_EQ(3, hulls.size());
+  EXPECT_TRUE(hulls[0]->is_full());
+  EXPECT_TRUE(hulls[1]->is_empty());
+  EXPECT_EQ(hulls[2], nullptr);
+}
+
+}  // namespace
+}  // namespace s2shapeutil
@@ -36,19 +36,20 @@ namespace s2shapeutil {
 // "result" to a ReferencePoint indicating whther "vtest" is contained and
 // returns true.  Otherwise returns false.
 static bool GetReferencePointAtVertex(
-    const S2Shape& shape, const S2Point& vtest, ReferencePoint* result) {
+    const S2Shape& shape, const S2Point& vtest,
+    S2ContainsVertexQuery* contains_query, ReferencePoint* result) {
   // Let P be an unbalanced vertex.  Vertex P is defined to be inside the
   // region if the region contains a particular direction vector starting from
   // P, namely the direction S2::RefDir(P).  This can be calculated using
   // S2ContainsVertexQuery.
-  S2ContainsVertexQuery contains_query(vtest);
+  contains_query->Init(vtest);
   int n = shape.num_edges();
   for (int e = 0; e < n; ++e) {
     auto edge = shape.edge(e);
-    if (edge.v0 == vtest) contains_query.AddEdge(edge.v1, 1);
-    if (edge.v1 == vtest) contains_query.AddEdge(edge.v0, -1);
+    if (edge.v0 == vtest) contains_query->AddEdge(edge.v1, 1);
+    if (edge.v1 == vtest) contains_query->AddEdge(edge.v0, -1);
   }
-  int contains_sign = contains_query.ContainsSign();
+  int contains_sign = contains_query->ContainsSign();
   if (contains_sign == 0) {
     return false;  // There are no unmatched edges incident to this vertex.
   }
@@ -72,7 +73,8 @@ S2Shape::ReferencePoint GetReferencePoint(const S2Shape& shape) {
   // arbitrary vertex.
   auto edge = shape.edge(0);
   ReferencePoint result;
-  if (GetReferencePointAtVertex(shape, edge.v0, &result)) {
+  S2ContainsVertexQuery contains_query;
+  if (GetReferencePointAtVertex(shape, edge.v0, &contains_query, &result)) {
     return result;
   }
   // That didn't work, so now we do some extra work to find an unbalanced
@@ -90,11 +92,13 @@ S2Shape::ReferencePoint GetReferencePoint(const S2Shape& shape) {
   std::sort(rev_edges.begin(), rev_edges.end());
   for (int i = 0; i < n; ++i) {
     if (edges[i] < rev_edges[i]) {  // edges[i] is unmatched
-      ABSL_CHECK(GetReferencePointAtVertex(shape, edges[i].v0, &result));
+      ABSL_CHECK(GetReferencePointAtVertex(shape, edges[i].v0, &contains_query,
+                                           &result));
       return result;
     }
     if (rev_edges[i] < edges[i]) {  // rev_edges[i] is unmatched
-      ABSL_CHECK(GetReferencePointAtVertex(shape, rev_edges[i].v0, &result));
+      ABSL_CHECK(GetReferencePointAtVertex(shape, rev_edges[i].v0,
+                                           &contains_query, &result));
       return result;
     }
   }
@@ -0,0 +1,192 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2shapeutil_pipelined_import.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "s2/base/types.h"
+#include "s2/util/coding/coder.h"
+#include "s2/encoded_string_vector.h"
+#include "s2/mutable_s2shape_index.h"
+#include "s2/s2error.h"
+#include "s2/s2shape.h"
+#include "s2/s2shapeutil_coding.h"
+
+using std::unique_ptr;
+using std::vector;
+
+namespace s2shapeutil {
+
+namespace {
+
+// Decodes the shape at "shape_id", using the same tag and dedup-reference
+// handling as TaggedShapeFactory::operator[] (see BatchDecodeShapeFactory).
+// Returns nullptr if the entry is corrupt.
+unique_ptr<S2Shape> DecodeOneShape(
+    const ShapeDecoder& shape_decoder,
+    const s2coding::EncodedStringVector& encoded_shapes, int shape_id) {
+  Decoder d = encoded_shapes.GetDecoder(shape_id);
+  S2Shape::TypeTag tag;
+  if (!d.get_varint32(&tag)) return nullptr;
+  if (tag == S2Shape::kNoTypeTag) {
+    // A reference to an identical shape encoded earlier in the vector (see
+    // EncodeDedupedTaggedShapes).
+    uint32 ref_id;
+    if (!d.get_varint32(&ref_id)) return nullptr;
+    if (ref_id >= static_cast<uint32>(shape_id)) return nullptr;
+    d = encoded_shapes.GetDecoder(ref_id);
+    if (!d.get_varint32(&tag)) return nullptr;
+    if (tag == S2Shape::kNoTypeTag) return nullptr;
+  }
+  return shape_decoder(tag, &d);
+}
+
+}  // namespace
+
+bool PipelinedDecodeShapes(const ShapeDecoder& shape_decoder, Decoder* decoder,
+                           const PipelinedImportOptions& options,
+                           MutableS2ShapeIndex* index, S2Error& error) {
+  s2coding::EncodedStringVector encoded_shapes;
+  if (!encoded_shapes.Init(decoder)) {
+    error.Init(S2Error::DATA_LOSS, "Corrupted encoded shapes.");
+    return false;
+  }
+  const int num_shapes = encoded_shapes.size();
+  if (num_shapes == 0) return true;
+  index->Reserve(num_shapes);
+
+  const int chunk_size = std::max(1, options.shapes_per_chunk);
+  const int num_chunks = (num_shapes + chunk_size - 1) / chunk_size;
+
+  // Decodes the shapes of one chunk; returns false if any entry is corrupt.
+  const auto decode_chunk = [&](int chunk_id,
+                                vector<unique_ptr<S2Shape>>* shapes) {
+    const int begin = chunk_id * chunk_size;
+    const int end = std::min(num_shapes, begin + chunk_size);
+    shapes->reserve(end - begin);
+    for (int i = begin; i < end; ++i) {
+      auto shape = DecodeOneShape(shape_decoder, encoded_shapes, i);
+      if (shape == nullptr) return false;
+      shapes->push_back(std::move(shape));
+    }
+    return true;
+  };
+
+  // Moves one decoded chunk into the index.
+  const auto add_chunk = [&](vector<unique_ptr<S2Shape>> shapes) {
+    index->Add(absl::MakeSpan(shapes));
+    if (options.apply_incrementally) index->ForceBuild();
+  };
+
+  const int num_threads = std::min(options.num_decode_threads, num_chunks);
+  if (num_threads <= 1) {
+    // Degenerate pipeline: decode and insert alternately on this thread.
+    for (int chunk_id = 0; chunk_id < num_chunks; ++chunk_id) {
+      vector<unique_ptr<S2Shape>> shapes;
+      if (!decode_chunk(chunk_id, &shapes)) {
+        error.Init(S2Error::DATA_LOSS, "Corrupted encoded shape.");
+        return false;
+      }
+      add_chunk(std::move(shapes));
+    }
+    return true;
+  }
+
+  // Shared pipeline state, guarded by "mutex".  Decode threads claim chunk
+  // ids from "next_chunk" and deposit results into "ready"; the calling
+  // thread removes chunks in order of "next_insert".  The number of
+  // deposited but not yet removed chunks is bounded by max_queued_chunks,
+  // which bounds the decoded shapes buffered ahead of insertion.
+  std::mutex mutex;
+  std::condition_variable chunk_ready;     // A chunk was deposited, or failure.
+  std::condition_variable queue_has_room;  // A chunk was removed, or failure.
+  std::map<int, vector<unique_ptr<S2Shape>>> ready;
+  int next_chunk = 0;
+  int next_insert = 0;
+  bool failed = false;
+  const int max_queued = std::max(1, options.max_queued_chunks);
+
+  const auto decode_worker = [&]() {
+    for (;;) {
+      int chunk_id;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (failed || next_chunk >= num_chunks) return;
+        chunk_id = next_chunk++;
+      }
+      vector<unique_ptr<S2Shape>> shapes;
+      const bool ok = decode_chunk(chunk_id, &shapes);
+      std::unique_lock<std::mutex> lock(mutex);
+      if (!ok) {
+        failed = true;
+        chunk_ready.notify_all();
+        queue_has_room.notify_all();
+        return;
+      }
+      // The chunk that insertion is waiting on is never delayed, so a full
+      // queue cannot deadlock the pipeline: chunk ids are claimed in order,
+      // and therefore "next_insert" is always held by some decode thread
+      // until it is deposited.
+      queue_has_room.wait(lock, [&] {
+        return failed || chunk_id == next_insert ||
+               static_cast<int>(ready.size()) < max_queued;
+      });
+      if (failed) return;
+      ready.emplace(chunk_id, std::move(shapes));
+      chunk_ready.notify_all();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (int t = 0; t < num_threads; ++t) threads.emplace_back(decode_worker);
+
+  for (;;) {
+    vector<unique_ptr<S2Shape>> shapes;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      if (next_insert >= num_chunks) break;
+      chunk_ready.wait(lock, [&] {
+        return failed || ready.find(next_insert) != ready.end();
+      });
+      if (failed) break;
+      const auto it = ready.find(next_insert);
+      shapes = std::move(it->second);
+      ready.erase(it);
+      ++next_insert;
+      // Wakes both producers waiting for room and the producer holding the
+      // new "next_insert" chunk.
+      queue_has_room.notify_all();
+    }
+    add_chunk(std::move(shapes));
+  }
+  for (auto& thread : threads) thread.join();
+  if (failed) {
+    error.Init(S2Error::DATA_LOSS, "Corrupted encoded shape.");
+    return false;
+  }
+  return true;
+}
+
+}  // namespace s2shapeutil
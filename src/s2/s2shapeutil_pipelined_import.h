@@ -0,0 +1,83 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef S2_S2SHAPEUTIL_PIPELINED_IMPORT_H_
+#define S2_S2SHAPEUTIL_PIPELINED_IMPORT_H_
+
+#include "s2/util/coding/coder.h"
+#include "s2/mutable_s2shape_index.h"
+#include "s2/s2error.h"
+#include "s2/s2shapeutil_coding.h"
+
+namespace s2shapeutil {
+
+// Options controlling PipelinedDecodeShapes() below.
+struct PipelinedImportOptions {
+  // The number of threads used to decode shape payloads.  With one thread
+  // the import degenerates to alternating decode and insertion on the
+  // calling thread.
+  int num_decode_threads = 2;
+
+  // The number of consecutive shapes decoded and handed to the index as one
+  // unit.  Larger chunks amortize queue synchronization; smaller chunks
+  // reduce the delay before the index can start working on early shapes.
+  int shapes_per_chunk = 256;
+
+  // The maximum number of decoded chunks buffered ahead of the insertion
+  // stage.  This bounds the memory held by decoded shapes that have not yet
+  // been inserted when decoding outpaces insertion.
+  int max_queued_chunks = 4;
+
+  // If true (the default), each chunk's pending updates are applied to the
+  // index as soon as the chunk is inserted, so that edge clipping for early
+  // shapes overlaps the decoding of later ones.  If false, the decoded
+  // shapes are left as pending additions to be applied by the first query
+  // or by ForceBuild(); this forgoes the decode/build overlap but preserves
+  // the single-batch parallel build path (see
+  // MutableS2ShapeIndex::Options::num_index_threads).
+  bool apply_incrementally = true;
+};
+
+// Decodes a vector of tagged shapes produced by EncodeTaggedShapes() and
+// appends them to "index" in encoded order, pipelining the two stages:
+// decode threads stream chunks of shapes into a bounded queue, and the
+// calling thread moves each chunk into the index as it becomes available.
+// This overlaps decoding with index insertion, unlike decoding everything
+// up front (see BatchDecodeShapeFactory) or faulting shapes in one at a
+// time (see TaggedShapeFactory).
+//
+// Returns true on success.  If the encoding is corrupt, sets "error", stops
+// both stages, and returns false; the index then contains some prefix of
+// the encoded shapes.  Note that unlike the ShapeFactory-based decoders,
+// entries that fail to decode are an error rather than null shapes, since
+// MutableS2ShapeIndex assigns ids densely.
+//
+// Example usage, restoring an index encoded with FastEncodeTaggedShapes():
+//
+//   Decoder decoder(data.data(), data.size());
+//   MutableS2ShapeIndex index;
+//   S2Error error;
+//   if (!s2shapeutil::PipelinedDecodeShapes(
+//           s2shapeutil::FullDecodeShape, &decoder,
+//           s2shapeutil::PipelinedImportOptions(), &index, error)) {
+//     return error;
+//   }
+bool PipelinedDecodeShapes(const ShapeDecoder& shape_decoder, Decoder* decoder,
+                           const PipelinedImportOptions& options,
+                           MutableS2ShapeIndex* index, S2Error& error);
+
+}  // namespace s2shapeutil
+
+#endif  // S2_S2SHAPEUTIL_PIPELINED_IMPORT_H_
@@ -0,0 +1,165 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2shapeutil_pipelined_import.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "s2/util/coding/coder.h"
+#include "s2/mutable_s2shape_index.h"
+#include "s2/s2error.h"
+#include "s2/s2latlng.h"
+#include "s2/s2point.h"
+#include "s2/s2point_vector_shape.h"
+#include "s2/s2shapeutil_coding.h"
+#include "s2/s2shapeutil_testing.h"
+#include "s2/s2text_format.h"
+
+using std::make_unique;
+using std::vector;
+
+namespace s2shapeutil {
+
+// Builds an index with enough shapes to exercise multiple chunks.
+void MakeLargeIndex(MutableS2ShapeIndex* index) {
+  for (int i = 0; i < 40; ++i) {
+    index->Add(make_unique<S2PointVectorShape>(vector<S2Point>{
+        S2LatLng::FromDegrees(i, 2 * i).ToPoint()}));
+  }
+}
+
+TEST(PipelinedDecodeShapes, BatchModeMatchesOriginalIndex) {
+  // With apply_incrementally = false the imported shapes are applied as one
+  // batch, so the resulting index is identical to the original.  A small
+  // chunk size and queue ensure that the bounded queue actually fills up.
+  MutableS2ShapeIndex original;
+  MakeLargeIndex(&original);
+  Encoder encoder;
+  ASSERT_TRUE(FastEncodeTaggedShapes(original, &encoder));
+
+  PipelinedImportOptions options;
+  options.num_decode_threads = 4;
+  options.shapes_per_chunk = 3;
+  options.max_queued_chunks = 2;
+  options.apply_incrementally = false;
+
+  Decoder decoder(encoder.base(), encoder.length());
+  MutableS2ShapeIndex imported;
+  S2Error error;
+  ASSERT_TRUE(PipelinedDecodeShapes(FullDecodeShape, &decoder, options,
+                                    &imported, error));
+  EXPECT_TRUE(error.ok());
+  s2testing::ExpectEqual(imported, original);
+}
+
+TEST(PipelinedDecodeShapes, IncrementalModeMatchesChunkedInsertion) {
+  // With apply_incrementally = true each chunk is applied as a separate
+  // incremental update, which may subdivide cells differently than a single
+  // batch.  The result is identical to inserting the same shapes with the
+  // same chunking directly.
+  MutableS2ShapeIndex original;
+  MakeLargeIndex(&original);
+  Encoder encoder;
+  ASSERT_TRUE(FastEncodeTaggedShapes(original, &encoder));
+
+  PipelinedImportOptions options;
+  options.num_decode_threads = 4;
+  options.shapes_per_chunk = 3;
+  options.max_queued_chunks = 2;
+  options.apply_incrementally = true;
+
+  Decoder decoder(encoder.base(), encoder.length());
+  MutableS2ShapeIndex imported;
+  S2Error error;
+  ASSERT_TRUE(PipelinedDecodeShapes(FullDecodeShape, &decoder, options,
+                                    &imported, error));
+  EXPECT_TRUE(error.ok());
+
+  MutableS2ShapeIndex expected;
+  for (int begin = 0; begin < original.num_shape_ids();
+       begin += options.shapes_per_chunk) {
+    const int end = std::min(original.num_shape_ids(),
+                             begin + options.shapes_per_chunk);
+    for (int id = begin; id < end; ++id) {
+      expected.Add(make_unique<S2PointVectorShape>(vector<S2Point>{
+          original.shape(id)->edge(0).v0}));
+    }
+    expected.ForceBuild();
+  }
+  s2testing::ExpectEqual(imported, expected);
+}
+
+TEST(PipelinedDecodeShapes, SingleThreadMixedShapes) {
+  // The degenerate single-threaded pipeline handles points, polylines, and
+  // polygons (including the dedup references of EncodeDedupedTaggedShapes).
+  auto original = s2textformat::MakeIndexOrDie(
+      "0:0 | 0:1 # 1:1, 1:2, 1:3 | 1:1, 1:2, 1:3 # 2:2; 2:3, 2:4, 3:3");
+  Encoder encoder;
+  ASSERT_TRUE(EncodeDedupedTaggedShapes(*original, CompactEncodeShape,
+                                        &encoder));
+
+  PipelinedImportOptions options;
+  options.num_decode_threads = 1;
+  options.shapes_per_chunk = 2;
+
+  Decoder decoder(encoder.base(), encoder.length());
+  MutableS2ShapeIndex imported;
+  S2Error error;
+  ASSERT_TRUE(PipelinedDecodeShapes(FullDecodeShape, &decoder, options,
+                                    &imported, error));
+  s2testing::ExpectEqual(imported, *original);
+}
+
+TEST(PipelinedDecodeShapes, EmptyVector) {
+  MutableS2ShapeIndex empty;
+  Encoder encoder;
+  ASSERT_TRUE(FastEncodeTaggedShapes(empty, &encoder));
+
+  Decoder decoder(encoder.base(), encoder.length());
+  MutableS2ShapeIndex imported;
+  S2Error error;
+  EXPECT_TRUE(PipelinedDecodeShapes(FullDecodeShape, &decoder,
+                                    PipelinedImportOptions(), &imported,
+                                    error));
+  EXPECT_EQ(imported.num_shape_ids(), 0);
+}
+
+TEST(PipelinedDecodeShapes, CorruptEncodingReturnsError) {
+  MutableS2ShapeIndex original;
+  MakeLargeIndex(&original);
+  Encoder encoder;
+  ASSERT_TRUE(FastEncodeTaggedShapes(original, &encoder));
+
+  // Truncating the buffer corrupts either the string vector or the trailing
+  // shape payloads; both must surface as DATA_LOSS from every pipeline
+  // configuration rather than crashing or hanging.
+  for (int num_decode_threads : {1, 4}) {
+    PipelinedImportOptions options;
+    options.num_decode_threads = num_decode_threads;
+    options.shapes_per_chunk = 3;
+
+    Decoder decoder(encoder.base(), encoder.length() - 5);
+    MutableS2ShapeIndex imported;
+    S2Error error;
+    EXPECT_FALSE(PipelinedDecodeShapes(FullDecodeShape, &decoder, options,
+                                       &imported, error));
+    EXPECT_EQ(error.code(), S2Error::DATA_LOSS);
+  }
+}
+
+}  // namespace s2shapeutil
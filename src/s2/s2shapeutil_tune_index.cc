@@ -0,0 +1,128 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2shapeutil_tune_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+#include "absl/types/span.h"
+#include "s2/base/types.h"
+#include "s2/mutable_s2shape_index.h"
+#include "s2/s2shape.h"
+#include "s2/s2shape_index.h"
+
+using std::max;
+using std::pow;
+using std::unique_ptr;
+using std::vector;
+
+namespace s2shapeutil {
+
+IndexCellStats GatherIndexCellStats(const S2ShapeIndex& index) {
+  IndexCellStats stats;
+  stats.num_edges = index.num_edges();
+  for (S2ShapeIndex::Iterator it(&index, S2ShapeIndex::BEGIN); !it.done();
+       it.Next()) {
+    ++stats.num_cells;
+    stats.num_edge_refs += it.cell().num_edges();
+  }
+  return stats;
+}
+
+namespace {
+
+// Candidate values considered for max_edges_per_cell.  The cost model below
+// is far too coarse to distinguish between adjacent integers, so we only
+// consider a geometric-ish progression around the default of 10.
+constexpr int kCandidates[] = {4, 6, 8, 10, 14, 20, 28, 40, 56, 80};
+
+// When the maximum number of edges per cell is halved, roughly one extra
+// level of subdivision is needed (cells split four ways but edges usually
+// cross into only two of the children), and each level of subdivision clips
+// the edges spanning a split into additional cells.  Empirically the total
+// number of edge references grows by roughly this factor per doubling of the
+// cell count, i.e. refs(c) ~ c^-log2(kRefGrowthPerLevel).
+constexpr double kRefGrowthPerLevel = 1.25;
+
+// Approximate memory costs, in bytes.  Each clipped edge stores an int32
+// edge id, and each index cell costs roughly an S2ShapeIndexCell plus its
+// entry in the cell map.
+constexpr double kBytesPerEdgeRef = 8;
+constexpr double kBytesPerCell = 80;
+
+// Approximate query costs, in arbitrary but consistent units.  Visiting a
+// cell (iterator seek plus decoding) costs about as much as testing a dozen
+// candidate edges.
+constexpr double kCostPerCellVisit = 12;
+constexpr double kCostPerEdgeTest = 1;
+
+}  // namespace
+
+MutableS2ShapeIndex::Options RecommendOptions(const MutableS2ShapeIndex& index,
+                                              double memory_weight) {
+  ABSL_DCHECK_GE(memory_weight, 0);
+  ABSL_DCHECK_LE(memory_weight, 1);
+  MutableS2ShapeIndex::Options options = index.options();
+  IndexCellStats stats = GatherIndexCellStats(index);
+  if (stats.num_cells == 0 || stats.num_edge_refs == 0) return options;
+
+  // The fraction of the edges-per-cell budget that cells actually use; this
+  // carries over approximately when the budget changes.
+  const int c0 = options.max_edges_per_cell();
+  const double fill = max(0.05, stats.avg_edges_per_cell() / c0);
+  const double ref_exponent = std::log2(kRefGrowthPerLevel);
+
+  double best_score = 0;
+  int best_c = c0;
+  for (int c : kCandidates) {
+    // Extrapolate the number of edge references and cells at budget "c" from
+    // the observed values at budget "c0" (see kRefGrowthPerLevel).
+    const double refs = stats.num_edge_refs *
+                        pow(static_cast<double>(c0) / c, ref_exponent);
+    const double cells = refs / (fill * c);
+    const double memory = refs * kBytesPerEdgeRef + cells * kBytesPerCell;
+    // A query that reaches a cell pays for the visit plus a scan of the
+    // cell's candidate edges.
+    const double query = kCostPerCellVisit + kCostPerEdgeTest * fill * c;
+    const double score =
+        pow(memory, memory_weight) * pow(query, 1 - memory_weight);
+    if (best_score == 0 || score < best_score) {
+      best_score = score;
+      best_c = c;
+    }
+  }
+  options.set_max_edges_per_cell(best_c);
+  return options;
+}
+
+void RebuildWithRecommendedOptions(MutableS2ShapeIndex* index,
+                                   double memory_weight) {
+  MutableS2ShapeIndex::Options options = RecommendOptions(*index,
+                                                          memory_weight);
+  if (options.max_edges_per_cell() ==
+      index->options().max_edges_per_cell()) {
+    return;  // Nothing to do, and Init() would discard the built cells.
+  }
+  vector<unique_ptr<S2Shape>> shapes = index->ReleaseAll();
+  index->Init(options);
+  index->Add(absl::MakeSpan(shapes));
+}
+
+}  // namespace s2shapeutil
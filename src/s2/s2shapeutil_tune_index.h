@@ -0,0 +1,74 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef S2_S2SHAPEUTIL_TUNE_INDEX_H_
+#define S2_S2SHAPEUTIL_TUNE_INDEX_H_
+
+#include "s2/base/types.h"
+#include "s2/mutable_s2shape_index.h"
+#include "s2/s2shape_index.h"
+
+namespace s2shapeutil {
+
+// Statistics describing how the cells of a built S2ShapeIndex are utilized.
+// These are gathered by a single pass over the index cells.
+struct IndexCellStats {
+  int64 num_edges = 0;      // Distinct edges over all indexed shapes.
+  int64 num_cells = 0;      // Number of index cells.
+  int64 num_edge_refs = 0;  // Clipped edge references summed over all cells.
+
+  // Average number of edge references per cell, or zero if there are none.
+  double avg_edges_per_cell() const {
+    return num_cells > 0 ? static_cast<double>(num_edge_refs) / num_cells : 0;
+  }
+
+  // Ratio of edge references to distinct edges (>= 1 for non-empty indexes).
+  // High values indicate that edges are long relative to the cells and are
+  // being clipped into many of them.
+  double duplication_factor() const {
+    return num_edges > 0 ? static_cast<double>(num_edge_refs) / num_edges : 0;
+  }
+};
+
+// Returns utilization statistics for the given index, building it first if
+// necessary.
+IndexCellStats GatherIndexCellStats(const S2ShapeIndex& index);
+
+// Returns a recommended set of options for indexing the contents of "index",
+// based on the statistics above and a simple model of query cost vs memory.
+//
+// Larger values of max_edges_per_cell reduce the number of index cells (and
+// the number of times each edge is clipped and stored), at the price of
+// testing more candidate edges per cell during queries.  "memory_weight"
+// positions the recommendation on that tradeoff: 0 tunes purely for query
+// speed, 1 purely for memory, and 0.5 (the default) balances the two.
+//
+// The model is a heuristic: it extrapolates from the observed cell
+// utilization rather than rebuilding the index at each candidate setting, so
+// it is cheap enough to run on production-sized indexes, but the
+// recommendation should be validated with benchmarks where it matters.
+MutableS2ShapeIndex::Options RecommendOptions(const MutableS2ShapeIndex& index,
+                                              double memory_weight = 0.5);
+
+// Rebuilds "index" in place with the options recommended above.  The shapes
+// and their ids are preserved.  This is equivalent to releasing all shapes,
+// calling Init() with RecommendOptions(), and re-adding the shapes, so it
+// temporarily requires memory for both the old and new cell structures.
+void RebuildWithRecommendedOptions(MutableS2ShapeIndex* index,
+                                   double memory_weight = 0.5);
+
+}  // namespace s2shapeutil
+
+#endif  // S2_S2SHAPEUTIL_TUNE_INDEX_H_
@@ -0,0 +1,92 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2shapeutil_tune_index.h"
+
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+#include "absl/strings/str_cat.h"
+#include "s2/mutable_s2shape_index.h"
+#include "s2/s2text_format.h"
+
+using s2shapeutil::GatherIndexCellStats;
+using s2shapeutil::IndexCellStats;
+using s2shapeutil::RebuildWithRecommendedOptions;
+using s2shapeutil::RecommendOptions;
+using std::string;
+using std::unique_ptr;
+
+namespace {
+
+// Returns an index over a moderately dense grid of polylines, enough to
+// force subdivision at the default options.
+unique_ptr<MutableS2ShapeIndex> MakeGridIndex() {
+  string str;
+  for (int i = 0; i < 40; ++i) {
+    absl::StrAppend(&str, (i > 0 ? "|" : ""), "0:", i * 0.1, ", 1:", i * 0.1);
+  }
+  return s2textformat::MakeIndexOrDie("# " + str + " #");
+}
+
+TEST(GatherIndexCellStats, CountsCellsAndEdges) {
+  auto index = MakeGridIndex();
+  IndexCellStats stats = GatherIndexCellStats(*index);
+  EXPECT_EQ(stats.num_edges, index->num_edges());
+  EXPECT_GT(stats.num_cells, 0);
+  // Every edge is referenced by at least one cell.
+  EXPECT_GE(stats.num_edge_refs, stats.num_edges);
+  EXPECT_GE(stats.duplication_factor(), 1.0);
+  EXPECT_GT(stats.avg_edges_per_cell(), 0);
+}
+
+TEST(GatherIndexCellStats, EmptyIndex) {
+  MutableS2ShapeIndex index;
+  IndexCellStats stats = GatherIndexCellStats(index);
+  EXPECT_EQ(stats.num_edges, 0);
+  EXPECT_EQ(stats.num_cells, 0);
+  EXPECT_EQ(stats.num_edge_refs, 0);
+}
+
+TEST(RecommendOptions, MemoryWeightTradesCellSizeForSpeed) {
+  auto index = MakeGridIndex();
+  int speed = RecommendOptions(*index, 0.0).max_edges_per_cell();
+  int balanced = RecommendOptions(*index, 0.5).max_edges_per_cell();
+  int memory = RecommendOptions(*index, 1.0).max_edges_per_cell();
+  // Tuning for memory always allows at least as many edges per cell as
+  // tuning for query speed.
+  EXPECT_LE(speed, balanced);
+  EXPECT_LE(balanced, memory);
+}
+
+TEST(RecommendOptions, EmptyIndexKeepsCurrentOptions) {
+  MutableS2ShapeIndex index;
+  EXPECT_EQ(RecommendOptions(index).max_edges_per_cell(),
+            index.options().max_edges_per_cell());
+}
+
+TEST(RebuildWithRecommendedOptions, PreservesShapes) {
+  auto index = MakeGridIndex();
+  const int num_shapes = index->num_shape_ids();
+  const int num_edges = index->num_edges();
+  const int recommended = RecommendOptions(*index, 1.0).max_edges_per_cell();
+  RebuildWithRecommendedOptions(index.get(), 1.0);
+  EXPECT_EQ(index->options().max_edges_per_cell(), recommended);
+  EXPECT_EQ(index->num_shape_ids(), num_shapes);
+  EXPECT_EQ(index->num_edges(), num_edges);
+}
+
+}  // namespace
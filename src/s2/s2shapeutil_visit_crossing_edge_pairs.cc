@@ -17,6 +17,8 @@
 
 #include "s2/s2shapeutil_visit_crossing_edge_pairs.h"
 
+#include <algorithm>
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -24,15 +26,19 @@
 #include "absl/container/inlined_vector.h"
 #include "absl/log/absl_check.h"
 #include "absl/strings/str_format.h"
+#include "absl/types/span.h"
 #include "s2/s2cell_id.h"
 #include "s2/s2cell_range_iterator.h"
 #include "s2/s2crossing_edge_query.h"
 #include "s2/s2edge_crosser.h"
 #include "s2/s2error.h"
+#include "s2/s2executor.h"
 #include "s2/s2padded_cell.h"
 #include "s2/s2point.h"
 #include "s2/s2shape.h"
 #include "s2/s2shape_index.h"
+#include "s2/s2shapeutil_count_edges.h"
+#include "s2/s2shapeutil_get_balanced_ranges.h"
 #include "s2/s2shapeutil_shape_edge.h"
 #include "s2/s2shapeutil_shape_edge_id.h"
 #include "s2/s2wedge_relations.h"
@@ -375,6 +381,196 @@ bool VisitCrossingEdgePairs(const S2ShapeIndex& a_index,
   return true;
 }
 
+// Advances "p" until it is not strictly interior to an index cell of either
+// index, so that it can be used as a partition boundary for the range-based
+// walk below.  (The containing cells form a nesting chain, so this loop
+// terminates after at most S2CellId::kMaxLevel iterations per index.)
+static S2CellId AlignRangeBoundary(const S2ShapeIndex& a_index,
+                                   const S2ShapeIndex& b_index, S2CellId p) {
+  const S2CellId end = S2CellId::End(S2CellId::kMaxLevel);
+  S2ShapeIndex::Iterator a_it(&a_index), b_it(&b_index);
+  bool moved = true;
+  while (moved && p != end) {
+    moved = false;
+    if (a_it.Locate(p) == S2CellRelation::INDEXED &&
+        a_it.id().range_min() < p) {
+      p = a_it.id().range_max().next();
+      moved = true;
+    }
+    if (p != end && b_it.Locate(p) == S2CellRelation::INDEXED &&
+        b_it.id().range_min() < p) {
+      p = b_it.id().range_max().next();
+      moved = true;
+    }
+  }
+  return p;
+}
+
+// Like the two-index VisitCrossingEdgePairs() above, but only visits
+// crossings between index cells contained by the leaf cell range
+// [begin, limit).
+//
+// REQUIRES: no index cell of either index straddles "begin" or "limit"
+//           (see AlignRangeBoundary), so that every pair of overlapping
+//           index cells belongs to exactly one such range.
+static bool VisitCrossingEdgePairsInRange(
+    const S2ShapeIndex& a_index, const S2ShapeIndex& b_index,
+    CrossingType type, const EdgePairVisitor& visitor,
+    S2CellId begin, S2CellId limit) {
+  auto ai = MakeS2CellRangeIterator(&a_index);
+  auto bi = MakeS2CellRangeIterator(&b_index);
+  ai.Seek(begin);
+  bi.Seek(begin);
+  IndexCrosser ab(a_index, b_index, type, visitor, false);  // Tests A against B
+  IndexCrosser ba(b_index, a_index, type, visitor, true);   // Tests B against A
+  // Once either index has no further cells in the range, the remaining cells
+  // of the other index cannot overlap any cell of this range.
+  while (!ai.done() && ai.range_min() < limit &&
+         !bi.done() && bi.range_min() < limit) {
+    if (ai.range_max() < bi.range_min()) {
+      // The A and B cells don't overlap, and A precedes B.
+      ai.SeekTo(bi);
+    } else if (bi.range_max() < ai.range_min()) {
+      // The A and B cells don't overlap, and B precedes A.
+      bi.SeekTo(ai);
+    } else {
+      // One cell contains the other.  Determine which cell is larger.
+      int64 ab_relation = ai.id().lsb() - bi.id().lsb();
+      if (ab_relation > 0) {
+        // A's index cell is larger.
+        if (!ab.VisitCrossings(&ai, &bi)) return false;
+      } else if (ab_relation < 0) {
+        // B's index cell is larger.
+        if (!ba.VisitCrossings(&bi, &ai)) return false;
+      } else {
+        // The A and B cells are the same.
+        if (ai.iterator().cell().num_edges() > 0 &&
+            bi.iterator().cell().num_edges() > 0) {
+          if (!ab.VisitCellCellCrossings(ai.iterator().cell(),
+                                         bi.iterator().cell()))
+            return false;
+        }
+        ai.Next();
+        bi.Next();
+      }
+    }
+  }
+  return true;
+}
+
+bool VisitCrossingEdgePairs(const S2ShapeIndex& a_index,
+                            const S2ShapeIndex& b_index, CrossingType type,
+                            absl::Span<const EdgePairVisitor> visitors,
+                            S2Executor* executor) {
+  const int num_threads = visitors.size();
+  ABSL_DCHECK_GT(num_threads, 0);
+  if (num_threads == 1) {
+    return VisitCrossingEdgePairs(a_index, b_index, type, visitors[0]);
+  }
+  // Split the S2CellId space into several ranges per thread (rather than just
+  // one) so that an unusually expensive range does not serialize the whole
+  // pass, then align the range boundaries so that no index cell straddles a
+  // boundary (otherwise crossings involving that cell could be missed).
+  const int64 num_edges = CountEdges(a_index) + CountEdges(b_index);
+  const int64 max_edges_per_range =
+      std::max<int64>(1, num_edges / (4 * num_threads));
+  vector<S2CellId> cuts;
+  cuts.push_back(S2CellId::Begin(S2CellId::kMaxLevel));
+  for (const CellIdRange& range :
+       GetBalancedCellIdRanges({&a_index, &b_index}, max_edges_per_range)) {
+    S2CellId cut = AlignRangeBoundary(a_index, b_index, range.limit);
+    if (cut > cuts.back()) cuts.push_back(cut);
+  }
+  ABSL_DCHECK_EQ(cuts.back(), S2CellId::End(S2CellId::kMaxLevel));
+
+  std::atomic<bool> result(true);
+  if (executor == nullptr) executor = S2Executor::Default();
+  executor->Run(num_threads, [&](int t) {
+    for (size_t r = t; r + 1 < cuts.size(); r += num_threads) {
+      if (!VisitCrossingEdgePairsInRange(a_index, b_index, type, visitors[t],
+                                         cuts[r], cuts[r + 1])) {
+        result = false;
+        return;
+      }
+    }
+  });
+  return result;
+}
+
+// Like the single-index VisitCrossings() above, but only visits the index
+// cells whose range_min() is contained by the leaf cell range [begin, limit).
+static bool VisitCrossingsInRange(const S2ShapeIndex& index, CrossingType type,
+                                  bool need_adjacent,
+                                  const EdgePairVisitor& visitor,
+                                  S2CellId begin, S2CellId limit) {
+  ShapeEdgeVector shape_edges;
+  auto it = MakeS2CellRangeIterator(&index);
+  for (it.Seek(begin); !it.done() && it.range_min() < limit; it.Next()) {
+    GetShapeEdges(index, it.iterator().cell(), &shape_edges);
+    if (!VisitCrossings(shape_edges, type, need_adjacent, visitor)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Multi-threaded form of the single-index VisitCrossings() above.  The
+// crossings within one index cell do not depend on any other cell, and the
+// cells of a single index do not overlap, so unlike the two-index case the
+// range boundaries need no further alignment.
+static bool VisitCrossings(const S2ShapeIndex& index, CrossingType type,
+                           bool need_adjacent,
+                           absl::Span<const EdgePairVisitor> visitors,
+                           S2Executor* executor) {
+  const int num_threads = visitors.size();
+  ABSL_DCHECK_GT(num_threads, 0);
+  if (num_threads == 1) {
+    return VisitCrossings(index, type, need_adjacent, visitors[0]);
+  }
+  // As in the two-index overload above, use several ranges per thread so
+  // that an unusually expensive range does not serialize the whole pass.
+  const int64 num_edges = CountEdges(index);
+  const int64 max_edges_per_range =
+      std::max<int64>(1, num_edges / (4 * num_threads));
+  const vector<CellIdRange> ranges =
+      GetBalancedCellIdRanges({&index}, max_edges_per_range);
+
+  std::atomic<bool> result(true);
+  if (executor == nullptr) executor = S2Executor::Default();
+  executor->Run(num_threads, [&](int t) {
+    for (size_t r = t; r < ranges.size(); r += num_threads) {
+      if (!VisitCrossingsInRange(index, type, need_adjacent, visitors[t],
+                                 ranges[r].begin, ranges[r].limit)) {
+        result = false;
+        return;
+      }
+    }
+  });
+  return result;
+}
+
+bool VisitCrossingEdgePairs(const S2ShapeIndex& index, CrossingType type,
+                            absl::Span<const EdgePairVisitor> visitors,
+                            S2Executor* executor) {
+  const bool need_adjacent = (type == CrossingType::ALL);
+  return VisitCrossings(index, type, need_adjacent, visitors, executor);
+}
+
+bool VisitCrossingEdgePairs(const S2ShapeIndex& index, CrossingType type,
+                            const EdgePairVisitor& visitor, int num_threads,
+                            S2Executor* executor) {
+  ABSL_DCHECK_GE(num_threads, 1);
+  // Point every worker at the same underlying visitor.  (The per-worker
+  // wrappers capture it by reference rather than copying it, since copies of
+  // a stateful visitor would each mutate their own state.)
+  std::vector<EdgePairVisitor> visitors(
+      num_threads,
+      [&visitor](const ShapeEdge& a, const ShapeEdge& b, bool is_interior) {
+        return visitor(a, b, is_interior);
+      });
+  return VisitCrossingEdgePairs(index, type, visitors, executor);
+}
+
 //////////////////////////////////////////////////////////////////////
 
 // Helper function that formats a loop error message.  If the loop belongs to
@@ -466,4 +662,41 @@ bool FindSelfIntersection(const S2ShapeIndex& index, S2Error* error) {
       });
 }
 
+bool FindSelfIntersection(const S2ShapeIndex& index, S2Error* error,
+                          int num_threads, S2Executor* executor) {
+  ABSL_DCHECK_GE(num_threads, 1);
+  if (num_threads == 1) return FindSelfIntersection(index, error);
+  if (index.num_shape_ids() == 0) return false;
+  ABSL_DCHECK_EQ(1, index.num_shape_ids());
+  const S2Shape& shape = *index.shape(0);
+
+  // Each thread records the first error it finds in its own slot, so the
+  // visitors need no synchronization with each other.
+  vector<S2Error> errors(num_threads);
+  vector<EdgePairVisitor> visitors;
+  visitors.reserve(num_threads);
+  for (int t = 0; t < num_threads; ++t) {
+    S2Error* thread_error = &errors[t];
+    visitors.push_back(
+        [&shape, thread_error](const ShapeEdge& a, const ShapeEdge& b,
+                               bool is_interior) {
+          return !FindCrossingError(shape, a, b, is_interior, thread_error);
+        });
+  }
+  // As in the serial version above, pairs of the form (AB, BC) are skipped
+  // since FindCrossingError() only needs pairs of the form (AB, AC).
+  if (VisitCrossings(index, CrossingType::ALL, false /*need_adjacent*/,
+                     visitors, executor)) {
+    return false;
+  }
+  for (const S2Error& thread_error : errors) {
+    if (!thread_error.ok()) {
+      *error = thread_error;
+      return true;
+    }
+  }
+  ABSL_DCHECK(false);  // A visitor terminated without recording an error.
+  return false;
+}
+
 }  // namespace s2shapeutil
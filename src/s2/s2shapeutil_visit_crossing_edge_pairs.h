@@ -20,8 +20,11 @@
 
 #include <functional>
 
+#include "absl/types/span.h"
+
 #include "s2/s2crossing_edge_query.h"
 #include "s2/s2error.h"
+#include "s2/s2executor.h"
 #include "s2/s2shape_index.h"
 #include "s2/s2shapeutil_shape_edge.h"
 
@@ -56,6 +59,50 @@ bool VisitCrossingEdgePairs(const S2ShapeIndex& a_index,
                             const S2ShapeIndex& b_index,
                             CrossingType type, const EdgePairVisitor& visitor);
 
+// Like the above, but distributes the work over visitors.size() threads by
+// splitting the S2CellId space into contiguous ranges containing
+// approximately equal numbers of edges.  Thread "t" reports the crossings it
+// finds to visitors[t], so the visitors do not need to be thread-safe with
+// respect to each other (e.g., each one can append to its own output vector).
+// The assignment of crossings to visitors and the order of the calls within
+// each visitor are unspecified.
+//
+// If a visitor returns false then its thread terminates early and the
+// overall result is false; the remaining threads still run to completion.
+//
+// REQUIRES: !visitors.empty()
+//
+// CAVEAT: Crossings may be visited more than once.
+//
+// If an executor is given then the threads are run on it; otherwise
+// S2Executor::Default() is used.
+bool VisitCrossingEdgePairs(const S2ShapeIndex& a_index,
+                            const S2ShapeIndex& b_index, CrossingType type,
+                            absl::Span<const EdgePairVisitor> visitors,
+                            S2Executor* executor = nullptr);
+
+// Like the above, but for the crossing edge pairs within a single
+// S2ShapeIndex.  Since the index cells of one index do not overlap each
+// other, each thread simply processes a contiguous subset of them.
+//
+// REQUIRES: !visitors.empty()
+//
+// CAVEAT: Crossings may be visited more than once.
+bool VisitCrossingEdgePairs(const S2ShapeIndex& index, CrossingType type,
+                            absl::Span<const EdgePairVisitor> visitors,
+                            S2Executor* executor = nullptr);
+
+// Like the overload above, but invokes a single visitor from all of the
+// "num_threads" threads rather than giving each thread its own.  This is
+// convenient when the visitor is naturally thread-safe (e.g. it only sets an
+// atomic flag, or accumulates into a mutex-guarded container).
+//
+// REQUIRES: num_threads >= 1
+// REQUIRES: "visitor" is safe to invoke concurrently.
+bool VisitCrossingEdgePairs(const S2ShapeIndex& index, CrossingType type,
+                            const EdgePairVisitor& visitor, int num_threads,
+                            S2Executor* executor = nullptr);
+
 // Given an S2ShapeIndex containing a single polygonal shape (e.g., an
 // S2Polygon or S2Loop), return true if any loop has a self-intersection
 // (including duplicate vertices) or crosses any other loop (including vertex
@@ -69,6 +116,19 @@ bool VisitCrossingEdgePairs(const S2ShapeIndex& a_index,
 // duplicate vertices and edges are allowed, but loop crossings are not).
 bool FindSelfIntersection(const S2ShapeIndex& index, S2Error* error);
 
+// Like the above, but checks "num_threads" contiguous S2CellId ranges of the
+// index in parallel.  Validation is a pure read of the index, so the threads
+// require no synchronization beyond a flag recording whether an error was
+// found.  If several ranges contain errors then which error is reported is
+// unspecified (but it is always one that the serial version could report).
+//
+// If an executor is given then the threads are run on it; otherwise
+// S2Executor::Default() is used.
+//
+// REQUIRES: num_threads >= 1
+bool FindSelfIntersection(const S2ShapeIndex& index, S2Error* error,
+                          int num_threads, S2Executor* executor = nullptr);
+
 }  // namespace s2shapeutil
 
 #endif  // S2_S2SHAPEUTIL_VISIT_CROSSING_EDGE_PAIRS_H_
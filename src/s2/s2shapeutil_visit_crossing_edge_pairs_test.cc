@@ -29,6 +29,7 @@
 
 #include "absl/log/absl_log.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 
 #include "s2/mutable_s2shape_index.h"
 #include "s2/s2crossing_edge_query.h"
@@ -92,6 +93,83 @@ EdgePairVector GetCrossings(const S2ShapeIndex& indexA,
   return edge_pairs;
 }
 
+// Get crossings between two indexes using the multi-threaded overload,
+// merging the per-thread results.
+EdgePairVector GetCrossingsParallel(const S2ShapeIndex& indexA,
+                                    const S2ShapeIndex& indexB,
+                                    CrossingType type, int num_threads) {
+  vector<EdgePairVector> buffers(num_threads);
+  vector<EdgePairVisitor> visitors;
+  for (int t = 0; t < num_threads; ++t) {
+    EdgePairVector* buffer = &buffers[t];
+    visitors.push_back(
+        [buffer](const ShapeEdge& a, const ShapeEdge& b, bool) {
+          buffer->push_back(std::make_pair(a.id(), b.id()));
+          return true;  // Continue visiting.
+        });
+  }
+  EXPECT_TRUE(VisitCrossingEdgePairs(indexA, indexB, type, visitors));
+  EdgePairVector edge_pairs;
+  for (const EdgePairVector& buffer : buffers) {
+    edge_pairs.insert(edge_pairs.end(), buffer.begin(), buffer.end());
+  }
+  if (edge_pairs.size() > 1) {
+    std::sort(edge_pairs.begin(), edge_pairs.end());
+    edge_pairs.erase(std::unique(edge_pairs.begin(), edge_pairs.end()),
+                     edge_pairs.end());
+  }
+  return edge_pairs;
+}
+
+// Get crossings in one index using the multi-threaded overload, merging the
+// per-thread results.
+EdgePairVector GetCrossingsParallel(const S2ShapeIndex& index,
+                                    CrossingType type, int num_threads) {
+  vector<EdgePairVector> buffers(num_threads);
+  vector<EdgePairVisitor> visitors;
+  for (int t = 0; t < num_threads; ++t) {
+    EdgePairVector* buffer = &buffers[t];
+    visitors.push_back(
+        [buffer](const ShapeEdge& a, const ShapeEdge& b, bool) {
+          buffer->push_back(std::make_pair(a.id(), b.id()));
+          return true;  // Continue visiting.
+        });
+  }
+  EXPECT_TRUE(VisitCrossingEdgePairs(index, type, visitors));
+  EdgePairVector edge_pairs;
+  for (const EdgePairVector& buffer : buffers) {
+    edge_pairs.insert(edge_pairs.end(), buffer.begin(), buffer.end());
+  }
+  if (edge_pairs.size() > 1) {
+    std::sort(edge_pairs.begin(), edge_pairs.end());
+    edge_pairs.erase(std::unique(edge_pairs.begin(), edge_pairs.end()),
+                     edge_pairs.end());
+  }
+  return edge_pairs;
+}
+
+// Get crossings in one index using the shared-visitor overload, which
+// invokes a single thread-safe visitor from every thread.
+EdgePairVector GetCrossingsSharedVisitor(const S2ShapeIndex& index,
+                                         CrossingType type, int num_threads) {
+  absl::Mutex lock;
+  EdgePairVector edge_pairs;
+  EXPECT_TRUE(VisitCrossingEdgePairs(
+      index, type,
+      [&](const ShapeEdge& a, const ShapeEdge& b, bool) {
+        absl::MutexLock l(&lock);
+        edge_pairs.push_back(std::make_pair(a.id(), b.id()));
+        return true;  // Continue visiting.
+      },
+      num_threads));
+  if (edge_pairs.size() > 1) {
+    std::sort(edge_pairs.begin(), edge_pairs.end());
+    edge_pairs.erase(std::unique(edge_pairs.begin(), edge_pairs.end()),
+                     edge_pairs.end());
+  }
+  return edge_pairs;
+}
+
 // Brute force crossings in one index.
 EdgePairVector GetCrossingEdgePairsBruteForce(const S2ShapeIndex& index,
                                               CrossingType type) {
@@ -217,6 +295,18 @@ TEST(GetCrossingEdgePairs, EdgeGridOneIndex) {
   index.Add(std::move(shape));
   TestGetCrossingEdgePairs(index, CrossingType::ALL, 112);
   TestGetCrossingEdgePairs(index, CrossingType::INTERIOR, 108);
+
+  // The multi-threaded overloads find the same crossings.
+  for (int num_threads : {1, 2, 4}) {
+    EXPECT_EQ(GetCrossings(index, CrossingType::ALL),
+              GetCrossingsParallel(index, CrossingType::ALL, num_threads));
+    EXPECT_EQ(GetCrossings(index, CrossingType::INTERIOR),
+              GetCrossingsParallel(index, CrossingType::INTERIOR,
+                                   num_threads));
+    EXPECT_EQ(GetCrossings(index, CrossingType::ALL),
+              GetCrossingsSharedVisitor(index, CrossingType::ALL,
+                                        num_threads));
+  }
 }
 
 TEST(GetCrossingEdgePairs, EdgeGridTwoIndexes) {
@@ -239,6 +329,16 @@ TEST(GetCrossingEdgePairs, EdgeGridTwoIndexes) {
   // See comments on the previous test regarding the number of crossings.
   TestGetCrossingEdgePairs(indexA, indexB, CrossingType::ALL, 112);
   TestGetCrossingEdgePairs(indexA, indexB, CrossingType::INTERIOR, 108);
+
+  // The multi-threaded overload finds the same crossings.
+  for (int num_threads : {1, 2, 4}) {
+    EXPECT_EQ(GetCrossings(indexA, indexB, CrossingType::ALL),
+              GetCrossingsParallel(indexA, indexB, CrossingType::ALL,
+                                   num_threads));
+    EXPECT_EQ(GetCrossings(indexA, indexB, CrossingType::INTERIOR),
+              GetCrossingsParallel(indexA, indexB, CrossingType::INTERIOR,
+                                   num_threads));
+  }
 }
 
 // Return true if any loop crosses any other loop (including vertex crossings
@@ -301,4 +401,27 @@ TEST(FindSelfIntersection, Basic) {
                   true);  // vertex crossing
 }
 
+TEST(FindSelfIntersection, ParallelMatchesSerial) {
+  for (string_view polygon_str :
+       {"0:0, 0:1, 0:2, 1:2, 1:1, 1:0",  // valid
+        "0:0, 0:1, 1:0, 1:1",            // edge crossing
+        "0:0, 1:1, 0:1; 0:0, 1:1, 1:0"}) {  // duplicate edge
+    unique_ptr<S2Polygon> polygon =
+        s2textformat::MakePolygonOrDie(polygon_str, S2Debug::DISABLE);
+    MutableS2ShapeIndex index;
+    index.Add(make_unique<S2Polygon::Shape>(polygon.get()));
+    S2Error serial_error;
+    const bool expected = FindSelfIntersection(index, &serial_error);
+    for (int num_threads : {1, 2, 4}) {
+      S2Error parallel_error;
+      EXPECT_EQ(expected,
+                FindSelfIntersection(index, &parallel_error, num_threads))
+          << polygon_str;
+      if (expected) {
+        EXPECT_EQ(serial_error.code(), parallel_error.code()) << polygon_str;
+      }
+    }
+  }
+}
+
 }  // namespace s2shapeutil
@@ -0,0 +1,164 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2testing_workloads.h"
+
+#include <cmath>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+#include "s2/base/types.h"
+#include "s2/s1angle.h"
+#include "s2/s2cap.h"
+#include "s2/s2fractal.h"
+#include "s2/s2loop.h"
+#include "s2/s2point.h"
+#include "s2/s2pointutil.h"
+#include "s2/s2polygon.h"
+#include "s2/util/math/matrix3x3.h"
+
+using std::make_unique;
+using std::unique_ptr;
+using std::vector;
+
+namespace s2testing {
+
+namespace {
+
+// Derives a well-distributed per-item seed from (seed, item), so that
+// consecutive items get uncorrelated random streams.  This is the SplitMix64
+// mixing function.
+uint64 MixSeed(uint64 seed, int64 item) {
+  uint64 z = seed + 0x9e3779b97f4a7c15ULL * (static_cast<uint64>(item) + 1);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+// Runs fn(item) for every item in [0, num_items), partitioning the items
+// into one contiguous range per thread.  fn must not depend on the order in
+// which items are processed.
+template <typename Fn>
+void ForEachItem(int64 num_items, int num_threads, const Fn& fn) {
+  ABSL_DCHECK_GE(num_threads, 1);
+  num_threads = std::min<int64>(num_threads, num_items);
+  if (num_threads <= 1) {
+    for (int64 item = 0; item < num_items; ++item) fn(item);
+    return;
+  }
+  vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (int t = 0; t < num_threads; ++t) {
+    int64 begin = num_items * t / num_threads;
+    int64 end = num_items * (t + 1) / num_threads;
+    threads.emplace_back([begin, end, &fn]() {
+      for (int64 item = begin; item < end; ++item) fn(item);
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+}
+
+// Returns a random unit-length vector (the same construction as
+// S2Testing::RandomPoint(), but drawn from the given local engine).
+S2Point RandomPoint(std::mt19937_64& rng) {
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+  double x = uniform(rng);
+  double y = uniform(rng);
+  double z = uniform(rng);
+  return S2Point(x, y, z).Normalize();
+}
+
+// Returns a point sampled uniformly (by area) from the given cap (the same
+// construction as S2Testing::SamplePoint(), but drawn from the given local
+// engine).
+S2Point SamplePoint(const S2Cap& cap, std::mt19937_64& rng) {
+  Matrix3x3_d m;
+  S2::GetFrame(cap.center(), &m);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  double h = uniform(rng) * cap.height();
+  double theta = 2 * M_PI * uniform(rng);
+  double r = std::sqrt(h * (2 - h));  // Radius of circle at height "h".
+  return S2::FromFrame(m, S2Point(std::cos(theta) * r, std::sin(theta) * r,
+                                  1 - h)).Normalize();
+}
+
+}  // namespace
+
+vector<unique_ptr<S2Loop>> MakeFractalLoops(int num_loops,
+                                            int approx_edges_per_loop,
+                                            S1Angle nominal_radius,
+                                            uint64 seed, int num_threads) {
+  vector<unique_ptr<S2Loop>> loops(num_loops);
+  ForEachItem(num_loops, num_threads, [&](int64 item) {
+    std::mt19937_64 rng(MixSeed(seed, item));
+    S2Fractal fractal;
+    fractal.SetLevelForApproxMaxEdges(approx_edges_per_loop);
+    // Use several levels so that the per-loop seed actually influences the
+    // subdivision pattern (a single-level fractal is deterministic).  The
+    // minimum of 12 edges keeps min_level() >= 1 (see S2Fractal).
+    fractal.SetLevelForApproxMinEdges(
+        std::max(12, approx_edges_per_loop / 16));
+    fractal.set_seed(static_cast<uint32>(rng()));
+    loops[item] = fractal.MakeLoop(S2::GetFrame(RandomPoint(rng)),
+                                   nominal_radius);
+  });
+  return loops;
+}
+
+vector<unique_ptr<S2Polygon>> MakeCapPolygons(int num_polygons,
+                                              int num_vertices,
+                                              S1Angle max_radius, uint64 seed,
+                                              int num_threads) {
+  vector<unique_ptr<S2Polygon>> polygons(num_polygons);
+  ForEachItem(num_polygons, num_threads, [&](int64 item) {
+    std::mt19937_64 rng(MixSeed(seed, item));
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    S2Point center = RandomPoint(rng);
+    S1Angle radius = (1 - uniform(rng)) * max_radius;  // In (0, max_radius].
+    polygons[item] = make_unique<S2Polygon>(
+        S2Loop::MakeRegularLoop(center, radius, num_vertices));
+  });
+  return polygons;
+}
+
+vector<S2Point> MakeClusteredPoints(int64 num_points, int num_clusters,
+                                    S1Angle cluster_radius, uint64 seed,
+                                    int num_threads) {
+  ABSL_DCHECK_GE(num_clusters, 1);
+  // The cluster centers use a random stream disjoint from the per-point
+  // streams below (MixSeed is applied to the bitwise complement of the
+  // cluster index).
+  vector<S2Cap> clusters;
+  clusters.reserve(num_clusters);
+  for (int c = 0; c < num_clusters; ++c) {
+    std::mt19937_64 rng(MixSeed(seed, ~static_cast<int64>(c)));
+    clusters.push_back(S2Cap(RandomPoint(rng), cluster_radius));
+  }
+  vector<S2Point> points(num_points);
+  ForEachItem(num_points, num_threads, [&](int64 item) {
+    std::mt19937_64 rng(MixSeed(seed, item));
+    const S2Cap& cluster = clusters[item * num_clusters / num_points];
+    points[item] = SamplePoint(cluster, rng);
+  });
+  return points;
+}
+
+}  // namespace s2testing
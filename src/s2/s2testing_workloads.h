@@ -0,0 +1,66 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef S2_S2TESTING_WORKLOADS_H_
+#define S2_S2TESTING_WORKLOADS_H_
+
+#include <memory>
+#include <vector>
+
+#include "s2/base/types.h"
+#include "s2/s1angle.h"
+#include "s2/s2loop.h"
+#include "s2/s2point.h"
+#include "s2/s2polygon.h"
+
+namespace s2testing {
+
+// Parallel, deterministic generators for large synthetic benchmark geometry.
+//
+// Unlike the helpers in S2Testing (which draw from the shared global PRNG
+// S2Testing::rnd and therefore must run single-threaded), each item below is
+// generated from its own PRNG seeded by (seed, item index).  This makes the
+// output for a given seed identical regardless of "num_threads" or thread
+// scheduling, while letting fixture generation scale with cores.  These
+// functions are intended for test and benchmark setup only; the geometry
+// distributions are chosen for coverage, not for statistical rigor.
+
+// Returns "num_loops" fractal loops (see S2Fractal), each centered at a
+// random point, with approximately "approx_edges_per_loop" edges and the
+// given nominal radius.  The fractals use distinct per-loop seeds, so their
+// subdivision patterns differ.
+std::vector<std::unique_ptr<S2Loop>> MakeFractalLoops(
+    int num_loops, int approx_edges_per_loop, S1Angle nominal_radius,
+    uint64 seed, int num_threads = 1);
+
+// Returns "num_polygons" single-loop polygons, each the boundary of a
+// spherical cap with a random center and a radius chosen uniformly from
+// (0, max_radius], discretized with "num_vertices" vertices.
+std::vector<std::unique_ptr<S2Polygon>> MakeCapPolygons(
+    int num_polygons, int num_vertices, S1Angle max_radius, uint64 seed,
+    int num_threads = 1);
+
+// Returns "num_points" points grouped into "num_clusters" clusters: the
+// cluster centers are chosen at random on the sphere, and each point is
+// sampled uniformly (by area) from the cap of radius "cluster_radius"
+// around its cluster center.  Points are assigned to clusters in contiguous
+// runs, so the result is ordered by cluster.
+std::vector<S2Point> MakeClusteredPoints(int64 num_points, int num_clusters,
+                                         S1Angle cluster_radius, uint64 seed,
+                                         int num_threads = 1);
+
+}  // namespace s2testing
+
+#endif  // S2_S2TESTING_WORKLOADS_H_
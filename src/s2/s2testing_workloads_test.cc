@@ -0,0 +1,91 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "s2/s2testing_workloads.h"
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "s2/s1angle.h"
+#include "s2/s1chord_angle.h"
+#include "s2/s2loop.h"
+#include "s2/s2point.h"
+#include "s2/s2polygon.h"
+
+using std::unique_ptr;
+using std::vector;
+
+namespace s2testing {
+
+TEST(MakeFractalLoops, DeterministicAcrossThreadCounts) {
+  const int kNumLoops = 20;
+  auto serial = MakeFractalLoops(kNumLoops, 100, S1Angle::Degrees(1), 123, 1);
+  auto parallel = MakeFractalLoops(kNumLoops, 100, S1Angle::Degrees(1), 123,
+                                   4);
+  ASSERT_EQ(kNumLoops, serial.size());
+  ASSERT_EQ(kNumLoops, parallel.size());
+  for (int i = 0; i < kNumLoops; ++i) {
+    EXPECT_TRUE(serial[i]->IsValid());
+    EXPECT_TRUE(serial[i]->BoundaryEquals(*parallel[i]));
+  }
+  // Different loops use different seeds, so they are not all translates of
+  // one fractal: at least two loops should have different vertex counts.
+  bool found_different = false;
+  for (int i = 1; i < kNumLoops && !found_different; ++i) {
+    found_different = serial[i]->num_vertices() != serial[0]->num_vertices();
+  }
+  EXPECT_TRUE(found_different);
+
+  // A different seed produces different geometry.
+  auto other = MakeFractalLoops(kNumLoops, 100, S1Angle::Degrees(1), 456, 1);
+  EXPECT_FALSE(other[0]->BoundaryEquals(*serial[0]));
+}
+
+TEST(MakeCapPolygons, DeterministicAcrossThreadCounts) {
+  const int kNumPolygons = 30;
+  auto serial = MakeCapPolygons(kNumPolygons, 16, S1Angle::Degrees(5), 42, 1);
+  auto parallel = MakeCapPolygons(kNumPolygons, 16, S1Angle::Degrees(5), 42,
+                                  4);
+  ASSERT_EQ(kNumPolygons, serial.size());
+  for (int i = 0; i < kNumPolygons; ++i) {
+    EXPECT_TRUE(serial[i]->IsValid());
+    EXPECT_EQ(16, serial[i]->num_vertices());
+    EXPECT_TRUE(serial[i]->BoundaryEquals(*parallel[i]));
+  }
+}
+
+TEST(MakeClusteredPoints, DeterministicAndClustered) {
+  const int64 kNumPoints = 1000;
+  const int kNumClusters = 10;
+  const S1Angle kRadius = S1Angle::Degrees(0.1);
+  auto serial = MakeClusteredPoints(kNumPoints, kNumClusters, kRadius, 7, 1);
+  auto parallel = MakeClusteredPoints(kNumPoints, kNumClusters, kRadius, 7,
+                                      4);
+  ASSERT_EQ(kNumPoints, serial.size());
+  EXPECT_EQ(serial, parallel);
+
+  // Points are ordered by cluster, so consecutive points in the same cluster
+  // are within one cluster diameter of each other.
+  const S1ChordAngle kDiameter(2 * kRadius);
+  int64 points_per_cluster = kNumPoints / kNumClusters;
+  for (int64 i = 0; i + 1 < kNumPoints; ++i) {
+    if ((i + 1) % points_per_cluster == 0) continue;  // Cluster boundary.
+    EXPECT_LE(S1ChordAngle(serial[i], serial[i + 1]), kDiameter);
+  }
+}
+
+}  // namespace s2testing
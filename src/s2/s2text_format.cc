@@ -70,19 +70,37 @@ vector<S2LatLng> ParseLatLngsOrDie(string_view str) {
   return latlngs;
 }
 
-bool ParseLatLngs(string_view str, vector<S2LatLng>* latlngs) {
-  for (const string_view lat_lng_str :
-       absl::StrSplit(str, ',', absl::SkipEmpty())) {
-    const vector<string_view> lat_lng = absl::StrSplit(lat_lng_str, ':');
-    if (lat_lng.size() != 2) return false;
+// Parses comma-separated "lat:lng" pairs from "str" and calls emit(latlng)
+// for each one.  This tokenizes in place over the string_view rather than
+// using absl::StrSplit, which allocates a vector of tokens per pair; the
+// difference matters when replaying large text dumps.  (absl::SimpleAtod is
+// already from_chars-based.)  Empty pairs are skipped, matching the behavior
+// of absl::SkipEmpty().
+template <class EmitFn>
+static bool ParseLatLngsInternal(string_view str, EmitFn emit) {
+  while (!str.empty()) {
+    const size_t comma = str.find(',');
+    const string_view lat_lng_str = str.substr(0, comma);
+    str.remove_prefix(comma == string_view::npos ? str.size() : comma + 1);
+    if (lat_lng_str.empty()) continue;
+    const size_t colon = lat_lng_str.find(':');
+    if (colon == string_view::npos ||
+        lat_lng_str.find(':', colon + 1) != string_view::npos) {
+      return false;
+    }
     double lat, lng;
-    if (!absl::SimpleAtod(lat_lng[0], &lat)) return false;
-    if (!absl::SimpleAtod(lat_lng[1], &lng)) return false;
-    latlngs->push_back(S2LatLng::FromDegrees(lat, lng));
+    if (!absl::SimpleAtod(lat_lng_str.substr(0, colon), &lat)) return false;
+    if (!absl::SimpleAtod(lat_lng_str.substr(colon + 1), &lng)) return false;
+    emit(S2LatLng::FromDegrees(lat, lng));
   }
   return true;
 }
 
+bool ParseLatLngs(string_view str, vector<S2LatLng>* latlngs) {
+  return ParseLatLngsInternal(
+      str, [latlngs](const S2LatLng& latlng) { latlngs->push_back(latlng); });
+}
+
 vector<S2Point> ParsePointsOrDie(string_view str) {
   vector<S2Point> vertices;
   ABSL_CHECK(ParsePoints(str, &vertices)) << ": str == \"" << str << "\"";
@@ -90,12 +108,11 @@ vector<S2Point> ParsePointsOrDie(string_view str) {
 }
 
 bool ParsePoints(string_view str, vector<S2Point>* vertices) {
-  vector<S2LatLng> latlngs;
-  if (!ParseLatLngs(str, &latlngs)) return false;
-  for (const auto& latlng : latlngs) {
+  // Converts each pair as it is parsed instead of materializing an
+  // intermediate vector<S2LatLng>.
+  return ParseLatLngsInternal(str, [vertices](const S2LatLng& latlng) {
     vertices->push_back(latlng.ToPoint());
-  }
-  return true;
+  });
 }
 
 S2Point MakePointOrDie(string_view str) {
@@ -289,6 +289,16 @@ TEST(SafeParseLatLngs, ValidInput) {
 TEST(SafeParseLatLngs, InvalidInput) {
   vector<S2LatLng> latlngs;
   EXPECT_FALSE(s2textformat::ParseLatLngs("blah", &latlngs));
+  EXPECT_FALSE(s2textformat::ParseLatLngs("1:2:3", &latlngs));
+  EXPECT_FALSE(s2textformat::ParseLatLngs("1:2, ", &latlngs));
+}
+
+TEST(SafeParseLatLngs, SkipsEmptyPairs) {
+  vector<S2LatLng> latlngs;
+  EXPECT_TRUE(s2textformat::ParseLatLngs(",-20:150,,-19:151,", &latlngs));
+  ASSERT_EQ(2, latlngs.size());
+  EXPECT_EQ(latlngs[0], S2LatLng::FromDegrees(-20, 150));
+  EXPECT_EQ(latlngs[1], S2LatLng::FromDegrees(-19, 151));
 }
 
 TEST(SafeParsePoints, ValidInput) {
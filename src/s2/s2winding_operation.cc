@@ -18,6 +18,7 @@
 
 #include "s2/s2winding_operation.h"
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -557,3 +558,54 @@ bool S2WindingOperation::Build(const S2Point& ref_p, int ref_winding,
   rule_ = rule;
   return builder_.Build(error);
 }
+
+S2WindingOperation::Session::Session(const Options& options)
+    : options_(options) {}
+
+int S2WindingOperation::Session::AddLoop(S2PointLoopSpan loop) {
+  loops_.emplace_back(loop.begin(), loop.end());
+  dirty_ = true;
+  return loops_.size() - 1;
+}
+
+void S2WindingOperation::Session::ReplaceLoop(int loop_id,
+                                              S2PointLoopSpan loop) {
+  ABSL_DCHECK_GE(loop_id, 0);
+  ABSL_DCHECK_LT(loop_id, loops_.size());
+  std::vector<S2Point>& old_loop = loops_[loop_id];
+  if (std::equal(old_loop.begin(), old_loop.end(), loop.begin(), loop.end())) {
+    return;  // The loop is unchanged; don't force a rebuild.
+  }
+  old_loop.assign(loop.begin(), loop.end());
+  dirty_ = true;
+}
+
+void S2WindingOperation::Session::RemoveLoop(int loop_id) {
+  ABSL_DCHECK_GE(loop_id, 0);
+  ABSL_DCHECK_LT(loop_id, loops_.size());
+  if (loops_[loop_id].empty()) return;
+  loops_[loop_id].clear();
+  dirty_ = true;
+}
+
+bool S2WindingOperation::Session::needs_rebuild(const S2Point& ref_p,
+                                                int ref_winding,
+                                                WindingRule rule) const {
+  return dirty_ || ref_p != last_ref_p_ || ref_winding != last_ref_winding_ ||
+         rule != last_rule_;
+}
+
+bool S2WindingOperation::Session::Build(
+    unique_ptr<S2Builder::Layer> result_layer, const S2Point& ref_p,
+    int ref_winding, WindingRule rule, S2Error* error) {
+  S2WindingOperation op(std::move(result_layer), options_);
+  for (const std::vector<S2Point>& loop : loops_) {
+    if (!loop.empty()) op.AddLoop(loop);
+  }
+  if (!op.Build(ref_p, ref_winding, rule, error)) return false;
+  dirty_ = false;
+  last_ref_p_ = ref_p;
+  last_ref_winding_ = ref_winding;
+  last_rule_ = rule;
+  return true;
+}
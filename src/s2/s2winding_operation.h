@@ -19,6 +19,7 @@
 #define S2_S2WINDING_OPERATION_H_
 
 #include <memory>
+#include <vector>
 
 #include "absl/log/absl_log.h"
 #include "s2/s2builder.h"
@@ -216,6 +217,69 @@ class S2WindingOperation {
   bool Build(const S2Point& ref_p, int ref_winding, WindingRule rule,
              S2Error* error);
 
+  // Session supports evaluating a winding operation repeatedly as a few of
+  // its input loops change (e.g. a display engine re-evaluating a union
+  // every frame).  It retains the input loops between evaluations so that
+  // only the modified loops need to be resupplied, detects no-op
+  // replacements, and reports via needs_rebuild() whether a new evaluation
+  // could produce a different result, letting the caller reuse the previous
+  // output otherwise.
+  //
+  // Note that S2Builder snaps all input edges together globally, so a
+  // changed loop can move snap sites (and therefore output edges) arbitrarily
+  // far away; when a rebuild is needed the whole operation is re-evaluated
+  // rather than just a dirty region.
+  class Session {
+   public:
+    explicit Session(const Options& options = Options{});
+
+    const Options& options() const { return options_; }
+
+    // Adds a loop (see S2WindingOperation::AddLoop) and returns an id that
+    // can be used to replace or remove it later.
+    int AddLoop(S2PointLoopSpan loop);
+
+    // Replaces the loop with the given id.  Replacing a loop with identical
+    // vertices is a no-op and does not force a rebuild.
+    // REQUIRES: "loop_id" was returned by AddLoop().
+    void ReplaceLoop(int loop_id, S2PointLoopSpan loop);
+
+    // Removes the loop with the given id.  The id is not reused.
+    // REQUIRES: "loop_id" was returned by AddLoop().
+    void RemoveLoop(int loop_id);
+
+    // Returns true if evaluating with the given parameters could produce a
+    // different result than the last successful Build() call, i.e. if any
+    // loop has changed or the parameters differ.  Returns true if Build()
+    // has not succeeded yet.
+    bool needs_rebuild(const S2Point& ref_p, int ref_winding,
+                       WindingRule rule) const;
+
+    // Re-evaluates the winding operation over the current set of loops,
+    // sending the output to the given result layer.  On success the session
+    // is marked clean with respect to the given parameters.
+    //
+    // REQUIRES: error->ok() [an existing error will not be overwritten]
+    bool Build(std::unique_ptr<S2Builder::Layer> result_layer,
+               const S2Point& ref_p, int ref_winding, WindingRule rule,
+               S2Error* error);
+
+   private:
+    Options options_;
+
+    // Retained input loops; a removed loop becomes an empty entry so that
+    // loop ids remain stable.
+    std::vector<std::vector<S2Point>> loops_;
+
+    // True if the loops have changed since the last successful Build().
+    bool dirty_ = true;
+
+    // The parameters of the last successful Build().
+    S2Point last_ref_p_;
+    int last_ref_winding_;
+    WindingRule last_rule_;
+  };
+
  private:
   // Most of the implementation is in the WindingLayer class.
   friend class s2builderutil::WindingLayer;
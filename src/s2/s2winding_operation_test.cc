@@ -295,4 +295,67 @@ TEST(S2WindingOperationOptions, SetGetSnapFunction) {
   EXPECT_EQ(opts.snap_function().snap_radius(), S1Angle::Zero());
 }
 
+
+// Builds the given session and returns the result as a text format string.
+string BuildSessionResult(S2WindingOperation::Session& session,
+                          string_view ref_point_str, int ref_winding,
+                          WindingRule rule) {
+  MutableS2ShapeIndex actual;
+  S2Error error;
+  EXPECT_TRUE(session.Build(
+      make_unique<s2builderutil::IndexedLaxPolygonLayer>(&actual),
+      s2textformat::MakePointOrDie(ref_point_str), ref_winding, rule, &error))
+      << error;
+  return s2textformat::ToString(actual);
+}
+
+TEST(S2WindingOperationSession, IncrementalLoopUpdates) {
+  // The session result must always match a from-scratch operation over the
+  // current set of loops.
+  S2WindingOperation::Session session;
+  int square_id = session.AddLoop(
+      s2textformat::ParsePointsOrDie("0:0, 0:10, 10:10, 10:0"));
+  session.AddLoop(s2textformat::ParsePointsOrDie("5:5, 5:15, 15:15, 15:5"));
+  EXPECT_TRUE(session.needs_rebuild(s2textformat::MakePointOrDie("20:20"), 0,
+                                    WindingRule::POSITIVE));
+  const string union_a = BuildSessionResult(session, "20:20", 0,
+                                            WindingRule::POSITIVE);
+  EXPECT_EQ(union_a,
+            BuildSessionResult(session, "20:20", 0, WindingRule::POSITIVE));
+
+  // After a successful build with unchanged inputs no rebuild is needed,
+  // and replacing a loop with identical vertices does not dirty the session.
+  EXPECT_FALSE(session.needs_rebuild(s2textformat::MakePointOrDie("20:20"), 0,
+                                     WindingRule::POSITIVE));
+  session.ReplaceLoop(square_id,
+                      s2textformat::ParsePointsOrDie("0:0, 0:10, 10:10, 10:0"));
+  EXPECT_FALSE(session.needs_rebuild(s2textformat::MakePointOrDie("20:20"), 0,
+                                     WindingRule::POSITIVE));
+
+  // Changing the winding rule or a loop requires a rebuild.
+  EXPECT_TRUE(session.needs_rebuild(s2textformat::MakePointOrDie("20:20"), 0,
+                                    WindingRule::ODD));
+  session.ReplaceLoop(square_id,
+                      s2textformat::ParsePointsOrDie("0:0, 0:8, 8:8, 8:0"));
+  EXPECT_TRUE(session.needs_rebuild(s2textformat::MakePointOrDie("20:20"), 0,
+                                    WindingRule::POSITIVE));
+  const string union_b = BuildSessionResult(session, "20:20", 0,
+                                            WindingRule::POSITIVE);
+  EXPECT_NE(union_a, union_b);
+
+  // Removing the replaced loop must match a from-scratch operation over the
+  // single remaining loop.
+  session.RemoveLoop(square_id);
+  MutableS2ShapeIndex expected;
+  S2WindingOperation op(
+      make_unique<s2builderutil::IndexedLaxPolygonLayer>(&expected));
+  op.AddLoop(s2textformat::ParsePointsOrDie("5:5, 5:15, 15:15, 15:5"));
+  S2Error error;
+  ASSERT_TRUE(op.Build(s2textformat::MakePointOrDie("20:20"), 0,
+                       WindingRule::POSITIVE, &error))
+      << error;
+  EXPECT_EQ(BuildSessionResult(session, "20:20", 0, WindingRule::POSITIVE),
+            s2textformat::ToString(expected));
+}
+
 }  // namespace
@@ -23,12 +23,11 @@
 #include <algorithm>
 #include <functional>
 #include <iterator>
-#include <limits>
 #include <utility>
 #include <vector>
 
 #include "s2/base/types.h"
-#include "s2/util/gtl/dense_hash_set.h"
+#include "absl/container/flat_hash_set.h"
 #include "s2/util/hash/mix.h"
 
 // SequenceLexicon is a class for compactly representing sequences of values
@@ -37,10 +36,13 @@
 // ValueLexicon and IdSetLexicon.
 //
 // Each distinct sequence is mapped to a 32-bit integer.  The space used for
-// each sequence is approximately 11 bytes plus the memory needed to represent
+// each sequence is approximately 10 bytes plus the memory needed to represent
 // the sequence elements.  For example, a sequence of three "double"s would
-// need about 11 + 3*8 = 35 bytes.  Note also that sequences are referred to
-// using 32-bit ids rather than 64-bit pointers.
+// need about 10 + 3*8 = 34 bytes.  Note also that sequences are referred to
+// using 32-bit ids rather than 64-bit pointers.  Duplicate detection is done
+// with a flat hash table of sequence ids (so that each sequence is stored
+// only once), while the sequence elements themselves are packed into a
+// single contiguous array.
 //
 // This class has the same thread-safety properties as "string": const methods
 // are thread safe, and non-const methods are not thread safe.
@@ -112,10 +114,6 @@ class SequenceLexicon {
   Sequence sequence(uint32 id) const;
 
  private:
-  friend class IdKeyEqual;
-  // Choose kEmptyKey to be the last key that will ever be generated.
-  static const uint32 kEmptyKey = std::numeric_limits<uint32>::max();
-
   class IdHasher {
    public:
     IdHasher(const Hasher& hasher, const SequenceLexicon* lexicon);
@@ -138,7 +136,7 @@ class SequenceLexicon {
     const SequenceLexicon* lexicon_;
   };
 
-  using IdSet = gtl::dense_hash_set<uint32, IdHasher, IdKeyEqual>;
+  using IdSet = absl::flat_hash_set<uint32, IdHasher, IdKeyEqual>;
 
   std::vector<T> values_;
   std::vector<uint32> begins_;
@@ -148,9 +146,6 @@ class SequenceLexicon {
 
 //////////////////   Implementation details follow   ////////////////////
 
-template <class T, class Hasher, class KeyEqual>
-const uint32 SequenceLexicon<T, Hasher, KeyEqual>::kEmptyKey;
-
 template <class T, class Hasher, class KeyEqual>
 SequenceLexicon<T, Hasher, KeyEqual>::IdHasher::IdHasher(
     const Hasher& hasher, const SequenceLexicon* lexicon)
@@ -189,9 +184,6 @@ template <class T, class Hasher, class KeyEqual>
 bool SequenceLexicon<T, Hasher, KeyEqual>::IdKeyEqual::operator()(
     uint32 id1, uint32 id2) const {
   if (id1 == id2) return true;
-  if (id1 == lexicon_->kEmptyKey || id2 == lexicon_->kEmptyKey) {
-    return false;
-  }
   SequenceLexicon::Sequence seq1 = lexicon_->sequence(id1);
   SequenceLexicon::Sequence seq2 = lexicon_->sequence(id2);
   return (seq1.size() == seq2.size() &&
@@ -203,7 +195,6 @@ SequenceLexicon<T, Hasher, KeyEqual>::SequenceLexicon(const Hasher& hasher,
                                                       const KeyEqual& key_equal)
     : id_set_(0, IdHasher(hasher, this),
               IdKeyEqual(key_equal, this)) {
-  id_set_.set_empty_key(kEmptyKey);
   begins_.push_back(0);
 }
 
@@ -212,8 +203,8 @@ SequenceLexicon<T, Hasher, KeyEqual>::SequenceLexicon(const SequenceLexicon& x)
     : values_(x.values_), begins_(x.begins_),
       // Unfortunately we can't copy "id_set_" because we need to change the
       // "this" pointers associated with hasher() and key_equal().
-      id_set_(x.id_set_.begin(), x.id_set_.end(), kEmptyKey, 0,
-              IdHasher(x.id_set_.hash_funct().hasher(), this),
+      id_set_(x.id_set_.begin(), x.id_set_.end(), 0,
+              IdHasher(x.id_set_.hash_function().hasher(), this),
               IdKeyEqual(x.id_set_.key_eq().key_equal(), this)) {
 }
 
@@ -222,8 +213,8 @@ SequenceLexicon<T, Hasher, KeyEqual>::SequenceLexicon(SequenceLexicon&& x)
     : values_(std::move(x.values_)), begins_(std::move(x.begins_)),
       // Unfortunately we can't move "id_set_" because we need to change the
       // "this" pointers associated with hasher() and key_equal().
-      id_set_(x.id_set_.begin(), x.id_set_.end(), kEmptyKey, 0,
-              IdHasher(x.id_set_.hash_funct().hasher(), this),
+      id_set_(x.id_set_.begin(), x.id_set_.end(), 0,
+              IdHasher(x.id_set_.hash_function().hasher(), this),
               IdKeyEqual(x.id_set_.key_eq().key_equal(), this)) {
 }
 
@@ -235,8 +226,8 @@ SequenceLexicon<T, Hasher, KeyEqual>::operator=(const SequenceLexicon& x) {
   begins_ = x.begins_;
   // Unfortunately we can't copy-assign "id_set_" because we need to change
   // the "this" pointers associated with hasher() and key_equal().
-  id_set_ = IdSet(x.id_set_.begin(), x.id_set_.end(), kEmptyKey, 0,
-                  IdHasher(x.id_set_.hash_funct().hasher(), this),
+  id_set_ = IdSet(x.id_set_.begin(), x.id_set_.end(), 0,
+                  IdHasher(x.id_set_.hash_function().hasher(), this),
                   IdKeyEqual(x.id_set_.key_eq().key_equal(), this));
   return *this;
 }
@@ -249,8 +240,8 @@ SequenceLexicon<T, Hasher, KeyEqual>::operator=(SequenceLexicon&& x) {
   begins_ = std::move(x.begins_);
   // Unfortunately we can't move-assign "id_set_" because we need to change
   // the "this" pointers associated with hasher() and key_equal().
-  id_set_ = IdSet(x.id_set_.begin(), x.id_set_.end(), kEmptyKey, 0,
-                  IdHasher(x.id_set_.hash_funct().hasher(), this),
+  id_set_ = IdSet(x.id_set_.begin(), x.id_set_.end(), 0,
+                  IdHasher(x.id_set_.hash_function().hasher(), this),
                   IdKeyEqual(x.id_set_.key_eq().key_equal(), this));
   return *this;
 }
@@ -29,6 +29,7 @@
 #include <ostream>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #include "absl/base/macros.h"
 #include "s2/base/types.h"
@@ -36,6 +37,7 @@
 #include "absl/base/macros.h"
 #include "absl/hash/hash.h"
 #include "absl/log/absl_check.h"
+#include "absl/types/span.h"
 #include "s2/util/bits/bits.h"
 
 namespace util {
@@ -643,6 +645,49 @@ inline std::ostream& operator<<(std::ostream& out,
   return out << bitmap.ToString();
 }
 
+// An optional acceleration index for rank and select queries on a
+// BasicBitmap.  The index stores one cumulative set-bit count per block of
+// 512 bits (64 bytes for Bitmap64), so Rank() needs a single table lookup
+// plus at most one block of popcounts, and Select() needs a binary search
+// over the table plus one block scan.  This is much faster than
+// FindNextSetBit() loops when distributing work over large bitmaps (e.g.,
+// selecting the k-th set bit out of millions).
+//
+// The index does not own the bitmap and is only valid as long as the bitmap
+// exists and is unmodified; rebuild the index after changing any bits.
+template <typename W>
+class BasicBitmapRankSelect {
+ public:
+  using Bitmap = BasicBitmap<W>;
+  using size_type = typename Bitmap::size_type;
+
+  // Builds the index for "bitmap" (not owned) in one pass over its words.
+  explicit BasicBitmapRankSelect(const Bitmap* bitmap);
+
+  // Returns the number of one bits in positions 0 to limit - 1.
+  // REQUIRES: limit <= bits()
+  size_type Rank(size_type limit) const;
+
+  // Finds the position of the k-th one bit (k is zero-based).  If the bitmap
+  // contains more than k one bits, sets "*index" to the position of that bit
+  // and returns true.  Otherwise returns false and "*index" is unmodified.
+  bool Select(size_type k, size_type* index) const;
+
+  // Returns the number of one bits in the bitmap.
+  size_type GetOnesCount() const { return counts_.back(); }
+
+ private:
+  static constexpr size_t kIntBits = CHAR_BIT * sizeof(W);
+  static constexpr size_t kBlockBits = 512;
+  static constexpr size_t kBlockWords = kBlockBits / kIntBits;
+
+  const Bitmap* bitmap_;  // Not owned.
+
+  // counts_[b] is the number of one bits before block "b"; the final entry
+  // holds the total number of one bits.
+  std::vector<size_type> counts_;
+};
+
 }  // namespace internal
 
 using BitmapChar = ::util::bitmap::internal::BasicBitmap<char>;
@@ -651,6 +696,16 @@ using Bitmap16 = ::util::bitmap::internal::BasicBitmap<uint16>;
 using Bitmap32 = ::util::bitmap::internal::BasicBitmap<uint32>;
 using Bitmap64 = ::util::bitmap::internal::BasicBitmap<uint64>;
 
+using BitmapCharRankSelect =
+    ::util::bitmap::internal::BasicBitmapRankSelect<char>;
+using Bitmap8RankSelect = ::util::bitmap::internal::BasicBitmapRankSelect<uint8>;
+using Bitmap16RankSelect =
+    ::util::bitmap::internal::BasicBitmapRankSelect<uint16>;
+using Bitmap32RankSelect =
+    ::util::bitmap::internal::BasicBitmapRankSelect<uint32>;
+using Bitmap64RankSelect =
+    ::util::bitmap::internal::BasicBitmapRankSelect<uint64>;
+
 using ConstBitmapChar = ::util::bitmap::internal::BasicBitmap<const char>;
 using ConstBitmap8 = ::util::bitmap::internal::BasicBitmap<const uint8>;
 using ConstBitmap16 = ::util::bitmap::internal::BasicBitmap<const uint16>;
@@ -973,6 +1028,24 @@ bool BasicBitmap<W>::FindNextBitInVector(bool complement, const Word* words,
           (int_index << kLogIntBits) + Bits::FindLSBSetNonZero64(one_word);
       return true;
     }
+    // Skip over runs of words with no matching bits four words at a time.
+    // Testing the block with a single combined value lets the compiler use
+    // wider (vector) loads where available, which matters when scanning
+    // sparse bitmaps over millions of bits.
+    while (int_index + 4 < last_int_index) {
+      MutableWord w1 = words[int_index + 1];
+      MutableWord w2 = words[int_index + 2];
+      MutableWord w3 = words[int_index + 3];
+      MutableWord w4 = words[int_index + 4];
+      if (complement) {
+        w1 = ~w1;
+        w2 = ~w2;
+        w3 = ~w3;
+        w4 = ~w4;
+      }
+      if (static_cast<MutableWord>(w1 | w2 | w3 | w4) != W{0}) break;
+      int_index += 4;
+    }
     one_word = words[++int_index];
     if (complement) one_word = ~one_word;
   }
@@ -1132,6 +1205,56 @@ BasicBitmap<W>::BitIndexIter::BitIndexIter(const BasicBitmap* bitmap,
              (bit_position_ & (kIntBits - 1));
 }
 
+template <typename W>
+BasicBitmapRankSelect<W>::BasicBitmapRankSelect(const Bitmap* bitmap)
+    : bitmap_(bitmap) {
+  using UWord = std::make_unsigned_t<typename Bitmap::MutableWord>;
+  const size_t num_words = bitmap->array_size();
+  counts_.reserve((num_words + kBlockWords - 1) / kBlockWords + 1);
+  size_type count = 0;
+  for (size_t i = 0; i < num_words; ++i) {
+    if (i % kBlockWords == 0) counts_.push_back(count);
+    count += absl::popcount(
+        static_cast<UWord>(bitmap->GetMaskedMapElement(i)));
+  }
+  counts_.push_back(count);
+}
+
+template <typename W>
+typename BasicBitmapRankSelect<W>::size_type BasicBitmapRankSelect<W>::Rank(
+    size_type limit) const {
+  ABSL_CHECK_LE(limit, bitmap_->bits());
+  const size_t block = limit / kBlockBits;
+  return counts_[block] +
+         bitmap_->GetOnesCountInRange(block * kBlockBits, limit);
+}
+
+template <typename W>
+bool BasicBitmapRankSelect<W>::Select(size_type k, size_type* index) const {
+  using UWord = std::make_unsigned_t<typename Bitmap::MutableWord>;
+  if (k >= counts_.back()) return false;
+  // Find the last block whose cumulative count is <= k.  (The final entry of
+  // counts_ is the total count, so it is excluded from the search.)
+  const size_t block =
+      std::upper_bound(counts_.begin(), counts_.end() - 1, k) -
+      counts_.begin() - 1;
+  size_type remaining = k - counts_[block];
+  const size_t num_words = bitmap_->array_size();
+  for (size_t i = block * kBlockWords; i < num_words; ++i) {
+    UWord word = static_cast<UWord>(bitmap_->GetMaskedMapElement(i));
+    const size_type count = absl::popcount(word);
+    if (remaining < count) {
+      // Clear the lowest "remaining" one bits; the answer is then the
+      // position of the lowest one bit that is left.
+      for (; remaining > 0; --remaining) word &= word - 1;
+      *index = i * kIntBits + Bits::FindLSBSetNonZero64(word);
+      return true;
+    }
+    remaining -= count;
+  }
+  return false;  // Unreachable: counts_.back() bounds the total count.
+}
+
 }  // namespace internal
 }  // namespace bitmap
 }  // namespace util
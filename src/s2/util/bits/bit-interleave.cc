@@ -40,6 +40,10 @@
 
 #include <cstdint>
 
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
 #include "s2/base/types.h"
 
 namespace util_bits {
@@ -94,6 +98,13 @@ uint32 InterleaveUint16(const uint16 val0, const uint16 val1) {
 }
 
 uint64 InterleaveUint32(const uint32 val0, const uint32 val1) {
+#if defined(__BMI2__)
+  // PDEP deposits the bits of its first argument into the positions selected
+  // by the mask, which performs the entire interleave in two instructions and
+  // avoids the lookup table (and its potential cache misses) entirely.
+  return _pdep_u64(val0, 0x5555555555555555) |
+         _pdep_u64(val1, 0xaaaaaaaaaaaaaaaa);
+#else
   return (static_cast<uint64>(kInterleaveLut[val0 & 0xff])) |
          (static_cast<uint64>(kInterleaveLut[(val0 >> 8) & 0xff]) << 16) |
          (static_cast<uint64>(kInterleaveLut[(val0 >> 16) & 0xff]) << 32) |
@@ -102,6 +113,7 @@ uint64 InterleaveUint32(const uint32 val0, const uint32 val1) {
          (static_cast<uint64>(kInterleaveLut[(val1 >> 8) & 0xff]) << 17) |
          (static_cast<uint64>(kInterleaveLut[(val1 >> 16) & 0xff]) << 33) |
          (static_cast<uint64>(kInterleaveLut[val1 >> 24]) << 49);
+#endif
 }
 
 // Extracting the even bits (bit 0, 2, ...).
@@ -154,8 +166,15 @@ inline uint32 ExtractEvenBits(uint64 bits) {
 }
 
 void DeinterleaveUint32(uint64 code, uint32 *val0, uint32 *val1) {
+#if defined(__BMI2__)
+  // PEXT is the inverse of PDEP: it gathers the bits selected by the mask
+  // into the low bits of the result.
+  *val0 = _pext_u64(code, 0x5555555555555555);
+  *val1 = _pext_u64(code, 0xaaaaaaaaaaaaaaaa);
+#else
   *val0 = ExtractEvenBits(code);
   *val1 = ExtractEvenBits(code >> 1);
+#endif
 }
 
 // Derivation of the multiplication based interleave algorithm:
@@ -22,7 +22,7 @@
 
 #include <algorithm>
 #include <cstdint>
-#include <tuple>
+#include <cstdlib>
 #include <utility>
 
 #include "absl/log/absl_check.h"
@@ -54,13 +54,8 @@ int Encoder::varint32_length(uint32 v) { return Varint::Length32(v); }
 
 int Encoder::varint64_length(uint64 v) { return Varint::Length64(v); }
 
-std::pair<unsigned char*, size_t> Encoder::NewBuffer(size_t size) {
-  auto* p = std::allocator<unsigned char>().allocate(size);
-  return {p, size};
-}
-
 void Encoder::DeleteBuffer(unsigned char* buf, size_t size) {
-  std::allocator<unsigned char>().deallocate(buf, size);
+  free(buf);
 }
 
 void Encoder::EnsureSlowPath(size_t N) {
@@ -68,19 +63,19 @@ void Encoder::EnsureSlowPath(size_t N) {
   assert(avail() < N);
   assert(length() == 0 || orig_ == underlying_buffer_);
 
-  // Double buffer size, but make sure we always have at least N extra bytes
+  // Double buffer size, but make sure we always have at least N extra bytes.
   const size_t current_len = length();
-  // Used in opensource; avoid structured bindings (a C++17 feature) to
-  // remain C++11-compatible.  b/210097200
-  unsigned char* new_buffer;
-  size_t new_capacity;
-  std::tie(new_buffer, new_capacity) =
-      NewBuffer(std::max(current_len + N, 2 * current_len));
-
-  if (underlying_buffer_) {
-    memcpy(new_buffer, underlying_buffer_, current_len);
-    DeleteBuffer(underlying_buffer_, capacity());
-  }
+  const size_t new_capacity = std::max(current_len + N, 2 * current_len);
+
+  // The buffer is grown with realloc() rather than allocate/copy/deallocate
+  // because the C library can often extend the allocation in place (for large
+  // buffers, by remapping pages).  This avoids copying all previously encoded
+  // data on each growth step, which otherwise dominates the memory traffic
+  // when encoding large data structures such as S2ShapeIndexes.  Note that
+  // realloc(nullptr, n) is equivalent to malloc(n).
+  auto* new_buffer =
+      static_cast<unsigned char*>(realloc(underlying_buffer_, new_capacity));
+  ABSL_CHECK(new_buffer != nullptr);
   underlying_buffer_ = new_buffer;
 
   orig_ = new_buffer;
@@ -188,7 +188,6 @@ class Encoder {
 
   Writer writer() { return Writer(this); }
 
-  static std::pair<unsigned char*, size_t> NewBuffer(size_t size);
   static void DeleteBuffer(unsigned char* buf, size_t size);
 
   void EnsureSlowPath(size_t N);
@@ -22,6 +22,9 @@
 
 #include <cstdint>
 
+#include "absl/log/absl_check.h"
+#include "absl/types/span.h"
+
 #include "s2/base/types.h"
 
 // ZigZag Transform
@@ -61,4 +64,66 @@ static inline int64 ZigZagDecode64(uint64 n) {
   return (n >> 1) ^ (0u - (n & 1));
 }
 
+// Span forms of the transforms above, for callers that transform a whole
+// buffer before handing it to a block encoder.  The loops are branch-free
+// and operate on independent elements so that compilers can unroll and
+// vectorize them.  "src" and "dst" must be the same size; they may refer to
+// the same memory.
+
+static inline void ZigZagEncode(absl::Span<const int32> src,
+                                absl::Span<uint32> dst) {
+  ABSL_DCHECK_EQ(src.size(), dst.size());
+  for (size_t i = 0; i < src.size(); ++i) dst[i] = ZigZagEncode(src[i]);
+}
+
+static inline void ZigZagDecode(absl::Span<const uint32> src,
+                                absl::Span<int32> dst) {
+  ABSL_DCHECK_EQ(src.size(), dst.size());
+  for (size_t i = 0; i < src.size(); ++i) dst[i] = ZigZagDecode(src[i]);
+}
+
+static inline void ZigZagEncode64(absl::Span<const int64> src,
+                                  absl::Span<uint64> dst) {
+  ABSL_DCHECK_EQ(src.size(), dst.size());
+  for (size_t i = 0; i < src.size(); ++i) dst[i] = ZigZagEncode64(src[i]);
+}
+
+static inline void ZigZagDecode64(absl::Span<const uint64> src,
+                                  absl::Span<int64> dst) {
+  ABSL_DCHECK_EQ(src.size(), dst.size());
+  for (size_t i = 0; i < src.size(); ++i) dst[i] = ZigZagDecode64(src[i]);
+}
+
+// Delta Transform
+//
+// Good for coding sequences of nearby integers such as sorted cell id
+// tables.  Each element is replaced by its difference from the previous
+// element (the first element is differenced against "base"), and the
+// difference is zig-zag encoded so that descending runs also yield small
+// values.  DeltaDecode64() reverses the transform.
+//
+// The encoder is a vectorizable element-wise subtraction; note that the
+// decoder is an inherently sequential prefix sum.
+
+static inline void DeltaEncode64(uint64 base, absl::Span<const uint64> src,
+                                 absl::Span<uint64> dst) {
+  ABSL_DCHECK_EQ(src.size(), dst.size());
+  uint64 prev = base;
+  for (size_t i = 0; i < src.size(); ++i) {
+    uint64 current = src[i];
+    dst[i] = ZigZagEncode64(static_cast<int64>(current - prev));
+    prev = current;
+  }
+}
+
+static inline void DeltaDecode64(uint64 base, absl::Span<const uint64> src,
+                                 absl::Span<uint64> dst) {
+  ABSL_DCHECK_EQ(src.size(), dst.size());
+  uint64 prev = base;
+  for (size_t i = 0; i < src.size(); ++i) {
+    prev += static_cast<uint64>(ZigZagDecode64(src[i]));
+    dst[i] = prev;
+  }
+}
+
 #endif  // S2_UTIL_CODING_TRANSFORMS_H_
@@ -28,6 +28,18 @@
 // than 64, the capacity is exactly as reserved, and grows linearly. Once the
 // size grows bigger than 64, the capacity grows exponentially.
 //
+// Heap allocations go through the allocator "A", which may be replaced with
+// a custom (e.g. pool or arena) allocator.  compact_array does not store an
+// allocator instance -- that would defeat its 16-byte size -- so the
+// allocator must be stateless: every instance must be interchangeable, with
+// any shared state held externally.
+//
+// The "ExtraInlinedBytes" parameter enlarges the object by that many bytes
+// (which must be a multiple of 8) and uses them to store additional elements
+// inline.  Arrays that typically hold a few more elements than fit in the
+// default 11 inline bytes can use this to avoid a heap allocation per array,
+// at the cost of making every array bigger.
+//
 // IMPORTANT: compact_array_base does not support a constructor and destructor
 // because it is designed to be used in "union". The replacements are
 // Construct() and Destruct() which MUST be called explicitly. If you need
@@ -62,9 +74,16 @@
 
 namespace gtl {
 
-template <typename T, typename A = std::allocator<T> >
+template <typename T, typename A = std::allocator<T>, int ExtraInlinedBytes = 0>
 class compact_array_base {
  private:
+  // See the file comment: the allocator is default-constructed at each use
+  // rather than stored, so it must be stateless.
+  static_assert(std::allocator_traits<A>::is_always_equal::value,
+                "compact_array requires a stateless allocator");
+  static_assert(ExtraInlinedBytes >= 0 && ExtraInlinedBytes % 8 == 0,
+                "ExtraInlinedBytes must be a non-negative multiple of 8");
+
   // The number of bits for the variable size_ and capacity_
   static const int kSizeNumBits = 24;
   static const int kCapacityNumBits = 6;
@@ -98,16 +117,20 @@ class compact_array_base {
   // We require 0-length arrays to take 0 bytes, and no strict aliasing. There
   // should be no compiler-inserted padding between any of our members.
   enum {
-    kMaxInlinedBytes = 11,
+    kMaxInlinedBytes = 11 + ExtraInlinedBytes,
     kInlined = kMaxInlinedBytes / sizeof(T),
     kActualInlinedBytes = kInlined * sizeof(T),
     kUnusedPaddingBytes = (kMaxInlinedBytes - kActualInlinedBytes) > 3 ?
         3 : (kMaxInlinedBytes - kActualInlinedBytes)
   };
+  // Inline capacities must be exactly representable by capacity_ (which
+  // stores an exponent of 2 for values >= kExponentStart).
+  static_assert(kInlined < kExponentStart,
+                "ExtraInlinedBytes too large for this element type");
 
   T* Array() { return IsInlined() ? InlinedSpace() : pointer_; }
   void SetArray(T* p) {
-    static_assert(sizeof(*this) == 16, "size assumption");
+    static_assert(sizeof(*this) == 16 + ExtraInlinedBytes, "size assumption");
     static_assert(sizeof(this) == 8, "pointer size assumption");
     is_inlined_ = false;
     pointer_ = p;
@@ -134,6 +157,10 @@ class compact_array_base {
     T* pointer_;
     char more_inlined_elements_[sizeof(T*)];
   };
+
+  // Optional additional inline storage (see ExtraInlinedBytes above).  This
+  // is contiguous with the preceding members, extending InlinedSpace().
+  char extra_inlined_elements_[ExtraInlinedBytes];
 #else
   enum { kInlined = 0, is_inlined_ = false };
   T* Array() { return first_; }
@@ -146,7 +173,7 @@ class compact_array_base {
 #endif
   bool IsInlined() const { return is_inlined_; }
   const T* ConstArray() const {
-    return const_cast<compact_array_base<T, A>*>(this)->Array();
+    return const_cast<compact_array_base*>(this)->Array();
   }
 
   using value_allocator_type =
@@ -171,6 +198,18 @@ class compact_array_base {
   // This means Init() must be called for every new compact_array_base
   void Init() noexcept { memset(this, 0, sizeof(*this)); }
 
+  // Points this array at the first "n" elements of "storage", which remains
+  // owned by the caller.  This allows many arrays to share one contiguous
+  // allocation.  Since the array does not own "storage", the caller must
+  // call Init() before the array is destroyed, resized, or assigned to;
+  // otherwise the array would deallocate memory it does not own.
+  void InitAsView(T* storage, size_type n) {
+    Init();
+    set_capacity(n);
+    set_size(n);
+    SetArray(storage);
+  }
+
   // Construct an array of size n and initialize the values to v.
   // Any old contents, if heap-allocated, will be leaked.
   void Construct(size_type n, const value_type& v = value_type()) {
@@ -527,22 +566,22 @@ class compact_array_base {
 };
 
 // Allocates storage for constants in compact_array_base<T>
-template <typename T, typename A>
-    const int compact_array_base<T, A>::kSizeNumBits;
-template <typename T, typename A>
-    const int compact_array_base<T, A>::kCapacityNumBits;
-template <typename T, typename A>
-    const int compact_array_base<T, A>::kMaxSize;
-template <typename T, typename A>
-    const int compact_array_base<T, A>::kExponentStart;
+template <typename T, typename A, int E>
+    const int compact_array_base<T, A, E>::kSizeNumBits;
+template <typename T, typename A, int E>
+    const int compact_array_base<T, A, E>::kCapacityNumBits;
+template <typename T, typename A, int E>
+    const int compact_array_base<T, A, E>::kMaxSize;
+template <typename T, typename A, int E>
+    const int compact_array_base<T, A, E>::kExponentStart;
 
 // compact_array:  Wrapper for compact_array_base that provides the
 //  constructors and destructor.
 
-template <class T, class A = std::allocator<T> >
-class compact_array : public compact_array_base<T, A> {
+template <class T, class A = std::allocator<T>, int ExtraInlinedBytes = 0>
+class compact_array : public compact_array_base<T, A, ExtraInlinedBytes> {
  private:
-  typedef compact_array_base<T, A> Base;
+  typedef compact_array_base<T, A, ExtraInlinedBytes> Base;
 
  public:
   typedef typename Base::value_type value_type;
@@ -605,40 +644,47 @@ class compact_array : public compact_array_base<T, A> {
 };
 
 // Comparison operators
-template <typename T, typename A>
-bool operator==(const compact_array<T, A>& x, const compact_array<T, A>& y) {
+template <typename T, typename A, int E>
+bool operator==(const compact_array<T, A, E>& x,
+                const compact_array<T, A, E>& y) {
   return x.size() == y.size() &&
          std::equal(x.begin(), x.end(), y.begin());
 }
 
-template <typename T, typename A>
-bool operator!=(const compact_array<T, A>& x, const compact_array<T, A>& y) {
+template <typename T, typename A, int E>
+bool operator!=(const compact_array<T, A, E>& x,
+                const compact_array<T, A, E>& y) {
   return !(x == y);
 }
 
-template <typename T, typename A>
-bool operator<(const compact_array<T, A>& x, const compact_array<T, A>& y) {
+template <typename T, typename A, int E>
+bool operator<(const compact_array<T, A, E>& x,
+               const compact_array<T, A, E>& y) {
   return std::lexicographical_compare(x.begin(), x.end(), y.begin(), y.end());
 }
 
-template <typename T, typename A>
-bool operator>(const compact_array<T, A>& x, const compact_array<T, A>& y) {
+template <typename T, typename A, int E>
+bool operator>(const compact_array<T, A, E>& x,
+               const compact_array<T, A, E>& y) {
   return y < x;
 }
 
-template <typename T, typename A>
-bool operator<=(const compact_array<T, A>& x, const compact_array<T, A>& y) {
+template <typename T, typename A, int E>
+bool operator<=(const compact_array<T, A, E>& x,
+                const compact_array<T, A, E>& y) {
   return !(y < x);
 }
 
-template <typename T, typename A>
-bool operator>=(const compact_array<T, A>& x, const compact_array<T, A>& y) {
+template <typename T, typename A, int E>
+bool operator>=(const compact_array<T, A, E>& x,
+                const compact_array<T, A, E>& y) {
   return !(x < y);
 }
 
 // Swap
-template <typename T, typename A>
-inline void swap(compact_array<T, A>& x, compact_array<T, A>& y) noexcept {
+template <typename T, typename A, int E>
+inline void swap(compact_array<T, A, E>& x,
+                 compact_array<T, A, E>& y) noexcept {
   x.swap(y);
 }
 
@@ -664,8 +710,9 @@ struct LogArray : public gtl::LogLegacyUpTo100 {
 // operator<< for std::ostream.  Note that
 // compact_array_internal::LogArray ensures that "signed char" and
 // "unsigned char" types print as integers.
-template <class T, class A>
-std::ostream& operator<<(std::ostream& out, const compact_array<T, A>& array) {
+template <class T, class A, int E>
+std::ostream& operator<<(std::ostream& out,
+                         const compact_array<T, A, E>& array) {
   gtl::LogRangeToStream(out, array.begin(), array.end(),
                         compact_array_internal::LogArray());
   return out;
@@ -0,0 +1,113 @@
+// Copyright 2026 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS-IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Batch kernels for the vector operations that dominate bulk geometric
+// computations: dot products, cross products, and normalization over whole
+// spans of vectors at once.
+//
+// The loops below are deliberately written as straight-line, branch-free
+// elementwise arithmetic over contiguous arrays so that the compiler can
+// auto-vectorize them for whatever instruction set the library build targets
+// (SSE2, AVX2, NEON, ...).  This library contains no intrinsics and is built
+// from source by its integrators, so selecting the target ISA via build
+// flags (e.g. -march) is preferred over runtime dispatch; these entry points
+// centralize the hot loops so that a runtime-dispatched implementation could
+// be substituted later without changing callers.
+//
+// Callers with many independent per-element operations (e.g. computing the
+// distance between corresponding points of two arrays) should prefer these
+// functions over per-element loops of Vector3 methods, which the compiler
+// often cannot vectorize across iterations.
+
+#ifndef S2_UTIL_MATH_VECTOR_BATCH_H_
+#define S2_UTIL_MATH_VECTOR_BATCH_H_
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+#include "absl/log/absl_check.h"
+#include "absl/types/span.h"
+#include "s2/util/math/vector.h"
+
+namespace util {
+namespace math {
+
+// Computes result[i] = a[i].DotProd(b[i]) for every element of "a" and "b".
+// "V" may be Vector3 or any type derived from it (e.g. S2Point).
+//
+// REQUIRES: a.size() == b.size() == result.size()
+template <typename V>
+void DotProdBatch(absl::Span<const V> a, absl::Span<const V> b,
+                  absl::Span<typename V::BaseType> result) {
+  static_assert(V::SIZE == 3, "DotProdBatch requires 3-dimensional vectors");
+  ABSL_DCHECK_EQ(a.size(), b.size());
+  ABSL_DCHECK_EQ(a.size(), result.size());
+  for (size_t i = 0; i < a.size(); ++i) {
+    result[i] = a[i].x() * b[i].x() + a[i].y() * b[i].y() +
+                a[i].z() * b[i].z();
+  }
+}
+
+// Computes result[i] = a[i].CrossProd(b[i]) for every element of "a" and "b".
+// It is not allowed for "result" to alias "a" or "b".
+//
+// REQUIRES: a.size() == b.size() == result.size()
+template <typename V>
+void CrossProdBatch(absl::Span<const V> a, absl::Span<const V> b,
+                    absl::Span<V> result) {
+  static_assert(V::SIZE == 3, "CrossProdBatch requires 3-dimensional vectors");
+  ABSL_DCHECK_EQ(a.size(), b.size());
+  ABSL_DCHECK_EQ(a.size(), result.size());
+  for (size_t i = 0; i < a.size(); ++i) {
+    result[i] = V(a[i].y() * b[i].z() - a[i].z() * b[i].y(),
+                  a[i].z() * b[i].x() - a[i].x() * b[i].z(),
+                  a[i].x() * b[i].y() - a[i].y() * b[i].x());
+  }
+}
+
+// Computes result[i] = v[i].Norm2() for every element of "v".
+//
+// REQUIRES: v.size() == result.size()
+template <typename V>
+void Norm2Batch(absl::Span<const V> v, absl::Span<typename V::BaseType> result) {
+  static_assert(V::SIZE == 3, "Norm2Batch requires 3-dimensional vectors");
+  ABSL_DCHECK_EQ(v.size(), result.size());
+  for (size_t i = 0; i < v.size(); ++i) {
+    result[i] = v[i].x() * v[i].x() + v[i].y() * v[i].y() +
+                v[i].z() * v[i].z();
+  }
+}
+
+// Normalizes every element of "v" in place.  Like Vector3::Normalize(),
+// zero vectors are left unchanged.
+template <typename V>
+void NormalizeBatch(absl::Span<V> v) {
+  using T = typename V::BaseType;
+  static_assert(V::SIZE == 3, "NormalizeBatch requires 3-dimensional vectors");
+  static_assert(std::is_floating_point<T>::value,
+                "NormalizeBatch requires a floating-point element type");
+  for (size_t i = 0; i < v.size(); ++i) {
+    T norm2 = v[i].x() * v[i].x() + v[i].y() * v[i].y() + v[i].z() * v[i].z();
+    // A zero vector scales by 1, which leaves its components unchanged.
+    T scale = norm2 > T(0) ? T(1) / std::sqrt(norm2) : T(1);
+    v[i] = V(v[i].x() * scale, v[i].y() * scale, v[i].z() * scale);
+  }
+}
+
+}  // namespace math
+}  // namespace util
+
+#endif  // S2_UTIL_MATH_VECTOR_BATCH_H_
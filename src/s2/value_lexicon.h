@@ -21,20 +21,19 @@
 #include <cstddef>
 
 #include <functional>
-#include <limits>
 #include <utility>
 #include <vector>
 
 #include "s2/base/types.h"
-#include "s2/util/gtl/dense_hash_set.h"
+#include "absl/container/flat_hash_set.h"
 
 // ValueLexicon is a class that maps distinct values to sequentially numbered
 // integer identifiers.  It automatically eliminates duplicates and uses a
 // compact representation.  See also SequenceLexicon.
 //
 // Each distinct value is mapped to a 32-bit integer.  The space used for each
-// value is approximately 7 bytes plus the space needed for the value itself.
-// For example, int64 values would need approximately 15 bytes each.  Note
+// value is approximately 6 bytes plus the space needed for the value itself.
+// For example, int64 values would need approximately 14 bytes each.  Note
 // also that values are referred to using 32-bit ids rather than 64-bit
 // pointers.
 //
@@ -76,10 +75,6 @@ class ValueLexicon {
   const T& value(uint32 id) const;
 
  private:
-  friend class IdKeyEqual;
-  // Choose kEmptyKey to be the last key that will ever be generated.
-  static const uint32 kEmptyKey = std::numeric_limits<uint32>::max();
-
   class IdHasher {
    public:
     IdHasher(const Hasher& hasher, const ValueLexicon* lexicon);
@@ -101,7 +96,7 @@ class ValueLexicon {
     const ValueLexicon* lexicon_;
   };
 
-  using IdSet = gtl::dense_hash_set<uint32, IdHasher, IdKeyEqual>;
+  using IdSet = absl::flat_hash_set<uint32, IdHasher, IdKeyEqual>;
 
   KeyEqual key_equal_;
   std::vector<T> values_;
@@ -111,9 +106,6 @@ class ValueLexicon {
 
 //////////////////   Implementation details follow   ////////////////////
 
-template <class T, class Hasher, class KeyEqual>
-const uint32 ValueLexicon<T, Hasher, KeyEqual>::kEmptyKey;
-
 template <class T, class Hasher, class KeyEqual>
 ValueLexicon<T, Hasher, KeyEqual>::IdHasher::IdHasher(
     const Hasher& hasher, const ValueLexicon* lexicon)
@@ -141,9 +133,6 @@ template <class T, class Hasher, class KeyEqual>
 inline bool ValueLexicon<T, Hasher, KeyEqual>::IdKeyEqual::operator()(
     uint32 id1, uint32 id2) const {
   if (id1 == id2) return true;
-  if (id1 == lexicon_->kEmptyKey || id2 == lexicon_->kEmptyKey) {
-    return false;
-  }
   return key_equal_(lexicon_->value(id1), lexicon_->value(id2));
 }
 
@@ -153,7 +142,6 @@ ValueLexicon<T, Hasher, KeyEqual>::ValueLexicon(const Hasher& hasher,
     : key_equal_(key_equal),
       id_set_(0, IdHasher(hasher, this),
                  IdKeyEqual(key_equal, this)) {
-  id_set_.set_empty_key(kEmptyKey);
 }
 
 template <class T, class Hasher, class KeyEqual>
@@ -161,8 +149,8 @@ ValueLexicon<T, Hasher, KeyEqual>::ValueLexicon(const ValueLexicon& x)
     : key_equal_(x.key_equal_), values_(x.values_),
       // Unfortunately we can't copy "id_set_" because we need to change the
       // "this" pointers associated with hasher() and key_equal().
-      id_set_(x.id_set_.begin(), x.id_set_.end(), kEmptyKey, 0,
-              IdHasher(x.id_set_.hash_funct().hasher(), this),
+      id_set_(x.id_set_.begin(), x.id_set_.end(), 0,
+              IdHasher(x.id_set_.hash_function().hasher(), this),
               IdKeyEqual(x.key_equal_, this)) {
 }
 
@@ -171,8 +159,8 @@ ValueLexicon<T, Hasher, KeyEqual>::ValueLexicon(ValueLexicon&& x)
     : key_equal_(std::move(x.key_equal_)), values_(std::move(x.values_)),
       // Unfortunately we can't move "id_set_" because we need to change the
       // "this" pointers associated with hasher() and key_equal().
-      id_set_(x.id_set_.begin(), x.id_set_.end(), kEmptyKey, 0,
-              IdHasher(x.id_set_.hash_funct().hasher(), this),
+      id_set_(x.id_set_.begin(), x.id_set_.end(), 0,
+              IdHasher(x.id_set_.hash_function().hasher(), this),
               IdKeyEqual(x.key_equal_, this)) {
 }
 
@@ -184,8 +172,8 @@ ValueLexicon<T, Hasher, KeyEqual>::operator=(const ValueLexicon& x) {
   values_ = x.values_;
   // Unfortunately we can't copy-assign "id_set_" because we need to change
   // the "this" pointers associated with hasher() and key_equal().
-  id_set_ = IdSet(x.id_set_.begin(), x.id_set_.end(), kEmptyKey, 0,
-                  IdHasher(x.id_set_.hash_funct().hasher(), this),
+  id_set_ = IdSet(x.id_set_.begin(), x.id_set_.end(), 0,
+                  IdHasher(x.id_set_.hash_function().hasher(), this),
                   IdKeyEqual(x.key_equal_, this));
   return *this;
 }
@@ -198,8 +186,8 @@ ValueLexicon<T, Hasher, KeyEqual>::operator=(ValueLexicon&& x) {
   values_ = std::move(x.values_);
   // Unfortunately we can't move-assign "id_set_" because we need to change
   // the "this" pointers associated with hasher() and key_equal().
-  id_set_ = IdSet(x.id_set_.begin(), x.id_set_.end(), kEmptyKey, 0,
-                  IdHasher(x.id_set_.hash_funct().hasher(), this),
+  id_set_ = IdSet(x.id_set_.begin(), x.id_set_.end(), 0,
+                  IdHasher(x.id_set_.hash_function().hasher(), this),
                   IdKeyEqual(x.key_equal_, this));
   return *this;
 }